@@ -57,6 +57,12 @@ void PendSV_Handler(void);
 void SysTick_Handler(void);
 void EXTI4_IRQHandler(void);
 /* USER CODE BEGIN EFP */
+void EXTI15_10_IRQHandler(void);
+void DMA2_Stream5_IRQHandler(void);
+void USART6_IRQHandler(void);
+void DMA1_Stream6_IRQHandler(void);
+void DMA1_Stream5_IRQHandler(void);
+void TIM5_IRQHandler(void);
 
 /* USER CODE END EFP */
 
@@ -21,7 +21,26 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
-#include <stdio.h>
+#include "altitude_estimator.h"
+#include "attitude_estimator.h"
+#include "blackbox.h"
+#include "cycle_counter.h"
+#include "dshot.h"
+#include "event_capture.h"
+#include "flight_control.h"
+#include "flight_log.h"
+#include "imu_compress.h"
+#include "imu_filter_bank.h"
+#include "imu_preintegration.h"
+#include "imu_temp_comp.h"
+#include "log_download.h"
+#include "mixer.h"
+#include "rc_input.h"
+#include "telemetry.h"
+#include "text_format.h"
+#include "timebase.h"
+#include "vibration_analyzer.h"
+#include <string.h>
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -31,6 +50,64 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
+#define BARO_SAMPLE_PERIOD_S (1.0f / 75.0f) // LPS22HB_CONFIG_ODR_75HZ
+#define ALTITUDE_TIME_CONSTANT_S 1.0f
+// LSM6DSO32 reads paced by the TIM5 tick while its INT1 line is not wired
+#define IMU_SAMPLE_PERIOD_US 1000
+#define IMU_TICK_IRQ_PRIORITY 0 // sensor timing, with the baro EXTI
+#define IMU_GYRO_SCALE_RADS (LSM6DSO32_GYRO_SENS_2000DPS_MDPS * 1e-3f * 3.14159265f / 180.0f)
+#define IMU_ACCEL_SCALE_MPS2 (LSM6DSO32_ACCEL_SENS_8G_MG * 1e-3f * 9.80665f)
+// Accel correction of the attitude, rad/s per rad of tilt error (SimLoop_DefaultConfig)
+#define ATTITUDE_ACCEL_GAIN 0.2f
+#define VIBRATION_MIN_FREQ_HZ 40.0f // below: attitude motion, not frame resonance
+
+// Receiver on USART6: RC_PROTOCOL_SBUS or RC_PROTOCOL_CRSF. Channels in AETR order, arm switch on AUX1
+#define RC_INPUT_PROTOCOL RC_PROTOCOL_SBUS
+#define RC_CHANNEL_ROLL 0
+#define RC_CHANNEL_PITCH 1
+#define RC_CHANNEL_THROTTLE 2
+#define RC_CHANNEL_YAW 3
+#define RC_CHANNEL_ARM 4
+#define RC_FRAME_TIMEOUT_MS 100 // no frame for this long: treated as failsafe
+#define RC_ARM_THROTTLE_MAX 0.05f // arming needs the throttle stick down
+#define FLIGHT_MAX_ANGLE_RAD 0.6f // full roll/pitch stick in angle mode
+#define FLIGHT_MAX_YAW_RATE_RADS 4.0f // full yaw stick
+
+// Motor outputs on TIM1 CH1..CH4 (PA8..PA11). Servo frames and frames with more motors have no driver yet
+#if MIXER_IS_MOTOR_FRAME && MIXER_OUTPUTS <= DSHOT_MAX_MOTORS
+#define MOTOR_OUTPUT_DSHOT 1
+#else
+#define MOTOR_OUTPUT_DSHOT 0
+#endif
+#define DSHOT_OUTPUT_SPEED DSHOT_SPEED_600
+#define DSHOT_TIMING_CHECK_FRAMES 100 // frames sent before the one-off DShot_CheckTiming report
+
+// 0: binary frames (telemetry.schema, decoded by tools/telemetry), 1: the old "p: ..., t: ..." text lines
+#define TELEMETRY_TEXT_OUTPUT 0
+
+// 1: TELEMETRY_MODE_STREAM at TELEMETRY_HIGH_RATE_BAUD, for raw sensor streams and fast log download;
+// 0: queue mode at the CubeMX 115200. The host tools default to -b 2000000 and need -b 115200 for 0
+#define TELEMETRY_HIGH_RATE 1
+#define TELEMETRY_HIGH_RATE_BAUD 2000000 // ST-LINK VCP limit
+// High rate only: every raw IMU sample, compressed into IMU_BLOCK messages
+#define TELEMETRY_IMU_STREAM (TELEMETRY_HIGH_RATE && !TELEMETRY_TEXT_OUTPUT)
+#define IMU_COMPRESS_KEY_INTERVAL 500 // samples: a host that lost a frame resyncs within 0.5 s
+
+// SCHEMA message period: a host attached mid-flight learns the schema hash within this
+#define TELEMETRY_SCHEMA_PERIOD_MS 1000
+#define TELEMETRY_STATUS_PERIOD_MS 1000
+
+// Flash words per main-loop pass: ~16 us of stall each while programming
+#define BLACKBOX_WORDS_PER_SERVICE 16
+
+// Pre-trigger IMU capture: RAM taken from the 128 KB of SRAM, windows at the 1 kHz loop rate
+#define EVENT_CAPTURE_RAM_BYTES (24u * 1024u)
+#define EVENT_CAPTURE_PRE_SAMPLES 800
+#define EVENT_CAPTURE_POST_SAMPLES 400
+
+// Log download (tools/telemetry stflight_download): chunks in flight, frames per main-loop pass
+#define LOG_DOWNLOAD_WINDOW LOG_DOWNLOAD_DEFAULT_WINDOW
+#define LOG_DOWNLOAD_CHUNKS_PER_SERVICE TELEMETRY_QUEUE_SLOTS
 
 /* USER CODE END PD */
 
@@ -47,6 +124,30 @@ SPI_HandleTypeDef hspi2;
 UART_HandleTypeDef huart2;
 
 /* USER CODE BEGIN PV */
+static Telemetry_Handle_t telemetry;
+static Blackbox_t blackbox;
+static FlightLog_t flightLog;
+static SensorIMU_Sample_t captureRing[EVENT_CAPTURE_SAMPLES(EVENT_CAPTURE_RAM_BYTES)];
+static EventCapture_t capture;
+static LogDownload_t logDownload;
+static Blackbox_Cursor_t logCursor;
+static uint32_t imuErrors; // SensorIMU_Read failures; the sample is skipped, the loop goes on
+static ImuTempComp_t imuTempComp;
+static FilterBank_t imuFilters;
+static ImuPreint_t imuPreint;
+static AttitudeEstimator_t attitude;
+static VibrationAnalyzer_t vibration; // ~7 KB
+static RcInput_Handle_t rcInput;
+#if TELEMETRY_IMU_STREAM
+static ImuCompress_Encoder_t imuCompress;
+#endif
+static bool rcArmed; // arm switch seen high with the throttle down, link good since
+static Mixer_Output_t motors; // airframe outputs of the last control tick, zero while disarmed
+#if MOTOR_OUTPUT_DSHOT
+static DShot_Handle_t dshot;
+static uint32_t dshotFrames; // frames handed to the DMA
+static bool dshotTimingReported;
+#endif
 
 /* USER CODE END PV */
 
@@ -62,6 +163,130 @@ static void MX_I2C1_Init(void);
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
 volatile bool lps22hb_data_ready = false;
+volatile uint32_t lps22hb_time_us; // TimeBase stamp of the data-ready EXTI
+volatile bool imu_data_due = false;
+volatile uint32_t imu_time_us; // Scheduled time of the TIM5 tick
+
+static void ImuTick(uint32_t tick_us)
+{
+    imu_time_us = tick_us;
+    imu_data_due = true;
+}
+
+// Log download source: the blackbox as a byte stream; logCursor keeps sequential reads cheap
+static uint16_t LogSource_Read(void *ctx, uint32_t offset, uint8_t *out, uint16_t len)
+{
+    return Blackbox_Read(ctx, &logCursor, offset, out, len);
+}
+
+static uint32_t LogSource_Size(void *ctx)
+{
+    return Blackbox_Size(ctx);
+}
+
+static uint32_t LogSource_Origin(void *ctx)
+{
+    Blackbox_Cursor_t oldest;
+    Blackbox_Rewind(ctx, &oldest);
+    return oldest.sequence;
+}
+
+static int LogLink_Send(void *ctx, uint8_t msgId, const void *payload, uint16_t len)
+{
+    (void)ctx;
+    return Telemetry_Send(&telemetry, msgId, payload, len);
+}
+
+// Pilot command from the latest receiver frame. Disarms, with the sticks centred and the throttle
+// at zero, before the first frame, on failsafe, or when frames stop arriving
+static void RcSetpoint(FlightControl_Setpoint_t *setpoint)
+{
+    RcProtocol_Frame_t frame;
+    uint32_t frameCycles;
+    uint32_t frames = RcInput_GetFrame(&rcInput, &frame, &frameCycles);
+    bool linkGood = frames > 0 && !frame.failsafe &&
+                    CycleCounter_Read() - frameCycles < SystemCoreClock / 1000u * RC_FRAME_TIMEOUT_MS;
+
+    *setpoint = (FlightControl_Setpoint_t){.mode = FLIGHT_MODE_ANGLE};
+    if (!linkGood)
+    {
+        rcArmed = false;
+        return;
+    }
+
+    float throttle = 0.5f * (RcProtocol_ChannelToUnit(frame.channel[RC_CHANNEL_THROTTLE]) + 1.0f);
+    if (RcProtocol_ChannelToUnit(frame.channel[RC_CHANNEL_ARM]) < 0.5f)
+    {
+        rcArmed = false;
+    }
+    else if (!rcArmed && !frame.frameLost && throttle < RC_ARM_THROTTLE_MAX)
+    {
+        rcArmed = true;
+    }
+
+    // Stick forward is nose down; the controller takes pitch nose up
+    setpoint->armed = rcArmed;
+    setpoint->roll = RcProtocol_ChannelToUnit(frame.channel[RC_CHANNEL_ROLL]) * FLIGHT_MAX_ANGLE_RAD;
+    setpoint->pitch = -RcProtocol_ChannelToUnit(frame.channel[RC_CHANNEL_PITCH]) * FLIGHT_MAX_ANGLE_RAD;
+    setpoint->yawRate_rads = RcProtocol_ChannelToUnit(frame.channel[RC_CHANNEL_YAW]) * FLIGHT_MAX_YAW_RATE_RADS;
+    setpoint->throttle = rcArmed ? throttle : 0.0f;
+}
+
+#if MOTOR_OUTPUT_DSHOT
+// One frame per motor per control tick: motor stop while disarmed, so the ESCs arm and stay quiet
+static void MotorsWrite(bool armed)
+{
+    uint16_t values[MIXER_OUTPUTS];
+    for (int i = 0; i < MIXER_OUTPUTS; i++)
+    {
+        values[i] = armed ? DShot_ThrottleToValue(motors.output[i]) : DSHOT_VALUE_DISARM;
+    }
+    if (DShot_Write(&dshot, values, false) == 0)
+    {
+        dshotFrames++;
+    }
+}
+
+// Once, after DSHOT_TIMING_CHECK_FRAMES frames: a wrong TIM1 clock or a stalled DMA shows here
+static void MotorsReportTiming(void)
+{
+    float frame_us = 0.0f;
+    int result = DShot_CheckTiming(&dshot, &frame_us);
+
+    char line[TEXT_FORMAT_LINE_MAX];
+    TextFormat_t tf;
+    TextFormat_Init(&tf, line, sizeof(line));
+    TextFormat_Str(&tf, "dshot frame: ");
+    TextFormat_Fixed(&tf, frame_us, 2);
+    TextFormat_Str(&tf, result == 0 ? " us, ok\r\n" : (result == -1 ? " us, NONE\r\n" : " us, OUT OF TOLERANCE\r\n"));
+    size_t len = TextFormat_End(&tf);
+    if (len > 0)
+    {
+        Telemetry_SendRaw(&telemetry, line, len);
+    }
+}
+#endif
+
+#if !TELEMETRY_TEXT_OUTPUT
+// Gyro peaks of a newly published spectrum; the accel axes do not place notches and stay on board
+static void SendVibration(const VibrationAnalyzer_Spectrum_t *spectrum)
+{
+    Telemetry_Vibration_t msg = {
+        .time_ms = HAL_GetTick(),
+        .sequence = spectrum->sequence,
+        .resolution_Hz = spectrum->resolution_Hz,
+    };
+    for (int axis = VIBRATION_AXIS_GYRO_X; axis <= VIBRATION_AXIS_GYRO_Z; axis++)
+    {
+        for (int p = 0; p < VIBRATION_PEAKS; p++)
+        {
+            msg.freq_Hz[axis * VIBRATION_PEAKS + p] = spectrum->peaks[axis][p].freq_Hz;
+            msg.amplitude[axis * VIBRATION_PEAKS + p] = spectrum->peaks[axis][p].amplitude;
+        }
+    }
+    Telemetry_Send(&telemetry, TELEMETRY_MSG_VIBRATION, &msg, sizeof(msg));
+}
+#endif
 
 /* USER CODE END 0 */
 
@@ -89,7 +314,8 @@ int main(void)
     SystemClock_Config();
 
     /* USER CODE BEGIN SysInit */
-
+    CycleCounter_Init();
+    TimeBase_Init();
     /* USER CODE END SysInit */
 
     /* Initialize all configured peripherals */
@@ -99,11 +325,11 @@ int main(void)
     MX_I2C1_Init();
     /* USER CODE BEGIN 2 */
 
-    // LSM6DSO32_Handle_t lsm6dso32 = {
-    //     .hspi = &hspi2,
-    //     .csPort = CS_LSM6DSO32_GPIO_Port,
-    //     .csPin = CS_LSM6DSO32_Pin,
-    // };
+    LSM6DSO32_Handle_t lsm6dso32 = {
+        .hspi = &hspi2,
+        .csPort = CS_LSM6DSO32_GPIO_Port,
+        .csPin = CS_LSM6DSO32_Pin,
+    };
 
     // LIS2MDL_Handle_t lis2mdl = {
     //     .hspi = &hspi2,
@@ -145,19 +371,19 @@ int main(void)
     //     }
     // };
 
-    // while (LSM6DSO32_Init(&lsm6dso32))
-    // {
-    //     // 2 flash
-    //     HAL_GPIO_TogglePin(LD2_GPIO_Port, LD2_Pin);
-    //     HAL_Delay(100);
-    //     HAL_GPIO_TogglePin(LD2_GPIO_Port, LD2_Pin);
-    //     HAL_Delay(200);
-    //     HAL_GPIO_TogglePin(LD2_GPIO_Port, LD2_Pin);
-    //     HAL_Delay(100);
-    //     HAL_GPIO_TogglePin(LD2_GPIO_Port, LD2_Pin);
-
-    //     HAL_Delay(1000);
-    // };
+    while (LSM6DSO32_Init(&lsm6dso32))
+    {
+        // 2 flash
+        HAL_GPIO_TogglePin(LD2_GPIO_Port, LD2_Pin);
+        HAL_Delay(100);
+        HAL_GPIO_TogglePin(LD2_GPIO_Port, LD2_Pin);
+        HAL_Delay(200);
+        HAL_GPIO_TogglePin(LD2_GPIO_Port, LD2_Pin);
+        HAL_Delay(100);
+        HAL_GPIO_TogglePin(LD2_GPIO_Port, LD2_Pin);
+        HAL_Delay(1000);
+    };
+    SensorIMU_Init(&lsm6dso32);
 
     // while (LIS2MDL_Init(&lis2mdl))
     // {
@@ -191,6 +417,190 @@ int main(void)
         HAL_Delay(1000);
     };
 
+    AltitudeEstimator_t altitude;
+    AltitudeEstimator_Config_t altitudeConfig = {
+        .timeConstant_s = ALTITUDE_TIME_CONSTANT_S,
+    };
+    AltitudeEstimator_Init(&altitude, &altitudeConfig);
+
+    // IMU path, as SimLoop runs it: temperature compensation, filters, preintegration, attitude.
+    // Bias is learned whenever the board is still, in practice on the ground before take-off.
+    ImuTempComp_Config_t tempCompConfig = {
+        .gyroThreshold_rads = 0.05f,
+        .accelThreshold_mps2 = 0.3f,
+        .stationarySamples = 200,
+        .minBinSamples = 500,
+        .maxBinWeight = 5000,
+    };
+    ImuTempComp_Init(&imuTempComp, &tempCompConfig);
+    FilterBank_Config_t filterConfig = {
+        .sampleRate_Hz = 1e6f / IMU_SAMPLE_PERIOD_US,
+        .lpfStages = 2,
+        .gyroLpfCutoff_Hz = 150.0f,
+        .accelLpfCutoff_Hz = 30.0f,
+        .notchCount = 2,
+        .notchQ = 3.0f,
+        .notchMinFreq_Hz = 80.0f,
+        .notchMaxFreq_Hz = 400.0f,
+        .notchMaxSlew_Hz = 20.0f,
+        .notchMinAmplitude = 0.05f,
+    };
+    FilterBank_Init(&imuFilters, &filterConfig);
+    ImuPreint_Config_t preintConfig = {
+        .sampleRate_Hz = 1e6f / IMU_SAMPLE_PERIOD_US,
+    };
+    ImuPreint_Init(&imuPreint, &preintConfig);
+    AttitudeEstimator_Config_t attitudeConfig = {
+        .accelGain = ATTITUDE_ACCEL_GAIN,
+    };
+    AttitudeEstimator_Init(&attitude, &attitudeConfig);
+    // Raw samples at full rate; its spectrum steers the filter bank notches
+    VibrationAnalyzer_Config_t vibrationConfig = {
+        .sampleRate_Hz = 1e6f / IMU_SAMPLE_PERIOD_US,
+        .decimation = 1,
+        .gyroScale = IMU_GYRO_SCALE_RADS,
+        .accelScale = IMU_ACCEL_SCALE_MPS2,
+        .minFreq_Hz = VIBRATION_MIN_FREQ_HZ,
+    };
+    VibrationAnalyzer_Init(&vibration, &vibrationConfig);
+
+    RcInput_Config_t rcConfig = {
+        .protocol = RC_INPUT_PROTOCOL,
+    };
+    RcInput_Init(&rcInput, &rcConfig);
+
+    // Tuning of SimLoop_DefaultConfig, flown in the SIL; one update per IMU tick
+    FlightControl_Config_t controlConfig = {
+        .loopRate_Hz = 1e6f / IMU_SAMPLE_PERIOD_US,
+        .angleKp = {6.0f, 6.0f},
+        .maxAngle_rad = FLIGHT_MAX_ANGLE_RAD,
+        .maxRate_rads = {10.0f, 10.0f, 10.0f},
+        .dTermCutoff_Hz = 100.0f,
+        .setpointCutoff_Hz = 30.0f,
+    };
+    for (int axis = 0; axis < FLIGHT_AXIS_COUNT; axis++)
+    {
+        controlConfig.rate[axis] = (FlightControl_RateGains_t){0.08f, 0.4f, 0.0008f, 0.002f, 0.3f, 1.0f};
+    }
+    FlightControl_Init(&controlConfig);
+    Mixer_Config_t mixerConfig = {
+        .airmode = true,
+        .servoLimit = 1.0f,
+    };
+    Mixer_Init(&mixerConfig);
+#if MOTOR_OUTPUT_DSHOT
+    DShot_Config_t dshotConfig = {
+        .speed = DSHOT_OUTPUT_SPEED,
+        .motorCount = MIXER_OUTPUTS,
+    };
+    DShot_Init(&dshot, &dshotConfig);
+#endif
+
+    // Log download: 2000000 baud brings 384 KB down in about 2 s instead of 36 s
+    Telemetry_Config_t telemetryConfig = {
+        .huart = &huart2,
+#if TELEMETRY_HIGH_RATE
+        .mode = TELEMETRY_MODE_STREAM,
+        .baudRate = TELEMETRY_HIGH_RATE_BAUD,
+#else
+        .mode = TELEMETRY_MODE_QUEUE,
+        .baudRate = 0,
+#endif
+        .receive = true,
+    };
+    Telemetry_Init(&telemetry, &telemetryConfig);
+#if TELEMETRY_IMU_STREAM
+    ImuCompress_Config_t imuCompressConfig = {
+        .predictor = IMU_COMPRESS_LINEAR,
+        .keyInterval = IMU_COMPRESS_KEY_INTERVAL,
+    };
+    ImuCompress_InitEncoder(&imuCompress, &imuCompressConfig);
+#endif
+
+    // Flight log into the upper flash sectors, continuing after the last reset
+    Blackbox_Config_t blackboxConfig = {
+        .wordsPerService = BLACKBOX_WORDS_PER_SERVICE,
+    };
+    Blackbox_Init(&blackbox, &blackboxConfig);
+    // Erase the sector ahead now, on the ground: the 1-2 s stall is harmless before the loop
+    Blackbox_Service(&blackbox, true);
+    FlightLog_Config_t flightLogConfig = {
+        .sink = Blackbox_Write,
+        .ctx = &blackbox,
+        .header =
+            {
+                .loopRate_Hz = 1e6f / IMU_SAMPLE_PERIOD_US,
+                .gyroScale = IMU_GYRO_SCALE_RADS,
+                .accelScale = IMU_ACCEL_SCALE_MPS2,
+            },
+    };
+    FlightLog_Init(&flightLog, &flightLogConfig);
+    // Not SensorIMU_SetLog: every sample (~17 kB/s) would wrap the 384 KB blackbox in
+    // about 20 s; the event captures record the IMU around each trigger instead
+
+    // Button, launch and crash captures go into the same log, ~4 records per main-loop pass
+    EventCapture_Config_t captureConfig = {
+        .ring = captureRing,
+        .capacity = EVENT_CAPTURE_SAMPLES(EVENT_CAPTURE_RAM_BYTES),
+        .preSamples = EVENT_CAPTURE_PRE_SAMPLES,
+        .postSamples = EVENT_CAPTURE_POST_SAMPLES,
+        .accelScale_g = LSM6DSO32_ACCEL_SENS_8G_MG * 1e-3f,
+        .launchAccel_g = 2.0f,
+        .launchSamples = 20,
+        .crashAccel_g = 7.5f,
+        .sink = EventCapture_LogSink,
+        .ctx = &flightLog,
+        .samplesPerService = 4,
+    };
+    EventCapture_Init(&capture, &captureConfig);
+
+    LogDownload_Config_t logDownloadConfig = {
+        .read = LogSource_Read,
+        .size = LogSource_Size,
+        .origin = LogSource_Origin,
+        .send = LogLink_Send,
+        .ctx = &blackbox,
+        .window = LOG_DOWNLOAD_WINDOW,
+        .chunksPerService = LOG_DOWNLOAD_CHUNKS_PER_SERVICE,
+        .retryTimeout_ms = 200,
+        .sessionTimeout_ms = 2000,
+    };
+    LogDownload_Init(&logDownload, &logDownloadConfig);
+
+#if !TELEMETRY_TEXT_OUTPUT
+    const Telemetry_Schema_t schema = {
+        .hash = TELEMETRY_SCHEMA_HASH,
+        .messages = TELEMETRY_SCHEMA_MESSAGES,
+    };
+    Telemetry_Send(&telemetry, TELEMETRY_MSG_SCHEMA, &schema, sizeof(schema));
+    uint32_t lastSchema_ms = HAL_GetTick();
+    uint32_t vibrationSequence = 0; // none published yet
+    uint32_t lastStatus_ms = HAL_GetTick();
+#endif
+
+#ifdef TEXT_FORMAT_BENCHMARK
+    // One-off report: cycles of the old snprintf line vs text_format, and whether they match
+    TextFormat_Benchmark_t bench;
+    if (TextFormat_RunBenchmark(&bench) == 0)
+    {
+        char benchLine[TEXT_FORMAT_LINE_MAX];
+        TextFormat_t tf;
+        TextFormat_Init(&tf, benchLine, sizeof(benchLine));
+        TextFormat_Str(&tf, "bench snprintf: ");
+        TextFormat_Int(&tf, (int32_t)bench.snprintfCycles);
+        TextFormat_Str(&tf, ", text: ");
+        TextFormat_Int(&tf, (int32_t)bench.textFormatCycles);
+        TextFormat_Str(&tf, bench.identical ? ", same\r\n" : ", DIFF\r\n");
+        size_t benchLen = TextFormat_End(&tf);
+        if (benchLen > 0)
+        {
+            Telemetry_SendRaw(&telemetry, benchLine, benchLen);
+        }
+    }
+#endif
+
+    TimeBase_StartTick(IMU_SAMPLE_PERIOD_US, IMU_TICK_IRQ_PRIORITY, ImuTick);
+
     /* USER CODE END 2 */
 
     /* Infinite loop */
@@ -199,37 +609,175 @@ int main(void)
     float temp;
     uint8_t status = 0;
     int lastResult = 0;
-    char buffer[50];
+    int16_t imuTemp = 0;
+    bool imuTempValid = false;
+    uint32_t loopMaxCycles = 0; // since the last STATUS
+#if TELEMETRY_TEXT_OUTPUT
+    char buffer[TEXT_FORMAT_LINE_MAX];
+#endif
     while (1)
     {
+        uint32_t loopStart = CycleCounter_Read();
 
-        // lastResult = LSM6DSO32_ReadAccelRaw(&lsm6dso32, &accel);
         // lastResult = LIS2MDL_ReadMagneticRaw(&lis2mdl, &mag);
 
+        if (imu_data_due)
+        {
+            uint32_t time_us = imu_time_us;
+            imu_data_due = false;
+
+            SensorIMU_Sample_t imuSample;
+            if (SensorIMU_Read(time_us, &imuSample) == 0)
+            {
+                // Feeds the launch and crash detectors and the B1 button capture
+                EventCapture_Push(&capture, &imuSample);
+                VibrationAnalyzer_PushSample(&vibration, &imuSample.gyro, &imuSample.accel);
+#if TELEMETRY_IMU_STREAM
+                const int16_t imuRaw[IMU_COMPRESS_AXES] = {
+                    imuSample.accel.x, imuSample.accel.y, imuSample.accel.z,
+                    imuSample.gyro.x,  imuSample.gyro.y,  imuSample.gyro.z,
+                };
+                uint8_t imuBlock[IMU_COMPRESS_BLOCK_MAX];
+                size_t imuBlockLen = ImuCompress_Push(&imuCompress, imuRaw, time_us, imuBlock);
+                // Left out during a log download; the host decoder resyncs at the next keyframe
+                if (imuBlockLen > 0 && !LogDownload_Active(&logDownload))
+                {
+                    Telemetry_Send(&telemetry, TELEMETRY_MSG_IMU_BLOCK, imuBlock, imuBlockLen);
+                }
+#endif
+
+                // OUT_TEMP updates at 52 Hz: refresh the correction only when it changes
+                if (!imuTempValid || imuSample.temp != imuTemp)
+                {
+                    ImuTempComp_SetTemperature(&imuTempComp, ImuTempComp_RawTempToC(imuSample.temp));
+                    imuTemp = imuSample.temp;
+                    imuTempValid = true;
+                }
+                ImuTempComp_Update(&imuTempComp, &imuSample.gyro, &imuSample.accel);
+                float imuAxes[FILTER_BANK_AXES]; // gyro rad/s, then accel m/s^2
+                ImuTempComp_Convert(&imuTempComp, &imuSample.gyro, &imuSample.accel, &imuAxes[0], &imuAxes[3]);
+                float *const imuAxisData[FILTER_BANK_AXES] = {
+                    &imuAxes[0], &imuAxes[1], &imuAxes[2], &imuAxes[3], &imuAxes[4], &imuAxes[5],
+                };
+                FilterBank_Process(&imuFilters, imuAxisData, 1);
+
+                // One sample per tick; a FIFO batch would add several before the Take
+                ImuPreint_Delta_t imuDelta;
+                ImuPreint_AddSample(&imuPreint, &imuAxes[0], &imuAxes[3]);
+                ImuPreint_Take(&imuPreint, &imuDelta);
+                AttitudeEstimator_Update(&attitude, &imuDelta);
+                AltitudeEstimator_Predict(&altitude, AltitudeEstimator_VerticalAccel(attitude.q, &imuAxes[3]),
+                                          imuDelta.dt_s);
+
+                FlightControl_Setpoint_t setpoint;
+                RcSetpoint(&setpoint);
+                FlightLog_Setpoint(&flightLog, time_us, &setpoint); // written only when it changes
+
+                // Controller axes: roll right, pitch nose up, yaw nose right
+                FlightControl_State_t state = {
+                    .rate_rads = {imuAxes[0], -imuAxes[1], -imuAxes[2]},
+                };
+                AttitudeEstimator_RollPitch(&attitude, state.attitude_rad);
+                FlightControl_Output_t control;
+                FlightControl_Update(&state, &setpoint, &control);
+                Mixer_Mix(control.torque, control.throttle, &motors);
+                if (!setpoint.armed)
+                {
+                    // Airmode would spin the motors on a torque command even at zero throttle
+                    memset(motors.output, 0, sizeof(motors.output));
+                }
+#if MOTOR_OUTPUT_DSHOT
+                MotorsWrite(setpoint.armed);
+                if (!dshotTimingReported && dshotFrames >= DSHOT_TIMING_CHECK_FRAMES)
+                {
+                    dshotTimingReported = true;
+                    MotorsReportTiming();
+                }
+#endif
+            }
+            else
+            {
+                // Not lastResult: its error blink stalls the loop for a second
+                imuErrors++;
+            }
+        }
+
         if (lps22hb_data_ready)
         {
-            lastResult = LPS22HB_ReadPT_Burst_hPa_C(&lps22hb, &pressure, &temp);
+            FlightLog_Baro_t baroRaw;
+            lastResult = LPS22HB_ReadPT_Burst(&lps22hb, &baroRaw.pressure, &baroRaw.temp);
+            pressure = baroRaw.pressure / 4096.0f;
+            temp = baroRaw.temp / 100.0f;
 
             lps22hb_data_ready = false;
 
-            char *tmpSignPressure = (pressure < 0) ? "-" : "";
-            float tmpValPressure = (pressure < 0) ? -pressure : pressure;
+            FlightLog_Baro(&flightLog, lps22hb_time_us, &baroRaw);
+
+            // First sample captures the ground reference
+            AltitudeEstimator_UpdateBaro(&altitude, pressure, BARO_SAMPLE_PERIOD_S);
+
+#if TELEMETRY_TEXT_OUTPUT
+            // size_t len = TextFormat_Vector3(buffer, sizeof(buffer), mag.x, mag.y, mag.z);
+            size_t len = TextFormat_PressureTemp(buffer, sizeof(buffer), pressure, temp);
+            // Queued for DMA; dropped (and counted) if the link is backed up
+            // Text lines would be noise between download frames
+            if (!LogDownload_Active(&logDownload))
+            {
+                Telemetry_SendRaw(&telemetry, buffer, len);
+            }
+#else
+            Telemetry_Baro_t baro = {
+                .time_ms = HAL_GetTick(),
+                .pressure_hPa = pressure,
+                .temperature_C = temp,
+                .altitude_m = altitude.altitude_m,
+                .climbRate_mps = altitude.climbRate_mps,
+            };
+            Telemetry_Send(&telemetry, TELEMETRY_MSG_BARO, &baro, sizeof(baro));
+#endif
+        }
 
-            int tmpInt1Pressure = tmpValPressure;                     // Get the integer (678).
-            float tmpFracPressure = tmpValPressure - tmpInt1Pressure; // Get fraction (0.0123).
-            int tmpInt2Pressure = trunc(tmpFracPressure * 10000);     // Turn into integer (123).
+        // One FFT or peak search per pass; notches slew toward the tracked peaks between samples
+        if (VibrationAnalyzer_Step(&vibration))
+        {
+            FilterBank_TrackSpectrum(&imuFilters, VibrationAnalyzer_GetSpectrum(&vibration));
+        }
+        FilterBank_Retune(&imuFilters);
 
-            char *tmpSignTemp = (temp < 0) ? "-" : "";
-            float tmpValTemp = (temp < 0) ? -temp : temp;
+#if !TELEMETRY_TEXT_OUTPUT
+        // Once per published spectrum
+        const VibrationAnalyzer_Spectrum_t *spectrum = VibrationAnalyzer_GetSpectrum(&vibration);
+        if (spectrum->sequence != vibrationSequence)
+        {
+            vibrationSequence = spectrum->sequence;
+            SendVibration(spectrum);
+        }
 
-            int tmpInt1Temp = tmpValTemp;                 // Get the integer (678).
-            float tmpFracTemp = tmpValTemp - tmpInt1Temp; // Get fraction (0.0123).
-            int tmpInt2Temp = trunc(tmpFracTemp * 100);
+        if (HAL_GetTick() - lastSchema_ms >= TELEMETRY_SCHEMA_PERIOD_MS)
+        {
+            lastSchema_ms = HAL_GetTick();
+            Telemetry_Send(&telemetry, TELEMETRY_MSG_SCHEMA, &schema, sizeof(schema));
+        }
 
-            // int len = snprintf(buffer, sizeof(buffer), "x: %d, y: %d, z: %d\r\n", mag.x, mag.y, mag.z);
-            int len = snprintf(buffer, sizeof(buffer), "p: %s%d.%04d, t: %s%d.%02d\r\n", tmpSignPressure, tmpInt1Pressure, tmpInt2Pressure, tmpSignTemp, tmpInt1Temp, tmpInt2Temp);
-            HAL_UART_Transmit(&huart2, (uint8_t *)buffer, len, 1000);
+        if (HAL_GetTick() - lastStatus_ms >= TELEMETRY_STATUS_PERIOD_MS)
+        {
+            lastStatus_ms = HAL_GetTick();
+            const Telemetry_Stats_t *linkStats = &telemetry.stats;
+            Telemetry_Status_t linkStatus = {
+                .time_ms = lastStatus_ms,
+                .framesSent = linkStats->framesSent,
+                .framesDropped = linkStats->framesDropped,
+                .loopMaxCycles = loopMaxCycles > UINT16_MAX ? UINT16_MAX : (uint16_t)loopMaxCycles,
+#if TELEMETRY_HIGH_RATE
+                .queueHighWater = (uint8_t)(linkStats->bufferHighWater * 100u / TELEMETRY_STREAM_BUFFER_SIZE),
+#else
+                .queueHighWater = linkStats->highWater,
+#endif
+            };
+            Telemetry_Send(&telemetry, TELEMETRY_MSG_STATUS, &linkStatus, sizeof(linkStatus));
+            loopMaxCycles = 0;
         }
+#endif
 
         if (LPS22HB_Status(&lps22hb, &status) != 0)
         {
@@ -267,6 +815,20 @@ int main(void)
             HAL_GPIO_TogglePin(LD2_GPIO_Port, LD2_Pin);
         }
 
+        EventCapture_Service(&capture);
+
+        uint8_t hostBytes[64];
+        size_t hostLen = Telemetry_Receive(&telemetry, hostBytes, sizeof(hostBytes));
+        LogDownload_Feed(&logDownload, hostBytes, hostLen, HAL_GetTick());
+        LogDownload_Service(&logDownload, HAL_GetTick());
+
+        // Never erases here: once the sector erased at boot is full too, records are
+        // dropped (and counted) until the next boot
+        Blackbox_Service(&blackbox, false);
+
+        uint32_t loopCycles = CycleCounter_Read() - loopStart;
+        loopMaxCycles = loopCycles > loopMaxCycles ? loopCycles : loopMaxCycles;
+
         /* USER CODE END WHILE */
 
         /* USER CODE BEGIN 3 */
@@ -475,6 +1037,9 @@ static void MX_GPIO_Init(void)
     HAL_NVIC_EnableIRQ(EXTI4_IRQn);
 
     /* USER CODE BEGIN MX_GPIO_Init_2 */
+    // B1 starts an event capture; lowest priority, it only sets a flag
+    HAL_NVIC_SetPriority(EXTI15_10_IRQn, 15, 0);
+    HAL_NVIC_EnableIRQ(EXTI15_10_IRQn);
     /* USER CODE END MX_GPIO_Init_2 */
 }
 
@@ -484,8 +1049,13 @@ void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
 {
     if (GPIO_Pin == INT_LPS22_Pin)
     { // same pin as above
+        lps22hb_time_us = TimeBase_Now_us();
         lps22hb_data_ready = true;
     }
+    else if (GPIO_Pin == B1_Pin)
+    {
+        EventCapture_Trigger(&capture, EVENT_CAPTURE_TRIGGER_BUTTON);
+    }
 }
 
 /* USER CODE END 4 */
@@ -22,6 +22,10 @@
 #include "stm32f4xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "dshot.h"
+#include "rc_input.h"
+#include "telemetry.h"
+#include "timebase.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -214,4 +218,52 @@ void EXTI4_IRQHandler(void)
 
 /* USER CODE BEGIN 1 */
 
+/**
+  * @brief This function handles EXTI line[15:10] interrupts (B1, event capture).
+  */
+void EXTI15_10_IRQHandler(void)
+{
+  HAL_GPIO_EXTI_IRQHandler(B1_Pin);
+}
+
+/**
+  * @brief This function handles DMA2 stream5 global interrupt (TIM1_UP, DShot).
+  */
+void DMA2_Stream5_IRQHandler(void)
+{
+  DShot_DmaIrqHandler();
+}
+
+/**
+  * @brief This function handles USART6 global interrupt (RC receiver IDLE line).
+  */
+void USART6_IRQHandler(void)
+{
+  RcInput_UartIrqHandler();
+}
+
+/**
+  * @brief This function handles DMA1 stream6 global interrupt (USART2_TX, telemetry).
+  */
+void DMA1_Stream6_IRQHandler(void)
+{
+  Telemetry_DmaIrqHandler();
+}
+
+/**
+  * @brief This function handles DMA1 stream5 global interrupt (USART2_RX, telemetry).
+  */
+void DMA1_Stream5_IRQHandler(void)
+{
+  Telemetry_RxDmaIrqHandler();
+}
+
+/**
+  * @brief This function handles TIM5 global interrupt (timebase tick, IMU pacing).
+  */
+void TIM5_IRQHandler(void)
+{
+  TimeBase_IrqHandler();
+}
+
 /* USER CODE END 1 */
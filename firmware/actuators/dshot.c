@@ -0,0 +1,211 @@
+#include "dshot.h"
+#include "cycle_counter.h"
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL DEFINITIONS                                                       */
+/*----------------------------------------------------------------------------*/
+
+static DShot_Handle_t *s_active = NULL; ///< Handle served by DShot_DmaIrqHandler
+
+static const uint32_t s_channels[DSHOT_MAX_MOTORS] = {TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_3, TIM_CHANNEL_4};
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @brief TIM1 kernel clock: PCLK2, doubled when the APB2 prescaler is not 1
+ */
+static uint32_t DShot_TimerClock(void)
+{
+    uint32_t pclk2 = HAL_RCC_GetPCLK2Freq();
+    return ((RCC->CFGR & RCC_CFGR_PPRE2) == 0) ? pclk2 : 2u * pclk2;
+}
+
+/**
+ * @brief End of frame: stop update DMA requests and record the frame time
+ */
+static void DShot_DmaComplete(DMA_HandleTypeDef *hdma)
+{
+    DShot_Handle_t *dev = (DShot_Handle_t *)hdma->Parent;
+    __HAL_TIM_DISABLE_DMA(&dev->htim, TIM_DMA_UPDATE);
+    dev->lastFrameCycles = CycleCounter_Read() - dev->startCycles;
+    dev->busy = false;
+}
+
+static void DShot_DmaError(DMA_HandleTypeDef *hdma)
+{
+    DShot_Handle_t *dev = (DShot_Handle_t *)hdma->Parent;
+    __HAL_TIM_DISABLE_DMA(&dev->htim, TIM_DMA_UPDATE);
+    dev->busy = false;
+}
+
+static void DShot_InitPins(uint8_t motorCount)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    for (uint8_t m = 0; m < motorCount; m++)
+    {
+        GPIO_InitStruct.Pin |= (uint32_t)GPIO_PIN_8 << m;
+    }
+    GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+    GPIO_InitStruct.Pull = GPIO_PULLDOWN;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+    GPIO_InitStruct.Alternate = GPIO_AF1_TIM1;
+    HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+}
+
+static int DShot_InitDma(DShot_Handle_t *dev)
+{
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    dev->hdma.Instance = DMA2_Stream5;
+    dev->hdma.Init.Channel = DMA_CHANNEL_6;
+    dev->hdma.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    dev->hdma.Init.PeriphInc = DMA_PINC_DISABLE;
+    dev->hdma.Init.MemInc = DMA_MINC_ENABLE;
+    dev->hdma.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    dev->hdma.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+    dev->hdma.Init.Mode = DMA_NORMAL;
+    dev->hdma.Init.Priority = DMA_PRIORITY_HIGH;
+    dev->hdma.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    if (HAL_DMA_Init(&dev->hdma) != HAL_OK)
+    {
+        return -1;
+    }
+
+    dev->hdma.Parent = dev;
+    dev->hdma.XferCpltCallback = DShot_DmaComplete;
+    dev->hdma.XferErrorCallback = DShot_DmaError;
+
+    HAL_NVIC_SetPriority(DMA2_Stream5_IRQn, 1, 0);
+    HAL_NVIC_EnableIRQ(DMA2_Stream5_IRQn);
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+int DShot_Init(DShot_Handle_t *dev, const DShot_Config_t *cfg)
+{
+    if (!dev || !cfg || cfg->motorCount == 0 || cfg->motorCount > DSHOT_MAX_MOTORS)
+    {
+        return -1;
+    }
+
+    dev->config = *cfg;
+    dev->busy = false;
+    dev->lastFrameCycles = 0;
+
+    if (DShot_ComputeTiming(DShot_TimerClock(), cfg->speed, &dev->timing) != 0)
+    {
+        return -2;
+    }
+
+    __HAL_RCC_TIM1_CLK_ENABLE();
+    DShot_InitPins(cfg->motorCount);
+    if (DShot_InitDma(dev) != 0)
+    {
+        return -3;
+    }
+
+    dev->htim.Instance = TIM1;
+    dev->htim.Init.Prescaler = 0;
+    dev->htim.Init.CounterMode = TIM_COUNTERMODE_UP;
+    dev->htim.Init.Period = dev->timing.period - 1u;
+    dev->htim.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    dev->htim.Init.RepetitionCounter = 0;
+    dev->htim.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+    if (HAL_TIM_PWM_Init(&dev->htim) != HAL_OK)
+    {
+        return -4;
+    }
+
+    // Compare preload is enabled by ConfigChannel: each burst takes effect
+    // on the following period, so every bit gets a full period
+    TIM_OC_InitTypeDef sConfigOC = {0};
+    sConfigOC.OCMode = TIM_OCMODE_PWM1;
+    sConfigOC.Pulse = 0;
+    sConfigOC.OCPolarity = TIM_OCPOLARITY_HIGH;
+    sConfigOC.OCNPolarity = TIM_OCNPOLARITY_HIGH;
+    sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
+    sConfigOC.OCIdleState = TIM_OCIDLESTATE_RESET;
+    sConfigOC.OCNIdleState = TIM_OCNIDLESTATE_RESET;
+    for (uint8_t m = 0; m < cfg->motorCount; m++)
+    {
+        if (HAL_TIM_PWM_ConfigChannel(&dev->htim, &sConfigOC, s_channels[m]) != HAL_OK ||
+            HAL_TIM_PWM_Start(&dev->htim, s_channels[m]) != HAL_OK)
+        {
+            return -5;
+        }
+    }
+
+    // DMA bursts write CCR1.. through DMAR, one transfer per motor
+    dev->htim.Instance->DCR = TIM_DMABASE_CCR1 | ((uint32_t)(cfg->motorCount - 1u) << TIM_DCR_DBL_Pos);
+
+    s_active = dev;
+    return 0;
+}
+
+int DShot_Write(DShot_Handle_t *dev, const uint16_t *values, bool telemetry)
+{
+    if (!dev || !values)
+    {
+        return -1;
+    }
+    if (dev->busy)
+    {
+        return -2;
+    }
+
+    uint16_t frames[DSHOT_MAX_MOTORS];
+    for (uint8_t m = 0; m < dev->config.motorCount; m++)
+    {
+        frames[m] = DShot_EncodeFrame(values[m], telemetry);
+    }
+    DShot_FillBuffer(frames, dev->config.motorCount, &dev->timing, dev->buffer);
+
+    dev->busy = true;
+    dev->startCycles = CycleCounter_Read();
+    if (HAL_DMA_Start_IT(&dev->hdma, (uint32_t)dev->buffer, (uint32_t)&dev->htim.Instance->DMAR,
+                         (uint32_t)DSHOT_BUFFER_SLOTS * dev->config.motorCount) != HAL_OK)
+    {
+        dev->busy = false;
+        return -1;
+    }
+    __HAL_TIM_ENABLE_DMA(&dev->htim, TIM_DMA_UPDATE);
+
+    return 0;
+}
+
+int DShot_CheckTiming(const DShot_Handle_t *dev, float *measured_us)
+{
+    if (!dev || dev->lastFrameCycles == 0)
+    {
+        return -1;
+    }
+
+    float cyclesPerUs = (float)SystemCoreClock * 1e-6f;
+    float bit_us = 1000.0f / (float)dev->config.speed;
+    float frame_us = (float)dev->lastFrameCycles / cyclesPerUs;
+    if (measured_us)
+    {
+        *measured_us = frame_us;
+    }
+
+    // Transfers happen on update events: the first one 0..1 period after the
+    // start, then one per period until the last slot is loaded
+    float min_us = (float)(DSHOT_BUFFER_SLOTS - 2) * bit_us;
+    float max_us = (float)(DSHOT_BUFFER_SLOTS + 1) * bit_us;
+    return (frame_us >= min_us && frame_us <= max_us) ? 0 : -2;
+}
+
+void DShot_DmaIrqHandler(void)
+{
+    if (s_active)
+    {
+        HAL_DMA_IRQHandler(&s_active->hdma);
+    }
+}
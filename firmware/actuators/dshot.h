@@ -0,0 +1,81 @@
+#ifndef DSHOT_H
+#define DSHOT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "stm32f4xx_hal.h"
+#include "dshot_frame.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Hardware: TIM1 CH1..CH4 on PA8..PA11 (AF1), update DMA on DMA2 Stream 5
+ * channel 6. Each update event bursts the next bit's compare values into
+ * CCR1..CCRn through TIM1->DMAR, so a frame costs the CPU one encode and
+ * one DMA start. DMA2_Stream5_IRQHandler must call DShot_DmaIrqHandler.
+ */
+
+    typedef struct
+    {
+        uint16_t speed;     ///< enum DShot_Speed
+        uint8_t motorCount; ///< Channels driven, 1..DSHOT_MAX_MOTORS
+    } DShot_Config_t;
+
+    /**
+     * @brief Driver handle. Owns the timer, DMA stream and bit buffer.
+     */
+    typedef struct
+    {
+        DShot_Config_t config;   ///< Output configuration
+        TIM_HandleTypeDef htim;  ///< TIM1 handle
+        DMA_HandleTypeDef hdma;  ///< TIM1_UP DMA handle
+        DShot_BitTiming_t timing;
+
+        uint32_t buffer[DSHOT_BUFFER_SLOTS * DSHOT_MAX_MOTORS]; ///< [slot][motor] compare values
+        volatile bool busy;                 ///< Frame in flight
+
+        uint32_t startCycles;               ///< DWT count at DMA start
+        volatile uint32_t lastFrameCycles;  ///< Measured start-to-complete time of the last frame
+    } DShot_Handle_t;
+
+    /**
+     * @brief Configure TIM1, its pins and DMA stream, and start the PWM outputs at 0 duty
+     * @param[out] dev Pointer to driver handle
+     * @param[in]  cfg Pointer to configuration
+     * @retval  0 on success, negative on error
+     */
+    int DShot_Init(DShot_Handle_t *dev, const DShot_Config_t *cfg);
+
+    /**
+     * @brief Send one frame per motor
+     * @param[in,out] dev       Pointer to driver handle
+     * @param[in]     values    DShot value per motor (0 = disarm, 48..2047 throttle)
+     * @param[in]     telemetry Set the telemetry request bit
+     * @retval  0 on success, -1 on error, -2 while the previous frame is still in flight
+     */
+    int DShot_Write(DShot_Handle_t *dev, const uint16_t *values, bool telemetry);
+
+    /**
+     * @brief Check the last frame duration against the nominal bit period
+     *        Run on target after a few frames: catches a wrong timer clock or
+     *        DMA stalls. Nominal is DSHOT_BUFFER_SLOTS bit periods, +-1 period
+     *        for the phase of the first update event.
+     * @param[in]  dev        Pointer to driver handle
+     * @param[out] measured_us Measured frame time (may be NULL)
+     * @retval  0 within tolerance, -1 no frame measured, -2 out of tolerance
+     */
+    int DShot_CheckTiming(const DShot_Handle_t *dev, float *measured_us);
+
+    /**
+     * @brief DMA interrupt entry point, call from DMA2_Stream5_IRQHandler
+     */
+    void DShot_DmaIrqHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DSHOT_H
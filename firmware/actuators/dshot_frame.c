@@ -0,0 +1,68 @@
+#include "dshot_frame.h"
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+int DShot_ComputeTiming(uint32_t timerClock_Hz, uint16_t speed, DShot_BitTiming_t *timing)
+{
+    if (!timing || (speed != DSHOT_SPEED_150 && speed != DSHOT_SPEED_300 && speed != DSHOT_SPEED_600))
+    {
+        return -1;
+    }
+
+    uint32_t bitRate = (uint32_t)speed * 1000u;
+    uint32_t period = (timerClock_Hz + bitRate / 2u) / bitRate;
+    if (period < 16u || period > 65535u)
+    {
+        return -2; // too coarse to shape the duty cycles, or does not fit a 16-bit timer
+    }
+
+    timing->period = (uint16_t)period;
+    timing->t0h = (uint16_t)((period * 3u + 4u) / 8u);
+    timing->t1h = (uint16_t)((period * 3u + 2u) / 4u);
+    return 0;
+}
+
+uint16_t DShot_EncodeFrame(uint16_t value, bool telemetry)
+{
+    if (value > DSHOT_VALUE_MAX_THROTTLE)
+    {
+        value = DSHOT_VALUE_MAX_THROTTLE;
+    }
+
+    uint16_t packet = (uint16_t)((value << 1) | (telemetry ? 1u : 0u));
+    uint16_t crc = (packet ^ (packet >> 4) ^ (packet >> 8)) & 0x0Fu;
+    return (uint16_t)((packet << 4) | crc);
+}
+
+uint16_t DShot_ThrottleToValue(float throttle)
+{
+    if (throttle <= 0.0f)
+    {
+        return DSHOT_VALUE_MIN_THROTTLE;
+    }
+    if (throttle >= 1.0f)
+    {
+        return DSHOT_VALUE_MAX_THROTTLE;
+    }
+    float span = (float)(DSHOT_VALUE_MAX_THROTTLE - DSHOT_VALUE_MIN_THROTTLE);
+    return (uint16_t)(DSHOT_VALUE_MIN_THROTTLE + (uint16_t)(throttle * span + 0.5f));
+}
+
+void DShot_FillBuffer(const uint16_t *frames, uint8_t motors, const DShot_BitTiming_t *timing, uint32_t *buffer)
+{
+    for (uint8_t m = 0; m < motors; m++)
+    {
+        uint16_t frame = frames[m];
+        for (int bit = 0; bit < DSHOT_FRAME_BITS; bit++)
+        {
+            bool one = (frame & (0x8000u >> bit)) != 0;
+            buffer[bit * motors + m] = one ? timing->t1h : timing->t0h;
+        }
+        for (int slot = DSHOT_FRAME_BITS; slot < DSHOT_BUFFER_SLOTS; slot++)
+        {
+            buffer[slot * motors + m] = 0;
+        }
+    }
+}
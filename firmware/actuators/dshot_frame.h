@@ -0,0 +1,83 @@
+#ifndef DSHOT_FRAME_H
+#define DSHOT_FRAME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * DShot frame: 11-bit value, 1 telemetry request bit, 4-bit CRC, MSB first.
+ * Each bit is one timer period; a 0 is high for 37.5 % of it, a 1 for 75 %.
+ * Nothing in this file touches the hardware so it builds on the host.
+ */
+#define DSHOT_MAX_MOTORS 4
+#define DSHOT_FRAME_BITS 16
+#define DSHOT_RESET_SLOTS 2 // zero-duty periods after the frame: line idles low, CCRs end at 0
+#define DSHOT_BUFFER_SLOTS (DSHOT_FRAME_BITS + DSHOT_RESET_SLOTS)
+
+#define DSHOT_VALUE_DISARM 0         // motor stop, the only value ESCs accept before arming
+#define DSHOT_VALUE_MAX_COMMAND 47   // 1..47 are special commands (beep, direction, save...)
+#define DSHOT_VALUE_MIN_THROTTLE 48
+#define DSHOT_VALUE_MAX_THROTTLE 2047
+
+    enum DShot_Speed
+    {
+        DSHOT_SPEED_150 = 150, ///< kbit/s
+        DSHOT_SPEED_300 = 300,
+        DSHOT_SPEED_600 = 600,
+    };
+
+    /**
+     * @brief Bit timing in timer ticks
+     */
+    typedef struct
+    {
+        uint16_t period; ///< Ticks per bit (ARR + 1)
+        uint16_t t0h;    ///< High time of a 0 bit
+        uint16_t t1h;    ///< High time of a 1 bit
+    } DShot_BitTiming_t;
+
+    /**
+     * @brief Derive the bit timing for a timer clock (prescaler 0)
+     * @param[in]  timerClock_Hz Timer kernel clock
+     * @param[in]  speed         enum DShot_Speed
+     * @param[out] timing        Resulting tick counts
+     * @retval  0 on success, negative if the speed cannot be generated
+     */
+    int DShot_ComputeTiming(uint32_t timerClock_Hz, uint16_t speed, DShot_BitTiming_t *timing);
+
+    /**
+     * @brief Build a 16-bit frame: value << 5 | telemetry << 4 | crc
+     * @param[in] value     0..2047 (larger values are clamped)
+     * @param[in] telemetry Request ESC telemetry on the telemetry wire
+     * @return Frame, MSB sent first
+     */
+    uint16_t DShot_EncodeFrame(uint16_t value, bool telemetry);
+
+    /**
+     * @brief Map a normalized throttle to a DShot value
+     * @param[in] throttle 0..1 (clamped)
+     * @return DSHOT_VALUE_MIN_THROTTLE..DSHOT_VALUE_MAX_THROTTLE
+     */
+    uint16_t DShot_ThrottleToValue(float throttle);
+
+    /**
+     * @brief Expand frames into the timer burst buffer
+     *        Layout is [slot][motor]: one DMA burst per timer update writes the
+     *        compare registers of every channel for that bit.
+     * @param[in]  frames Frame per motor
+     * @param[in]  motors Number of channels (1..DSHOT_MAX_MOTORS)
+     * @param[in]  timing Bit timing
+     * @param[out] buffer DSHOT_BUFFER_SLOTS * motors compare values
+     */
+    void DShot_FillBuffer(const uint16_t *frames, uint8_t motors, const DShot_BitTiming_t *timing, uint32_t *buffer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DSHOT_FRAME_H
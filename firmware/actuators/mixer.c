@@ -0,0 +1,123 @@
+#include "mixer.h"
+#include "cycle_counter.h"
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL DEFINITIONS                                                       */
+/*----------------------------------------------------------------------------*/
+
+static Mixer_Config_t s_config = {
+    .airmode = true,
+    .servoLimit = 1.0f,
+};
+static Mixer_Stats_t s_stats;
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+static inline float Mixer_Clamp(float v, float lo, float hi)
+{
+    return (v > hi) ? hi : ((v < lo) ? lo : v);
+}
+
+/**
+ * @brief Torque part of every output, expanded from the airframe table
+ */
+static inline void Mixer_ApplyTable(const float torque[3], float *output)
+{
+    const float roll = torque[0];
+    const float pitch = torque[1];
+    const float yaw = torque[2];
+    float *o = output;
+
+#define MIXER_ROW(r, p, y) *o++ = (r) * roll + (p) * pitch + (y) * yaw;
+    MIXER_TABLE(MIXER_ROW)
+#undef MIXER_ROW
+}
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+int Mixer_Init(const Mixer_Config_t *cfg)
+{
+    if (!cfg || cfg->servoLimit < 0.0f || cfg->servoLimit > 1.0f)
+    {
+        return -1;
+    }
+
+    s_config = *cfg;
+    s_stats.lastCycles = 0;
+    s_stats.maxCycles = 0;
+    return 0;
+}
+
+void Mixer_Mix(const float torque[3], float throttle, Mixer_Output_t *out)
+{
+    uint32_t start = CycleCounter_Read();
+
+    Mixer_ApplyTable(torque, out->output);
+    throttle = Mixer_Clamp(throttle, 0.0f, 1.0f);
+    out->saturated = false;
+
+#if MIXER_IS_MOTOR_FRAME
+    float lo = out->output[0];
+    float hi = out->output[0];
+    for (int i = 1; i < MIXER_OUTPUTS; i++) // constant trip count, unrolled by the compiler
+    {
+        lo = (out->output[i] < lo) ? out->output[i] : lo;
+        hi = (out->output[i] > hi) ? out->output[i] : hi;
+    }
+
+    // Desaturation: keep the torque ratios, shrink the spread to the output range
+    float spread = hi - lo;
+    if (spread > 1.0f)
+    {
+        float scale = 1.0f / spread;
+        for (int i = 0; i < MIXER_OUTPUTS; i++)
+        {
+            out->output[i] *= scale;
+        }
+        lo *= scale;
+        hi *= scale;
+        out->saturated = true;
+    }
+
+    if (s_config.airmode)
+    {
+        // Move collective so the lowest motor is >= 0 and the highest <= 1
+        throttle = Mixer_Clamp(throttle, -lo, 1.0f - hi);
+    }
+    else if (throttle > 1.0f - hi)
+    {
+        // Without airmode only the top is protected; low-throttle authority is clipped
+        throttle = 1.0f - hi;
+    }
+
+    for (int i = 0; i < MIXER_OUTPUTS; i++)
+    {
+        out->output[i] = Mixer_Clamp(out->output[i] + throttle, 0.0f, 1.0f);
+    }
+#else
+    for (int i = 0; i < MIXER_OUTPUTS; i++)
+    {
+        float v = out->output[i];
+        float limited = Mixer_Clamp(v, -s_config.servoLimit, s_config.servoLimit);
+        out->saturated |= (limited != v);
+        out->output[i] = limited;
+    }
+#endif
+    out->throttle = throttle;
+
+    uint32_t cycles = CycleCounter_Read() - start;
+    s_stats.lastCycles = cycles;
+    if (cycles > s_stats.maxCycles)
+    {
+        s_stats.maxCycles = cycles;
+    }
+}
+
+const Mixer_Stats_t *Mixer_GetStats(void)
+{
+    return &s_stats;
+}
@@ -0,0 +1,126 @@
+#ifndef MIXER_H
+#define MIXER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*----------------------------------------------------------------------------*/
+/* AIRFRAME TABLES                                                            */
+/*----------------------------------------------------------------------------*/
+/*
+ * The airframe is chosen at build time (STFLIGHT_MIXER_FRAME in CMakeLists.txt
+ * defines one MIXER_FRAME_*). Each table is an X-macro of rows
+ *     X(roll, pitch, yaw)
+ * in output order, so Mixer_Mix expands to one multiply-add line per output
+ * with the coefficients as immediates: no loop over a runtime matrix.
+ *
+ * Motor frames use Betaflight motor order and sign conventions (roll right,
+ * pitch nose up and yaw nose right positive). Servo frames produce symmetric
+ * deflections and pass throttle through separately.
+ */
+#if !defined(MIXER_FRAME_QUAD_X) && !defined(MIXER_FRAME_HEX_X) && !defined(MIXER_FRAME_OCTO_X) && \
+    !defined(MIXER_FRAME_FIN_4)
+#define MIXER_FRAME_QUAD_X
+#endif
+
+#if defined(MIXER_FRAME_QUAD_X)
+#define MIXER_OUTPUTS 4
+#define MIXER_IS_MOTOR_FRAME 1
+#define MIXER_TABLE(X)       \
+    X(-1.0f, 1.0f, -1.0f)  /* rear right  */ \
+    X(-1.0f, -1.0f, 1.0f)  /* front right */ \
+    X(1.0f, 1.0f, 1.0f)    /* rear left   */ \
+    X(1.0f, -1.0f, -1.0f)  /* front left  */
+
+#elif defined(MIXER_FRAME_HEX_X)
+#define MIXER_OUTPUTS 6
+#define MIXER_IS_MOTOR_FRAME 1
+#define MIXER_TABLE(X)            \
+    X(-0.5f, 0.866025f, 1.0f)   /* rear right  */ \
+    X(-0.5f, -0.866025f, 1.0f)  /* front right */ \
+    X(0.5f, 0.866025f, -1.0f)   /* rear left   */ \
+    X(0.5f, -0.866025f, -1.0f)  /* front left  */ \
+    X(-1.0f, 0.0f, -1.0f)       /* right       */ \
+    X(1.0f, 0.0f, 1.0f)         /* left        */
+
+#elif defined(MIXER_FRAME_OCTO_X)
+// Motors every 45 degrees, 22.5 degrees off the axes: the short arm component is tan(22.5) = 0.414178
+#define MIXER_OUTPUTS 8
+#define MIXER_IS_MOTOR_FRAME 1
+#define MIXER_TABLE(X)             \
+    X(1.0f, -0.414178f, 1.0f)    /* mid front left  */ \
+    X(-0.414178f, -1.0f, 1.0f)   /* front right     */ \
+    X(-1.0f, 0.414178f, 1.0f)    /* mid rear right  */ \
+    X(0.414178f, 1.0f, 1.0f)     /* rear left       */ \
+    X(0.414178f, -1.0f, -1.0f)   /* front left      */ \
+    X(-1.0f, -0.414178f, -1.0f)  /* mid front right */ \
+    X(-0.414178f, 1.0f, -1.0f)   /* rear right      */ \
+    X(1.0f, 0.414178f, -1.0f)    /* mid rear left   */
+
+#elif defined(MIXER_FRAME_FIN_4)
+// Four fins in "+" seen from behind; positive deflection rolls the airframe right
+#define MIXER_OUTPUTS 4
+#define MIXER_IS_MOTOR_FRAME 0
+#define MIXER_TABLE(X)       \
+    X(1.0f, 0.0f, 1.0f)    /* top    */ \
+    X(1.0f, 1.0f, 0.0f)    /* right  */ \
+    X(1.0f, 0.0f, -1.0f)   /* bottom */ \
+    X(1.0f, -1.0f, 0.0f)   /* left   */
+
+#else
+#error "Unknown MIXER_FRAME_*"
+#endif
+
+    typedef struct
+    {
+        bool airmode;      ///< Motor frames: shift throttle to keep full authority at low and high throttle
+        float servoLimit;  ///< Servo frames: deflection clamp, 0..1
+    } Mixer_Config_t;
+
+    typedef struct
+    {
+        float output[MIXER_OUTPUTS]; ///< Motors 0..1, servos -1..1
+        float throttle;              ///< Collective actually applied (motor frames: after desaturation)
+        bool saturated;              ///< Requested torque did not fit and was scaled down
+    } Mixer_Output_t;
+
+    typedef struct
+    {
+        uint32_t lastCycles; ///< DWT cycles of the last Mixer_Mix
+        uint32_t maxCycles;  ///< Worst case seen
+    } Mixer_Stats_t;
+
+    /**
+     * @brief Set the runtime options of the build-time airframe
+     * @param[in] cfg Pointer to configuration (copied)
+     * @retval  0 on success, negative on error
+     */
+    int Mixer_Init(const Mixer_Config_t *cfg);
+
+    /**
+     * @brief Mix controller outputs into actuator commands
+     *        Motor frames: the torque part is scaled down when its spread exceeds
+     *        the 0..1 output range (at most one division), then throttle is
+     *        shifted (airmode) or capped so every motor stays in range.
+     * @param[in]  torque   Roll, pitch, yaw commands (FlightControl_Output_t.torque)
+     * @param[in]  throttle Collective, 0..1
+     * @param[out] out      Actuator commands
+     */
+    void Mixer_Mix(const float torque[3], float throttle, Mixer_Output_t *out);
+
+    /**
+     * @brief Cycle statistics of Mixer_Mix
+     * @return Pointer to the statistics (valid for the program lifetime)
+     */
+    const Mixer_Stats_t *Mixer_GetStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MIXER_H
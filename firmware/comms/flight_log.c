@@ -0,0 +1,414 @@
+#include "flight_log.h"
+#include <string.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL DEFINITIONS                                                       */
+/*----------------------------------------------------------------------------*/
+
+#define FLIGHT_LOG_MAX_VARINT 5
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+static inline void FlightLog_Put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void FlightLog_Put32(uint8_t *p, uint32_t v)
+{
+    FlightLog_Put16(p, (uint16_t)v);
+    FlightLog_Put16(p + 2, (uint16_t)(v >> 16));
+}
+
+static inline void FlightLog_PutFloat(uint8_t *p, float f)
+{
+    uint32_t v;
+    memcpy(&v, &f, sizeof(v));
+    FlightLog_Put32(p, v);
+}
+
+static inline uint16_t FlightLog_Get16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t FlightLog_Get32(const uint8_t *p)
+{
+    return (uint32_t)FlightLog_Get16(p) | ((uint32_t)FlightLog_Get16(p + 2) << 16);
+}
+
+static inline float FlightLog_GetFloat(const uint8_t *p)
+{
+    uint32_t v = FlightLog_Get32(p);
+    float f;
+    memcpy(&f, &v, sizeof(f));
+    return f;
+}
+
+static void FlightLog_Put16s(uint8_t *p, const int16_t *v, int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        FlightLog_Put16(&p[2 * i], (uint16_t)v[i]);
+    }
+}
+
+static void FlightLog_Get16s(const uint8_t *p, int16_t *v, int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        v[i] = (int16_t)FlightLog_Get16(&p[2 * i]);
+    }
+}
+
+static void FlightLog_PutImu(uint8_t *p, const FlightLog_Imu_t *imu)
+{
+    FlightLog_Put16(p, (uint16_t)imu->temp);
+    FlightLog_Put16s(&p[2], imu->gyro, 3);
+    FlightLog_Put16s(&p[8], imu->accel, 3);
+}
+
+/**
+ * @brief Record prefix: type and the time since the last written record
+ * @return Bytes written (2..1 + FLIGHT_LOG_MAX_VARINT)
+ */
+static size_t FlightLog_Begin(const FlightLog_t *log, uint8_t type, uint32_t time_us, uint8_t *out)
+{
+    uint32_t dt = time_us - log->lastTime_us;
+    size_t n = 0;
+    out[n++] = type;
+    while (dt >= 0x80u)
+    {
+        out[n++] = (uint8_t)(dt | 0x80u);
+        dt >>= 7;
+    }
+    out[n++] = (uint8_t)dt;
+    return n;
+}
+
+/**
+ * @brief Check a header at data and decode it
+ * @return Header size, -1 not a header or truncated, -2 unsupported version
+ */
+static int FlightLog_ParseHeader(const uint8_t *data, size_t len, FlightLog_Header_t *header)
+{
+    if (len < FLIGHT_LOG_HEADER_SIZE || memcmp(data, FLIGHT_LOG_MAGIC, 4) != 0 ||
+        data[5] < FLIGHT_LOG_HEADER_SIZE || data[5] > len)
+    {
+        return -1;
+    }
+    if (data[4] != FLIGHT_LOG_VERSION)
+    {
+        return -2;
+    }
+
+    header->loopRate_Hz = FlightLog_GetFloat(&data[8]);
+    header->gyroScale = FlightLog_GetFloat(&data[12]);
+    header->accelScale = FlightLog_GetFloat(&data[16]);
+    return data[5];
+}
+
+/**
+ * @brief Hand a record to the sink, reporting earlier drops first
+ */
+static int FlightLog_Commit(FlightLog_t *log, uint32_t time_us, const uint8_t *record, size_t len)
+{
+    if (log->pendingGap)
+    {
+        uint8_t gap[1 + FLIGHT_LOG_MAX_VARINT + FLIGHT_LOG_GAP_SIZE];
+        size_t n = FlightLog_Begin(log, FLIGHT_LOG_GAP, log->lastTime_us, gap);
+        FlightLog_Put16(&gap[n], log->pendingGap);
+        n += FLIGHT_LOG_GAP_SIZE;
+        if (log->config.sink(log->config.ctx, gap, (uint16_t)n) != 0)
+        {
+            log->pendingGap = log->pendingGap < UINT16_MAX ? (uint16_t)(log->pendingGap + 1) : UINT16_MAX;
+            log->stats.dropped++;
+            return -1;
+        }
+        log->pendingGap = 0;
+        log->stats.records++;
+        log->stats.bytes += (uint32_t)n;
+    }
+
+    if (log->config.sink(log->config.ctx, record, (uint16_t)len) != 0)
+    {
+        log->pendingGap = log->pendingGap < UINT16_MAX ? (uint16_t)(log->pendingGap + 1) : UINT16_MAX;
+        log->stats.dropped++;
+        return -1;
+    }
+    log->lastTime_us = time_us;
+    log->stats.records++;
+    log->stats.bytes += (uint32_t)len;
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+int FlightLog_Init(FlightLog_t *log, const FlightLog_Config_t *cfg)
+{
+    if (!log || !cfg || !cfg->sink)
+    {
+        return -1;
+    }
+
+    memset(log, 0, sizeof(*log));
+    log->config = *cfg;
+
+    uint8_t header[FLIGHT_LOG_HEADER_SIZE] = {0};
+    memcpy(header, FLIGHT_LOG_MAGIC, 4);
+    header[4] = FLIGHT_LOG_VERSION;
+    header[5] = FLIGHT_LOG_HEADER_SIZE;
+    FlightLog_PutFloat(&header[8], cfg->header.loopRate_Hz);
+    FlightLog_PutFloat(&header[12], cfg->header.gyroScale);
+    FlightLog_PutFloat(&header[16], cfg->header.accelScale);
+    if (cfg->sink(cfg->ctx, header, FLIGHT_LOG_HEADER_SIZE) != 0)
+    {
+        return -2;
+    }
+    log->stats.bytes = FLIGHT_LOG_HEADER_SIZE;
+    return 0;
+}
+
+int FlightLog_Imu(FlightLog_t *log, uint32_t time_us, const FlightLog_Imu_t *imu)
+{
+    uint8_t r[FLIGHT_LOG_RECORD_MAX];
+    size_t n = FlightLog_Begin(log, FLIGHT_LOG_IMU, time_us, r);
+    FlightLog_PutImu(&r[n], imu);
+    return FlightLog_Commit(log, time_us, r, n + FLIGHT_LOG_IMU_SIZE);
+}
+
+int FlightLog_Baro(FlightLog_t *log, uint32_t time_us, const FlightLog_Baro_t *baro)
+{
+    uint8_t r[FLIGHT_LOG_RECORD_MAX];
+    size_t n = FlightLog_Begin(log, FLIGHT_LOG_BARO, time_us, r);
+    r[n] = (uint8_t)baro->pressure;
+    r[n + 1] = (uint8_t)(baro->pressure >> 8);
+    r[n + 2] = (uint8_t)(baro->pressure >> 16);
+    FlightLog_Put16(&r[n + 3], (uint16_t)baro->temp);
+    return FlightLog_Commit(log, time_us, r, n + FLIGHT_LOG_BARO_SIZE);
+}
+
+int FlightLog_Mag(FlightLog_t *log, uint32_t time_us, const int16_t mag[3])
+{
+    uint8_t r[FLIGHT_LOG_RECORD_MAX];
+    size_t n = FlightLog_Begin(log, FLIGHT_LOG_MAG, time_us, r);
+    FlightLog_Put16s(&r[n], mag, 3);
+    return FlightLog_Commit(log, time_us, r, n + FLIGHT_LOG_MAG_SIZE);
+}
+
+int FlightLog_Setpoint(FlightLog_t *log, uint32_t time_us, const FlightControl_Setpoint_t *setpoint)
+{
+    uint8_t r[FLIGHT_LOG_RECORD_MAX];
+    size_t n = FlightLog_Begin(log, FLIGHT_LOG_SETPOINT, time_us, r);
+    uint8_t *d = &r[n];
+    d[0] = setpoint->mode;
+    d[1] = setpoint->armed ? 1u : 0u;
+    FlightLog_PutFloat(&d[2], setpoint->roll);
+    FlightLog_PutFloat(&d[6], setpoint->pitch);
+    FlightLog_PutFloat(&d[10], setpoint->yawRate_rads);
+    FlightLog_PutFloat(&d[14], setpoint->throttle);
+
+    // Compared as bytes so -0.0f and NaN payloads replay exactly
+    if (log->haveSetpoint && memcmp(d, log->lastSetpoint, FLIGHT_LOG_SETPOINT_SIZE) == 0)
+    {
+        return 0;
+    }
+    if (FlightLog_Commit(log, time_us, r, n + FLIGHT_LOG_SETPOINT_SIZE) != 0)
+    {
+        log->haveSetpoint = false; // resend on the next call
+        return -1;
+    }
+    memcpy(log->lastSetpoint, d, FLIGHT_LOG_SETPOINT_SIZE);
+    log->haveSetpoint = true;
+    return 0;
+}
+
+int FlightLog_Loop(FlightLog_t *log, uint32_t time_us)
+{
+    uint8_t r[1 + FLIGHT_LOG_MAX_VARINT];
+    size_t n = FlightLog_Begin(log, FLIGHT_LOG_LOOP, time_us, r);
+    return FlightLog_Commit(log, time_us, r, n);
+}
+
+int FlightLog_Event(FlightLog_t *log, uint32_t time_us, const FlightLog_Event_t *event)
+{
+    uint8_t r[FLIGHT_LOG_RECORD_MAX];
+    size_t n = FlightLog_Begin(log, FLIGHT_LOG_EVENT, time_us, r);
+    r[n] = event->trigger;
+    FlightLog_Put16(&r[n + 1], event->preSamples);
+    FlightLog_Put16(&r[n + 3], event->postSamples);
+    return FlightLog_Commit(log, time_us, r, n + FLIGHT_LOG_EVENT_SIZE);
+}
+
+int FlightLog_Capture(FlightLog_t *log, uint32_t time_us, const FlightLog_Imu_t *imu)
+{
+    uint8_t r[FLIGHT_LOG_RECORD_MAX];
+    size_t n = FlightLog_Begin(log, FLIGHT_LOG_CAPTURE, time_us, r);
+    FlightLog_PutImu(&r[n], imu);
+    return FlightLog_Commit(log, time_us, r, n + FLIGHT_LOG_IMU_SIZE);
+}
+
+int FlightLog_ReaderInit(FlightLog_Reader_t *reader, const uint8_t *data, size_t len)
+{
+    if (!reader || !data || len == 0)
+    {
+        return -1;
+    }
+
+    memset(reader, 0, sizeof(*reader));
+    reader->data = data;
+    reader->len = len;
+
+    // A wrapped ring log starts on some other record
+    if (data[0] != FLIGHT_LOG_HEADER)
+    {
+        FlightLog_Record_t first;
+        if (FlightLog_Next(reader, &first) != 1)
+        {
+            return -1;
+        }
+        reader->pos = 0;
+        reader->time_us = 0;
+        return 1;
+    }
+
+    int size = FlightLog_ParseHeader(data, len, &reader->header);
+    if (size < 0)
+    {
+        return size;
+    }
+    reader->pos = (size_t)size;
+    reader->haveHeader = true;
+    return 0;
+}
+
+int FlightLog_Next(FlightLog_Reader_t *reader, FlightLog_Record_t *record)
+{
+    const uint8_t *p = reader->data;
+    size_t pos = reader->pos;
+    if (pos >= reader->len)
+    {
+        return 0;
+    }
+
+    if (p[pos] == FLIGHT_LOG_HEADER)
+    {
+        // The writer rebooted: new scales, and its clock started again at 0
+        memset(record, 0, sizeof(*record));
+        int size = FlightLog_ParseHeader(&p[pos], reader->len - pos, &record->data.header);
+        if (size < 0)
+        {
+            return -1;
+        }
+        record->type = FLIGHT_LOG_HEADER;
+        reader->header = record->data.header;
+        reader->haveHeader = true;
+        reader->pos = pos + (size_t)size;
+        reader->time_us = 0;
+        return 1;
+    }
+
+    uint8_t type = p[pos++];
+    uint32_t dt = 0;
+    for (int shift = 0;; shift += 7)
+    {
+        if (pos >= reader->len || shift >= 7 * FLIGHT_LOG_MAX_VARINT)
+        {
+            return -1;
+        }
+        uint8_t b = p[pos++];
+        dt |= (uint32_t)(b & 0x7Fu) << shift;
+        if (!(b & 0x80u))
+        {
+            break;
+        }
+    }
+
+    size_t size;
+    switch (type)
+    {
+    case FLIGHT_LOG_IMU:
+    case FLIGHT_LOG_CAPTURE:
+        size = FLIGHT_LOG_IMU_SIZE;
+        break;
+    case FLIGHT_LOG_BARO:
+        size = FLIGHT_LOG_BARO_SIZE;
+        break;
+    case FLIGHT_LOG_MAG:
+        size = FLIGHT_LOG_MAG_SIZE;
+        break;
+    case FLIGHT_LOG_SETPOINT:
+        size = FLIGHT_LOG_SETPOINT_SIZE;
+        break;
+    case FLIGHT_LOG_LOOP:
+        size = 0;
+        break;
+    case FLIGHT_LOG_GAP:
+        size = FLIGHT_LOG_GAP_SIZE;
+        break;
+    case FLIGHT_LOG_EVENT:
+        size = FLIGHT_LOG_EVENT_SIZE;
+        break;
+    default:
+        return -1;
+    }
+    if (reader->len - pos < size)
+    {
+        return -1;
+    }
+
+    memset(record, 0, sizeof(*record));
+    record->type = type;
+    record->time_us = reader->time_us + dt;
+    const uint8_t *d = &p[pos];
+    switch (type)
+    {
+    case FLIGHT_LOG_IMU:
+    case FLIGHT_LOG_CAPTURE:
+        record->data.imu.temp = (int16_t)FlightLog_Get16(d);
+        FlightLog_Get16s(&d[2], record->data.imu.gyro, 3);
+        FlightLog_Get16s(&d[8], record->data.imu.accel, 3);
+        break;
+    case FLIGHT_LOG_BARO:
+    {
+        int32_t pressure = (int32_t)(d[0] | (d[1] << 8) | ((uint32_t)d[2] << 16));
+        if (pressure & 0x00800000)
+        {
+            pressure |= (int32_t)0xFF000000;
+        }
+        record->data.baro.pressure = pressure;
+        record->data.baro.temp = (int16_t)FlightLog_Get16(&d[3]);
+        break;
+    }
+    case FLIGHT_LOG_MAG:
+        FlightLog_Get16s(d, record->data.mag, 3);
+        break;
+    case FLIGHT_LOG_SETPOINT:
+        record->data.setpoint.mode = d[0];
+        record->data.setpoint.armed = d[1] != 0;
+        record->data.setpoint.roll = FlightLog_GetFloat(&d[2]);
+        record->data.setpoint.pitch = FlightLog_GetFloat(&d[6]);
+        record->data.setpoint.yawRate_rads = FlightLog_GetFloat(&d[10]);
+        record->data.setpoint.throttle = FlightLog_GetFloat(&d[14]);
+        break;
+    case FLIGHT_LOG_GAP:
+        record->data.gap = FlightLog_Get16(d);
+        break;
+    case FLIGHT_LOG_EVENT:
+        record->data.event.trigger = d[0];
+        record->data.event.preSamples = FlightLog_Get16(&d[1]);
+        record->data.event.postSamples = FlightLog_Get16(&d[3]);
+        break;
+    default:
+        break;
+    }
+
+    reader->pos = pos + size;
+    reader->time_us = record->time_us;
+    return 1;
+}
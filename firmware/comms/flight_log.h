@@ -0,0 +1,227 @@
+#ifndef FLIGHT_LOG_H
+#define FLIGHT_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "flight_control.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Binary flight log: every raw input of the estimators and the controller,
+ * in the order the loop consumed it, so a host replay through the same C
+ * code reproduces the outputs bit for bit. HAL-free: the reader is shared
+ * with the SIL replay.
+ *
+ * Layout (little-endian):
+ *   header : "STFL" | version (1) | headerSize (1) | reserved (2) |
+ *            loopRate_Hz (f32) | gyroScale (f32) | accelScale (f32)
+ *   record : type (1) | dt_us (LEB128 varint, since the previous record) | payload
+ *
+ *   IMU      : temp, gyro xyz, accel xyz (7 x int16, raw LSB)   ISR timestamp
+ *   BARO     : pressure (int24, LSB/4096 hPa), temp (int16)
+ *   MAG      : xyz (3 x int16, raw LSB)
+ *   SETPOINT : mode (1) | armed (1) | roll, pitch, yawRate, throttle (f32)
+ *              written only when it differs from the last one written
+ *   LOOP     : no payload; one control iteration ran on everything before it
+ *   GAP      : records dropped (uint16) since the last written one
+ *   EVENT    : trigger (1) | preSamples (uint16) | postSamples (uint16)
+ *              start of an event capture (event_capture.h), at the trigger time
+ *   CAPTURE  : as IMU; a sample of the capture, at its own time
+ *
+ * A capture is written after the fact, so its timestamps go back in time
+ * and forward again; replay restarts its loop at each EVENT and runs the
+ * CAPTURE samples through the estimators (sim_replay.h).
+ *
+ * Every FlightLog_Init writes a header, so a log kept across reboots holds
+ * one per boot. Its 'S' doubles as a record type (HEADER, no dt): the
+ * reader takes the new scales from it and restarts time at 0, as the
+ * writer did. A ring sink such as the blackbox drops whole records when it
+ * overwrites its oldest data, so a wrapped log starts on a record but
+ * without a header; the reader accepts that, with a zeroed header and
+ * times relative to the first record until the next HEADER.
+ * A record the sink refuses is dropped whole; the next accepted record is
+ * preceded by a GAP so a replay knows it is no longer exact. Timestamps are
+ * 32-bit microseconds and wrap; dt is taken modulo 2^32. Not reentrant:
+ * write from one context (the main loop).
+ */
+#define FLIGHT_LOG_MAGIC "STFL"
+#define FLIGHT_LOG_VERSION 1
+#define FLIGHT_LOG_HEADER_SIZE 20
+#define FLIGHT_LOG_RECORD_MAX 24 // type + 5-byte varint + largest payload
+#define FLIGHT_LOG_IMU_SIZE 14
+#define FLIGHT_LOG_BARO_SIZE 5
+#define FLIGHT_LOG_MAG_SIZE 6
+#define FLIGHT_LOG_SETPOINT_SIZE 18
+#define FLIGHT_LOG_GAP_SIZE 2
+#define FLIGHT_LOG_EVENT_SIZE 5
+
+    enum FlightLog_Type
+    {
+        FLIGHT_LOG_IMU = 0x01,
+        FLIGHT_LOG_BARO = 0x02,
+        FLIGHT_LOG_MAG = 0x03,
+        FLIGHT_LOG_SETPOINT = 0x10,
+        FLIGHT_LOG_LOOP = 0x11,
+        FLIGHT_LOG_GAP = 0x12,
+        FLIGHT_LOG_EVENT = 0x13,
+        FLIGHT_LOG_CAPTURE = 0x14,
+        FLIGHT_LOG_HEADER = 0x53, ///< 'S' of FLIGHT_LOG_MAGIC: a header after a reboot
+    };
+
+    /**
+     * @brief Accepts one whole record
+     * @retval 0 if stored, negative if there is no room (the record is dropped)
+     */
+    typedef int (*FlightLog_Sink_t)(void *ctx, const uint8_t *data, uint16_t len);
+
+    typedef struct
+    {
+        float loopRate_Hz;    ///< FlightControl loop rate of the recording
+        float gyroScale;      ///< rad/s per LSB
+        float accelScale;     ///< m/s^2 per LSB
+    } FlightLog_Header_t;
+
+    typedef struct
+    {
+        FlightLog_Sink_t sink;
+        void *ctx;
+        FlightLog_Header_t header;
+    } FlightLog_Config_t;
+
+    typedef struct
+    {
+        int16_t temp;
+        int16_t gyro[3];
+        int16_t accel[3];
+    } FlightLog_Imu_t;
+
+    typedef struct
+    {
+        int32_t pressure; ///< 24-bit raw, sign extended
+        int16_t temp;
+    } FlightLog_Baro_t;
+
+    typedef struct
+    {
+        uint8_t trigger;      ///< enum EventCapture_Trigger
+        uint16_t preSamples;  ///< Samples before the trigger, trigger sample included
+        uint16_t postSamples; ///< Samples after it
+    } FlightLog_Event_t;
+
+    typedef struct
+    {
+        uint32_t records; ///< Written, GAP records included
+        uint32_t bytes;
+        uint32_t dropped; ///< Refused by the sink
+    } FlightLog_Stats_t;
+
+    typedef struct
+    {
+        FlightLog_Config_t config;
+        uint32_t lastTime_us;     ///< Timestamp of the last written record
+        uint16_t pendingGap;      ///< Drops not yet reported with a GAP record
+        bool haveSetpoint;
+        uint8_t lastSetpoint[FLIGHT_LOG_SETPOINT_SIZE]; ///< Payload of the last SETPOINT written
+        FlightLog_Stats_t stats;
+    } FlightLog_t;
+
+    typedef struct
+    {
+        uint8_t type;     ///< enum FlightLog_Type
+        uint32_t time_us;
+        union
+        {
+            FlightLog_Imu_t imu; ///< IMU and CAPTURE
+            FlightLog_Baro_t baro;
+            int16_t mag[3];
+            FlightControl_Setpoint_t setpoint;
+            uint16_t gap;
+            FlightLog_Event_t event;
+            FlightLog_Header_t header;
+        } data;
+    } FlightLog_Record_t;
+
+    typedef struct
+    {
+        const uint8_t *data;
+        size_t len;
+        size_t pos;
+        uint32_t time_us;
+        FlightLog_Header_t header; ///< Of the current boot; zeroed until the first one in a wrapped log
+        bool haveHeader;
+    } FlightLog_Reader_t;
+
+    /**
+     * @brief Start a log: keeps the sink and writes the header through it
+     * @param[out] log Writer state
+     * @param[in]  cfg Pointer to configuration (copied)
+     * @retval  0 on success, -1 invalid argument, -2 header refused by the sink
+     */
+    int FlightLog_Init(FlightLog_t *log, const FlightLog_Config_t *cfg);
+
+    /**
+     * @brief Raw IMU sample, stamped with the time of the interrupt that produced it
+     * @retval  0 written, negative dropped
+     */
+    int FlightLog_Imu(FlightLog_t *log, uint32_t time_us, const FlightLog_Imu_t *imu);
+
+    /**
+     * @brief Raw barometer sample
+     * @retval  0 written, negative dropped
+     */
+    int FlightLog_Baro(FlightLog_t *log, uint32_t time_us, const FlightLog_Baro_t *baro);
+
+    /**
+     * @brief Raw magnetometer sample
+     * @retval  0 written, negative dropped
+     */
+    int FlightLog_Mag(FlightLog_t *log, uint32_t time_us, const int16_t mag[3]);
+
+    /**
+     * @brief Setpoint handed to FlightControl_Update; skipped when unchanged
+     * @retval  0 written or unchanged, negative dropped
+     */
+    int FlightLog_Setpoint(FlightLog_t *log, uint32_t time_us, const FlightControl_Setpoint_t *setpoint);
+
+    /**
+     * @brief Mark one control iteration
+     * @retval  0 written, negative dropped
+     */
+    int FlightLog_Loop(FlightLog_t *log, uint32_t time_us);
+
+    /**
+     * @brief Start of an event capture, stamped with the trigger time
+     * @retval  0 written, negative dropped
+     */
+    int FlightLog_Event(FlightLog_t *log, uint32_t time_us, const FlightLog_Event_t *event);
+
+    /**
+     * @brief One IMU sample of an event capture, stamped with its own time
+     * @retval  0 written, negative dropped
+     */
+    int FlightLog_Capture(FlightLog_t *log, uint32_t time_us, const FlightLog_Imu_t *imu);
+
+    /**
+     * @brief Check the header and position the reader on the first record
+     * @retval  0 on success, 1 no leading header (a wrapped log, see above),
+     *         -1 not a flight log or truncated header, -2 unsupported version
+     */
+    int FlightLog_ReaderInit(FlightLog_Reader_t *reader, const uint8_t *data, size_t len);
+
+    /**
+     * @brief Decode the next record
+     * @return 1 record decoded, 0 end of log, -1 unknown type, truncated record
+     *         or unsupported header
+     */
+    int FlightLog_Next(FlightLog_Reader_t *reader, FlightLog_Record_t *record);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FLIGHT_LOG_H
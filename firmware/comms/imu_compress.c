@@ -0,0 +1,289 @@
+#include "imu_compress.h"
+#include <string.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL DEFINITIONS                                                       */
+/*----------------------------------------------------------------------------*/
+
+#define IMU_COMPRESS_RAW_SAMPLE_SIZE (IMU_COMPRESS_AXES * 2)
+#define IMU_COMPRESS_MAX_VARINT 3 // |residual| < 2^17 with the linear predictor
+#define IMU_COMPRESS_MAX_RESIDUALS (IMU_COMPRESS_AXES * IMU_COMPRESS_MAX_VARINT)
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+static inline int32_t ImuCompress_Predict(bool linear, int32_t prev, int32_t prev2)
+{
+    return linear ? 2 * prev - prev2 : prev;
+}
+
+static inline void ImuCompress_Put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline uint16_t ImuCompress_Get16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static void ImuCompress_SetHistory(int32_t *prev, int32_t *prev2, const int32_t *x)
+{
+    for (int a = 0; a < IMU_COMPRESS_AXES; a++)
+    {
+        prev2[a] = prev[a];
+        prev[a] = x[a];
+    }
+}
+
+/**
+ * @brief Residuals of one sample against the encoder history, as zig-zag varints
+ * @return Bytes written (6..IMU_COMPRESS_MAX_RESIDUALS)
+ */
+static size_t ImuCompress_EncodeResiduals(const ImuCompress_Encoder_t *enc, const int16_t *sample, uint8_t *out)
+{
+    bool linear = (enc->config.predictor == IMU_COMPRESS_LINEAR);
+    size_t n = 0;
+    for (int a = 0; a < IMU_COMPRESS_AXES; a++)
+    {
+        int32_t r = sample[a] - ImuCompress_Predict(linear, enc->prev[a], enc->prev2[a]);
+        uint32_t zz = ((uint32_t)r << 1) ^ (uint32_t)(r >> 31);
+        while (zz >= 0x80u)
+        {
+            out[n++] = (uint8_t)(zz | 0x80u);
+            zz >>= 7;
+        }
+        out[n++] = (uint8_t)zz;
+    }
+    return n;
+}
+
+/**
+ * @brief Start a block with this sample: raw if a keyframe is due, else as residuals
+ */
+static void ImuCompress_OpenBlock(ImuCompress_Encoder_t *enc, const int16_t *sample, uint32_t time_us)
+{
+    bool keyframe = (enc->sinceKeyframe >= enc->config.keyInterval);
+    uint8_t *b = enc->block;
+
+    b[0] = (uint8_t)((keyframe ? IMU_COMPRESS_FLAG_KEYFRAME : 0u) |
+                     ((enc->config.predictor == IMU_COMPRESS_LINEAR) ? IMU_COMPRESS_FLAG_LINEAR : 0u));
+    b[1] = 1;
+    ImuCompress_Put16(&b[2], enc->sampleIndex);
+    ImuCompress_Put16(&b[4], (uint16_t)time_us);
+    ImuCompress_Put16(&b[6], (uint16_t)(time_us >> 16));
+    size_t len = IMU_COMPRESS_HEADER_SIZE;
+
+    int32_t x[IMU_COMPRESS_AXES];
+    for (int a = 0; a < IMU_COMPRESS_AXES; a++)
+    {
+        x[a] = sample[a];
+    }
+
+    if (keyframe)
+    {
+        for (int a = 0; a < IMU_COMPRESS_AXES; a++)
+        {
+            ImuCompress_Put16(&b[len + 2 * a], (uint16_t)sample[a]);
+        }
+        len += IMU_COMPRESS_RAW_SAMPLE_SIZE;
+        ImuCompress_SetHistory(enc->prev, enc->prev2, x); // with the update below, both entries hold x
+        enc->sinceKeyframe = 0;
+    }
+    else
+    {
+        len += ImuCompress_EncodeResiduals(enc, sample, &b[len]);
+    }
+    ImuCompress_SetHistory(enc->prev, enc->prev2, x);
+    enc->blockLen = (uint8_t)len;
+}
+
+/**
+ * @brief Read one LEB128 varint and undo the zig-zag mapping
+ * @return Bytes consumed, 0 on truncation or an over-long varint
+ */
+static size_t ImuCompress_ReadResidual(const uint8_t *p, size_t avail, int32_t *r)
+{
+    uint32_t zz = 0;
+    for (size_t i = 0; i < avail && i < IMU_COMPRESS_MAX_VARINT; i++)
+    {
+        zz |= (uint32_t)(p[i] & 0x7Fu) << (7 * i);
+        if ((p[i] & 0x80u) == 0)
+        {
+            *r = (int32_t)(zz >> 1) ^ -(int32_t)(zz & 1u);
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+int ImuCompress_InitEncoder(ImuCompress_Encoder_t *enc, const ImuCompress_Config_t *cfg)
+{
+    if (!enc || !cfg || cfg->keyInterval == 0 ||
+        (cfg->predictor != IMU_COMPRESS_DELTA && cfg->predictor != IMU_COMPRESS_LINEAR))
+    {
+        return -1;
+    }
+
+    memset(enc, 0, sizeof(*enc));
+    enc->config = *cfg;
+    enc->sinceKeyframe = cfg->keyInterval; // first block is a keyframe
+    return 0;
+}
+
+size_t ImuCompress_Push(ImuCompress_Encoder_t *enc, const int16_t sample[IMU_COMPRESS_AXES], uint32_t time_us,
+                        uint8_t *out)
+{
+    size_t completed = 0;
+
+    if (enc->blockLen != 0)
+    {
+        uint8_t residuals[IMU_COMPRESS_MAX_RESIDUALS];
+        size_t n = ImuCompress_EncodeResiduals(enc, sample, residuals);
+        if (enc->blockLen + n <= IMU_COMPRESS_BLOCK_MAX)
+        {
+            memcpy(&enc->block[enc->blockLen], residuals, n);
+            enc->blockLen = (uint8_t)(enc->blockLen + n);
+            enc->block[1]++;
+
+            int32_t x[IMU_COMPRESS_AXES];
+            for (int a = 0; a < IMU_COMPRESS_AXES; a++)
+            {
+                x[a] = sample[a];
+            }
+            ImuCompress_SetHistory(enc->prev, enc->prev2, x);
+        }
+        else
+        {
+            completed = ImuCompress_Flush(enc, out);
+        }
+    }
+
+    if (enc->blockLen == 0)
+    {
+        ImuCompress_OpenBlock(enc, sample, time_us);
+    }
+
+    enc->sampleIndex++;
+    if (enc->sinceKeyframe < enc->config.keyInterval)
+    {
+        enc->sinceKeyframe++;
+    }
+    enc->stats.samples++;
+    enc->stats.rawBytes += IMU_COMPRESS_RAW_SAMPLE_SIZE;
+    return completed;
+}
+
+size_t ImuCompress_Flush(ImuCompress_Encoder_t *enc, uint8_t *out)
+{
+    size_t len = enc->blockLen;
+    if (len == 0)
+    {
+        return 0;
+    }
+
+    memcpy(out, enc->block, len);
+    enc->blockLen = 0;
+    enc->stats.blocks++;
+    enc->stats.encodedBytes += len;
+    if (enc->block[0] & IMU_COMPRESS_FLAG_KEYFRAME)
+    {
+        enc->stats.keyframes++;
+    }
+    return len;
+}
+
+void ImuCompress_InitDecoder(ImuCompress_Decoder_t *dec)
+{
+    memset(dec, 0, sizeof(*dec));
+}
+
+int ImuCompress_Decode(ImuCompress_Decoder_t *dec, const uint8_t *block, size_t len,
+                       int16_t (*samples)[IMU_COMPRESS_AXES], size_t maxSamples, uint16_t *firstIndex,
+                       uint32_t *firstTime_us)
+{
+    if (len < IMU_COMPRESS_HEADER_SIZE || block[1] == 0 || block[1] > maxSamples)
+    {
+        return -1;
+    }
+
+    uint8_t flags = block[0];
+    uint8_t count = block[1];
+    uint16_t index = ImuCompress_Get16(&block[2]);
+    bool linear = (flags & IMU_COMPRESS_FLAG_LINEAR) != 0;
+    size_t pos = IMU_COMPRESS_HEADER_SIZE;
+    uint8_t first = 0;
+
+    if (flags & IMU_COMPRESS_FLAG_KEYFRAME)
+    {
+        if (len < pos + IMU_COMPRESS_RAW_SAMPLE_SIZE)
+        {
+            return -1;
+        }
+        int32_t x[IMU_COMPRESS_AXES];
+        for (int a = 0; a < IMU_COMPRESS_AXES; a++)
+        {
+            samples[0][a] = (int16_t)ImuCompress_Get16(&block[pos + 2 * a]);
+            x[a] = samples[0][a];
+        }
+        pos += IMU_COMPRESS_RAW_SAMPLE_SIZE;
+        // Both history entries hold the keyframe sample, as in the encoder
+        ImuCompress_SetHistory(dec->prev, dec->prev2, x);
+        ImuCompress_SetHistory(dec->prev, dec->prev2, x);
+        dec->synced = true;
+        first = 1;
+    }
+    else if (!dec->synced || index != dec->nextIndex)
+    {
+        // Lost a block: residuals are meaningless until the next keyframe
+        dec->synced = false;
+        return -2;
+    }
+
+    for (uint8_t s = first; s < count; s++)
+    {
+        int32_t x[IMU_COMPRESS_AXES];
+        for (int a = 0; a < IMU_COMPRESS_AXES; a++)
+        {
+            int32_t r;
+            size_t used = ImuCompress_ReadResidual(&block[pos], len - pos, &r);
+            if (used == 0)
+            {
+                dec->synced = false;
+                return -1;
+            }
+            x[a] = ImuCompress_Predict(linear, dec->prev[a], dec->prev2[a]) + r;
+            if (x[a] < INT16_MIN || x[a] > INT16_MAX)
+            {
+                dec->synced = false;
+                return -1;
+            }
+            pos += used;
+            samples[s][a] = (int16_t)x[a];
+        }
+        ImuCompress_SetHistory(dec->prev, dec->prev2, x);
+    }
+
+    if (pos != len)
+    {
+        dec->synced = false;
+        return -1;
+    }
+
+    dec->nextIndex = (uint16_t)(index + count);
+    if (firstIndex)
+    {
+        *firstIndex = index;
+    }
+    if (firstTime_us)
+    {
+        *firstTime_us = (uint32_t)ImuCompress_Get16(&block[4]) | ((uint32_t)ImuCompress_Get16(&block[6]) << 16);
+    }
+    return count;
+}
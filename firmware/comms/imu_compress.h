@@ -0,0 +1,137 @@
+#ifndef IMU_COMPRESS_H
+#define IMU_COMPRESS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "telemetry_frame.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Lossless compression of raw 6-axis IMU samples (accel xyz, gyro xyz,
+ * int16 LSB) into TELEMETRY_MSG_IMU_BLOCK payloads. HAL-free: the decoder
+ * is shared with the host tools.
+ *
+ * Block layout (little-endian):
+ *   flags (1) | count (1) | firstIndex (2) | firstTime_us (4) | body
+ *   keyframe block : sample 0 as 6 raw int16, then residuals of samples 1..n-1
+ *   delta block    : residuals of samples 0..n-1
+ * A residual is the sample minus the predictor, zig-zag mapped and written
+ * as a LEB128 varint per axis (1 byte for |r| < 64). A block is a keyframe
+ * once keyInterval samples have passed since the last one, so a decoder
+ * that lost a frame recovers at the next keyframe. firstIndex counts
+ * samples and exposes the loss.
+ *
+ * Predictors: DELTA (previous sample) or LINEAR (2 * prev - prev2). After a
+ * keyframe sample both history entries hold that sample.
+ */
+#define IMU_COMPRESS_AXES 6
+#define IMU_COMPRESS_BLOCK_MAX TELEMETRY_MAX_PAYLOAD
+#define IMU_COMPRESS_HEADER_SIZE 8
+#define IMU_COMPRESS_FLAG_KEYFRAME 0x80u
+#define IMU_COMPRESS_FLAG_LINEAR 0x01u // predictor used by this block
+
+    enum ImuCompress_Predictor
+    {
+        IMU_COMPRESS_DELTA = 0,
+        IMU_COMPRESS_LINEAR,
+    };
+
+    typedef struct
+    {
+        uint8_t predictor;    ///< enum ImuCompress_Predictor
+        uint16_t keyInterval; ///< Samples between keyframes (> 0)
+    } ImuCompress_Config_t;
+
+    typedef struct
+    {
+        uint32_t samples;      ///< Samples encoded
+        uint32_t blocks;       ///< Blocks completed
+        uint32_t keyframes;    ///< Of which keyframes
+        uint32_t rawBytes;     ///< samples * 12
+        uint32_t encodedBytes; ///< Completed block bytes, headers included
+    } ImuCompress_Stats_t;
+
+    /**
+     * @brief Encoder state. Builds one block at a time.
+     */
+    typedef struct
+    {
+        ImuCompress_Config_t config;
+        int32_t prev[IMU_COMPRESS_AXES];       ///< Last sample
+        int32_t prev2[IMU_COMPRESS_AXES];      ///< Sample before that
+        uint16_t sampleIndex;                  ///< Index of the next sample, wraps
+        uint16_t sinceKeyframe;                ///< Samples since the last keyframe sample
+        uint8_t block[IMU_COMPRESS_BLOCK_MAX]; ///< Open block
+        uint8_t blockLen;                      ///< 0 when no block is open
+        ImuCompress_Stats_t stats;
+    } ImuCompress_Encoder_t;
+
+    /**
+     * @brief Decoder state, mirrors the encoder history
+     */
+    typedef struct
+    {
+        int32_t prev[IMU_COMPRESS_AXES];
+        int32_t prev2[IMU_COMPRESS_AXES];
+        uint16_t nextIndex; ///< Expected firstIndex of the next block
+        bool synced;        ///< History is valid (a keyframe has been seen since the last gap)
+    } ImuCompress_Decoder_t;
+
+    /**
+     * @brief Initialize the encoder; the first block is a keyframe
+     * @param[out] enc Encoder state
+     * @param[in]  cfg Pointer to configuration (copied)
+     * @retval  0 on success, negative on error
+     */
+    int ImuCompress_InitEncoder(ImuCompress_Encoder_t *enc, const ImuCompress_Config_t *cfg);
+
+    /**
+     * @brief Add one sample. When it does not fit the open block, that block is
+     *        returned and the sample starts the next one.
+     * @param[in,out] enc     Encoder state
+     * @param[in]     sample  Accel xyz, gyro xyz
+     * @param[in]     time_us Sample timestamp, stored for the first sample of a block
+     * @param[out]    out     Completed block, IMU_COMPRESS_BLOCK_MAX bytes
+     * @return Length of the completed block in out, 0 if none completed
+     */
+    size_t ImuCompress_Push(ImuCompress_Encoder_t *enc, const int16_t sample[IMU_COMPRESS_AXES], uint32_t time_us,
+                            uint8_t *out);
+
+    /**
+     * @brief Close the open block early (e.g. on a latency deadline)
+     * @param[in,out] enc Encoder state
+     * @param[out]    out Completed block, IMU_COMPRESS_BLOCK_MAX bytes
+     * @return Length of the block, 0 if no block was open
+     */
+    size_t ImuCompress_Flush(ImuCompress_Encoder_t *enc, uint8_t *out);
+
+    /**
+     * @brief Reset the decoder; it waits for a keyframe
+     */
+    void ImuCompress_InitDecoder(ImuCompress_Decoder_t *dec);
+
+    /**
+     * @brief Decode one block
+     * @param[in,out] dec          Decoder state
+     * @param[in]     block        Block bytes (telemetry payload)
+     * @param[in]     len          Block length
+     * @param[out]    samples      Decoded samples
+     * @param[in]     maxSamples   Capacity of samples
+     * @param[out]    firstIndex   Sample index of samples[0] (may be NULL)
+     * @param[out]    firstTime_us Timestamp of samples[0] (may be NULL)
+     * @return Number of samples, -1 malformed block, -2 skipped until the next keyframe
+     */
+    int ImuCompress_Decode(ImuCompress_Decoder_t *dec, const uint8_t *block, size_t len,
+                           int16_t (*samples)[IMU_COMPRESS_AXES], size_t maxSamples, uint16_t *firstIndex,
+                           uint32_t *firstTime_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // IMU_COMPRESS_H
@@ -0,0 +1,199 @@
+#include "log_download.h"
+#include <string.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+static void LogDownload_Start(LogDownload_t *dl, const Telemetry_LogRead_t *req, uint32_t now_ms)
+{
+    uint32_t size = dl->config.size(dl->config.ctx);
+    uint32_t offset = req->offset < size ? req->offset : size;
+
+    dl->acked = offset;
+    dl->next = offset;
+    dl->end = req->length < size - offset ? offset + req->length : size;
+    dl->lastAck_ms = now_ms;
+    dl->active = dl->end > offset;
+    dl->stats.requests++;
+}
+
+static void LogDownload_Ack(LogDownload_t *dl, const Telemetry_LogAck_t *ack, uint32_t now_ms)
+{
+    // Stale or out-of-range ACKs are dropped; the retry timeout sorts out the rest
+    if (!dl->active || ack->offset <= dl->acked || ack->offset > dl->next)
+    {
+        return;
+    }
+    dl->acked = ack->offset;
+    dl->lastAck_ms = now_ms;
+    if (dl->acked >= dl->end)
+    {
+        dl->active = false;
+    }
+}
+
+/**
+ * @brief One complete COBS block from the host: check and dispatch it
+ */
+static void LogDownload_Handle(LogDownload_t *dl, uint32_t now_ms)
+{
+    uint8_t raw[TELEMETRY_MAX_ENCODED];
+    int n = Telemetry_CobsDecode(dl->rx, dl->rxLen, raw);
+    if (n < TELEMETRY_RAW_OVERHEAD)
+    {
+        dl->stats.badFrames++;
+        return;
+    }
+    uint16_t crc = (uint16_t)(raw[n - 2] | (raw[n - 1] << 8));
+    if (Telemetry_Crc16(0xFFFF, raw, (size_t)n - 2u) != crc)
+    {
+        dl->stats.badFrames++;
+        return;
+    }
+
+    const uint8_t *payload = &raw[2];
+    size_t len = (size_t)n - TELEMETRY_RAW_OVERHEAD;
+    switch (raw[0])
+    {
+    case TELEMETRY_MSG_LOG_INFO:
+        dl->infoPending = true;
+        break;
+    case TELEMETRY_MSG_LOG_READ:
+        if (len != sizeof(Telemetry_LogRead_t))
+        {
+            dl->stats.badFrames++;
+            return;
+        }
+        Telemetry_LogRead_t req;
+        memcpy(&req, payload, sizeof(req));
+        LogDownload_Start(dl, &req, now_ms);
+        break;
+    case TELEMETRY_MSG_LOG_ACK:
+        if (len != sizeof(Telemetry_LogAck_t))
+        {
+            dl->stats.badFrames++;
+            return;
+        }
+        Telemetry_LogAck_t ack;
+        memcpy(&ack, payload, sizeof(ack));
+        LogDownload_Ack(dl, &ack, now_ms);
+        break;
+    default:
+        // Meant for someone else
+        return;
+    }
+    dl->lastHost_ms = now_ms;
+}
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+int LogDownload_Init(LogDownload_t *dl, const LogDownload_Config_t *cfg)
+{
+    if (!dl || !cfg || !cfg->read || !cfg->size || !cfg->send || cfg->window == 0 || cfg->chunksPerService == 0)
+    {
+        return -1;
+    }
+
+    memset(dl, 0, sizeof(*dl));
+    dl->config = *cfg;
+    return 0;
+}
+
+void LogDownload_Feed(LogDownload_t *dl, const uint8_t *data, size_t len, uint32_t now_ms)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        uint8_t byte = data[i];
+        if (byte == 0x00)
+        {
+            if (dl->rxLen > 0 && !dl->rxOverflow)
+            {
+                LogDownload_Handle(dl, now_ms);
+            }
+            else if (dl->rxOverflow)
+            {
+                dl->stats.badFrames++;
+            }
+            dl->rxLen = 0;
+            dl->rxOverflow = false;
+        }
+        else if (dl->rxLen < sizeof(dl->rx))
+        {
+            dl->rx[dl->rxLen++] = byte;
+        }
+        else
+        {
+            dl->rxOverflow = true;
+        }
+    }
+}
+
+uint16_t LogDownload_Service(LogDownload_t *dl, uint32_t now_ms)
+{
+    if (dl->infoPending)
+    {
+        Telemetry_LogInfo_t info = {
+            .size = dl->config.size(dl->config.ctx),
+            .chunkSize = TELEMETRY_LOG_CHUNK,
+            .window = dl->config.window,
+            .origin = dl->config.origin ? dl->config.origin(dl->config.ctx) : 0u,
+        };
+        if (dl->config.send(dl->config.ctx, TELEMETRY_MSG_LOG_INFO, &info, sizeof(info)) != 0)
+        {
+            return 0;
+        }
+        dl->infoPending = false;
+    }
+
+    if (!dl->active)
+    {
+        return 0;
+    }
+    if (now_ms - dl->lastHost_ms >= dl->config.sessionTimeout_ms)
+    {
+        dl->active = false;
+        return 0;
+    }
+    if (dl->next > dl->acked && now_ms - dl->lastAck_ms >= dl->config.retryTimeout_ms)
+    {
+        // Go back N: everything past the last ACK again
+        dl->next = dl->acked;
+        dl->lastAck_ms = now_ms;
+        dl->stats.resends++;
+    }
+
+    const uint32_t inFlight = (uint32_t)dl->config.window * TELEMETRY_LOG_CHUNK;
+    uint16_t sent = 0;
+    while (sent < dl->config.chunksPerService && dl->next < dl->end && dl->next - dl->acked < inFlight)
+    {
+        Telemetry_LogData_t chunk;
+        uint32_t left = dl->end - dl->next;
+        uint16_t len = left < TELEMETRY_LOG_CHUNK ? (uint16_t)left : TELEMETRY_LOG_CHUNK;
+        chunk.offset = dl->next;
+        len = dl->config.read(dl->config.ctx, dl->next, chunk.data, len);
+        if (len == 0)
+        {
+            // The log is shorter than it was at LOG_READ
+            dl->end = dl->next;
+            break;
+        }
+        if (dl->config.send(dl->config.ctx, TELEMETRY_MSG_LOG_DATA, &chunk, (uint16_t)(sizeof(chunk.offset) + len)) !=
+            0)
+        {
+            break;
+        }
+        dl->next += len;
+        dl->stats.chunks++;
+        dl->stats.bytes += len;
+        sent++;
+    }
+    return sent;
+}
+
+bool LogDownload_Active(const LogDownload_t *dl)
+{
+    return dl->active;
+}
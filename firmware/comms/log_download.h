@@ -0,0 +1,133 @@
+#ifndef LOG_DOWNLOAD_H
+#define LOG_DOWNLOAD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "telemetry_messages.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Post-flight log download over the telemetry link, HAL-free. The log is
+ * seen as one byte stream (Blackbox_Read for the flash log) and goes out in
+ * LOG_DATA frames of TELEMETRY_LOG_CHUNK bytes, each carrying its stream
+ * offset; the frame CRC is the per-chunk check. At 116 payload bytes in 126
+ * on the wire the transfer uses 92% of the baud rate.
+ *
+ *   host                          board
+ *   LOG_INFO (empty)        ->
+ *                           <-    LOG_INFO {size, chunkSize, window, origin}
+ *   LOG_READ {offset, len}  ->
+ *                           <-    LOG_DATA {offset, data} x window
+ *   LOG_ACK {offset}        ->    (every few chunks: the window slides)
+ *                           <-    LOG_DATA ...
+ *
+ * Go-back-N: the board keeps at most window chunks past the last ACK in
+ * flight. A host that sees a gap or a bad CRC sends LOG_READ again from the
+ * first byte it is missing; a board that hears no ACK for retryTimeout_ms
+ * resends from the last ACK, which also covers lost ACKs and READs. Resuming
+ * an interrupted download is the same LOG_READ from the bytes already saved,
+ * valid only while LOG_INFO reports the same origin: offsets count from the
+ * oldest data, and an erase of it (the blackbox ring moving on) moves them.
+ *
+ * The transfer ends when the ACK reaches the end of the requested range, or
+ * sessionTimeout_ms after the last host frame. While it runs,
+ * LogDownload_Active tells the rest of the firmware to keep the link quiet
+ * (no text telemetry).
+ */
+#define LOG_DOWNLOAD_DEFAULT_WINDOW 16
+
+    /**
+     * @brief Copy log bytes from a stream offset
+     * @return Bytes copied, fewer than len only at the end of the log
+     */
+    typedef uint16_t (*LogDownload_Read_t)(void *ctx, uint32_t offset, uint8_t *out, uint16_t len);
+
+    /**
+     * @brief Current log size, bytes
+     */
+    typedef uint32_t (*LogDownload_Size_t)(void *ctx);
+
+    /**
+     * @brief Identity of the first stream byte (the oldest blackbox sector sequence)
+     */
+    typedef uint32_t (*LogDownload_Origin_t)(void *ctx);
+
+    /**
+     * @brief Send one telemetry frame
+     * @retval 0 sent, negative no room (the same frame is tried again later)
+     */
+    typedef int (*LogDownload_Send_t)(void *ctx, uint8_t msgId, const void *payload, uint16_t len);
+
+    typedef struct
+    {
+        LogDownload_Read_t read;
+        LogDownload_Size_t size;
+        LogDownload_Origin_t origin; ///< May be NULL: origin 0
+        LogDownload_Send_t send;
+        void *ctx;
+        uint16_t window;            ///< Chunks in flight past the last ACK (> 0)
+        uint16_t chunksPerService;  ///< Frames sent per LogDownload_Service call at most (> 0)
+        uint32_t retryTimeout_ms;   ///< No ACK for this long: resend from the last ACK
+        uint32_t sessionTimeout_ms; ///< No host frame for this long: transfer abandoned
+    } LogDownload_Config_t;
+
+    typedef struct
+    {
+        uint32_t requests;  ///< LOG_READ frames accepted
+        uint32_t chunks;    ///< LOG_DATA frames sent, resends included
+        uint32_t bytes;     ///< Log bytes sent, resends included
+        uint32_t resends;   ///< Go-back-N restarts on timeout
+        uint32_t badFrames; ///< Host frames with a COBS, CRC or length error
+    } LogDownload_Stats_t;
+
+    typedef struct
+    {
+        LogDownload_Config_t config;
+        uint8_t rx[TELEMETRY_MAX_ENCODED]; ///< Encoded host frame being received
+        uint16_t rxLen;
+        bool rxOverflow; ///< Frame longer than rx: discarded up to its delimiter
+        bool infoPending;
+        bool active;
+        uint32_t acked;      ///< Host has every byte below this
+        uint32_t next;       ///< Next byte to send
+        uint32_t end;        ///< End of the requested range
+        uint32_t lastHost_ms;
+        uint32_t lastAck_ms;
+        LogDownload_Stats_t stats;
+    } LogDownload_t;
+
+    /**
+     * @brief Idle server
+     * @param[out] dl  Server state
+     * @param[in]  cfg Pointer to configuration (copied)
+     * @retval  0 on success, -1 invalid argument
+     */
+    int LogDownload_Init(LogDownload_t *dl, const LogDownload_Config_t *cfg);
+
+    /**
+     * @brief Take bytes received from the host; complete frames are handled at once
+     * @param[in] now_ms Millisecond clock, for the timeouts
+     */
+    void LogDownload_Feed(LogDownload_t *dl, const uint8_t *data, size_t len, uint32_t now_ms);
+
+    /**
+     * @brief Answer a pending LOG_INFO and send the chunks the window allows
+     * @return LOG_DATA frames sent in this call
+     */
+    uint16_t LogDownload_Service(LogDownload_t *dl, uint32_t now_ms);
+
+    /**
+     * @brief A transfer is in progress
+     */
+    bool LogDownload_Active(const LogDownload_t *dl);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LOG_DOWNLOAD_H
@@ -0,0 +1,182 @@
+#include "rc_input.h"
+#include "cycle_counter.h"
+#include <string.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL DEFINITIONS                                                       */
+/*----------------------------------------------------------------------------*/
+
+#define RC_INPUT_SBUS_BAUD 100000u
+#define RC_INPUT_SBUS_CHAR_BITS 12u // start + 8 data + parity + 2 stop
+#define RC_INPUT_CRSF_BAUD 420000u
+#define RC_INPUT_CRSF_CHAR_BITS 10u // start + 8 data + stop
+
+static RcInput_Handle_t *s_active = NULL; ///< Handle served by RcInput_UartIrqHandler
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+static void RcInput_InitPins(void)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    __HAL_RCC_GPIOC_CLK_ENABLE();
+    GPIO_InitStruct.Pin = GPIO_PIN_7;
+    GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+    GPIO_InitStruct.Pull = GPIO_PULLUP;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+    GPIO_InitStruct.Alternate = GPIO_AF8_USART6;
+    HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
+}
+
+static int RcInput_InitDma(RcInput_Handle_t *rc)
+{
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    rc->hdma.Instance = DMA2_Stream1;
+    rc->hdma.Init.Channel = DMA_CHANNEL_5;
+    rc->hdma.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    rc->hdma.Init.PeriphInc = DMA_PINC_DISABLE;
+    rc->hdma.Init.MemInc = DMA_MINC_ENABLE;
+    rc->hdma.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    rc->hdma.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    rc->hdma.Init.Mode = DMA_CIRCULAR;
+    rc->hdma.Init.Priority = DMA_PRIORITY_HIGH;
+    rc->hdma.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    if (HAL_DMA_Init(&rc->hdma) != HAL_OK)
+    {
+        return -1;
+    }
+    __HAL_LINKDMA(&rc->huart, hdmarx, rc->hdma);
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+int RcInput_Init(RcInput_Handle_t *rc, const RcInput_Config_t *cfg)
+{
+    if (!rc || !cfg || (cfg->protocol != RC_PROTOCOL_SBUS && cfg->protocol != RC_PROTOCOL_CRSF))
+    {
+        return -1;
+    }
+
+    memset(rc, 0, sizeof(*rc));
+    rc->config = *cfg;
+
+    __HAL_RCC_USART6_CLK_ENABLE();
+    RcInput_InitPins();
+
+    rc->huart.Instance = USART6;
+    if (cfg->protocol == RC_PROTOCOL_SBUS)
+    {
+        // 8 data bits + even parity = 9-bit word on this USART
+        rc->huart.Init.BaudRate = RC_INPUT_SBUS_BAUD;
+        rc->huart.Init.WordLength = UART_WORDLENGTH_9B;
+        rc->huart.Init.StopBits = UART_STOPBITS_2;
+        rc->huart.Init.Parity = UART_PARITY_EVEN;
+        rc->charCycles = SystemCoreClock / RC_INPUT_SBUS_BAUD * RC_INPUT_SBUS_CHAR_BITS;
+    }
+    else
+    {
+        rc->huart.Init.BaudRate = RC_INPUT_CRSF_BAUD;
+        rc->huart.Init.WordLength = UART_WORDLENGTH_8B;
+        rc->huart.Init.StopBits = UART_STOPBITS_1;
+        rc->huart.Init.Parity = UART_PARITY_NONE;
+        rc->charCycles = SystemCoreClock / RC_INPUT_CRSF_BAUD * RC_INPUT_CRSF_CHAR_BITS;
+    }
+    rc->huart.Init.Mode = UART_MODE_RX;
+    rc->huart.Init.HwFlowCtl = UART_HWCONTROL_NONE;
+    rc->huart.Init.OverSampling = UART_OVERSAMPLING_16;
+    if (HAL_UART_Init(&rc->huart) != HAL_OK)
+    {
+        return -2;
+    }
+
+    if (RcInput_InitDma(rc) != 0)
+    {
+        return -3;
+    }
+
+    s_active = rc;
+
+    // Circular DMA into the ring; the CPU only hears about the IDLE after each frame
+    if (HAL_DMA_Start(&rc->hdma, (uint32_t)&rc->huart.Instance->DR, (uint32_t)rc->ring, RC_INPUT_RING_SIZE) != HAL_OK)
+    {
+        return -4;
+    }
+    SET_BIT(rc->huart.Instance->CR3, USART_CR3_DMAR);
+    __HAL_UART_CLEAR_IDLEFLAG(&rc->huart);
+    __HAL_UART_ENABLE_IT(&rc->huart, UART_IT_IDLE);
+
+    HAL_NVIC_SetPriority(USART6_IRQn, 1, 0);
+    HAL_NVIC_EnableIRQ(USART6_IRQn);
+
+    return 0;
+}
+
+uint32_t RcInput_GetFrame(const RcInput_Handle_t *rc, RcProtocol_Frame_t *frame, uint32_t *timestampCycles)
+{
+    uint32_t seq;
+    uint32_t count;
+    uint32_t stamp;
+
+    // Sequence lock: retry if the IRQ updated the frame while we copied it
+    do
+    {
+        seq = rc->sequence;
+        __DMB();
+        *frame = rc->frame;
+        stamp = rc->frameCycles;
+        count = rc->stats.frames;
+        __DMB();
+    } while ((seq & 1u) != 0 || seq != rc->sequence);
+
+    if (timestampCycles)
+    {
+        *timestampCycles = stamp;
+    }
+    return count;
+}
+
+void RcInput_UartIrqHandler(void)
+{
+    RcInput_Handle_t *rc = s_active;
+    if (!rc || !__HAL_UART_GET_FLAG(&rc->huart, UART_FLAG_IDLE))
+    {
+        return;
+    }
+    __HAL_UART_CLEAR_IDLEFLAG(&rc->huart);
+
+    // IDLE is raised one character time after the last stop bit
+    uint32_t stamp = CycleCounter_Read() - rc->charCycles;
+    rc->stats.idleEvents++;
+
+    uint16_t dmaPos = (uint16_t)(RC_INPUT_RING_SIZE - __HAL_DMA_GET_COUNTER(&rc->hdma));
+    uint16_t writePos = (uint16_t)(rc->readPos + ((uint16_t)(dmaPos - rc->readPos) & (RC_INPUT_RING_SIZE - 1u)));
+    const RcProtocol_Ring_t ring = {rc->ring, RC_INPUT_RING_SIZE - 1u};
+
+    rc->sequence++;
+    __DMB();
+    for (;;)
+    {
+        int result = RcProtocol_Parse(rc->config.protocol, &ring, &rc->readPos, writePos, &rc->frame);
+        if (result == RC_PARSE_NEED_MORE)
+        {
+            break;
+        }
+        if (result == RC_PARSE_CHANNELS)
+        {
+            rc->stats.frames++;
+            rc->frameCycles = stamp;
+        }
+        else if (result == RC_PARSE_BAD_FRAME)
+        {
+            rc->stats.badFrames++;
+        }
+    }
+    __DMB();
+    rc->sequence++;
+}
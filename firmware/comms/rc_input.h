@@ -0,0 +1,79 @@
+#ifndef RC_INPUT_H
+#define RC_INPUT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "stm32f4xx_hal.h"
+#include "rc_protocol.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Hardware: USART6 RX on PC7 (AF8), DMA2 Stream 1 channel 5 in circular
+ * mode. The only interrupt is USART IDLE, raised once per frame: the
+ * handler parses the new bytes in place from the ring. USART6_IRQHandler
+ * must call RcInput_UartIrqHandler.
+ */
+#define RC_INPUT_RING_SIZE 128 // power of two, > 2 frames
+
+    typedef struct
+    {
+        uint8_t protocol; ///< enum RcProtocol
+    } RcInput_Config_t;
+
+    typedef struct
+    {
+        uint32_t frames;     ///< Channel frames decoded
+        uint32_t badFrames;  ///< CRC / footer failures
+        uint32_t idleEvents; ///< IDLE interrupts served
+    } RcInput_Stats_t;
+
+    /**
+     * @brief Driver handle. Owns the UART, DMA stream and ring buffer.
+     */
+    typedef struct
+    {
+        RcInput_Config_t config;
+        UART_HandleTypeDef huart;
+        DMA_HandleTypeDef hdma;
+
+        uint8_t ring[RC_INPUT_RING_SIZE]; ///< DMA target
+        uint16_t readPos;                 ///< Free-running parse index
+        uint32_t charCycles;              ///< One character time in core cycles
+
+        RcProtocol_Frame_t frame;          ///< Latest decoded frame (written by the IRQ)
+        volatile uint32_t frameCycles;     ///< DWT timestamp of the last byte of that frame
+        volatile uint32_t sequence;        ///< Odd while the IRQ updates the frame
+        RcInput_Stats_t stats;
+    } RcInput_Handle_t;
+
+    /**
+     * @brief Configure USART6 and its DMA for the selected protocol and start receiving
+     * @param[out] rc  Pointer to driver handle
+     * @param[in]  cfg Pointer to configuration
+     * @retval  0 on success, negative on error
+     */
+    int RcInput_Init(RcInput_Handle_t *rc, const RcInput_Config_t *cfg);
+
+    /**
+     * @brief Consistent copy of the latest frame
+     * @param[in]  rc             Pointer to driver handle
+     * @param[out] frame          Latest channels and link state
+     * @param[out] timestampCycles DWT count at the end of the frame (may be NULL)
+     * @return Number of channel frames received so far (0 = none yet)
+     */
+    uint32_t RcInput_GetFrame(const RcInput_Handle_t *rc, RcProtocol_Frame_t *frame, uint32_t *timestampCycles);
+
+    /**
+     * @brief USART interrupt entry point, call from USART6_IRQHandler
+     */
+    void RcInput_UartIrqHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RC_INPUT_H
@@ -0,0 +1,98 @@
+#ifndef RC_PROTOCOL_H
+#define RC_PROTOCOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * SBUS and CRSF frame parsers working directly on a DMA ring buffer.
+ * Both protocols pack 16 channels of 11 bits LSB first and use the same
+ * channel scale (172 = 988 us, 992 = 1500 us, 1811 = 2012 us).
+ * No HAL dependency: builds on the host.
+ */
+#define RC_CHANNELS 16
+#define RC_CHANNEL_MIN 172
+#define RC_CHANNEL_MID 992
+#define RC_CHANNEL_MAX 1811
+
+#define RC_SBUS_FRAME_LEN 25
+#define RC_SBUS_HEADER 0x0F
+#define RC_SBUS_FLAG_FRAME_LOST 0x04
+#define RC_SBUS_FLAG_FAILSAFE 0x08
+
+#define RC_CRSF_ADDR_FC 0xC8       // flight controller
+#define RC_CRSF_MAX_FRAME_LEN 64   // addr + len + up to 62 bytes
+#define RC_CRSF_TYPE_LINK_STATS 0x14
+#define RC_CRSF_TYPE_RC_CHANNELS 0x16
+#define RC_CRSF_RC_PAYLOAD_LEN 22
+
+    enum RcProtocol
+    {
+        RC_PROTOCOL_SBUS = 0, ///< 100000 baud 8E2, inverted (needs an external inverter on the F411)
+        RC_PROTOCOL_CRSF,     ///< 420000 baud 8N1
+    };
+
+    enum RcProtocol_Result
+    {
+        RC_PARSE_NEED_MORE = 0, ///< No complete frame in the buffer yet
+        RC_PARSE_CHANNELS,      ///< A channel frame was decoded into the output
+        RC_PARSE_OTHER,         ///< A valid frame of another type was consumed
+        RC_PARSE_BAD_FRAME,     ///< A corrupt frame (CRC, footer) was dropped
+    };
+
+    typedef struct
+    {
+        uint16_t channel[RC_CHANNELS]; ///< Raw 11-bit channel values
+        bool failsafe;                 ///< Receiver reports loss of link
+        bool frameLost;                ///< SBUS: receiver dropped a frame
+        uint8_t linkQuality;           ///< CRSF: uplink LQ in percent (from link statistics)
+    } RcProtocol_Frame_t;
+
+    /**
+     * @brief View of a power-of-two sized ring buffer written by DMA
+     */
+    typedef struct
+    {
+        const volatile uint8_t *data; ///< Ring storage
+        uint16_t mask;                ///< Size - 1
+    } RcProtocol_Ring_t;
+
+    /**
+     * @brief Parse at most one frame between *readPos and writePos
+     *        Bytes are read in place from the ring; leading garbage is skipped.
+     *        *readPos is advanced past anything consumed.
+     * @param[in]     protocol enum RcProtocol
+     * @param[in]     ring     Ring buffer view
+     * @param[in,out] readPos  Free-running read index
+     * @param[in]     writePos Free-running write index
+     * @param[in,out] frame    Updated with the decoded channels / link state
+     * @return enum RcProtocol_Result
+     */
+    int RcProtocol_Parse(uint8_t protocol, const RcProtocol_Ring_t *ring, uint16_t *readPos, uint16_t writePos,
+                         RcProtocol_Frame_t *frame);
+
+    /**
+     * @brief CRSF CRC-8 (poly 0xD5) update
+     * @param[in] crc  Running CRC (start with 0)
+     * @param[in] byte Next byte
+     * @return Updated CRC
+     */
+    uint8_t RcProtocol_Crc8(uint8_t crc, uint8_t byte);
+
+    /**
+     * @brief Normalize a raw channel value
+     * @param[in] raw 11-bit channel value
+     * @return -1..1 (clamped) with RC_CHANNEL_MID at 0
+     */
+    float RcProtocol_ChannelToUnit(uint16_t raw);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RC_PROTOCOL_H
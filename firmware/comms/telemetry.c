@@ -0,0 +1,400 @@
+#include "telemetry.h"
+#include <string.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL DEFINITIONS                                                       */
+/*----------------------------------------------------------------------------*/
+
+#define TELEMETRY_SLOT_MASK (TELEMETRY_QUEUE_SLOTS - 1u)
+#define TELEMETRY_RX_FIFO_MASK (TELEMETRY_RX_FIFO_SIZE - 1u)
+#define TELEMETRY_MAX_BAUD 2000000u
+#define TELEMETRY_OVER8_BAUD 1000000u // above this, 8x oversampling for an exact divider
+
+static Telemetry_Handle_t *s_active = NULL; ///< Handle served by the DMA interrupt handlers
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @brief Mask the telemetry DMA interrupt (and lower) but leave the
+ *        sensor, RC and motor interrupts running
+ * @return Previous BASEPRI, for Telemetry_Unlock
+ */
+static inline uint32_t Telemetry_Lock(void)
+{
+    uint32_t basepri = __get_BASEPRI();
+    __set_BASEPRI(TELEMETRY_IRQ_PRIORITY << (8u - __NVIC_PRIO_BITS));
+    return basepri;
+}
+
+static inline void Telemetry_Unlock(uint32_t basepri)
+{
+    __set_BASEPRI(basepri);
+}
+
+static bool Telemetry_StartDma(Telemetry_Handle_t *tm, const uint8_t *data, uint16_t len)
+{
+    tm->busy = true;
+    if (HAL_DMA_Start_IT(&tm->hdma, (uint32_t)data, (uint32_t)&tm->config.huart->Instance->DR, len) != HAL_OK)
+    {
+        tm->busy = false;
+        return false;
+    }
+    tm->stats.bytesSent += len;
+    return true;
+}
+
+/**
+ * @brief Queue mode: hand the oldest queued slot to the DMA, or go idle
+ *        Runs in the DMA interrupt or under Telemetry_Lock.
+ */
+static void Telemetry_StartNextSlot(Telemetry_Handle_t *tm)
+{
+    if (tm->tail == tm->head)
+    {
+        tm->busy = false;
+        return;
+    }
+
+    Telemetry_Slot_t *slot = &tm->buffer.slot[tm->tail & TELEMETRY_SLOT_MASK];
+    Telemetry_StartDma(tm, slot->data, slot->len);
+}
+
+/**
+ * @brief Stream mode: send the filling buffer and start filling the other one
+ *        Runs in the DMA interrupt or under Telemetry_Lock.
+ */
+static void Telemetry_SwapBuffers(Telemetry_Handle_t *tm)
+{
+    uint16_t len = tm->fillLen;
+    if (len == 0)
+    {
+        tm->busy = false;
+        return;
+    }
+
+    const uint8_t *data = tm->buffer.stream[tm->fill];
+    tm->fill ^= 1u;
+    tm->fillLen = 0;
+    if (!Telemetry_StartDma(tm, data, len))
+    {
+        tm->stats.bytesDropped += len;
+    }
+}
+
+/**
+ * @brief Last byte moved to the data register: release the slot or buffer, send the next
+ */
+static void Telemetry_DmaComplete(DMA_HandleTypeDef *hdma)
+{
+    Telemetry_Handle_t *tm = (Telemetry_Handle_t *)hdma->Parent;
+    if (tm->config.mode == TELEMETRY_MODE_STREAM)
+    {
+        Telemetry_SwapBuffers(tm);
+    }
+    else
+    {
+        tm->tail++;
+        Telemetry_StartNextSlot(tm);
+    }
+}
+
+static void Telemetry_DmaError(DMA_HandleTypeDef *hdma)
+{
+    // Drop the transfer in flight rather than stalling the link
+    Telemetry_DmaComplete(hdma);
+}
+
+static int Telemetry_InitDma(Telemetry_Handle_t *tm)
+{
+    __HAL_RCC_DMA1_CLK_ENABLE();
+
+    tm->hdma.Instance = DMA1_Stream6;
+    tm->hdma.Init.Channel = DMA_CHANNEL_4;
+    tm->hdma.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    tm->hdma.Init.PeriphInc = DMA_PINC_DISABLE;
+    tm->hdma.Init.MemInc = DMA_MINC_ENABLE;
+    tm->hdma.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    tm->hdma.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    tm->hdma.Init.Mode = DMA_NORMAL;
+    tm->hdma.Init.Priority = DMA_PRIORITY_LOW;
+    tm->hdma.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    if (HAL_DMA_Init(&tm->hdma) != HAL_OK)
+    {
+        return -1;
+    }
+
+    tm->hdma.Parent = tm;
+    tm->hdma.XferCpltCallback = Telemetry_DmaComplete;
+    tm->hdma.XferErrorCallback = Telemetry_DmaError;
+
+    HAL_NVIC_SetPriority(DMA1_Stream6_IRQn, TELEMETRY_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Stream6_IRQn);
+    return 0;
+}
+
+/**
+ * @brief Move the bytes the RX DMA has written since the last call into the FIFO
+ *        Runs in the RX DMA interrupt or under Telemetry_Lock.
+ */
+static void Telemetry_RxDrain(Telemetry_Handle_t *tm)
+{
+    uint16_t ringHead = (uint16_t)(TELEMETRY_RX_RING_SIZE - __HAL_DMA_GET_COUNTER(&tm->hdmaRx));
+    if (ringHead >= TELEMETRY_RX_RING_SIZE)
+    {
+        ringHead = 0;
+    }
+
+    uint16_t head = tm->rxHead;
+    while (tm->rxRingPos != ringHead)
+    {
+        if ((uint16_t)(head - tm->rxTail) < TELEMETRY_RX_FIFO_SIZE)
+        {
+            tm->rxFifo[head & TELEMETRY_RX_FIFO_MASK] = tm->rxRing[tm->rxRingPos];
+            head++;
+        }
+        else
+        {
+            tm->stats.bytesLost++;
+        }
+        tm->rxRingPos = (uint16_t)((tm->rxRingPos + 1u) % TELEMETRY_RX_RING_SIZE);
+    }
+    __DMB();
+    tm->rxHead = head;
+}
+
+/**
+ * @brief Half or whole ring written: empty it before the DMA comes round again
+ */
+static void Telemetry_RxDmaEvent(DMA_HandleTypeDef *hdma)
+{
+    (void)hdma; // Parent is the UART handle, linked for the HAL
+    if (s_active)
+    {
+        Telemetry_RxDrain(s_active);
+    }
+}
+
+/**
+ * @brief Circular RX DMA into rxRing, with the half and complete interrupts draining it
+ */
+static int Telemetry_InitRxDma(Telemetry_Handle_t *tm)
+{
+    tm->hdmaRx.Instance = DMA1_Stream5;
+    tm->hdmaRx.Init.Channel = DMA_CHANNEL_4;
+    tm->hdmaRx.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    tm->hdmaRx.Init.PeriphInc = DMA_PINC_DISABLE;
+    tm->hdmaRx.Init.MemInc = DMA_MINC_ENABLE;
+    tm->hdmaRx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    tm->hdmaRx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    tm->hdmaRx.Init.Mode = DMA_CIRCULAR;
+    tm->hdmaRx.Init.Priority = DMA_PRIORITY_MEDIUM;
+    tm->hdmaRx.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    if (HAL_DMA_Init(&tm->hdmaRx) != HAL_OK)
+    {
+        return -1;
+    }
+
+    UART_HandleTypeDef *huart = tm->config.huart;
+    __HAL_LINKDMA(huart, hdmarx, tm->hdmaRx);
+    tm->hdmaRx.XferHalfCpltCallback = Telemetry_RxDmaEvent;
+    tm->hdmaRx.XferCpltCallback = Telemetry_RxDmaEvent;
+
+    // Same priority as the TX stream, so Telemetry_Lock keeps it out as well
+    HAL_NVIC_SetPriority(DMA1_Stream5_IRQn, TELEMETRY_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Stream5_IRQn);
+
+    if (HAL_DMA_Start_IT(&tm->hdmaRx, (uint32_t)&huart->Instance->DR, (uint32_t)tm->rxRing,
+                         TELEMETRY_RX_RING_SIZE) != HAL_OK)
+    {
+        return -1;
+    }
+    SET_BIT(huart->Instance->CR3, USART_CR3_DMAR);
+    return 0;
+}
+
+/**
+ * @brief Reprogram the UART divider. USART2 runs from the 42 MHz APB1 clock:
+ *        921600 is 0.9% off with 16x oversampling, 2000000 is exact with 8x.
+ */
+static int Telemetry_SetBaud(UART_HandleTypeDef *huart, uint32_t baudRate)
+{
+    huart->Init.BaudRate = baudRate;
+    huart->Init.OverSampling = (baudRate > TELEMETRY_OVER8_BAUD) ? UART_OVERSAMPLING_8 : UART_OVERSAMPLING_16;
+    return (HAL_UART_Init(huart) == HAL_OK) ? 0 : -1;
+}
+
+/**
+ * @brief Queue mode: store one message in the next free slot and start the DMA if idle
+ */
+static int Telemetry_QueuePush(Telemetry_Handle_t *tm, const uint8_t *data, size_t len)
+{
+    uint8_t used = (uint8_t)(tm->head - tm->tail);
+    if (used >= TELEMETRY_QUEUE_SLOTS)
+    {
+        return -2;
+    }
+    if (used + 1u > tm->stats.highWater)
+    {
+        tm->stats.highWater = (uint8_t)(used + 1u);
+    }
+
+    Telemetry_Slot_t *slot = &tm->buffer.slot[tm->head & TELEMETRY_SLOT_MASK];
+    memcpy(slot->data, data, len);
+    slot->len = (uint8_t)len;
+    __DMB();
+    tm->head++;
+
+    // The complete interrupt must not go idle between the test and the start
+    uint32_t basepri = Telemetry_Lock();
+    if (!tm->busy)
+    {
+        Telemetry_StartNextSlot(tm);
+    }
+    Telemetry_Unlock(basepri);
+    return 0;
+}
+
+/**
+ * @brief Stream mode: append one message to the filling buffer and start the DMA if idle
+ *        The copy runs under Telemetry_Lock because the complete interrupt may swap buffers.
+ */
+static int Telemetry_StreamAppend(Telemetry_Handle_t *tm, const uint8_t *data, size_t len)
+{
+    int result = -2;
+    uint32_t basepri = Telemetry_Lock();
+    if (tm->fillLen + len <= TELEMETRY_STREAM_BUFFER_SIZE)
+    {
+        memcpy(&tm->buffer.stream[tm->fill][tm->fillLen], data, len);
+        tm->fillLen = (uint16_t)(tm->fillLen + len);
+        if (tm->fillLen > tm->stats.bufferHighWater)
+        {
+            tm->stats.bufferHighWater = tm->fillLen;
+        }
+        if (!tm->busy)
+        {
+            Telemetry_SwapBuffers(tm);
+        }
+        result = 0;
+    }
+    Telemetry_Unlock(basepri);
+    return result;
+}
+
+static int Telemetry_Push(Telemetry_Handle_t *tm, const uint8_t *data, size_t len)
+{
+    int result = (tm->config.mode == TELEMETRY_MODE_STREAM) ? Telemetry_StreamAppend(tm, data, len)
+                                                            : Telemetry_QueuePush(tm, data, len);
+    if (result == 0)
+    {
+        tm->stats.framesSent++;
+    }
+    else
+    {
+        tm->stats.framesDropped++;
+        tm->stats.bytesDropped += len;
+    }
+    return result;
+}
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+int Telemetry_Init(Telemetry_Handle_t *tm, const Telemetry_Config_t *cfg)
+{
+    if (!tm || !cfg || !cfg->huart || !cfg->huart->Instance || cfg->baudRate > TELEMETRY_MAX_BAUD ||
+        (cfg->mode != TELEMETRY_MODE_QUEUE && cfg->mode != TELEMETRY_MODE_STREAM))
+    {
+        return -1;
+    }
+
+    memset(tm, 0, sizeof(*tm));
+    tm->config = *cfg;
+
+    if (cfg->baudRate != 0 && Telemetry_SetBaud(cfg->huart, cfg->baudRate) != 0)
+    {
+        return -2;
+    }
+
+    if (Telemetry_InitDma(tm) != 0)
+    {
+        return -3;
+    }
+
+    s_active = tm;
+    if (cfg->receive && Telemetry_InitRxDma(tm) != 0)
+    {
+        return -3;
+    }
+
+    SET_BIT(tm->config.huart->Instance->CR3, USART_CR3_DMAT);
+    return 0;
+}
+
+int Telemetry_Send(Telemetry_Handle_t *tm, uint8_t msgId, const void *payload, size_t len)
+{
+    if (!tm || len > TELEMETRY_MAX_PAYLOAD)
+    {
+        return -1;
+    }
+
+    // Encode outside the lock; a dropped frame still consumes a sequence number
+    uint8_t frame[TELEMETRY_MAX_ENCODED];
+    size_t n = Telemetry_EncodeFrame(msgId, tm->sequence++, payload, len, frame);
+    if (n == 0)
+    {
+        return -1;
+    }
+    return Telemetry_Push(tm, frame, n);
+}
+
+int Telemetry_SendRaw(Telemetry_Handle_t *tm, const void *data, size_t len)
+{
+    if (!tm || !data || len == 0 || len > TELEMETRY_MAX_ENCODED)
+    {
+        return -1;
+    }
+    return Telemetry_Push(tm, (const uint8_t *)data, len);
+}
+
+size_t Telemetry_Receive(Telemetry_Handle_t *tm, uint8_t *out, size_t max)
+{
+    if (!tm || !tm->config.receive)
+    {
+        return 0;
+    }
+
+    // Pick up the bytes written since the last half-ring interrupt
+    uint32_t basepri = Telemetry_Lock();
+    Telemetry_RxDrain(tm);
+    Telemetry_Unlock(basepri);
+
+    size_t n = 0;
+    uint16_t tail = tm->rxTail;
+    while (tail != tm->rxHead && n < max)
+    {
+        out[n++] = tm->rxFifo[tail & TELEMETRY_RX_FIFO_MASK];
+        tail++;
+    }
+    tm->rxTail = tail;
+    tm->stats.bytesReceived += n;
+    return n;
+}
+
+void Telemetry_DmaIrqHandler(void)
+{
+    if (s_active)
+    {
+        HAL_DMA_IRQHandler(&s_active->hdma);
+    }
+}
+
+void Telemetry_RxDmaIrqHandler(void)
+{
+    if (s_active)
+    {
+        HAL_DMA_IRQHandler(&s_active->hdmaRx);
+    }
+}
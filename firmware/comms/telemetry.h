@@ -0,0 +1,162 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "stm32f4xx_hal.h"
+#include "telemetry_messages.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Hardware: USART2 TX (PA2, ST-LINK VCP) through DMA1 Stream 6 channel 4.
+ * The UART itself is set up by CubeMX (MX_USART2_UART_Init); this module
+ * only adds the DMA. DMA1_Stream6_IRQHandler must call
+ * Telemetry_DmaIrqHandler.
+ *
+ * Optional receive (config.receive): USART2 RX (PA3) runs through DMA1
+ * Stream 5 channel 4 into a circular TELEMETRY_RX_RING_SIZE ring. Its half
+ * and complete interrupts move the bytes on into a TELEMETRY_RX_FIFO_SIZE
+ * FIFO, which Telemetry_Receive drains; DMA1_Stream5_IRQHandler must call
+ * Telemetry_RxDmaIrqHandler. At 2 Mbaud the ring fills in 1.3 ms, less
+ * than a main-loop pass can take, so it is not left to polling: the
+ * interrupt empties it every 128 bytes (640 us). The FIFO holds 5 ms of
+ * continuous traffic at 2 Mbaud, many times the host commands that arrive
+ * between polls; bytes that find it full are dropped and counted.
+ *
+ * Queue mode (default): messages are encoded into one of
+ * TELEMETRY_QUEUE_SLOTS fixed slots at queue time, so queuing costs one
+ * bounded encode and never waits for the UART. The DMA complete interrupt
+ * starts the next slot. One DMA transfer per message suits low rates.
+ *
+ * Stream mode: two TELEMETRY_STREAM_BUFFER_SIZE buffers. Messages are
+ * appended to the filling buffer while the DMA drains the other; the
+ * complete interrupt swaps them, so the line never idles while data is
+ * pending. Meant for raw sensor streams at 921600 baud to 2 Mbaud.
+ *
+ * In both modes a message that does not fit is dropped and counted: the
+ * sensing path always wins. Single producer: send from thread context only.
+ */
+#define TELEMETRY_QUEUE_SLOTS 8           // power of two
+#define TELEMETRY_STREAM_BUFFER_SIZE 1024 // 5 ms at 2 Mbaud
+#define TELEMETRY_IRQ_PRIORITY 5          // below sensor, RC and motor interrupts
+#define TELEMETRY_RX_RING_SIZE 256        // DMA ring, an interrupt per half
+#define TELEMETRY_RX_FIFO_SIZE 1024       // power of two, waits for Telemetry_Receive
+
+    enum Telemetry_Mode
+    {
+        TELEMETRY_MODE_QUEUE = 0, ///< One DMA transfer per message
+        TELEMETRY_MODE_STREAM,    ///< Double-buffered byte stream
+    };
+
+    typedef struct
+    {
+        UART_HandleTypeDef *huart; ///< Initialized UART, shared with the CubeMX code
+        uint8_t mode;              ///< enum Telemetry_Mode
+        uint32_t baudRate;         ///< 0 keeps the CubeMX setting; up to 2000000 (ST-LINK VCP limit)
+        bool receive;              ///< Also run the RX DMA, for Telemetry_Receive
+    } Telemetry_Config_t;
+
+    typedef struct
+    {
+        uint32_t framesSent;      ///< Messages accepted for transmission
+        uint32_t framesDropped;   ///< Messages rejected because the queue or buffer was full
+        uint32_t bytesSent;       ///< Bytes handed to the DMA
+        uint32_t bytesDropped;    ///< Bytes of the dropped messages
+        uint8_t highWater;        ///< Queue mode: most slots ever in use
+        uint16_t bufferHighWater; ///< Stream mode: fullest the filling buffer has been, bytes
+        uint32_t bytesReceived;   ///< Bytes returned by Telemetry_Receive
+        uint32_t bytesLost;       ///< Received bytes dropped because the FIFO was full
+    } Telemetry_Stats_t;
+
+    typedef struct
+    {
+        uint8_t data[TELEMETRY_MAX_ENCODED];
+        uint8_t len;
+    } Telemetry_Slot_t;
+
+    /**
+     * @brief Driver handle. Owns the TX DMA stream and the transmit buffers.
+     */
+    typedef struct
+    {
+        Telemetry_Config_t config;
+        DMA_HandleTypeDef hdma; ///< USART2_TX DMA handle
+
+        union
+        {
+            Telemetry_Slot_t slot[TELEMETRY_QUEUE_SLOTS];    ///< Queue mode
+            uint8_t stream[2][TELEMETRY_STREAM_BUFFER_SIZE]; ///< Stream mode
+        } buffer;
+        volatile uint8_t head;     ///< Queue mode: free-running, written by the producer
+        volatile uint8_t tail;     ///< Queue mode: free-running, written by the DMA interrupt
+        uint8_t fill;              ///< Stream mode: index of the buffer being filled
+        volatile uint16_t fillLen; ///< Stream mode: bytes in that buffer
+        volatile bool busy;        ///< A DMA transfer is in flight
+        uint8_t sequence;          ///< Frame sequence number, wraps
+
+        DMA_HandleTypeDef hdmaRx;                 ///< USART2_RX DMA handle, circular
+        uint8_t rxRing[TELEMETRY_RX_RING_SIZE];
+        uint16_t rxRingPos;                       ///< Next ring byte to move into the FIFO
+        uint8_t rxFifo[TELEMETRY_RX_FIFO_SIZE];
+        volatile uint16_t rxHead;                 ///< FIFO, free-running, written by the RX interrupt
+        volatile uint16_t rxTail;                 ///< FIFO, free-running, written by Telemetry_Receive
+
+        Telemetry_Stats_t stats;
+    } Telemetry_Handle_t;
+
+    /**
+     * @brief Set the baud rate, attach the TX DMA to the UART and empty the buffers
+     * @param[out] tm  Pointer to driver handle
+     * @param[in]  cfg Pointer to configuration
+     * @retval  0 on success, negative on error
+     */
+    int Telemetry_Init(Telemetry_Handle_t *tm, const Telemetry_Config_t *cfg);
+
+    /**
+     * @brief Frame a message and queue (or append) it for transmission
+     * @param[in,out] tm      Pointer to driver handle
+     * @param[in]     msgId   enum Telemetry_MsgId
+     * @param[in]     payload Message struct
+     * @param[in]     len     Payload size, <= TELEMETRY_MAX_PAYLOAD
+     * @retval  0 accepted, -1 on error, -2 no room (message dropped)
+     */
+    int Telemetry_Send(Telemetry_Handle_t *tm, uint8_t msgId, const void *payload, size_t len);
+
+    /**
+     * @brief Queue bytes as they are, without framing (human-readable text lines)
+     * @param[in,out] tm   Pointer to driver handle
+     * @param[in]     data Bytes to send
+     * @param[in]     len  Number of bytes, <= TELEMETRY_MAX_ENCODED
+     * @retval  0 accepted, -1 on error, -2 no room (data dropped)
+     */
+    int Telemetry_SendRaw(Telemetry_Handle_t *tm, const void *data, size_t len);
+
+    /**
+     * @brief Take the bytes received since the last call (config.receive only)
+     * @param[in,out] tm  Pointer to driver handle
+     * @param[out]    out Destination
+     * @param[in]     max Size of out
+     * @return Bytes copied; bytes that arrived while the FIFO was full were
+     *         dropped and counted in stats.bytesLost
+     */
+    size_t Telemetry_Receive(Telemetry_Handle_t *tm, uint8_t *out, size_t max);
+
+    /**
+     * @brief DMA interrupt entry point, call from DMA1_Stream6_IRQHandler
+     */
+    void Telemetry_DmaIrqHandler(void);
+
+    /**
+     * @brief RX DMA interrupt entry point, call from DMA1_Stream5_IRQHandler
+     */
+    void Telemetry_RxDmaIrqHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TELEMETRY_H
@@ -0,0 +1,72 @@
+#ifndef TELEMETRY_FRAME_H
+#define TELEMETRY_FRAME_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Binary telemetry framing, HAL-free.
+ *
+ *   raw frame : msgId (1) | seq (1) | payload (0..TELEMETRY_MAX_PAYLOAD) | crc16 (2, LE)
+ *   on wire   : COBS(raw frame) | 0x00
+ *
+ * CRC is CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) over msgId..payload;
+ * on the host it is binascii.crc_hqx(raw[:-2], 0xFFFF). COBS removes every
+ * 0x00 from the frame so the delimiter resynchronizes the decoder after any
+ * corruption. Message ids and payload structs are generated from
+ * telemetry.schema into telemetry_messages.h.
+ */
+#define TELEMETRY_MAX_PAYLOAD 120 // keeps TELEMETRY_MAX_ENCODED within a uint8_t slot length
+#define TELEMETRY_RAW_OVERHEAD 4  // msgId + seq + crc16
+#define TELEMETRY_MAX_RAW (TELEMETRY_MAX_PAYLOAD + TELEMETRY_RAW_OVERHEAD)
+// COBS adds one byte per 254 (+1), then the delimiter
+#define TELEMETRY_MAX_ENCODED (TELEMETRY_MAX_RAW + TELEMETRY_MAX_RAW / 254 + 2)
+
+    /**
+     * @brief CRC-16/CCITT-FALSE
+     * @param[in] crc  Running value (0xFFFF to start)
+     * @param[in] data Bytes to add
+     * @param[in] len  Number of bytes
+     * @return Updated CRC
+     */
+    uint16_t Telemetry_Crc16(uint16_t crc, const uint8_t *data, size_t len);
+
+    /**
+     * @brief COBS-encode a buffer and append the 0x00 delimiter
+     * @param[in]  in     Source bytes
+     * @param[in]  len    Number of source bytes
+     * @param[out] out    Destination, at least len + len / 254 + 2 bytes
+     * @return Number of bytes written, delimiter included
+     */
+    size_t Telemetry_CobsEncode(const uint8_t *in, size_t len, uint8_t *out);
+
+    /**
+     * @brief Decode one COBS block (without its delimiter). Used by tests and host tools.
+     * @param[in]  in     Encoded bytes, no 0x00 inside
+     * @param[in]  len    Number of encoded bytes
+     * @param[out] out    Destination, at least len bytes
+     * @return Decoded length, or -1 on a malformed block
+     */
+    int Telemetry_CobsDecode(const uint8_t *in, size_t len, uint8_t *out);
+
+    /**
+     * @brief Build a complete on-wire frame (header, CRC, COBS, delimiter)
+     * @param[in]  msgId   enum Telemetry_MsgId
+     * @param[in]  seq     Per-link sequence counter, lets the host count losses
+     * @param[in]  payload Message struct
+     * @param[in]  len     Payload size, <= TELEMETRY_MAX_PAYLOAD
+     * @param[out] out     Destination, TELEMETRY_MAX_ENCODED bytes
+     * @return Number of bytes written, or 0 if the payload is too large
+     */
+    size_t Telemetry_EncodeFrame(uint8_t msgId, uint8_t seq, const void *payload, size_t len, uint8_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TELEMETRY_FRAME_H
@@ -0,0 +1,211 @@
+#ifndef TELEMETRY_MESSAGES_H
+#define TELEMETRY_MESSAGES_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "telemetry_frame.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Generated by tools/gen_telemetry_schema.py from telemetry.schema: edit the
+ * schema and regenerate rather than this file. Payloads are the packed
+ * little-endian structs below; Telemetry_Encode<Message> frames one with
+ * the id and size that belong to it.
+ */
+#define TELEMETRY_SCHEMA_HASH 0x18D80171u
+#define TELEMETRY_SCHEMA_MESSAGES 11
+#define TELEMETRY_LOG_CHUNK 116 // Log bytes per LOG_DATA frame: TELEMETRY_MAX_PAYLOAD less the offset
+#define TELEMETRY_VIBRATION_PEAKS 9 // Gyro axes times VIBRATION_PEAKS
+
+    enum Telemetry_MsgId
+    {
+        TELEMETRY_MSG_BARO = 0x01,      ///< Telemetry_Baro_t
+        TELEMETRY_MSG_IMU = 0x02,       ///< Telemetry_Imu_t
+        TELEMETRY_MSG_MAG = 0x03,       ///< Telemetry_Mag_t
+        TELEMETRY_MSG_IMU_BLOCK = 0x04, ///< Compressed IMU samples, see imu_compress.h
+        TELEMETRY_MSG_VIBRATION = 0x05, ///< Telemetry_Vibration_t: Gyro peaks of a spectrum, see vibration_analyzer.h
+        TELEMETRY_MSG_STATUS = 0x10,    ///< Telemetry_Status_t
+        TELEMETRY_MSG_SCHEMA = 0x11,    ///< Telemetry_Schema_t: Firmware build schema, sent at start and every second
+        TELEMETRY_MSG_LOG_INFO = 0x20,  ///< Telemetry_LogInfo_t: Host: empty request; board: this reply
+        TELEMETRY_MSG_LOG_READ = 0x21,  ///< Telemetry_LogRead_t: Host request
+        TELEMETRY_MSG_LOG_ACK = 0x22,   ///< Telemetry_LogAck_t: Host
+        TELEMETRY_MSG_LOG_DATA = 0x23,  ///< Telemetry_LogData_t: Board, see log_download.h
+    };
+
+    typedef struct __attribute__((packed))
+    {
+        uint32_t time_ms;
+        float pressure_hPa;
+        float temperature_C;
+        float altitude_m;    ///< Altitude estimator output above the ground reference
+        float climbRate_mps;
+    } Telemetry_Baro_t;
+
+    typedef struct __attribute__((packed))
+    {
+        uint32_t time_us;
+        int16_t accel[3]; ///< Raw LSB, sensor axes
+        int16_t gyro[3];  ///< Raw LSB, sensor axes
+    } Telemetry_Imu_t;
+
+    typedef struct __attribute__((packed))
+    {
+        uint32_t time_us;
+        int16_t mag[3];   ///< Raw LSB, sensor axes
+    } Telemetry_Mag_t;
+
+    typedef struct __attribute__((packed))
+    {
+        uint32_t time_ms;
+        uint32_t sequence;                          ///< VibrationAnalyzer_Spectrum_t sequence
+        float resolution_Hz;                        ///< FFT bin width
+        float freq_Hz[TELEMETRY_VIBRATION_PEAKS];   ///< Gyro x, y, z peaks in turn, strongest first
+        float amplitude[TELEMETRY_VIBRATION_PEAKS]; ///< rad/s; zero means no peak
+    } Telemetry_Vibration_t;
+
+    typedef struct __attribute__((packed))
+    {
+        uint32_t time_ms;
+        uint32_t framesSent;    ///< Telemetry frames handed to the DMA
+        uint32_t framesDropped; ///< Frames rejected because the queue was full
+        uint16_t loopMaxCycles; ///< Worst main loop iteration since the last STATUS, saturated at 65535
+        uint8_t queueHighWater; ///< Most slots ever in use; stream mode: fullest buffer, percent
+        uint8_t reserved;
+    } Telemetry_Status_t;
+
+    typedef struct __attribute__((packed))
+    {
+        uint32_t hash;     ///< TELEMETRY_SCHEMA_HASH
+        uint16_t messages; ///< TELEMETRY_SCHEMA_MESSAGES
+        uint16_t reserved;
+    } Telemetry_Schema_t;
+
+    typedef struct __attribute__((packed))
+    {
+        uint32_t size;      ///< Log bytes available
+        uint16_t chunkSize; ///< Log bytes per full LOG_DATA frame
+        uint16_t window;    ///< Chunks the board sends ahead of the last ACK
+        uint32_t origin;    ///< Sequence of the oldest blackbox sector: offsets count from its start
+    } Telemetry_LogInfo_t;
+
+    typedef struct __attribute__((packed))
+    {
+        uint32_t offset; ///< First log byte wanted
+        uint32_t length; ///< Bytes from there, clipped to the log size (0xFFFFFFFF: to the end)
+    } Telemetry_LogRead_t;
+
+    typedef struct __attribute__((packed))
+    {
+        uint32_t offset; ///< Every byte below this was received
+    } Telemetry_LogAck_t;
+
+    typedef struct __attribute__((packed))
+    {
+        uint32_t offset;                   ///< Log offset of data[0]
+        uint8_t data[TELEMETRY_LOG_CHUNK]; ///< Frame payload length - 4 bytes are valid
+    } Telemetry_LogData_t;
+
+#ifndef __cplusplus
+    _Static_assert(sizeof(Telemetry_Baro_t) == 20, "Baro layout");
+    _Static_assert(sizeof(Telemetry_Imu_t) == 16, "Imu layout");
+    _Static_assert(sizeof(Telemetry_Mag_t) == 10, "Mag layout");
+    _Static_assert(sizeof(Telemetry_Vibration_t) == 84, "Vibration layout");
+    _Static_assert(sizeof(Telemetry_Status_t) == 16, "Status layout");
+    _Static_assert(sizeof(Telemetry_Schema_t) == 8, "Schema layout");
+    _Static_assert(sizeof(Telemetry_LogInfo_t) == 12, "LogInfo layout");
+    _Static_assert(sizeof(Telemetry_LogRead_t) == 8, "LogRead layout");
+    _Static_assert(sizeof(Telemetry_LogAck_t) == 4, "LogAck layout");
+    _Static_assert(sizeof(Telemetry_LogData_t) == 120, "LogData layout");
+#endif
+
+    /**
+     * @brief Frame a TELEMETRY_MSG_BARO message, see Telemetry_EncodeFrame
+     */
+    static inline size_t Telemetry_EncodeBaro(uint8_t seq, const Telemetry_Baro_t *msg, uint8_t *out)
+    {
+        return Telemetry_EncodeFrame(TELEMETRY_MSG_BARO, seq, msg, sizeof(*msg), out);
+    }
+
+    /**
+     * @brief Frame a TELEMETRY_MSG_IMU message, see Telemetry_EncodeFrame
+     */
+    static inline size_t Telemetry_EncodeImu(uint8_t seq, const Telemetry_Imu_t *msg, uint8_t *out)
+    {
+        return Telemetry_EncodeFrame(TELEMETRY_MSG_IMU, seq, msg, sizeof(*msg), out);
+    }
+
+    /**
+     * @brief Frame a TELEMETRY_MSG_MAG message, see Telemetry_EncodeFrame
+     */
+    static inline size_t Telemetry_EncodeMag(uint8_t seq, const Telemetry_Mag_t *msg, uint8_t *out)
+    {
+        return Telemetry_EncodeFrame(TELEMETRY_MSG_MAG, seq, msg, sizeof(*msg), out);
+    }
+
+    /**
+     * @brief Frame a TELEMETRY_MSG_VIBRATION message, see Telemetry_EncodeFrame
+     */
+    static inline size_t Telemetry_EncodeVibration(uint8_t seq, const Telemetry_Vibration_t *msg, uint8_t *out)
+    {
+        return Telemetry_EncodeFrame(TELEMETRY_MSG_VIBRATION, seq, msg, sizeof(*msg), out);
+    }
+
+    /**
+     * @brief Frame a TELEMETRY_MSG_STATUS message, see Telemetry_EncodeFrame
+     */
+    static inline size_t Telemetry_EncodeStatus(uint8_t seq, const Telemetry_Status_t *msg, uint8_t *out)
+    {
+        return Telemetry_EncodeFrame(TELEMETRY_MSG_STATUS, seq, msg, sizeof(*msg), out);
+    }
+
+    /**
+     * @brief Frame a TELEMETRY_MSG_SCHEMA message, see Telemetry_EncodeFrame
+     */
+    static inline size_t Telemetry_EncodeSchema(uint8_t seq, const Telemetry_Schema_t *msg, uint8_t *out)
+    {
+        return Telemetry_EncodeFrame(TELEMETRY_MSG_SCHEMA, seq, msg, sizeof(*msg), out);
+    }
+
+    /**
+     * @brief Frame a TELEMETRY_MSG_LOG_INFO message, see Telemetry_EncodeFrame
+     */
+    static inline size_t Telemetry_EncodeLogInfo(uint8_t seq, const Telemetry_LogInfo_t *msg, uint8_t *out)
+    {
+        return Telemetry_EncodeFrame(TELEMETRY_MSG_LOG_INFO, seq, msg, sizeof(*msg), out);
+    }
+
+    /**
+     * @brief Frame a TELEMETRY_MSG_LOG_READ message, see Telemetry_EncodeFrame
+     */
+    static inline size_t Telemetry_EncodeLogRead(uint8_t seq, const Telemetry_LogRead_t *msg, uint8_t *out)
+    {
+        return Telemetry_EncodeFrame(TELEMETRY_MSG_LOG_READ, seq, msg, sizeof(*msg), out);
+    }
+
+    /**
+     * @brief Frame a TELEMETRY_MSG_LOG_ACK message, see Telemetry_EncodeFrame
+     */
+    static inline size_t Telemetry_EncodeLogAck(uint8_t seq, const Telemetry_LogAck_t *msg, uint8_t *out)
+    {
+        return Telemetry_EncodeFrame(TELEMETRY_MSG_LOG_ACK, seq, msg, sizeof(*msg), out);
+    }
+
+    /**
+     * @brief Frame a TELEMETRY_MSG_LOG_DATA message with the first dataLen elements of data
+     */
+    static inline size_t Telemetry_EncodeLogData(uint8_t seq, const Telemetry_LogData_t *msg, size_t dataLen,
+                                                 uint8_t *out)
+    {
+        size_t len = offsetof(Telemetry_LogData_t, data) + dataLen * sizeof(msg->data[0]);
+        return Telemetry_EncodeFrame(TELEMETRY_MSG_LOG_DATA, seq, msg, len, out);
+    }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TELEMETRY_MESSAGES_H
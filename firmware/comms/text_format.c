@@ -0,0 +1,217 @@
+#include "text_format.h"
+
+#ifdef TEXT_FORMAT_BENCHMARK
+#include <stdio.h>
+#include <math.h>
+#include "cycle_counter.h"
+#endif
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL DEFINITIONS                                                       */
+/*----------------------------------------------------------------------------*/
+
+#define TEXT_FORMAT_MAX_DECIMALS 6
+#define TEXT_FORMAT_INT_LIMIT 2147483520.0f // largest float below 2^31
+
+static const uint32_t s_pow10[TEXT_FORMAT_MAX_DECIMALS + 1] = {1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u};
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+static inline void TextFormat_Char(TextFormat_t *tf, char c)
+{
+    if (tf->len < tf->size)
+    {
+        tf->buf[tf->len++] = c;
+    }
+    else
+    {
+        tf->overflow = true;
+    }
+}
+
+/**
+ * @brief Append an unsigned decimal, zero-padded to at least minDigits (like %0*u)
+ */
+static void TextFormat_Uint(TextFormat_t *tf, uint32_t v, uint8_t minDigits)
+{
+    char digits[10];
+    uint8_t n = 0;
+    do
+    {
+        digits[n++] = (char)('0' + v % 10u);
+        v /= 10u;
+    } while (v != 0);
+
+    while (n < minDigits)
+    {
+        digits[n++] = '0';
+    }
+    while (n > 0)
+    {
+        TextFormat_Char(tf, digits[--n]);
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+void TextFormat_Init(TextFormat_t *tf, char *buf, size_t size)
+{
+    tf->buf = buf;
+    tf->size = (size > UINT16_MAX) ? UINT16_MAX : (uint16_t)size;
+    tf->len = 0;
+    tf->overflow = (buf == NULL);
+}
+
+void TextFormat_Str(TextFormat_t *tf, const char *s)
+{
+    while (*s)
+    {
+        TextFormat_Char(tf, *s++);
+    }
+}
+
+void TextFormat_Int(TextFormat_t *tf, int32_t v)
+{
+    uint32_t magnitude = (uint32_t)v;
+    if (v < 0)
+    {
+        TextFormat_Char(tf, '-');
+        magnitude = 0u - magnitude;
+    }
+    TextFormat_Uint(tf, magnitude, 1);
+}
+
+void TextFormat_Fixed(TextFormat_t *tf, float v, uint8_t decimals)
+{
+    if (decimals > TEXT_FORMAT_MAX_DECIMALS)
+    {
+        decimals = TEXT_FORMAT_MAX_DECIMALS;
+    }
+    if (v < 0.0f)
+    {
+        TextFormat_Char(tf, '-');
+        v = -v;
+    }
+    if (!(v <= TEXT_FORMAT_INT_LIMIT)) // also catches NaN
+    {
+        v = TEXT_FORMAT_INT_LIMIT;
+    }
+
+    // Same float operations as the old trunc() split, so the digits match exactly
+    uint32_t whole = (uint32_t)v;
+    TextFormat_Uint(tf, whole, 1);
+    if (decimals == 0)
+    {
+        return;
+    }
+    TextFormat_Char(tf, '.');
+    uint32_t frac = (uint32_t)((v - (float)whole) * (float)s_pow10[decimals]);
+    TextFormat_Uint(tf, frac, decimals);
+}
+
+size_t TextFormat_End(const TextFormat_t *tf)
+{
+    return tf->overflow ? 0 : tf->len;
+}
+
+size_t TextFormat_Vector3(char *buf, size_t size, int16_t x, int16_t y, int16_t z)
+{
+    TextFormat_t tf;
+    TextFormat_Init(&tf, buf, size);
+    TextFormat_Str(&tf, "x: ");
+    TextFormat_Int(&tf, x);
+    TextFormat_Str(&tf, ", y: ");
+    TextFormat_Int(&tf, y);
+    TextFormat_Str(&tf, ", z: ");
+    TextFormat_Int(&tf, z);
+    TextFormat_Str(&tf, "\r\n");
+    return TextFormat_End(&tf);
+}
+
+size_t TextFormat_PressureTemp(char *buf, size_t size, float pressure_hPa, float temperature_C)
+{
+    TextFormat_t tf;
+    TextFormat_Init(&tf, buf, size);
+    TextFormat_Str(&tf, "p: ");
+    TextFormat_Fixed(&tf, pressure_hPa, 4);
+    TextFormat_Str(&tf, ", t: ");
+    TextFormat_Fixed(&tf, temperature_C, 2);
+    TextFormat_Str(&tf, "\r\n");
+    return TextFormat_End(&tf);
+}
+
+#ifdef TEXT_FORMAT_BENCHMARK
+
+/**
+ * @brief The formatting main.c used before this module, kept verbatim as the reference
+ */
+static int TextFormat_ReferenceLine(char *buffer, size_t size, float pressure, float temp)
+{
+    char *tmpSignPressure = (pressure < 0) ? "-" : "";
+    float tmpValPressure = (pressure < 0) ? -pressure : pressure;
+
+    int tmpInt1Pressure = tmpValPressure;
+    float tmpFracPressure = tmpValPressure - tmpInt1Pressure;
+    int tmpInt2Pressure = trunc(tmpFracPressure * 10000);
+
+    char *tmpSignTemp = (temp < 0) ? "-" : "";
+    float tmpValTemp = (temp < 0) ? -temp : temp;
+
+    int tmpInt1Temp = tmpValTemp;
+    float tmpFracTemp = tmpValTemp - tmpInt1Temp;
+    int tmpInt2Temp = trunc(tmpFracTemp * 100);
+
+    return snprintf(buffer, size, "p: %s%d.%04d, t: %s%d.%02d\r\n", tmpSignPressure, tmpInt1Pressure,
+                    tmpInt2Pressure, tmpSignTemp, tmpInt1Temp, tmpInt2Temp);
+}
+
+int TextFormat_RunBenchmark(TextFormat_Benchmark_t *result)
+{
+    static const float s_pressure[] = {1013.25f, 987.6543f, 1100.0f, 260.0001f, 1060.9999f, 0.5f, -3.25f};
+    static const float s_temp[] = {21.5f, -5.75f, 0.0f, 39.99f, -0.01f, 85.0f, 17.125f};
+    const uint32_t count = sizeof(s_pressure) / sizeof(s_pressure[0]);
+
+    if (!result)
+    {
+        return -1;
+    }
+
+    char reference[TEXT_FORMAT_LINE_MAX];
+    char line[TEXT_FORMAT_LINE_MAX];
+    uint32_t snprintfTotal = 0;
+    uint32_t textFormatTotal = 0;
+    bool identical = true;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t start = CycleCounter_Read();
+        int refLen = TextFormat_ReferenceLine(reference, sizeof(reference), s_pressure[i], s_temp[i]);
+        uint32_t mid = CycleCounter_Read();
+        size_t len = TextFormat_PressureTemp(line, sizeof(line), s_pressure[i], s_temp[i]);
+        uint32_t end = CycleCounter_Read();
+
+        snprintfTotal += mid - start;
+        textFormatTotal += end - mid;
+
+        if (refLen <= 0 || (size_t)refLen != len)
+        {
+            identical = false;
+            continue;
+        }
+        for (size_t k = 0; k < len; k++)
+        {
+            identical &= (reference[k] == line[k]);
+        }
+    }
+
+    result->snprintfCycles = snprintfTotal / count;
+    result->textFormatCycles = textFormatTotal / count;
+    result->identical = identical;
+    return 0;
+}
+
+#endif // TEXT_FORMAT_BENCHMARK
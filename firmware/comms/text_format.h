@@ -0,0 +1,101 @@
+#ifndef TEXT_FORMAT_H
+#define TEXT_FORMAT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Human-readable telemetry lines without printf: no varargs, no heap, no
+ * float formatting from the C library. Fields are appended to a caller
+ * buffer; an overflow marks the line invalid instead of truncating it.
+ *
+ * Text output is the TELEMETRY_TEXT_OUTPUT build of main.c; binary frames
+ * are the default. The line builders produce, byte for byte, the formats
+ * the host tools read in text mode (stflight_capture -t, then stflight_plot):
+ *   accelerometer / magnetometer : "x: %d, y: %d, z: %d\r\n"
+ *   pressure / temperature       : "p: %s%d.%04d, t: %s%d.%02d\r\n"
+ * Fixed-point fields truncate toward zero like the old trunc() code.
+ */
+#define TEXT_FORMAT_LINE_MAX 50 // longest line of the builders below, with margin
+
+    typedef struct
+    {
+        char *buf;
+        uint16_t size;
+        uint16_t len;
+        bool overflow; ///< A field did not fit; TextFormat_End returns 0
+    } TextFormat_t;
+
+    typedef struct
+    {
+        uint32_t snprintfCycles;   ///< Old path: trunc() split + snprintf, mean per line
+        uint32_t textFormatCycles; ///< TextFormat_PressureTemp, mean per line
+        bool identical;            ///< Both produced the same bytes for every test value
+    } TextFormat_Benchmark_t;
+
+    /**
+     * @brief Start a line in a caller buffer
+     * @param[out] tf   Formatter state
+     * @param[out] buf  Destination (not NUL-terminated)
+     * @param[in]  size Destination size
+     */
+    void TextFormat_Init(TextFormat_t *tf, char *buf, size_t size);
+
+    /**
+     * @brief Append a NUL-terminated string
+     */
+    void TextFormat_Str(TextFormat_t *tf, const char *s);
+
+    /**
+     * @brief Append a signed decimal integer
+     */
+    void TextFormat_Int(TextFormat_t *tf, int32_t v);
+
+    /**
+     * @brief Append a value as [-]int.frac with a fixed number of decimals, truncated toward zero
+     * @param[in,out] tf       Formatter state
+     * @param[in]     v        Value, |v| < 2^31
+     * @param[in]     decimals 0..6
+     */
+    void TextFormat_Fixed(TextFormat_t *tf, float v, uint8_t decimals);
+
+    /**
+     * @brief Finish the line
+     * @return Line length in bytes, 0 if it overflowed the buffer
+     */
+    size_t TextFormat_End(const TextFormat_t *tf);
+
+    /**
+     * @brief "x: <x>, y: <y>, z: <z>\r\n", accelerometer and magnetometer text lines
+     * @return Line length, 0 if buf is too small
+     */
+    size_t TextFormat_Vector3(char *buf, size_t size, int16_t x, int16_t y, int16_t z);
+
+    /**
+     * @brief "p: <hPa, 4 decimals>, t: <degC, 2 decimals>\r\n", barometer text lines
+     * @return Line length, 0 if buf is too small
+     */
+    size_t TextFormat_PressureTemp(char *buf, size_t size, float pressure_hPa, float temperature_C);
+
+#ifdef TEXT_FORMAT_BENCHMARK
+    /**
+     * @brief Time pressure/temperature lines through the old snprintf path and
+     *        through TextFormat_PressureTemp on target, and compare their output.
+     *        Pulls in snprintf; only built with TEXT_FORMAT_BENCHMARK defined.
+     * @param[out] result Mean cycles per line and the byte comparison
+     * @retval  0 on success, negative on error
+     */
+    int TextFormat_RunBenchmark(TextFormat_Benchmark_t *result);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEXT_FORMAT_H
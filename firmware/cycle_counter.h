@@ -0,0 +1,34 @@
+#ifndef CYCLE_COUNTER_H
+#define CYCLE_COUNTER_H
+
+#include <stdint.h>
+#include "stm32f4xx.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Enable the DWT cycle counter (call once after SystemClock_Config)
+     */
+    static inline void CycleCounter_Init(void)
+    {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+
+    /**
+     * @brief Current core cycle count. Differences are valid across one wrap (~51 s at 84 MHz).
+     */
+    static inline uint32_t CycleCounter_Read(void)
+    {
+        return DWT->CYCCNT;
+    }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CYCLE_COUNTER_H
@@ -0,0 +1,170 @@
+/*
+ * CMSIS-DSP FFT tables for the sizes the firmware uses (see the ARM_TABLE_*
+ * definitions in CMakeLists.txt). Generated by tools/gen_fft_tables.py,
+ * do not edit.
+ */
+#include "arm_math.h"
+#include "arm_common_tables.h"
+
+const float32_t twiddleCoef_128[256] = {
+    1.000000000e+00f, 0.000000000e+00f, 9.987954562e-01f, 4.906767433e-02f,
+    9.951847267e-01f, 9.801714033e-02f, 9.891765100e-01f, 1.467304745e-01f,
+    9.807852804e-01f, 1.950903220e-01f, 9.700312532e-01f, 2.429801799e-01f,
+    9.569403357e-01f, 2.902846773e-01f, 9.415440652e-01f, 3.368898534e-01f,
+    9.238795325e-01f, 3.826834324e-01f, 9.039892931e-01f, 4.275550934e-01f,
+    8.819212643e-01f, 4.713967368e-01f, 8.577286100e-01f, 5.141027442e-01f,
+    8.314696123e-01f, 5.555702330e-01f, 8.032075315e-01f, 5.956993045e-01f,
+    7.730104534e-01f, 6.343932842e-01f, 7.409511254e-01f, 6.715589548e-01f,
+    7.071067812e-01f, 7.071067812e-01f, 6.715589548e-01f, 7.409511254e-01f,
+    6.343932842e-01f, 7.730104534e-01f, 5.956993045e-01f, 8.032075315e-01f,
+    5.555702330e-01f, 8.314696123e-01f, 5.141027442e-01f, 8.577286100e-01f,
+    4.713967368e-01f, 8.819212643e-01f, 4.275550934e-01f, 9.039892931e-01f,
+    3.826834324e-01f, 9.238795325e-01f, 3.368898534e-01f, 9.415440652e-01f,
+    2.902846773e-01f, 9.569403357e-01f, 2.429801799e-01f, 9.700312532e-01f,
+    1.950903220e-01f, 9.807852804e-01f, 1.467304745e-01f, 9.891765100e-01f,
+    9.801714033e-02f, 9.951847267e-01f, 4.906767433e-02f, 9.987954562e-01f,
+    6.123233996e-17f, 1.000000000e+00f, -4.906767433e-02f, 9.987954562e-01f,
+    -9.801714033e-02f, 9.951847267e-01f, -1.467304745e-01f, 9.891765100e-01f,
+    -1.950903220e-01f, 9.807852804e-01f, -2.429801799e-01f, 9.700312532e-01f,
+    -2.902846773e-01f, 9.569403357e-01f, -3.368898534e-01f, 9.415440652e-01f,
+    -3.826834324e-01f, 9.238795325e-01f, -4.275550934e-01f, 9.039892931e-01f,
+    -4.713967368e-01f, 8.819212643e-01f, -5.141027442e-01f, 8.577286100e-01f,
+    -5.555702330e-01f, 8.314696123e-01f, -5.956993045e-01f, 8.032075315e-01f,
+    -6.343932842e-01f, 7.730104534e-01f, -6.715589548e-01f, 7.409511254e-01f,
+    -7.071067812e-01f, 7.071067812e-01f, -7.409511254e-01f, 6.715589548e-01f,
+    -7.730104534e-01f, 6.343932842e-01f, -8.032075315e-01f, 5.956993045e-01f,
+    -8.314696123e-01f, 5.555702330e-01f, -8.577286100e-01f, 5.141027442e-01f,
+    -8.819212643e-01f, 4.713967368e-01f, -9.039892931e-01f, 4.275550934e-01f,
+    -9.238795325e-01f, 3.826834324e-01f, -9.415440652e-01f, 3.368898534e-01f,
+    -9.569403357e-01f, 2.902846773e-01f, -9.700312532e-01f, 2.429801799e-01f,
+    -9.807852804e-01f, 1.950903220e-01f, -9.891765100e-01f, 1.467304745e-01f,
+    -9.951847267e-01f, 9.801714033e-02f, -9.987954562e-01f, 4.906767433e-02f,
+    -1.000000000e+00f, 1.224646799e-16f, -9.987954562e-01f, -4.906767433e-02f,
+    -9.951847267e-01f, -9.801714033e-02f, -9.891765100e-01f, -1.467304745e-01f,
+    -9.807852804e-01f, -1.950903220e-01f, -9.700312532e-01f, -2.429801799e-01f,
+    -9.569403357e-01f, -2.902846773e-01f, -9.415440652e-01f, -3.368898534e-01f,
+    -9.238795325e-01f, -3.826834324e-01f, -9.039892931e-01f, -4.275550934e-01f,
+    -8.819212643e-01f, -4.713967368e-01f, -8.577286100e-01f, -5.141027442e-01f,
+    -8.314696123e-01f, -5.555702330e-01f, -8.032075315e-01f, -5.956993045e-01f,
+    -7.730104534e-01f, -6.343932842e-01f, -7.409511254e-01f, -6.715589548e-01f,
+    -7.071067812e-01f, -7.071067812e-01f, -6.715589548e-01f, -7.409511254e-01f,
+    -6.343932842e-01f, -7.730104534e-01f, -5.956993045e-01f, -8.032075315e-01f,
+    -5.555702330e-01f, -8.314696123e-01f, -5.141027442e-01f, -8.577286100e-01f,
+    -4.713967368e-01f, -8.819212643e-01f, -4.275550934e-01f, -9.039892931e-01f,
+    -3.826834324e-01f, -9.238795325e-01f, -3.368898534e-01f, -9.415440652e-01f,
+    -2.902846773e-01f, -9.569403357e-01f, -2.429801799e-01f, -9.700312532e-01f,
+    -1.950903220e-01f, -9.807852804e-01f, -1.467304745e-01f, -9.891765100e-01f,
+    -9.801714033e-02f, -9.951847267e-01f, -4.906767433e-02f, -9.987954562e-01f,
+    -1.836970199e-16f, -1.000000000e+00f, 4.906767433e-02f, -9.987954562e-01f,
+    9.801714033e-02f, -9.951847267e-01f, 1.467304745e-01f, -9.891765100e-01f,
+    1.950903220e-01f, -9.807852804e-01f, 2.429801799e-01f, -9.700312532e-01f,
+    2.902846773e-01f, -9.569403357e-01f, 3.368898534e-01f, -9.415440652e-01f,
+    3.826834324e-01f, -9.238795325e-01f, 4.275550934e-01f, -9.039892931e-01f,
+    4.713967368e-01f, -8.819212643e-01f, 5.141027442e-01f, -8.577286100e-01f,
+    5.555702330e-01f, -8.314696123e-01f, 5.956993045e-01f, -8.032075315e-01f,
+    6.343932842e-01f, -7.730104534e-01f, 6.715589548e-01f, -7.409511254e-01f,
+    7.071067812e-01f, -7.071067812e-01f, 7.409511254e-01f, -6.715589548e-01f,
+    7.730104534e-01f, -6.343932842e-01f, 8.032075315e-01f, -5.956993045e-01f,
+    8.314696123e-01f, -5.555702330e-01f, 8.577286100e-01f, -5.141027442e-01f,
+    8.819212643e-01f, -4.713967368e-01f, 9.039892931e-01f, -4.275550934e-01f,
+    9.238795325e-01f, -3.826834324e-01f, 9.415440652e-01f, -3.368898534e-01f,
+    9.569403357e-01f, -2.902846773e-01f, 9.700312532e-01f, -2.429801799e-01f,
+    9.807852804e-01f, -1.950903220e-01f, 9.891765100e-01f, -1.467304745e-01f,
+    9.951847267e-01f, -9.801714033e-02f, 9.987954562e-01f, -4.906767433e-02f,
+};
+
+const float32_t twiddleCoef_rfft_256[256] = {
+    0.000000000e+00f, 1.000000000e+00f, 2.454122852e-02f, 9.996988187e-01f,
+    4.906767433e-02f, 9.987954562e-01f, 7.356456360e-02f, 9.972904567e-01f,
+    9.801714033e-02f, 9.951847267e-01f, 1.224106752e-01f, 9.924795346e-01f,
+    1.467304745e-01f, 9.891765100e-01f, 1.709618888e-01f, 9.852776424e-01f,
+    1.950903220e-01f, 9.807852804e-01f, 2.191012402e-01f, 9.757021300e-01f,
+    2.429801799e-01f, 9.700312532e-01f, 2.667127575e-01f, 9.637760658e-01f,
+    2.902846773e-01f, 9.569403357e-01f, 3.136817404e-01f, 9.495281806e-01f,
+    3.368898534e-01f, 9.415440652e-01f, 3.598950365e-01f, 9.329927988e-01f,
+    3.826834324e-01f, 9.238795325e-01f, 4.052413140e-01f, 9.142097557e-01f,
+    4.275550934e-01f, 9.039892931e-01f, 4.496113297e-01f, 8.932243012e-01f,
+    4.713967368e-01f, 8.819212643e-01f, 4.928981922e-01f, 8.700869911e-01f,
+    5.141027442e-01f, 8.577286100e-01f, 5.349976199e-01f, 8.448535652e-01f,
+    5.555702330e-01f, 8.314696123e-01f, 5.758081914e-01f, 8.175848132e-01f,
+    5.956993045e-01f, 8.032075315e-01f, 6.152315906e-01f, 7.883464276e-01f,
+    6.343932842e-01f, 7.730104534e-01f, 6.531728430e-01f, 7.572088465e-01f,
+    6.715589548e-01f, 7.409511254e-01f, 6.895405447e-01f, 7.242470830e-01f,
+    7.071067812e-01f, 7.071067812e-01f, 7.242470830e-01f, 6.895405447e-01f,
+    7.409511254e-01f, 6.715589548e-01f, 7.572088465e-01f, 6.531728430e-01f,
+    7.730104534e-01f, 6.343932842e-01f, 7.883464276e-01f, 6.152315906e-01f,
+    8.032075315e-01f, 5.956993045e-01f, 8.175848132e-01f, 5.758081914e-01f,
+    8.314696123e-01f, 5.555702330e-01f, 8.448535652e-01f, 5.349976199e-01f,
+    8.577286100e-01f, 5.141027442e-01f, 8.700869911e-01f, 4.928981922e-01f,
+    8.819212643e-01f, 4.713967368e-01f, 8.932243012e-01f, 4.496113297e-01f,
+    9.039892931e-01f, 4.275550934e-01f, 9.142097557e-01f, 4.052413140e-01f,
+    9.238795325e-01f, 3.826834324e-01f, 9.329927988e-01f, 3.598950365e-01f,
+    9.415440652e-01f, 3.368898534e-01f, 9.495281806e-01f, 3.136817404e-01f,
+    9.569403357e-01f, 2.902846773e-01f, 9.637760658e-01f, 2.667127575e-01f,
+    9.700312532e-01f, 2.429801799e-01f, 9.757021300e-01f, 2.191012402e-01f,
+    9.807852804e-01f, 1.950903220e-01f, 9.852776424e-01f, 1.709618888e-01f,
+    9.891765100e-01f, 1.467304745e-01f, 9.924795346e-01f, 1.224106752e-01f,
+    9.951847267e-01f, 9.801714033e-02f, 9.972904567e-01f, 7.356456360e-02f,
+    9.987954562e-01f, 4.906767433e-02f, 9.996988187e-01f, 2.454122852e-02f,
+    1.000000000e+00f, 6.123233996e-17f, 9.996988187e-01f, -2.454122852e-02f,
+    9.987954562e-01f, -4.906767433e-02f, 9.972904567e-01f, -7.356456360e-02f,
+    9.951847267e-01f, -9.801714033e-02f, 9.924795346e-01f, -1.224106752e-01f,
+    9.891765100e-01f, -1.467304745e-01f, 9.852776424e-01f, -1.709618888e-01f,
+    9.807852804e-01f, -1.950903220e-01f, 9.757021300e-01f, -2.191012402e-01f,
+    9.700312532e-01f, -2.429801799e-01f, 9.637760658e-01f, -2.667127575e-01f,
+    9.569403357e-01f, -2.902846773e-01f, 9.495281806e-01f, -3.136817404e-01f,
+    9.415440652e-01f, -3.368898534e-01f, 9.329927988e-01f, -3.598950365e-01f,
+    9.238795325e-01f, -3.826834324e-01f, 9.142097557e-01f, -4.052413140e-01f,
+    9.039892931e-01f, -4.275550934e-01f, 8.932243012e-01f, -4.496113297e-01f,
+    8.819212643e-01f, -4.713967368e-01f, 8.700869911e-01f, -4.928981922e-01f,
+    8.577286100e-01f, -5.141027442e-01f, 8.448535652e-01f, -5.349976199e-01f,
+    8.314696123e-01f, -5.555702330e-01f, 8.175848132e-01f, -5.758081914e-01f,
+    8.032075315e-01f, -5.956993045e-01f, 7.883464276e-01f, -6.152315906e-01f,
+    7.730104534e-01f, -6.343932842e-01f, 7.572088465e-01f, -6.531728430e-01f,
+    7.409511254e-01f, -6.715589548e-01f, 7.242470830e-01f, -6.895405447e-01f,
+    7.071067812e-01f, -7.071067812e-01f, 6.895405447e-01f, -7.242470830e-01f,
+    6.715589548e-01f, -7.409511254e-01f, 6.531728430e-01f, -7.572088465e-01f,
+    6.343932842e-01f, -7.730104534e-01f, 6.152315906e-01f, -7.883464276e-01f,
+    5.956993045e-01f, -8.032075315e-01f, 5.758081914e-01f, -8.175848132e-01f,
+    5.555702330e-01f, -8.314696123e-01f, 5.349976199e-01f, -8.448535652e-01f,
+    5.141027442e-01f, -8.577286100e-01f, 4.928981922e-01f, -8.700869911e-01f,
+    4.713967368e-01f, -8.819212643e-01f, 4.496113297e-01f, -8.932243012e-01f,
+    4.275550934e-01f, -9.039892931e-01f, 4.052413140e-01f, -9.142097557e-01f,
+    3.826834324e-01f, -9.238795325e-01f, 3.598950365e-01f, -9.329927988e-01f,
+    3.368898534e-01f, -9.415440652e-01f, 3.136817404e-01f, -9.495281806e-01f,
+    2.902846773e-01f, -9.569403357e-01f, 2.667127575e-01f, -9.637760658e-01f,
+    2.429801799e-01f, -9.700312532e-01f, 2.191012402e-01f, -9.757021300e-01f,
+    1.950903220e-01f, -9.807852804e-01f, 1.709618888e-01f, -9.852776424e-01f,
+    1.467304745e-01f, -9.891765100e-01f, 1.224106752e-01f, -9.924795346e-01f,
+    9.801714033e-02f, -9.951847267e-01f, 7.356456360e-02f, -9.972904567e-01f,
+    4.906767433e-02f, -9.987954562e-01f, 2.454122852e-02f, -9.996988187e-01f,
+};
+
+const uint16_t armBitRevIndexTable128[ARMBITREVINDEXTABLE_128_TABLE_LENGTH] = {
+    8, 128, 8, 32, 8, 512, 16, 256,
+    16, 64, 24, 384, 24, 96, 24, 528,
+    24, 264, 24, 192, 24, 48, 24, 768,
+    24, 72, 24, 144, 24, 288, 24, 576,
+    40, 640, 56, 896, 56, 104, 56, 656,
+    56, 296, 56, 704, 80, 272, 80, 320,
+    88, 400, 88, 352, 88, 592, 88, 280,
+    88, 448, 88, 112, 88, 784, 88, 328,
+    88, 208, 88, 304, 88, 832, 120, 912,
+    120, 360, 120, 720, 120, 312, 120, 960,
+    136, 160, 136, 544, 136, 520, 152, 416,
+    152, 608, 152, 536, 152, 392, 152, 224,
+    152, 560, 152, 776, 152, 200, 152, 176,
+    152, 800, 152, 584, 168, 672, 168, 552,
+    168, 648, 184, 928, 184, 616, 184, 664,
+    184, 424, 184, 736, 184, 568, 184, 904,
+    184, 232, 184, 688, 184, 808, 184, 712,
+    216, 432, 216, 864, 216, 600, 216, 408,
+    216, 480, 216, 624, 216, 792, 216, 456,
+    216, 240, 216, 816, 216, 840, 248, 944,
+    248, 872, 248, 728, 248, 440, 248, 992,
+    248, 632, 248, 920, 248, 488, 248, 752,
+    248, 824, 248, 968, 344, 464, 344, 368,
+    344, 848, 376, 976, 472, 496, 472, 880,
+    472, 856, 504, 1008, 504, 888, 504, 984,
+    696, 936, 696, 744, 760, 952, 760, 1000,
+};
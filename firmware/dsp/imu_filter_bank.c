@@ -0,0 +1,291 @@
+#include "imu_filter_bank.h"
+#include "cycle_counter.h"
+#include <math.h>
+#include <string.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+#define FILTER_BANK_BUTTERWORTH_Q 0.70710678f
+
+/**
+ * @brief Store a normalized biquad in CMSIS order {b0, b1, b2, -a1, -a2}
+ */
+static void FilterBank_Store(float *c, float b0, float b1, float b2, float a0, float a1, float a2)
+{
+    float inv = 1.0f / a0;
+    c[0] = b0 * inv;
+    c[1] = b1 * inv;
+    c[2] = b2 * inv;
+    c[3] = -a1 * inv;
+    c[4] = -a2 * inv;
+}
+
+/**
+ * @brief RBJ cookbook 2nd order low-pass
+ */
+static void FilterBank_DesignLowPass(float *c, float fc, float fs)
+{
+    float w0 = 2.0f * PI * fc / fs;
+    float cw = cosf(w0);
+    float alpha = sinf(w0) / (2.0f * FILTER_BANK_BUTTERWORTH_Q);
+    FilterBank_Store(c, 0.5f * (1.0f - cw), 1.0f - cw, 0.5f * (1.0f - cw), 1.0f + alpha, -2.0f * cw, 1.0f - alpha);
+}
+
+/**
+ * @brief RBJ cookbook notch, or a pass-through section when f0 is 0
+ */
+static void FilterBank_DesignNotch(float *c, float f0, float q, float fs)
+{
+    if (f0 <= 0.0f)
+    {
+        FilterBank_Store(c, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f);
+        return;
+    }
+
+    float w0 = 2.0f * PI * f0 / fs;
+    float cw = cosf(w0);
+    float alpha = sinf(w0) / (2.0f * q);
+    FilterBank_Store(c, 1.0f, -2.0f * cw, 1.0f, 1.0f + alpha, -2.0f * cw, 1.0f - alpha);
+}
+
+/**
+ * @brief Write the notch sections of one coefficient buffer
+ */
+static void FilterBank_DesignNotches(FilterBank_t *bank, uint8_t buffer)
+{
+    const FilterBank_Config_t *cfg = &bank->config;
+    for (uint8_t n = 0; n < cfg->notchCount; n++)
+    {
+        uint32_t offset = (uint32_t)(cfg->lpfStages + n) * FILTER_BANK_COEFFS_PER_STAGE;
+        FilterBank_DesignNotch(&bank->coeffs[buffer][0][offset], bank->notchFreq_Hz[n], cfg->notchQ, cfg->sampleRate_Hz);
+        memcpy(&bank->coeffs[buffer][1][offset], &bank->coeffs[buffer][0][offset], FILTER_BANK_COEFFS_PER_STAGE * sizeof(float));
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+int FilterBank_Init(FilterBank_t *bank, const FilterBank_Config_t *cfg)
+{
+    if (!bank || !cfg || cfg->sampleRate_Hz <= 0.0f ||
+        cfg->lpfStages > FILTER_BANK_MAX_LPF_STAGES || cfg->notchCount > FILTER_BANK_MAX_NOTCHES)
+    {
+        return -1;
+    }
+    float nyquist = 0.5f * cfg->sampleRate_Hz;
+    if (cfg->lpfStages > 0 && (cfg->gyroLpfCutoff_Hz <= 0.0f || cfg->gyroLpfCutoff_Hz >= nyquist ||
+                               cfg->accelLpfCutoff_Hz <= 0.0f || cfg->accelLpfCutoff_Hz >= nyquist))
+    {
+        return -2;
+    }
+    if (cfg->notchCount > 0 && (cfg->notchQ <= 0.0f || cfg->notchMaxFreq_Hz >= nyquist))
+    {
+        return -3;
+    }
+
+    memset(bank, 0, sizeof(*bank));
+    bank->config = *cfg;
+
+    // Low-pass sections never change: design them once into both buffers
+    for (uint8_t buffer = 0; buffer < 2; buffer++)
+    {
+        for (uint8_t s = 0; s < cfg->lpfStages; s++)
+        {
+            uint32_t offset = (uint32_t)s * FILTER_BANK_COEFFS_PER_STAGE;
+            FilterBank_DesignLowPass(&bank->coeffs[buffer][0][offset], cfg->gyroLpfCutoff_Hz, cfg->sampleRate_Hz);
+            FilterBank_DesignLowPass(&bank->coeffs[buffer][1][offset], cfg->accelLpfCutoff_Hz, cfg->sampleRate_Hz);
+        }
+        FilterBank_DesignNotches(bank, buffer);
+    }
+
+    uint8_t stages = cfg->lpfStages + cfg->notchCount;
+    for (int i = 0; i < FILTER_BANK_AXES; i++)
+    {
+        float *coeffs = bank->coeffs[0][(i < VIBRATION_AXIS_ACCEL_X) ? 0 : 1];
+        arm_biquad_cascade_df2T_init_f32(&bank->axis[i], stages, coeffs, bank->state[i]);
+    }
+    bank->active = 0;
+
+    return 0;
+}
+
+void FilterBank_Process(FilterBank_t *bank, float32_t *const axes[FILTER_BANK_AXES], uint32_t count)
+{
+    if (bank->axis[0].numStages == 0 || count == 0)
+    {
+        return; // nothing configured: pass-through
+    }
+
+    uint32_t start = CycleCounter_Read();
+
+    for (int i = 0; i < FILTER_BANK_AXES; i++)
+    {
+        arm_biquad_cascade_df2T_f32(&bank->axis[i], axes[i], axes[i], count);
+    }
+
+    uint32_t cycles = CycleCounter_Read() - start;
+    bank->stats.lastCycles = cycles;
+    bank->stats.lastSamples = count;
+    if (cycles > bank->stats.maxCycles)
+    {
+        bank->stats.maxCycles = cycles;
+    }
+}
+
+float FilterBank_CyclesPerSampleAxis(const FilterBank_t *bank)
+{
+    if (!bank || bank->stats.lastSamples == 0)
+    {
+        return 0.0f;
+    }
+    return (float)bank->stats.lastCycles / (float)(bank->stats.lastSamples * FILTER_BANK_AXES);
+}
+
+void FilterBank_SetNotchTarget(FilterBank_t *bank, uint8_t index, float freq_Hz)
+{
+    if (!bank || index >= bank->config.notchCount)
+    {
+        return;
+    }
+    bank->notchTarget_Hz[index] = freq_Hz;
+}
+
+void FilterBank_TrackSpectrum(FilterBank_t *bank, const VibrationAnalyzer_Spectrum_t *spectrum)
+{
+    if (!bank || !spectrum || bank->config.notchCount == 0)
+    {
+        return;
+    }
+    const FilterBank_Config_t *cfg = &bank->config;
+
+    // 1) Gather gyro peaks, merging the same vibration seen on several axes
+    VibrationAnalyzer_Peak_t candidates[3 * VIBRATION_PEAKS];
+    int count = 0;
+    float mergeWidth = 2.0f * spectrum->resolution_Hz;
+    for (int a = VIBRATION_AXIS_GYRO_X; a <= VIBRATION_AXIS_GYRO_Z; a++)
+    {
+        for (int p = 0; p < VIBRATION_PEAKS; p++)
+        {
+            const VibrationAnalyzer_Peak_t *peak = &spectrum->peaks[a][p];
+            if (peak->amplitude < cfg->notchMinAmplitude ||
+                peak->freq_Hz < cfg->notchMinFreq_Hz || peak->freq_Hz > cfg->notchMaxFreq_Hz)
+            {
+                continue;
+            }
+
+            int merged = -1;
+            for (int c = 0; c < count; c++)
+            {
+                if (fabsf(candidates[c].freq_Hz - peak->freq_Hz) < mergeWidth)
+                {
+                    merged = c;
+                    break;
+                }
+            }
+            if (merged < 0)
+            {
+                candidates[count++] = *peak;
+            }
+            else if (peak->amplitude > candidates[merged].amplitude)
+            {
+                candidates[merged] = *peak;
+            }
+        }
+    }
+
+    // 2) Strongest first
+    for (int i = 1; i < count; i++)
+    {
+        VibrationAnalyzer_Peak_t key = candidates[i];
+        int j = i - 1;
+        while (j >= 0 && candidates[j].amplitude < key.amplitude)
+        {
+            candidates[j + 1] = candidates[j];
+            j--;
+        }
+        candidates[j + 1] = key;
+    }
+
+    // 3) Give each peak the nearest free notch; notches without a peak hold
+    //    their frequency so a vanishing peak does not cause a transient.
+    bool taken[FILTER_BANK_MAX_NOTCHES] = {false};
+    for (int c = 0; c < count && c < cfg->notchCount; c++)
+    {
+        int best = -1;
+        float bestDist = 0.0f;
+        for (int n = 0; n < cfg->notchCount; n++)
+        {
+            if (taken[n])
+            {
+                continue;
+            }
+            // Unused notches are the last choice so placed notches keep their peak
+            float ref = bank->notchTarget_Hz[n];
+            float dist = (ref > 0.0f) ? fabsf(ref - candidates[c].freq_Hz) : 1e9f;
+            if (best < 0 || dist < bestDist)
+            {
+                best = n;
+                bestDist = dist;
+            }
+        }
+        taken[best] = true;
+        bank->notchTarget_Hz[best] = candidates[c].freq_Hz;
+    }
+}
+
+void FilterBank_Retune(FilterBank_t *bank)
+{
+    if (!bank || bank->config.notchCount == 0)
+    {
+        return;
+    }
+    const FilterBank_Config_t *cfg = &bank->config;
+
+    bool changed = false;
+    for (uint8_t n = 0; n < cfg->notchCount; n++)
+    {
+        float target = bank->notchTarget_Hz[n];
+        float current = bank->notchFreq_Hz[n];
+        if (target == current)
+        {
+            continue;
+        }
+
+        if (current <= 0.0f || target <= 0.0f)
+        {
+            current = target; // first placement or disable
+        }
+        else if (target > current + cfg->notchMaxSlew_Hz)
+        {
+            current += cfg->notchMaxSlew_Hz;
+        }
+        else if (target < current - cfg->notchMaxSlew_Hz)
+        {
+            current -= cfg->notchMaxSlew_Hz;
+        }
+        else
+        {
+            current = target;
+        }
+        bank->notchFreq_Hz[n] = current;
+        changed = true;
+    }
+
+    if (!changed)
+    {
+        return;
+    }
+
+    // Build the inactive set, then swap pointers. Each store is atomic, so
+    // the hot path sees either the old or the new coefficients of an axis.
+    uint8_t next = bank->active ^ 1;
+    FilterBank_DesignNotches(bank, next);
+    for (int i = 0; i < FILTER_BANK_AXES; i++)
+    {
+        bank->axis[i].pCoeffs = bank->coeffs[next][(i < VIBRATION_AXIS_ACCEL_X) ? 0 : 1];
+    }
+    bank->active = next;
+}
@@ -0,0 +1,115 @@
+#ifndef IMU_FILTER_BANK_H
+#define IMU_FILTER_BANK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "arm_math.h"
+#include "vibration_analyzer.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define FILTER_BANK_AXES 6 // gyro x, y, z then accel x, y, z (VibrationAnalyzer_Axis order)
+#define FILTER_BANK_MAX_LPF_STAGES 2
+#define FILTER_BANK_MAX_NOTCHES 3
+#define FILTER_BANK_MAX_STAGES (FILTER_BANK_MAX_LPF_STAGES + FILTER_BANK_MAX_NOTCHES)
+#define FILTER_BANK_COEFFS_PER_STAGE 5 // b0, b1, b2, a1, a2 (CMSIS sign convention)
+
+    typedef struct
+    {
+        float sampleRate_Hz;       ///< IMU output data rate the bank runs at
+        uint8_t lpfStages;         ///< 2nd order Butterworth sections (0..FILTER_BANK_MAX_LPF_STAGES)
+        float gyroLpfCutoff_Hz;    ///< Low-pass cutoff on the gyro axes
+        float accelLpfCutoff_Hz;   ///< Low-pass cutoff on the accel axes
+        uint8_t notchCount;        ///< Dynamic notches (0..FILTER_BANK_MAX_NOTCHES), on all axes
+        float notchQ;              ///< Notch quality factor
+        float notchMinFreq_Hz;     ///< Tracked peaks outside [min, max] are ignored
+        float notchMaxFreq_Hz;
+        float notchMaxSlew_Hz;     ///< Largest centre move per FilterBank_Retune call
+        float notchMinAmplitude;   ///< Gyro peak amplitude (rad/s) needed to place a notch
+    } FilterBank_Config_t;
+
+    /**
+     * @brief Cost of the hot path, from the DWT cycle counter
+     */
+    typedef struct
+    {
+        uint32_t lastCycles;      ///< Cycles of the last FilterBank_Process call
+        uint32_t maxCycles;       ///< Worst FilterBank_Process call seen
+        uint32_t lastSamples;     ///< Samples per axis in the last call
+    } FilterBank_Stats_t;
+
+    typedef struct
+    {
+        FilterBank_Config_t config;
+
+        arm_biquad_cascade_df2T_instance_f32 axis[FILTER_BANK_AXES];
+
+        // Double-buffered coefficients [buffer][0 = gyro, 1 = accel]; the
+        // hot path only ever reads the active buffer.
+        float coeffs[2][2][FILTER_BANK_MAX_STAGES * FILTER_BANK_COEFFS_PER_STAGE];
+        float state[FILTER_BANK_AXES][FILTER_BANK_MAX_STAGES * 2];
+        volatile uint8_t active;
+
+        float notchFreq_Hz[FILTER_BANK_MAX_NOTCHES];   ///< Current centre (0 = bypassed)
+        float notchTarget_Hz[FILTER_BANK_MAX_NOTCHES]; ///< Tracker target (0 = none)
+
+        FilterBank_Stats_t stats;
+    } FilterBank_t;
+
+    /**
+     * @brief Design the initial coefficients and clear the filter state
+     * @param[out] bank Pointer to filter bank
+     * @param[in]  cfg  Pointer to configuration
+     * @retval  0 on success, negative on error
+     */
+    int FilterBank_Init(FilterBank_t *bank, const FilterBank_Config_t *cfg);
+
+    /**
+     * @brief Filter a block of samples in place (hot path, full ODR)
+     *        No coefficient math here: only the active coefficient set is read.
+     * @param[in,out] bank  Pointer to filter bank
+     * @param[in,out] axes  One pointer per axis to `count` contiguous samples
+     * @param[in]     count Samples per axis
+     */
+    void FilterBank_Process(FilterBank_t *bank, float32_t *const axes[FILTER_BANK_AXES], uint32_t count);
+
+    /**
+     * @brief Cost of the last FilterBank_Process call per sample and axis
+     *        Divides here, at read time, so the hot path only stores counts.
+     * @param[in] bank Pointer to filter bank
+     * @return lastCycles / (lastSamples * FILTER_BANK_AXES), 0 before the first call
+     */
+    float FilterBank_CyclesPerSampleAxis(const FilterBank_t *bank);
+
+    /**
+     * @brief Set a notch target directly (0 disables once the notch has slewed)
+     * @param[in,out] bank    Pointer to filter bank
+     * @param[in]     index   Notch index
+     * @param[in]     freq_Hz Target centre frequency
+     */
+    void FilterBank_SetNotchTarget(FilterBank_t *bank, uint8_t index, float freq_Hz);
+
+    /**
+     * @brief Frequency tracker: place notch targets on the strongest gyro peaks
+     *        Peaks are matched to the nearest existing notch so notches do not swap.
+     * @param[in,out] bank     Pointer to filter bank
+     * @param[in]     spectrum Spectrum published by the vibration analyzer
+     */
+    void FilterBank_TrackSpectrum(FilterBank_t *bank, const VibrationAnalyzer_Spectrum_t *spectrum);
+
+    /**
+     * @brief Slew notches toward their targets and publish new coefficients
+     *        Background context. The new set is built in the inactive buffer and
+     *        swapped in with single pointer stores between samples.
+     * @param[in,out] bank Pointer to filter bank
+     */
+    void FilterBank_Retune(FilterBank_t *bank);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // IMU_FILTER_BANK_H
@@ -0,0 +1,211 @@
+#include "vibration_analyzer.h"
+#include <math.h>
+#include <string.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL DEFINITIONS                                                       */
+/*----------------------------------------------------------------------------*/
+
+enum VibrationAnalyzer_Stage
+{
+    VIBRATION_STAGE_CAPTURE = 0, ///< Waiting for the capture window to fill
+    VIBRATION_STAGE_FFT,         ///< Window + real FFT of the current axis
+    VIBRATION_STAGE_PEAKS,       ///< Power spectrum + peak search of the current axis
+};
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @brief Insert a peak into a list kept sorted by descending amplitude
+ */
+static void VibrationAnalyzer_InsertPeak(VibrationAnalyzer_Peak_t peaks[VIBRATION_PEAKS], float freq, float amplitude)
+{
+    int pos = VIBRATION_PEAKS;
+    while (pos > 0 && peaks[pos - 1].amplitude < amplitude)
+    {
+        pos--;
+    }
+    if (pos >= VIBRATION_PEAKS)
+    {
+        return;
+    }
+
+    for (int i = VIBRATION_PEAKS - 1; i > pos; i--)
+    {
+        peaks[i] = peaks[i - 1];
+    }
+    peaks[pos].freq_Hz = freq;
+    peaks[pos].amplitude = amplitude;
+}
+
+/**
+ * @brief Window the captured axis and run the real FFT
+ */
+static void VibrationAnalyzer_RunFft(VibrationAnalyzer_t *va)
+{
+    const int16_t *src = va->capture[va->axis];
+    float scale = (va->axis < VIBRATION_AXIS_ACCEL_X) ? va->config.gyroScale : va->config.accelScale;
+
+    // Remove the mean so DC leakage does not mask low vibration peaks
+    int32_t sum = 0;
+    for (int i = 0; i < VIBRATION_FFT_SIZE; i++)
+    {
+        sum += src[i];
+    }
+    float mean = (float)sum * (1.0f / VIBRATION_FFT_SIZE);
+
+    for (int i = 0; i < VIBRATION_FFT_SIZE; i++)
+    {
+        va->fftIn[i] = ((float)src[i] - mean) * scale * va->window[i];
+    }
+
+    arm_rfft_fast_f32(&va->fft, va->fftIn, va->fftOut, 0);
+}
+
+/**
+ * @brief Find the strongest local maxima of the current axis spectrum
+ */
+static void VibrationAnalyzer_FindPeaks(VibrationAnalyzer_t *va)
+{
+    const int bins = VIBRATION_FFT_SIZE / 2;
+    VibrationAnalyzer_Peak_t *peaks = va->pending.peaks[va->axis];
+    memset(peaks, 0, sizeof(va->pending.peaks[0]));
+
+    // power[0] mixes the packed DC and Nyquist terms; minBin >= 2 keeps the search off it
+    arm_cmplx_mag_squared_f32(va->fftOut, va->power, bins);
+
+    float resolution = va->pending.resolution_Hz;
+    int minBin = (int)(va->config.minFreq_Hz / resolution) + 1;
+    if (minBin < 2)
+    {
+        minBin = 2;
+    }
+
+    for (int k = minBin; k < bins - 1; k++)
+    {
+        float p = va->power[k];
+        if (p <= va->power[k - 1] || p < va->power[k + 1])
+        {
+            continue;
+        }
+
+        // Parabolic interpolation on magnitudes of the three bins around the peak
+        float m0 = sqrtf(va->power[k - 1]);
+        float m1 = sqrtf(p);
+        float m2 = sqrtf(va->power[k + 1]);
+        float denom = m0 - 2.0f * m1 + m2;
+        float delta = (denom != 0.0f) ? 0.5f * (m0 - m2) / denom : 0.0f;
+        float amplitude = (m1 - 0.25f * (m0 - m2) * delta) * va->amplitudeGain;
+
+        VibrationAnalyzer_InsertPeak(peaks, ((float)k + delta) * resolution, amplitude);
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+int VibrationAnalyzer_Init(VibrationAnalyzer_t *va, const VibrationAnalyzer_Config_t *cfg)
+{
+    if (!va || !cfg || cfg->sampleRate_Hz <= 0.0f || cfg->decimation == 0)
+    {
+        return -1;
+    }
+
+    memset(va, 0, sizeof(*va));
+    va->config = *cfg;
+
+    if (arm_rfft_fast_init_f32(&va->fft, VIBRATION_FFT_SIZE) != ARM_MATH_SUCCESS)
+    {
+        return -2;
+    }
+
+    // Hann window, computed once
+    float windowSum = 0.0f;
+    for (int i = 0; i < VIBRATION_FFT_SIZE; i++)
+    {
+        va->window[i] = 0.5f - 0.5f * cosf(2.0f * PI * (float)i / (float)VIBRATION_FFT_SIZE);
+        windowSum += va->window[i];
+    }
+    va->amplitudeGain = 2.0f / windowSum;
+
+    va->pending.resolution_Hz = cfg->sampleRate_Hz / (float)cfg->decimation / (float)VIBRATION_FFT_SIZE;
+    va->published.resolution_Hz = va->pending.resolution_Hz;
+    va->stage = VIBRATION_STAGE_CAPTURE;
+
+    return 0;
+}
+
+void VibrationAnalyzer_PushSample(VibrationAnalyzer_t *va, const LSM6DSO32_GyroRaw_t *gyro, const LSM6DSO32_AccelRaw_t *accel)
+{
+    if (va->stage != VIBRATION_STAGE_CAPTURE || va->fill >= VIBRATION_FFT_SIZE)
+    {
+        return;
+    }
+
+    if (++va->decimCount < va->config.decimation)
+    {
+        return;
+    }
+    va->decimCount = 0;
+
+    uint16_t i = va->fill;
+    va->capture[VIBRATION_AXIS_GYRO_X][i] = gyro->x;
+    va->capture[VIBRATION_AXIS_GYRO_Y][i] = gyro->y;
+    va->capture[VIBRATION_AXIS_GYRO_Z][i] = gyro->z;
+    va->capture[VIBRATION_AXIS_ACCEL_X][i] = accel->x;
+    va->capture[VIBRATION_AXIS_ACCEL_Y][i] = accel->y;
+    va->capture[VIBRATION_AXIS_ACCEL_Z][i] = accel->z;
+    va->fill = i + 1;
+}
+
+bool VibrationAnalyzer_Step(VibrationAnalyzer_t *va)
+{
+    if (!va)
+    {
+        return false;
+    }
+
+    switch (va->stage)
+    {
+    case VIBRATION_STAGE_CAPTURE:
+        if (va->fill >= VIBRATION_FFT_SIZE)
+        {
+            // Window complete: capture is frozen until all axes are analyzed
+            va->axis = 0;
+            va->stage = VIBRATION_STAGE_FFT;
+        }
+        return false;
+
+    case VIBRATION_STAGE_FFT:
+        VibrationAnalyzer_RunFft(va);
+        va->stage = VIBRATION_STAGE_PEAKS;
+        return false;
+
+    case VIBRATION_STAGE_PEAKS:
+        VibrationAnalyzer_FindPeaks(va);
+        if (++va->axis < VIBRATION_AXIS_COUNT)
+        {
+            va->stage = VIBRATION_STAGE_FFT;
+            return false;
+        }
+
+        va->pending.sequence = va->published.sequence + 1;
+        va->published = va->pending;
+        va->fill = 0;
+        va->decimCount = 0;
+        va->stage = VIBRATION_STAGE_CAPTURE;
+        return true;
+
+    default:
+        va->stage = VIBRATION_STAGE_CAPTURE;
+        return false;
+    }
+}
+
+const VibrationAnalyzer_Spectrum_t *VibrationAnalyzer_GetSpectrum(const VibrationAnalyzer_t *va)
+{
+    return &va->published;
+}
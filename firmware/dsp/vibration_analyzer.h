@@ -0,0 +1,118 @@
+#ifndef VIBRATION_ANALYZER_H
+#define VIBRATION_ANALYZER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "arm_math.h"
+#include "lsm6dso32.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define VIBRATION_FFT_SIZE 256 // must have its tables enabled in CMakeLists.txt
+#define VIBRATION_PEAKS 3      // peaks tracked per axis
+
+    /**
+     * @brief Analyzed channels, in capture order
+     */
+    enum VibrationAnalyzer_Axis
+    {
+        VIBRATION_AXIS_GYRO_X = 0,
+        VIBRATION_AXIS_GYRO_Y,
+        VIBRATION_AXIS_GYRO_Z,
+        VIBRATION_AXIS_ACCEL_X,
+        VIBRATION_AXIS_ACCEL_Y,
+        VIBRATION_AXIS_ACCEL_Z,
+        VIBRATION_AXIS_COUNT,
+    };
+
+    typedef struct
+    {
+        float sampleRate_Hz; ///< Rate at which VibrationAnalyzer_PushSample is called
+        uint16_t decimation; ///< Keep one sample out of N (1 = full rate)
+        float gyroScale;     ///< Raw LSB -> rad/s
+        float accelScale;    ///< Raw LSB -> m/s^2
+        float minFreq_Hz;    ///< Peaks below this are ignored (drift, attitude motion)
+    } VibrationAnalyzer_Config_t;
+
+    typedef struct
+    {
+        float freq_Hz;   ///< Interpolated peak frequency
+        float amplitude; ///< Sine amplitude in rad/s or m/s^2
+    } VibrationAnalyzer_Peak_t;
+
+    /**
+     * @brief Published result, strongest peak first. Zero amplitude means no peak.
+     */
+    typedef struct
+    {
+        uint32_t sequence;  ///< Incremented on every completed analysis
+        float resolution_Hz; ///< FFT bin width
+        VibrationAnalyzer_Peak_t peaks[VIBRATION_AXIS_COUNT][VIBRATION_PEAKS];
+    } VibrationAnalyzer_Spectrum_t;
+
+    /**
+     * @brief Analyzer state. Large (~7 KB): give it static storage.
+     */
+    typedef struct
+    {
+        VibrationAnalyzer_Config_t config;
+        arm_rfft_fast_instance_f32 fft;
+
+        int16_t capture[VIBRATION_AXIS_COUNT][VIBRATION_FFT_SIZE]; ///< Raw samples, one row per axis
+        uint16_t fill;        ///< Samples captured so far
+        uint16_t decimCount;  ///< Decimation phase
+
+        float window[VIBRATION_FFT_SIZE];   ///< Hann window
+        float amplitudeGain;                ///< 2 / sum(window), single-sided amplitude
+        float fftIn[VIBRATION_FFT_SIZE];    ///< Windowed input (overwritten by the FFT)
+        float fftOut[VIBRATION_FFT_SIZE];   ///< Packed complex spectrum
+        float power[VIBRATION_FFT_SIZE / 2]; ///< Squared magnitudes
+
+        uint8_t stage; ///< Next processing stage
+        uint8_t axis;  ///< Axis being processed
+
+        VibrationAnalyzer_Spectrum_t pending;   ///< Being filled by the running analysis
+        VibrationAnalyzer_Spectrum_t published; ///< Last complete analysis
+    } VibrationAnalyzer_t;
+
+    /**
+     * @brief Initialize the analyzer and its FFT instance
+     * @param[out] va  Pointer to analyzer state
+     * @param[in]  cfg Pointer to configuration
+     * @retval  0 on success, negative on error
+     */
+    int VibrationAnalyzer_Init(VibrationAnalyzer_t *va, const VibrationAnalyzer_Config_t *cfg);
+
+    /**
+     * @brief Capture one raw IMU sample. O(1), safe to call from the sensing path.
+     *        Samples are ignored while a captured window is being analyzed.
+     * @param[in,out] va    Pointer to analyzer state
+     * @param[in]     gyro  Raw gyro sample
+     * @param[in]     accel Raw accel sample
+     */
+    void VibrationAnalyzer_PushSample(VibrationAnalyzer_t *va, const LSM6DSO32_GyroRaw_t *gyro, const LSM6DSO32_AccelRaw_t *accel);
+
+    /**
+     * @brief Run one bounded slice of analysis. Call from a background slot.
+     *        Each call does at most one windowed 256 point real FFT or one peak
+     *        search, so a full analysis takes 2 * VIBRATION_AXIS_COUNT calls.
+     * @param[in,out] va Pointer to analyzer state
+     * @return true when this call published a new spectrum
+     */
+    bool VibrationAnalyzer_Step(VibrationAnalyzer_t *va);
+
+    /**
+     * @brief Last published spectrum
+     * @param[in] va Pointer to analyzer state
+     * @return Pointer to the published result (valid until the next publish)
+     */
+    const VibrationAnalyzer_Spectrum_t *VibrationAnalyzer_GetSpectrum(const VibrationAnalyzer_t *va);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VIBRATION_ANALYZER_H
@@ -0,0 +1,142 @@
+#include "altitude_estimator.h"
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL DATA                                                              */
+/*----------------------------------------------------------------------------*/
+
+#define ALTITUDE_LUT_INV_STEP (1.0f / ALTITUDE_LUT_STEP_HPA)
+
+/**
+ * @brief ISA altitude in meters at ALTITUDE_LUT_P_MIN_HPA + i * ALTITUDE_LUT_STEP_HPA
+ */
+static const float s_altitudeLut[ALTITUDE_LUT_SIZE] = {
+    9163.947f, 9025.713f, 8889.746f, 8755.962f, 8624.287f, 8494.645f,
+    8366.970f, 8241.195f, 8117.259f, 7995.102f, 7874.667f, 7755.903f,
+    7638.758f, 7523.183f, 7409.132f, 7296.561f, 7185.428f, 7075.693f,
+    6967.315f, 6860.260f, 6754.490f, 6649.973f, 6546.675f, 6444.565f,
+    6343.613f, 6243.790f, 6145.069f, 6047.421f, 5950.823f, 5855.248f,
+    5760.673f, 5667.075f, 5574.431f, 5482.720f, 5391.922f, 5302.016f,
+    5212.982f, 5124.803f, 5037.460f, 4950.935f, 4865.212f, 4780.275f,
+    4696.106f, 4612.692f, 4530.016f, 4448.065f, 4366.824f, 4286.280f,
+    4206.420f, 4127.231f, 4048.700f, 3970.815f, 3893.564f, 3816.937f,
+    3740.922f, 3665.507f, 3590.683f, 3516.440f, 3442.766f, 3369.654f,
+    3297.093f, 3225.073f, 3153.587f, 3082.625f, 3012.179f, 2942.240f,
+    2872.801f, 2803.853f, 2735.389f, 2667.401f, 2599.882f, 2532.825f,
+    2466.223f, 2400.069f, 2334.355f, 2269.077f, 2204.227f, 2139.799f,
+    2075.787f, 2012.185f, 1948.987f, 1886.188f, 1823.781f, 1761.763f,
+    1700.126f, 1638.866f, 1577.979f, 1517.458f, 1457.299f, 1397.497f,
+    1338.047f, 1278.946f, 1220.187f, 1161.768f, 1103.683f, 1045.928f,
+    988.500f, 931.393f, 874.604f, 818.130f, 761.966f, 706.108f,
+    650.553f, 595.297f, 540.337f, 485.668f, 431.289f, 377.194f,
+    323.381f, 269.847f, 216.588f, 163.602f, 110.884f, 58.433f,
+    6.245f, -45.683f, -97.353f, -148.770f, -199.934f, -250.849f,
+    -301.518f, -351.944f, -402.128f, -452.074f, -501.784f, -551.261f,
+    -600.506f, -649.523f, -698.314f,
+};
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+int AltitudeEstimator_Init(AltitudeEstimator_t *est, const AltitudeEstimator_Config_t *cfg)
+{
+    if (!est || !cfg || cfg->timeConstant_s <= 0.0f)
+    {
+        return -1;
+    }
+
+    est->config = *cfg;
+
+    // Gains of a critically damped third-order loop, computed once here so
+    // that the per-sample paths only multiply.
+    float invTau = 1.0f / cfg->timeConstant_s;
+    est->k1 = 3.0f * invTau;
+    est->k2 = 3.0f * invTau * invTau;
+    est->k3 = invTau * invTau * invTau;
+
+    est->refAltitude_m = 0.0f;
+    est->altitude_m = 0.0f;
+    est->climbRate_mps = 0.0f;
+    est->accelBias_mps2 = 0.0f;
+    est->baroAltitude_m = 0.0f;
+    est->hasReference = false;
+
+    return 0;
+}
+
+float AltitudeEstimator_PressureToAltitude(float pressure_hPa)
+{
+    float pos = (pressure_hPa - ALTITUDE_LUT_P_MIN_HPA) * ALTITUDE_LUT_INV_STEP;
+    if (pos <= 0.0f)
+    {
+        return s_altitudeLut[0];
+    }
+    if (pos >= (float)(ALTITUDE_LUT_SIZE - 1))
+    {
+        return s_altitudeLut[ALTITUDE_LUT_SIZE - 1];
+    }
+
+    int idx = (int)pos;
+    float frac = pos - (float)idx;
+    float h0 = s_altitudeLut[idx];
+    return h0 + (s_altitudeLut[idx + 1] - h0) * frac;
+}
+
+void AltitudeEstimator_SetReference(AltitudeEstimator_t *est, float pressure_hPa)
+{
+    if (!est)
+    {
+        return;
+    }
+
+    est->refAltitude_m = AltitudeEstimator_PressureToAltitude(pressure_hPa);
+    est->altitude_m = 0.0f;
+    est->climbRate_mps = 0.0f;
+    est->baroAltitude_m = 0.0f;
+    est->hasReference = true;
+}
+
+void AltitudeEstimator_Predict(AltitudeEstimator_t *est, float accelUp_mps2, float dt_s)
+{
+    if (!est || !est->hasReference)
+    {
+        return;
+    }
+
+    float accel = accelUp_mps2 - est->accelBias_mps2;
+    est->altitude_m += (est->climbRate_mps + 0.5f * accel * dt_s) * dt_s;
+    est->climbRate_mps += accel * dt_s;
+}
+
+void AltitudeEstimator_UpdateBaro(AltitudeEstimator_t *est, float pressure_hPa, float dt_s)
+{
+    if (!est)
+    {
+        return;
+    }
+
+    if (!est->hasReference)
+    {
+        AltitudeEstimator_SetReference(est, pressure_hPa);
+        return;
+    }
+
+    est->baroAltitude_m = AltitudeEstimator_PressureToAltitude(pressure_hPa) - est->refAltitude_m;
+
+    // Baro corrects the low-frequency part; the accel integration in
+    // AltitudeEstimator_Predict carries everything between samples.
+    float err = est->baroAltitude_m - est->altitude_m;
+    est->altitude_m += est->k1 * err * dt_s;
+    est->climbRate_mps += est->k2 * err * dt_s;
+    est->accelBias_mps2 -= est->k3 * err * dt_s;
+}
+
+float AltitudeEstimator_VerticalAccel(const float q[4], const float accel_mps2[3])
+{
+    // Third row of the body->earth rotation matrix
+    float r20 = 2.0f * (q[1] * q[3] - q[0] * q[2]);
+    float r21 = 2.0f * (q[2] * q[3] + q[0] * q[1]);
+    float r22 = 1.0f - 2.0f * (q[1] * q[1] + q[2] * q[2]);
+
+    return r20 * accel_mps2[0] + r21 * accel_mps2[1] + r22 * accel_mps2[2] - ALTITUDE_GRAVITY_MPS2;
+}
@@ -0,0 +1,108 @@
+#ifndef ALTITUDE_ESTIMATOR_H
+#define ALTITUDE_ESTIMATOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*----------------------------------------------------------------------------*/
+/* PRESSURE -> ALTITUDE LOOKUP TABLE                                          */
+/*----------------------------------------------------------------------------*/
+/*
+ * ISA altitude h(p) = 44330.77 * (1 - (p / 1013.25)^0.190263) is tabulated
+ * every 6.25 hPa from 300 hPa to 1100 hPa (129 entries) and linearly
+ * interpolated. Worst-case interpolation error against the formula is
+ * 0.29 m at 300 hPa and below 0.07 m anywhere above 700 hPa, which is
+ * under the LPS22HB noise floor (~0.01 hPa RMS ~= 8 cm).
+ */
+#define ALTITUDE_LUT_P_MIN_HPA 300.0f
+#define ALTITUDE_LUT_P_MAX_HPA 1100.0f
+#define ALTITUDE_LUT_STEP_HPA 6.25f
+#define ALTITUDE_LUT_SIZE 129
+
+#define ALTITUDE_GRAVITY_MPS2 9.80665f
+
+    /**
+     * @brief Tuning of the baro / accel complementary filter.
+     */
+    typedef struct
+    {
+        float timeConstant_s; ///< Crossover time constant: baro trusted below 1/tau, accel above
+    } AltitudeEstimator_Config_t;
+
+    /**
+     * @brief Third-order complementary filter state (altitude, climb rate, accel bias).
+     */
+    typedef struct
+    {
+        AltitudeEstimator_Config_t config; ///< Filter configuration
+
+        float k1; ///< Altitude correction gain (3 / tau)
+        float k2; ///< Velocity correction gain (3 / tau^2)
+        float k3; ///< Accel bias correction gain (1 / tau^3)
+
+        float refAltitude_m;   ///< ISA altitude of the ground reference pressure
+        float altitude_m;      ///< Estimated altitude above reference
+        float climbRate_mps;   ///< Estimated vertical velocity (up positive)
+        float accelBias_mps2;  ///< Estimated vertical accelerometer bias
+        float baroAltitude_m;  ///< Last raw baro altitude above reference
+        bool hasReference;     ///< Reference pressure has been captured
+    } AltitudeEstimator_t;
+
+    /**
+     * @brief Initialize the estimator and precompute filter gains
+     * @param[out] est Pointer to estimator state
+     * @param[in]  cfg Pointer to filter configuration
+     * @retval  0 on success, negative on error
+     */
+    int AltitudeEstimator_Init(AltitudeEstimator_t *est, const AltitudeEstimator_Config_t *cfg);
+
+    /**
+     * @brief Convert pressure to ISA altitude without powf (LUT + linear interpolation)
+     * @param[in] pressure_hPa Static pressure in hPa, clamped to the LUT range
+     * @return ISA altitude in meters
+     */
+    float AltitudeEstimator_PressureToAltitude(float pressure_hPa);
+
+    /**
+     * @brief Capture the ground reference and reset the filter on it
+     * @param[in,out] est          Pointer to estimator state
+     * @param[in]     pressure_hPa Ground pressure in hPa
+     */
+    void AltitudeEstimator_SetReference(AltitudeEstimator_t *est, float pressure_hPa);
+
+    /**
+     * @brief Propagate altitude and climb rate with vertical acceleration
+     *        Call at IMU rate, between baro samples.
+     * @param[in,out] est          Pointer to estimator state
+     * @param[in]     accelUp_mps2 Gravity-compensated vertical acceleration (up positive)
+     * @param[in]     dt_s         Time since last prediction in seconds
+     */
+    void AltitudeEstimator_Predict(AltitudeEstimator_t *est, float accelUp_mps2, float dt_s);
+
+    /**
+     * @brief Correct the estimate with a new baro sample
+     *        The first sample captures the ground reference if none is set.
+     * @param[in,out] est          Pointer to estimator state
+     * @param[in]     pressure_hPa Pressure in hPa
+     * @param[in]     dt_s         Time since last baro sample in seconds
+     */
+    void AltitudeEstimator_UpdateBaro(AltitudeEstimator_t *est, float pressure_hPa, float dt_s);
+
+    /**
+     * @brief Rotate a body-frame specific force to earth-up and remove gravity
+     * @param[in] q         Attitude quaternion body->earth {w, x, y, z}, earth z up
+     * @param[in] accel_mps2 Accelerometer reading in m/s^2 (body frame)
+     * @return Vertical acceleration in m/s^2, up positive
+     */
+    float AltitudeEstimator_VerticalAccel(const float q[4], const float accel_mps2[3]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ALTITUDE_ESTIMATOR_H
@@ -0,0 +1,75 @@
+#include "attitude_estimator.h"
+#include <math.h>
+#include <string.h>
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+int AttitudeEstimator_Init(AttitudeEstimator_t *est, const AttitudeEstimator_Config_t *cfg)
+{
+    if (!est || !cfg || cfg->accelGain < 0.0f)
+    {
+        return -1;
+    }
+
+    memset(est, 0, sizeof(*est));
+    est->config = *cfg;
+    est->q[0] = 1.0f;
+
+    return 0;
+}
+
+void AttitudeEstimator_Update(AttitudeEstimator_t *est, const ImuPreint_Delta_t *delta)
+{
+    if (delta->samples == 0 || delta->dt_s <= 0.0f)
+    {
+        return;
+    }
+
+    float *q = est->q;
+    float rv[3] = {delta->dAngle_rad[0], delta->dAngle_rad[1], delta->dAngle_rad[2]};
+
+    // Correct only near 1 g, where the mean specific force is mostly gravity
+    float inv_dt = 1.0f / delta->dt_s;
+    float a[3] = {delta->dVel_mps[0] * inv_dt, delta->dVel_mps[1] * inv_dt, delta->dVel_mps[2] * inv_dt};
+    float norm = sqrtf(a[0] * a[0] + a[1] * a[1] + a[2] * a[2]);
+    est->accelUsed = norm > 0.5f * ATTITUDE_GRAVITY_MPS2 && norm < 1.5f * ATTITUDE_GRAVITY_MPS2;
+    if (est->accelUsed)
+    {
+        float ax = a[0] / norm, ay = a[1] / norm, az = a[2] / norm;
+        // Up in body axes, third row of R(q)
+        float vx = 2.0f * (q[1] * q[3] - q[0] * q[2]);
+        float vy = 2.0f * (q[2] * q[3] + q[0] * q[1]);
+        float vz = 1.0f - 2.0f * (q[1] * q[1] + q[2] * q[2]);
+        float k = est->config.accelGain * delta->dt_s;
+        rv[0] += k * (ay * vz - az * vy);
+        rv[1] += k * (az * vx - ax * vz);
+        rv[2] += k * (ax * vy - ay * vx);
+    }
+
+    float hx = 0.5f * rv[0];
+    float hy = 0.5f * rv[1];
+    float hz = 0.5f * rv[2];
+    float qw = q[0], qx = q[1], qy = q[2], qz = q[3];
+    q[0] = qw - qx * hx - qy * hy - qz * hz;
+    q[1] = qx + qw * hx + qy * hz - qz * hy;
+    q[2] = qy + qw * hy + qz * hx - qx * hz;
+    q[3] = qz + qw * hz + qx * hy - qy * hx;
+    float inv = 1.0f / sqrtf(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+    for (int k = 0; k < 4; k++)
+    {
+        q[k] *= inv;
+    }
+}
+
+void AttitudeEstimator_RollPitch(const AttitudeEstimator_t *est, float attitude_rad[2])
+{
+    const float *q = est->q;
+    float s = 2.0f * (q[0] * q[2] - q[3] * q[1]);
+    s = s > 1.0f ? 1.0f : (s < -1.0f ? -1.0f : s);
+
+    // z-y-x angles about x fwd, y left, z up; pitch flips to nose up
+    attitude_rad[0] = atan2f(2.0f * (q[0] * q[1] + q[2] * q[3]), 1.0f - 2.0f * (q[1] * q[1] + q[2] * q[2]));
+    attitude_rad[1] = -asinf(s);
+}
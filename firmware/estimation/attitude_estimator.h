@@ -0,0 +1,64 @@
+#ifndef ATTITUDE_ESTIMATOR_H
+#define ATTITUDE_ESTIMATOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "imu_preintegration.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Roll/pitch attitude from preintegrated IMU increments: the coning
+ * compensated rotation of each control tick is applied to the quaternion,
+ * and a proportional correction turns it toward the tilt of the mean
+ * specific force whenever that is close to 1 g (Mahony without the
+ * integral term). Yaw is gyro only: there is no heading reference yet.
+ *
+ * Sensor axes are x forward, y left, z up; the quaternion rotates body to
+ * world. One ImuPreint_Take per control tick feeds one update, whatever the
+ * number of samples in it.
+ */
+#define ATTITUDE_GRAVITY_MPS2 9.80665f
+
+    typedef struct
+    {
+        float accelGain; ///< Accel correction, rad/s per rad of tilt error
+    } AttitudeEstimator_Config_t;
+
+    typedef struct
+    {
+        AttitudeEstimator_Config_t config;
+        float q[4];            ///< Body -> world, w x y z
+        bool accelUsed;        ///< The last update applied the accel correction
+    } AttitudeEstimator_t;
+
+    /**
+     * @brief Start level, facing the initial heading
+     * @param[out] est Pointer to estimator state
+     * @param[in]  cfg Pointer to configuration
+     * @retval  0 on success, negative on error
+     */
+    int AttitudeEstimator_Init(AttitudeEstimator_t *est, const AttitudeEstimator_Config_t *cfg);
+
+    /**
+     * @brief Advance over one control tick
+     * @param[in,out] est   Pointer to estimator state
+     * @param[in]     delta Increments from ImuPreint_Take; ignored when it holds no sample
+     */
+    void AttitudeEstimator_Update(AttitudeEstimator_t *est, const ImuPreint_Delta_t *delta);
+
+    /**
+     * @brief Roll and pitch in controller axes (roll right, pitch nose up), rad
+     * @param[in]  est          Pointer to estimator state
+     * @param[out] attitude_rad Roll, pitch
+     */
+    void AttitudeEstimator_RollPitch(const AttitudeEstimator_t *est, float attitude_rad[2]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ATTITUDE_ESTIMATOR_H
@@ -0,0 +1,158 @@
+#include "imu_preintegration.h"
+#include <string.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL DEFINITIONS                                                       */
+/*----------------------------------------------------------------------------*/
+
+#define IMU_PREINT_GYRO_SCALE (LSM6DSO32_GYRO_SENS_2000DPS_MDPS * 1e-3f * 0.017453293f) // LSB -> rad/s
+#define IMU_PREINT_ACCEL_SCALE (LSM6DSO32_ACCEL_SENS_8G_MG * 1e-3f * 9.80665f)        // LSB -> m/s^2
+
+#define IMU_PREINT_HAVE_GYRO 0x01
+#define IMU_PREINT_HAVE_ACCEL 0x02
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @brief out += k * (a x b)
+ */
+static inline void ImuPreint_CrossAcc(float out[3], const float a[3], const float b[3], float k)
+{
+    out[0] += k * (a[1] * b[2] - a[2] * b[1]);
+    out[1] += k * (a[2] * b[0] - a[0] * b[2]);
+    out[2] += k * (a[0] * b[1] - a[1] * b[0]);
+}
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+int ImuPreint_Init(ImuPreint_t *pi, const ImuPreint_Config_t *cfg)
+{
+    if (!pi || !cfg || cfg->sampleRate_Hz <= 0.0f)
+    {
+        return -1;
+    }
+
+    memset(pi, 0, sizeof(*pi));
+    pi->config = *cfg;
+    pi->dt_s = 1.0f / cfg->sampleRate_Hz;
+
+    return 0;
+}
+
+void ImuPreint_AddSample(ImuPreint_t *pi, const float gyro_rads[3], const float accel_mps2[3])
+{
+    float dTheta[3];
+    float dVel[3];
+    float a[3]; // alpha(k-1) + dTheta(k-1) / 6
+    float v[3]; // nu(k-1) + dVel(k-1) / 6
+
+    for (int i = 0; i < 3; i++)
+    {
+        dTheta[i] = gyro_rads[i] * pi->dt_s;
+        dVel[i] = accel_mps2[i] * pi->dt_s;
+        a[i] = pi->alpha[i] + pi->prevDTheta[i] * (1.0f / 6.0f);
+        v[i] = pi->nu[i] + pi->prevDVel[i] * (1.0f / 6.0f);
+    }
+
+    // Coning: beta += 1/2 (alpha + dTheta_prev / 6) x dTheta
+    ImuPreint_CrossAcc(pi->beta, a, dTheta, 0.5f);
+
+    // Sculling: 1/2 [(alpha + dTheta_prev / 6) x dVel + (nu + dVel_prev / 6) x dTheta]
+    ImuPreint_CrossAcc(pi->scul, a, dVel, 0.5f);
+    ImuPreint_CrossAcc(pi->scul, v, dTheta, 0.5f);
+
+    for (int i = 0; i < 3; i++)
+    {
+        pi->alpha[i] += dTheta[i];
+        pi->nu[i] += dVel[i];
+        pi->prevDTheta[i] = dTheta[i];
+        pi->prevDVel[i] = dVel[i];
+    }
+    pi->samples++;
+}
+
+uint16_t ImuPreint_AddFifo(ImuPreint_t *pi, const ImuTempComp_t *comp, const LSM6DSO32_FifoWord_t *words, uint16_t count)
+{
+    uint16_t integrated = 0;
+
+    for (uint16_t n = 0; n < count; n++)
+    {
+        const LSM6DSO32_FifoWord_t *w = &words[n];
+        if (w->tag == LSM6DSO32_FIFO_TAG_GYRO)
+        {
+            pi->fifoGyro.x = w->x;
+            pi->fifoGyro.y = w->y;
+            pi->fifoGyro.z = w->z;
+            pi->fifoHave |= IMU_PREINT_HAVE_GYRO;
+        }
+        else if (w->tag == LSM6DSO32_FIFO_TAG_ACCEL)
+        {
+            pi->fifoAccel.x = w->x;
+            pi->fifoAccel.y = w->y;
+            pi->fifoAccel.z = w->z;
+            pi->fifoHave |= IMU_PREINT_HAVE_ACCEL;
+        }
+        else
+        {
+            continue;
+        }
+
+        if (pi->fifoHave != (IMU_PREINT_HAVE_GYRO | IMU_PREINT_HAVE_ACCEL))
+        {
+            continue;
+        }
+        pi->fifoHave = 0;
+
+        float gyro[3];
+        float accel[3];
+        if (comp)
+        {
+            ImuTempComp_Convert(comp, &pi->fifoGyro, &pi->fifoAccel, gyro, accel);
+        }
+        else
+        {
+            gyro[0] = pi->fifoGyro.x * IMU_PREINT_GYRO_SCALE;
+            gyro[1] = pi->fifoGyro.y * IMU_PREINT_GYRO_SCALE;
+            gyro[2] = pi->fifoGyro.z * IMU_PREINT_GYRO_SCALE;
+            accel[0] = pi->fifoAccel.x * IMU_PREINT_ACCEL_SCALE;
+            accel[1] = pi->fifoAccel.y * IMU_PREINT_ACCEL_SCALE;
+            accel[2] = pi->fifoAccel.z * IMU_PREINT_ACCEL_SCALE;
+        }
+        ImuPreint_AddSample(pi, gyro, accel);
+        integrated++;
+    }
+
+    return integrated;
+}
+
+int ImuPreint_Take(ImuPreint_t *pi, ImuPreint_Delta_t *delta)
+{
+    if (pi->samples == 0)
+    {
+        memset(delta, 0, sizeof(*delta));
+        return -1;
+    }
+
+    for (int i = 0; i < 3; i++)
+    {
+        delta->dAngle_rad[i] = pi->alpha[i] + pi->beta[i];
+        delta->dVel_mps[i] = pi->nu[i] + pi->scul[i];
+    }
+    // Velocity rotation compensation: 1/2 alpha x nu
+    ImuPreint_CrossAcc(delta->dVel_mps, pi->alpha, pi->nu, 0.5f);
+
+    delta->samples = pi->samples;
+    delta->dt_s = (float)pi->samples * pi->dt_s;
+
+    memset(pi->alpha, 0, sizeof(pi->alpha));
+    memset(pi->nu, 0, sizeof(pi->nu));
+    memset(pi->beta, 0, sizeof(pi->beta));
+    memset(pi->scul, 0, sizeof(pi->scul));
+    pi->samples = 0;
+
+    return 0;
+}
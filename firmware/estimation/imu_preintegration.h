@@ -0,0 +1,91 @@
+#ifndef IMU_PREINTEGRATION_H
+#define IMU_PREINTEGRATION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lsm6dso32.h"
+#include "imu_temp_comp.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef struct
+    {
+        float sampleRate_Hz; ///< IMU ODR / FIFO batch rate of both gyro and accel
+    } ImuPreint_Config_t;
+
+    /**
+     * @brief Increments over one control tick, in the body frame at the start of the tick
+     */
+    typedef struct
+    {
+        float dAngle_rad[3]; ///< Coning-compensated rotation vector
+        float dVel_mps[3];   ///< Rotation- and sculling-compensated velocity change (specific force)
+        float dt_s;          ///< Integrated time
+        uint16_t samples;    ///< IMU samples consumed
+    } ImuPreint_Delta_t;
+
+    typedef struct
+    {
+        ImuPreint_Config_t config;
+        float dt_s; ///< 1 / sampleRate_Hz
+
+        float alpha[3]; ///< Sum of angle increments this tick
+        float nu[3];    ///< Sum of velocity increments this tick
+        float beta[3];  ///< Coning correction
+        float scul[3];  ///< Sculling correction
+        uint16_t samples;
+
+        float prevDTheta[3]; ///< Previous angle increment (carried across ticks)
+        float prevDVel[3];   ///< Previous velocity increment (carried across ticks)
+
+        // FIFO pairing: gyro and accel words arrive separately
+        LSM6DSO32_GyroRaw_t fifoGyro;
+        LSM6DSO32_AccelRaw_t fifoAccel;
+        uint8_t fifoHave; ///< Bit 0 gyro, bit 1 accel
+    } ImuPreint_t;
+
+    /**
+     * @brief Initialize the integrator
+     * @param[out] pi  Pointer to integrator state
+     * @param[in]  cfg Pointer to configuration
+     * @retval  0 on success, negative on error
+     */
+    int ImuPreint_Init(ImuPreint_t *pi, const ImuPreint_Config_t *cfg);
+
+    /**
+     * @brief Integrate one IMU sample (rectangular increments, previous-sample
+     *        coning and sculling terms)
+     * @param[in,out] pi         Pointer to integrator state
+     * @param[in]     gyro_rads  Angular rate, rad/s
+     * @param[in]     accel_mps2 Specific force, m/s^2
+     */
+    void ImuPreint_AddSample(ImuPreint_t *pi, const float gyro_rads[3], const float accel_mps2[3]);
+
+    /**
+     * @brief Integrate every gyro/accel pair of a FIFO batch
+     *        Words must come from LSM6DSO32_FifoRead with equal gyro and accel
+     *        batch rates. Other tags are skipped.
+     * @param[in,out] pi    Pointer to integrator state
+     * @param[in]     comp  Temperature compensation to apply, or NULL for plain scaling
+     * @param[in]     words FIFO words
+     * @param[in]     count Number of words
+     * @return Number of samples integrated
+     */
+    uint16_t ImuPreint_AddFifo(ImuPreint_t *pi, const ImuTempComp_t *comp, const LSM6DSO32_FifoWord_t *words, uint16_t count);
+
+    /**
+     * @brief Output the increments of the finished control tick and start the next one
+     * @param[in,out] pi    Pointer to integrator state
+     * @param[out]    delta Increments since the previous call
+     * @retval  0 on success, -1 if no sample was integrated
+     */
+    int ImuPreint_Take(ImuPreint_t *pi, ImuPreint_Delta_t *delta);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // IMU_PREINTEGRATION_H
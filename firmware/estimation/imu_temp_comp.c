@@ -0,0 +1,278 @@
+#include "imu_temp_comp.h"
+#include <string.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL CONSTANTS                                                         */
+/*----------------------------------------------------------------------------*/
+
+#define IMU_GRAVITY_MPS2 9.80665f
+#define IMU_GYRO_SCALE_RADS (LSM6DSO32_GYRO_SENS_2000DPS_MDPS * 0.001f * 0.0174532925f)
+#define IMU_ACCEL_SCALE_MPS2 (LSM6DSO32_ACCEL_SENS_8G_MG * 0.001f * IMU_GRAVITY_MPS2)
+#define IMU_TEMP_COMP_INV_BIN_WIDTH (1.0f / IMU_TEMP_COMP_BIN_WIDTH_C)
+
+// Accel drift is only learned when the board sits within ~2 deg of the
+// orientation the reference bin was learned in (cos^2(2 deg)).
+#define IMU_TEMP_COMP_ACCEL_DIR_COS2 0.998782f
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @brief Merge one sample into a saturating running mean
+ */
+static inline void ImuTempComp_Accumulate(float mean[3], uint16_t *count, uint16_t maxWeight, const float x[3])
+{
+    if (*count < maxWeight)
+    {
+        (*count)++;
+    }
+    float w = 1.0f / (float)(*count);
+    for (int i = 0; i < 3; i++)
+    {
+        mean[i] += (x[i] - mean[i]) * w;
+    }
+}
+
+/**
+ * @brief Interpolate gyro bias or accel mean between the nearest valid bins
+ * @retval true if at least one valid bin was found
+ */
+static bool ImuTempComp_Interpolate(const ImuTempComp_t *comp, float temp_C, bool accel, float out[3])
+{
+    // Position in units of bins, 0.0 at the centre of bin 0
+    float pos = (temp_C - IMU_TEMP_COMP_T_MIN_C) * IMU_TEMP_COMP_INV_BIN_WIDTH - 0.5f;
+    int start = (int)pos;
+    if (pos < 0.0f)
+    {
+        start = -1;
+    }
+
+    int lo = -1;
+    for (int i = (start < IMU_TEMP_COMP_BIN_COUNT ? start : IMU_TEMP_COMP_BIN_COUNT - 1); i >= 0; i--)
+    {
+        uint16_t n = accel ? comp->bins[i].accelCount : comp->bins[i].gyroCount;
+        if (n >= comp->config.minBinSamples)
+        {
+            lo = i;
+            break;
+        }
+    }
+
+    int hi = -1;
+    for (int i = (start + 1 > 0 ? start + 1 : 0); i < IMU_TEMP_COMP_BIN_COUNT; i++)
+    {
+        uint16_t n = accel ? comp->bins[i].accelCount : comp->bins[i].gyroCount;
+        if (n >= comp->config.minBinSamples)
+        {
+            hi = i;
+            break;
+        }
+    }
+
+    if (lo < 0 && hi < 0)
+    {
+        return false;
+    }
+
+    const float *a = NULL;
+    const float *b = NULL;
+    float t = 0.0f;
+    if (lo < 0 || hi < 0)
+    {
+        // Only one side populated: hold the nearest bin
+        int i = (lo < 0) ? hi : lo;
+        a = accel ? comp->bins[i].accelMean : comp->bins[i].gyroBias;
+        b = a;
+    }
+    else
+    {
+        a = accel ? comp->bins[lo].accelMean : comp->bins[lo].gyroBias;
+        b = accel ? comp->bins[hi].accelMean : comp->bins[hi].gyroBias;
+        t = (pos - (float)lo) / (float)(hi - lo);
+    }
+
+    for (int i = 0; i < 3; i++)
+    {
+        out[i] = a[i] + (b[i] - a[i]) * t;
+    }
+    return true;
+}
+
+/**
+ * @brief Recompute the cached correction for comp->temp_C
+ */
+static void ImuTempComp_Refresh(ImuTempComp_t *comp)
+{
+    if (!ImuTempComp_Interpolate(comp, comp->temp_C, false, comp->gyroBias))
+    {
+        memset(comp->gyroBias, 0, sizeof(comp->gyroBias));
+    }
+
+    float accelMean[3];
+    int ref = comp->accelRefBin;
+    if (ref >= 0 && comp->bins[ref].accelCount >= comp->config.minBinSamples &&
+        ImuTempComp_Interpolate(comp, comp->temp_C, true, accelMean))
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            comp->accelBias[i] = accelMean[i] - comp->bins[ref].accelMean[i];
+        }
+    }
+    else
+    {
+        memset(comp->accelBias, 0, sizeof(comp->accelBias));
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+int ImuTempComp_Init(ImuTempComp_t *comp, const ImuTempComp_Config_t *cfg)
+{
+    if (!comp || !cfg || cfg->maxBinWeight == 0 || cfg->minBinSamples > cfg->maxBinWeight)
+    {
+        return -1;
+    }
+
+    memset(comp, 0, sizeof(*comp));
+    comp->config = *cfg;
+    comp->accelRefBin = -1;
+    comp->tempBin = -1;
+    comp->temp_C = LSM6DSO32_TEMP_OFFSET_C;
+
+    return 0;
+}
+
+void ImuTempComp_SetTemperature(ImuTempComp_t *comp, float temp_C)
+{
+    if (!comp)
+    {
+        return;
+    }
+
+    comp->temp_C = temp_C;
+
+    float pos = (temp_C - IMU_TEMP_COMP_T_MIN_C) * IMU_TEMP_COMP_INV_BIN_WIDTH;
+    if (pos < 0.0f || pos >= (float)IMU_TEMP_COMP_BIN_COUNT)
+    {
+        comp->tempBin = -1; // outside the model: correct from the edge bins, never learn
+    }
+    else
+    {
+        comp->tempBin = (int8_t)pos;
+    }
+
+    ImuTempComp_Refresh(comp);
+}
+
+bool ImuTempComp_Update(ImuTempComp_t *comp, const LSM6DSO32_GyroRaw_t *gyro, const LSM6DSO32_AccelRaw_t *accel)
+{
+    if (!comp || !gyro || !accel)
+    {
+        return false;
+    }
+
+    const ImuTempComp_Config_t *cfg = &comp->config;
+
+    float g[3] = {
+        gyro->x * IMU_GYRO_SCALE_RADS,
+        gyro->y * IMU_GYRO_SCALE_RADS,
+        gyro->z * IMU_GYRO_SCALE_RADS,
+    };
+    float a[3] = {
+        accel->x * IMU_ACCEL_SCALE_MPS2,
+        accel->y * IMU_ACCEL_SCALE_MPS2,
+        accel->z * IMU_ACCEL_SCALE_MPS2,
+    };
+
+    // Still test: bias-corrected rate small on every axis and |a| close to 1 g.
+    // ||a|^2 - g^2| < 2 g thr is the first-order form of ||a| - g| < thr.
+    bool still = true;
+    for (int i = 0; i < 3; i++)
+    {
+        float r = g[i] - comp->gyroBias[i];
+        if (r > cfg->gyroThreshold_rads || r < -cfg->gyroThreshold_rads)
+        {
+            still = false;
+        }
+    }
+    float n2 = a[0] * a[0] + a[1] * a[1] + a[2] * a[2];
+    float dn2 = n2 - IMU_GRAVITY_MPS2 * IMU_GRAVITY_MPS2;
+    float lim = 2.0f * IMU_GRAVITY_MPS2 * cfg->accelThreshold_mps2;
+    if (dn2 > lim || dn2 < -lim)
+    {
+        still = false;
+    }
+
+    if (!still)
+    {
+        comp->stillCount = 0;
+        comp->stationary = false;
+        return false;
+    }
+
+    if (comp->stillCount < cfg->stationarySamples)
+    {
+        comp->stillCount++;
+    }
+    comp->stationary = comp->stillCount >= cfg->stationarySamples;
+    if (!comp->stationary || comp->tempBin < 0)
+    {
+        return comp->stationary;
+    }
+
+    ImuTempComp_Bin_t *bin = &comp->bins[comp->tempBin];
+    bool refresh = false;
+
+    uint16_t before = bin->gyroCount;
+    ImuTempComp_Accumulate(bin->gyroBias, &bin->gyroCount, cfg->maxBinWeight, g);
+    refresh |= (before < cfg->minBinSamples && bin->gyroCount >= cfg->minBinSamples);
+
+    if (comp->accelRefBin < 0)
+    {
+        comp->accelRefBin = comp->tempBin;
+    }
+
+    // Accel drift is the change of the stationary reading with temperature,
+    // so it is only observable in the orientation of the reference bin.
+    const float *ref = comp->bins[comp->accelRefBin].accelMean;
+    bool sameAttitude = true;
+    if (comp->tempBin != comp->accelRefBin)
+    {
+        float r2 = ref[0] * ref[0] + ref[1] * ref[1] + ref[2] * ref[2];
+        float dot = a[0] * ref[0] + a[1] * ref[1] + a[2] * ref[2];
+        sameAttitude = dot > 0.0f && dot * dot > IMU_TEMP_COMP_ACCEL_DIR_COS2 * n2 * r2;
+    }
+    if (sameAttitude)
+    {
+        before = bin->accelCount;
+        ImuTempComp_Accumulate(bin->accelMean, &bin->accelCount, cfg->maxBinWeight, a);
+        refresh |= (before < cfg->minBinSamples && bin->accelCount >= cfg->minBinSamples);
+    }
+
+    if (refresh)
+    {
+        ImuTempComp_Refresh(comp);
+    }
+
+    return true;
+}
+
+void ImuTempComp_Convert(const ImuTempComp_t *comp, const LSM6DSO32_GyroRaw_t *gyro, const LSM6DSO32_AccelRaw_t *accel,
+                         float gyro_rads[3], float accel_mps2[3])
+{
+    gyro_rads[0] = gyro->x * IMU_GYRO_SCALE_RADS - comp->gyroBias[0];
+    gyro_rads[1] = gyro->y * IMU_GYRO_SCALE_RADS - comp->gyroBias[1];
+    gyro_rads[2] = gyro->z * IMU_GYRO_SCALE_RADS - comp->gyroBias[2];
+
+    accel_mps2[0] = accel->x * IMU_ACCEL_SCALE_MPS2 - comp->accelBias[0];
+    accel_mps2[1] = accel->y * IMU_ACCEL_SCALE_MPS2 - comp->accelBias[1];
+    accel_mps2[2] = accel->z * IMU_ACCEL_SCALE_MPS2 - comp->accelBias[2];
+}
+
+float ImuTempComp_RawTempToC(int16_t raw)
+{
+    return LSM6DSO32_TEMP_OFFSET_C + raw * (1.0f / LSM6DSO32_TEMP_SENS_LSB_PER_C);
+}
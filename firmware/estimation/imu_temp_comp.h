@@ -0,0 +1,110 @@
+#ifndef IMU_TEMP_COMP_H
+#define IMU_TEMP_COMP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lsm6dso32.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*----------------------------------------------------------------------------*/
+/* TEMPERATURE BINS                                                           */
+/*----------------------------------------------------------------------------*/
+#define IMU_TEMP_COMP_BIN_COUNT 16
+#define IMU_TEMP_COMP_BIN_WIDTH_C 4.0f
+#define IMU_TEMP_COMP_T_MIN_C -10.0f // lower edge of bin 0, bins cover -10..54 degC
+
+    /**
+     * @brief Stationary detection and learning parameters.
+     */
+    typedef struct
+    {
+        float gyroThreshold_rads;   ///< Max bias-corrected rate on any axis to count as still
+        float accelThreshold_mps2;  ///< Max deviation of |a| from 1 g to count as still
+        uint16_t stationarySamples; ///< Consecutive still samples before learning starts
+        uint16_t minBinSamples;     ///< Samples needed before a bin is used for correction
+        uint16_t maxBinWeight;      ///< Running mean turns into an EMA of 1/maxBinWeight after this
+    } ImuTempComp_Config_t;
+
+    /**
+     * @brief Learned bias for one temperature bin. Fixed size, updated in place.
+     */
+    typedef struct
+    {
+        uint16_t gyroCount;    ///< Samples merged into gyroBias (saturates at maxBinWeight)
+        uint16_t accelCount;   ///< Samples merged into accelMean (saturates at maxBinWeight)
+        float gyroBias[3];     ///< Mean stationary gyro output, rad/s
+        float accelMean[3];    ///< Mean stationary accel output, m/s^2
+    } ImuTempComp_Bin_t;
+
+    /**
+     * @brief Temperature compensation model and stationary detector state.
+     */
+    typedef struct
+    {
+        ImuTempComp_Config_t config; ///< Configuration
+
+        ImuTempComp_Bin_t bins[IMU_TEMP_COMP_BIN_COUNT]; ///< Per temperature bin statistics
+
+        uint16_t stillCount; ///< Consecutive samples that passed the still test
+        bool stationary;     ///< Detector output for the last sample
+
+        int8_t accelRefBin;  ///< Bin whose accel mean defines zero drift, -1 if none yet
+
+        float temp_C;        ///< Temperature the cached correction was computed for
+        int8_t tempBin;      ///< Bin index of temp_C
+        float gyroBias[3];   ///< Cached gyro correction at temp_C, rad/s
+        float accelBias[3];  ///< Cached accel drift correction at temp_C, m/s^2
+    } ImuTempComp_t;
+
+    /**
+     * @brief Initialize an empty model
+     * @param[out] comp Pointer to model state
+     * @param[in]  cfg  Pointer to configuration
+     * @retval  0 on success, negative on error
+     */
+    int ImuTempComp_Init(ImuTempComp_t *comp, const ImuTempComp_Config_t *cfg);
+
+    /**
+     * @brief Set the current sensor temperature and refresh the cached correction
+     *        Call at temperature rate (IMU or LPS22HB channel), not per sample.
+     * @param[in,out] comp   Pointer to model state
+     * @param[in]     temp_C Temperature in degC
+     */
+    void ImuTempComp_SetTemperature(ImuTempComp_t *comp, float temp_C);
+
+    /**
+     * @brief Run stationary detection on a raw sample and learn bias if still
+     * @param[in,out] comp  Pointer to model state
+     * @param[in]     gyro  Raw gyro sample
+     * @param[in]     accel Raw accel sample
+     * @return true if the sample was classified stationary
+     */
+    bool ImuTempComp_Update(ImuTempComp_t *comp, const LSM6DSO32_GyroRaw_t *gyro, const LSM6DSO32_AccelRaw_t *accel);
+
+    /**
+     * @brief Convert raw samples to SI units with the temperature correction applied
+     * @param[in]  comp       Pointer to model state
+     * @param[in]  gyro       Raw gyro sample
+     * @param[in]  accel      Raw accel sample
+     * @param[out] gyro_rads  Corrected angular rate, rad/s
+     * @param[out] accel_mps2 Corrected specific force, m/s^2
+     */
+    void ImuTempComp_Convert(const ImuTempComp_t *comp, const LSM6DSO32_GyroRaw_t *gyro, const LSM6DSO32_AccelRaw_t *accel,
+                             float gyro_rads[3], float accel_mps2[3]);
+
+    /**
+     * @brief Convert a raw LSM6DSO32 temperature reading to degC
+     * @param[in] raw Raw OUT_TEMP value
+     * @return Temperature in degC
+     */
+    float ImuTempComp_RawTempToC(int16_t raw);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // IMU_TEMP_COMP_H
@@ -0,0 +1,391 @@
+#include "mag_calibration.h"
+#include <math.h>
+#include <string.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL CONSTANTS                                                         */
+/*----------------------------------------------------------------------------*/
+
+// Raw samples are scaled to ~unit magnitude before squaring so the normal
+// equations stay well conditioned (earth field is ~330 LSB at 1.5 mG/LSB).
+// That is what lets the whole fit run in single precision on the FPU: on the
+// host the offset stays within 0.05 LSB of a double fit up to 500k samples
+// (over an hour at 100 Hz); beyond that the float sums start to stagnate.
+#define MAG_CAL_NORM (1.0f / 512.0f)
+#define MAG_CAL_MIN_PIVOT 1e-5f
+#define MAG_CAL_JACOBI_SWEEPS 8
+#define MAG_CAL_MAX_ANISOTROPY 3.0f
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @brief Build the design row d = [x2, y2, z2, 2yz, 2xz, 2xy, 2x, 2y, 2z]
+ */
+static inline void MagCal_DesignRow(const LIS2MDL_Mag_Raw *mag, float d[MAG_CAL_PARAMS])
+{
+    float x = mag->x * MAG_CAL_NORM;
+    float y = mag->y * MAG_CAL_NORM;
+    float z = mag->z * MAG_CAL_NORM;
+
+    d[0] = x * x;
+    d[1] = y * y;
+    d[2] = z * z;
+    d[3] = 2.0f * y * z;
+    d[4] = 2.0f * x * z;
+    d[5] = 2.0f * x * y;
+    d[6] = 2.0f * x;
+    d[7] = 2.0f * y;
+    d[8] = 2.0f * z;
+}
+
+/**
+ * @brief Solve the SPD system A x = b in place with Cholesky (A is overwritten)
+ * @retval 0 on success, -1 if A is not positive definite
+ */
+static int MagCal_CholeskySolve(float a[MAG_CAL_PARAMS][MAG_CAL_PARAMS], const float b[MAG_CAL_PARAMS],
+                                float x[MAG_CAL_PARAMS])
+{
+    for (int j = 0; j < MAG_CAL_PARAMS; j++)
+    {
+        float diag = a[j][j];
+        for (int k = 0; k < j; k++)
+        {
+            diag -= a[j][k] * a[j][k];
+        }
+        // A pivot that lost all but the last digits of its column is rank deficiency
+        if (diag <= MAG_CAL_MIN_PIVOT * a[j][j])
+        {
+            return -1;
+        }
+        a[j][j] = sqrtf(diag);
+
+        for (int i = j + 1; i < MAG_CAL_PARAMS; i++)
+        {
+            float v = a[i][j];
+            for (int k = 0; k < j; k++)
+            {
+                v -= a[i][k] * a[j][k];
+            }
+            a[i][j] = v / a[j][j];
+        }
+    }
+
+    // Forward substitution L y = b
+    for (int i = 0; i < MAG_CAL_PARAMS; i++)
+    {
+        float v = b[i];
+        for (int k = 0; k < i; k++)
+        {
+            v -= a[i][k] * x[k];
+        }
+        x[i] = v / a[i][i];
+    }
+
+    // Back substitution L^T x = y
+    for (int i = MAG_CAL_PARAMS - 1; i >= 0; i--)
+    {
+        float v = x[i];
+        for (int k = i + 1; k < MAG_CAL_PARAMS; k++)
+        {
+            v -= a[k][i] * x[k];
+        }
+        x[i] = v / a[i][i];
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Eigen decomposition of a symmetric 3x3 matrix with a fixed number of Jacobi sweeps
+ *        On return m is diagonal (eigenvalues) and v holds the eigenvectors in columns.
+ */
+static void MagCal_Jacobi3(float m[3][3], float v[3][3])
+{
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            v[i][j] = (i == j) ? 1.0f : 0.0f;
+        }
+    }
+
+    for (int sweep = 0; sweep < MAG_CAL_JACOBI_SWEEPS; sweep++)
+    {
+        for (int p = 0; p < 2; p++)
+        {
+            for (int q = p + 1; q < 3; q++)
+            {
+                if (fabsf(m[p][q]) < 1e-15f)
+                {
+                    continue;
+                }
+
+                float theta = (m[q][q] - m[p][p]) / (2.0f * m[p][q]);
+                float t = 1.0f / (fabsf(theta) + sqrtf(theta * theta + 1.0f));
+                if (theta < 0.0f)
+                {
+                    t = -t;
+                }
+                float c = 1.0f / sqrtf(t * t + 1.0f);
+                float s = t * c;
+
+                for (int k = 0; k < 3; k++)
+                {
+                    float mkp = m[k][p];
+                    float mkq = m[k][q];
+                    m[k][p] = c * mkp - s * mkq;
+                    m[k][q] = s * mkp + c * mkq;
+                }
+                for (int k = 0; k < 3; k++)
+                {
+                    float mpk = m[p][k];
+                    float mqk = m[q][k];
+                    m[p][k] = c * mpk - s * mqk;
+                    m[q][k] = s * mpk + c * mqk;
+                }
+                for (int k = 0; k < 3; k++)
+                {
+                    float vkp = v[k][p];
+                    float vkq = v[k][q];
+                    v[k][p] = c * vkp - s * vkq;
+                    v[k][q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+void MagCal_Reset(MagCal_Accumulator_t *acc)
+{
+    if (!acc)
+    {
+        return;
+    }
+    memset(acc, 0, sizeof(*acc));
+}
+
+void MagCal_AddSample(MagCal_Accumulator_t *acc, const LIS2MDL_Mag_Raw *mag)
+{
+    if (!acc || !mag)
+    {
+        return;
+    }
+
+    float d[MAG_CAL_PARAMS];
+    MagCal_DesignRow(mag, d);
+
+    int idx = 0;
+    for (int i = 0; i < MAG_CAL_PARAMS; i++)
+    {
+        for (int j = i; j < MAG_CAL_PARAMS; j++)
+        {
+            acc->dtd[idx++] += d[i] * d[j];
+        }
+        acc->dt1[i] += d[i];
+    }
+    acc->count++;
+}
+
+int MagCal_Fit(const MagCal_Accumulator_t *acc, MagCal_Result_t *result)
+{
+    if (!acc || !result)
+    {
+        return -1;
+    }
+    result->valid = false;
+    result->samples = acc->count;
+    if (acc->count < MAG_CAL_MIN_SAMPLES)
+    {
+        return -2;
+    }
+
+    // 1) Least squares d . theta = 1 from the packed normal equations
+    float a[MAG_CAL_PARAMS][MAG_CAL_PARAMS];
+    int idx = 0;
+    for (int i = 0; i < MAG_CAL_PARAMS; i++)
+    {
+        for (int j = i; j < MAG_CAL_PARAMS; j++)
+        {
+            a[i][j] = acc->dtd[idx];
+            a[j][i] = acc->dtd[idx];
+            idx++;
+        }
+    }
+
+    float theta[MAG_CAL_PARAMS];
+    if (MagCal_CholeskySolve(a, acc->dt1, theta) != 0)
+    {
+        return -3; // not enough orientation coverage
+    }
+
+    // Residual sum of squares straight from the statistics:
+    // |D theta - 1|^2 = theta' D'D theta - 2 theta' D'1 + N
+    float rss = (float)acc->count;
+    idx = 0;
+    for (int i = 0; i < MAG_CAL_PARAMS; i++)
+    {
+        for (int j = i; j < MAG_CAL_PARAMS; j++)
+        {
+            float w = (i == j) ? 1.0f : 2.0f;
+            rss += w * theta[i] * theta[j] * acc->dtd[idx++];
+        }
+        rss -= 2.0f * theta[i] * acc->dt1[i];
+    }
+    if (rss < 0.0f)
+    {
+        rss = 0.0f;
+    }
+
+    // 2) Centre c = -A^-1 v, with x' A x + 2 v' x = 1
+    float A[3][3] = {
+        {theta[0], theta[5], theta[4]},
+        {theta[5], theta[1], theta[3]},
+        {theta[4], theta[3], theta[2]},
+    };
+    float v[3] = {theta[6], theta[7], theta[8]};
+
+    float det = A[0][0] * (A[1][1] * A[2][2] - A[1][2] * A[2][1]) -
+                 A[0][1] * (A[1][0] * A[2][2] - A[1][2] * A[2][0]) +
+                 A[0][2] * (A[1][0] * A[2][1] - A[1][1] * A[2][0]);
+    if (fabsf(det) < 1e-18f)
+    {
+        return -4;
+    }
+    float inv[3][3] = {
+        {(A[1][1] * A[2][2] - A[1][2] * A[2][1]) / det, (A[0][2] * A[2][1] - A[0][1] * A[2][2]) / det, (A[0][1] * A[1][2] - A[0][2] * A[1][1]) / det},
+        {(A[1][2] * A[2][0] - A[1][0] * A[2][2]) / det, (A[0][0] * A[2][2] - A[0][2] * A[2][0]) / det, (A[0][2] * A[1][0] - A[0][0] * A[1][2]) / det},
+        {(A[1][0] * A[2][1] - A[1][1] * A[2][0]) / det, (A[0][1] * A[2][0] - A[0][0] * A[2][1]) / det, (A[0][0] * A[1][1] - A[0][1] * A[1][0]) / det},
+    };
+    float c[3];
+    for (int i = 0; i < 3; i++)
+    {
+        c[i] = -(inv[i][0] * v[0] + inv[i][1] * v[1] + inv[i][2] * v[2]);
+    }
+
+    // (x - c)' A (x - c) = 1 + c' A c  ->  M = A / k
+    float k = 1.0f;
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            k += c[i] * A[i][j] * c[j];
+        }
+    }
+    if (k <= 0.0f)
+    {
+        return -5;
+    }
+
+    // 3) Soft-iron: symmetric square root of M, scaled to keep the mean radius
+    float m[3][3];
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            m[i][j] = A[i][j] / k;
+        }
+    }
+    float vec[3][3];
+    MagCal_Jacobi3(m, vec);
+
+    float lambda[3] = {m[0][0], m[1][1], m[2][2]};
+    float lmin = lambda[0];
+    float lmax = lambda[0];
+    for (int i = 0; i < 3; i++)
+    {
+        if (lambda[i] <= 0.0f)
+        {
+            return -6; // hyperboloid, not an ellipsoid
+        }
+        lmin = (lambda[i] < lmin) ? lambda[i] : lmin;
+        lmax = (lambda[i] > lmax) ? lambda[i] : lmax;
+    }
+
+    // Geometric mean radius in normalized units
+    float radius = powf(lambda[0] * lambda[1] * lambda[2], -1.0f / 6.0f);
+    float scale = radius / MAG_CAL_NORM * LIS2MDL_SENS_MGAUSS * 0.001f; // normalized -> gauss
+
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            float w = 0.0f;
+            for (int e = 0; e < 3; e++)
+            {
+                w += vec[i][e] * sqrtf(lambda[e]) * vec[j][e];
+            }
+            // W operates on normalized units: fold MAG_CAL_NORM in so Apply takes raw LSB
+            result->matrix[i][j] = w * scale * MAG_CAL_NORM;
+        }
+        result->offset[i] = c[i] / MAG_CAL_NORM;
+    }
+
+    result->radius_gauss = radius / MAG_CAL_NORM * LIS2MDL_SENS_MGAUSS * 0.001f;
+    result->residualRms = sqrtf(rss / (float)acc->count);
+    result->anisotropy = sqrtf(lmax / lmin);
+    if (result->anisotropy > MAG_CAL_MAX_ANISOTROPY)
+    {
+        return -7; // implausible soft-iron distortion: bad data
+    }
+
+    result->valid = true;
+    return 0;
+}
+
+void MagCal_SetIdentity(MagCal_Result_t *result)
+{
+    if (!result)
+    {
+        return;
+    }
+
+    memset(result, 0, sizeof(*result));
+    for (int i = 0; i < 3; i++)
+    {
+        result->matrix[i][i] = LIS2MDL_SENS_MGAUSS * 0.001f;
+    }
+    result->anisotropy = 1.0f;
+    result->valid = true;
+}
+
+void MagCal_Apply(const MagCal_Result_t *result, const LIS2MDL_Mag_Raw *mag, float out_gauss[3])
+{
+    float x = mag->x - result->offset[0];
+    float y = mag->y - result->offset[1];
+    float z = mag->z - result->offset[2];
+
+    out_gauss[0] = result->matrix[0][0] * x + result->matrix[0][1] * y + result->matrix[0][2] * z;
+    out_gauss[1] = result->matrix[1][0] * x + result->matrix[1][1] * y + result->matrix[1][2] * z;
+    out_gauss[2] = result->matrix[2][0] * x + result->matrix[2][1] * y + result->matrix[2][2] * z;
+}
+
+int MagCal_LoadHardIronToSensor(LIS2MDL_Handle_t *dev, MagCal_Result_t *result)
+{
+    if (!dev || !result || !result->valid)
+    {
+        return -1;
+    }
+
+    // Samples must have been collected with the offset registers cleared,
+    // the fitted offset is absolute.
+    LIS2MDL_Mag_Raw offset = {
+        .x = (int16_t)lroundf(result->offset[0]),
+        .y = (int16_t)lroundf(result->offset[1]),
+        .z = (int16_t)lroundf(result->offset[2]),
+    };
+    if (LIS2MDL_SetHardIronOffset(dev, &offset) != 0)
+    {
+        return -2;
+    }
+
+    result->offset[0] -= offset.x;
+    result->offset[1] -= offset.y;
+    result->offset[2] -= offset.z;
+    return 0;
+}
@@ -0,0 +1,99 @@
+#ifndef MAG_CALIBRATION_H
+#define MAG_CALIBRATION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lis2mdl.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Incremental hard- and soft-iron fit of raw LIS2MDL samples. Not reachable
+ * on target yet: main.c leaves the LIS2MDL uninitialized and nothing calls
+ * MagCal_AddSample or MagCal_Fit, so there is no field recalibration. That
+ * needs the mag read back in the loop and a host command to start
+ * collecting and to fit. Until then the fit is exercised in the SIL only
+ * (test_mag_calibration).
+ */
+#define MAG_CAL_PARAMS 9 // general ellipsoid: 6 quadratic + 3 linear terms
+#define MAG_CAL_MIN_SAMPLES 100
+
+    /**
+     * @brief Sufficient statistics of the ellipsoid least-squares problem.
+     *        Fixed size regardless of how many samples were added.
+     */
+    typedef struct
+    {
+        float dtd[MAG_CAL_PARAMS * (MAG_CAL_PARAMS + 1) / 2]; ///< Upper triangle of D^T D, row major
+        float dt1[MAG_CAL_PARAMS];                           ///< D^T * 1
+        uint32_t count;                                       ///< Number of samples accumulated
+    } MagCal_Accumulator_t;
+
+    /**
+     * @brief Calibration result, ready for MagCal_Apply.
+     *        calibrated_gauss = matrix * (raw - offset)
+     */
+    typedef struct
+    {
+        float offset[3];    ///< Hard-iron offset in LSB
+        float matrix[3][3]; ///< Soft-iron correction including LSB->gauss scaling
+        float radius_gauss; ///< Mean field magnitude of the fitted ellipsoid
+        float residualRms;  ///< Algebraic fit residual, RMS relative to the unit sphere
+        float anisotropy;   ///< Largest over smallest ellipsoid axis (1.0 = sphere)
+        uint32_t samples;   ///< Samples used for the fit
+        bool valid;         ///< Fit produced a real ellipsoid
+    } MagCal_Result_t;
+
+    /**
+     * @brief Clear the accumulated statistics
+     * @param[out] acc Pointer to accumulator
+     */
+    void MagCal_Reset(MagCal_Accumulator_t *acc);
+
+    /**
+     * @brief Add one raw sample (54 multiply-adds, no stored points)
+     * @param[in,out] acc Pointer to accumulator
+     * @param[in]     mag Raw sample
+     */
+    void MagCal_AddSample(MagCal_Accumulator_t *acc, const LIS2MDL_Mag_Raw *mag);
+
+    /**
+     * @brief Fit hard-iron offset and soft-iron matrix from the accumulated statistics
+     *        Runs in bounded time: one 9x9 Cholesky solve and a fixed-sweep 3x3 Jacobi.
+     * @param[in]  acc    Pointer to accumulator
+     * @param[out] result Pointer to calibration result
+     * @retval  0 on success, negative on error (too few samples, degenerate fit)
+     */
+    int MagCal_Fit(const MagCal_Accumulator_t *acc, MagCal_Result_t *result);
+
+    /**
+     * @brief Identity calibration: sensitivity scaling only
+     * @param[out] result Pointer to calibration result
+     */
+    void MagCal_SetIdentity(MagCal_Result_t *result);
+
+    /**
+     * @brief Fused conversion kernel: offset, soft-iron and LSB->gauss in one pass
+     * @param[in]  result Pointer to calibration result
+     * @param[in]  mag    Raw sample
+     * @param[out] out_gauss Calibrated field in gauss
+     */
+    void MagCal_Apply(const MagCal_Result_t *result, const LIS2MDL_Mag_Raw *mag, float out_gauss[3]);
+
+    /**
+     * @brief Move the integer part of the hard-iron offset into the LIS2MDL offset registers
+     *        The remaining fractional LSB stays in result->offset.
+     * @param[in]     dev    Pointer to driver handle
+     * @param[in,out] result Pointer to calibration result
+     * @retval  0 on success, negative on error
+     */
+    int MagCal_LoadHardIronToSensor(LIS2MDL_Handle_t *dev, MagCal_Result_t *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MAG_CALIBRATION_H
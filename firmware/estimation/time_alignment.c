@@ -0,0 +1,171 @@
+#include "time_alignment.h"
+#include <string.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @brief Signed difference a - b, valid across one counter wrap
+ */
+static inline int32_t TimeAlign_Diff(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b);
+}
+
+/**
+ * @brief Ring index of the k-th newest entry (k = 0 is the newest)
+ */
+static inline uint8_t TimeAlign_Index(const TimeAlign_Channel_t *ch, uint8_t k)
+{
+    int idx = (int)ch->head - 1 - (int)k;
+    return (uint8_t)((idx < 0) ? idx + ch->depth : idx);
+}
+
+static void TimeAlign_SetupChannel(TimeAlign_Channel_t *ch, uint32_t *t, float *values, uint8_t depth, uint8_t width)
+{
+    ch->t_us = t;
+    ch->values = values;
+    ch->depth = depth;
+    ch->width = width;
+    ch->head = 0;
+    ch->count = 0;
+}
+
+static int TimeAlign_Push(TimeAlign_Channel_t *ch, uint32_t t_us, const float *values)
+{
+    if (ch->count > 0 && TimeAlign_Diff(t_us, ch->t_us[TimeAlign_Index(ch, 0)]) <= 0)
+    {
+        return -1;
+    }
+
+    ch->t_us[ch->head] = t_us;
+    memcpy(&ch->values[ch->head * ch->width], values, ch->width * sizeof(float));
+    ch->head = (uint8_t)((ch->head + 1 < ch->depth) ? ch->head + 1 : 0);
+    if (ch->count < ch->depth)
+    {
+        ch->count++;
+    }
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+int TimeAlign_Init(TimeAlign_t *ta, const TimeAlign_Config_t *cfg)
+{
+    if (!ta || !cfg || cfg->latency_us > INT32_MAX)
+    {
+        return -1;
+    }
+
+    memset(ta, 0, sizeof(*ta));
+    ta->config = *cfg;
+
+    TimeAlign_SetupChannel(&ta->channel[TIME_ALIGN_IMU], ta->imuTime, ta->imuValues, TIME_ALIGN_IMU_DEPTH, 6);
+    TimeAlign_SetupChannel(&ta->channel[TIME_ALIGN_MAG], ta->magTime, ta->magValues, TIME_ALIGN_MAG_DEPTH, 3);
+    TimeAlign_SetupChannel(&ta->channel[TIME_ALIGN_BARO], ta->baroTime, ta->baroValues, TIME_ALIGN_BARO_DEPTH, 2);
+
+    return 0;
+}
+
+int TimeAlign_PushImu(TimeAlign_t *ta, uint32_t t_us, const float gyro[3], const float accel[3])
+{
+    float v[6] = {gyro[0], gyro[1], gyro[2], accel[0], accel[1], accel[2]};
+    return TimeAlign_Push(&ta->channel[TIME_ALIGN_IMU], t_us, v);
+}
+
+int TimeAlign_PushMag(TimeAlign_t *ta, uint32_t t_us, const float mag[3])
+{
+    return TimeAlign_Push(&ta->channel[TIME_ALIGN_MAG], t_us, mag);
+}
+
+int TimeAlign_PushBaro(TimeAlign_t *ta, uint32_t t_us, float pressure_hPa, float temp_C)
+{
+    float v[2] = {pressure_hPa, temp_C};
+    return TimeAlign_Push(&ta->channel[TIME_ALIGN_BARO], t_us, v);
+}
+
+uint32_t TimeAlign_AlignedTime(const TimeAlign_t *ta, uint32_t now_us)
+{
+    return now_us - ta->config.latency_us;
+}
+
+int TimeAlign_SampleSensor(const TimeAlign_t *ta, uint8_t sensor, uint32_t t_us, float *out)
+{
+    if (!ta || sensor >= TIME_ALIGN_SENSOR_COUNT || !out)
+    {
+        return -1;
+    }
+    const TimeAlign_Channel_t *ch = &ta->channel[sensor];
+    if (ch->count == 0)
+    {
+        return -2;
+    }
+
+    // Newest sample at or before t_us; the scan is short since t_us trails
+    // the newest sample by about the configured latency.
+    uint8_t newer = 0;
+    for (uint8_t k = 0; k < ch->count; k++)
+    {
+        uint8_t idx = TimeAlign_Index(ch, k);
+        int32_t age = TimeAlign_Diff(t_us, ch->t_us[idx]);
+        if (age < 0)
+        {
+            newer = idx;
+            continue;
+        }
+
+        const float *v0 = &ch->values[idx * ch->width];
+        if (k == 0)
+        {
+            // Past the newest sample: hold it for a bounded time only
+            if ((uint32_t)age > ta->config.maxHold_us[sensor])
+            {
+                return -3;
+            }
+            memcpy(out, v0, ch->width * sizeof(float));
+            return (age == 0) ? 0 : 1;
+        }
+
+        const float *v1 = &ch->values[newer * ch->width];
+        float span = (float)TimeAlign_Diff(ch->t_us[newer], ch->t_us[idx]);
+        float w = (float)age / span;
+        for (uint8_t i = 0; i < ch->width; i++)
+        {
+            out[i] = v0[i] + w * (v1[i] - v0[i]);
+        }
+        return 0;
+    }
+
+    return -4; // older than the kept history
+}
+
+uint8_t TimeAlign_Sample(const TimeAlign_t *ta, uint32_t t_us, TimeAlign_Frame_t *frame)
+{
+    float imu[6];
+    float baro[2];
+
+    memset(frame, 0, sizeof(*frame));
+    frame->t_us = t_us;
+
+    if (TimeAlign_SampleSensor(ta, TIME_ALIGN_IMU, t_us, imu) >= 0)
+    {
+        memcpy(frame->gyro, &imu[0], sizeof(frame->gyro));
+        memcpy(frame->accel, &imu[3], sizeof(frame->accel));
+        frame->valid |= TIME_ALIGN_VALID_IMU;
+    }
+    if (TimeAlign_SampleSensor(ta, TIME_ALIGN_MAG, t_us, frame->mag) >= 0)
+    {
+        frame->valid |= TIME_ALIGN_VALID_MAG;
+    }
+    if (TimeAlign_SampleSensor(ta, TIME_ALIGN_BARO, t_us, baro) >= 0)
+    {
+        frame->pressure_hPa = baro[0];
+        frame->baroTemp_C = baro[1];
+        frame->valid |= TIME_ALIGN_VALID_BARO;
+    }
+
+    return frame->valid;
+}
@@ -0,0 +1,154 @@
+#ifndef TIME_ALIGNMENT_H
+#define TIME_ALIGNMENT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * History depths. The IMU ring must span the configured latency at the
+ * highest ODR (64 samples = 38 ms at 1.66 kHz, 9.6 ms at 6.66 kHz); mag and
+ * baro only need the samples bracketing the aligned time.
+ */
+#define TIME_ALIGN_IMU_DEPTH 64
+#define TIME_ALIGN_MAG_DEPTH 8
+#define TIME_ALIGN_BARO_DEPTH 8
+
+    enum TimeAlign_Sensor
+    {
+        TIME_ALIGN_IMU = 0,
+        TIME_ALIGN_MAG,
+        TIME_ALIGN_BARO,
+        TIME_ALIGN_SENSOR_COUNT,
+    };
+
+#define TIME_ALIGN_VALID_IMU (1u << TIME_ALIGN_IMU)
+#define TIME_ALIGN_VALID_MAG (1u << TIME_ALIGN_MAG)
+#define TIME_ALIGN_VALID_BARO (1u << TIME_ALIGN_BARO)
+
+    typedef struct
+    {
+        uint32_t latency_us;                        ///< Aligned time lags "now" by this much
+        uint32_t maxHold_us[TIME_ALIGN_SENSOR_COUNT]; ///< Newest sample may be held this long past its timestamp
+    } TimeAlign_Config_t;
+
+    /**
+     * @brief One sensor history: timestamps plus `width` values per sample
+     */
+    typedef struct
+    {
+        uint32_t *t_us;  ///< Timestamp ring
+        float *values;   ///< Value ring, `width` floats per entry
+        uint8_t depth;   ///< Ring capacity
+        uint8_t width;   ///< Values per sample
+        uint8_t head;    ///< Next write index
+        uint8_t count;   ///< Valid entries
+    } TimeAlign_Channel_t;
+
+    /**
+     * @brief All sensors resampled to one timestamp
+     */
+    typedef struct
+    {
+        uint32_t t_us;        ///< Common timestamp
+        uint8_t valid;        ///< TIME_ALIGN_VALID_* bits
+        float gyro[3];        ///< Same units as pushed
+        float accel[3];
+        float mag[3];
+        float pressure_hPa;
+        float baroTemp_C;
+    } TimeAlign_Frame_t;
+
+    /**
+     * @brief Static storage for every history (~2.3 KB)
+     */
+    typedef struct
+    {
+        TimeAlign_Config_t config;
+        TimeAlign_Channel_t channel[TIME_ALIGN_SENSOR_COUNT];
+
+        uint32_t imuTime[TIME_ALIGN_IMU_DEPTH];
+        float imuValues[TIME_ALIGN_IMU_DEPTH * 6];
+        uint32_t magTime[TIME_ALIGN_MAG_DEPTH];
+        float magValues[TIME_ALIGN_MAG_DEPTH * 3];
+        uint32_t baroTime[TIME_ALIGN_BARO_DEPTH];
+        float baroValues[TIME_ALIGN_BARO_DEPTH * 2];
+    } TimeAlign_t;
+
+    /**
+     * @brief Initialize empty histories
+     * @param[out] ta  Pointer to alignment state
+     * @param[in]  cfg Pointer to configuration
+     * @retval  0 on success, negative on error
+     */
+    int TimeAlign_Init(TimeAlign_t *ta, const TimeAlign_Config_t *cfg);
+
+    /**
+     * @brief Record an IMU sample. Timestamps are microseconds from one
+     *        free-running counter; wrap-around is handled.
+     * @param[in,out] ta    Pointer to alignment state
+     * @param[in]     t_us  Sample timestamp
+     * @param[in]     gyro  Angular rate, 3 axes
+     * @param[in]     accel Acceleration, 3 axes
+     * @retval  0 on success, -1 if older than the previous IMU sample
+     */
+    int TimeAlign_PushImu(TimeAlign_t *ta, uint32_t t_us, const float gyro[3], const float accel[3]);
+
+    /**
+     * @brief Record a magnetometer sample
+     * @param[in,out] ta   Pointer to alignment state
+     * @param[in]     t_us Sample timestamp
+     * @param[in]     mag  Field, 3 axes
+     * @retval  0 on success, -1 if out of order
+     */
+    int TimeAlign_PushMag(TimeAlign_t *ta, uint32_t t_us, const float mag[3]);
+
+    /**
+     * @brief Record a barometer sample
+     * @param[in,out] ta           Pointer to alignment state
+     * @param[in]     t_us         Sample timestamp
+     * @param[in]     pressure_hPa Pressure
+     * @param[in]     temp_C       Sensor temperature
+     * @retval  0 on success, -1 if out of order
+     */
+    int TimeAlign_PushBaro(TimeAlign_t *ta, uint32_t t_us, float pressure_hPa, float temp_C);
+
+    /**
+     * @brief Timestamp consumers should query: now - configured latency
+     * @param[in] ta     Pointer to alignment state
+     * @param[in] now_us Current time
+     * @return Aligned timestamp
+     */
+    uint32_t TimeAlign_AlignedTime(const TimeAlign_t *ta, uint32_t now_us);
+
+    /**
+     * @brief Interpolate one sensor at t_us
+     *        Between two samples: linear interpolation. Past the newest sample:
+     *        the newest value, held up to maxHold_us. Older than the history or
+     *        held too long: no data.
+     * @param[in]  ta     Pointer to alignment state
+     * @param[in]  sensor TimeAlign_Sensor
+     * @param[in]  t_us   Query timestamp
+     * @param[out] out    Channel width values
+     * @retval  0 interpolated, 1 held, negative if no valid data
+     */
+    int TimeAlign_SampleSensor(const TimeAlign_t *ta, uint8_t sensor, uint32_t t_us, float *out);
+
+    /**
+     * @brief Resample every sensor at one timestamp
+     * @param[in]  ta    Pointer to alignment state
+     * @param[in]  t_us  Query timestamp (usually TimeAlign_AlignedTime)
+     * @param[out] frame Aligned values and validity bits
+     * @return Validity bits (same as frame->valid)
+     */
+    uint8_t TimeAlign_Sample(const TimeAlign_t *ta, uint32_t t_us, TimeAlign_Frame_t *frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TIME_ALIGNMENT_H
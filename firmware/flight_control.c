@@ -1,32 +1,219 @@
 #include "flight_control.h"
-#include <stdio.h> // just for printf examples (if you want logging)
+#include "cycle_counter.h"
+#include <math.h>
+#include <string.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL DEFINITIONS                                                       */
+/*----------------------------------------------------------------------------*/
+
+#define FLIGHT_CONTROL_TWO_PI 6.28318531f
 
 /**
- * @brief Simple example: track a dummy "altitude" and "heading".
+ * @brief Rate loop gains with the loop period folded in
  */
-static float s_altitude = 0.0f;
-static float s_heading = 0.0f;
+typedef struct
+{
+    float kp;
+    float kiDt;      ///< ki * dt
+    float kdRate;    ///< kd / dt
+    float kffRate;   ///< kff / dt
+    float iLimit;
+    float outLimit;
+} FlightControl_RateLoop_t;
 
-void FlightControl_Init(void)
+/**
+ * @brief Per-axis controller memory
+ */
+typedef struct
 {
-    // Example: Initialize variables, etc.
-    s_altitude = 0.0f;
-    s_heading = 0.0f;
+    float setpoint;     ///< Smoothed pilot setpoint
+    float integral;     ///< Integrator, output units
+    float dTerm;        ///< Low-passed derivative term
+    float prevRate;     ///< Measured rate of the previous iteration
+    float prevRateSp;   ///< Rate setpoint of the previous iteration
+    bool hasRateSp;     ///< prevRateSp holds a setpoint of the current mode
+} FlightControl_AxisState_t;
+
+static FlightControl_Config_t s_config;
+static FlightControl_RateLoop_t s_loop[FLIGHT_AXIS_COUNT];
+static FlightControl_AxisState_t s_axis[FLIGHT_AXIS_COUNT];
+static float s_dAlpha;  ///< D-term low-pass coefficient
+static float s_spAlpha; ///< Setpoint smoothing coefficient
+static uint8_t s_lastMode;
+static bool s_isInitialized = false;
+static FlightControl_Stats_t s_stats;
 
-    // In a real system, you might set up PID controllers, read config, etc.
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+static inline float FlightControl_Clamp(float v, float limit)
+{
+    return (v > limit) ? limit : ((v < -limit) ? -limit : v);
 }
 
-void FlightControl_Update(const SensorData_t *sensorData)
+/**
+ * @brief Discrete first-order low-pass coefficient for a cutoff (0 = no filtering)
+ */
+static float FlightControl_LowPassAlpha(float cutoff_Hz, float dt_s)
 {
-    if (!sensorData)
+    if (cutoff_Hz <= 0.0f)
+    {
+        return 1.0f;
+    }
+    return 1.0f - expf(-FLIGHT_CONTROL_TWO_PI * cutoff_Hz * dt_s);
+}
+
+/**
+ * @brief Inner loop: PID on rate error, D on measurement, setpoint-derivative feed-forward
+ */
+static float FlightControl_RateStep(const FlightControl_RateLoop_t *k, FlightControl_AxisState_t *s,
+                                    float rateSp, float rate)
+{
+    float err = rateSp - rate;
+
+    float p = k->kp * err;
+
+    // D on measurement so setpoint steps do not kick; low-passed
+    float dRaw = (s->prevRate - rate) * k->kdRate;
+    s->dTerm += s_dAlpha * (dRaw - s->dTerm);
+
+    // The first setpoint after arming or a mode change has no predecessor to differentiate
+    if (!s->hasRateSp)
+    {
+        s->prevRateSp = rateSp;
+        s->hasRateSp = true;
+    }
+    float ff = (rateSp - s->prevRateSp) * k->kffRate;
+
+    s->prevRate = rate;
+    s->prevRateSp = rateSp;
+
+    // Anti-windup: stop integrating while the output is saturated in the
+    // direction the error would push it; the integrator is clamped as well.
+    float u = p + s->integral + s->dTerm + ff;
+    bool saturated = (u > k->outLimit && err > 0.0f) || (u < -k->outLimit && err < 0.0f);
+    if (!saturated)
+    {
+        s->integral = FlightControl_Clamp(s->integral + k->kiDt * err, k->iLimit);
+        u = p + s->integral + s->dTerm + ff;
+    }
+
+    return FlightControl_Clamp(u, k->outLimit);
+}
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+int FlightControl_Init(const FlightControl_Config_t *cfg)
+{
+    if (!cfg || cfg->loopRate_Hz <= 0.0f)
+    {
+        return -1;
+    }
+
+    s_config = *cfg;
+    float dt = 1.0f / cfg->loopRate_Hz;
+
+    for (int i = 0; i < FLIGHT_AXIS_COUNT; i++)
+    {
+        const FlightControl_RateGains_t *g = &cfg->rate[i];
+        if (g->outLimit <= 0.0f || g->iLimit < 0.0f)
+        {
+            return -2;
+        }
+        s_loop[i].kp = g->kp;
+        s_loop[i].kiDt = g->ki * dt;
+        s_loop[i].kdRate = g->kd * cfg->loopRate_Hz;
+        s_loop[i].kffRate = g->kff * cfg->loopRate_Hz;
+        s_loop[i].iLimit = g->iLimit;
+        s_loop[i].outLimit = g->outLimit;
+    }
+
+    s_dAlpha = FlightControl_LowPassAlpha(cfg->dTermCutoff_Hz, dt);
+    s_spAlpha = FlightControl_LowPassAlpha(cfg->setpointCutoff_Hz, dt);
+
+    FlightControl_Reset();
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_isInitialized = true;
+
+    return 0;
+}
+
+void FlightControl_Reset(void)
+{
+    memset(s_axis, 0, sizeof(s_axis));
+    s_lastMode = FLIGHT_MODE_RATE;
+}
+
+void FlightControl_Update(const FlightControl_State_t *state, const FlightControl_Setpoint_t *setpoint,
+                          FlightControl_Output_t *out)
+{
+    if (!s_isInitialized || !state || !setpoint || !out)
+    {
+        return;
+    }
+
+    uint32_t start = CycleCounter_Read();
+
+    if (!setpoint->armed)
+    {
+        // Keep the measurement history current so arming does not kick the D-term
+        FlightControl_Reset();
+        for (int i = 0; i < FLIGHT_AXIS_COUNT; i++)
+        {
+            s_axis[i].prevRate = state->rate_rads[i];
+            out->torque[i] = 0.0f;
+        }
+        out->throttle = 0.0f;
+        s_stats.lastCycles = CycleCounter_Read() - start;
         return;
+    }
+
+    // Setpoint units change with the mode: restart smoothing from the new command
+    float raw[FLIGHT_AXIS_COUNT] = {setpoint->roll, setpoint->pitch, setpoint->yawRate_rads};
+    if (setpoint->mode != s_lastMode)
+    {
+        s_lastMode = setpoint->mode;
+        s_axis[FLIGHT_AXIS_ROLL].setpoint = raw[FLIGHT_AXIS_ROLL];
+        s_axis[FLIGHT_AXIS_PITCH].setpoint = raw[FLIGHT_AXIS_PITCH];
+        s_axis[FLIGHT_AXIS_ROLL].hasRateSp = false;
+        s_axis[FLIGHT_AXIS_PITCH].hasRateSp = false;
+    }
 
-    // Dummy logic: just update altitude/heading from sensor data
-    // This does nothing meaningful – purely illustrative
-    s_altitude = sensorData->dummy1 * 1.5f;
-    s_heading = sensorData->dummy2 * 2.0f;
+    for (int i = 0; i < FLIGHT_AXIS_COUNT; i++)
+    {
+        FlightControl_AxisState_t *s = &s_axis[i];
+        s->setpoint += s_spAlpha * (raw[i] - s->setpoint);
 
-    // Optional: do something with s_altitude and s_heading
-    // e.g., print them (if you have a UART printf or semihosting)
-    // printf("Altitude: %.2f, Heading: %.2f\r\n", s_altitude, s_heading);
+        float rateSp;
+        if (setpoint->mode == FLIGHT_MODE_ANGLE && i != FLIGHT_AXIS_YAW)
+        {
+            // Outer loop: P on angle error
+            float angleSp = FlightControl_Clamp(s->setpoint, s_config.maxAngle_rad);
+            rateSp = s_config.angleKp[i] * (angleSp - state->attitude_rad[i]);
+        }
+        else
+        {
+            rateSp = s->setpoint;
+        }
+        rateSp = FlightControl_Clamp(rateSp, s_config.maxRate_rads[i]);
+
+        out->torque[i] = FlightControl_RateStep(&s_loop[i], s, rateSp, state->rate_rads[i]);
+    }
+    out->throttle = setpoint->throttle;
+
+    uint32_t cycles = CycleCounter_Read() - start;
+    s_stats.lastCycles = cycles;
+    if (cycles > s_stats.maxCycles)
+    {
+        s_stats.maxCycles = cycles;
+    }
+}
+
+const FlightControl_Stats_t *FlightControl_GetStats(void)
+{
+    return &s_stats;
 }
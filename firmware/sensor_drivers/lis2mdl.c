@@ -185,4 +185,29 @@ int LIS2MDL_ReadMagneticRaw(LIS2MDL_Handle_t *dev, LIS2MDL_Mag_Raw *mag)
     mag->z = (int16_t)((rawData[5] << 8) | rawData[4]);
 
     return 0;
-}
\ No newline at end of file
+}
+
+int LIS2MDL_SetHardIronOffset(LIS2MDL_Handle_t *dev, const LIS2MDL_Mag_Raw *offset)
+{
+    if (!dev || !offset)
+    {
+        return -1;
+    }
+
+    uint8_t rawData[6] = {
+        (uint8_t)(offset->x & 0xFF), (uint8_t)((uint16_t)offset->x >> 8),
+        (uint8_t)(offset->y & 0xFF), (uint8_t)((uint16_t)offset->y >> 8),
+        (uint8_t)(offset->z & 0xFF), (uint8_t)((uint16_t)offset->z >> 8),
+    };
+
+    // Written one register at a time like the output registers are read
+    for (uint8_t i = 0; i < 6; i++)
+    {
+        if (LIS2MDL_WriteReg(dev, LIS2MDL_REG_OFFSET_X_L + i, &rawData[i], 1) != 0)
+        {
+            return -2;
+        }
+    }
+
+    return 0;
+}
@@ -16,6 +16,13 @@ extern "C"
 #define LIS2MDL_REG_WHO_AM_I 0x4F
 #define LIS2MDL_WHO_AM_I_VAL 0x40
 
+#define LIS2MDL_REG_OFFSET_X_L 0x45
+#define LIS2MDL_REG_OFFSET_X_H 0x46
+#define LIS2MDL_REG_OFFSET_Y_L 0x47
+#define LIS2MDL_REG_OFFSET_Y_H 0x48
+#define LIS2MDL_REG_OFFSET_Z_L 0x49
+#define LIS2MDL_REG_OFFSET_Z_H 0x4A
+
 #define LIS2MDL_REG_OUTX_L 0x68
 #define LIS2MDL_REG_OUTX_H 0x69
 #define LIS2MDL_REG_OUTY_L 0x6A
@@ -27,6 +34,8 @@ extern "C"
 #define LIS2MDL_CFG_REG_B 0x61
 #define LIS2MDL_CFG_REG_C 0x62
 
+#define LIS2MDL_SENS_MGAUSS 1.5f // mgauss/LSB, also the unit of the offset registers
+
     typedef struct
     {
         int dummy;
@@ -99,6 +108,14 @@ extern "C"
      */
     int LIS2MDL_ReadMagneticRaw(LIS2MDL_Handle_t *dev, LIS2MDL_Mag_Raw *mag);
 
+    /**
+     * @brief Write the hard-iron offset registers, subtracted by the sensor from every output
+     * @param[in] dev    Pointer to driver handle
+     * @param[in] offset Offset in LSB (1.5 mgauss/LSB)
+     * @retval  0 on success, negative on error
+     */
+    int LIS2MDL_SetHardIronOffset(LIS2MDL_Handle_t *dev, const LIS2MDL_Mag_Raw *offset);
+
 #ifdef __cplusplus
 }
 #endif
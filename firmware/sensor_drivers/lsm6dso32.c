@@ -161,6 +161,151 @@ int LSM6DSO32_ReadAccelRaw(LSM6DSO32_Handle_t *dev, LSM6DSO32_AccelRaw_t *accel)
     return 0;
 }
 
+int LSM6DSO32_ReadGyroRaw(LSM6DSO32_Handle_t *dev, LSM6DSO32_GyroRaw_t *gyro)
+{
+    if (!dev || !gyro)
+    {
+        return -1;
+    }
+
+    // IF_INC is set by default in CTRL3_C, so the 6 bytes come in one burst
+    uint8_t rawData[6] = {0};
+    if (LSM6DSO32_ReadReg(dev, LSM6DSO32_REG_OUTX_L_G, rawData, 6) != 0)
+    {
+        return -2;
+    }
+
+    gyro->x = (int16_t)((rawData[1] << 8) | rawData[0]);
+    gyro->y = (int16_t)((rawData[3] << 8) | rawData[2]);
+    gyro->z = (int16_t)((rawData[5] << 8) | rawData[4]);
+
+    return 0;
+}
+
+int LSM6DSO32_ReadTempRaw(LSM6DSO32_Handle_t *dev, int16_t *temp)
+{
+    if (!dev || !temp)
+    {
+        return -1;
+    }
+
+    uint8_t rawData[2] = {0};
+    if (LSM6DSO32_ReadReg(dev, LSM6DSO32_REG_OUT_TEMP_L, rawData, 2) != 0)
+    {
+        return -2;
+    }
+
+    *temp = (int16_t)((rawData[1] << 8) | rawData[0]);
+
+    return 0;
+}
+
+int LSM6DSO32_ReadAllRaw(LSM6DSO32_Handle_t *dev, int16_t *temp, LSM6DSO32_GyroRaw_t *gyro, LSM6DSO32_AccelRaw_t *accel)
+{
+    if (!dev || !temp || !gyro || !accel)
+    {
+        return -1;
+    }
+
+    // OUT_TEMP_L .. OUTZ_H_A are contiguous (0x20 .. 0x2D)
+    uint8_t rawData[14] = {0};
+    if (LSM6DSO32_ReadReg(dev, LSM6DSO32_REG_OUT_TEMP_L, rawData, 14) != 0)
+    {
+        return -2;
+    }
+
+    *temp = (int16_t)((rawData[1] << 8) | rawData[0]);
+
+    gyro->x = (int16_t)((rawData[3] << 8) | rawData[2]);
+    gyro->y = (int16_t)((rawData[5] << 8) | rawData[4]);
+    gyro->z = (int16_t)((rawData[7] << 8) | rawData[6]);
+
+    accel->x = (int16_t)((rawData[9] << 8) | rawData[8]);
+    accel->y = (int16_t)((rawData[11] << 8) | rawData[10]);
+    accel->z = (int16_t)((rawData[13] << 8) | rawData[12]);
+
+    return 0;
+}
+
+int LSM6DSO32_FifoConfig(LSM6DSO32_Handle_t *dev, uint8_t accelBdr, uint8_t gyroBdr, uint16_t watermark)
+{
+    if (!dev || watermark > LSM6DSO32_FIFO_WTM_MAX)
+    {
+        return -1;
+    }
+
+    // Bypass first so the FIFO restarts empty with the new settings
+    uint8_t ctrl4 = LSM6DSO32_FIFO_MODE_BYPASS;
+    if (LSM6DSO32_WriteReg(dev, LSM6DSO32_REG_FIFO_CTRL4, &ctrl4, 1) != 0)
+    {
+        return -2;
+    }
+
+    uint8_t ctrl[3] = {
+        (uint8_t)(watermark & 0xFF),                            // FIFO_CTRL1: WTM[7:0]
+        (uint8_t)((watermark >> 8) & 0x01),                     // FIFO_CTRL2: WTM8
+        (uint8_t)(((gyroBdr & 0x0F) << 4) | (accelBdr & 0x0F)), // FIFO_CTRL3: BDR_GY | BDR_XL
+    };
+    if (LSM6DSO32_WriteReg(dev, LSM6DSO32_REG_FIFO_CTRL1, ctrl, 3) != 0)
+    {
+        return -3;
+    }
+
+    ctrl4 = LSM6DSO32_FIFO_MODE_CONTINUOUS;
+    if (LSM6DSO32_WriteReg(dev, LSM6DSO32_REG_FIFO_CTRL4, &ctrl4, 1) != 0)
+    {
+        return -4;
+    }
+
+    return 0;
+}
+
+int LSM6DSO32_FifoLevel(LSM6DSO32_Handle_t *dev, uint16_t *level, uint8_t *flags)
+{
+    if (!dev || !level)
+    {
+        return -1;
+    }
+
+    uint8_t status[2] = {0};
+    if (LSM6DSO32_ReadReg(dev, LSM6DSO32_REG_FIFO_STATUS1, status, 2) != 0)
+    {
+        return -2;
+    }
+
+    *level = (uint16_t)(((status[1] & 0x03) << 8) | status[0]);
+    if (flags)
+    {
+        *flags = status[1] & (LSM6DSO32_FIFO_STATUS_WTM | LSM6DSO32_FIFO_STATUS_OVR | LSM6DSO32_FIFO_STATUS_FULL);
+    }
+
+    return 0;
+}
+
+int LSM6DSO32_FifoRead(LSM6DSO32_Handle_t *dev, LSM6DSO32_FifoWord_t *words, uint16_t count)
+{
+    if (!dev || !words)
+    {
+        return -1;
+    }
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        uint8_t rawData[LSM6DSO32_FIFO_WORD_SIZE] = {0};
+        if (LSM6DSO32_ReadReg(dev, LSM6DSO32_REG_FIFO_DATA_OUT_TAG, rawData, LSM6DSO32_FIFO_WORD_SIZE) != 0)
+        {
+            return -2;
+        }
+
+        words[i].tag = rawData[0] >> 3;
+        words[i].x = (int16_t)((rawData[2] << 8) | rawData[1]);
+        words[i].y = (int16_t)((rawData[4] << 8) | rawData[3]);
+        words[i].z = (int16_t)((rawData[6] << 8) | rawData[5]);
+    }
+
+    return 0;
+}
+
 int LSM6DS032_WhoIAm(LSM6DSO32_Handle_t *dev)
 {
     if (!dev)
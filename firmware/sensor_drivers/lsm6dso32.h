@@ -13,9 +13,28 @@ extern "C"
 /*----------------------------------------------------------------------------*/
 /* REGISTER DEFINITIONS (PARTIAL)                                             */
 /*----------------------------------------------------------------------------*/
+#define LSM6DSO32_REG_FIFO_CTRL1 0x07
+#define LSM6DSO32_REG_FIFO_CTRL2 0x08
+#define LSM6DSO32_REG_FIFO_CTRL3 0x09
+#define LSM6DSO32_REG_FIFO_CTRL4 0x0A
+
 #define LSM6DSO32_REG_WHO_AM_I 0x0F
 #define LSM6DSO32_REG_CTRL1_XL 0x10
 #define LSM6DSO32_REG_CTRL2_G 0x11
+#define LSM6DSO32_REG_CTRL3_C 0x12
+#define LSM6DSO32_REG_STATUS 0x1E
+
+#define LSM6DSO32_REG_OUT_TEMP_L 0x20
+#define LSM6DSO32_REG_OUT_TEMP_H 0x21
+
+#define LSM6DSO32_REG_OUTX_L_G 0x22 // first gyro data register
+#define LSM6DSO32_REG_OUTX_H_G 0x23
+
+#define LSM6DSO32_REG_OUTY_L_G 0x24
+#define LSM6DSO32_REG_OUTY_H_G 0x25
+
+#define LSM6DSO32_REG_OUTZ_L_G 0x26
+#define LSM6DSO32_REG_OUTZ_H_G 0x27
 
 #define LSM6DSO32_REG_OUTX_L_A 0x28 // first accel data register
 #define LSM6DSO32_REG_OUTX_H_A 0x29
@@ -26,8 +45,55 @@ extern "C"
 #define LSM6DSO32_REG_OUTZ_L_A 0x2C
 #define LSM6DSO32_REG_OUTZ_H_A 0x2D
 
+#define LSM6DSO32_REG_FIFO_STATUS1 0x3A
+#define LSM6DSO32_REG_FIFO_STATUS2 0x3B
+#define LSM6DSO32_REG_FIFO_DATA_OUT_TAG 0x78 // tag byte followed by X_L .. Z_H
+
 #define LSM6DSO32_WHO_AM_I_VAL 0x6C // expected WHO_AM_I value for LSM6DSO32
 
+#define LSM6DSO32_STATUS_XLDA 0x01 // accel data available
+#define LSM6DSO32_STATUS_GDA 0x02  // gyro data available
+#define LSM6DSO32_STATUS_TDA 0x04  // temperature data available
+
+// Sensitivities matching the ranges set in LSM6DSO32_Init (+-8 g, +-2000 dps)
+#define LSM6DSO32_ACCEL_SENS_8G_MG 0.244f        // mg/LSB
+#define LSM6DSO32_GYRO_SENS_2000DPS_MDPS 70.0f   // mdps/LSB
+#define LSM6DSO32_TEMP_SENS_LSB_PER_C 256.0f     // LSB/degC
+#define LSM6DSO32_TEMP_OFFSET_C 25.0f            // output is 0 at 25 degC
+
+#define LSM6DSO32_FIFO_WORD_SIZE 7     // tag + 3 axes
+#define LSM6DSO32_FIFO_WTM_MAX 511     // 9 bit watermark
+#define LSM6DSO32_FIFO_MODE_BYPASS 0x00
+#define LSM6DSO32_FIFO_MODE_CONTINUOUS 0x06
+
+#define LSM6DSO32_FIFO_STATUS_WTM 0x80  // watermark reached
+#define LSM6DSO32_FIFO_STATUS_OVR 0x40  // overrun, samples were lost
+#define LSM6DSO32_FIFO_STATUS_FULL 0x20 // next ODR cycle will overrun
+
+// TAG_SENSOR field (tag >> 3)
+#define LSM6DSO32_FIFO_TAG_GYRO 0x01
+#define LSM6DSO32_FIFO_TAG_ACCEL 0x02
+#define LSM6DSO32_FIFO_TAG_TEMP 0x03
+#define LSM6DSO32_FIFO_TAG_TIMESTAMP 0x04
+
+    /**
+     * @brief FIFO batch data rates (BDR_XL / BDR_GY codes)
+     */
+    enum LSM6DSO32_FifoBdr
+    {
+        LSM6DSO32_FIFO_BDR_OFF = 0x0,
+        LSM6DSO32_FIFO_BDR_12HZ5 = 0x1,
+        LSM6DSO32_FIFO_BDR_26HZ = 0x2,
+        LSM6DSO32_FIFO_BDR_52HZ = 0x3,
+        LSM6DSO32_FIFO_BDR_104HZ = 0x4,
+        LSM6DSO32_FIFO_BDR_208HZ = 0x5,
+        LSM6DSO32_FIFO_BDR_417HZ = 0x6,
+        LSM6DSO32_FIFO_BDR_833HZ = 0x7,
+        LSM6DSO32_FIFO_BDR_1667HZ = 0x8,
+        LSM6DSO32_FIFO_BDR_3333HZ = 0x9,
+        LSM6DSO32_FIFO_BDR_6667HZ = 0xA,
+    };
+
     /*------------------------#ifdev __cplusplusrange, etc. as needed.
      */
     typedef struct
@@ -58,6 +124,21 @@ extern "C"
         int16_t z;
     } LSM6DSO32_AccelRaw_t;
 
+    typedef struct
+    {
+        int16_t x;
+        int16_t y;
+        int16_t z;
+    } LSM6DSO32_GyroRaw_t;
+
+    typedef struct
+    {
+        uint8_t tag; ///< TAG_SENSOR (already shifted, see LSM6DSO32_FIFO_TAG_*)
+        int16_t x;
+        int16_t y;
+        int16_t z;
+    } LSM6DSO32_FifoWord_t;
+
     /*----------------------------------------------------------------------------*/
     /* PUBLIC DRIVER API                                                           */
     /*----------------------------------------------------------------------------*/
@@ -77,6 +158,60 @@ extern "C"
      */
     int LSM6DSO32_ReadAccelRaw(LSM6DSO32_Handle_t *dev, LSM6DSO32_AccelRaw_t *accel);
 
+    /**
+     * @brief Read raw gyroscope values (X,Y,Z) in one burst
+     * @param[in]  dev  Pointer to driver handle
+     * @param[out] gyro Pointer to structure that will store raw gyro data
+     * @retval  0 on success, negative on error
+     */
+    int LSM6DSO32_ReadGyroRaw(LSM6DSO32_Handle_t *dev, LSM6DSO32_GyroRaw_t *gyro);
+
+    /**
+     * @brief Read raw die temperature (256 LSB/degC, 0 at 25 degC)
+     * @param[in]  dev  Pointer to driver handle
+     * @param[out] temp Pointer to int16 data
+     * @retval  0 on success, negative on error
+     */
+    int LSM6DSO32_ReadTempRaw(LSM6DSO32_Handle_t *dev, int16_t *temp);
+
+    /**
+     * @brief Read temperature, gyro and accel in a single 14 byte burst
+     * @param[in]  dev   Pointer to driver handle
+     * @param[out] temp  Pointer to raw temperature
+     * @param[out] gyro  Pointer to raw gyro data
+     * @param[out] accel Pointer to raw accel data
+     * @retval  0 on success, negative on error
+     */
+    int LSM6DSO32_ReadAllRaw(LSM6DSO32_Handle_t *dev, int16_t *temp, LSM6DSO32_GyroRaw_t *gyro, LSM6DSO32_AccelRaw_t *accel);
+
+    /**
+     * @brief Configure FIFO batching in continuous mode
+     * @param[in] dev       Pointer to driver handle
+     * @param[in] accelBdr  Accel batch rate (enum LSM6DSO32_FifoBdr)
+     * @param[in] gyroBdr   Gyro batch rate (enum LSM6DSO32_FifoBdr)
+     * @param[in] watermark Watermark in FIFO words (max LSM6DSO32_FIFO_WTM_MAX)
+     * @retval  0 on success, negative on error
+     */
+    int LSM6DSO32_FifoConfig(LSM6DSO32_Handle_t *dev, uint8_t accelBdr, uint8_t gyroBdr, uint16_t watermark);
+
+    /**
+     * @brief Read the number of unread FIFO words and the status flags
+     * @param[in]  dev   Pointer to driver handle
+     * @param[out] level Number of words waiting
+     * @param[out] flags LSM6DSO32_FIFO_STATUS_* bits (may be NULL)
+     * @retval  0 on success, negative on error
+     */
+    int LSM6DSO32_FifoLevel(LSM6DSO32_Handle_t *dev, uint16_t *level, uint8_t *flags);
+
+    /**
+     * @brief Read words from the FIFO, one 7 byte burst per word
+     * @param[in]  dev   Pointer to driver handle
+     * @param[out] words Output array
+     * @param[in]  count Number of words to read (<= FIFO level)
+     * @retval  0 on success, negative on error
+     */
+    int LSM6DSO32_FifoRead(LSM6DSO32_Handle_t *dev, LSM6DSO32_FifoWord_t *words, uint16_t count);
+
     /**
      * @brief Read a device register
      * @param[in]  dev  Pointer to driver handle
@@ -1,29 +1,55 @@
 #include "sensor_imu.h"
-#include <stdlib.h> // for rand() if you want random data
-#include <time.h>   // if you want to seed random
+#include <stddef.h>
 
-static int s_isInitialized = 0;
+/*----------------------------------------------------------------------------*/
+/* INTERNAL DEFINITIONS                                                       */
+/*----------------------------------------------------------------------------*/
 
-int SensorIMU_Init(void)
+static LSM6DSO32_Handle_t *s_dev;
+static FlightLog_t *s_log;
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+int SensorIMU_Init(LSM6DSO32_Handle_t *dev)
 {
-    // Dummy initialization, e.g. seed a random generator
-    s_isInitialized = 1;
-    srand(12345);
+    if (!dev)
+    {
+        return -1;
+    }
 
-    return 0; // success
+    s_dev = dev;
+    s_log = NULL;
+    return 0;
 }
 
-int SensorIMU_ReadData(SensorData_t *outData)
+void SensorIMU_SetLog(FlightLog_t *log)
 {
-    if (!s_isInitialized || !outData)
-        return -1; // error if not initialized or invalid pointer
+    s_log = log;
+}
 
-    // Provide some dummy values
-    outData->dummy1 = (float)(rand() % 100) / 10.0f; // e.g. random 0..9.9
-    outData->dummy2 = (float)(rand() % 100) / 10.0f;
+int SensorIMU_Read(uint32_t time_us, SensorIMU_Sample_t *sample)
+{
+    if (!s_dev || !sample)
+    {
+        return -1;
+    }
 
-    // In a real system, you'd read actual SPI/I2C registers
-    // from the IMU, parse them, etc.
+    if (LSM6DSO32_ReadAllRaw(s_dev, &sample->temp, &sample->gyro, &sample->accel) != 0)
+    {
+        return -2;
+    }
+    sample->time_us = time_us;
 
+    if (s_log)
+    {
+        FlightLog_Imu_t rec = {
+            .temp = sample->temp,
+            .gyro = {sample->gyro.x, sample->gyro.y, sample->gyro.z},
+            .accel = {sample->accel.x, sample->accel.y, sample->accel.z},
+        };
+        FlightLog_Imu(s_log, time_us, &rec); // a drop shows up as a GAP in the log
+    }
     return 0;
 }
@@ -2,35 +2,50 @@
 #define SENSOR_IMU_H
 
 #include <stdint.h>
+#include "flight_log.h"
+#include "lsm6dso32.h"
 
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
-    /**
-     * @brief Simple struct that represents data from a mock sensor.
-     *        In a real IMU, you'd have accel, gyro, etc.
-     */
+/*
+ * Entry point of raw IMU samples into the estimators: one burst read of the
+ * LSM6DSO32 per call, stamped with the time the caller captured in the
+ * interrupt that scheduled it (INT1 data-ready EXTI, or the loop timer
+ * while INT1 is not wired). With a log attached every sample is recorded
+ * before it is handed on, so a replay sees exactly what the loop saw.
+ */
+
     typedef struct
     {
-        float dummy1;
-        float dummy2;
-        // you might have float pitch, float roll, etc. in a real IMU
-    } SensorData_t;
+        uint32_t time_us;           ///< ISR timestamp
+        int16_t temp;               ///< Raw LSB
+        LSM6DSO32_GyroRaw_t gyro;   ///< Raw LSB
+        LSM6DSO32_AccelRaw_t accel; ///< Raw LSB
+    } SensorIMU_Sample_t;
 
     /**
-     * @brief Initializes the (dummy) sensor.
+     * @brief Use an initialized device as the sample source
+     * @param[in] dev LSM6DSO32 handle (kept, not copied)
      * @return 0 if success, negative if error.
      */
-    int SensorIMU_Init(void);
+    int SensorIMU_Init(LSM6DSO32_Handle_t *dev);
 
     /**
-     * @brief Reads data from the (dummy) sensor.
-     * @param outData Pointer to a SensorData_t struct to fill with sensor values.
-     * @return 0 if success, negative if error.
+     * @brief Record every sample read from now on into a log
+     * @param[in] log Open log, NULL to stop recording
+     */
+    void SensorIMU_SetLog(FlightLog_t *log);
+
+    /**
+     * @brief Read one sample
+     * @param[in]  time_us ISR timestamp of the sample
+     * @param[out] sample  Raw sample
+     * @return 0 if success, -1 not initialized or invalid pointer, -2 bus error.
      */
-    int SensorIMU_ReadData(SensorData_t *outData);
+    int SensorIMU_Read(uint32_t time_us, SensorIMU_Sample_t *sample);
 
 #ifdef __cplusplus
 }
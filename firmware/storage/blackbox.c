@@ -0,0 +1,494 @@
+#include "blackbox.h"
+#include "cycle_counter.h"
+#include "stm32f4xx_hal.h"
+#include "telemetry_frame.h"
+#include <string.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL DEFINITIONS                                                       */
+/*----------------------------------------------------------------------------*/
+
+#define BLACKBOX_MAGIC 0x31584242u // "BBX1"
+#define BLACKBOX_ERASED 0xFFFFFFFFu
+
+// Sector header words
+#define BLACKBOX_HDR_MAGIC 0
+#define BLACKBOX_HDR_ERASE_COUNT 4
+#define BLACKBOX_HDR_SEQUENCE 8
+#define BLACKBOX_HDR_SEQUENCE_INV 12
+
+#define BLACKBOX_ALIGN4(n) (((n) + 3u) & ~3u)
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+static inline uint32_t Blackbox_Address(uint8_t sector, uint32_t offset)
+{
+    return BLACKBOX_BASE_ADDRESS + (uint32_t)sector * BLACKBOX_SECTOR_SIZE + offset;
+}
+
+static inline const uint8_t *Blackbox_Ptr(uint8_t sector, uint32_t offset)
+{
+#ifdef SILHAL_FLASH_PTR
+    return SILHAL_FLASH_PTR(Blackbox_Address(sector, offset));
+#else
+    return (const uint8_t *)(uintptr_t)Blackbox_Address(sector, offset);
+#endif
+}
+
+static inline uint32_t Blackbox_ReadWord(uint8_t sector, uint32_t offset)
+{
+    uint32_t word;
+    memcpy(&word, Blackbox_Ptr(sector, offset), sizeof(word));
+    return word;
+}
+
+/**
+ * @brief Program one word; flash must be unlocked
+ */
+static inline int Blackbox_ProgramWord(uint8_t sector, uint32_t offset, uint32_t word)
+{
+    return HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, Blackbox_Address(sector, offset), word) == HAL_OK ? 0 : -1;
+}
+
+static void Blackbox_ScanSector(Blackbox_t *bb, uint8_t sector)
+{
+    uint32_t magic = Blackbox_ReadWord(sector, BLACKBOX_HDR_MAGIC);
+    uint32_t eraseCount = Blackbox_ReadWord(sector, BLACKBOX_HDR_ERASE_COUNT);
+    uint32_t sequence = Blackbox_ReadWord(sector, BLACKBOX_HDR_SEQUENCE);
+    uint32_t inverse = Blackbox_ReadWord(sector, BLACKBOX_HDR_SEQUENCE_INV);
+
+    bb->sectorSequence[sector] = 0;
+    if (magic != BLACKBOX_MAGIC)
+    {
+        bb->state[sector] = BLACKBOX_SECTOR_DIRTY;
+        return;
+    }
+    bb->stats.eraseCount[sector] = eraseCount == BLACKBOX_ERASED ? 0 : eraseCount;
+
+    if (sequence == BLACKBOX_ERASED && inverse == BLACKBOX_ERASED)
+    {
+        bb->state[sector] = BLACKBOX_SECTOR_READY;
+    }
+    else if (sequence == ~inverse)
+    {
+        bb->state[sector] = BLACKBOX_SECTOR_USED;
+        bb->sectorSequence[sector] = sequence;
+    }
+    else
+    {
+        // Reset while the sequence was being programmed: nothing was written after it
+        bb->state[sector] = BLACKBOX_SECTOR_DIRTY;
+    }
+}
+
+/**
+ * @brief End of the blocks in a used sector: the first block header still erased
+ */
+static uint32_t Blackbox_FindEnd(uint8_t sector)
+{
+    uint32_t offset = BLACKBOX_SECTOR_HEADER_SIZE;
+    while (offset + BLACKBOX_BLOCK_HEADER_SIZE <= BLACKBOX_SECTOR_SIZE)
+    {
+        uint32_t header = Blackbox_ReadWord(sector, offset);
+        if (header == BLACKBOX_ERASED)
+        {
+            return offset;
+        }
+        uint32_t len = header & 0xFFFFu;
+        if (len == 0 || len > BLACKBOX_BLOCK_PAYLOAD_MAX)
+        {
+            // Unreadable: never write after it
+            return BLACKBOX_SECTOR_SIZE;
+        }
+        offset += BLACKBOX_ALIGN4(BLACKBOX_BLOCK_HEADER_SIZE + len);
+    }
+    return BLACKBOX_SECTOR_SIZE;
+}
+
+/**
+ * @brief Erase one sector and program its magic and erase count (blocking)
+ */
+static int Blackbox_EraseSector(Blackbox_t *bb, uint8_t sector)
+{
+    uint32_t eraseCount = bb->stats.eraseCount[sector] + 1u;
+    FLASH_EraseInitTypeDef erase = {
+        .TypeErase = FLASH_TYPEERASE_SECTORS,
+        .Banks = FLASH_BANK_1,
+        .Sector = BLACKBOX_FIRST_SECTOR + sector,
+        .NbSectors = 1,
+        .VoltageRange = FLASH_VOLTAGE_RANGE_3,
+    };
+    uint32_t sectorError;
+
+    bb->state[sector] = BLACKBOX_SECTOR_DIRTY;
+    uint32_t start = CycleCounter_Read();
+    HAL_FLASH_Unlock();
+    int ret = HAL_FLASHEx_Erase(&erase, &sectorError) == HAL_OK ? 0 : -1;
+    if (ret == 0)
+    {
+        ret = Blackbox_ProgramWord(sector, BLACKBOX_HDR_MAGIC, BLACKBOX_MAGIC);
+    }
+    if (ret == 0)
+    {
+        ret = Blackbox_ProgramWord(sector, BLACKBOX_HDR_ERASE_COUNT, eraseCount);
+    }
+    HAL_FLASH_Lock();
+    uint32_t cycles = CycleCounter_Read() - start;
+
+    bb->stats.maxEraseCycles = cycles > bb->stats.maxEraseCycles ? cycles : bb->stats.maxEraseCycles;
+    if (ret != 0)
+    {
+        bb->state[sector] = BLACKBOX_SECTOR_BAD;
+        bb->stats.errors++;
+        return -1;
+    }
+    bb->stats.eraseCount[sector] = eraseCount;
+    bb->state[sector] = BLACKBOX_SECTOR_READY;
+    return 0;
+}
+
+/**
+ * @brief Make the sector after the write sector the new write sector; flash must be unlocked
+ * @retval  0 on success, -1 if it is not erased yet
+ */
+static int Blackbox_OpenNext(Blackbox_t *bb)
+{
+    uint8_t next = (uint8_t)((bb->sector + 1u) % BLACKBOX_SECTOR_COUNT);
+    if (bb->state[next] != BLACKBOX_SECTOR_READY)
+    {
+        return -1;
+    }
+
+    uint32_t sequence = bb->sequence + 1u;
+    bb->state[next] = BLACKBOX_SECTOR_DIRTY;
+    if (Blackbox_ProgramWord(next, BLACKBOX_HDR_SEQUENCE, sequence) != 0 ||
+        Blackbox_ProgramWord(next, BLACKBOX_HDR_SEQUENCE_INV, ~sequence) != 0)
+    {
+        bb->stats.errors++;
+        return -1;
+    }
+    bb->state[next] = BLACKBOX_SECTOR_USED;
+    bb->sectorSequence[next] = sequence;
+    bb->sequence = sequence;
+    bb->sector = next;
+    bb->offset = BLACKBOX_SECTOR_HEADER_SIZE;
+    bb->writing = true;
+    return 0;
+}
+
+/**
+ * @brief Close the fill block: header, padding, queue it
+ */
+static void Blackbox_Close(Blackbox_t *bb)
+{
+    Blackbox_Block_t *b = &bb->block[bb->fill];
+    uint16_t crc = Telemetry_Crc16(0xFFFF, &b->data[BLACKBOX_BLOCK_HEADER_SIZE], b->len);
+    b->data[0] = (uint8_t)b->len;
+    b->data[1] = (uint8_t)(b->len >> 8);
+    b->data[2] = (uint8_t)crc;
+    b->data[3] = (uint8_t)(crc >> 8);
+
+    uint32_t used = BLACKBOX_BLOCK_HEADER_SIZE + b->len;
+    memset(&b->data[used], 0xFF, BLACKBOX_ALIGN4(used) - used);
+    b->queued = true;
+    bb->fill ^= 1u;
+}
+
+static inline void Blackbox_Reset(Blackbox_t *bb)
+{
+    memset(bb->block, 0, sizeof(bb->block));
+    bb->fill = 0;
+    bb->program = 0;
+    bb->programmed = 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+int Blackbox_Init(Blackbox_t *bb, const Blackbox_Config_t *cfg)
+{
+    if (!bb || !cfg || cfg->wordsPerService < 3)
+    {
+        return -1;
+    }
+
+    memset(bb, 0, sizeof(*bb));
+    bb->config = *cfg;
+
+    // Until a sector is opened, the next one in the ring is sector 0
+    bb->sector = BLACKBOX_SECTOR_COUNT - 1;
+    for (uint8_t i = 0; i < BLACKBOX_SECTOR_COUNT; i++)
+    {
+        Blackbox_ScanSector(bb, i);
+        if (bb->state[i] == BLACKBOX_SECTOR_USED && (!bb->writing || bb->sectorSequence[i] > bb->sequence))
+        {
+            bb->writing = true;
+            bb->sector = i;
+            bb->sequence = bb->sectorSequence[i];
+        }
+    }
+    if (bb->writing)
+    {
+        bb->offset = Blackbox_FindEnd(bb->sector);
+    }
+    return 0;
+}
+
+int Blackbox_Write(void *ctx, const uint8_t *data, uint16_t len)
+{
+    Blackbox_t *bb = ctx;
+    if (len == 0 || len > BLACKBOX_BLOCK_PAYLOAD_MAX)
+    {
+        bb->stats.dropped++;
+        return -1;
+    }
+
+    Blackbox_Block_t *b = &bb->block[bb->fill];
+    if (!b->queued && b->len + len > BLACKBOX_BLOCK_PAYLOAD_MAX)
+    {
+        Blackbox_Close(bb);
+        b = &bb->block[bb->fill];
+    }
+    if (b->queued)
+    {
+        // Flash is not keeping up, or there is no erased space left
+        bb->stats.dropped++;
+        return -1;
+    }
+
+    memcpy(&b->data[BLACKBOX_BLOCK_HEADER_SIZE + b->len], data, len);
+    b->len = (uint16_t)(b->len + len);
+    bb->stats.bytesLogged += len;
+    return 0;
+}
+
+void Blackbox_Flush(Blackbox_t *bb)
+{
+    const Blackbox_Block_t *b = &bb->block[bb->fill];
+    if (!b->queued && b->len > 0)
+    {
+        Blackbox_Close(bb);
+    }
+}
+
+void Blackbox_Service(Blackbox_t *bb, bool allowErase)
+{
+    uint8_t ahead = (uint8_t)((bb->sector + 1u) % BLACKBOX_SECTOR_COUNT);
+    if (allowErase && bb->state[ahead] != BLACKBOX_SECTOR_READY && bb->state[ahead] != BLACKBOX_SECTOR_BAD)
+    {
+        Blackbox_EraseSector(bb, ahead);
+    }
+
+    Blackbox_Block_t *b = &bb->block[bb->program];
+    if (!b->queued)
+    {
+        return;
+    }
+
+    uint32_t start = CycleCounter_Read();
+    uint16_t budget = bb->config.wordsPerService;
+    HAL_FLASH_Unlock();
+    while (budget > 0 && b->queued)
+    {
+        uint32_t size = BLACKBOX_ALIGN4(BLACKBOX_BLOCK_HEADER_SIZE + b->len);
+        if (bb->programmed == 0 && (!bb->writing || bb->offset + size > BLACKBOX_SECTOR_SIZE))
+        {
+            // The sequence words count against the budget
+            if (budget < 3 || Blackbox_OpenNext(bb) != 0)
+            {
+                break; // Stays queued until the sector ahead is erased
+            }
+            budget -= 2;
+        }
+
+        // Header first: after a reset the length still leads past a partial block
+        uint32_t word;
+        memcpy(&word, &b->data[bb->programmed], sizeof(word));
+        budget--;
+        if (Blackbox_ProgramWord(bb->sector, bb->offset + bb->programmed, word) != 0)
+        {
+            // Abandon the block and the rest of the sector
+            bb->stats.errors++;
+            bb->offset = BLACKBOX_SECTOR_SIZE;
+            bb->programmed = 0;
+            b->queued = false;
+            b->len = 0;
+            bb->program ^= 1u;
+            b = &bb->block[bb->program];
+            continue;
+        }
+
+        bb->programmed = (uint16_t)(bb->programmed + 4u);
+        if (bb->programmed == size)
+        {
+            bb->offset += size;
+            bb->stats.bytesProgrammed += size;
+            bb->stats.blocks++;
+            bb->programmed = 0;
+            b->queued = false;
+            b->len = 0;
+            bb->program ^= 1u;
+            b = &bb->block[bb->program];
+        }
+    }
+    HAL_FLASH_Lock();
+    uint32_t cycles = CycleCounter_Read() - start;
+    bb->stats.maxStallCycles = cycles > bb->stats.maxStallCycles ? cycles : bb->stats.maxStallCycles;
+}
+
+bool Blackbox_Idle(const Blackbox_t *bb)
+{
+    return !bb->block[0].queued && !bb->block[1].queued && bb->block[bb->fill].len == 0;
+}
+
+int Blackbox_Erase(Blackbox_t *bb)
+{
+    int ret = 0;
+    Blackbox_Reset(bb);
+    for (uint8_t i = 0; i < BLACKBOX_SECTOR_COUNT; i++)
+    {
+        if (Blackbox_EraseSector(bb, i) != 0)
+        {
+            ret = -1;
+        }
+    }
+    bb->writing = false;
+    bb->sector = BLACKBOX_SECTOR_COUNT - 1;
+    bb->offset = 0;
+    return ret;
+}
+
+void Blackbox_Rewind(const Blackbox_t *bb, Blackbox_Cursor_t *cursor)
+{
+    bool found = false;
+    cursor->sequence = 0;
+    cursor->offset = BLACKBOX_SECTOR_HEADER_SIZE;
+    cursor->position = 0;
+    for (uint8_t i = 0; i < BLACKBOX_SECTOR_COUNT; i++)
+    {
+        if (bb->state[i] == BLACKBOX_SECTOR_USED && (!found || bb->sectorSequence[i] < cursor->sequence))
+        {
+            found = true;
+            cursor->sequence = bb->sectorSequence[i];
+        }
+    }
+}
+
+int Blackbox_NextBlock(const Blackbox_t *bb, Blackbox_Cursor_t *cursor, const uint8_t **payload,
+                       uint16_t *len)
+{
+    for (;;)
+    {
+        uint8_t sector = BLACKBOX_SECTOR_COUNT;
+        for (uint8_t i = 0; i < BLACKBOX_SECTOR_COUNT; i++)
+        {
+            if (bb->state[i] == BLACKBOX_SECTOR_USED && bb->sectorSequence[i] == cursor->sequence)
+            {
+                sector = i;
+            }
+        }
+        if (sector == BLACKBOX_SECTOR_COUNT)
+        {
+            return 0;
+        }
+
+        // The write sector ends at the write position, older ones at the first erased header
+        uint32_t end = (bb->writing && sector == bb->sector) ? bb->offset : BLACKBOX_SECTOR_SIZE;
+        uint32_t header = cursor->offset + BLACKBOX_BLOCK_HEADER_SIZE <= end
+                              ? Blackbox_ReadWord(sector, cursor->offset)
+                              : BLACKBOX_ERASED;
+        if (header == BLACKBOX_ERASED)
+        {
+            cursor->sequence++;
+            cursor->offset = BLACKBOX_SECTOR_HEADER_SIZE;
+            continue;
+        }
+
+        uint16_t blockLen = (uint16_t)header;
+        uint16_t crc = (uint16_t)(header >> 16);
+        if (blockLen == 0 || blockLen > BLACKBOX_BLOCK_PAYLOAD_MAX ||
+            cursor->offset + BLACKBOX_BLOCK_HEADER_SIZE + blockLen > end)
+        {
+            // Nothing after it can be located: skip the rest of the sector
+            cursor->sequence++;
+            cursor->offset = BLACKBOX_SECTOR_HEADER_SIZE;
+            *payload = NULL;
+            *len = 0;
+            return -1;
+        }
+
+        *payload = Blackbox_Ptr(sector, cursor->offset + BLACKBOX_BLOCK_HEADER_SIZE);
+        *len = blockLen;
+        cursor->offset += BLACKBOX_ALIGN4(BLACKBOX_BLOCK_HEADER_SIZE + blockLen);
+        if (Telemetry_Crc16(0xFFFF, *payload, blockLen) != crc)
+        {
+            return -1;
+        }
+        cursor->position += blockLen;
+        return 1;
+    }
+}
+
+uint16_t Blackbox_Read(const Blackbox_t *bb, Blackbox_Cursor_t *cursor, uint32_t offset, uint8_t *out,
+                       uint16_t len)
+{
+    // A zeroed cursor (offset 0 is inside a sector header) starts at the oldest block too
+    if (offset < cursor->position || cursor->offset < BLACKBOX_SECTOR_HEADER_SIZE)
+    {
+        Blackbox_Rewind(bb, cursor);
+    }
+
+    uint16_t copied = 0;
+    while (copied < len)
+    {
+        // Look at the next block without moving past it unless it is used up
+        Blackbox_Cursor_t next = *cursor;
+        const uint8_t *payload;
+        uint16_t blockLen;
+        int ret = Blackbox_NextBlock(bb, &next, &payload, &blockLen);
+        if (ret == 0)
+        {
+            break;
+        }
+        if (ret < 0 || offset >= cursor->position + blockLen)
+        {
+            *cursor = next;
+            continue;
+        }
+
+        uint32_t skip = offset - cursor->position;
+        uint32_t n = blockLen - skip;
+        if (n > (uint32_t)(len - copied))
+        {
+            n = (uint32_t)(len - copied);
+        }
+        memcpy(&out[copied], &payload[skip], n);
+        copied = (uint16_t)(copied + n);
+        offset += n;
+        if (skip + n == blockLen)
+        {
+            *cursor = next;
+        }
+    }
+    return copied;
+}
+
+uint32_t Blackbox_Size(const Blackbox_t *bb)
+{
+    Blackbox_Cursor_t cursor;
+    const uint8_t *payload;
+    uint16_t len;
+    Blackbox_Rewind(bb, &cursor);
+    while (Blackbox_NextBlock(bb, &cursor, &payload, &len) != 0)
+    {
+    }
+    return cursor.position;
+}
+
+void Blackbox_GetStats(const Blackbox_t *bb, Blackbox_Stats_t *stats)
+{
+    *stats = bb->stats;
+}
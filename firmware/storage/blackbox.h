@@ -0,0 +1,184 @@
+#ifndef BLACKBOX_H
+#define BLACKBOX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * On-board flight recorder in the upper flash sectors (5..7, 3 x 128 KB at
+ * 0x08020000; the linker script keeps the image below them). Meant as the
+ * sink of a FlightLog.
+ *
+ * Records go into one of two RAM blocks; a full block is queued and
+ * Blackbox_Service, called from the main loop, programs a bounded number
+ * of words of it per call. The F411 has a single flash bank: while a word
+ * is programmed (~16 us) the core stalls on every fetch from flash, so
+ * wordsPerService bounds the stall per call, and with it the throughput
+ * (wordsPerService * 4 bytes per call). Erasing a 128 KB sector stalls the
+ * core for 1-2 s; it only happens in Blackbox_Service with allowErase set,
+ * one sector at a time, always the one after the write sector. The caller
+ * passes allowErase only where a stall is harmless (main.c: once at boot,
+ * before the control loop starts). A flight therefore has the erased
+ * sector ahead plus the rest of the current one; once both are full,
+ * records are dropped (and counted) instead of stalling. A sector whose
+ * erase fails is marked bad and not tried again until Blackbox_Init or
+ * Blackbox_Erase, so a failing sector costs one stall, not one per call.
+ *
+ * Flash layout: the sectors form a ring.
+ *   sector header : magic | eraseCount | sequence | ~sequence  (4 words)
+ *     magic and eraseCount are programmed right after the erase, the
+ *     sequence when the sector becomes the write sector. Each new write
+ *     sector gets the previous sequence + 1.
+ *   block         : payload length (2) | CRC-16/CCITT-FALSE of payload (2) |
+ *                   payload, padded with 0xFF to a word
+ * Records never straddle blocks. At Blackbox_Init the write position is
+ * found again from the sector with the highest sequence: the first block
+ * header still erased. Sectors are written and erased in ring order, so
+ * they wear evenly; erase counts are kept in the headers.
+ *
+ * Single producer: write from thread context only.
+ */
+#define BLACKBOX_FIRST_SECTOR 5
+#define BLACKBOX_SECTOR_COUNT 3
+#define BLACKBOX_SECTOR_SIZE (128u * 1024u)
+#define BLACKBOX_BASE_ADDRESS 0x08020000u
+#define BLACKBOX_SECTOR_HEADER_SIZE 16
+#define BLACKBOX_BLOCK_SIZE 512 // RAM block, header included
+#define BLACKBOX_BLOCK_HEADER_SIZE 4
+#define BLACKBOX_BLOCK_PAYLOAD_MAX (BLACKBOX_BLOCK_SIZE - BLACKBOX_BLOCK_HEADER_SIZE)
+
+    enum Blackbox_SectorState
+    {
+        BLACKBOX_SECTOR_DIRTY = 0, ///< Needs an erase before use
+        BLACKBOX_SECTOR_READY,     ///< Erased, no sequence yet
+        BLACKBOX_SECTOR_USED,      ///< Holds blocks of its sequence
+        BLACKBOX_SECTOR_BAD,       ///< Erase failed; left alone until Blackbox_Init or Blackbox_Erase
+    };
+
+    typedef struct
+    {
+        uint16_t wordsPerService; ///< Flash words programmed per Blackbox_Service call (>= 3)
+    } Blackbox_Config_t;
+
+    typedef struct
+    {
+        uint32_t bytesLogged;     ///< Record bytes accepted
+        uint32_t bytesProgrammed; ///< Block bytes in flash, headers and padding included
+        uint32_t blocks;          ///< Blocks programmed
+        uint32_t dropped;         ///< Records refused: both RAM blocks busy or no erased space
+        uint32_t errors;          ///< HAL_FLASH failures (the block is abandoned)
+        uint32_t maxStallCycles;  ///< Longest programming burst in one Blackbox_Service call
+        uint32_t maxEraseCycles;  ///< Longest sector erase
+        uint32_t eraseCount[BLACKBOX_SECTOR_COUNT]; ///< From the sector headers
+    } Blackbox_Stats_t;
+
+    typedef struct
+    {
+        uint8_t data[BLACKBOX_BLOCK_SIZE]; ///< Header, then payload
+        uint16_t len;                      ///< Payload bytes
+        bool queued;                       ///< Closed, waiting to be programmed
+    } Blackbox_Block_t;
+
+    typedef struct
+    {
+        Blackbox_Config_t config;
+        Blackbox_Block_t block[2];
+        uint8_t fill;                      ///< Block records go into
+        uint8_t program;                   ///< Oldest queued block
+        uint16_t programmed;               ///< Bytes of that block already in flash
+        bool writing;                      ///< A write sector is open
+        uint8_t sector;                    ///< Write sector, 0..BLACKBOX_SECTOR_COUNT-1
+        uint32_t offset;                   ///< Next free byte in the write sector
+        uint32_t sequence;                 ///< Of the write sector (or the last one)
+        uint8_t state[BLACKBOX_SECTOR_COUNT];
+        uint32_t sectorSequence[BLACKBOX_SECTOR_COUNT];
+        Blackbox_Stats_t stats;
+    } Blackbox_t;
+
+    /**
+     * @brief Position of a reader, from the oldest block to the newest
+     */
+    typedef struct
+    {
+        uint32_t sequence; ///< Sector being read
+        uint32_t offset;   ///< Next block in it
+        uint32_t position; ///< Log bytes (good block payloads) before that block
+    } Blackbox_Cursor_t;
+
+    /**
+     * @brief Scan the sectors and continue after the last block written before the reset
+     * @param[out] bb  Recorder state
+     * @param[in]  cfg Pointer to configuration (copied)
+     * @retval  0 on success, negative on error
+     */
+    int Blackbox_Init(Blackbox_t *bb, const Blackbox_Config_t *cfg);
+
+    /**
+     * @brief Append one record (FlightLog_Sink_t, ctx is the Blackbox_t)
+     * @retval  0 if stored, -1 if dropped
+     */
+    int Blackbox_Write(void *ctx, const uint8_t *data, uint16_t len);
+
+    /**
+     * @brief Queue the partly filled block, e.g. on disarm
+     */
+    void Blackbox_Flush(Blackbox_t *bb);
+
+    /**
+     * @brief Program queued data, bounded by wordsPerService; erase the sector ahead if allowed
+     * @param[in] allowErase The core may stall for a sector erase (1-2 s) now
+     */
+    void Blackbox_Service(Blackbox_t *bb, bool allowErase);
+
+    /**
+     * @brief Nothing queued or filling: everything accepted is in flash
+     */
+    bool Blackbox_Idle(const Blackbox_t *bb);
+
+    /**
+     * @brief Erase every sector (blocking, seconds) and start an empty log
+     * @retval  0 on success, negative on a flash error
+     */
+    int Blackbox_Erase(Blackbox_t *bb);
+
+    /**
+     * @brief Point a cursor at the oldest block in flash
+     */
+    void Blackbox_Rewind(const Blackbox_t *bb, Blackbox_Cursor_t *cursor);
+
+    /**
+     * @brief Next block in flash
+     * @param[out] payload Points into flash
+     * @param[out] len     Payload bytes
+     * @return 1 block, -1 block with a bad CRC (skipped over), 0 no more blocks
+     */
+    int Blackbox_NextBlock(const Blackbox_t *bb, Blackbox_Cursor_t *cursor, const uint8_t **payload,
+                           uint16_t *len);
+
+    /**
+     * @brief Read the log as one byte stream: the payloads of the good blocks, oldest first
+     * @param[in,out] cursor Kept between calls so sequential reads do not rescan; may start zeroed
+     * @param[in]     offset Stream offset
+     * @return Bytes copied, 0 at the end of the log
+     * @note Offsets stay valid while nothing is erased; appending does not move them
+     */
+    uint16_t Blackbox_Read(const Blackbox_t *bb, Blackbox_Cursor_t *cursor, uint32_t offset, uint8_t *out,
+                           uint16_t len);
+
+    /**
+     * @brief Length of the Blackbox_Read stream (walks every block)
+     */
+    uint32_t Blackbox_Size(const Blackbox_t *bb);
+
+    void Blackbox_GetStats(const Blackbox_t *bb, Blackbox_Stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BLACKBOX_H
@@ -0,0 +1,192 @@
+#include "event_capture.h"
+#include <string.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @brief Squared accel magnitude threshold in LSB^2, 0 when disabled
+ */
+static uint32_t EventCapture_Threshold(float accel_g, float scale_g)
+{
+    if (accel_g <= 0.0f)
+    {
+        return 0;
+    }
+    float lsb = accel_g / scale_g;
+    float sq = lsb * lsb;
+    return sq >= 4294967295.0f ? UINT32_MAX : (uint32_t)sq;
+}
+
+static uint8_t EventCapture_Detect(EventCapture_t *cap, const LSM6DSO32_AccelRaw_t *a)
+{
+    // 3 x 32768^2 still fits in 32 bits
+    uint32_t sq = (uint32_t)((int32_t)a->x * a->x) + (uint32_t)((int32_t)a->y * a->y) +
+                  (uint32_t)((int32_t)a->z * a->z);
+
+    if (cap->crashThreshold && sq > cap->crashThreshold)
+    {
+        return EVENT_CAPTURE_TRIGGER_CRASH;
+    }
+    if (cap->launchThreshold && !cap->launched)
+    {
+        cap->launchRun = sq > cap->launchThreshold ? (uint16_t)(cap->launchRun + 1u) : 0u;
+        if (cap->launchRun >= cap->config.launchSamples)
+        {
+            cap->launched = true;
+            return EVENT_CAPTURE_TRIGGER_LAUNCH;
+        }
+    }
+    return EVENT_CAPTURE_TRIGGER_NONE;
+}
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+int EventCapture_Init(EventCapture_t *cap, const EventCapture_Config_t *cfg)
+{
+    if (!cap || !cfg || !cfg->ring || !cfg->sink || cfg->preSamples == 0 || cfg->samplesPerService == 0 ||
+        ((cfg->launchAccel_g > 0.0f || cfg->crashAccel_g > 0.0f) && cfg->accelScale_g <= 0.0f) ||
+        (cfg->launchAccel_g > 0.0f && cfg->launchSamples == 0))
+    {
+        return -1;
+    }
+    if ((uint32_t)cfg->preSamples + cfg->postSamples > cfg->capacity)
+    {
+        return -2;
+    }
+
+    memset(cap, 0, sizeof(*cap));
+    cap->config = *cfg;
+    cap->launchThreshold = EventCapture_Threshold(cfg->launchAccel_g, cfg->accelScale_g);
+    cap->crashThreshold = EventCapture_Threshold(cfg->crashAccel_g, cfg->accelScale_g);
+    cap->state = EVENT_CAPTURE_ARMED;
+    return 0;
+}
+
+void EventCapture_Push(EventCapture_t *cap, const SensorIMU_Sample_t *sample)
+{
+    const uint32_t capacity = cap->config.capacity;
+    if (cap->state == EVENT_CAPTURE_FLUSH)
+    {
+        cap->stats.missed++;
+        return;
+    }
+
+    cap->config.ring[cap->head] = *sample;
+    cap->head = cap->head + 1u < capacity ? cap->head + 1u : 0u;
+
+    if (cap->state == EVENT_CAPTURE_POST)
+    {
+        uint32_t captured = cap->captured + 1u;
+        cap->captured = captured;
+        if (captured == (uint32_t)cap->event.preSamples + cap->event.postSamples)
+        {
+            cap->state = EVENT_CAPTURE_FLUSH;
+        }
+        return;
+    }
+
+    if (cap->count < capacity)
+    {
+        cap->count++;
+    }
+    uint8_t trigger = EventCapture_Detect(cap, &sample->accel);
+    if (trigger == EVENT_CAPTURE_TRIGGER_NONE)
+    {
+        trigger = cap->pending;
+    }
+    if (trigger == EVENT_CAPTURE_TRIGGER_NONE)
+    {
+        return;
+    }
+
+    uint32_t pre = cap->count < cap->config.preSamples ? cap->count : cap->config.preSamples;
+    cap->pending = EVENT_CAPTURE_TRIGGER_NONE;
+    cap->event.time_us = sample->time_us;
+    cap->event.trigger = trigger;
+    cap->event.preSamples = (uint16_t)pre;
+    cap->event.postSamples = cap->config.postSamples;
+    cap->start = (cap->head + capacity - pre) % capacity;
+    cap->sent = 0;
+    cap->eventSent = false;
+    cap->captured = pre;
+    cap->stats.events++;
+    cap->state = cap->config.postSamples ? EVENT_CAPTURE_POST : EVENT_CAPTURE_FLUSH;
+}
+
+int EventCapture_Trigger(EventCapture_t *cap, uint8_t trigger)
+{
+    if (cap->state != EVENT_CAPTURE_ARMED || cap->pending != EVENT_CAPTURE_TRIGGER_NONE ||
+        trigger == EVENT_CAPTURE_TRIGGER_NONE)
+    {
+        cap->stats.ignored++;
+        return -1;
+    }
+    cap->pending = trigger;
+    return 0;
+}
+
+uint32_t EventCapture_Service(EventCapture_t *cap)
+{
+    uint8_t state = cap->state;
+    if (state == EVENT_CAPTURE_ARMED)
+    {
+        return 0;
+    }
+
+    uint16_t budget = cap->config.samplesPerService;
+    if (!cap->eventSent)
+    {
+        if (cap->config.sink(cap->config.ctx, &cap->event, NULL) != 0)
+        {
+            return 0;
+        }
+        cap->eventSent = true;
+        budget--;
+    }
+
+    // Samples below captured are final; the producer only writes past them
+    uint32_t available = cap->captured;
+    uint32_t taken = 0;
+    while (budget > 0 && cap->sent < available)
+    {
+        uint32_t slot = (cap->start + cap->sent) % cap->config.capacity;
+        if (cap->config.sink(cap->config.ctx, &cap->event, &cap->config.ring[slot]) != 0)
+        {
+            break;
+        }
+        cap->sent++;
+        taken++;
+        budget--;
+    }
+    cap->stats.flushed += taken;
+
+    if (state == EVENT_CAPTURE_FLUSH && cap->sent == available)
+    {
+        // The ring restarts empty: the next pre-window is all new samples
+        cap->count = 0;
+        cap->launchRun = 0;
+        cap->state = EVENT_CAPTURE_ARMED;
+    }
+    return taken;
+}
+
+int EventCapture_LogSink(void *ctx, const EventCapture_Event_t *event, const SensorIMU_Sample_t *sample)
+{
+    FlightLog_t *log = ctx;
+    if (!sample)
+    {
+        FlightLog_Event_t record = {event->trigger, event->preSamples, event->postSamples};
+        return FlightLog_Event(log, event->time_us, &record);
+    }
+
+    FlightLog_Imu_t imu = {
+        .temp = sample->temp,
+        .gyro = {sample->gyro.x, sample->gyro.y, sample->gyro.z},
+        .accel = {sample->accel.x, sample->accel.y, sample->accel.z},
+    };
+    return FlightLog_Capture(log, sample->time_us, &imu);
+}
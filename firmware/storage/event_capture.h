@@ -0,0 +1,142 @@
+#ifndef EVENT_CAPTURE_H
+#define EVENT_CAPTURE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "flight_log.h"
+#include "sensor_imu.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Pre-trigger capture of full-rate IMU samples. While armed, every sample
+ * pushed goes into a RAM ring, overwriting the oldest. A trigger (the B1
+ * button, launch or crash seen on the accel, or any caller) freezes the last
+ * preSamples samples and keeps the next postSamples after them; the ring is
+ * sized so those never overlap. EventCapture_Service then hands the event
+ * and its samples to a sink a few at a time, from the main loop, while the
+ * flight goes on. Until the flush is complete new samples are not kept
+ * (counted in missed) and further triggers are ignored (counted).
+ *
+ * RAM: the caller provides the ring, so its size is chosen where the rest of
+ * the 128 KB of SRAM is accounted for. A sample is sizeof(SensorIMU_Sample_t)
+ * = 20 bytes: one second at 1 kHz takes 20 KB.
+ *
+ * Contexts: EventCapture_Push where the IMU is read, EventCapture_Service
+ * from the main loop, EventCapture_Trigger from anywhere (EXTI included).
+ */
+#define EVENT_CAPTURE_SAMPLES(bytes) ((bytes) / sizeof(SensorIMU_Sample_t))
+
+    enum EventCapture_Trigger
+    {
+        EVENT_CAPTURE_TRIGGER_NONE = 0,
+        EVENT_CAPTURE_TRIGGER_BUTTON,  ///< B1 (PC13)
+        EVENT_CAPTURE_TRIGGER_LAUNCH,  ///< Accel above launchAccel_g for launchSamples
+        EVENT_CAPTURE_TRIGGER_CRASH,   ///< Accel above crashAccel_g
+        EVENT_CAPTURE_TRIGGER_COMMAND, ///< Any other caller
+    };
+
+    enum EventCapture_State
+    {
+        EVENT_CAPTURE_ARMED = 0, ///< Filling the ring
+        EVENT_CAPTURE_POST,      ///< Triggered, keeping the post-window
+        EVENT_CAPTURE_FLUSH,     ///< Complete, waiting for the sink to take the rest
+    };
+
+    typedef struct
+    {
+        uint32_t time_us;     ///< Of the sample that saw the trigger
+        uint8_t trigger;      ///< enum EventCapture_Trigger
+        uint16_t preSamples;  ///< Up to the trigger sample, included; fewer if the ring was not full yet
+        uint16_t postSamples; ///< After it
+    } EventCapture_Event_t;
+
+    /**
+     * @brief Takes the event (sample NULL, first) and then each sample, oldest first
+     * @retval 0 if taken, negative to be called again with the same item on the next service
+     */
+    typedef int (*EventCapture_Sink_t)(void *ctx, const EventCapture_Event_t *event, const SensorIMU_Sample_t *sample);
+
+    typedef struct
+    {
+        SensorIMU_Sample_t *ring;   ///< Caller RAM, capacity samples
+        uint32_t capacity;          ///< >= preSamples + postSamples
+        uint16_t preSamples;        ///< Kept before the trigger, trigger sample included (> 0)
+        uint16_t postSamples;       ///< Kept after it
+        float accelScale_g;         ///< g per accel LSB
+        float launchAccel_g;        ///< Launch: |accel| above this... (0 disables)
+        uint16_t launchSamples;     ///< ...for this many samples in a row; fires once per Init
+        float crashAccel_g;         ///< Crash: one sample with |accel| above this (0 disables)
+        EventCapture_Sink_t sink;
+        void *ctx;
+        uint16_t samplesPerService; ///< Items handed to the sink per EventCapture_Service call
+    } EventCapture_Config_t;
+
+    typedef struct
+    {
+        uint32_t events;  ///< Captures started
+        uint32_t flushed; ///< Samples taken by the sink
+        uint32_t missed;  ///< Samples pushed while a capture was being flushed
+        uint32_t ignored; ///< Triggers while a capture was in progress
+    } EventCapture_Stats_t;
+
+    typedef struct
+    {
+        EventCapture_Config_t config;
+        uint32_t launchThreshold;   ///< Squared magnitude, LSB^2
+        uint32_t crashThreshold;    ///< Squared magnitude, LSB^2
+        uint16_t launchRun;         ///< Consecutive samples above launchThreshold
+        bool launched;
+        volatile uint8_t state;     ///< enum EventCapture_State
+        volatile uint8_t pending;   ///< Trigger waiting for the next sample
+        uint32_t head;              ///< Next ring slot written
+        uint32_t count;             ///< Valid samples in the ring while armed
+        uint32_t start;             ///< Ring slot of the first captured sample
+        volatile uint32_t captured; ///< Samples of the capture in the ring
+        uint32_t sent;              ///< Samples of the capture taken by the sink
+        bool eventSent;
+        EventCapture_Event_t event;
+        EventCapture_Stats_t stats;
+    } EventCapture_t;
+
+    /**
+     * @brief Arm the capture on an empty ring
+     * @param[out] cap Capture state
+     * @param[in]  cfg Pointer to configuration (copied)
+     * @retval  0 on success, -1 invalid argument, -2 windows do not fit the ring
+     */
+    int EventCapture_Init(EventCapture_t *cap, const EventCapture_Config_t *cfg);
+
+    /**
+     * @brief Keep one sample; runs the launch and crash detectors while armed
+     */
+    void EventCapture_Push(EventCapture_t *cap, const SensorIMU_Sample_t *sample);
+
+    /**
+     * @brief Request a capture; it starts at the next sample pushed
+     * @param[in] trigger enum EventCapture_Trigger
+     * @retval  0 accepted, -1 a capture is already in progress (ignored)
+     */
+    int EventCapture_Trigger(EventCapture_t *cap, uint8_t trigger);
+
+    /**
+     * @brief Hand up to samplesPerService items to the sink; re-arms once the capture is out
+     * @return Samples taken by the sink in this call
+     */
+    uint32_t EventCapture_Service(EventCapture_t *cap);
+
+    /**
+     * @brief Sink into a flight log (ctx is the FlightLog_t): an EVENT record, then CAPTURE records
+     * @return The FlightLog result: an item the log refuses is handed over again on a later service
+     *         (the refusal still counts in the log's next GAP record)
+     */
+    int EventCapture_LogSink(void *ctx, const EventCapture_Event_t *event, const SensorIMU_Sample_t *sample);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EVENT_CAPTURE_H
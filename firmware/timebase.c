@@ -0,0 +1,89 @@
+#include "timebase.h"
+#include <stddef.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL DEFINITIONS                                                       */
+/*----------------------------------------------------------------------------*/
+
+#define TIMEBASE_HZ 1000000u
+
+static uint32_t s_period_us;
+static TimeBase_TickCallback_t s_callback = NULL;
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @brief TIM5 kernel clock: PCLK1, doubled when the APB1 prescaler is not 1
+ */
+static uint32_t TimeBase_TimerClock(void)
+{
+    uint32_t pclk1 = HAL_RCC_GetPCLK1Freq();
+    return ((RCC->CFGR & RCC_CFGR_PPRE1) == 0) ? pclk1 : 2u * pclk1;
+}
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+int TimeBase_Init(void)
+{
+    uint32_t clock = TimeBase_TimerClock();
+    if (clock % TIMEBASE_HZ != 0)
+    {
+        return -1;
+    }
+
+    __HAL_RCC_TIM5_CLK_ENABLE();
+    TIM5->CR1 = 0;
+    TIM5->PSC = clock / TIMEBASE_HZ - 1u;
+    TIM5->ARR = 0xFFFFFFFFu;
+    TIM5->CNT = 0;
+    TIM5->EGR = TIM_EGR_UG; // load the prescaler now rather than at the first wrap
+    TIM5->SR = 0;
+    TIM5->CR1 = TIM_CR1_CEN;
+    return 0;
+}
+
+int TimeBase_StartTick(uint32_t period_us, uint32_t priority, TimeBase_TickCallback_t callback)
+{
+    if (period_us == 0 || !callback)
+    {
+        return -1;
+    }
+
+    s_period_us = period_us;
+    s_callback = callback;
+    TIM5->CCR1 = TimeBase_Now_us() + period_us;
+    TIM5->SR = ~TIM_SR_CC1IF;
+    TIM5->DIER |= TIM_DIER_CC1IE;
+
+    HAL_NVIC_SetPriority(TIM5_IRQn, priority, 0);
+    HAL_NVIC_EnableIRQ(TIM5_IRQn);
+    return 0;
+}
+
+void TimeBase_IrqHandler(void)
+{
+    if (!(TIM5->SR & TIM_SR_CC1IF))
+    {
+        return;
+    }
+    TIM5->SR = ~TIM_SR_CC1IF;
+
+    // The compare value is the scheduled time; the next one follows it, not the late service.
+    // A tick already in the past would only match after the wrap: skip the missed ones.
+    uint32_t tick_us = TIM5->CCR1;
+    uint32_t next = tick_us + s_period_us;
+    uint32_t late = TimeBase_Now_us() - next;
+    if ((int32_t)late >= 0)
+    {
+        next += (late / s_period_us + 1u) * s_period_us;
+    }
+    TIM5->CCR1 = next;
+    if (s_callback)
+    {
+        s_callback(tick_us);
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include <stdint.h>
+#include "stm32f4xx_hal.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Microsecond timestamps for sensor samples: TIM5, a 32-bit timer counting
+ * at 1 MHz. It wraps after 2^32 us (71.6 min), the modulus every uint32_t
+ * *_us field in the firmware already assumes, so differences stay valid
+ * across the wrap. HAL_GetTick only resolves 1 ms and the DWT cycle counter
+ * wraps after 51 s, so neither serves as a sample clock.
+ *
+ * Optional tick: channel 1 compare raises TIM5_IRQn every period_us and
+ * hands the callback the scheduled time, so the stamps keep an exact period
+ * however late the interrupt is served (a tick missed entirely is skipped).
+ * It paces sensors without a data-ready line. TIM5_IRQHandler must call
+ * TimeBase_IrqHandler.
+ */
+
+    typedef void (*TimeBase_TickCallback_t)(uint32_t tick_us);
+
+    /**
+     * @brief Start TIM5 counting microseconds from 0 (call once after SystemClock_Config)
+     * @retval  0 on success, -1 if the timer clock is not a whole number of MHz
+     */
+    int TimeBase_Init(void);
+
+    /**
+     * @brief Current time, safe from thread and interrupt context
+     */
+    static inline uint32_t TimeBase_Now_us(void)
+    {
+        return TIM5->CNT;
+    }
+
+    /**
+     * @brief Call back every period_us from the TIM5 interrupt
+     * @param[in] period_us Tick period, > 0
+     * @param[in] priority  NVIC preemption priority of TIM5_IRQn
+     * @param[in] callback  Runs in the interrupt with the scheduled tick time
+     * @retval  0 on success, -1 on error
+     */
+    int TimeBase_StartTick(uint32_t period_us, uint32_t priority, TimeBase_TickCallback_t callback);
+
+    /**
+     * @brief Interrupt entry point, call from TIM5_IRQHandler
+     */
+    void TimeBase_IrqHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TIMEBASE_H
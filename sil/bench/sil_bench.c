@@ -0,0 +1,311 @@
+#include "altitude_estimator.h"
+#include "dshot_frame.h"
+#include "flight_control.h"
+#include "imu_compress.h"
+#include "imu_filter_bank.h"
+#include "mixer.h"
+#include "sil_hal.h"
+#include "telemetry_messages.h"
+#include "vibration_analyzer.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+ * Runs the flight loop on synthetic IMU data, one iteration per simulated
+ * loop period, as fast as the host allows. Reports host time per stage and
+ * how much faster than real time the loop ran.
+ *
+ *   sil_bench [-s simulated_seconds] [-r loop_rate_Hz]
+ */
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL DEFINITIONS                                                       */
+/*----------------------------------------------------------------------------*/
+
+#define BENCH_GYRO_SCALE (0.070f * 3.14159265f / 180.0f) // ±2000 dps, rad/s per LSB
+#define BENCH_ACCEL_SCALE (0.244e-3f * 9.80665f)         // ±8 g, m/s^2 per LSB
+#define BENCH_VIBRATION_HZ 170.0f                        // motor vibration line in the synthetic gyro
+
+enum Bench_Stage
+{
+    BENCH_STAGE_FILTER = 0,
+    BENCH_STAGE_VIBRATION,
+    BENCH_STAGE_CONTROL,
+    BENCH_STAGE_MIXER,
+    BENCH_STAGE_DSHOT,
+    BENCH_STAGE_ALTITUDE,
+    BENCH_STAGE_LOGGING,
+    BENCH_STAGE_COUNT,
+};
+
+static const char *const s_stageNames[BENCH_STAGE_COUNT] = {
+    "FilterBank_Process",
+    "VibrationAnalyzer",
+    "FlightControl_Update",
+    "Mixer_Mix",
+    "DShot encode + fill",
+    "AltitudeEstimator",
+    "ImuCompress + frame",
+};
+
+typedef struct
+{
+    uint64_t ns;
+    uint64_t maxNs;
+    uint64_t calls;
+} Bench_Timer_t;
+
+static Bench_Timer_t s_timers[BENCH_STAGE_COUNT];
+
+static VibrationAnalyzer_t s_vibration;
+static FilterBank_t s_filters;
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+static uint64_t Bench_Now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void Bench_Record(enum Bench_Stage stage, uint64_t start_ns)
+{
+    uint64_t ns = Bench_Now_ns() - start_ns;
+    Bench_Timer_t *t = &s_timers[stage];
+    t->ns += ns;
+    t->calls++;
+    if (ns > t->maxNs)
+    {
+        t->maxNs = ns;
+    }
+}
+
+/**
+ * @brief Hovering airframe: gravity on z, slow attitude wander and a motor vibration line
+ */
+static void Bench_SynthImu(double t_s, LSM6DSO32_GyroRaw_t *gyro, LSM6DSO32_AccelRaw_t *accel)
+{
+    double vib = sin(2.0 * M_PI * BENCH_VIBRATION_HZ * t_s);
+    double wander = sin(2.0 * M_PI * 0.7 * t_s);
+    gyro->x = (int16_t)(300.0 * vib + 40.0 * wander + (rand() % 7 - 3));
+    gyro->y = (int16_t)(220.0 * vib - 25.0 * wander + (rand() % 7 - 3));
+    gyro->z = (int16_t)(80.0 * vib + (rand() % 7 - 3));
+    accel->x = (int16_t)(150.0 * vib + (rand() % 11 - 5));
+    accel->y = (int16_t)(120.0 * vib + (rand() % 11 - 5));
+    accel->z = (int16_t)(4096.0 + 400.0 * vib + (rand() % 11 - 5));
+}
+
+static int Bench_Init(float loopRate_Hz)
+{
+    VibrationAnalyzer_Config_t vibCfg = {loopRate_Hz, 1, BENCH_GYRO_SCALE, BENCH_ACCEL_SCALE, 40.0f};
+    FilterBank_Config_t filterCfg = {loopRate_Hz, 2, 150.0f, 30.0f, 2, 3.0f, 80.0f, 400.0f, 20.0f, 0.05f};
+    FlightControl_Config_t fcCfg;
+    Mixer_Config_t mixCfg = {true, 1.0f};
+
+    memset(&fcCfg, 0, sizeof(fcCfg));
+    fcCfg.loopRate_Hz = loopRate_Hz;
+    fcCfg.angleKp[0] = 6.0f;
+    fcCfg.angleKp[1] = 6.0f;
+    fcCfg.maxAngle_rad = 0.6f;
+    fcCfg.dTermCutoff_Hz = 100.0f;
+    fcCfg.setpointCutoff_Hz = 30.0f;
+    for (int i = 0; i < FLIGHT_AXIS_COUNT; i++)
+    {
+        fcCfg.maxRate_rads[i] = 10.0f;
+        fcCfg.rate[i] = (FlightControl_RateGains_t){0.08f, 0.4f, 0.0008f, 0.002f, 0.3f, 1.0f};
+    }
+
+    if (VibrationAnalyzer_Init(&s_vibration, &vibCfg) != 0 || FilterBank_Init(&s_filters, &filterCfg) != 0 ||
+        FlightControl_Init(&fcCfg) != 0 || Mixer_Init(&mixCfg) != 0)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+static void Bench_Usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [-s simulated_seconds] [-r loop_rate_Hz]\n", prog);
+}
+
+/*----------------------------------------------------------------------------*/
+/* MAIN                                                                       */
+/*----------------------------------------------------------------------------*/
+
+int main(int argc, char **argv)
+{
+    double seconds = 60.0;
+    float loopRate_Hz = 1000.0f;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "s:r:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 's':
+            seconds = atof(optarg);
+            break;
+        case 'r':
+            loopRate_Hz = (float)atof(optarg);
+            break;
+        default:
+            Bench_Usage(argv[0]);
+            return 2;
+        }
+    }
+    if (seconds <= 0.0 || loopRate_Hz <= 0.0f)
+    {
+        Bench_Usage(argv[0]);
+        return 2;
+    }
+
+    SilHal_Reset();
+    srand(1);
+    if (Bench_Init(loopRate_Hz) != 0)
+    {
+        fprintf(stderr, "module init failed\n");
+        return 1;
+    }
+
+    AltitudeEstimator_Config_t altCfg = {0.5f};
+    AltitudeEstimator_t alt;
+    AltitudeEstimator_Init(&alt, &altCfg);
+
+    ImuCompress_Config_t compressCfg = {IMU_COMPRESS_LINEAR, 500};
+    ImuCompress_Encoder_t compress;
+    ImuCompress_InitEncoder(&compress, &compressCfg);
+
+    DShot_BitTiming_t timing;
+    DShot_ComputeTiming(84000000u, DSHOT_SPEED_600, &timing);
+
+    const uint64_t period_us = (uint64_t)(1e6f / loopRate_Hz);
+    const uint64_t iterations = (uint64_t)(seconds * loopRate_Hz);
+    const float dt = 1.0f / loopRate_Hz;
+
+    float axisData[FILTER_BANK_AXES];
+    float *axes[FILTER_BANK_AXES];
+    for (int i = 0; i < FILTER_BANK_AXES; i++)
+    {
+        axes[i] = &axisData[i];
+    }
+
+    FlightControl_Setpoint_t setpoint = {FLIGHT_MODE_ANGLE, true, 0.0f, 0.0f, 0.0f, 0.45f};
+    FlightControl_State_t state;
+    FlightControl_Output_t command;
+    Mixer_Output_t motors;
+    uint16_t frames[MIXER_OUTPUTS];
+    static uint32_t dshotBuffer[DSHOT_BUFFER_SLOTS * MIXER_OUTPUTS];
+    uint8_t block[IMU_COMPRESS_BLOCK_MAX];
+    uint8_t encoded[TELEMETRY_MAX_ENCODED];
+    uint64_t telemetryBytes = 0;
+    uint8_t seq = 0;
+    uint32_t spectra = 0;
+    uint64_t controlCycles = 0;
+
+    memset(&state, 0, sizeof(state));
+    uint64_t wallStart = Bench_Now_ns();
+
+    for (uint64_t n = 0; n < iterations; n++)
+    {
+        double t_s = (double)SilHal_GetTime_us() * 1e-6;
+        LSM6DSO32_GyroRaw_t gyro;
+        LSM6DSO32_AccelRaw_t accel;
+        Bench_SynthImu(t_s, &gyro, &accel);
+
+        uint64_t start = Bench_Now_ns();
+        axisData[0] = gyro.x * BENCH_GYRO_SCALE;
+        axisData[1] = gyro.y * BENCH_GYRO_SCALE;
+        axisData[2] = gyro.z * BENCH_GYRO_SCALE;
+        axisData[3] = accel.x * BENCH_ACCEL_SCALE;
+        axisData[4] = accel.y * BENCH_ACCEL_SCALE;
+        axisData[5] = accel.z * BENCH_ACCEL_SCALE;
+        FilterBank_Process(&s_filters, axes, 1);
+        Bench_Record(BENCH_STAGE_FILTER, start);
+
+        // Analysis runs one stage per loop, as in the main loop; notches follow it
+        start = Bench_Now_ns();
+        VibrationAnalyzer_PushSample(&s_vibration, &gyro, &accel);
+        if (VibrationAnalyzer_Step(&s_vibration))
+        {
+            FilterBank_TrackSpectrum(&s_filters, VibrationAnalyzer_GetSpectrum(&s_vibration));
+            spectra++;
+        }
+        FilterBank_Retune(&s_filters);
+        Bench_Record(BENCH_STAGE_VIBRATION, start);
+
+        start = Bench_Now_ns();
+        for (int i = 0; i < FLIGHT_AXIS_COUNT; i++)
+        {
+            state.rate_rads[i] = axisData[i];
+        }
+        state.attitude_rad[0] += state.rate_rads[0] * dt;
+        state.attitude_rad[1] += state.rate_rads[1] * dt;
+        FlightControl_Update(&state, &setpoint, &command);
+        Bench_Record(BENCH_STAGE_CONTROL, start);
+        controlCycles += FlightControl_GetStats()->lastCycles;
+
+        start = Bench_Now_ns();
+        Mixer_Mix(command.torque, command.throttle, &motors);
+        Bench_Record(BENCH_STAGE_MIXER, start);
+
+        start = Bench_Now_ns();
+        for (int i = 0; i < MIXER_OUTPUTS; i++)
+        {
+            frames[i] = DShot_EncodeFrame(DShot_ThrottleToValue(motors.output[i]), false);
+        }
+        DShot_FillBuffer(frames, MIXER_OUTPUTS, &timing, dshotBuffer);
+        Bench_Record(BENCH_STAGE_DSHOT, start);
+
+        start = Bench_Now_ns();
+        AltitudeEstimator_Predict(&alt, axisData[5] - 9.80665f, dt);
+        if (n % 40 == 0) // 25 Hz baro at the default loop rate
+        {
+            AltitudeEstimator_UpdateBaro(&alt, 1013.25f - 0.01f * (float)(rand() % 5), 40.0f * dt);
+        }
+        Bench_Record(BENCH_STAGE_ALTITUDE, start);
+
+        start = Bench_Now_ns();
+        int16_t sample[IMU_COMPRESS_AXES] = {accel.x, accel.y, accel.z, gyro.x, gyro.y, gyro.z};
+        size_t len = ImuCompress_Push(&compress, sample, (uint32_t)SilHal_GetTime_us(), block);
+        if (len > 0)
+        {
+            telemetryBytes += Telemetry_EncodeFrame(TELEMETRY_MSG_IMU_BLOCK, seq++, block, len, encoded);
+        }
+        Bench_Record(BENCH_STAGE_LOGGING, start);
+
+        SilHal_Advance_us(period_us);
+    }
+
+    double wall_s = (double)(Bench_Now_ns() - wallStart) * 1e-9;
+    double sim_s = (double)SilHal_GetTime_us() * 1e-6;
+
+    printf("%-22s %10s %10s\n", "stage", "mean ns", "max ns");
+    for (int i = 0; i < BENCH_STAGE_COUNT; i++)
+    {
+        const Bench_Timer_t *t = &s_timers[i];
+        printf("%-22s %10.1f %10llu\n", s_stageNames[i], t->calls ? (double)t->ns / (double)t->calls : 0.0,
+               (unsigned long long)t->maxNs);
+    }
+    printf("\n%llu iterations, %.2f s simulated in %.3f s: %.0fx real time\n", (unsigned long long)iterations, sim_s,
+           wall_s, wall_s > 0.0 ? sim_s / wall_s : 0.0);
+    printf("%u spectra, %llu telemetry bytes (%.1f kB/s simulated)\n", spectra, (unsigned long long)telemetryBytes,
+           sim_s > 0.0 ? (double)telemetryBytes / sim_s / 1000.0 : 0.0);
+    printf("FlightControl_Update: %.1f cycles mean, %lu max (stand-in DWT at %lu Hz)\n",
+           iterations ? (double)controlCycles / (double)iterations : 0.0,
+           (unsigned long)FlightControl_GetStats()->maxCycles, (unsigned long)SIL_CORE_CLOCK_HZ);
+
+    // Smoke checks for the CTest run
+    if (spectra == 0 || telemetryBytes == 0 || !(motors.output[0] >= 0.0f && motors.output[0] <= 1.0f))
+    {
+        fprintf(stderr, "loop produced no output\n");
+        return 1;
+    }
+    return 0;
+}
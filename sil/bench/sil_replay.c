@@ -0,0 +1,349 @@
+#include "flight_log.h"
+#include "sim_loop.h"
+#include "sim_replay.h"
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/*
+ * Replays a flight log through the flight loop built from this tree and
+ * reports host time per stage. The outputs of every iteration can be saved
+ * (-o) and compared bit for bit against a file saved by another build (-c),
+ * which shows whether a change to a filter or the controller changes what
+ * the loop does on recorded data, and from which iteration on.
+ *
+ *   sil_replay [-o outputs] [-c reference_outputs] [-v] flight.stfl
+ *
+ * The board's own blackbox holds event captures: each captured IMU sample
+ * is an iteration, with the estimator outputs only (no LOOP record, no
+ * controller). A log with neither LOOP nor CAPTURE records has nothing to
+ * compare and fails.
+ *
+ * Exit code 1 when the outputs differ from the reference, the log is corrupt
+ * or nothing was replayed.
+ */
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL DEFINITIONS                                                       */
+/*----------------------------------------------------------------------------*/
+
+#define REPLAY_OUTPUT_MAGIC "STFR"
+#define REPLAY_OUTPUT_VERSION 1
+#define REPLAY_OUTPUT_HEADER_SIZE 8 // magic | version (2) | record size (2)
+
+typedef struct
+{
+    const char *name;
+    size_t offset;
+    int count;
+} Replay_Field_t;
+
+#define REPLAY_FIELD(f) {#f, offsetof(SimLoop_Output_t, f), (int)(sizeof(((SimLoop_Output_t *)0)->f) / sizeof(float))}
+
+// Every float of SimLoop_Output_t, in order
+static const Replay_Field_t s_fields[] = {
+    REPLAY_FIELD(q),          REPLAY_FIELD(gyro_rads), REPLAY_FIELD(accel_mps2), REPLAY_FIELD(altitude_m),
+    REPLAY_FIELD(climbRate_mps), REPLAY_FIELD(torque), REPLAY_FIELD(throttle),   REPLAY_FIELD(motors),
+};
+
+#define REPLAY_FIELD_COUNT (sizeof(s_fields) / sizeof(s_fields[0]))
+
+typedef struct
+{
+    FILE *out;
+    const SimLoop_Output_t *reference;
+    size_t referenceCount;
+    size_t index;           ///< Iterations replayed
+    size_t mismatches;      ///< Iterations that differ from the reference
+    size_t firstMismatch;
+    float maxDiff[REPLAY_FIELD_COUNT];
+    int verbose;
+} Replay_t;
+
+static SimLoop_t s_loop;
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+static uint8_t *Replay_ReadFile(const char *path, size_t *len)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f)
+    {
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *data = size > 0 ? malloc((size_t)size) : NULL;
+    if (data && fread(data, 1, (size_t)size, f) != (size_t)size)
+    {
+        free(data);
+        data = NULL;
+    }
+    fclose(f);
+    *len = data ? (size_t)size : 0;
+    return data;
+}
+
+static void Replay_PrintMismatch(size_t index, const SimLoop_Output_t *ref, const SimLoop_Output_t *out)
+{
+    printf("iteration %zu (t = %u us) differs:\n", index, out->time_us);
+    if (ref->time_us != out->time_us)
+    {
+        printf("  %-16s %u -> %u\n", "time_us", ref->time_us, out->time_us);
+    }
+    for (size_t i = 0; i < REPLAY_FIELD_COUNT; i++)
+    {
+        const float *a = (const float *)((const uint8_t *)ref + s_fields[i].offset);
+        const float *b = (const float *)((const uint8_t *)out + s_fields[i].offset);
+        for (int k = 0; k < s_fields[i].count; k++)
+        {
+            if (memcmp(&a[k], &b[k], sizeof(float)) != 0)
+            {
+                printf("  %-13s[%d] %.9g -> %.9g\n", s_fields[i].name, k, (double)a[k], (double)b[k]);
+            }
+        }
+    }
+}
+
+static void Replay_Output(void *ctx, const SimLoop_Output_t *out)
+{
+    Replay_t *r = ctx;
+    if (r->out)
+    {
+        fwrite(out, sizeof(*out), 1, r->out);
+    }
+
+    if (r->reference && r->index < r->referenceCount)
+    {
+        const SimLoop_Output_t *ref = &r->reference[r->index];
+        if (memcmp(ref, out, sizeof(*out)) != 0)
+        {
+            if (r->mismatches == 0 || r->verbose)
+            {
+                Replay_PrintMismatch(r->index, ref, out);
+            }
+            if (r->mismatches == 0)
+            {
+                r->firstMismatch = r->index;
+            }
+            r->mismatches++;
+
+            for (size_t i = 0; i < REPLAY_FIELD_COUNT; i++)
+            {
+                const float *a = (const float *)((const uint8_t *)ref + s_fields[i].offset);
+                const float *b = (const float *)((const uint8_t *)out + s_fields[i].offset);
+                for (int k = 0; k < s_fields[i].count; k++)
+                {
+                    float d = fabsf(a[k] - b[k]);
+                    r->maxDiff[i] = d > r->maxDiff[i] ? d : r->maxDiff[i];
+                }
+            }
+        }
+    }
+    r->index++;
+}
+
+/**
+ * @brief Load a reference output file written with -o
+ * @return Records, or 0 when the file is unreadable or from an incompatible build
+ */
+static size_t Replay_LoadReference(const char *path, uint8_t **file, const SimLoop_Output_t **records)
+{
+    size_t len;
+    *file = Replay_ReadFile(path, &len);
+    if (!*file || len < REPLAY_OUTPUT_HEADER_SIZE || memcmp(*file, REPLAY_OUTPUT_MAGIC, 4) != 0)
+    {
+        fprintf(stderr, "%s: not a replay output file\n", path);
+        return 0;
+    }
+    uint16_t version = (uint16_t)((*file)[4] | ((*file)[5] << 8));
+    uint16_t size = (uint16_t)((*file)[6] | ((*file)[7] << 8));
+    if (version != REPLAY_OUTPUT_VERSION || size != sizeof(SimLoop_Output_t))
+    {
+        fprintf(stderr, "%s: record layout %u/%u, this build writes %u/%zu (airframe or version differs)\n", path,
+                version, size, REPLAY_OUTPUT_VERSION, sizeof(SimLoop_Output_t));
+        return 0;
+    }
+    *records = (const SimLoop_Output_t *)(*file + REPLAY_OUTPUT_HEADER_SIZE);
+    return (len - REPLAY_OUTPUT_HEADER_SIZE) / sizeof(SimLoop_Output_t);
+}
+
+static void Replay_Usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [-o outputs] [-c reference_outputs] [-v] flight.stfl\n", prog);
+}
+
+/*----------------------------------------------------------------------------*/
+/* MAIN                                                                       */
+/*----------------------------------------------------------------------------*/
+
+int main(int argc, char **argv)
+{
+    const char *outPath = NULL;
+    const char *refPath = NULL;
+    Replay_t replay;
+    memset(&replay, 0, sizeof(replay));
+    int opt;
+
+    while ((opt = getopt(argc, argv, "o:c:vh")) != -1)
+    {
+        switch (opt)
+        {
+        case 'o':
+            outPath = optarg;
+            break;
+        case 'c':
+            refPath = optarg;
+            break;
+        case 'v':
+            replay.verbose = 1;
+            break;
+        default:
+            Replay_Usage(argv[0]);
+            return 2;
+        }
+    }
+    if (optind != argc - 1)
+    {
+        Replay_Usage(argv[0]);
+        return 2;
+    }
+
+    size_t logLen;
+    uint8_t *log = Replay_ReadFile(argv[optind], &logLen);
+    FlightLog_Reader_t reader;
+    int init = log ? FlightLog_ReaderInit(&reader, log, logLen) : -1;
+    if (init < 0)
+    {
+        fprintf(stderr, "%s: not a flight log\n", argv[optind]);
+        return 1;
+    }
+    if (init == 1)
+    {
+        // Wrapped blackbox log: the scales are unknown until the first reboot header
+        FlightLog_Record_t rec;
+        uint32_t skipped = 0;
+        int next;
+        while ((next = FlightLog_Next(&reader, &rec)) == 1 && rec.type != FLIGHT_LOG_HEADER)
+        {
+            skipped++;
+        }
+        if (next != 1)
+        {
+            fprintf(stderr, "%s: wrapped flight log without a header\n", argv[optind]);
+            return 1;
+        }
+        printf("wrapped log: %u records before the first header skipped\n", skipped);
+    }
+
+    uint8_t *refFile = NULL;
+    if (refPath)
+    {
+        replay.referenceCount = Replay_LoadReference(refPath, &refFile, &replay.reference);
+        if (!replay.reference)
+        {
+            return 1;
+        }
+    }
+
+    if (outPath)
+    {
+        replay.out = fopen(outPath, "wb");
+        if (!replay.out)
+        {
+            perror(outPath);
+            return 1;
+        }
+        uint8_t header[REPLAY_OUTPUT_HEADER_SIZE] = {'S', 'T', 'F', 'R', REPLAY_OUTPUT_VERSION, 0,
+                                                     (uint8_t)sizeof(SimLoop_Output_t),
+                                                     (uint8_t)(sizeof(SimLoop_Output_t) >> 8)};
+        fwrite(header, 1, sizeof(header), replay.out);
+    }
+
+    SimLoop_Config_t cfg;
+    SimLoop_DefaultConfig(&cfg);
+    SimReplay_Configure(&cfg, &reader.header);
+    if (SimLoop_Init(&s_loop, &cfg) != 0)
+    {
+        fprintf(stderr, "loop init failed (loop rate %.1f Hz in the header)\n", (double)reader.header.loopRate_Hz);
+        return 1;
+    }
+    s_loop.timed = true;
+
+    SimReplay_Stats_t stats;
+    int ret = SimReplay_Run(&s_loop, &reader, Replay_Output, &replay, &stats);
+    if (replay.out)
+    {
+        fclose(replay.out);
+    }
+
+    printf("%u records: %u imu, %u baro, %u mag, %u setpoints, %u loops (%.1f s at %.0f Hz)\n", stats.records,
+           stats.imu, stats.baro, stats.mag, stats.setpoints, stats.loops,
+           (double)stats.loops / (double)reader.header.loopRate_Hz, (double)reader.header.loopRate_Hz);
+    printf("%u event captures, %u captured samples\n", stats.events, stats.captures);
+    printf("%zu log bytes, %.1f per iteration\n", logLen, replay.index ? (double)logLen / replay.index : 0.0);
+    if (stats.loops == 0 && stats.captures)
+    {
+        printf("no LOOP records: the controller did not run, outputs are the estimators on the captures\n");
+    }
+    if (stats.dropped)
+    {
+        printf("%u records were dropped while recording: the replay is not exact\n", stats.dropped);
+    }
+    if (stats.reboots)
+    {
+        printf("%u reboots in the log: the loop was restarted at each\n", stats.reboots);
+    }
+
+    printf("\n%-22s %10s %10s\n", "stage", "mean ns", "max ns");
+    for (int i = 0; i < SIM_LOOP_STAGE_COUNT; i++)
+    {
+        const SimLoop_Timer_t *t = &s_loop.timers[i];
+        printf("%-22s %10.1f %10llu\n", SimLoop_StageName(i), t->calls ? (double)t->ns / (double)t->calls : 0.0,
+               (unsigned long long)t->maxNs);
+    }
+
+    int status = 0;
+    if (ret != 0)
+    {
+        fprintf(stderr, "corrupt record after %u records\n", stats.records);
+        status = 1;
+    }
+    if (replay.index == 0)
+    {
+        fprintf(stderr, "%s: no LOOP or CAPTURE records, nothing replayed\n", argv[optind]);
+        status = 1;
+    }
+    if (replay.reference)
+    {
+        if (replay.referenceCount != replay.index)
+        {
+            printf("\n%zu iterations replayed, reference has %zu\n", replay.index, replay.referenceCount);
+            status = 1;
+        }
+        if (replay.mismatches)
+        {
+            printf("\n%zu of %zu iterations differ from the reference, first at %zu; max |diff|:\n",
+                   replay.mismatches, replay.index, replay.firstMismatch);
+            for (size_t i = 0; i < REPLAY_FIELD_COUNT; i++)
+            {
+                printf("  %-16s %.9g\n", s_fields[i].name, (double)replay.maxDiff[i]);
+            }
+            status = 1;
+        }
+        else if (replay.referenceCount == replay.index && replay.index)
+        {
+            printf("\noutputs identical to the reference (%zu iterations)\n", replay.index);
+        }
+    }
+
+    free(refFile);
+    free(log);
+    return status;
+}
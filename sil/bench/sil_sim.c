@@ -0,0 +1,242 @@
+#include "flight_log.h"
+#include "sil_hal.h"
+#include "sim_flight.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+ * Monte-Carlo batches of closed-loop flights. Every run flies the same plan
+ * (take-off, angle and yaw steps under altitude hold) on a vehicle and
+ * sensors perturbed from the defaults by that run's seed, so any run can
+ * be repeated alone with -s. -l records the first run as a flight log for
+ * sil_replay.
+ *
+ *   sil_sim [-t flight_seconds] [-n runs] [-s first_seed] [-r loop_rate_Hz] [-l log] [-v]
+ */
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL DEFINITIONS                                                       */
+/*----------------------------------------------------------------------------*/
+
+#define SIM_PLAN_ALTITUDE_M 5.0f
+#define SIM_PLAN_TAKEOFF_S 3.0f // level climb before the first step
+#define SIM_PLAN_STEP_S 2.0f
+
+typedef struct
+{
+    float roll;
+    float pitch;
+    float yawRate;
+} Sim_Step_t;
+
+static const Sim_Step_t s_steps[] = {
+    {0.3f, 0.0f, 0.0f}, {-0.3f, 0.0f, 0.0f}, {0.0f, 0.3f, 0.0f},
+    {0.0f, -0.3f, 0.0f}, {0.0f, 0.0f, 1.5f}, {0.0f, 0.0f, 0.0f},
+};
+
+static SimFlight_t s_sim;
+static FlightLog_t s_log;
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+static uint64_t Sim_Now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Uniform in [-1, 1] from a per-run generator
+ */
+static float Sim_Uniform(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return (float)x * (2.0f / 4294967295.0f) - 1.0f;
+}
+
+static void Sim_Pilot(void *ctx, float time_s, SimFlight_Command_t *cmd)
+{
+    (void)ctx;
+    memset(cmd, 0, sizeof(*cmd));
+    cmd->setpoint.mode = FLIGHT_MODE_ANGLE;
+    cmd->setpoint.armed = true;
+    cmd->altitudeHold = true;
+    cmd->altitude_m = SIM_PLAN_ALTITUDE_M;
+
+    if (time_s >= SIM_PLAN_TAKEOFF_S)
+    {
+        size_t step = (size_t)((time_s - SIM_PLAN_TAKEOFF_S) / SIM_PLAN_STEP_S) % (sizeof(s_steps) / sizeof(s_steps[0]));
+        cmd->setpoint.roll = s_steps[step].roll;
+        cmd->setpoint.pitch = s_steps[step].pitch;
+        cmd->setpoint.yawRate_rads = s_steps[step].yawRate;
+    }
+}
+
+/**
+ * @brief Perturb the default vehicle and sensors with a run's seed
+ */
+static void Sim_Perturb(SimFlight_Config_t *cfg, uint32_t seed)
+{
+    uint32_t rng = seed * 2654435761u + 1u;
+    SimVehicle_Config_t *v = &cfg->vehicle;
+    SimVehicle_SensorModel_t *s = &cfg->sensors;
+
+    v->mass_kg *= 1.0f + 0.10f * Sim_Uniform(&rng);
+    for (int k = 0; k < 3; k++)
+    {
+        v->inertia_kgm2[k] *= 1.0f + 0.15f * Sim_Uniform(&rng);
+        s->gyroBias_rads[k] = 0.02f * Sim_Uniform(&rng);
+        s->accelBias_mps2[k] = 0.2f * Sim_Uniform(&rng);
+    }
+    v->maxThrust_N *= 1.0f + 0.10f * Sim_Uniform(&rng);
+    v->motorTau_s *= 1.0f + 0.25f * Sim_Uniform(&rng);
+    v->maxMotorFreq_Hz *= 1.0f + 0.15f * Sim_Uniform(&rng);
+    v->groundPressure_hPa = 990.0f + 40.0f * Sim_Uniform(&rng);
+    v->temperature_C = 25.0f + 15.0f * Sim_Uniform(&rng);
+    s->seed = seed ? seed : 1u;
+}
+
+static int Sim_FileSink(void *ctx, const uint8_t *data, uint16_t len)
+{
+    return fwrite(data, 1, len, (FILE *)ctx) == len ? 0 : -1;
+}
+
+static void Sim_Usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [-t flight_seconds] [-n runs] [-s first_seed] [-r loop_rate_Hz] [-l log] [-v]\n",
+            prog);
+}
+
+/*----------------------------------------------------------------------------*/
+/* MAIN                                                                       */
+/*----------------------------------------------------------------------------*/
+
+int main(int argc, char **argv)
+{
+    float seconds = 30.0f;
+    long runs = 10;
+    uint32_t firstSeed = 1;
+    float loopRate_Hz = 1000.0f;
+    const char *logPath = NULL;
+    int verbose = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "t:n:s:r:l:vh")) != -1)
+    {
+        switch (opt)
+        {
+        case 't':
+            seconds = (float)atof(optarg);
+            break;
+        case 'n':
+            runs = atol(optarg);
+            break;
+        case 's':
+            firstSeed = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'r':
+            loopRate_Hz = (float)atof(optarg);
+            break;
+        case 'l':
+            logPath = optarg;
+            break;
+        case 'v':
+            verbose = 1;
+            break;
+        default:
+            Sim_Usage(argv[0]);
+            return 2;
+        }
+    }
+    if (seconds <= 0.0f || runs <= 0 || loopRate_Hz <= 0.0f)
+    {
+        Sim_Usage(argv[0]);
+        return 2;
+    }
+
+    double attitudeSum = 0.0, altitudeSum = 0.0;
+    float attitudeWorst = 0.0f, altitudeWorst = 0.0f, estimatorWorst = 0.0f;
+    long crashes = 0;
+    double simSeconds = 0.0;
+    uint64_t wallStart = Sim_Now_ns();
+
+    if (verbose)
+    {
+        printf("%10s %10s %10s %10s %10s %8s %s\n", "seed", "att rms", "att max", "alt rms", "est max", "sat %",
+               "result");
+    }
+
+    for (long run = 0; run < runs; run++)
+    {
+        uint32_t seed = firstSeed + (uint32_t)run;
+        SimFlight_Config_t cfg;
+        SimFlight_DefaultConfig(&cfg);
+        cfg.loop.control.loopRate_Hz = loopRate_Hz;
+        Sim_Perturb(&cfg, seed);
+
+        if (SimFlight_Init(&s_sim, &cfg) != 0)
+        {
+            fprintf(stderr, "seed %u: init failed\n", seed);
+            return 1;
+        }
+
+        FILE *logFile = NULL;
+        if (logPath && run == 0)
+        {
+            logFile = fopen(logPath, "wb");
+            FlightLog_Config_t logCfg = {Sim_FileSink, logFile, {loopRate_Hz, cfg.loop.gyroScale, cfg.loop.accelScale}};
+            if (!logFile || FlightLog_Init(&s_log, &logCfg) != 0)
+            {
+                perror(logPath);
+                return 1;
+            }
+            SimFlight_SetLog(&s_sim, &s_log);
+        }
+
+        SimFlight_Result_t r;
+        SimFlight_Run(&s_sim, Sim_Pilot, NULL, seconds, &r);
+        if (logFile)
+        {
+            fclose(logFile);
+            SimFlight_SetLog(&s_sim, NULL);
+            printf("seed %u recorded to %s: %u records, %u bytes\n", seed, logPath, s_log.stats.records,
+                   s_log.stats.bytes);
+        }
+        simSeconds += (double)SilHal_GetTime_us() * 1e-6;
+
+        attitudeSum += r.attitudeErrorRms_rad;
+        altitudeSum += r.altitudeErrorRms_m;
+        attitudeWorst = r.attitudeErrorRms_rad > attitudeWorst ? r.attitudeErrorRms_rad : attitudeWorst;
+        altitudeWorst = r.altitudeErrorRms_m > altitudeWorst ? r.altitudeErrorRms_m : altitudeWorst;
+        estimatorWorst = r.estimatorErrorMax_m > estimatorWorst ? r.estimatorErrorMax_m : estimatorWorst;
+        crashes += r.crashed ? 1 : 0;
+
+        if (verbose || r.crashed)
+        {
+            printf("%10u %10.4f %10.4f %10.3f %10.3f %8.1f %s\n", seed, r.attitudeErrorRms_rad,
+                   r.attitudeErrorMax_rad, r.altitudeErrorRms_m, r.estimatorErrorMax_m, 100.0f * r.saturatedFraction,
+                   r.crashed ? "CRASH" : "ok");
+        }
+    }
+
+    double wall_s = (double)(Sim_Now_ns() - wallStart) * 1e-9;
+    printf("%ld runs of %.1f s: attitude rms mean %.4f rad (worst %.4f), altitude rms mean %.3f m (worst %.3f), "
+           "estimator worst %.3f m, %ld crashed\n",
+           runs, seconds, attitudeSum / (double)runs, attitudeWorst, altitudeSum / (double)runs, altitudeWorst,
+           estimatorWorst, crashes);
+    printf("%.1f s simulated in %.3f s: %.0fx real time\n", simSeconds, wall_s,
+           wall_s > 0.0 ? simSeconds / wall_s : 0.0);
+
+    return crashes ? 1 : 0;
+}
@@ -0,0 +1,147 @@
+#include "emu_spi.h"
+#include <math.h>
+#include <string.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+static void EmuSpi_Select(void *ctx)
+{
+    EmuSpi_t *spi = ctx;
+    spi->addressed = false;
+    spi->counted = false;
+    spi->stats.transactions++;
+}
+
+static uint8_t EmuSpi_Transfer(void *ctx, uint8_t tx)
+{
+    EmuSpi_t *spi = ctx;
+
+    if (!spi->addressed)
+    {
+        spi->addressed = true;
+        spi->read = (tx & 0x80) != 0;
+        spi->addr = tx & 0x7F;
+        return 0xFF; // SDO is not driven during the address byte
+    }
+
+    if (!spi->counted)
+    {
+        spi->counted = true;
+        if (spi->read)
+        {
+            spi->stats.readTransactions++;
+        }
+        else
+        {
+            spi->stats.writeTransactions++;
+        }
+    }
+
+    uint8_t rx = 0xFF;
+    if (spi->read)
+    {
+        rx = spi->ops->read(spi->dev, spi->addr);
+        spi->stats.readBytes++;
+    }
+    else
+    {
+        spi->ops->write(spi->dev, spi->addr, tx);
+        spi->stats.writeBytes++;
+    }
+    spi->addr = spi->ops->next(spi->dev, spi->addr) & 0x7F;
+    return rx;
+}
+
+static void EmuSpi_Deselect(void *ctx)
+{
+    EmuSpi_t *spi = ctx;
+    if (spi->ops->release)
+    {
+        spi->ops->release(spi->dev);
+    }
+}
+
+static const SilHal_SpiDevice_t s_emuSpiDevice = {EmuSpi_Select, EmuSpi_Transfer, EmuSpi_Deselect};
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+void EmuSpi_Init(EmuSpi_t *spi, const EmuSpi_Ops_t *ops, void *dev)
+{
+    memset(spi, 0, sizeof(*spi));
+    spi->ops = ops;
+    spi->dev = dev;
+}
+
+int EmuSpi_Attach(EmuSpi_t *spi, SPI_HandleTypeDef *hspi, GPIO_TypeDef *csPort, uint16_t csPin)
+{
+    return SilHal_SpiAttach(hspi, csPort, csPin, &s_emuSpiDevice, spi);
+}
+
+void EmuSpi_InitOutput(EmuSpi_Output_t *out, uint8_t base, uint8_t size, uint8_t wordSize)
+{
+    memset(out, 0, sizeof(*out));
+    out->base = base;
+    out->size = (size <= EMU_SPI_OUTPUT_MAX) ? size : EMU_SPI_OUTPUT_MAX;
+    out->wordSize = wordSize;
+}
+
+void EmuSpi_OutputUpdate(EmuSpi_Output_t *out, const uint8_t *bytes, bool bdu)
+{
+    if (bdu && out->held)
+    {
+        memcpy(out->pending, bytes, out->size);
+        out->hasPending = true;
+        return;
+    }
+    memcpy(out->value, bytes, out->size);
+    out->hasPending = false;
+}
+
+uint8_t EmuSpi_OutputRead(EmuSpi_Output_t *out, uint8_t addr, bool bdu)
+{
+    uint8_t offset = addr - out->base;
+    if (bdu)
+    {
+        uint8_t word = offset / out->wordSize;
+        if (offset % out->wordSize == out->wordSize - 1)
+        {
+            out->held &= (uint8_t)~(1u << word);
+        }
+        else
+        {
+            out->held |= (uint8_t)(1u << word);
+        }
+    }
+    else
+    {
+        out->held = 0;
+    }
+    return out->value[offset];
+}
+
+void EmuSpi_OutputRelease(EmuSpi_Output_t *out)
+{
+    if (!out->held && out->hasPending)
+    {
+        memcpy(out->value, out->pending, out->size);
+        out->hasPending = false;
+    }
+}
+
+int16_t EmuSpi_ToInt16(float lsb)
+{
+    float r = roundf(lsb);
+    if (r > 32767.0f)
+    {
+        return 32767;
+    }
+    if (r < -32768.0f)
+    {
+        return -32768;
+    }
+    return (int16_t)r;
+}
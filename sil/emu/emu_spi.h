@@ -0,0 +1,121 @@
+#ifndef EMU_SPI_H
+#define EMU_SPI_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sil_hal.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * SPI front end shared by the sensor emulators: the first byte of a
+ * transaction is the address with bit 7 set for a read, every following
+ * byte reads or writes one register and moves the address as the device
+ * would. Register semantics live in the device callbacks.
+ */
+
+#define EMU_SPI_OUTPUT_MAX 8 // bytes in one output block
+
+    typedef struct
+    {
+        uint8_t (*read)(void *dev, uint8_t addr);             ///< Register read, with side effects
+        void (*write)(void *dev, uint8_t addr, uint8_t value); ///< Register write
+        uint8_t (*next)(void *dev, uint8_t addr);             ///< Address after a data byte
+        void (*release)(void *dev);                           ///< CS went high (may be NULL)
+    } EmuSpi_Ops_t;
+
+    typedef struct
+    {
+        uint32_t transactions;      ///< Chip selects
+        uint32_t readTransactions;  ///< Of which reads with at least one data byte
+        uint32_t writeTransactions; ///< Of which writes with at least one data byte
+        uint32_t readBytes;         ///< Data bytes clocked out of the device
+        uint32_t writeBytes;        ///< Data bytes written to registers
+    } EmuSpi_Stats_t;
+
+    typedef struct
+    {
+        const EmuSpi_Ops_t *ops;
+        void *dev;
+
+        uint8_t addr;    ///< Register the next data byte goes to
+        bool read;       ///< Current transaction reads
+        bool addressed;  ///< Address byte received
+        bool counted;    ///< Transaction already counted as read or write
+
+        EmuSpi_Stats_t stats;
+    } EmuSpi_t;
+
+    /**
+     * @brief Output registers with block data update (BDU).
+     *
+     * With BDU set, reading the low byte(s) of a word holds the block: samples
+     * that arrive before the high byte is read are kept back and applied when
+     * no word is half read at the end of a transaction.
+     */
+    typedef struct
+    {
+        uint8_t base;                          ///< First register of the block
+        uint8_t size;                          ///< Bytes in the block
+        uint8_t wordSize;                      ///< Bytes per word, MSB last
+        uint8_t value[EMU_SPI_OUTPUT_MAX];     ///< What the registers read
+        uint8_t pending[EMU_SPI_OUTPUT_MAX];   ///< Held back by BDU
+        bool hasPending;
+        uint8_t held;                          ///< Words with the low part read, one bit each
+    } EmuSpi_Output_t;
+
+    /**
+     * @brief Set up the front end for a device
+     */
+    void EmuSpi_Init(EmuSpi_t *spi, const EmuSpi_Ops_t *ops, void *dev);
+
+    /**
+     * @brief Connect the device to a bus and chip-select pin of the stand-in HAL
+     * @retval  0 on success, negative when the HAL has no free slot
+     */
+    int EmuSpi_Attach(EmuSpi_t *spi, SPI_HandleTypeDef *hspi, GPIO_TypeDef *csPort, uint16_t csPin);
+
+    void EmuSpi_InitOutput(EmuSpi_Output_t *out, uint8_t base, uint8_t size, uint8_t wordSize);
+
+    static inline bool EmuSpi_InOutput(const EmuSpi_Output_t *out, uint8_t addr)
+    {
+        return addr >= out->base && addr < out->base + out->size;
+    }
+
+    /**
+     * @brief New sample for the block (little-endian words)
+     */
+    void EmuSpi_OutputUpdate(EmuSpi_Output_t *out, const uint8_t *bytes, bool bdu);
+
+    /**
+     * @brief Read one byte of the block, tracking half-read words when bdu is set
+     */
+    uint8_t EmuSpi_OutputRead(EmuSpi_Output_t *out, uint8_t addr, bool bdu);
+
+    /**
+     * @brief Apply a held-back sample once no word is half read (call at CS high)
+     */
+    void EmuSpi_OutputRelease(EmuSpi_Output_t *out);
+
+    /**
+     * @brief Little-endian int16 into two register bytes
+     */
+    static inline void EmuSpi_PutInt16(uint8_t *bytes, int16_t v)
+    {
+        bytes[0] = (uint8_t)((uint16_t)v & 0xFF);
+        bytes[1] = (uint8_t)((uint16_t)v >> 8);
+    }
+
+    /**
+     * @brief Round and saturate a value in LSB to int16
+     */
+    int16_t EmuSpi_ToInt16(float lsb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EMU_SPI_H
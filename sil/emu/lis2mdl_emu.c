@@ -0,0 +1,227 @@
+#include "lis2mdl_emu.h"
+#include "lis2mdl.h"
+#include <string.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL DEFINITIONS                                                       */
+/*----------------------------------------------------------------------------*/
+
+#define LIS2MDL_EMU_REG_INT_CTRL 0x63
+#define LIS2MDL_EMU_REG_INT_THS_H 0x66
+#define LIS2MDL_EMU_REG_STATUS 0x67
+#define LIS2MDL_EMU_REG_TEMP_OUT_L 0x6E
+
+#define LIS2MDL_EMU_CFG_A_DEFAULT 0x03 // idle
+#define LIS2MDL_EMU_CFG_A_SOFT_RST 0x20
+#define LIS2MDL_EMU_CFG_A_REBOOT 0x40
+#define LIS2MDL_EMU_INT_CTRL_DEFAULT 0xE0
+
+#define LIS2MDL_EMU_MODE_CONTINUOUS 0x00
+#define LIS2MDL_EMU_MODE_SINGLE 0x01
+
+#define LIS2MDL_EMU_CFG_C_DRDY_ON_PIN 0x01
+#define LIS2MDL_EMU_CFG_C_4WSPI 0x04
+#define LIS2MDL_EMU_CFG_C_BDU 0x10
+
+#define LIS2MDL_EMU_STATUS_ZYXDA 0x0F // ZYXDA and the per-axis flags
+#define LIS2MDL_EMU_STATUS_ZYXOR 0xF0
+
+#define LIS2MDL_EMU_TEMP_LSB_PER_C 8.0f // 0 LSB at 25 degC
+#define LIS2MDL_EMU_SINGLE_DELAY_US 9400.0
+
+static const float s_odrHz[4] = {10.0f, 20.0f, 50.0f, 100.0f};
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+static void Lis2mdlEmu_Reset(Lis2mdlEmu_t *emu)
+{
+    memset(emu->reg, 0, sizeof(emu->reg));
+    emu->reg[LIS2MDL_REG_WHO_AM_I] = LIS2MDL_WHO_AM_I_VAL;
+    emu->reg[LIS2MDL_CFG_REG_A] = LIS2MDL_EMU_CFG_A_DEFAULT;
+    emu->reg[LIS2MDL_EMU_REG_INT_CTRL] = LIS2MDL_EMU_INT_CTRL_DEFAULT;
+    emu->status = 0;
+    EmuSpi_InitOutput(&emu->mag, LIS2MDL_REG_OUTX_L, 6, 2);
+    EmuSpi_InitOutput(&emu->temp, LIS2MDL_EMU_REG_TEMP_OUT_L, 2, 2);
+    emu->nextSample_us = 0.0;
+    emu->singlePending = false;
+}
+
+static bool Lis2mdlEmu_Bdu(const Lis2mdlEmu_t *emu)
+{
+    return (emu->reg[LIS2MDL_CFG_REG_C] & LIS2MDL_EMU_CFG_C_BDU) != 0;
+}
+
+static double Lis2mdlEmu_Period_us(const Lis2mdlEmu_t *emu)
+{
+    return 1e6 / s_odrHz[(emu->reg[LIS2MDL_CFG_REG_A] >> 2) & 0x03];
+}
+
+static int16_t Lis2mdlEmu_Offset(const Lis2mdlEmu_t *emu, int axis)
+{
+    uint8_t base = (uint8_t)(LIS2MDL_REG_OFFSET_X_L + 2 * axis);
+    return (int16_t)(emu->reg[base] | (emu->reg[base + 1] << 8));
+}
+
+static void Lis2mdlEmu_Sample(Lis2mdlEmu_t *emu, uint64_t time_us)
+{
+    SilProfile_Truth_t truth;
+    emu->profile->sample(emu->profile->ctx, time_us, &truth);
+
+    uint8_t data[6];
+    for (int i = 0; i < 3; i++)
+    {
+        float lsb = truth.mag_gauss[i] * 1000.0f / LIS2MDL_SENS_MGAUSS;
+        EmuSpi_PutInt16(&data[2 * i], EmuSpi_ToInt16(lsb - (float)Lis2mdlEmu_Offset(emu, i)));
+    }
+    EmuSpi_OutputUpdate(&emu->mag, data, Lis2mdlEmu_Bdu(emu));
+
+    uint8_t temp[2];
+    EmuSpi_PutInt16(temp, EmuSpi_ToInt16((truth.temperature_C - 25.0f) * LIS2MDL_EMU_TEMP_LSB_PER_C));
+    EmuSpi_OutputUpdate(&emu->temp, temp, Lis2mdlEmu_Bdu(emu));
+
+    if (emu->status & LIS2MDL_EMU_STATUS_ZYXDA)
+    {
+        emu->status |= LIS2MDL_EMU_STATUS_ZYXOR; // previous sample never read
+    }
+    emu->status |= LIS2MDL_EMU_STATUS_ZYXDA;
+    emu->samples++;
+
+    if (emu->drdyPin && (emu->reg[LIS2MDL_CFG_REG_C] & LIS2MDL_EMU_CFG_C_DRDY_ON_PIN))
+    {
+        SilHal_RaiseExti(emu->drdyPin);
+    }
+}
+
+static uint8_t Lis2mdlEmu_Read(void *dev, uint8_t addr)
+{
+    Lis2mdlEmu_t *emu = dev;
+    uint8_t v;
+
+    if (EmuSpi_InOutput(&emu->mag, addr))
+    {
+        if (addr & 0x01) // any high byte
+        {
+            emu->status = 0;
+        }
+        v = EmuSpi_OutputRead(&emu->mag, addr, Lis2mdlEmu_Bdu(emu));
+    }
+    else if (EmuSpi_InOutput(&emu->temp, addr))
+    {
+        v = EmuSpi_OutputRead(&emu->temp, addr, Lis2mdlEmu_Bdu(emu));
+    }
+    else if (addr == LIS2MDL_EMU_REG_STATUS)
+    {
+        v = emu->status;
+    }
+    else
+    {
+        v = emu->reg[addr];
+    }
+
+    // 3-wire until 4WSPI: the answer goes out on SDI, MISO stays idle
+    return (emu->reg[LIS2MDL_CFG_REG_C] & LIS2MDL_EMU_CFG_C_4WSPI) ? v : 0xFF;
+}
+
+static void Lis2mdlEmu_Write(void *dev, uint8_t addr, uint8_t value)
+{
+    Lis2mdlEmu_t *emu = dev;
+    bool writable = (addr >= LIS2MDL_REG_OFFSET_X_L && addr <= LIS2MDL_REG_OFFSET_Z_H) ||
+                    (addr >= LIS2MDL_CFG_REG_A && addr <= LIS2MDL_EMU_REG_INT_THS_H);
+    if (!writable)
+    {
+        return;
+    }
+
+    if (addr != LIS2MDL_CFG_REG_A)
+    {
+        emu->reg[addr] = value;
+        return;
+    }
+
+    if (value & (LIS2MDL_EMU_CFG_A_SOFT_RST | LIS2MDL_EMU_CFG_A_REBOOT))
+    {
+        Lis2mdlEmu_Reset(emu);
+        return;
+    }
+
+    uint8_t old = emu->reg[addr];
+    emu->reg[addr] = value;
+    switch (value & 0x03)
+    {
+    case LIS2MDL_EMU_MODE_CONTINUOUS:
+        if ((old & 0x03) != LIS2MDL_EMU_MODE_CONTINUOUS || ((old ^ value) & 0x0C))
+        {
+            emu->nextSample_us = (double)emu->now_us + Lis2mdlEmu_Period_us(emu);
+        }
+        break;
+    case LIS2MDL_EMU_MODE_SINGLE:
+        emu->nextSample_us = (double)emu->now_us + LIS2MDL_EMU_SINGLE_DELAY_US;
+        emu->singlePending = true;
+        break;
+    default:
+        emu->nextSample_us = 0.0;
+        emu->singlePending = false;
+        break;
+    }
+}
+
+static uint8_t Lis2mdlEmu_Next(void *dev, uint8_t addr)
+{
+    (void)dev;
+    return (uint8_t)(addr + 1);
+}
+
+static void Lis2mdlEmu_Release(void *dev)
+{
+    Lis2mdlEmu_t *emu = dev;
+    EmuSpi_OutputRelease(&emu->mag);
+    EmuSpi_OutputRelease(&emu->temp);
+}
+
+static const EmuSpi_Ops_t s_lis2mdlEmuOps = {
+    Lis2mdlEmu_Read,
+    Lis2mdlEmu_Write,
+    Lis2mdlEmu_Next,
+    Lis2mdlEmu_Release,
+};
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+void Lis2mdlEmu_Init(Lis2mdlEmu_t *emu, const SilProfile_t *profile)
+{
+    memset(emu, 0, sizeof(*emu));
+    EmuSpi_Init(&emu->spi, &s_lis2mdlEmuOps, emu);
+    emu->profile = profile;
+    Lis2mdlEmu_Reset(emu);
+}
+
+int Lis2mdlEmu_Attach(Lis2mdlEmu_t *emu, SPI_HandleTypeDef *hspi, GPIO_TypeDef *csPort, uint16_t csPin)
+{
+    return EmuSpi_Attach(&emu->spi, hspi, csPort, csPin);
+}
+
+void Lis2mdlEmu_Advance(Lis2mdlEmu_t *emu, uint64_t now_us)
+{
+    while (emu->nextSample_us > 0.0 && emu->nextSample_us <= (double)now_us)
+    {
+        uint64_t t = (uint64_t)emu->nextSample_us;
+        emu->now_us = t;
+        if (emu->singlePending)
+        {
+            // One measurement, then back to idle
+            emu->singlePending = false;
+            emu->nextSample_us = 0.0;
+            emu->reg[LIS2MDL_CFG_REG_A] |= 0x03;
+        }
+        else
+        {
+            emu->nextSample_us += Lis2mdlEmu_Period_us(emu);
+        }
+        Lis2mdlEmu_Sample(emu, t);
+    }
+    emu->now_us = now_us;
+}
@@ -0,0 +1,57 @@
+#ifndef LIS2MDL_EMU_H
+#define LIS2MDL_EMU_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "emu_spi.h"
+#include "sil_profile.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Register-level model of the LIS2MDL on SPI.
+ *
+ * Modelled: WHO_AM_I, CFG_REG_A mode (continuous, single, idle), ODR and
+ * SOFT_RST, CFG_REG_C BDU, 4WSPI and DRDY_on_PIN, hard-iron offset
+ * registers (subtracted from the output), STATUS_REG data-ready and
+ * overrun, the magnetic and temperature outputs. The address always
+ * auto-increments. Until 4WSPI is set the device answers on SDI only, so
+ * reads on a 4-wire bus see an idle MISO (0xFF) - as on the board.
+ * Low-pass filtering, offset cancellation and interrupts on threshold are
+ * not modelled.
+ */
+
+#define LIS2MDL_EMU_REGS 128
+
+    typedef struct
+    {
+        EmuSpi_t spi;
+        const SilProfile_t *profile;
+        uint16_t drdyPin; ///< EXTI line of DRDY, 0 when not wired
+
+        uint8_t reg[LIS2MDL_EMU_REGS]; ///< Control registers as written
+        uint8_t status;                 ///< STATUS_REG
+        EmuSpi_Output_t mag;            ///< OUTX_L .. OUTZ_H
+        EmuSpi_Output_t temp;           ///< TEMP_OUT_L/H
+
+        double nextSample_us; ///< Next sample, 0 when idle
+        bool singlePending;   ///< Single measurement requested
+
+        uint64_t now_us;
+        uint32_t samples;     ///< Samples produced since init
+    } Lis2mdlEmu_t;
+
+    void Lis2mdlEmu_Init(Lis2mdlEmu_t *emu, const SilProfile_t *profile);
+
+    int Lis2mdlEmu_Attach(Lis2mdlEmu_t *emu, SPI_HandleTypeDef *hspi, GPIO_TypeDef *csPort, uint16_t csPin);
+
+    void Lis2mdlEmu_Advance(Lis2mdlEmu_t *emu, uint64_t now_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIS2MDL_EMU_H
@@ -0,0 +1,336 @@
+#include "lps22hb_emu.h"
+#include "lps22hb.h"
+#include <math.h>
+#include <string.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL DEFINITIONS                                                       */
+/*----------------------------------------------------------------------------*/
+
+#define LPS22HB_EMU_REG_INTERRUPT_CFG 0x0B
+#define LPS22HB_EMU_REG_FIFO_CTRL 0x14
+#define LPS22HB_EMU_REG_RES_CONF 0x1A
+#define LPS22HB_EMU_REG_FIFO_STATUS 0x26
+
+#define LPS22HB_EMU_CTRL1_BDU 0x02
+#define LPS22HB_EMU_CTRL2_DEFAULT 0x10
+#define LPS22HB_EMU_CTRL2_BOOT 0x80
+#define LPS22HB_EMU_CTRL2_FIFO_EN 0x40
+#define LPS22HB_EMU_CTRL2_STOP_ON_FTH 0x20
+#define LPS22HB_EMU_CTRL2_IF_ADD_INC 0x10
+#define LPS22HB_EMU_CTRL2_SWRESET 0x04
+#define LPS22HB_EMU_CTRL2_ONE_SHOT 0x01
+#define LPS22HB_EMU_CTRL3_F_FSS5 0x20
+#define LPS22HB_EMU_CTRL3_F_FTH 0x10
+#define LPS22HB_EMU_CTRL3_F_OVR 0x08
+#define LPS22HB_EMU_CTRL3_DRDY 0x04
+
+#define LPS22HB_EMU_FIFO_MODE_BYPASS 0x0
+#define LPS22HB_EMU_FIFO_MODE_FIFO 0x1
+
+#define LPS22HB_EMU_STATUS_P_OR 0x10
+#define LPS22HB_EMU_STATUS_T_OR 0x20
+#define LPS22HB_EMU_FIFO_STATUS_FTH 0x80
+#define LPS22HB_EMU_FIFO_STATUS_OVR 0x40
+
+#define LPS22HB_EMU_PRESS_LSB_PER_HPA 4096.0f
+#define LPS22HB_EMU_TEMP_LSB_PER_C 100.0f
+#define LPS22HB_EMU_ONE_SHOT_US 10000.0
+
+static const float s_odrHz[8] = {0.0f, 1.0f, 10.0f, 25.0f, 50.0f, 75.0f};
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+static void Lps22hbEmu_Reset(Lps22hbEmu_t *emu)
+{
+    memset(emu->reg, 0, sizeof(emu->reg));
+    emu->reg[LPS22HB_REG_WHO_AM_I] = LPS22HB_WHO_AM_I_VAL;
+    emu->reg[LPS22HB_REG_CTRL_2] = LPS22HB_EMU_CTRL2_DEFAULT;
+    emu->status = 0;
+    EmuSpi_InitOutput(&emu->press, LPS22HB_REG_PRESS_OUT_XL, 3, 3);
+    EmuSpi_InitOutput(&emu->temp, LPS22HB_REG_TEMP_OUT_L, 2, 2);
+    emu->nextSample_us = 0.0;
+    emu->oneShotPending = false;
+    emu->fifoHead = 0;
+    emu->fifoLevel = 0;
+    emu->fifoOverrun = false;
+}
+
+static bool Lps22hbEmu_Bdu(const Lps22hbEmu_t *emu)
+{
+    return (emu->reg[LPS22HB_REG_CTRL_1] & LPS22HB_EMU_CTRL1_BDU) != 0;
+}
+
+static uint8_t Lps22hbEmu_FifoMode(const Lps22hbEmu_t *emu)
+{
+    if (!(emu->reg[LPS22HB_REG_CTRL_2] & LPS22HB_EMU_CTRL2_FIFO_EN))
+    {
+        return LPS22HB_EMU_FIFO_MODE_BYPASS;
+    }
+    return emu->reg[LPS22HB_EMU_REG_FIFO_CTRL] >> 5;
+}
+
+static uint8_t Lps22hbEmu_Watermark(const Lps22hbEmu_t *emu)
+{
+    return emu->reg[LPS22HB_EMU_REG_FIFO_CTRL] & 0x1F;
+}
+
+/**
+ * @brief FIFO depth: 32 slots, or the watermark with STOP_ON_FTH
+ */
+static uint8_t Lps22hbEmu_FifoDepth(const Lps22hbEmu_t *emu)
+{
+    uint8_t wtm = Lps22hbEmu_Watermark(emu);
+    if ((emu->reg[LPS22HB_REG_CTRL_2] & LPS22HB_EMU_CTRL2_STOP_ON_FTH) && wtm > 0)
+    {
+        return wtm;
+    }
+    return LPS22HB_EMU_FIFO_SLOTS;
+}
+
+static void Lps22hbEmu_Interrupt(Lps22hbEmu_t *emu, uint8_t source)
+{
+    if (emu->drdyPin && (emu->reg[LPS22HB_REG_CTRL_3] & source))
+    {
+        SilHal_RaiseExti(emu->drdyPin);
+    }
+}
+
+static void Lps22hbEmu_FifoPush(Lps22hbEmu_t *emu, const uint8_t slot[5])
+{
+    uint8_t depth = Lps22hbEmu_FifoDepth(emu);
+    if (emu->fifoLevel >= depth)
+    {
+        emu->fifoLost++;
+        emu->fifoOverrun = true;
+        Lps22hbEmu_Interrupt(emu, LPS22HB_EMU_CTRL3_F_OVR);
+        if (Lps22hbEmu_FifoMode(emu) == LPS22HB_EMU_FIFO_MODE_FIFO)
+        {
+            return; // FIFO mode stops when full
+        }
+        // Stream modes drop the oldest slot
+        emu->fifoHead = (uint8_t)((emu->fifoHead + 1) % LPS22HB_EMU_FIFO_SLOTS);
+        emu->fifoLevel--;
+    }
+
+    memcpy(emu->fifo[(emu->fifoHead + emu->fifoLevel) % LPS22HB_EMU_FIFO_SLOTS], slot, 5);
+    emu->fifoLevel++;
+
+    uint8_t wtm = Lps22hbEmu_Watermark(emu);
+    if (wtm && emu->fifoLevel == wtm)
+    {
+        Lps22hbEmu_Interrupt(emu, LPS22HB_EMU_CTRL3_F_FTH);
+    }
+    if (emu->fifoLevel == depth)
+    {
+        Lps22hbEmu_Interrupt(emu, LPS22HB_EMU_CTRL3_F_FSS5);
+    }
+}
+
+static void Lps22hbEmu_Sample(Lps22hbEmu_t *emu, uint64_t time_us)
+{
+    SilProfile_Truth_t truth;
+    emu->profile->sample(emu->profile->ctx, time_us, &truth);
+
+    int32_t p = (int32_t)lroundf(truth.pressure_hPa * LPS22HB_EMU_PRESS_LSB_PER_HPA);
+    if (p > 0x7FFFFF)
+    {
+        p = 0x7FFFFF;
+    }
+    uint8_t slot[5] = {(uint8_t)p, (uint8_t)(p >> 8), (uint8_t)(p >> 16)};
+    EmuSpi_PutInt16(&slot[3], EmuSpi_ToInt16(truth.temperature_C * LPS22HB_EMU_TEMP_LSB_PER_C));
+    emu->samples++;
+
+    if (Lps22hbEmu_FifoMode(emu) != LPS22HB_EMU_FIFO_MODE_BYPASS)
+    {
+        Lps22hbEmu_FifoPush(emu, slot);
+    }
+    else
+    {
+        EmuSpi_OutputUpdate(&emu->press, slot, Lps22hbEmu_Bdu(emu));
+        EmuSpi_OutputUpdate(&emu->temp, &slot[3], Lps22hbEmu_Bdu(emu));
+    }
+
+    if (emu->status & LPS22HB_STATUS_PRESS_READY)
+    {
+        emu->status |= LPS22HB_EMU_STATUS_P_OR;
+    }
+    if (emu->status & LPS22HB_STATUS_TEMP_READY)
+    {
+        emu->status |= LPS22HB_EMU_STATUS_T_OR;
+    }
+    emu->status |= LPS22HB_STATUS_PRESS_READY | LPS22HB_STATUS_TEMP_READY;
+    Lps22hbEmu_Interrupt(emu, LPS22HB_EMU_CTRL3_DRDY);
+}
+
+static uint8_t Lps22hbEmu_Read(void *dev, uint8_t addr)
+{
+    Lps22hbEmu_t *emu = dev;
+    bool bdu = Lps22hbEmu_Bdu(emu);
+
+    if (EmuSpi_InOutput(&emu->press, addr))
+    {
+        if (addr == LPS22HB_REG_PRESS_OUT_XL && Lps22hbEmu_FifoMode(emu) != LPS22HB_EMU_FIFO_MODE_BYPASS &&
+            emu->fifoLevel > 0)
+        {
+            // The output registers show the FIFO slot being read
+            const uint8_t *slot = emu->fifo[emu->fifoHead];
+            EmuSpi_OutputUpdate(&emu->press, slot, false);
+            EmuSpi_OutputUpdate(&emu->temp, &slot[3], false);
+            emu->fifoHead = (uint8_t)((emu->fifoHead + 1) % LPS22HB_EMU_FIFO_SLOTS);
+            emu->fifoLevel--;
+            emu->fifoOverrun = false;
+        }
+        if (addr == LPS22HB_REG_PRESS_OUT_H)
+        {
+            emu->status &= (uint8_t)~(LPS22HB_STATUS_PRESS_READY | LPS22HB_EMU_STATUS_P_OR);
+        }
+        return EmuSpi_OutputRead(&emu->press, addr, bdu);
+    }
+    if (EmuSpi_InOutput(&emu->temp, addr))
+    {
+        if (addr == LPS22HB_REG_TEMP_OUT_H)
+        {
+            emu->status &= (uint8_t)~(LPS22HB_STATUS_TEMP_READY | LPS22HB_EMU_STATUS_T_OR);
+        }
+        return EmuSpi_OutputRead(&emu->temp, addr, bdu);
+    }
+
+    switch (addr)
+    {
+    case LPS22HB_REG_STATUS:
+        return emu->status;
+
+    case LPS22HB_EMU_REG_FIFO_STATUS:
+    {
+        uint8_t wtm = Lps22hbEmu_Watermark(emu);
+        uint8_t v = emu->fifoLevel & 0x3F;
+        v |= (wtm && emu->fifoLevel >= wtm) ? LPS22HB_EMU_FIFO_STATUS_FTH : 0;
+        v |= emu->fifoOverrun ? LPS22HB_EMU_FIFO_STATUS_OVR : 0;
+        return v;
+    }
+
+    default:
+        return emu->reg[addr];
+    }
+}
+
+static void Lps22hbEmu_Write(void *dev, uint8_t addr, uint8_t value)
+{
+    Lps22hbEmu_t *emu = dev;
+    bool writable = (addr >= LPS22HB_EMU_REG_INTERRUPT_CFG && addr <= LPS22HB_REG_CTRL_3 &&
+                     addr != LPS22HB_REG_WHO_AM_I && addr != 0x0E) ||
+                    (addr >= LPS22HB_EMU_REG_FIFO_CTRL && addr <= LPS22HB_EMU_REG_RES_CONF);
+    if (!writable)
+    {
+        return;
+    }
+
+    switch (addr)
+    {
+    case LPS22HB_REG_CTRL_1:
+    {
+        uint8_t old = emu->reg[addr];
+        emu->reg[addr] = value;
+        if ((old ^ value) & 0x70) // ODR changed
+        {
+            float hz = s_odrHz[(value >> 4) & 0x07];
+            emu->nextSample_us = (hz > 0.0f) ? (double)emu->now_us + 1e6 / hz : 0.0;
+        }
+        return;
+    }
+
+    case LPS22HB_REG_CTRL_2:
+        if (value & (LPS22HB_EMU_CTRL2_SWRESET | LPS22HB_EMU_CTRL2_BOOT))
+        {
+            Lps22hbEmu_Reset(emu);
+            return;
+        }
+        if ((value & LPS22HB_EMU_CTRL2_ONE_SHOT) && s_odrHz[(emu->reg[LPS22HB_REG_CTRL_1] >> 4) & 0x07] == 0.0f)
+        {
+            emu->oneShotPending = true;
+            emu->nextSample_us = (double)emu->now_us + LPS22HB_EMU_ONE_SHOT_US;
+        }
+        if ((value ^ emu->reg[addr]) & LPS22HB_EMU_CTRL2_FIFO_EN)
+        {
+            emu->fifoHead = 0;
+            emu->fifoLevel = 0;
+            emu->fifoOverrun = false;
+        }
+        emu->reg[addr] = value & (uint8_t)~LPS22HB_EMU_CTRL2_ONE_SHOT; // self-clearing once started
+        return;
+
+    case LPS22HB_EMU_REG_FIFO_CTRL:
+        emu->reg[addr] = value;
+        if ((value >> 5) == LPS22HB_EMU_FIFO_MODE_BYPASS)
+        {
+            emu->fifoHead = 0;
+            emu->fifoLevel = 0;
+            emu->fifoOverrun = false;
+        }
+        return;
+
+    default:
+        emu->reg[addr] = value;
+        return;
+    }
+}
+
+static uint8_t Lps22hbEmu_Next(void *dev, uint8_t addr)
+{
+    Lps22hbEmu_t *emu = dev;
+    return (emu->reg[LPS22HB_REG_CTRL_2] & LPS22HB_EMU_CTRL2_IF_ADD_INC) ? (uint8_t)(addr + 1) : addr;
+}
+
+static void Lps22hbEmu_Release(void *dev)
+{
+    Lps22hbEmu_t *emu = dev;
+    EmuSpi_OutputRelease(&emu->press);
+    EmuSpi_OutputRelease(&emu->temp);
+}
+
+static const EmuSpi_Ops_t s_lps22hbEmuOps = {
+    Lps22hbEmu_Read,
+    Lps22hbEmu_Write,
+    Lps22hbEmu_Next,
+    Lps22hbEmu_Release,
+};
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+void Lps22hbEmu_Init(Lps22hbEmu_t *emu, const SilProfile_t *profile)
+{
+    memset(emu, 0, sizeof(*emu));
+    EmuSpi_Init(&emu->spi, &s_lps22hbEmuOps, emu);
+    emu->profile = profile;
+    Lps22hbEmu_Reset(emu);
+}
+
+int Lps22hbEmu_Attach(Lps22hbEmu_t *emu, SPI_HandleTypeDef *hspi, GPIO_TypeDef *csPort, uint16_t csPin)
+{
+    return EmuSpi_Attach(&emu->spi, hspi, csPort, csPin);
+}
+
+void Lps22hbEmu_Advance(Lps22hbEmu_t *emu, uint64_t now_us)
+{
+    while (emu->nextSample_us > 0.0 && emu->nextSample_us <= (double)now_us)
+    {
+        uint64_t t = (uint64_t)emu->nextSample_us;
+        emu->now_us = t;
+        if (emu->oneShotPending)
+        {
+            emu->oneShotPending = false;
+            emu->nextSample_us = 0.0;
+        }
+        else
+        {
+            emu->nextSample_us += 1e6 / s_odrHz[(emu->reg[LPS22HB_REG_CTRL_1] >> 4) & 0x07];
+        }
+        Lps22hbEmu_Sample(emu, t);
+    }
+    emu->now_us = now_us;
+}
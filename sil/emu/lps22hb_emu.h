@@ -0,0 +1,64 @@
+#ifndef LPS22HB_EMU_H
+#define LPS22HB_EMU_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "emu_spi.h"
+#include "sil_profile.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Register-level model of the LPS22HB on SPI.
+ *
+ * Modelled: WHO_AM_I, CTRL_REG1 ODR and BDU, CTRL_REG2 IF_ADD_INC,
+ * ONE_SHOT, SWRESET, FIFO_EN and STOP_ON_FTH, CTRL_REG3 DRDY and FIFO
+ * threshold/full on the INT_DRDY pin, STATUS data-ready and overrun, the
+ * pressure and temperature outputs, and the 32-slot FIFO (bypass, FIFO and
+ * stream modes, watermark, overrun). With the FIFO running, reading
+ * PRESS_OUT_XL pops the next slot into the output registers. The low-pass
+ * filter, reference pressure and pressure threshold interrupts are not
+ * modelled.
+ */
+
+#define LPS22HB_EMU_FIFO_SLOTS 32
+#define LPS22HB_EMU_REGS 128
+
+    typedef struct
+    {
+        EmuSpi_t spi;
+        const SilProfile_t *profile;
+        uint16_t drdyPin; ///< EXTI line of INT_DRDY, 0 when not wired
+
+        uint8_t reg[LPS22HB_EMU_REGS]; ///< Control registers as written
+        uint8_t status;                 ///< STATUS
+        EmuSpi_Output_t press;          ///< PRESS_OUT_XL .. PRESS_OUT_H
+        EmuSpi_Output_t temp;           ///< TEMP_OUT_L/H
+
+        double nextSample_us; ///< Next sample, 0 when powered down
+        bool oneShotPending;
+
+        uint8_t fifo[LPS22HB_EMU_FIFO_SLOTS][5]; ///< Pressure (3) then temperature (2)
+        uint8_t fifoHead;
+        uint8_t fifoLevel;
+        bool fifoOverrun;
+
+        uint64_t now_us;
+        uint32_t samples;   ///< Samples produced since init
+        uint32_t fifoLost;  ///< Slots dropped or overwritten
+    } Lps22hbEmu_t;
+
+    void Lps22hbEmu_Init(Lps22hbEmu_t *emu, const SilProfile_t *profile);
+
+    int Lps22hbEmu_Attach(Lps22hbEmu_t *emu, SPI_HandleTypeDef *hspi, GPIO_TypeDef *csPort, uint16_t csPin);
+
+    void Lps22hbEmu_Advance(Lps22hbEmu_t *emu, uint64_t now_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LPS22HB_EMU_H
@@ -0,0 +1,434 @@
+#include "lsm6dso32_emu.h"
+#include "lsm6dso32.h"
+#include <math.h>
+#include <string.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL DEFINITIONS                                                       */
+/*----------------------------------------------------------------------------*/
+
+#define LSM6DSO32_EMU_REG_INT1_CTRL 0x0D
+#define LSM6DSO32_EMU_REG_INT2_CTRL 0x0E
+#define LSM6DSO32_EMU_REG_CTRL10_C 0x19
+#define LSM6DSO32_EMU_REG_FIFO_DATA_OUT_Z_H 0x7E
+
+#define LSM6DSO32_EMU_CTRL3_BDU 0x40
+#define LSM6DSO32_EMU_CTRL3_IF_INC 0x04
+#define LSM6DSO32_EMU_CTRL3_SW_RESET 0x01
+#define LSM6DSO32_EMU_CTRL3_DEFAULT LSM6DSO32_EMU_CTRL3_IF_INC
+
+#define LSM6DSO32_EMU_INT1_DRDY_XL 0x01
+#define LSM6DSO32_EMU_INT1_DRDY_G 0x02
+#define LSM6DSO32_EMU_INT1_FIFO_TH 0x08
+#define LSM6DSO32_EMU_INT1_FIFO_OVR 0x10
+#define LSM6DSO32_EMU_INT1_FIFO_FULL 0x20
+
+#define LSM6DSO32_EMU_FIFO_MODE_FIFO 0x01
+#define LSM6DSO32_EMU_FIFO_OVR_LATCHED 0x08
+
+#define LSM6DSO32_EMU_GRAVITY 9.80665f
+#define LSM6DSO32_EMU_RAD_TO_MDPS (180000.0f / 3.14159265f)
+
+// ODR / BDR codes 0..10; 11..15 are reserved and read as off
+static const float s_odrHz[16] = {0.0f, 12.5f, 26.0f, 52.0f, 104.0f, 208.0f, 416.0f, 833.0f, 1666.0f, 3332.0f, 6664.0f};
+
+// FS_XL codes: +-4 g, +-32 g, +-8 g, +-16 g (mg/LSB)
+static const float s_accelSens[4] = {0.122f, 0.976f, 0.244f, 0.488f};
+
+// FS_G codes: 250, 500, 1000, 2000 dps (mdps/LSB)
+static const float s_gyroSens[4] = {8.75f, 17.5f, 35.0f, 70.0f};
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+static void Lsm6dso32Emu_Reset(Lsm6dso32Emu_t *emu)
+{
+    memset(emu->reg, 0, sizeof(emu->reg));
+    emu->reg[LSM6DSO32_REG_WHO_AM_I] = LSM6DSO32_WHO_AM_I_VAL;
+    emu->reg[LSM6DSO32_REG_CTRL3_C] = LSM6DSO32_EMU_CTRL3_DEFAULT;
+    emu->status = 0;
+    EmuSpi_InitOutput(&emu->temp, LSM6DSO32_REG_OUT_TEMP_L, 2, 2);
+    EmuSpi_InitOutput(&emu->gyro, LSM6DSO32_REG_OUTX_L_G, 6, 2);
+    EmuSpi_InitOutput(&emu->accel, LSM6DSO32_REG_OUTX_L_A, 6, 2);
+    emu->nextAccel_us = 0.0;
+    emu->nextGyro_us = 0.0;
+    emu->accelBatch = 0;
+    emu->gyroBatch = 0;
+    emu->fifoHead = 0;
+    emu->fifoLevel = 0;
+    memset(emu->fifoOut, 0, sizeof(emu->fifoOut));
+    emu->fifoOverrun = false;
+    emu->fifoOvrLatched = false;
+    emu->tagCount = 0;
+    emu->tagTime_us = UINT64_MAX;
+}
+
+static bool Lsm6dso32Emu_Bdu(const Lsm6dso32Emu_t *emu)
+{
+    return (emu->reg[LSM6DSO32_REG_CTRL3_C] & LSM6DSO32_EMU_CTRL3_BDU) != 0;
+}
+
+static uint8_t Lsm6dso32Emu_FifoMode(const Lsm6dso32Emu_t *emu)
+{
+    return emu->reg[LSM6DSO32_REG_FIFO_CTRL4] & 0x07;
+}
+
+static uint16_t Lsm6dso32Emu_Watermark(const Lsm6dso32Emu_t *emu)
+{
+    return (uint16_t)(emu->reg[LSM6DSO32_REG_FIFO_CTRL1] | ((emu->reg[LSM6DSO32_REG_FIFO_CTRL2] & 0x01) << 8));
+}
+
+static void Lsm6dso32Emu_Interrupt(Lsm6dso32Emu_t *emu, uint8_t source)
+{
+    if (emu->int1Pin && (emu->reg[LSM6DSO32_EMU_REG_INT1_CTRL] & source))
+    {
+        SilHal_RaiseExti(emu->int1Pin);
+    }
+}
+
+static void Lsm6dso32Emu_FifoClear(Lsm6dso32Emu_t *emu)
+{
+    emu->fifoHead = 0;
+    emu->fifoLevel = 0;
+    emu->fifoOverrun = false;
+    emu->fifoOvrLatched = false;
+}
+
+/**
+ * @brief Batch one tagged word; words sampled at the same time share a TAG_CNT
+ */
+static void Lsm6dso32Emu_FifoPush(Lsm6dso32Emu_t *emu, uint8_t sensor, const uint8_t data[6], uint64_t time_us)
+{
+    if (emu->fifoLevel == LSM6DSO32_EMU_FIFO_WORDS)
+    {
+        emu->fifoLost++;
+        emu->fifoOverrun = true;
+        emu->fifoOvrLatched = true;
+        Lsm6dso32Emu_Interrupt(emu, LSM6DSO32_EMU_INT1_FIFO_OVR);
+        if (Lsm6dso32Emu_FifoMode(emu) == LSM6DSO32_EMU_FIFO_MODE_FIFO)
+        {
+            return; // FIFO mode stops when full
+        }
+        // Continuous modes overwrite the oldest word
+        emu->fifoHead = (uint16_t)((emu->fifoHead + 1) % LSM6DSO32_EMU_FIFO_WORDS);
+        emu->fifoLevel--;
+    }
+
+    if (time_us != emu->tagTime_us)
+    {
+        emu->tagTime_us = time_us;
+        emu->tagCount = (emu->tagCount + 1) & 0x03;
+    }
+    uint8_t tag = (uint8_t)((sensor << 3) | (emu->tagCount << 1));
+    tag |= (uint8_t)(__builtin_parity(tag) & 1); // TAG_PARITY
+
+    uint8_t *word = emu->fifo[(emu->fifoHead + emu->fifoLevel) % LSM6DSO32_EMU_FIFO_WORDS];
+    word[0] = tag;
+    memcpy(&word[1], data, 6);
+    emu->fifoLevel++;
+    emu->fifoWords++;
+
+    uint16_t wtm = Lsm6dso32Emu_Watermark(emu);
+    if (wtm && emu->fifoLevel == wtm)
+    {
+        Lsm6dso32Emu_Interrupt(emu, LSM6DSO32_EMU_INT1_FIFO_TH);
+    }
+    if (emu->fifoLevel == LSM6DSO32_EMU_FIFO_WORDS)
+    {
+        Lsm6dso32Emu_Interrupt(emu, LSM6DSO32_EMU_INT1_FIFO_FULL);
+    }
+}
+
+/**
+ * @brief Batch a sample at BDR: one out of round(ODR / BDR) samples
+ */
+static void Lsm6dso32Emu_Batch(Lsm6dso32Emu_t *emu, uint8_t bdrCode, float odrHz, uint32_t *counter,
+                               uint8_t sensor, const uint8_t data[6], uint64_t time_us)
+{
+    float bdrHz = s_odrHz[bdrCode & 0x0F];
+    if (bdrHz <= 0.0f || Lsm6dso32Emu_FifoMode(emu) == LSM6DSO32_FIFO_MODE_BYPASS)
+    {
+        return;
+    }
+    uint32_t every = (bdrHz >= odrHz) ? 1u : (uint32_t)lroundf(odrHz / bdrHz);
+    if (++*counter < every)
+    {
+        return;
+    }
+    *counter = 0;
+    Lsm6dso32Emu_FifoPush(emu, sensor, data, time_us);
+}
+
+static void Lsm6dso32Emu_AccelSample(Lsm6dso32Emu_t *emu, uint64_t time_us)
+{
+    SilProfile_Truth_t truth;
+    emu->profile->sample(emu->profile->ctx, time_us, &truth);
+
+    uint8_t ctrl = emu->reg[LSM6DSO32_REG_CTRL1_XL];
+    float lsbPerMps2 = 1000.0f / (LSM6DSO32_EMU_GRAVITY * s_accelSens[(ctrl >> 2) & 0x03]);
+    uint8_t data[6];
+    for (int i = 0; i < 3; i++)
+    {
+        EmuSpi_PutInt16(&data[2 * i], EmuSpi_ToInt16(truth.accel_mps2[i] * lsbPerMps2));
+    }
+    EmuSpi_OutputUpdate(&emu->accel, data, Lsm6dso32Emu_Bdu(emu));
+
+    // Temperature follows the accelerometer
+    uint8_t temp[2];
+    EmuSpi_PutInt16(temp, EmuSpi_ToInt16((truth.temperature_C - LSM6DSO32_TEMP_OFFSET_C) *
+                                         LSM6DSO32_TEMP_SENS_LSB_PER_C));
+    EmuSpi_OutputUpdate(&emu->temp, temp, Lsm6dso32Emu_Bdu(emu));
+
+    emu->status |= LSM6DSO32_STATUS_XLDA | LSM6DSO32_STATUS_TDA;
+    emu->accelSamples++;
+    Lsm6dso32Emu_Batch(emu, emu->reg[LSM6DSO32_REG_FIFO_CTRL3] & 0x0F, s_odrHz[ctrl >> 4], &emu->accelBatch,
+                       LSM6DSO32_FIFO_TAG_ACCEL, data, time_us);
+    Lsm6dso32Emu_Interrupt(emu, LSM6DSO32_EMU_INT1_DRDY_XL);
+}
+
+static void Lsm6dso32Emu_GyroSample(Lsm6dso32Emu_t *emu, uint64_t time_us)
+{
+    SilProfile_Truth_t truth;
+    emu->profile->sample(emu->profile->ctx, time_us, &truth);
+
+    uint8_t ctrl = emu->reg[LSM6DSO32_REG_CTRL2_G];
+    float sens = (ctrl & 0x02) ? 4.375f : s_gyroSens[(ctrl >> 2) & 0x03]; // FS_125
+    float lsbPerRads = LSM6DSO32_EMU_RAD_TO_MDPS / sens;
+    uint8_t data[6];
+    for (int i = 0; i < 3; i++)
+    {
+        EmuSpi_PutInt16(&data[2 * i], EmuSpi_ToInt16(truth.gyro_rads[i] * lsbPerRads));
+    }
+    EmuSpi_OutputUpdate(&emu->gyro, data, Lsm6dso32Emu_Bdu(emu));
+
+    emu->status |= LSM6DSO32_STATUS_GDA;
+    emu->gyroSamples++;
+    Lsm6dso32Emu_Batch(emu, emu->reg[LSM6DSO32_REG_FIFO_CTRL3] >> 4, s_odrHz[ctrl >> 4], &emu->gyroBatch,
+                       LSM6DSO32_FIFO_TAG_GYRO, data, time_us);
+    Lsm6dso32Emu_Interrupt(emu, LSM6DSO32_EMU_INT1_DRDY_G);
+}
+
+/**
+ * @brief First sample one period after the ODR is set, 0 when powered down
+ */
+static double Lsm6dso32Emu_Schedule(const Lsm6dso32Emu_t *emu, uint8_t ctrl)
+{
+    float hz = s_odrHz[ctrl >> 4];
+    return (hz > 0.0f) ? (double)emu->now_us + 1e6 / hz : 0.0;
+}
+
+static uint8_t Lsm6dso32Emu_Read(void *dev, uint8_t addr)
+{
+    Lsm6dso32Emu_t *emu = dev;
+    bool bdu = Lsm6dso32Emu_Bdu(emu);
+
+    if (EmuSpi_InOutput(&emu->temp, addr))
+    {
+        if (addr == LSM6DSO32_REG_OUT_TEMP_H)
+        {
+            emu->status &= (uint8_t)~LSM6DSO32_STATUS_TDA;
+        }
+        return EmuSpi_OutputRead(&emu->temp, addr, bdu);
+    }
+    if (EmuSpi_InOutput(&emu->gyro, addr))
+    {
+        if (addr & 0x01) // any high byte
+        {
+            emu->status &= (uint8_t)~LSM6DSO32_STATUS_GDA;
+        }
+        return EmuSpi_OutputRead(&emu->gyro, addr, bdu);
+    }
+    if (EmuSpi_InOutput(&emu->accel, addr))
+    {
+        if (addr & 0x01)
+        {
+            emu->status &= (uint8_t)~LSM6DSO32_STATUS_XLDA;
+        }
+        return EmuSpi_OutputRead(&emu->accel, addr, bdu);
+    }
+
+    switch (addr)
+    {
+    case LSM6DSO32_REG_STATUS:
+        return emu->status;
+
+    case LSM6DSO32_REG_FIFO_STATUS1:
+        return (uint8_t)(emu->fifoLevel & 0xFF);
+
+    case LSM6DSO32_REG_FIFO_STATUS2:
+    {
+        uint16_t wtm = Lsm6dso32Emu_Watermark(emu);
+        uint8_t v = (uint8_t)((emu->fifoLevel >> 8) & 0x03);
+        v |= (wtm && emu->fifoLevel >= wtm) ? LSM6DSO32_FIFO_STATUS_WTM : 0;
+        v |= emu->fifoOverrun ? LSM6DSO32_FIFO_STATUS_OVR : 0;
+        v |= (emu->fifoLevel == LSM6DSO32_EMU_FIFO_WORDS) ? LSM6DSO32_FIFO_STATUS_FULL : 0;
+        v |= emu->fifoOvrLatched ? LSM6DSO32_EMU_FIFO_OVR_LATCHED : 0;
+        emu->fifoOvrLatched = false;
+        return v;
+    }
+
+    case LSM6DSO32_REG_FIFO_DATA_OUT_TAG:
+        // Reading the tag pops the next word; the rest of it follows
+        if (emu->fifoLevel > 0)
+        {
+            memcpy(emu->fifoOut, emu->fifo[emu->fifoHead], sizeof(emu->fifoOut));
+            emu->fifoHead = (uint16_t)((emu->fifoHead + 1) % LSM6DSO32_EMU_FIFO_WORDS);
+            emu->fifoLevel--;
+            emu->fifoOverrun = false;
+        }
+        else
+        {
+            memset(emu->fifoOut, 0, sizeof(emu->fifoOut));
+        }
+        return emu->fifoOut[0];
+
+    default:
+        if (addr > LSM6DSO32_REG_FIFO_DATA_OUT_TAG && addr <= LSM6DSO32_EMU_REG_FIFO_DATA_OUT_Z_H)
+        {
+            return emu->fifoOut[addr - LSM6DSO32_REG_FIFO_DATA_OUT_TAG];
+        }
+        return emu->reg[addr];
+    }
+}
+
+static void Lsm6dso32Emu_Write(void *dev, uint8_t addr, uint8_t value)
+{
+    Lsm6dso32Emu_t *emu = dev;
+    bool writable = (addr >= LSM6DSO32_REG_FIFO_CTRL1 && addr <= LSM6DSO32_EMU_REG_INT2_CTRL) ||
+                    (addr >= LSM6DSO32_REG_CTRL1_XL && addr <= LSM6DSO32_EMU_REG_CTRL10_C);
+    if (!writable)
+    {
+        return; // read-only or reserved
+    }
+
+    switch (addr)
+    {
+    case LSM6DSO32_REG_CTRL3_C:
+        if (value & LSM6DSO32_EMU_CTRL3_SW_RESET)
+        {
+            Lsm6dso32Emu_Reset(emu);
+            return;
+        }
+        emu->reg[addr] = value;
+        return;
+
+    case LSM6DSO32_REG_CTRL1_XL:
+        if ((value ^ emu->reg[addr]) & 0xF0) // ODR changed
+        {
+            emu->nextAccel_us = Lsm6dso32Emu_Schedule(emu, value);
+            emu->accelBatch = 0;
+        }
+        emu->reg[addr] = value;
+        return;
+
+    case LSM6DSO32_REG_CTRL2_G:
+        if ((value ^ emu->reg[addr]) & 0xF0) // ODR changed
+        {
+            emu->nextGyro_us = Lsm6dso32Emu_Schedule(emu, value);
+            emu->gyroBatch = 0;
+        }
+        emu->reg[addr] = value;
+        return;
+
+    case LSM6DSO32_REG_FIFO_CTRL3:
+        emu->reg[addr] = value;
+        emu->accelBatch = 0;
+        emu->gyroBatch = 0;
+        return;
+
+    case LSM6DSO32_REG_FIFO_CTRL4:
+        emu->reg[addr] = value;
+        if ((value & 0x07) == LSM6DSO32_FIFO_MODE_BYPASS)
+        {
+            Lsm6dso32Emu_FifoClear(emu);
+        }
+        return;
+
+    default:
+        emu->reg[addr] = value;
+        return;
+    }
+}
+
+static uint8_t Lsm6dso32Emu_Next(void *dev, uint8_t addr)
+{
+    Lsm6dso32Emu_t *emu = dev;
+    if (!(emu->reg[LSM6DSO32_REG_CTRL3_C] & LSM6DSO32_EMU_CTRL3_IF_INC))
+    {
+        return addr;
+    }
+    // FIFO reads roll over to the tag so words can be drained in one burst
+    if (addr == LSM6DSO32_EMU_REG_FIFO_DATA_OUT_Z_H)
+    {
+        return LSM6DSO32_REG_FIFO_DATA_OUT_TAG;
+    }
+    return (uint8_t)(addr + 1);
+}
+
+static void Lsm6dso32Emu_Release(void *dev)
+{
+    Lsm6dso32Emu_t *emu = dev;
+    EmuSpi_OutputRelease(&emu->temp);
+    EmuSpi_OutputRelease(&emu->gyro);
+    EmuSpi_OutputRelease(&emu->accel);
+}
+
+static const EmuSpi_Ops_t s_lsm6dso32EmuOps = {
+    Lsm6dso32Emu_Read,
+    Lsm6dso32Emu_Write,
+    Lsm6dso32Emu_Next,
+    Lsm6dso32Emu_Release,
+};
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+void Lsm6dso32Emu_Init(Lsm6dso32Emu_t *emu, const SilProfile_t *profile)
+{
+    memset(emu, 0, sizeof(*emu));
+    EmuSpi_Init(&emu->spi, &s_lsm6dso32EmuOps, emu);
+    emu->profile = profile;
+    Lsm6dso32Emu_Reset(emu);
+}
+
+int Lsm6dso32Emu_Attach(Lsm6dso32Emu_t *emu, SPI_HandleTypeDef *hspi, GPIO_TypeDef *csPort, uint16_t csPin)
+{
+    return EmuSpi_Attach(&emu->spi, hspi, csPort, csPin);
+}
+
+void Lsm6dso32Emu_Advance(Lsm6dso32Emu_t *emu, uint64_t now_us)
+{
+    // Samples in time order across both sensors
+    for (;;)
+    {
+        bool accelDue = emu->nextAccel_us > 0.0 && emu->nextAccel_us <= (double)now_us;
+        bool gyroDue = emu->nextGyro_us > 0.0 && emu->nextGyro_us <= (double)now_us;
+        if (!accelDue && !gyroDue)
+        {
+            break;
+        }
+
+        if (accelDue && (!gyroDue || emu->nextAccel_us <= emu->nextGyro_us))
+        {
+            uint64_t t = (uint64_t)emu->nextAccel_us;
+            emu->now_us = t;
+            emu->nextAccel_us += 1e6 / s_odrHz[emu->reg[LSM6DSO32_REG_CTRL1_XL] >> 4];
+            Lsm6dso32Emu_AccelSample(emu, t);
+        }
+        else
+        {
+            uint64_t t = (uint64_t)emu->nextGyro_us;
+            emu->now_us = t;
+            emu->nextGyro_us += 1e6 / s_odrHz[emu->reg[LSM6DSO32_REG_CTRL2_G] >> 4];
+            Lsm6dso32Emu_GyroSample(emu, t);
+        }
+    }
+    emu->now_us = now_us;
+}
+
+float Lsm6dso32Emu_OdrHz(uint8_t code)
+{
+    return s_odrHz[code & 0x0F];
+}
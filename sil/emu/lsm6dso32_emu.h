@@ -0,0 +1,88 @@
+#ifndef LSM6DSO32_EMU_H
+#define LSM6DSO32_EMU_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "emu_spi.h"
+#include "sil_profile.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Register-level model of the LSM6DSO32 on SPI.
+ *
+ * Modelled: WHO_AM_I, CTRL1_XL/CTRL2_G ODR and full scale, CTRL3_C IF_INC,
+ * BDU and SW_RESET, STATUS_REG data-ready flags, the temperature, gyro and
+ * accel outputs, and the FIFO (FIFO_CTRL1..4, FIFO_STATUS1/2, tagged words
+ * at FIFO_DATA_OUT_TAG with the address wrapping back to the tag after Z_H,
+ * bypass, FIFO and continuous modes, watermark, full and overrun).
+ * INT1_CTRL data-ready and FIFO threshold/overrun/full raise an EXTI on the
+ * INT1 pin when one is wired. Filters, timestamps and embedded functions
+ * are not modelled.
+ */
+
+#define LSM6DSO32_EMU_FIFO_WORDS 438 // 3 KB of 7-byte words
+#define LSM6DSO32_EMU_REGS 128
+
+    typedef struct
+    {
+        EmuSpi_t spi;
+        const SilProfile_t *profile;
+        uint16_t int1Pin; ///< EXTI line of INT1, 0 when not wired
+
+        uint8_t reg[LSM6DSO32_EMU_REGS]; ///< Control registers as written
+        uint8_t status;                   ///< STATUS_REG
+        EmuSpi_Output_t temp;             ///< OUT_TEMP_L/H
+        EmuSpi_Output_t gyro;             ///< OUTX_L_G .. OUTZ_H_G
+        EmuSpi_Output_t accel;            ///< OUTX_L_A .. OUTZ_H_A
+
+        double nextAccel_us; ///< Next accel sample, 0 when powered down
+        double nextGyro_us;  ///< Next gyro sample, 0 when powered down
+        uint32_t accelBatch; ///< Samples until the next accel FIFO batch
+        uint32_t gyroBatch;
+
+        uint8_t fifo[LSM6DSO32_EMU_FIFO_WORDS][7]; ///< Ring of tagged words
+        uint16_t fifoHead;                         ///< Oldest word
+        uint16_t fifoLevel;
+        uint8_t fifoOut[7];  ///< Word being read at FIFO_DATA_OUT_TAG..Z_H
+        bool fifoOverrun;    ///< OVR_IA: a word was lost since the last read
+        bool fifoOvrLatched; ///< FIFO_OVR_LATCHED, cleared by reading FIFO_STATUS2
+        uint8_t tagCount;    ///< TAG_CNT, advances per batched time slot
+        uint64_t tagTime_us; ///< Time slot of the last batched word
+
+        uint64_t now_us;
+        uint32_t accelSamples; ///< Accel samples produced since reset
+        uint32_t gyroSamples;
+        uint32_t fifoWords;    ///< Words batched
+        uint32_t fifoLost;     ///< Words dropped or overwritten
+    } Lsm6dso32Emu_t;
+
+    /**
+     * @brief Power-on state, fed from a motion profile (must outlive the emulator)
+     */
+    void Lsm6dso32Emu_Init(Lsm6dso32Emu_t *emu, const SilProfile_t *profile);
+
+    /**
+     * @brief Connect to a bus of the stand-in HAL
+     * @retval  0 on success, negative when the HAL has no free slot
+     */
+    int Lsm6dso32Emu_Attach(Lsm6dso32Emu_t *emu, SPI_HandleTypeDef *hspi, GPIO_TypeDef *csPort, uint16_t csPin);
+
+    /**
+     * @brief Produce every sample due up to now_us
+     */
+    void Lsm6dso32Emu_Advance(Lsm6dso32Emu_t *emu, uint64_t now_us);
+
+    /**
+     * @brief Output data rate in Hz for a CTRL1_XL / CTRL2_G / BDR code (0 = off)
+     */
+    float Lsm6dso32Emu_OdrHz(uint8_t code);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LSM6DSO32_EMU_H
@@ -0,0 +1,220 @@
+#include "sil_profile.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL DEFINITIONS                                                       */
+/*----------------------------------------------------------------------------*/
+
+#define SIL_PROFILE_GRAVITY 9.80665f
+#define SIL_PROFILE_CSV_FIELDS 12
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @brief Uniform in [-1, 1], xorshift32 so runs are repeatable
+ */
+static float SilProfile_Noise(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return (float)x * (2.0f / 4294967295.0f) - 1.0f;
+}
+
+static void SilProfile_SyntheticSample(void *ctx, uint64_t time_us, SilProfile_Truth_t *truth)
+{
+    SilProfile_Synthetic_t *cfg = ctx;
+    float t = (float)((double)time_us * 1e-6);
+    float vib = 0.0f;
+    if (cfg->vibrationFreq_Hz > 0.0f)
+    {
+        vib = sinf(2.0f * 3.14159265f * (float)fmod((double)cfg->vibrationFreq_Hz * (double)time_us * 1e-6, 1.0));
+    }
+
+    for (int i = 0; i < 3; i++)
+    {
+        truth->accel_mps2[i] = cfg->vibrationAccel_mps2 * vib + cfg->accelNoise_mps2 * SilProfile_Noise(&cfg->seed);
+        truth->gyro_rads[i] = cfg->gyro_rads[i] + cfg->vibrationGyro_rads * vib +
+                              cfg->gyroNoise_rads * SilProfile_Noise(&cfg->seed);
+        truth->mag_gauss[i] = cfg->mag_gauss[i];
+    }
+    truth->accel_mps2[2] += SIL_PROFILE_GRAVITY;
+
+    // Altitude of the ground level, then climb from there
+    float ground_m = 44330.0f * (1.0f - powf(cfg->groundPressure_hPa / 1013.25f, 0.190295f));
+    truth->pressure_hPa = SilProfile_IsaPressure(ground_m + cfg->climbRate_mps * t);
+    truth->temperature_C = cfg->temperature_C;
+}
+
+static void SilProfile_Lerp(const SilProfile_Truth_t *a, const SilProfile_Truth_t *b, float f,
+                            SilProfile_Truth_t *out)
+{
+    const float *pa = (const float *)a;
+    const float *pb = (const float *)b;
+    float *po = (float *)out;
+    for (size_t i = 0; i < sizeof(*out) / sizeof(float); i++)
+    {
+        po[i] = pa[i] + (pb[i] - pa[i]) * f;
+    }
+}
+
+static void SilProfile_RecordingSample(void *ctx, uint64_t time_us, SilProfile_Truth_t *truth)
+{
+    SilProfile_Recording_t *rec = ctx;
+    if (rec->count == 0)
+    {
+        memset(truth, 0, sizeof(*truth));
+        return;
+    }
+
+    const SilProfile_Record_t *r = rec->records;
+    if (time_us <= r[0].time_us)
+    {
+        *truth = r[0].truth;
+        return;
+    }
+    if (time_us >= r[rec->count - 1].time_us)
+    {
+        *truth = r[rec->count - 1].truth;
+        return;
+    }
+
+    // Move the cursor to the record at or before time_us
+    if (rec->cursor >= rec->count || r[rec->cursor].time_us > time_us)
+    {
+        rec->cursor = 0;
+    }
+    while (rec->cursor + 1 < rec->count && r[rec->cursor + 1].time_us <= time_us)
+    {
+        rec->cursor++;
+    }
+
+    const SilProfile_Record_t *a = &r[rec->cursor];
+    const SilProfile_Record_t *b = &r[rec->cursor + 1];
+    float f = (float)(time_us - a->time_us) / (float)(b->time_us - a->time_us);
+    SilProfile_Lerp(&a->truth, &b->truth, f, truth);
+}
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+void SilProfile_SyntheticDefaults(SilProfile_Synthetic_t *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->mag_gauss[0] = 0.2f; // mid-latitude field, pointing north and down
+    cfg->mag_gauss[2] = 0.4f;
+    cfg->groundPressure_hPa = 1013.25f;
+    cfg->temperature_C = 25.0f;
+    cfg->seed = 0x1234567u;
+}
+
+void SilProfile_InitSynthetic(SilProfile_t *profile, SilProfile_Synthetic_t *cfg)
+{
+    if (cfg->seed == 0)
+    {
+        cfg->seed = 0x1234567u;
+    }
+    profile->sample = SilProfile_SyntheticSample;
+    profile->ctx = cfg;
+}
+
+void SilProfile_InitRecording(SilProfile_t *profile, SilProfile_Recording_t *rec)
+{
+    rec->cursor = 0;
+    profile->sample = SilProfile_RecordingSample;
+    profile->ctx = rec;
+}
+
+int SilProfile_LoadCsv(const char *path, SilProfile_Recording_t *rec)
+{
+    memset(rec, 0, sizeof(*rec));
+    FILE *f = fopen(path, "r");
+    if (!f)
+    {
+        return -1;
+    }
+
+    SilProfile_Record_t *records = NULL;
+    size_t count = 0;
+    size_t capacity = 0;
+    char line[512];
+    int status = 0;
+
+    while (fgets(line, sizeof(line), f))
+    {
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r')
+        {
+            continue;
+        }
+
+        double v[SIL_PROFILE_CSV_FIELDS];
+        int n = sscanf(line, "%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf", &v[0], &v[1], &v[2], &v[3], &v[4],
+                       &v[5], &v[6], &v[7], &v[8], &v[9], &v[10], &v[11]);
+        if (n == 0 && count == 0)
+        {
+            continue; // header
+        }
+        if (n != SIL_PROFILE_CSV_FIELDS || v[0] < 0.0)
+        {
+            status = -2;
+            break;
+        }
+
+        if (count == capacity)
+        {
+            capacity = capacity ? capacity * 2 : 256;
+            SilProfile_Record_t *grown = realloc(records, capacity * sizeof(*records));
+            if (!grown)
+            {
+                status = -1;
+                break;
+            }
+            records = grown;
+        }
+
+        SilProfile_Record_t *r = &records[count++];
+        r->time_us = (uint64_t)llround(v[0] * 1e6);
+        for (int i = 0; i < 3; i++)
+        {
+            r->truth.accel_mps2[i] = (float)v[1 + i];
+            r->truth.gyro_rads[i] = (float)v[4 + i];
+            r->truth.mag_gauss[i] = (float)v[7 + i];
+        }
+        r->truth.pressure_hPa = (float)v[10];
+        r->truth.temperature_C = (float)v[11];
+        if (count > 1 && r->time_us < records[count - 2].time_us)
+        {
+            status = -2;
+            break;
+        }
+    }
+    fclose(f);
+
+    if (status != 0)
+    {
+        free(records);
+        return status;
+    }
+    rec->records = records;
+    rec->count = count;
+    return 0;
+}
+
+void SilProfile_FreeRecording(SilProfile_Recording_t *rec)
+{
+    free((void *)rec->records);
+    memset(rec, 0, sizeof(*rec));
+}
+
+float SilProfile_IsaPressure(float altitude_m)
+{
+    return 1013.25f * powf(1.0f - altitude_m / 44330.0f, 1.0f / 0.190295f);
+}
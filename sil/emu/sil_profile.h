@@ -0,0 +1,107 @@
+#ifndef SIL_PROFILE_H
+#define SIL_PROFILE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Motion profiles: what the sensors would measure at a given time, in the
+ * sensor axes and physical units. The emulators quantize it with their
+ * current full scale; noise belongs to the profile.
+ */
+
+    typedef struct
+    {
+        float accel_mps2[3]; ///< Specific force (reads +g on z when level and still)
+        float gyro_rads[3];  ///< Body rates
+        float mag_gauss[3];  ///< Magnetic field, hard-iron included
+        float pressure_hPa;  ///< Static pressure
+        float temperature_C; ///< Die temperature, shared by all sensors
+    } SilProfile_Truth_t;
+
+    typedef struct
+    {
+        void (*sample)(void *ctx, uint64_t time_us, SilProfile_Truth_t *truth);
+        void *ctx;
+    } SilProfile_t;
+
+    /**
+     * @brief Synthetic profile: level and still, plus optional rotation, climb,
+     *        a vibration line and white noise
+     */
+    typedef struct
+    {
+        float gyro_rads[3];        ///< Constant body rates (attitude is not integrated)
+        float mag_gauss[3];        ///< Constant field
+        float groundPressure_hPa;  ///< Pressure at t = 0
+        float climbRate_mps;       ///< Constant climb, converted with the ISA
+        float temperature_C;
+        float vibrationFreq_Hz;    ///< 0 = no vibration
+        float vibrationAccel_mps2; ///< Amplitude on every accel axis
+        float vibrationGyro_rads;  ///< Amplitude on every gyro axis
+        float accelNoise_mps2;     ///< Uniform noise amplitude
+        float gyroNoise_rads;
+        uint32_t seed;             ///< Noise generator state, 0 picks a default
+    } SilProfile_Synthetic_t;
+
+    typedef struct
+    {
+        uint64_t time_us;
+        SilProfile_Truth_t truth;
+    } SilProfile_Record_t;
+
+    /**
+     * @brief Recorded profile, linearly interpolated and held at both ends
+     */
+    typedef struct
+    {
+        const SilProfile_Record_t *records; ///< Sorted by time
+        size_t count;
+        size_t cursor; ///< Search hint, samples are requested in time order
+    } SilProfile_Recording_t;
+
+    /**
+     * @brief Defaults for a synthetic profile: level, still, 1013.25 hPa, 25 degC
+     */
+    void SilProfile_SyntheticDefaults(SilProfile_Synthetic_t *cfg);
+
+    /**
+     * @brief Profile backed by a synthetic description (cfg must outlive it)
+     */
+    void SilProfile_InitSynthetic(SilProfile_t *profile, SilProfile_Synthetic_t *cfg);
+
+    /**
+     * @brief Profile backed by a recording (rec must outlive it)
+     */
+    void SilProfile_InitRecording(SilProfile_t *profile, SilProfile_Recording_t *rec);
+
+    /**
+     * @brief Load a recording from CSV
+     *
+     * One row per record, a header line is skipped:
+     * time_s, ax, ay, az, gx, gy, gz, mx, my, mz, pressure_hPa, temperature_C
+     *
+     * @param[in]  path Text file
+     * @param[out] rec  Filled in; release with SilProfile_FreeRecording
+     * @retval  0 on success, -1 if the file cannot be read, -2 on a malformed row
+     */
+    int SilProfile_LoadCsv(const char *path, SilProfile_Recording_t *rec);
+
+    void SilProfile_FreeRecording(SilProfile_Recording_t *rec);
+
+    /**
+     * @brief ISA pressure at an altitude above the 1013.25 hPa level
+     */
+    float SilProfile_IsaPressure(float altitude_m);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIL_PROFILE_H
@@ -0,0 +1,47 @@
+#include "sil_sensors.h"
+#include <string.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+static void SilSensors_Hook(void *ctx, uint64_t now_us)
+{
+    SilSensors_Advance(ctx, now_us);
+}
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+int SilSensors_Init(SilSensors_t *rig, const SilProfile_t *profile, SPI_HandleTypeDef *hspi)
+{
+    memset(rig, 0, sizeof(*rig));
+    rig->hspi = hspi;
+
+    Lsm6dso32Emu_Init(&rig->imu, profile);
+    Lis2mdlEmu_Init(&rig->mag, profile);
+    Lps22hbEmu_Init(&rig->baro, profile);
+    rig->baro.drdyPin = SIL_SENSORS_INT_LPS22HB;
+
+    if (Lsm6dso32Emu_Attach(&rig->imu, hspi, SIL_SENSORS_CS_PORT, SIL_SENSORS_CS_LSM6DSO32) != 0 ||
+        Lis2mdlEmu_Attach(&rig->mag, hspi, SIL_SENSORS_CS_PORT, SIL_SENSORS_CS_LIS2MDL) != 0 ||
+        Lps22hbEmu_Attach(&rig->baro, hspi, SIL_SENSORS_CS_PORT, SIL_SENSORS_CS_LPS22HB) != 0)
+    {
+        return -1;
+    }
+
+    uint64_t now_us = SilHal_GetTime_us();
+    rig->imu.now_us = now_us;
+    rig->mag.now_us = now_us;
+    rig->baro.now_us = now_us;
+    SilHal_SetAdvanceHook(SilSensors_Hook, rig);
+    return 0;
+}
+
+void SilSensors_Advance(SilSensors_t *rig, uint64_t now_us)
+{
+    Lsm6dso32Emu_Advance(&rig->imu, now_us);
+    Lis2mdlEmu_Advance(&rig->mag, now_us);
+    Lps22hbEmu_Advance(&rig->baro, now_us);
+}
@@ -0,0 +1,55 @@
+#ifndef SIL_SENSORS_H
+#define SIL_SENSORS_H
+
+#include <stdint.h>
+#include "lis2mdl_emu.h"
+#include "lps22hb_emu.h"
+#include "lsm6dso32_emu.h"
+#include "sil_profile.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * The board's sensor bus: the three emulators on one SPI handle with the
+ * chip selects and interrupt lines of Core/Inc/main.h, all fed from one
+ * motion profile and stepped by the stand-in HAL's clock.
+ */
+
+// Board wiring, as in Core/Inc/main.h
+#define SIL_SENSORS_CS_PORT GPIOB
+#define SIL_SENSORS_CS_LIS2MDL GPIO_PIN_0
+#define SIL_SENSORS_CS_LSM6DSO32 GPIO_PIN_14
+#define SIL_SENSORS_CS_LPS22HB GPIO_PIN_15
+#define SIL_SENSORS_INT_LPS22HB GPIO_PIN_4
+
+    typedef struct
+    {
+        SPI_HandleTypeDef *hspi;
+        Lsm6dso32Emu_t imu;
+        Lis2mdlEmu_t mag;
+        Lps22hbEmu_t baro;
+    } SilSensors_t;
+
+    /**
+     * @brief Reset the emulators and put them on the bus
+     * @param rig      Rig to set up (keeps pointers to profile and hspi)
+     * @param profile  Motion profile feeding all three sensors
+     * @param hspi     Bus handle the drivers use
+     * @retval  0 on success, negative when the HAL has no free SPI slot
+     * @note Installs the HAL advance hook; call after SilHal_Reset().
+     */
+    int SilSensors_Init(SilSensors_t *rig, const SilProfile_t *profile, SPI_HandleTypeDef *hspi);
+
+    /**
+     * @brief Step all emulators to the given time (done by the advance hook)
+     */
+    void SilSensors_Advance(SilSensors_t *rig, uint64_t now_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIL_SENSORS_H
@@ -0,0 +1,410 @@
+#define _POSIX_C_SOURCE 199309L
+#include "sil_hal.h"
+#include <string.h>
+#include <time.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL DEFINITIONS                                                       */
+/*----------------------------------------------------------------------------*/
+
+typedef struct
+{
+    SPI_HandleTypeDef *hspi;
+    GPIO_TypeDef *csPort;
+    uint16_t csPin;
+    const SilHal_SpiDevice_t *device;
+    void *ctx;
+    bool selected;
+} SilHal_SpiSlot_t;
+
+typedef struct
+{
+    UART_HandleTypeDef *huart;
+    SilHal_UartSink_t sink;
+    void *ctx;
+} SilHal_UartSlot_t;
+
+GPIO_TypeDef SilHal_GpioA = {0xFFFF, 0xFFFF};
+GPIO_TypeDef SilHal_GpioB = {0xFFFF, 0xFFFF};
+GPIO_TypeDef SilHal_GpioC = {0xFFFF, 0xFFFF};
+CoreDebug_Type SilHal_CoreDebug;
+
+static DWT_Type s_dwt;
+static SilHal_SpiSlot_t s_spi[SILHAL_MAX_SPI_DEVICES];
+static uint8_t s_spiCount;
+static SilHal_UartSlot_t s_uart[SILHAL_MAX_UART_SINKS];
+static uint8_t s_uartCount;
+static uint8_t s_flash[SILHAL_FLASH_SIZE];
+static bool s_flashBlank; ///< s_flash still needs its first erase
+static bool s_flashUnlocked;
+static SilHal_FlashStats_t s_flashStats;
+static uint32_t s_flashFailErase; ///< Sector bit mask
+static uint64_t s_time_us;
+static SilHal_AdvanceHook_t s_advanceHook;
+static void *s_advanceCtx;
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @brief Device currently selected on a bus, NULL when none drives MISO
+ */
+static SilHal_SpiSlot_t *SilHal_SpiSelected(SPI_HandleTypeDef *hspi)
+{
+    for (uint8_t i = 0; i < s_spiCount; i++)
+    {
+        if (s_spi[i].hspi == hspi && s_spi[i].selected)
+        {
+            return &s_spi[i];
+        }
+    }
+    return NULL;
+}
+
+static HAL_StatusTypeDef SilHal_SpiBytes(SPI_HandleTypeDef *hspi, const uint8_t *tx, uint8_t *rx, uint16_t size)
+{
+    if (!hspi || size == 0)
+    {
+        return HAL_ERROR;
+    }
+    hspi->transfers++;
+
+    SilHal_SpiSlot_t *slot = SilHal_SpiSelected(hspi);
+    for (uint16_t i = 0; i < size; i++)
+    {
+        uint8_t out = tx ? tx[i] : 0x00;
+        uint8_t in = slot ? slot->device->transfer(slot->ctx, out) : 0xFF; // MISO idles high
+        if (rx)
+        {
+            rx[i] = in;
+        }
+    }
+    return HAL_OK;
+}
+
+/**
+ * @brief Start and size of a sector: 4 x 16 KB, 64 KB, 3 x 128 KB
+ */
+static void SilHal_FlashSector(uint32_t sector, uint32_t *offset, uint32_t *size)
+{
+    if (sector < 4)
+    {
+        *offset = sector * 0x4000u;
+        *size = 0x4000u;
+    }
+    else if (sector == 4)
+    {
+        *offset = 0x10000u;
+        *size = 0x10000u;
+    }
+    else
+    {
+        *offset = 0x20000u * (sector - 4u);
+        *size = 0x20000u;
+    }
+}
+
+static void SilHal_FlashInit(void)
+{
+    if (!s_flashBlank)
+    {
+        memset(s_flash, 0xFF, sizeof(s_flash));
+        s_flashBlank = true;
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/* HAL STAND-IN                                                               */
+/*----------------------------------------------------------------------------*/
+
+DWT_Type *SilHal_Dwt(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t ns = (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+    s_dwt.CYCCNT = (uint32_t)(ns * (SIL_CORE_CLOCK_HZ / 1000000u) / 1000u);
+    return &s_dwt;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    uint32_t before = GPIOx->ODR;
+    if (PinState == GPIO_PIN_SET)
+    {
+        GPIOx->ODR |= GPIO_Pin;
+    }
+    else
+    {
+        GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+    }
+
+    // Chip-select edges
+    for (uint8_t i = 0; i < s_spiCount; i++)
+    {
+        SilHal_SpiSlot_t *slot = &s_spi[i];
+        if (slot->csPort != GPIOx || !(slot->csPin & GPIO_Pin) || ((before ^ GPIOx->ODR) & slot->csPin) == 0)
+        {
+            continue;
+        }
+        slot->selected = (PinState == GPIO_PIN_RESET);
+        if (slot->selected && slot->device->select)
+        {
+            slot->device->select(slot->ctx);
+        }
+        else if (!slot->selected && slot->device->deselect)
+        {
+            slot->device->deselect(slot->ctx);
+        }
+    }
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    return (GPIOx->IDR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    HAL_GPIO_WritePin(GPIOx, GPIO_Pin, (GPIOx->ODR & GPIO_Pin) ? GPIO_PIN_RESET : GPIO_PIN_SET);
+}
+
+__attribute__((weak)) void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+    (void)GPIO_Pin;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)Timeout;
+    return SilHal_SpiBytes(hspi, pData, NULL, Size);
+}
+
+HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)Timeout;
+    return SilHal_SpiBytes(hspi, NULL, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef *hspi, uint8_t *pTxData, uint8_t *pRxData,
+                                          uint16_t Size, uint32_t Timeout)
+{
+    (void)Timeout;
+    return SilHal_SpiBytes(hspi, pTxData, pRxData, Size);
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size,
+                                    uint32_t Timeout)
+{
+    (void)Timeout;
+    if (!huart || !pData || Size == 0)
+    {
+        return HAL_ERROR;
+    }
+    for (uint8_t i = 0; i < s_uartCount; i++)
+    {
+        if (s_uart[i].huart == huart)
+        {
+            s_uart[i].sink(s_uart[i].ctx, pData, Size);
+        }
+    }
+
+    // Blocking transmit: 10 bit times per byte (8N1)
+    if (huart->Init.BaudRate > 0)
+    {
+        SilHal_Advance_us((uint64_t)Size * 10u * 1000000u / huart->Init.BaudRate);
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+    s_flashUnlocked = true;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+    s_flashUnlocked = false;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data)
+{
+    SilHal_FlashInit();
+    uint32_t offset = Address - FLASH_BASE;
+    if (!s_flashUnlocked || TypeProgram != FLASH_TYPEPROGRAM_WORD || (offset & 3u) || offset >= SILHAL_FLASH_SIZE)
+    {
+        s_flashStats.failures++;
+        return HAL_ERROR;
+    }
+
+    uint32_t word = (uint32_t)Data;
+    uint32_t old;
+    memcpy(&old, &s_flash[offset], sizeof(old));
+    SilHal_Advance_us(16);
+    if ((old & word) != word)
+    {
+        s_flashStats.failures++;
+        return HAL_ERROR;
+    }
+    memcpy(&s_flash[offset], &word, sizeof(word));
+    s_flashStats.words++;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *SectorError)
+{
+    SilHal_FlashInit();
+    *SectorError = 0xFFFFFFFFu;
+    if (!s_flashUnlocked || pEraseInit->TypeErase != FLASH_TYPEERASE_SECTORS ||
+        pEraseInit->Sector + pEraseInit->NbSectors > SILHAL_FLASH_SECTORS)
+    {
+        *SectorError = pEraseInit->Sector;
+        return HAL_ERROR;
+    }
+
+    for (uint32_t sector = pEraseInit->Sector; sector < pEraseInit->Sector + pEraseInit->NbSectors; sector++)
+    {
+        uint32_t offset, size;
+        SilHal_FlashSector(sector, &offset, &size);
+        SilHal_Advance_us((uint64_t)size / 128u * 1000u); // 1 s per 128 KB
+        if (s_flashFailErase & (1u << sector))
+        {
+            *SectorError = sector;
+            return HAL_ERROR;
+        }
+        memset(&s_flash[offset], 0xFF, size);
+        s_flashStats.erases[sector]++;
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_Init(void)
+{
+    return HAL_OK;
+}
+
+uint32_t HAL_GetTick(void)
+{
+    return (uint32_t)(s_time_us / 1000u);
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+    SilHal_Advance_us((uint64_t)Delay * 1000u);
+}
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+void SilHal_Reset(void)
+{
+    memset(s_spi, 0, sizeof(s_spi));
+    memset(s_uart, 0, sizeof(s_uart));
+    s_spiCount = 0;
+    s_uartCount = 0;
+    s_time_us = 0;
+    s_advanceHook = NULL;
+    s_advanceCtx = NULL;
+
+    // Pins idle high (pull-ups on chip selects and open-drain lines)
+    GPIO_TypeDef *ports[] = {GPIOA, GPIOB, GPIOC};
+    for (size_t i = 0; i < sizeof(ports) / sizeof(ports[0]); i++)
+    {
+        ports[i]->IDR = 0xFFFF;
+        ports[i]->ODR = 0xFFFF;
+    }
+}
+
+int SilHal_SpiAttach(SPI_HandleTypeDef *hspi, GPIO_TypeDef *csPort, uint16_t csPin,
+                     const SilHal_SpiDevice_t *device, void *ctx)
+{
+    if (s_spiCount >= SILHAL_MAX_SPI_DEVICES || !hspi || !csPort || !device || !device->transfer)
+    {
+        return -1;
+    }
+    s_spi[s_spiCount++] = (SilHal_SpiSlot_t){
+        .hspi = hspi,
+        .csPort = csPort,
+        .csPin = csPin,
+        .device = device,
+        .ctx = ctx,
+        .selected = (csPort->ODR & csPin) == 0,
+    };
+    return 0;
+}
+
+int SilHal_UartSetSink(UART_HandleTypeDef *huart, SilHal_UartSink_t sink, void *ctx)
+{
+    if (s_uartCount >= SILHAL_MAX_UART_SINKS || !huart || !sink)
+    {
+        return -1;
+    }
+    s_uart[s_uartCount++] = (SilHal_UartSlot_t){huart, sink, ctx};
+    return 0;
+}
+
+void SilHal_GpioSetInput(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state)
+{
+    if (state == GPIO_PIN_SET)
+    {
+        port->IDR |= pin;
+    }
+    else
+    {
+        port->IDR &= ~(uint32_t)pin;
+    }
+}
+
+void SilHal_RaiseExti(uint16_t pin)
+{
+    HAL_GPIO_EXTI_Callback(pin);
+}
+
+void SilHal_Advance_us(uint64_t us)
+{
+    s_time_us += us;
+    if (s_advanceHook)
+    {
+        s_advanceHook(s_advanceCtx, s_time_us);
+    }
+}
+
+uint64_t SilHal_GetTime_us(void)
+{
+    return s_time_us;
+}
+
+void SilHal_SetAdvanceHook(SilHal_AdvanceHook_t hook, void *ctx)
+{
+    s_advanceHook = hook;
+    s_advanceCtx = ctx;
+}
+
+const uint8_t *SilHal_FlashPtr(uint32_t address)
+{
+    SilHal_FlashInit();
+    uint32_t offset = address - FLASH_BASE;
+    return offset < SILHAL_FLASH_SIZE ? &s_flash[offset] : NULL;
+}
+
+void SilHal_FlashReset(void)
+{
+    memset(s_flash, 0xFF, sizeof(s_flash));
+    s_flashBlank = true;
+    s_flashUnlocked = false;
+    memset(&s_flashStats, 0, sizeof(s_flashStats));
+    s_flashFailErase = 0;
+}
+
+const SilHal_FlashStats_t *SilHal_FlashGetStats(void)
+{
+    return &s_flashStats;
+}
+
+void SilHal_FlashFailErase(uint32_t sectorMask)
+{
+    s_flashFailErase = sectorMask;
+}
@@ -0,0 +1,119 @@
+#ifndef SIL_HAL_H
+#define SIL_HAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "stm32f4xx_hal.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Simulated board behind the stand-in HAL.
+ *
+ * Time is virtual: it only moves when the harness calls SilHal_Advance_us
+ * or the firmware calls HAL_Delay / transmits on a UART with a baud rate
+ * set, so a loop runs as fast as the host allows. HAL_GetTick follows it.
+ * The DWT cycle counter is the exception and reads host time (see
+ * stm32f4xx.h).
+ *
+ * The 512 KB flash (F411 sector layout) keeps its contents across
+ * SilHal_Reset, as the chip does across a reset. Erase and program take
+ * their typical times out of virtual time (16 us per word, 1 s per 128 KB
+ * sector), which is how long the core stalls on the chip. Programming can
+ * only clear bits: a word that would need one set fails.
+ *
+ * SPI devices are attached to a bus and a chip-select pin. Driving the pin
+ * low selects the device, and every byte the firmware transmits or receives
+ * goes through its transfer callback, as on the wire.
+ */
+
+#define SILHAL_MAX_SPI_DEVICES 8
+#define SILHAL_MAX_UART_SINKS 4
+#define SILHAL_FLASH_SIZE (512u * 1024u)
+#define SILHAL_FLASH_SECTORS 8
+
+    typedef struct
+    {
+        void (*select)(void *ctx);                  ///< CS went low (may be NULL)
+        uint8_t (*transfer)(void *ctx, uint8_t tx); ///< One full-duplex byte; receives send 0x00
+        void (*deselect)(void *ctx);                ///< CS went high (may be NULL)
+    } SilHal_SpiDevice_t;
+
+    typedef void (*SilHal_UartSink_t)(void *ctx, const uint8_t *data, size_t len);
+
+    typedef void (*SilHal_AdvanceHook_t)(void *ctx, uint64_t now_us);
+
+    typedef struct
+    {
+        uint32_t words;                         ///< Words programmed
+        uint32_t failures;                      ///< Programs of non-erased words, or while locked
+        uint32_t erases[SILHAL_FLASH_SECTORS];  ///< Per sector
+    } SilHal_FlashStats_t;
+
+    /**
+     * @brief Detach every device and sink, release all pins and restart time at 0
+     */
+    void SilHal_Reset(void);
+
+    /**
+     * @brief Connect a simulated SPI device
+     * @param[in] hspi   Bus the firmware driver uses
+     * @param[in] csPort Chip-select port
+     * @param[in] csPin  Chip-select pin (active low)
+     * @param[in] device Callbacks (must outlive the attachment)
+     * @param[in] ctx    Passed to the callbacks
+     * @retval  0 on success, -1 when SILHAL_MAX_SPI_DEVICES are attached
+     */
+    int SilHal_SpiAttach(SPI_HandleTypeDef *hspi, GPIO_TypeDef *csPort, uint16_t csPin,
+                         const SilHal_SpiDevice_t *device, void *ctx);
+
+    /**
+     * @brief Receive everything the firmware transmits on a UART
+     * @retval  0 on success, -1 when SILHAL_MAX_UART_SINKS are registered
+     */
+    int SilHal_UartSetSink(UART_HandleTypeDef *huart, SilHal_UartSink_t sink, void *ctx);
+
+    /**
+     * @brief Set the level the firmware reads on an input pin
+     */
+    void SilHal_GpioSetInput(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state);
+
+    /**
+     * @brief Deliver an external interrupt (calls HAL_GPIO_EXTI_Callback)
+     */
+    void SilHal_RaiseExti(uint16_t pin);
+
+    /**
+     * @brief Move virtual time forward, calling the advance hook
+     */
+    void SilHal_Advance_us(uint64_t us);
+
+    uint64_t SilHal_GetTime_us(void);
+
+    /**
+     * @brief Called after each advance of virtual time, e.g. to step sensor models
+     */
+    void SilHal_SetAdvanceHook(SilHal_AdvanceHook_t hook, void *ctx);
+
+    /**
+     * @brief Erase the whole flash and clear its counters (a factory-fresh chip)
+     */
+    void SilHal_FlashReset(void);
+
+    const SilHal_FlashStats_t *SilHal_FlashGetStats(void);
+
+    /**
+     * @brief Make erases of the sectors in a bit mask fail after their full erase time (a worn-out sector)
+     * @note Cleared by SilHal_FlashReset
+     */
+    void SilHal_FlashFailErase(uint32_t sectorMask);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIL_HAL_H
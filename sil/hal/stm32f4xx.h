@@ -0,0 +1,48 @@
+#ifndef STM32F4XX_H
+#define STM32F4XX_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Host stand-in for the CMSIS device header: only the core registers the
+ * firmware modules touch. The DWT cycle counter reads host time scaled to
+ * SIL_CORE_CLOCK_HZ, so cycle budgets measured by the firmware (loop, mixer,
+ * controller stats) come out in target-equivalent cycles of the host.
+ */
+
+#define SIL_CORE_CLOCK_HZ 84000000u
+
+#define CoreDebug_DEMCR_TRCENA_Msk (1u << 24)
+#define DWT_CTRL_CYCCNTENA_Msk (1u << 0)
+
+    typedef struct
+    {
+        volatile uint32_t CTRL;
+        volatile uint32_t CYCCNT;
+    } DWT_Type;
+
+    typedef struct
+    {
+        volatile uint32_t DEMCR;
+    } CoreDebug_Type;
+
+    /**
+     * @brief DWT registers with CYCCNT refreshed from the host clock
+     */
+    DWT_Type *SilHal_Dwt(void);
+
+    extern CoreDebug_Type SilHal_CoreDebug;
+
+#define DWT (SilHal_Dwt())
+#define CoreDebug (&SilHal_CoreDebug)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STM32F4XX_H
@@ -0,0 +1,154 @@
+#ifndef STM32F4XX_HAL_H
+#define STM32F4XX_HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "stm32f4xx.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Host stand-in for the STM32F4 HAL: the GPIO, SPI, UART, flash and tick
+ * calls the firmware makes, with the same signatures. Behind them sits the
+ * simulated board in sil_hal.c (SPI devices, pin levels, UART sinks, flash
+ * and a virtual clock); harness code reaches it through sil_hal.h.
+ */
+
+#define HAL_MAX_DELAY 0xFFFFFFFFu
+
+    typedef enum
+    {
+        HAL_OK = 0x00U,
+        HAL_ERROR = 0x01U,
+        HAL_BUSY = 0x02U,
+        HAL_TIMEOUT = 0x03U
+    } HAL_StatusTypeDef;
+
+    /*------------------------------------------------------------------------*/
+    /* GPIO                                                                   */
+    /*------------------------------------------------------------------------*/
+
+#define GPIO_PIN_0 ((uint16_t)0x0001)
+#define GPIO_PIN_1 ((uint16_t)0x0002)
+#define GPIO_PIN_2 ((uint16_t)0x0004)
+#define GPIO_PIN_3 ((uint16_t)0x0008)
+#define GPIO_PIN_4 ((uint16_t)0x0010)
+#define GPIO_PIN_5 ((uint16_t)0x0020)
+#define GPIO_PIN_6 ((uint16_t)0x0040)
+#define GPIO_PIN_7 ((uint16_t)0x0080)
+#define GPIO_PIN_8 ((uint16_t)0x0100)
+#define GPIO_PIN_9 ((uint16_t)0x0200)
+#define GPIO_PIN_10 ((uint16_t)0x0400)
+#define GPIO_PIN_11 ((uint16_t)0x0800)
+#define GPIO_PIN_12 ((uint16_t)0x1000)
+#define GPIO_PIN_13 ((uint16_t)0x2000)
+#define GPIO_PIN_14 ((uint16_t)0x4000)
+#define GPIO_PIN_15 ((uint16_t)0x8000)
+
+    typedef enum
+    {
+        GPIO_PIN_RESET = 0,
+        GPIO_PIN_SET
+    } GPIO_PinState;
+
+    typedef struct
+    {
+        volatile uint32_t IDR; ///< Input levels, driven by the harness
+        volatile uint32_t ODR; ///< Output levels, driven by the firmware
+    } GPIO_TypeDef;
+
+    extern GPIO_TypeDef SilHal_GpioA;
+    extern GPIO_TypeDef SilHal_GpioB;
+    extern GPIO_TypeDef SilHal_GpioC;
+
+#define GPIOA (&SilHal_GpioA)
+#define GPIOB (&SilHal_GpioB)
+#define GPIOC (&SilHal_GpioC)
+
+    void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+    GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+    void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+    void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin);
+
+    /*------------------------------------------------------------------------*/
+    /* SPI                                                                    */
+    /*------------------------------------------------------------------------*/
+
+    typedef struct
+    {
+        uint8_t busId;      ///< Any value; tells buses apart in traces
+        uint32_t transfers; ///< Transmit/Receive calls, for tests
+    } SPI_HandleTypeDef;
+
+    HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+    HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+    HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef *hspi, uint8_t *pTxData, uint8_t *pRxData,
+                                              uint16_t Size, uint32_t Timeout);
+
+    /*------------------------------------------------------------------------*/
+    /* UART                                                                   */
+    /*------------------------------------------------------------------------*/
+
+    typedef struct
+    {
+        uint32_t BaudRate;
+    } UART_InitTypeDef;
+
+    typedef struct
+    {
+        UART_InitTypeDef Init;
+    } UART_HandleTypeDef;
+
+    HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size,
+                                        uint32_t Timeout);
+
+    /*------------------------------------------------------------------------*/
+    /* FLASH                                                                  */
+    /*------------------------------------------------------------------------*/
+
+#define FLASH_BASE 0x08000000u
+#define FLASH_TYPEERASE_SECTORS 0x00u
+#define FLASH_TYPEPROGRAM_WORD 0x02u
+#define FLASH_VOLTAGE_RANGE_3 0x02u
+#define FLASH_BANK_1 1u
+#define FLASH_SECTOR_0 0u
+#define FLASH_SECTOR_4 4u
+#define FLASH_SECTOR_5 5u
+#define FLASH_SECTOR_7 7u
+
+    typedef struct
+    {
+        uint32_t TypeErase;
+        uint32_t Banks;
+        uint32_t Sector;
+        uint32_t NbSectors;
+        uint32_t VoltageRange;
+    } FLASH_EraseInitTypeDef;
+
+    HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+    HAL_StatusTypeDef HAL_FLASH_Lock(void);
+    HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data);
+    HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *SectorError);
+
+    /**
+     * @brief Host address of a flash address, for code that reads flash in place
+     */
+    const uint8_t *SilHal_FlashPtr(uint32_t address);
+#define SILHAL_FLASH_PTR(address) SilHal_FlashPtr(address)
+
+    /*------------------------------------------------------------------------*/
+    /* TICK                                                                   */
+    /*------------------------------------------------------------------------*/
+
+    HAL_StatusTypeDef HAL_Init(void);
+    uint32_t HAL_GetTick(void);
+    void HAL_Delay(uint32_t Delay);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STM32F4XX_HAL_H
@@ -0,0 +1,240 @@
+#include "sim_flight.h"
+#include "sensor_imu.h"
+#include "sil_hal.h"
+#include <math.h>
+#include <string.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL DEFINITIONS                                                       */
+/*----------------------------------------------------------------------------*/
+
+#define SIM_FLIGHT_IMU_CTRL1_XL 0x88 // 1666 Hz, 8 g
+#define SIM_FLIGHT_IMU_CTRL2_G 0x8C  // 1666 Hz, 2000 dps
+#define SIM_FLIGHT_IMU_CTRL3_C 0x44  // BDU, IF_INC
+
+#define SIM_FLIGHT_CRASH_TILT_RAD 1.5708f
+#define SIM_FLIGHT_CRASH_IMPACT_MPS 2.0f
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+static float SimFlight_Clamp(float v, float lo, float hi)
+{
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+/**
+ * @brief Read the IMU through SensorIMU, poll the baro as the main loop does, feed the loop
+ */
+static void SimFlight_Sense(SimFlight_t *sim, uint32_t time_us)
+{
+    SensorIMU_Sample_t sample;
+    if (SensorIMU_Read(time_us, &sample) != 0)
+    {
+        return;
+    }
+    SimLoop_Imu(&sim->loop, sample.temp, &sample.gyro, &sample.accel);
+
+    uint8_t status = 0;
+    if (LPS22HB_Status(&sim->baro, &status) == 0 && (status & LPS22HB_STATUS_PRESS_READY))
+    {
+        FlightLog_Baro_t baro;
+        if (LPS22HB_ReadPT_Burst(&sim->baro, &baro.pressure, &baro.temp) == 0)
+        {
+            if (sim->log)
+            {
+                FlightLog_Baro(sim->log, time_us, &baro);
+            }
+            SimLoop_Baro(&sim->loop, baro.pressure);
+        }
+    }
+}
+
+/**
+ * @brief Collective for the altitude hold: P on altitude, PI on climb rate, tilt compensated
+ */
+static float SimFlight_AltitudeHold(SimFlight_t *sim, float target_m)
+{
+    const SimFlight_Config_t *cfg = &sim->config;
+    const SimLoop_t *loop = &sim->loop;
+    float climbSetpoint =
+        SimFlight_Clamp(cfg->altitudeKp * (target_m - loop->altitude.altitude_m), -cfg->maxClimb_mps, cfg->maxClimb_mps);
+    float climbError = climbSetpoint - loop->altitude.climbRate_mps;
+
+    sim->hoverThrottle = SimFlight_Clamp(sim->hoverThrottle + cfg->climbKi * climbError * loop->dt_s, 0.05f, 0.95f);
+
+    // Body z component of up
+    const float *q = loop->attitude.q;
+    float tiltCos = 1.0f - 2.0f * (q[1] * q[1] + q[2] * q[2]);
+    tiltCos = tiltCos < 0.5f ? 0.5f : tiltCos;
+    return SimFlight_Clamp((sim->hoverThrottle + cfg->climbKp * climbError) / tiltCos, 0.0f, 1.0f);
+}
+
+static void SimFlight_Measure(SimFlight_t *sim, const SimFlight_Command_t *cmd)
+{
+    const SimVehicle_State_t *s = &sim->vehicle.state;
+    SimFlight_Result_t *r = &sim->result;
+    float euler[3];
+    SimVehicle_Euler(s->q, euler);
+
+    float tilt = acosf(SimFlight_Clamp(1.0f - 2.0f * (s->q[1] * s->q[1] + s->q[2] * s->q[2]), -1.0f, 1.0f));
+    r->tiltMax_rad = tilt > r->tiltMax_rad ? tilt : r->tiltMax_rad;
+
+    if (cmd->setpoint.armed && cmd->setpoint.mode == FLIGHT_MODE_ANGLE && !s->onGround)
+    {
+        float dr = euler[0] - cmd->setpoint.roll;
+        float dp = euler[1] - cmd->setpoint.pitch;
+        float err = sqrtf(dr * dr + dp * dp);
+        sim->attitudeErr2 += (double)(err * err);
+        sim->attitudeCount++;
+        r->attitudeErrorMax_rad = err > r->attitudeErrorMax_rad ? err : r->attitudeErrorMax_rad;
+    }
+    if (cmd->altitudeHold && !s->onGround)
+    {
+        float err = s->position_m[2] - cmd->altitude_m;
+        sim->altitudeErr2 += (double)(err * err);
+        sim->altitudeCount++;
+    }
+    if (!s->onGround)
+    {
+        float err = fabsf(sim->loop.altitude.altitude_m - s->position_m[2]);
+        r->estimatorErrorMax_m = err > r->estimatorErrorMax_m ? err : r->estimatorErrorMax_m;
+    }
+
+    sim->saturated += sim->loop.motors.saturated ? 1u : 0u;
+    r->maxImpact_mps = sim->vehicle.maxImpact_mps;
+    if (tilt > SIM_FLIGHT_CRASH_TILT_RAD || r->maxImpact_mps > SIM_FLIGHT_CRASH_IMPACT_MPS)
+    {
+        r->crashed = true;
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+void SimFlight_DefaultConfig(SimFlight_Config_t *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    SimVehicle_DefaultConfig(&cfg->vehicle);
+    SimVehicle_DefaultSensors(&cfg->sensors);
+    SimLoop_DefaultConfig(&cfg->loop);
+
+    cfg->altitudeKp = 1.5f;
+    cfg->maxClimb_mps = 2.0f;
+    cfg->climbKp = 0.15f;
+    cfg->climbKi = 0.1f;
+    cfg->hoverThrottle = 0.4f;
+}
+
+int SimFlight_Init(SimFlight_t *sim, const SimFlight_Config_t *cfg)
+{
+    if (!sim || !cfg || cfg->loop.control.loopRate_Hz <= 0.0f)
+    {
+        return -1;
+    }
+
+    memset(sim, 0, sizeof(*sim));
+    sim->config = *cfg;
+    sim->period_us = (uint64_t)(1e6f / cfg->loop.control.loopRate_Hz);
+    sim->hoverThrottle = cfg->hoverThrottle;
+
+    SilHal_Reset();
+    if (SimVehicle_Init(&sim->vehicle, &cfg->vehicle, &cfg->sensors) != 0)
+    {
+        return -2;
+    }
+    SimVehicle_Profile(&sim->vehicle, &sim->profile);
+
+    static SPI_HandleTypeDef s_spi2 = {2, 0};
+    if (SilSensors_Init(&sim->rig, &sim->profile, &s_spi2) != 0)
+    {
+        return -3;
+    }
+
+    sim->imu = (LSM6DSO32_Handle_t){.hspi = &s_spi2, .csPort = SIL_SENSORS_CS_PORT, .csPin = SIL_SENSORS_CS_LSM6DSO32};
+    sim->baro = (LPS22HB_Handle_t){.hspi = &s_spi2, .csPort = SIL_SENSORS_CS_PORT, .csPin = SIL_SENSORS_CS_LPS22HB};
+    sim->baro.config.odr = LPS22HB_CONFIG_ODR_75HZ;
+    sim->baro.config.lp_bw = LPS22HB_CONFIG_LP_BW_ODR_20;
+
+    // The driver's Init leaves the IMU at 104 Hz; the loop needs it faster
+    const uint8_t imuCtrl[3] = {SIM_FLIGHT_IMU_CTRL1_XL, SIM_FLIGHT_IMU_CTRL2_G, SIM_FLIGHT_IMU_CTRL3_C};
+    if (LSM6DSO32_Init(&sim->imu) != 0 || LSM6DSO32_WriteReg(&sim->imu, LSM6DSO32_REG_CTRL1_XL, imuCtrl, 3) != 0 ||
+        LPS22HB_Init(&sim->baro) != 0 || SensorIMU_Init(&sim->imu) != 0)
+    {
+        return -4;
+    }
+
+    if (SimLoop_Init(&sim->loop, &cfg->loop) != 0)
+    {
+        return -5;
+    }
+    return 0;
+}
+
+void SimFlight_SetLog(SimFlight_t *sim, FlightLog_t *log)
+{
+    sim->log = log;
+    SensorIMU_SetLog(log);
+}
+
+void SimFlight_Step(SimFlight_t *sim, const SimFlight_Command_t *cmd)
+{
+    // Physics over the period with the last commands, sensors sample it at their ODR
+    uint64_t now = SilHal_GetTime_us();
+    SimVehicle_Step(&sim->vehicle, now + sim->period_us);
+    SilHal_Advance_us(sim->period_us);
+
+    // The loop tick stamps the samples it reads
+    uint32_t tick_us = (uint32_t)SilHal_GetTime_us();
+    SimFlight_Sense(sim, tick_us);
+
+    FlightControl_Setpoint_t setpoint = cmd->setpoint;
+    if (cmd->altitudeHold)
+    {
+        setpoint.throttle = SimFlight_AltitudeHold(sim, cmd->altitude_m);
+    }
+
+    if (sim->log)
+    {
+        FlightLog_Setpoint(sim->log, tick_us, &setpoint);
+    }
+    SimLoop_Control(&sim->loop, &setpoint);
+    if (sim->log)
+    {
+        FlightLog_Loop(sim->log, tick_us);
+    }
+    SimVehicle_SetMotors(&sim->vehicle, sim->loop.motors.output);
+
+    sim->iterations++;
+    SimFlight_Measure(sim, cmd);
+}
+
+void SimFlight_Run(SimFlight_t *sim, SimFlight_Pilot_t pilot, void *ctx, float duration_s,
+                   SimFlight_Result_t *result)
+{
+    uint32_t iterations = (uint32_t)(duration_s / sim->loop.dt_s);
+    SimFlight_Command_t cmd;
+    memset(&cmd, 0, sizeof(cmd));
+
+    for (uint32_t n = 0; n < iterations && !sim->result.crashed; n++)
+    {
+        pilot(ctx, (float)((double)SilHal_GetTime_us() * 1e-6), &cmd);
+        SimFlight_Step(sim, &cmd);
+    }
+
+    if (result)
+    {
+        SimFlight_GetResult(sim, result);
+    }
+}
+
+void SimFlight_GetResult(const SimFlight_t *sim, SimFlight_Result_t *result)
+{
+    *result = sim->result;
+    result->iterations = sim->iterations;
+    result->attitudeErrorRms_rad = sim->attitudeCount ? (float)sqrt(sim->attitudeErr2 / sim->attitudeCount) : 0.0f;
+    result->altitudeErrorRms_m = sim->altitudeCount ? (float)sqrt(sim->altitudeErr2 / sim->altitudeCount) : 0.0f;
+    result->saturatedFraction = sim->iterations ? (float)sim->saturated / (float)sim->iterations : 0.0f;
+}
@@ -0,0 +1,133 @@
+#ifndef SIM_FLIGHT_H
+#define SIM_FLIGHT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "flight_control.h"
+#include "flight_log.h"
+#include "lps22hb.h"
+#include "lsm6dso32.h"
+#include "sil_sensors.h"
+#include "sim_loop.h"
+#include "sim_vehicle.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Closed-loop flight on the host: the vehicle model feeds the sensor
+ * emulators, the drivers read them over the stand-in SPI bus, and the
+ * filter bank, vibration analyzer, altitude estimator, FlightControl and
+ * mixer run once per loop period exactly as on the board. Mixer outputs
+ * drive the motors of the model for the next period.
+ *
+ * Attitude comes from the firmware's AttitudeEstimator on preintegrated
+ * samples. Throttle comes from the command, or from an altitude hold that
+ * plays the pilot.
+ *
+ * FlightControl, the mixer, SensorIMU and the stand-in HAL are single instances, so
+ * only one SimFlight_t can run at a time. It is large: give it static
+ * storage.
+ */
+
+    typedef struct
+    {
+        SimVehicle_Config_t vehicle;
+        SimVehicle_SensorModel_t sensors;
+        SimLoop_Config_t loop; ///< control.loopRate_Hz sets the simulated loop
+        float altitudeKp;      ///< Altitude hold: climb rate per metre of error
+        float maxClimb_mps;
+        float climbKp;         ///< Throttle per m/s of climb rate error
+        float climbKi;         ///< Hover throttle learning, per m of climb error
+        float hoverThrottle;   ///< Starting guess
+    } SimFlight_Config_t;
+
+    typedef struct
+    {
+        FlightControl_Setpoint_t setpoint;
+        bool altitudeHold; ///< Throttle from the altitude hold instead of setpoint.throttle
+        float altitude_m;  ///< Target above the take-off point
+    } SimFlight_Command_t;
+
+    /**
+     * @brief Flight plan: fills the command for the loop iteration at time_s
+     */
+    typedef void (*SimFlight_Pilot_t)(void *ctx, float time_s, SimFlight_Command_t *cmd);
+
+    typedef struct
+    {
+        uint32_t iterations;
+        float attitudeErrorRms_rad;  ///< True roll/pitch against the setpoint, angle mode only
+        float attitudeErrorMax_rad;
+        float altitudeErrorRms_m;    ///< True altitude against the target, altitude hold only
+        float estimatorErrorMax_m;   ///< Altitude estimate against the truth, once airborne
+        float tiltMax_rad;
+        float saturatedFraction;     ///< Iterations with the mixer saturated
+        float maxImpact_mps;         ///< Hardest ground contact
+        bool crashed;                ///< Tilted past 90 deg or hit the ground hard
+    } SimFlight_Result_t;
+
+    typedef struct
+    {
+        SimFlight_Config_t config;
+        SimVehicle_t vehicle;
+        SilProfile_t profile;
+        SilSensors_t rig;
+        LSM6DSO32_Handle_t imu;
+        LPS22HB_Handle_t baro;
+        SimLoop_t loop;
+        FlightLog_t *log;     ///< Recording, NULL when off
+        float hoverThrottle;  ///< Learned by the altitude hold
+        uint64_t period_us;
+
+        // Running metrics
+        uint32_t iterations;
+        uint32_t saturated;
+        double attitudeErr2;
+        uint32_t attitudeCount;
+        double altitudeErr2;
+        uint32_t altitudeCount;
+        SimFlight_Result_t result;
+    } SimFlight_t;
+
+    /**
+     * @brief Vehicle and sensor defaults, the bench's controller and filter tuning, 1 kHz loop
+     */
+    void SimFlight_DefaultConfig(SimFlight_Config_t *cfg);
+
+    /**
+     * @brief Reset the HAL, put the vehicle on the ground and bring up drivers and modules
+     * @retval  0 on success, negative on error (which step failed)
+     */
+    int SimFlight_Init(SimFlight_t *sim, const SimFlight_Config_t *cfg);
+
+    /**
+     * @brief Record the flight from now on (after SimFlight_Init)
+     * @param[in] log Open log, NULL to stop recording
+     */
+    void SimFlight_SetLog(SimFlight_t *sim, FlightLog_t *log);
+
+    /**
+     * @brief Run one loop period with the given command
+     */
+    void SimFlight_Step(SimFlight_t *sim, const SimFlight_Command_t *cmd);
+
+    /**
+     * @brief Fly a plan for duration_s, stopping early on a crash
+     * @param[out] result Metrics of the whole flight (may be NULL)
+     */
+    void SimFlight_Run(SimFlight_t *sim, SimFlight_Pilot_t pilot, void *ctx, float duration_s,
+                       SimFlight_Result_t *result);
+
+    /**
+     * @brief Metrics so far
+     */
+    void SimFlight_GetResult(const SimFlight_t *sim, SimFlight_Result_t *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_FLIGHT_H
@@ -0,0 +1,200 @@
+#include "sim_loop.h"
+#include <string.h>
+#include <time.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL DEFINITIONS                                                       */
+/*----------------------------------------------------------------------------*/
+
+#define SIM_LOOP_GRAVITY 9.80665f
+
+static const char *const s_stageNames[SIM_LOOP_STAGE_COUNT] = {
+    "ImuTempComp", "FilterBank", "VibrationAnalyzer", "Attitude", "AltitudeEstimator", "FlightControl_Update", "Mixer_Mix",
+};
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+static uint64_t SimLoop_Now_ns(const SimLoop_t *loop)
+{
+    if (!loop->timed)
+    {
+        return 0;
+    }
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void SimLoop_Record(SimLoop_t *loop, enum SimLoop_Stage stage, uint64_t start_ns)
+{
+    if (!loop->timed)
+    {
+        return;
+    }
+    uint64_t ns = SimLoop_Now_ns(loop) - start_ns;
+    SimLoop_Timer_t *t = &loop->timers[stage];
+    t->ns += ns;
+    t->maxNs = ns > t->maxNs ? ns : t->maxNs;
+    t->calls++;
+}
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+void SimLoop_DefaultConfig(SimLoop_Config_t *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+
+    FlightControl_Config_t *fc = &cfg->control;
+    fc->loopRate_Hz = 1000.0f;
+    fc->angleKp[0] = 6.0f;
+    fc->angleKp[1] = 6.0f;
+    fc->maxAngle_rad = 0.6f;
+    fc->dTermCutoff_Hz = 100.0f;
+    fc->setpointCutoff_Hz = 30.0f;
+    for (int i = 0; i < FLIGHT_AXIS_COUNT; i++)
+    {
+        fc->maxRate_rads[i] = 10.0f;
+        fc->rate[i] = (FlightControl_RateGains_t){0.08f, 0.4f, 0.0008f, 0.002f, 0.3f, 1.0f};
+    }
+
+    cfg->mixer = (Mixer_Config_t){true, 1.0f};
+    cfg->filters = (FilterBank_Config_t){1000.0f, 2, 150.0f, 30.0f, 2, 3.0f, 80.0f, 400.0f, 20.0f, 0.05f};
+    cfg->tempComp = (ImuTempComp_Config_t){0.05f, 0.3f, 200, 500, 5000}; // as in main.c
+
+    cfg->attitudeGain = 0.2f;
+    cfg->altitudeTimeConstant_s = 1.0f; // as in main.c
+    cfg->baroPeriod_s = 1.0f / 75.0f;   // LPS22HB_CONFIG_ODR_75HZ
+    cfg->gyroScale = LSM6DSO32_GYRO_SENS_2000DPS_MDPS * 1e-3f * 3.14159265f / 180.0f;
+    cfg->accelScale = LSM6DSO32_ACCEL_SENS_8G_MG * 1e-3f * SIM_LOOP_GRAVITY;
+}
+
+int SimLoop_Init(SimLoop_t *loop, const SimLoop_Config_t *cfg)
+{
+    if (!loop || !cfg || cfg->control.loopRate_Hz <= 0.0f)
+    {
+        return -1;
+    }
+
+    memset(loop, 0, sizeof(*loop));
+    loop->config = *cfg;
+    loop->config.filters.sampleRate_Hz = cfg->control.loopRate_Hz;
+    loop->dt_s = (float)(uint64_t)(1e6f / cfg->control.loopRate_Hz) * 1e-6f;
+
+    VibrationAnalyzer_Config_t vibCfg = {cfg->control.loopRate_Hz, 1, cfg->gyroScale, cfg->accelScale, 40.0f};
+    AltitudeEstimator_Config_t altCfg = {cfg->altitudeTimeConstant_s};
+    ImuPreint_Config_t preintCfg = {1.0f / loop->dt_s};
+    AttitudeEstimator_Config_t attCfg = {cfg->attitudeGain};
+    if (ImuTempComp_Init(&loop->tempComp, &cfg->tempComp) != 0 ||
+        FilterBank_Init(&loop->filters, &loop->config.filters) != 0 ||
+        VibrationAnalyzer_Init(&loop->vibration, &vibCfg) != 0 ||
+        AltitudeEstimator_Init(&loop->altitude, &altCfg) != 0 || ImuPreint_Init(&loop->preint, &preintCfg) != 0 ||
+        AttitudeEstimator_Init(&loop->attitude, &attCfg) != 0 || FlightControl_Init(&cfg->control) != 0 ||
+        Mixer_Init(&cfg->mixer) != 0)
+    {
+        return -2;
+    }
+    return 0;
+}
+
+void SimLoop_Imu(SimLoop_t *loop, int16_t temp, const LSM6DSO32_GyroRaw_t *gyro,
+                 const LSM6DSO32_AccelRaw_t *accel)
+{
+    // The temperature register updates far below the sample rate: refresh on change only
+    uint64_t t0 = SimLoop_Now_ns(loop);
+    if (!loop->haveTemp || temp != loop->temp)
+    {
+        ImuTempComp_SetTemperature(&loop->tempComp, ImuTempComp_RawTempToC(temp));
+        loop->temp = temp;
+        loop->haveTemp = true;
+    }
+    ImuTempComp_Update(&loop->tempComp, gyro, accel);
+    float axisData[FILTER_BANK_AXES];
+    ImuTempComp_Convert(&loop->tempComp, gyro, accel, &axisData[0], &axisData[3]);
+    SimLoop_Record(loop, SIM_LOOP_STAGE_TEMP_COMP, t0);
+
+    float *axes[FILTER_BANK_AXES];
+    for (int i = 0; i < FILTER_BANK_AXES; i++)
+    {
+        axes[i] = &axisData[i];
+    }
+
+    t0 = SimLoop_Now_ns(loop);
+    FilterBank_Process(&loop->filters, axes, 1);
+    SimLoop_Record(loop, SIM_LOOP_STAGE_FILTER, t0);
+
+    // One analysis stage per loop; notches follow it
+    t0 = SimLoop_Now_ns(loop);
+    VibrationAnalyzer_PushSample(&loop->vibration, gyro, accel);
+    if (VibrationAnalyzer_Step(&loop->vibration))
+    {
+        FilterBank_TrackSpectrum(&loop->filters, VibrationAnalyzer_GetSpectrum(&loop->vibration));
+    }
+    FilterBank_Retune(&loop->filters);
+    SimLoop_Record(loop, SIM_LOOP_STAGE_VIBRATION, t0);
+
+    memcpy(loop->gyro_rads, &axisData[0], sizeof(loop->gyro_rads));
+    memcpy(loop->accel_mps2, &axisData[3], sizeof(loop->accel_mps2));
+    t0 = SimLoop_Now_ns(loop);
+    ImuPreint_Delta_t delta;
+    ImuPreint_AddSample(&loop->preint, loop->gyro_rads, loop->accel_mps2);
+    ImuPreint_Take(&loop->preint, &delta);
+    AttitudeEstimator_Update(&loop->attitude, &delta);
+    SimLoop_Record(loop, SIM_LOOP_STAGE_ATTITUDE, t0);
+
+    t0 = SimLoop_Now_ns(loop);
+    AltitudeEstimator_Predict(&loop->altitude, AltitudeEstimator_VerticalAccel(loop->attitude.q, loop->accel_mps2),
+                              loop->dt_s);
+    SimLoop_Record(loop, SIM_LOOP_STAGE_ALTITUDE, t0);
+}
+
+void SimLoop_Baro(SimLoop_t *loop, int32_t pressure)
+{
+    // Same conversion as LPS22HB_ReadPT_Burst_hPa_C
+    uint64_t t0 = SimLoop_Now_ns(loop);
+    AltitudeEstimator_UpdateBaro(&loop->altitude, pressure / 4096.0f, loop->config.baroPeriod_s);
+    SimLoop_Record(loop, SIM_LOOP_STAGE_ALTITUDE, t0);
+}
+
+void SimLoop_Control(SimLoop_t *loop, const FlightControl_Setpoint_t *setpoint)
+{
+    // Controller axes: roll right, pitch nose up, yaw nose right
+    FlightControl_State_t state = {
+        .rate_rads = {loop->gyro_rads[0], -loop->gyro_rads[1], -loop->gyro_rads[2]},
+    };
+    AttitudeEstimator_RollPitch(&loop->attitude, state.attitude_rad);
+
+    uint64_t t0 = SimLoop_Now_ns(loop);
+    FlightControl_Update(&state, setpoint, &loop->control);
+    SimLoop_Record(loop, SIM_LOOP_STAGE_CONTROL, t0);
+
+    t0 = SimLoop_Now_ns(loop);
+    Mixer_Mix(loop->control.torque, loop->control.throttle, &loop->motors);
+    SimLoop_Record(loop, SIM_LOOP_STAGE_MIXER, t0);
+    if (!setpoint->armed)
+    {
+        memset(loop->motors.output, 0, sizeof(loop->motors.output));
+    }
+}
+
+void SimLoop_Output(const SimLoop_t *loop, uint32_t time_us, SimLoop_Output_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    out->time_us = time_us;
+    memcpy(out->q, loop->attitude.q, sizeof(out->q));
+    memcpy(out->gyro_rads, loop->gyro_rads, sizeof(out->gyro_rads));
+    memcpy(out->accel_mps2, loop->accel_mps2, sizeof(out->accel_mps2));
+    out->altitude_m = loop->altitude.altitude_m;
+    out->climbRate_mps = loop->altitude.climbRate_mps;
+    memcpy(out->torque, loop->control.torque, sizeof(out->torque));
+    out->throttle = loop->control.throttle;
+    memcpy(out->motors, loop->motors.output, sizeof(out->motors));
+}
+
+const char *SimLoop_StageName(int stage)
+{
+    return (stage >= 0 && stage < SIM_LOOP_STAGE_COUNT) ? s_stageNames[stage] : "?";
+}
@@ -0,0 +1,149 @@
+#ifndef SIM_LOOP_H
+#define SIM_LOOP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "altitude_estimator.h"
+#include "attitude_estimator.h"
+#include "flight_control.h"
+#include "imu_filter_bank.h"
+#include "imu_preintegration.h"
+#include "imu_temp_comp.h"
+#include "lsm6dso32.h"
+#include "mixer.h"
+#include "vibration_analyzer.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * The flight loop from raw samples to motor outputs: temperature
+ * compensation, filter bank, vibration analyzer, attitude, altitude
+ * estimator, FlightControl and mixer, in that order. The closed-loop
+ * simulator and the log replay both run it, so a replay of a recorded
+ * flight goes through the same calls in the same order and reproduces its
+ * outputs bit for bit.
+ *
+ * The attitude stage is the board's: filtered samples are preintegrated
+ * and AttitudeEstimator_Update takes the increments of each tick from
+ * ImuPreint_Take. The IMU runs at the loop rate here, one sample per tick.
+ *
+ * FlightControl and the mixer are single instances, so only one SimLoop_t
+ * can run at a time.
+ */
+
+    enum SimLoop_Stage
+    {
+        SIM_LOOP_STAGE_TEMP_COMP = 0,
+        SIM_LOOP_STAGE_FILTER,
+        SIM_LOOP_STAGE_VIBRATION,
+        SIM_LOOP_STAGE_ATTITUDE,
+        SIM_LOOP_STAGE_ALTITUDE,
+        SIM_LOOP_STAGE_CONTROL,
+        SIM_LOOP_STAGE_MIXER,
+        SIM_LOOP_STAGE_COUNT,
+    };
+
+    typedef struct
+    {
+        FlightControl_Config_t control; ///< loopRate_Hz sets the loop period
+        Mixer_Config_t mixer;
+        FilterBank_Config_t filters;    ///< sampleRate_Hz is set to the loop rate
+        ImuTempComp_Config_t tempComp;  ///< Bias learning while still; converts at ±2000 dps / ±8 g
+        float attitudeGain;             ///< AttitudeEstimator accel correction, rad/s per rad of tilt error
+        float altitudeTimeConstant_s;   ///< AltitudeEstimator crossover
+        float baroPeriod_s;             ///< Baro sample period handed to the estimator
+        float gyroScale;                ///< rad/s per LSB, for the vibration analyzer
+        float accelScale;               ///< m/s^2 per LSB, for the vibration analyzer
+    } SimLoop_Config_t;
+
+    typedef struct
+    {
+        uint64_t ns;
+        uint64_t maxNs;
+        uint64_t calls;
+    } SimLoop_Timer_t;
+
+    /**
+     * @brief Everything the loop produces, compared bit for bit between replays
+     */
+    typedef struct
+    {
+        uint32_t time_us;
+        float q[4];
+        float gyro_rads[3];
+        float accel_mps2[3];
+        float altitude_m;
+        float climbRate_mps;
+        float torque[FLIGHT_AXIS_COUNT];
+        float throttle;
+        float motors[MIXER_OUTPUTS];
+    } SimLoop_Output_t;
+
+    typedef struct
+    {
+        SimLoop_Config_t config;
+        ImuTempComp_t tempComp;
+        int16_t temp;         ///< Raw IMU temperature the correction was last set for
+        bool haveTemp;
+        FilterBank_t filters;
+        VibrationAnalyzer_t vibration;
+        AltitudeEstimator_t altitude;
+        ImuPreint_t preint;
+        AttitudeEstimator_t attitude; ///< q: body -> world
+        float gyro_rads[3];   ///< Filtered, body axes
+        float accel_mps2[3];  ///< Filtered, body axes
+        float dt_s;
+        FlightControl_Output_t control;
+        Mixer_Output_t motors;
+
+        bool timed;           ///< Time each stage into timers (host clock)
+        SimLoop_Timer_t timers[SIM_LOOP_STAGE_COUNT];
+    } SimLoop_t;
+
+    /**
+     * @brief The bench's controller and filter tuning, 1 kHz loop, ±2000 dps / ±8 g
+     */
+    void SimLoop_DefaultConfig(SimLoop_Config_t *cfg);
+
+    /**
+     * @brief Bring up the modules; the attitude starts level
+     * @retval  0 on success, negative on error
+     */
+    int SimLoop_Init(SimLoop_t *loop, const SimLoop_Config_t *cfg);
+
+    /**
+     * @brief Compensate and filter one raw IMU sample, feed the analyzer, attitude and altitude prediction
+     * @param[in] temp Raw IMU temperature read with the sample; the correction is refreshed when it changes
+     */
+    void SimLoop_Imu(SimLoop_t *loop, int16_t temp, const LSM6DSO32_GyroRaw_t *gyro,
+                     const LSM6DSO32_AccelRaw_t *accel);
+
+    /**
+     * @brief Baro correction of the altitude estimate
+     * @param[in] pressure Raw LPS22HB counts (LSB/4096 hPa), as LPS22HB_ReadPT_Burst returns them
+     */
+    void SimLoop_Baro(SimLoop_t *loop, int32_t pressure);
+
+    /**
+     * @brief Controller and mixer on the current estimate; outputs are zero while disarmed
+     */
+    void SimLoop_Control(SimLoop_t *loop, const FlightControl_Setpoint_t *setpoint);
+
+    /**
+     * @brief Collect the outputs of the last iteration
+     */
+    void SimLoop_Output(const SimLoop_t *loop, uint32_t time_us, SimLoop_Output_t *out);
+
+    /**
+     * @brief Printable name of a stage
+     */
+    const char *SimLoop_StageName(int stage);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_LOOP_H
@@ -0,0 +1,125 @@
+#include "sim_replay.h"
+#include <string.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @brief Start the loop over with a new configuration, keeping its timers
+ */
+static int SimReplay_Restart(SimLoop_t *loop, const SimLoop_Config_t *cfg)
+{
+    bool timed = loop->timed;
+    SimLoop_Timer_t timers[SIM_LOOP_STAGE_COUNT];
+    memcpy(timers, loop->timers, sizeof(timers));
+    if (SimLoop_Init(loop, cfg) != 0)
+    {
+        return -1;
+    }
+    loop->timed = timed;
+    memcpy(loop->timers, timers, sizeof(timers));
+    return 0;
+}
+
+static void SimReplay_Imu(SimLoop_t *loop, const FlightLog_Imu_t *imu)
+{
+    LSM6DSO32_GyroRaw_t gyro = {imu->gyro[0], imu->gyro[1], imu->gyro[2]};
+    LSM6DSO32_AccelRaw_t accel = {imu->accel[0], imu->accel[1], imu->accel[2]};
+    SimLoop_Imu(loop, imu->temp, &gyro, &accel);
+}
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+void SimReplay_Configure(SimLoop_Config_t *cfg, const FlightLog_Header_t *header)
+{
+    cfg->control.loopRate_Hz = header->loopRate_Hz;
+    cfg->gyroScale = header->gyroScale;
+    cfg->accelScale = header->accelScale;
+}
+
+int SimReplay_Run(SimLoop_t *loop, FlightLog_Reader_t *reader, SimReplay_Callback_t cb, void *ctx,
+                  SimReplay_Stats_t *stats)
+{
+    SimReplay_Stats_t local;
+    SimReplay_Stats_t *s = stats ? stats : &local;
+    memset(s, 0, sizeof(*s));
+
+    FlightControl_Setpoint_t setpoint;
+    memset(&setpoint, 0, sizeof(setpoint)); // disarmed until the first SETPOINT
+
+    FlightLog_Record_t rec;
+    int ret;
+    while ((ret = FlightLog_Next(reader, &rec)) == 1)
+    {
+        s->records++;
+        switch (rec.type)
+        {
+        case FLIGHT_LOG_IMU:
+            SimReplay_Imu(loop, &rec.data.imu);
+            s->imu++;
+            break;
+        case FLIGHT_LOG_BARO:
+            SimLoop_Baro(loop, rec.data.baro.pressure);
+            s->baro++;
+            break;
+        case FLIGHT_LOG_MAG:
+            s->mag++;
+            break;
+        case FLIGHT_LOG_SETPOINT:
+            setpoint = rec.data.setpoint;
+            s->setpoints++;
+            break;
+        case FLIGHT_LOG_LOOP:
+            SimLoop_Control(loop, &setpoint);
+            s->loops++;
+            if (cb)
+            {
+                SimLoop_Output_t out;
+                SimLoop_Output(loop, rec.time_us, &out);
+                cb(ctx, &out);
+            }
+            break;
+        case FLIGHT_LOG_GAP:
+            s->dropped += rec.data.gap;
+            break;
+        case FLIGHT_LOG_EVENT:
+        {
+            SimLoop_Config_t cfg = loop->config;
+            if (SimReplay_Restart(loop, &cfg) != 0)
+            {
+                return -1;
+            }
+            s->events++;
+            break;
+        }
+        case FLIGHT_LOG_CAPTURE:
+            SimReplay_Imu(loop, &rec.data.imu);
+            s->captures++;
+            if (cb)
+            {
+                SimLoop_Output_t out;
+                SimLoop_Output(loop, rec.time_us, &out);
+                cb(ctx, &out);
+            }
+            break;
+        case FLIGHT_LOG_HEADER:
+        {
+            SimLoop_Config_t cfg = loop->config;
+            SimReplay_Configure(&cfg, &rec.data.header);
+            if (SimReplay_Restart(loop, &cfg) != 0)
+            {
+                return -1;
+            }
+            memset(&setpoint, 0, sizeof(setpoint));
+            s->reboots++;
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    return ret < 0 ? -1 : 0;
+}
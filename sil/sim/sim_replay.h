@@ -0,0 +1,67 @@
+#ifndef SIM_REPLAY_H
+#define SIM_REPLAY_H
+
+#include <stdint.h>
+#include "flight_log.h"
+#include "sim_loop.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Feeds a flight log back through SimLoop: IMU and baro records go to the
+ * estimators as they come, the last SETPOINT is held, and every LOOP record
+ * runs the controller and mixer and reports the outputs. A log without GAP
+ * records reproduces the recorded loop bit for bit when the module code and
+ * configuration are the same. A HEADER record means the firmware rebooted:
+ * the loop restarts from scratch with the new header, as the firmware did.
+ *
+ * The board's blackbox holds event captures rather than a continuous IMU
+ * stream: an EVENT record restarts the loop (its samples go back in time)
+ * and every CAPTURE sample then runs the estimators and reports the outputs
+ * at the sample's own timestamp. No controller iteration is recorded with a
+ * capture, so torque and motors stay as the last LOOP record left them.
+ * A log that mixes live IMU records with captures therefore replays the
+ * live stream in pieces, restarted at each capture.
+ */
+
+    typedef struct
+    {
+        uint32_t records;
+        uint32_t imu;
+        uint32_t baro;
+        uint32_t mag;       ///< Decoded but not used by the loop yet
+        uint32_t setpoints;
+        uint32_t loops;
+        uint32_t events;    ///< EVENT records, each restarts the loop
+        uint32_t captures;  ///< CAPTURE samples run through the estimators
+        uint32_t dropped;   ///< Sum of GAP counts: the replay is not exact when non-zero
+        uint32_t reboots;   ///< HEADER records after the start
+    } SimReplay_Stats_t;
+
+    /**
+     * @brief Called after every replayed loop iteration and captured sample
+     */
+    typedef void (*SimReplay_Callback_t)(void *ctx, const SimLoop_Output_t *out);
+
+    /**
+     * @brief Take loop rate and sensor scales from a log header
+     */
+    void SimReplay_Configure(SimLoop_Config_t *cfg, const FlightLog_Header_t *header);
+
+    /**
+     * @brief Replay the rest of the log through an initialized loop
+     * @param[in]  cb    Output of each iteration (may be NULL)
+     * @param[out] stats Record counts (may be NULL)
+     * @retval  0 at the end of the log, -1 on a corrupt record (stats cover what came before)
+     */
+    int SimReplay_Run(SimLoop_t *loop, FlightLog_Reader_t *reader, SimReplay_Callback_t cb, void *ctx,
+                      SimReplay_Stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_REPLAY_H
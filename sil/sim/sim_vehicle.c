@@ -0,0 +1,324 @@
+#include "sim_vehicle.h"
+#include <math.h>
+#include <string.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL DEFINITIONS                                                       */
+/*----------------------------------------------------------------------------*/
+
+#define SIM_VEHICLE_GRAVITY 9.80665f
+#define SIM_VEHICLE_TWO_PI 6.28318531f
+#define SIM_VEHICLE_DEFAULT_SEED 0x2545F491u
+
+// Mixer rows as roll/pitch/yaw coefficients, in output order
+#define SIM_VEHICLE_MIX_ROW(roll, pitch, yaw) {roll, pitch, yaw},
+static const float s_mix[MIXER_OUTPUTS][3] = {MIXER_TABLE(SIM_VEHICLE_MIX_ROW)};
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @brief Uniform in [-1, 1], xorshift32 so runs are repeatable
+ */
+static float SimVehicle_Noise(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return (float)x * (2.0f / 4294967295.0f) - 1.0f;
+}
+
+/**
+ * @brief v_world = R(q) v_body
+ */
+static void SimVehicle_Rotate(const float q[4], const float v[3], float out[3])
+{
+    float w = q[0], x = q[1], y = q[2], z = q[3];
+    out[0] = (1.0f - 2.0f * (y * y + z * z)) * v[0] + 2.0f * (x * y - w * z) * v[1] + 2.0f * (x * z + w * y) * v[2];
+    out[1] = 2.0f * (x * y + w * z) * v[0] + (1.0f - 2.0f * (x * x + z * z)) * v[1] + 2.0f * (y * z - w * x) * v[2];
+    out[2] = 2.0f * (x * z - w * y) * v[0] + 2.0f * (y * z + w * x) * v[1] + (1.0f - 2.0f * (x * x + y * y)) * v[2];
+}
+
+/**
+ * @brief v_body = R(q)^T v_world
+ */
+static void SimVehicle_RotateInv(const float q[4], const float v[3], float out[3])
+{
+    const float qc[4] = {q[0], -q[1], -q[2], -q[3]};
+    SimVehicle_Rotate(qc, v, out);
+}
+
+static void SimVehicle_Snapshot(const SimVehicle_t *veh, const float accel_mps2[3], SimVehicle_Snapshot_t *snap)
+{
+    const SimVehicle_State_t *s = &veh->state;
+    const float specific[3] = {accel_mps2[0], accel_mps2[1], accel_mps2[2] + SIM_VEHICLE_GRAVITY};
+
+    snap->time_us = veh->time_us;
+    SimVehicle_RotateInv(s->q, specific, snap->specificForce_mps2);
+    SimVehicle_RotateInv(s->q, veh->config.mag_gauss, snap->mag_gauss);
+    memcpy(snap->rate_rads, s->rate_rads, sizeof(snap->rate_rads));
+    snap->altitude_m = s->position_m[2];
+    memcpy(snap->motorSpeed, s->motorSpeed, sizeof(snap->motorSpeed));
+    memcpy(snap->motorPhase, veh->motorPhase, sizeof(snap->motorPhase));
+}
+
+/**
+ * @brief One integration step of dt_s with the held motor commands
+ * @param[out] accel_mps2 World acceleration over the step
+ */
+static void SimVehicle_Integrate(SimVehicle_t *veh, float dt_s, float accel_mps2[3])
+{
+    const SimVehicle_Config_t *cfg = &veh->config;
+    SimVehicle_State_t *s = &veh->state;
+    float alpha = 1.0f - expf(-dt_s / cfg->motorTau_s);
+
+    // Motors
+    float thrust = 0.0f;
+    float torque[3] = {0.0f, 0.0f, 0.0f};
+    for (int i = 0; i < MIXER_OUTPUTS; i++)
+    {
+        s->motorSpeed[i] += (veh->command[i] - s->motorSpeed[i]) * alpha;
+        float t = cfg->maxThrust_N * s->motorSpeed[i] * s->motorSpeed[i];
+        thrust += t;
+        for (int k = 0; k < 3; k++)
+        {
+            torque[k] += veh->motorTorque[i][k] * t;
+        }
+        veh->motorPhase[i] += cfg->maxMotorFreq_Hz * s->motorSpeed[i] * dt_s;
+    }
+
+    // Rotation: Euler's equations with damping
+    const float *I = cfg->inertia_kgm2;
+    const float *w = s->rate_rads;
+    float gyroscopic[3] = {
+        (I[2] - I[1]) * w[1] * w[2],
+        (I[0] - I[2]) * w[2] * w[0],
+        (I[1] - I[0]) * w[0] * w[1],
+    };
+    for (int k = 0; k < 3; k++)
+    {
+        s->rate_rads[k] += dt_s * (torque[k] - cfg->angularDrag_Nmsprad * w[k] - gyroscopic[k]) / I[k];
+    }
+
+    // q += 0.5 q (x) (0, w) dt
+    float qw = s->q[0], qx = s->q[1], qy = s->q[2], qz = s->q[3];
+    float hx = 0.5f * dt_s * s->rate_rads[0];
+    float hy = 0.5f * dt_s * s->rate_rads[1];
+    float hz = 0.5f * dt_s * s->rate_rads[2];
+    s->q[0] = qw - qx * hx - qy * hy - qz * hz;
+    s->q[1] = qx + qw * hx + qy * hz - qz * hy;
+    s->q[2] = qy + qw * hy + qz * hx - qx * hz;
+    s->q[3] = qz + qw * hz + qx * hy - qy * hx;
+    float norm = 1.0f / sqrtf(s->q[0] * s->q[0] + s->q[1] * s->q[1] + s->q[2] * s->q[2] + s->q[3] * s->q[3]);
+    for (int k = 0; k < 4; k++)
+    {
+        s->q[k] *= norm;
+    }
+
+    // Translation
+    const float bodyThrust[3] = {0.0f, 0.0f, thrust};
+    float force[3];
+    SimVehicle_Rotate(s->q, bodyThrust, force);
+    force[2] -= cfg->mass_kg * SIM_VEHICLE_GRAVITY;
+    for (int k = 0; k < 3; k++)
+    {
+        force[k] -= cfg->linearDrag_Nspm * s->velocity_mps[k];
+        accel_mps2[k] = force[k] / cfg->mass_kg;
+        s->velocity_mps[k] += accel_mps2[k] * dt_s;
+        s->position_m[k] += s->velocity_mps[k] * dt_s;
+    }
+
+    // Ground contact: stops the fall and holds the vehicle until thrust lifts it
+    if (s->position_m[2] <= 0.0f && (s->velocity_mps[2] <= 0.0f || accel_mps2[2] <= 0.0f))
+    {
+        if (!s->onGround && -s->velocity_mps[2] > veh->maxImpact_mps)
+        {
+            veh->maxImpact_mps = -s->velocity_mps[2];
+        }
+        s->position_m[2] = 0.0f;
+        memset(s->velocity_mps, 0, sizeof(s->velocity_mps));
+        memset(s->rate_rads, 0, sizeof(s->rate_rads));
+        memset(accel_mps2, 0, 3 * sizeof(float));
+        s->onGround = true;
+    }
+    else
+    {
+        s->onGround = false;
+    }
+}
+
+static float SimVehicle_Lerp(float a, float b, float f)
+{
+    return a + (b - a) * f;
+}
+
+static void SimVehicle_Sample(void *ctx, uint64_t time_us, SilProfile_Truth_t *truth)
+{
+    SimVehicle_t *veh = ctx;
+    SimVehicle_SensorModel_t *sm = &veh->sensors;
+    const SimVehicle_Snapshot_t *a = &veh->prev;
+    const SimVehicle_Snapshot_t *b = &veh->cur;
+
+    float f = 0.0f;
+    if (b->time_us > a->time_us)
+    {
+        uint64_t t = time_us < a->time_us ? a->time_us : (time_us > b->time_us ? b->time_us : time_us);
+        f = (float)(t - a->time_us) / (float)(b->time_us - a->time_us);
+    }
+
+    // Rotor imbalance: a force rotating in the rotor plane, smaller along the shaft
+    float vibration[3] = {0.0f, 0.0f, 0.0f};
+    for (int i = 0; i < MIXER_OUTPUTS; i++)
+    {
+        float speed = SimVehicle_Lerp(a->motorSpeed[i], b->motorSpeed[i], f);
+        float phase = SIM_VEHICLE_TWO_PI * SimVehicle_Lerp(a->motorPhase[i], b->motorPhase[i], f);
+        float level = speed * speed;
+        vibration[0] += level * cosf(phase);
+        vibration[1] += level * sinf(phase);
+        vibration[2] += 0.5f * level * sinf(phase);
+    }
+
+    for (int k = 0; k < 3; k++)
+    {
+        truth->accel_mps2[k] = SimVehicle_Lerp(a->specificForce_mps2[k], b->specificForce_mps2[k], f) +
+                               sm->accelBias_mps2[k] + sm->vibrationAccel_mps2 * vibration[k] +
+                               sm->accelNoise_mps2 * SimVehicle_Noise(&veh->rng);
+        truth->gyro_rads[k] = SimVehicle_Lerp(a->rate_rads[k], b->rate_rads[k], f) + sm->gyroBias_rads[k] +
+                              sm->vibrationGyro_rads * vibration[k] + sm->gyroNoise_rads * SimVehicle_Noise(&veh->rng);
+        truth->mag_gauss[k] = SimVehicle_Lerp(a->mag_gauss[k], b->mag_gauss[k], f) +
+                              sm->magNoise_gauss * SimVehicle_Noise(&veh->rng);
+    }
+
+    float altitude = SimVehicle_Lerp(a->altitude_m, b->altitude_m, f);
+    truth->pressure_hPa = SilProfile_IsaPressure(veh->groundAltitude_m + altitude) +
+                          sm->baroNoise_hPa * SimVehicle_Noise(&veh->rng);
+    truth->temperature_C = veh->config.temperature_C;
+}
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+void SimVehicle_DefaultConfig(SimVehicle_Config_t *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->mass_kg = 0.5f;
+    cfg->inertia_kgm2[0] = 2.5e-3f;
+    cfg->inertia_kgm2[1] = 2.5e-3f;
+    cfg->inertia_kgm2[2] = 4.5e-3f;
+    cfg->leverArm_m = 0.08f;
+    cfg->yawTorque_m = 0.015f;
+    cfg->maxThrust_N = 4.0f;
+    cfg->motorTau_s = 0.02f;
+    cfg->maxMotorFreq_Hz = 450.0f;
+    cfg->linearDrag_Nspm = 0.25f;
+    cfg->angularDrag_Nmsprad = 2e-4f;
+    cfg->physicsRate_Hz = 4000.0f;
+    cfg->groundPressure_hPa = 1013.25f;
+    cfg->temperature_C = 25.0f;
+    cfg->mag_gauss[0] = 0.2f;
+    cfg->mag_gauss[2] = -0.4f;
+}
+
+void SimVehicle_DefaultSensors(SimVehicle_SensorModel_t *sensors)
+{
+    memset(sensors, 0, sizeof(*sensors));
+    sensors->gyroNoise_rads = 0.005f;
+    sensors->accelNoise_mps2 = 0.05f;
+    sensors->magNoise_gauss = 0.003f;
+    sensors->baroNoise_hPa = 0.02f;
+    sensors->vibrationAccel_mps2 = 1.0f;
+    sensors->vibrationGyro_rads = 0.05f;
+}
+
+int SimVehicle_Init(SimVehicle_t *veh, const SimVehicle_Config_t *cfg, const SimVehicle_SensorModel_t *sensors)
+{
+    if (!veh || !cfg || !sensors || cfg->mass_kg <= 0.0f || cfg->motorTau_s <= 0.0f ||
+        cfg->physicsRate_Hz <= 0.0f || cfg->inertia_kgm2[0] <= 0.0f || cfg->inertia_kgm2[1] <= 0.0f ||
+        cfg->inertia_kgm2[2] <= 0.0f)
+    {
+        return -1;
+    }
+    if (!MIXER_IS_MOTOR_FRAME)
+    {
+        return -2; // fins need an airspeed model
+    }
+
+    memset(veh, 0, sizeof(*veh));
+    veh->config = *cfg;
+    veh->sensors = *sensors;
+    veh->rng = sensors->seed ? sensors->seed : SIM_VEHICLE_DEFAULT_SEED;
+    veh->groundAltitude_m = 44330.0f * (1.0f - powf(cfg->groundPressure_hPa / 1013.25f, 0.190295f));
+
+    // Controller axes (roll right, pitch up, yaw right) to body axes (x fwd, y left, z up)
+    for (int i = 0; i < MIXER_OUTPUTS; i++)
+    {
+        veh->motorTorque[i][0] = s_mix[i][0] * cfg->leverArm_m;
+        veh->motorTorque[i][1] = -s_mix[i][1] * cfg->leverArm_m;
+        veh->motorTorque[i][2] = -s_mix[i][2] * cfg->yawTorque_m;
+    }
+
+    veh->state.q[0] = 1.0f;
+    veh->state.onGround = true;
+    const float rest[3] = {0.0f, 0.0f, 0.0f};
+    SimVehicle_Snapshot(veh, rest, &veh->cur);
+    veh->prev = veh->cur;
+    return 0;
+}
+
+void SimVehicle_SetMotors(SimVehicle_t *veh, const float output[MIXER_OUTPUTS])
+{
+    for (int i = 0; i < MIXER_OUTPUTS; i++)
+    {
+        float u = output[i];
+        veh->command[i] = u < 0.0f ? 0.0f : (u > 1.0f ? 1.0f : u);
+    }
+}
+
+void SimVehicle_Step(SimVehicle_t *veh, uint64_t until_us)
+{
+    if (until_us <= veh->time_us)
+    {
+        return;
+    }
+
+    // Keep the phases small; prev and the live phase move together
+    veh->prev = veh->cur;
+    for (int i = 0; i < MIXER_OUTPUTS; i++)
+    {
+        float whole = floorf(veh->motorPhase[i]);
+        veh->motorPhase[i] -= whole;
+        veh->prev.motorPhase[i] -= whole;
+    }
+
+    const uint64_t step_us = (uint64_t)(1e6f / veh->config.physicsRate_Hz);
+    float accel[3] = {0.0f, 0.0f, 0.0f};
+    while (veh->time_us < until_us)
+    {
+        uint64_t dt_us = until_us - veh->time_us < step_us ? until_us - veh->time_us : step_us;
+        SimVehicle_Integrate(veh, (float)dt_us * 1e-6f, accel);
+        veh->time_us += dt_us;
+    }
+    SimVehicle_Snapshot(veh, accel, &veh->cur);
+}
+
+void SimVehicle_Profile(SimVehicle_t *veh, SilProfile_t *profile)
+{
+    profile->sample = SimVehicle_Sample;
+    profile->ctx = veh;
+}
+
+void SimVehicle_Euler(const float q[4], float euler[3])
+{
+    float w = q[0], x = q[1], y = q[2], z = q[3];
+    float s = 2.0f * (w * y - z * x);
+    s = s > 1.0f ? 1.0f : (s < -1.0f ? -1.0f : s);
+
+    // z-y-x angles about x fwd, y left, z up; pitch and yaw flip to nose up / nose right
+    euler[0] = atan2f(2.0f * (w * x + y * z), 1.0f - 2.0f * (x * x + y * y));
+    euler[1] = -asinf(s);
+    euler[2] = -atan2f(2.0f * (w * z + x * y), 1.0f - 2.0f * (y * y + z * z));
+}
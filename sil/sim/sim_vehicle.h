@@ -0,0 +1,150 @@
+#ifndef SIM_VEHICLE_H
+#define SIM_VEHICLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "mixer.h"
+#include "sil_profile.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Rigid-body multirotor for the closed-loop simulator.
+ *
+ * Frames: body x forward, y left, z up - the sensor axes, so the truth goes
+ * to the emulators unchanged. World z is up, ground at z = 0. Attitude is
+ * the body->world quaternion {w, x, y, z}.
+ *
+ * Motors are placed from the build-time MIXER_TABLE: a unit roll/pitch
+ * coefficient is leverArm_m of moment arm and a unit yaw coefficient
+ * yawTorque_m newton-metres per newton, with signs such that a positive
+ * command from FlightControl gives a positive controller-axis torque
+ * (roll right, pitch nose up, yaw nose right). Each motor's speed follows
+ * its command through a first-order lag; thrust goes with speed squared.
+ *
+ * The state is integrated at physicsRate_Hz with semi-implicit Euler. The
+ * sensor profile interpolates between the states at the start and end of
+ * the last SimVehicle_Step and adds noise, bias and the motor vibration
+ * lines, so the emulators can sample it at their own ODR.
+ */
+
+    typedef struct
+    {
+        float mass_kg;
+        float inertia_kgm2[3];     ///< Principal moments, body axes
+        float leverArm_m;          ///< Moment arm of a unit roll/pitch mixer coefficient
+        float yawTorque_m;         ///< Reaction torque per newton of thrust
+        float maxThrust_N;         ///< Per motor, full command
+        float motorTau_s;          ///< Motor speed time constant
+        float maxMotorFreq_Hz;     ///< Rotation frequency at full speed
+        float linearDrag_Nspm;     ///< Translational drag, N per m/s
+        float angularDrag_Nmsprad; ///< Rotational damping, N.m per rad/s
+        float physicsRate_Hz;      ///< Integration rate
+        float groundPressure_hPa;  ///< Static pressure at z = 0
+        float temperature_C;       ///< Die temperature of every sensor
+        float mag_gauss[3];        ///< Earth field, world frame
+    } SimVehicle_Config_t;
+
+    /**
+     * @brief Sensor imperfections added on top of the truth
+     */
+    typedef struct
+    {
+        float gyroNoise_rads;      ///< Uniform noise amplitude, per sample
+        float accelNoise_mps2;
+        float magNoise_gauss;
+        float baroNoise_hPa;
+        float gyroBias_rads[3];    ///< Constant bias, body axes
+        float accelBias_mps2[3];
+        float vibrationAccel_mps2; ///< Per motor at full speed, scales with speed squared
+        float vibrationGyro_rads;
+        uint32_t seed;             ///< Noise generator state, 0 picks a default
+    } SimVehicle_SensorModel_t;
+
+    /**
+     * @brief What the sensors see at one instant
+     */
+    typedef struct
+    {
+        uint64_t time_us;
+        float specificForce_mps2[3]; ///< Body axes, +g on z at rest
+        float rate_rads[3];          ///< Body axes
+        float mag_gauss[3];          ///< Body axes
+        float altitude_m;
+        float motorSpeed[MIXER_OUTPUTS]; ///< 0..1 of full speed
+        float motorPhase[MIXER_OUTPUTS]; ///< Revolutions, unwrapped within a step
+    } SimVehicle_Snapshot_t;
+
+    typedef struct
+    {
+        float position_m[3];   ///< World
+        float velocity_mps[3]; ///< World
+        float q[4];            ///< Body -> world {w, x, y, z}
+        float rate_rads[3];    ///< Body
+        float motorSpeed[MIXER_OUTPUTS];
+        bool onGround;
+    } SimVehicle_State_t;
+
+    typedef struct
+    {
+        SimVehicle_Config_t config;
+        SimVehicle_SensorModel_t sensors;
+
+        float motorTorque[MIXER_OUTPUTS][3]; ///< Body torque per newton of each motor's thrust
+        float command[MIXER_OUTPUTS];        ///< Motor commands 0..1, held between SetMotors calls
+        float motorPhase[MIXER_OUTPUTS];
+
+        SimVehicle_State_t state;
+        uint64_t time_us;
+        SimVehicle_Snapshot_t prev; ///< At the start of the last step
+        SimVehicle_Snapshot_t cur;  ///< At time_us
+
+        float groundAltitude_m; ///< ISA altitude of groundPressure_hPa
+        uint32_t rng;
+        float maxImpact_mps; ///< Hardest ground contact seen
+    } SimVehicle_t;
+
+    /**
+     * @brief A 0.5 kg, 5 inch class quad at sea level
+     */
+    void SimVehicle_DefaultConfig(SimVehicle_Config_t *cfg);
+
+    /**
+     * @brief Noise and vibration in the range of the board's sensors, no bias
+     */
+    void SimVehicle_DefaultSensors(SimVehicle_SensorModel_t *sensors);
+
+    /**
+     * @brief Put the vehicle level and still on the ground at t = 0
+     * @retval  0 on success, -1 on a bad configuration, -2 for servo airframes
+     */
+    int SimVehicle_Init(SimVehicle_t *veh, const SimVehicle_Config_t *cfg, const SimVehicle_SensorModel_t *sensors);
+
+    /**
+     * @brief Set the motor commands (Mixer_Output_t.output) applied from now on
+     */
+    void SimVehicle_SetMotors(SimVehicle_t *veh, const float output[MIXER_OUTPUTS]);
+
+    /**
+     * @brief Integrate the dynamics up to until_us
+     */
+    void SimVehicle_Step(SimVehicle_t *veh, uint64_t until_us);
+
+    /**
+     * @brief Sensor truth source for the emulators (valid while veh lives)
+     */
+    void SimVehicle_Profile(SimVehicle_t *veh, SilProfile_t *profile);
+
+    /**
+     * @brief Attitude in controller axes: roll right, pitch nose up, yaw nose right (rad)
+     */
+    void SimVehicle_Euler(const float q[4], float euler[3]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_VEHICLE_H
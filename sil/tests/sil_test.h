@@ -0,0 +1,46 @@
+#ifndef SIL_TEST_H
+#define SIL_TEST_H
+
+#include <math.h>
+#include <stdio.h>
+
+/*
+ * Minimal checks for the SIL tests: a failed check prints its location and
+ * the test keeps going; SilTest_Result() is the process exit code.
+ */
+
+static int s_silChecks;
+static int s_silFailures;
+
+#define SIL_CHECK(cond)                                                            \
+    do                                                                             \
+    {                                                                              \
+        s_silChecks++;                                                             \
+        if (!(cond))                                                               \
+        {                                                                          \
+            s_silFailures++;                                                       \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        }                                                                          \
+    } while (0)
+
+#define SIL_CHECK_NEAR(a, b, tol)                                                                          \
+    do                                                                                                     \
+    {                                                                                                      \
+        double silA_ = (double)(a);                                                                        \
+        double silB_ = (double)(b);                                                                        \
+        s_silChecks++;                                                                                     \
+        if (!(fabs(silA_ - silB_) <= (double)(tol)))                                                       \
+        {                                                                                                  \
+            s_silFailures++;                                                                               \
+            fprintf(stderr, "%s:%d: %s = %g, expected %g +- %g\n", __FILE__, __LINE__, #a, silA_, silB_, \
+                    (double)(tol));                                                                        \
+        }                                                                                                  \
+    } while (0)
+
+static inline int SilTest_Result(const char *name)
+{
+    printf("%s: %d checks, %d failed\n", name, s_silChecks, s_silFailures);
+    return s_silFailures ? 1 : 0;
+}
+
+#endif // SIL_TEST_H
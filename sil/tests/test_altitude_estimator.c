@@ -0,0 +1,87 @@
+#include "altitude_estimator.h"
+#include "sil_test.h"
+
+static double IsaAltitude(double pressure_hPa)
+{
+    return 44330.0 * (1.0 - pow(pressure_hPa / 1013.25, 0.190295));
+}
+
+static double IsaPressure(double altitude_m)
+{
+    return 1013.25 * pow(1.0 - altitude_m / 44330.0, 1.0 / 0.190295);
+}
+
+static void Test_PressureToAltitude(void)
+{
+    // Lookup table with linear interpolation against the closed form
+    for (float p = ALTITUDE_LUT_P_MIN_HPA; p <= ALTITUDE_LUT_P_MAX_HPA; p += 0.37f)
+    {
+        SIL_CHECK_NEAR(AltitudeEstimator_PressureToAltitude(p), IsaAltitude(p), 2.0); // interpolation error peaks near 300 hPa
+    }
+
+    // Clamped outside the table
+    SIL_CHECK(AltitudeEstimator_PressureToAltitude(50.0f) ==
+              AltitudeEstimator_PressureToAltitude(ALTITUDE_LUT_P_MIN_HPA));
+    SIL_CHECK(AltitudeEstimator_PressureToAltitude(2000.0f) ==
+              AltitudeEstimator_PressureToAltitude(ALTITUDE_LUT_P_MAX_HPA));
+}
+
+static void Test_VerticalAccel(void)
+{
+    const float level[4] = {1.0f, 0.0f, 0.0f, 0.0f};
+    const float still[3] = {0.0f, 0.0f, 9.80665f};
+    SIL_CHECK_NEAR(AltitudeEstimator_VerticalAccel(level, still), 0.0f, 1e-4);
+
+    // Rolled 90 degrees: gravity shows on body y
+    const float rolled[4] = {0.70710678f, 0.70710678f, 0.0f, 0.0f};
+    const float side[3] = {0.0f, 9.80665f, 0.0f};
+    SIL_CHECK_NEAR(AltitudeEstimator_VerticalAccel(rolled, side), 0.0f, 1e-4);
+}
+
+static void Test_Climb(void)
+{
+    AltitudeEstimator_Config_t cfg = {0.5f};
+    AltitudeEstimator_t est;
+    const float dt = 0.001f;
+    const float accelBias = 0.3f;
+    const double ground = 150.0;
+
+    SIL_CHECK(AltitudeEstimator_Init(&est, NULL) == -1);
+    SIL_CHECK(AltitudeEstimator_Init(&est, &cfg) == 0);
+
+    // First baro sample sets the reference
+    AltitudeEstimator_UpdateBaro(&est, (float)IsaPressure(ground), 0.0f);
+    SIL_CHECK(est.hasReference);
+    SIL_CHECK(est.altitude_m == 0.0f);
+
+    // Hover 10 s, then climb at 2 m/s for 5 s; accel at 1 kHz, baro at 50 Hz
+    double altitude = 0.0;
+    double climb = 0.0;
+    for (int n = 1; n <= 15000; n++)
+    {
+        double accel = 0.0;
+        if (n == 10000)
+        {
+            accel = 2.0 / dt;
+        }
+        climb += accel * dt;
+        altitude += climb * dt;
+        AltitudeEstimator_Predict(&est, (float)accel + accelBias, dt);
+        if (n % 20 == 0)
+        {
+            AltitudeEstimator_UpdateBaro(&est, (float)IsaPressure(ground + altitude), 20.0f * dt);
+        }
+    }
+
+    SIL_CHECK_NEAR(est.altitude_m, altitude, 0.5);
+    SIL_CHECK_NEAR(est.climbRate_mps, 2.0f, 0.2);
+    SIL_CHECK_NEAR(est.accelBias_mps2, accelBias, 0.1);
+}
+
+int main(void)
+{
+    Test_PressureToAltitude();
+    Test_VerticalAccel();
+    Test_Climb();
+    return SilTest_Result("altitude_estimator");
+}
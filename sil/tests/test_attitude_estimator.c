@@ -0,0 +1,97 @@
+#include "attitude_estimator.h"
+#include "sil_test.h"
+
+/*
+ * Attitude from preintegrated increments: pure rotation follows the gyro,
+ * the accel correction levels a wrong estimate, and an empty tick changes
+ * nothing.
+ */
+
+#define TEST_RATE_HZ 1000.0f
+#define TEST_GRAVITY 9.80665f
+
+static AttitudeEstimator_t s_est;
+static ImuPreint_t s_preint;
+
+/**
+ * @brief Run ticks of samplesPerTick constant samples each
+ */
+static void Run(int ticks, int samplesPerTick, const float gyro[3], const float accel[3])
+{
+    int taken = 0;
+    for (int t = 0; t < ticks; t++)
+    {
+        ImuPreint_Delta_t delta;
+        for (int n = 0; n < samplesPerTick; n++)
+        {
+            ImuPreint_AddSample(&s_preint, gyro, accel);
+        }
+        taken += ImuPreint_Take(&s_preint, &delta) == 0;
+        AttitudeEstimator_Update(&s_est, &delta);
+    }
+    SIL_CHECK(taken == ticks);
+}
+
+static void Test_GyroOnly(void)
+{
+    AttitudeEstimator_Config_t cfg = {0.0f};
+    ImuPreint_Config_t preintCfg = {TEST_RATE_HZ};
+    SIL_CHECK(AttitudeEstimator_Init(&s_est, &cfg) == 0);
+    SIL_CHECK(ImuPreint_Init(&s_preint, &preintCfg) == 0);
+
+    // 0.5 rad/s about x for 0.6 s, in ticks of 4 samples: roll right
+    const float roll[3] = {0.5f, 0.0f, 0.0f};
+    const float free[3] = {0.0f, 0.0f, 0.0f}; // free fall: no accel correction
+    float att[2];
+    Run(150, 4, roll, free);
+    AttitudeEstimator_RollPitch(&s_est, att);
+    SIL_CHECK_NEAR(att[0], 0.3f, 1e-3);
+    SIL_CHECK_NEAR(att[1], 0.0f, 1e-4);
+    SIL_CHECK(!s_est.accelUsed);
+
+    // Back, then about y: the nose goes down
+    const float back[3] = {-0.5f, 0.0f, 0.0f};
+    const float pitch[3] = {0.0f, 0.5f, 0.0f};
+    Run(150, 4, back, free);
+    Run(100, 4, pitch, free);
+    AttitudeEstimator_RollPitch(&s_est, att);
+    SIL_CHECK_NEAR(att[0], 0.0f, 1e-3);
+    SIL_CHECK_NEAR(att[1], -0.2f, 1e-3);
+}
+
+static void Test_AccelLevels(void)
+{
+    AttitudeEstimator_Config_t cfg = {1.0f};
+    ImuPreint_Config_t preintCfg = {TEST_RATE_HZ};
+    SIL_CHECK(AttitudeEstimator_Init(&s_est, &cfg) == 0);
+    SIL_CHECK(ImuPreint_Init(&s_preint, &preintCfg) == 0);
+
+    // At rest rolled 0.3 rad right: gravity leans toward +y in the body
+    const float still[3] = {0.0f, 0.0f, 0.0f};
+    const float accel[3] = {0.0f, TEST_GRAVITY * sinf(0.3f), TEST_GRAVITY * cosf(0.3f)};
+    float att[2];
+    Run(10000, 1, still, accel);
+    AttitudeEstimator_RollPitch(&s_est, att);
+    SIL_CHECK(s_est.accelUsed);
+    SIL_CHECK_NEAR(att[0], 0.3f, 1e-3);
+    SIL_CHECK_NEAR(att[1], 0.0f, 1e-3);
+}
+
+static void Test_EmptyTick(void)
+{
+    AttitudeEstimator_Config_t cfg = {1.0f};
+    SIL_CHECK(AttitudeEstimator_Init(&s_est, &cfg) == 0);
+    SIL_CHECK(AttitudeEstimator_Init(&s_est, &(AttitudeEstimator_Config_t){-1.0f}) == -1);
+
+    ImuPreint_Delta_t empty = {{0.1f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, 0.0f, 0};
+    AttitudeEstimator_Update(&s_est, &empty);
+    SIL_CHECK(s_est.q[0] == 1.0f && s_est.q[1] == 0.0f);
+}
+
+int main(void)
+{
+    Test_GyroOnly();
+    Test_AccelLevels();
+    Test_EmptyTick();
+    return SilTest_Result("attitude_estimator");
+}
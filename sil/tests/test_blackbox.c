@@ -0,0 +1,472 @@
+#include "blackbox.h"
+#include "flight_log.h"
+#include "sil_hal.h"
+#include "sil_test.h"
+#include <string.h>
+
+/*
+ * Blackbox in the stand-in flash: records come back in order, the write
+ * position survives a reset (partial block included), the ring erases
+ * ahead evenly, a full log drops instead of stalling, and the stall per
+ * Blackbox_Service call stays within its word budget. A flight log kept in
+ * it reads back across reboots and after the ring wraps, and a sector that
+ * fails to erase stalls once, not on every call.
+ */
+
+#define WORDS_PER_SERVICE 16u
+#define WORD_US 16u // stand-in program time
+#define LOOP_US 1000u
+#define RECORD_WORDS 8u
+
+static Blackbox_t s_bb;
+static const Blackbox_Config_t s_cfg = {WORDS_PER_SERVICE};
+static uint32_t s_counter; ///< Next value written
+
+/**
+ * @brief One record of consecutive counter values
+ */
+static int Write_Record(void)
+{
+    uint32_t words[RECORD_WORDS];
+    for (uint32_t i = 0; i < RECORD_WORDS; i++)
+    {
+        words[i] = s_counter + i;
+    }
+    int ret = Blackbox_Write(&s_bb, (const uint8_t *)words, sizeof(words));
+    if (ret == 0)
+    {
+        s_counter += RECORD_WORDS;
+    }
+    return ret;
+}
+
+/**
+ * @brief One control loop: a record, a bounded service call
+ * @return Virtual time spent in Blackbox_Service
+ */
+static uint64_t Run_Loop(bool allowErase)
+{
+    Write_Record();
+    uint64_t t0 = SilHal_GetTime_us();
+    Blackbox_Service(&s_bb, allowErase);
+    uint64_t stall = SilHal_GetTime_us() - t0;
+    SilHal_Advance_us(LOOP_US);
+    return stall;
+}
+
+static void Drain(void)
+{
+    Blackbox_Flush(&s_bb);
+    for (int i = 0; i < 1000 && !Blackbox_Idle(&s_bb); i++)
+    {
+        Blackbox_Service(&s_bb, false);
+    }
+    SIL_CHECK(Blackbox_Idle(&s_bb));
+}
+
+/**
+ * @brief Read every block back and check the counter runs on without gaps
+ * @return Number of counter values read, first one in *first
+ */
+static uint32_t Read_Back(uint32_t *first, int *badBlocks)
+{
+    Blackbox_Cursor_t cursor;
+    const uint8_t *payload;
+    uint16_t len;
+    uint32_t count = 0;
+    uint32_t expected = 0;
+    int ret;
+
+    *badBlocks = 0;
+    Blackbox_Rewind(&s_bb, &cursor);
+    while ((ret = Blackbox_NextBlock(&s_bb, &cursor, &payload, &len)) != 0)
+    {
+        if (ret < 0)
+        {
+            (*badBlocks)++;
+            continue;
+        }
+        SIL_CHECK(len % (RECORD_WORDS * 4u) == 0);
+        for (uint16_t i = 0; i < len / 4u; i++)
+        {
+            uint32_t v;
+            memcpy(&v, &payload[4u * i], sizeof(v));
+            if (count == 0)
+            {
+                *first = v;
+            }
+            else if (v != expected)
+            {
+                SIL_CHECK(v == expected);
+                return count;
+            }
+            expected = v + 1u;
+            count++;
+        }
+    }
+    return count;
+}
+
+static void Test_RoundTripAndStall(void)
+{
+    SilHal_FlashReset();
+    s_counter = 0;
+    SIL_CHECK(Blackbox_Init(&s_bb, &s_cfg) == 0);
+    SIL_CHECK(!s_bb.writing);
+
+    // On the ground: the first sector gets erased, the others stay as they are
+    Blackbox_Service(&s_bb, true);
+    SIL_CHECK(s_bb.state[0] == BLACKBOX_SECTOR_READY);
+    SIL_CHECK(SilHal_FlashGetStats()->erases[BLACKBOX_FIRST_SECTOR] == 1);
+
+    // In flight: 32 bytes per 1 ms loop, 64 bytes of flash per service call
+    uint64_t start = SilHal_GetTime_us();
+    uint64_t maxStall = 0;
+    for (int i = 0; i < 3000; i++)
+    {
+        uint64_t stall = Run_Loop(false);
+        maxStall = stall > maxStall ? stall : maxStall;
+    }
+    uint64_t elapsed = SilHal_GetTime_us() - start;
+    Drain();
+
+    Blackbox_Stats_t stats;
+    Blackbox_GetStats(&s_bb, &stats);
+    SIL_CHECK(stats.dropped == 0);
+    SIL_CHECK(stats.errors == 0);
+    SIL_CHECK(stats.bytesLogged == 3000u * RECORD_WORDS * 4u);
+    SIL_CHECK(maxStall <= WORDS_PER_SERVICE * WORD_US);
+    SIL_CHECK(s_bb.offset == BLACKBOX_SECTOR_HEADER_SIZE + stats.bytesProgrammed);
+    printf("logged %u bytes at %.0f bytes/s, %u blocks, %u flash bytes (%.1f%% overhead)\n", stats.bytesLogged,
+           (double)stats.bytesLogged * 1e6 / (double)elapsed, stats.blocks, stats.bytesProgrammed,
+           100.0 * (stats.bytesProgrammed - stats.bytesLogged) / stats.bytesLogged);
+    printf("worst stall per service call %llu us (budget %u words, up to %.0f bytes/s at 1 kHz)\n",
+           (unsigned long long)maxStall, WORDS_PER_SERVICE, WORDS_PER_SERVICE * 4.0 * 1e6 / LOOP_US);
+
+    uint32_t first = 0;
+    int bad;
+    SIL_CHECK(Read_Back(&first, &bad) == s_counter);
+    SIL_CHECK(first == 0);
+    SIL_CHECK(bad == 0);
+}
+
+static void Test_Recovery(void)
+{
+    // Continues the log of the previous test
+    uint32_t offset = s_bb.offset;
+    SIL_CHECK(Blackbox_Init(&s_bb, &s_cfg) == 0);
+    SIL_CHECK(s_bb.writing);
+    SIL_CHECK(s_bb.sector == 0);
+    SIL_CHECK(s_bb.offset == offset);
+
+    for (int i = 0; i < 100; i++)
+    {
+        Run_Loop(false);
+    }
+    Drain();
+    uint32_t first = 0;
+    int bad;
+    SIL_CHECK(Read_Back(&first, &bad) == s_counter);
+    SIL_CHECK(bad == 0);
+
+    // Reset in the middle of a block: its header is in flash, part of its payload is not
+    for (int i = 0; i < 10; i++)
+    {
+        Write_Record();
+    }
+    Blackbox_Flush(&s_bb);
+    Blackbox_Service(&s_bb, false);
+    SIL_CHECK(s_bb.programmed == WORDS_PER_SERVICE * 4u);
+    uint32_t partialEnd = s_bb.offset + BLACKBOX_BLOCK_HEADER_SIZE + 10u * RECORD_WORDS * 4u;
+    uint32_t lost = 10u * RECORD_WORDS;
+
+    SIL_CHECK(Blackbox_Init(&s_bb, &s_cfg) == 0);
+    SIL_CHECK(s_bb.offset == partialEnd);
+    SIL_CHECK(Read_Back(&first, &bad) == s_counter - lost);
+    SIL_CHECK(bad == 1);
+
+    // Writing goes on after it
+    s_counter -= lost;
+    for (int i = 0; i < 100; i++)
+    {
+        Run_Loop(false);
+    }
+    Drain();
+    Blackbox_Stats_t stats;
+    Blackbox_GetStats(&s_bb, &stats);
+    SIL_CHECK(stats.errors == 0);
+    SIL_CHECK(SilHal_FlashGetStats()->failures == 0);
+}
+
+static void Test_FullDrops(void)
+{
+    SilHal_FlashReset();
+    s_counter = 0;
+    SIL_CHECK(Blackbox_Init(&s_bb, &s_cfg) == 0);
+    Blackbox_Service(&s_bb, true);
+
+    // Armed the whole time: one erased sector, then drops, never an erase
+    for (int i = 0; i < 6000; i++)
+    {
+        Run_Loop(false);
+    }
+    Blackbox_Stats_t stats;
+    Blackbox_GetStats(&s_bb, &stats);
+    SIL_CHECK(stats.dropped > 0);
+    SIL_CHECK(stats.errors == 0);
+    SIL_CHECK(stats.bytesProgrammed <= BLACKBOX_SECTOR_SIZE - BLACKBOX_SECTOR_HEADER_SIZE);
+    SIL_CHECK(SilHal_FlashGetStats()->erases[BLACKBOX_FIRST_SECTOR + 1] == 0);
+    SIL_CHECK(s_bb.block[0].queued && s_bb.block[1].queued);
+
+    // Landed: the next sector is erased and the queued blocks go out
+    Blackbox_Service(&s_bb, true);
+    SIL_CHECK(s_bb.state[1] == BLACKBOX_SECTOR_USED);
+    Drain();
+    uint32_t first = 0;
+    int bad;
+    SIL_CHECK(Read_Back(&first, &bad) == s_counter);
+    SIL_CHECK(bad == 0);
+}
+
+static void Test_RingWear(void)
+{
+    SilHal_FlashReset();
+    s_counter = 0;
+    SIL_CHECK(Blackbox_Init(&s_bb, &s_cfg) == 0);
+
+    // About 10 sectors' worth, always allowed to erase ahead
+    for (int i = 0; i < 45000; i++)
+    {
+        Run_Loop(true);
+    }
+    Drain();
+
+    Blackbox_Stats_t stats;
+    Blackbox_GetStats(&s_bb, &stats);
+    SIL_CHECK(stats.dropped == 0);
+    SIL_CHECK(stats.errors == 0);
+    uint32_t minErase = stats.eraseCount[0], maxErase = stats.eraseCount[0];
+    for (int i = 1; i < BLACKBOX_SECTOR_COUNT; i++)
+    {
+        minErase = stats.eraseCount[i] < minErase ? stats.eraseCount[i] : minErase;
+        maxErase = stats.eraseCount[i] > maxErase ? stats.eraseCount[i] : maxErase;
+    }
+    SIL_CHECK(minErase >= 3);
+    SIL_CHECK(maxErase - minErase <= 1);
+    for (int i = 0; i < BLACKBOX_SECTOR_COUNT; i++)
+    {
+        SIL_CHECK(stats.eraseCount[i] == SilHal_FlashGetStats()->erases[BLACKBOX_FIRST_SECTOR + i]);
+    }
+    printf("ring: erase counts %u %u %u\n", stats.eraseCount[0], stats.eraseCount[1], stats.eraseCount[2]);
+
+    // The newest records survive, without gaps, up to the last one written
+    uint32_t first = 0;
+    int bad;
+    uint32_t count = Read_Back(&first, &bad);
+    SIL_CHECK(bad == 0);
+    SIL_CHECK(first + count == s_counter);
+    SIL_CHECK(count > BLACKBOX_SECTOR_SIZE / 4u);
+
+    // Erase counts come back from the sector headers
+    SIL_CHECK(Blackbox_Init(&s_bb, &s_cfg) == 0);
+    for (int i = 0; i < BLACKBOX_SECTOR_COUNT; i++)
+    {
+        SIL_CHECK(s_bb.stats.eraseCount[i] == stats.eraseCount[i]);
+    }
+}
+
+static void Test_FlightLogSink(void)
+{
+    SilHal_FlashReset();
+    SIL_CHECK(Blackbox_Init(&s_bb, &s_cfg) == 0);
+    SIL_CHECK(Blackbox_Erase(&s_bb) == 0);
+
+    FlightLog_t log;
+    FlightLog_Config_t cfg = {Blackbox_Write, &s_bb, {1000.0f, 1.0e-3f, 2.0e-3f}};
+    SIL_CHECK(FlightLog_Init(&log, &cfg) == 0);
+    for (uint32_t i = 0; i < 2000; i++)
+    {
+        FlightLog_Imu_t imu = {(int16_t)i, {(int16_t)i, 1, 2}, {3, 4, (int16_t)-i}};
+        SIL_CHECK(FlightLog_Imu(&log, 1000u * i, &imu) == 0);
+        SIL_CHECK(FlightLog_Loop(&log, 1000u * i) == 0);
+        Blackbox_Service(&s_bb, false);
+    }
+    Drain();
+
+    // Blocks concatenate back into the log stream
+    static uint8_t stream[64u * 1024u];
+    size_t len = 0;
+    Blackbox_Cursor_t cursor;
+    const uint8_t *payload;
+    uint16_t blockLen;
+    Blackbox_Rewind(&s_bb, &cursor);
+    while (Blackbox_NextBlock(&s_bb, &cursor, &payload, &blockLen) == 1 && len + blockLen <= sizeof(stream))
+    {
+        memcpy(&stream[len], payload, blockLen);
+        len += blockLen;
+    }
+    SIL_CHECK(len == log.stats.bytes);
+
+    FlightLog_Reader_t reader;
+    FlightLog_Record_t rec;
+    uint32_t imu = 0;
+    SIL_CHECK(FlightLog_ReaderInit(&reader, stream, len) == 0);
+    while (FlightLog_Next(&reader, &rec) == 1)
+    {
+        if (rec.type == FLIGHT_LOG_IMU)
+        {
+            SIL_CHECK(rec.data.imu.gyro[0] == (int16_t)imu);
+            imu++;
+        }
+    }
+    SIL_CHECK(imu == 2000);
+}
+
+/**
+ * @brief One power cycle as main.c runs it: erase ahead at boot, log IMU samples at 1 kHz, flush on disarm
+ */
+static void Boot_Flight(FlightLog_t *log, uint32_t samples)
+{
+    FlightLog_Config_t cfg = {Blackbox_Write, &s_bb, {1000.0f, 1.0e-3f, 2.0e-3f}};
+    SIL_CHECK(Blackbox_Init(&s_bb, &s_cfg) == 0);
+    Blackbox_Service(&s_bb, true);
+    SIL_CHECK(FlightLog_Init(log, &cfg) == 0);
+    for (uint32_t i = 0; i < samples; i++)
+    {
+        FlightLog_Imu_t imu = {(int16_t)i, {(int16_t)s_counter, 1, 2}, {3, 4, 5}};
+        SIL_CHECK(FlightLog_Imu(log, 1000u * i, &imu) == 0);
+        s_counter++;
+        Blackbox_Service(&s_bb, false);
+    }
+    Drain();
+}
+
+/**
+ * @brief Read the log back through Blackbox_Read and check the IMU counter runs on across headers
+ * @return FlightLog_ReaderInit result; the counts of IMU and HEADER records and the first counter value
+ */
+static int Read_Log(uint32_t *imu, uint32_t *headers, uint32_t *first)
+{
+    static uint8_t stream[BLACKBOX_SECTOR_COUNT * BLACKBOX_SECTOR_SIZE];
+    Blackbox_Cursor_t cursor = {0};
+    uint32_t size = Blackbox_Size(&s_bb);
+    uint32_t len = 0;
+    uint16_t n;
+    SIL_CHECK(size <= sizeof(stream));
+    while (len < size && (n = Blackbox_Read(&s_bb, &cursor, len, &stream[len], 4096)) > 0)
+    {
+        len += n;
+    }
+    SIL_CHECK(len == size);
+
+    FlightLog_Reader_t reader;
+    FlightLog_Record_t rec;
+    int init = FlightLog_ReaderInit(&reader, stream, len);
+    int ret;
+    *imu = 0;
+    *headers = 0;
+    *first = 0;
+    while ((ret = FlightLog_Next(&reader, &rec)) == 1)
+    {
+        if (rec.type == FLIGHT_LOG_HEADER)
+        {
+            SIL_CHECK(reader.time_us == 0);
+            SIL_CHECK(rec.data.header.loopRate_Hz == 1000.0f);
+            (*headers)++;
+        }
+        else if (rec.type == FLIGHT_LOG_IMU)
+        {
+            if (*imu == 0)
+            {
+                *first = (uint16_t)rec.data.imu.gyro[0];
+            }
+            SIL_CHECK(rec.data.imu.gyro[0] == (int16_t)(*first + *imu));
+            // Times restart at every boot, and are absolute after its header
+            SIL_CHECK(!reader.haveHeader || rec.time_us == 1000u * (uint16_t)rec.data.imu.temp);
+            (*imu)++;
+        }
+    }
+    SIL_CHECK(ret == 0);
+    return init;
+}
+
+static void Test_LogAcrossReboots(void)
+{
+    FlightLog_t log;
+    uint32_t imu, headers, first;
+    SilHal_FlashReset();
+    s_counter = 0;
+
+    // Two flights: the second header sits in the middle of the stream
+    Boot_Flight(&log, 2000);
+    Boot_Flight(&log, 3000);
+    SIL_CHECK(Read_Log(&imu, &headers, &first) == 0);
+    SIL_CHECK(headers == 1);
+    SIL_CHECK(first == 0);
+    SIL_CHECK(imu == 5000);
+
+    // ~100 KB flights until the first sector has been erased again: the oldest data,
+    // the first header with it, is gone and the stream starts on a plain record
+    int boots = 2;
+    while (SilHal_FlashGetStats()->erases[BLACKBOX_FIRST_SECTOR] < 2)
+    {
+        Boot_Flight(&log, 6000);
+        boots++;
+    }
+    Boot_Flight(&log, 6000);
+    boots++;
+    Blackbox_Stats_t stats;
+    Blackbox_GetStats(&s_bb, &stats);
+    SIL_CHECK(stats.dropped == 0);
+    SIL_CHECK(stats.errors == 0);
+
+    SIL_CHECK(Read_Log(&imu, &headers, &first) == 1);
+    SIL_CHECK(first > 0);
+    SIL_CHECK(s_counter <= UINT16_MAX); // the counter travels in an int16_t
+    SIL_CHECK(first + imu == s_counter);
+    SIL_CHECK(headers >= 2 && headers < (uint32_t)boots);
+    printf("wrapped log: %d boots, %u imu records from counter %u, %u headers\n", boots, imu, first, headers);
+}
+
+static void Test_EraseFailure(void)
+{
+    SilHal_FlashReset();
+    SilHal_FlashFailErase(1u << BLACKBOX_FIRST_SECTOR);
+    SIL_CHECK(Blackbox_Init(&s_bb, &s_cfg) == 0);
+
+    // One full erase stall, then the sector is left alone
+    uint64_t t0 = SilHal_GetTime_us();
+    Blackbox_Service(&s_bb, true);
+    SIL_CHECK(SilHal_GetTime_us() - t0 >= 1000000u);
+    SIL_CHECK(s_bb.state[0] == BLACKBOX_SECTOR_BAD);
+    t0 = SilHal_GetTime_us();
+    for (int i = 0; i < 100; i++)
+    {
+        Run_Loop(true);
+    }
+    SIL_CHECK(SilHal_GetTime_us() - t0 == 100u * LOOP_US);
+
+    Blackbox_Stats_t stats;
+    Blackbox_GetStats(&s_bb, &stats);
+    SIL_CHECK(stats.errors == 1);
+    SIL_CHECK(stats.dropped > 0);
+    SIL_CHECK(SilHal_FlashGetStats()->erases[BLACKBOX_FIRST_SECTOR] == 0);
+
+    // The next boot tries again
+    SilHal_FlashFailErase(0);
+    SIL_CHECK(Blackbox_Init(&s_bb, &s_cfg) == 0);
+    Blackbox_Service(&s_bb, true);
+    SIL_CHECK(s_bb.state[0] == BLACKBOX_SECTOR_READY);
+}
+
+int main(void)
+{
+    Test_RoundTripAndStall();
+    Test_Recovery();
+    Test_FullDrops();
+    Test_RingWear();
+    Test_FlightLogSink();
+    Test_LogAcrossReboots();
+    Test_EraseFailure();
+    return SilTest_Result("test_blackbox");
+}
@@ -0,0 +1,69 @@
+#include "dshot_frame.h"
+#include "sil_test.h"
+
+static void Test_EncodeFrame(void)
+{
+    // Reference frames from the DShot specification
+    SIL_CHECK(DShot_EncodeFrame(0, false) == 0x0000);
+    SIL_CHECK(DShot_EncodeFrame(1046, false) == 0x82C6);
+    SIL_CHECK(DShot_EncodeFrame(2047, true) == 0xFFFF);
+    SIL_CHECK(DShot_EncodeFrame(5000, false) == DShot_EncodeFrame(DSHOT_VALUE_MAX_THROTTLE, false));
+
+    // Every frame carries a valid 4-bit checksum
+    for (uint16_t v = 0; v <= DSHOT_VALUE_MAX_THROTTLE; v++)
+    {
+        uint16_t frame = DShot_EncodeFrame(v, (v & 1) != 0);
+        uint16_t packet = frame >> 4;
+        SIL_CHECK(((packet ^ (packet >> 4) ^ (packet >> 8)) & 0x0F) == (frame & 0x0F));
+        SIL_CHECK((packet >> 1) == v);
+    }
+}
+
+static void Test_Throttle(void)
+{
+    SIL_CHECK(DShot_ThrottleToValue(-1.0f) == DSHOT_VALUE_MIN_THROTTLE);
+    SIL_CHECK(DShot_ThrottleToValue(0.0f) == DSHOT_VALUE_MIN_THROTTLE);
+    SIL_CHECK(DShot_ThrottleToValue(1.0f) == DSHOT_VALUE_MAX_THROTTLE);
+    SIL_CHECK(DShot_ThrottleToValue(2.0f) == DSHOT_VALUE_MAX_THROTTLE);
+    SIL_CHECK(DShot_ThrottleToValue(0.5f) == 1048);
+}
+
+static void Test_Timing(void)
+{
+    DShot_BitTiming_t timing;
+
+    // TIM1 on APB2 at 84 MHz
+    SIL_CHECK(DShot_ComputeTiming(84000000u, DSHOT_SPEED_600, &timing) == 0);
+    SIL_CHECK(timing.period == 140);
+    SIL_CHECK(timing.t0h == 53);
+    SIL_CHECK(timing.t1h == 105);
+
+    SIL_CHECK(DShot_ComputeTiming(84000000u, 450, &timing) == -1);
+    SIL_CHECK(DShot_ComputeTiming(8000000u, DSHOT_SPEED_600, &timing) == -2);
+}
+
+static void Test_FillBuffer(void)
+{
+    DShot_BitTiming_t timing = {140, 53, 105};
+    uint16_t frames[2] = {0x8001, 0x0000};
+    uint32_t buffer[DSHOT_BUFFER_SLOTS * 2];
+
+    DShot_FillBuffer(frames, 2, &timing, buffer);
+
+    // [slot][motor]: MSB first, reset slots at zero duty
+    SIL_CHECK(buffer[0] == 105);
+    SIL_CHECK(buffer[1] == 53);
+    SIL_CHECK(buffer[2] == 53);
+    SIL_CHECK(buffer[15 * 2] == 105);
+    SIL_CHECK(buffer[16 * 2] == 0);
+    SIL_CHECK(buffer[17 * 2 + 1] == 0);
+}
+
+int main(void)
+{
+    Test_EncodeFrame();
+    Test_Throttle();
+    Test_Timing();
+    Test_FillBuffer();
+    return SilTest_Result("dshot_frame");
+}
@@ -0,0 +1,391 @@
+#include "blackbox.h"
+#include "event_capture.h"
+#include "flight_log.h"
+#include "sil_hal.h"
+#include "sil_test.h"
+#include "sim_replay.h"
+#include <string.h>
+
+/*
+ * Event capture: the pre- and post-windows around a trigger come out in
+ * order, a slow sink only delays the flush, the accel detectors fire, and
+ * the flight log sink writes an EVENT followed by CAPTURE records, holding
+ * on to them while the log refuses them, and the replay runs the captured
+ * samples through the loop.
+ */
+
+#define RING_SAMPLES 100u
+#define PRE_SAMPLES 30u
+#define POST_SAMPLES 20u
+#define ACCEL_SCALE_G (LSM6DSO32_ACCEL_SENS_8G_MG * 1e-3f)
+#define ONE_G_LSB 4098
+
+typedef struct
+{
+    EventCapture_Event_t event;
+    int events;
+    uint32_t times[RING_SAMPLES];
+    uint32_t samples;
+    int refuseEvery; ///< Refuse every n-th call, 0 never
+    int calls;
+} Collector_t;
+
+static SensorIMU_Sample_t s_ring[RING_SAMPLES];
+static EventCapture_t s_cap;
+static Collector_t s_out;
+
+static int Collect(void *ctx, const EventCapture_Event_t *event, const SensorIMU_Sample_t *sample)
+{
+    Collector_t *c = ctx;
+    c->calls++;
+    if (c->refuseEvery && c->calls % c->refuseEvery == 0)
+    {
+        return -1;
+    }
+    if (!sample)
+    {
+        c->event = *event;
+        c->events++;
+        c->samples = 0;
+        return 0;
+    }
+    if (c->samples < RING_SAMPLES)
+    {
+        c->times[c->samples] = sample->time_us;
+    }
+    c->samples++;
+    return 0;
+}
+
+static void Capture_Open(float launch_g, float crash_g)
+{
+    memset(&s_out, 0, sizeof(s_out));
+    EventCapture_Config_t cfg = {
+        .ring = s_ring,
+        .capacity = RING_SAMPLES,
+        .preSamples = PRE_SAMPLES,
+        .postSamples = POST_SAMPLES,
+        .accelScale_g = ACCEL_SCALE_G,
+        .launchAccel_g = launch_g,
+        .launchSamples = 5,
+        .crashAccel_g = crash_g,
+        .sink = Collect,
+        .ctx = &s_out,
+        .samplesPerService = 4,
+    };
+    SIL_CHECK(EventCapture_Init(&s_cap, &cfg) == 0);
+}
+
+static void Push(uint32_t i, int16_t accelZ)
+{
+    SensorIMU_Sample_t s = {.time_us = i * 1000u, .temp = 0, .accel = {0, 0, accelZ}};
+    EventCapture_Push(&s_cap, &s);
+}
+
+static void Test_Windows(void)
+{
+    Capture_Open(0.0f, 0.0f);
+    for (uint32_t i = 0; i < 250; i++)
+    {
+        if (i == 200)
+        {
+            SIL_CHECK(EventCapture_Trigger(&s_cap, EVENT_CAPTURE_TRIGGER_COMMAND) == 0);
+        }
+        Push(i, ONE_G_LSB);
+        EventCapture_Service(&s_cap);
+    }
+    SIL_CHECK(s_cap.state == EVENT_CAPTURE_ARMED);
+    SIL_CHECK(s_out.events == 1);
+    SIL_CHECK(s_out.event.trigger == EVENT_CAPTURE_TRIGGER_COMMAND);
+    SIL_CHECK(s_out.event.time_us == 200000u);
+    SIL_CHECK(s_out.event.preSamples == PRE_SAMPLES);
+    SIL_CHECK(s_out.event.postSamples == POST_SAMPLES);
+    SIL_CHECK(s_out.samples == PRE_SAMPLES + POST_SAMPLES);
+    for (uint32_t k = 0; k < s_out.samples; k++)
+    {
+        SIL_CHECK(s_out.times[k] == (171u + k) * 1000u);
+    }
+    SIL_CHECK(s_cap.stats.missed == 0);
+    SIL_CHECK(s_cap.stats.flushed == PRE_SAMPLES + POST_SAMPLES);
+
+    // Ring not full yet: a shorter pre-window
+    Capture_Open(0.0f, 0.0f);
+    for (uint32_t i = 0; i < 40; i++)
+    {
+        if (i == 10)
+        {
+            EventCapture_Trigger(&s_cap, EVENT_CAPTURE_TRIGGER_BUTTON);
+        }
+        Push(i, ONE_G_LSB);
+        EventCapture_Service(&s_cap);
+    }
+    SIL_CHECK(s_out.event.preSamples == 11);
+    SIL_CHECK(s_out.samples == 11 + POST_SAMPLES);
+    SIL_CHECK(s_out.times[0] == 0);
+
+    SIL_CHECK(EventCapture_Init(&s_cap, &(EventCapture_Config_t){.ring = s_ring,
+                                                                  .capacity = RING_SAMPLES,
+                                                                  .preSamples = 90,
+                                                                  .postSamples = 20,
+                                                                  .sink = Collect,
+                                                                  .samplesPerService = 1}) == -2);
+}
+
+static void Test_SlowSink(void)
+{
+    Capture_Open(0.0f, 0.0f);
+    s_out.refuseEvery = 2;
+    for (uint32_t i = 0; i < 300; i++)
+    {
+        if (i == 150)
+        {
+            SIL_CHECK(EventCapture_Trigger(&s_cap, EVENT_CAPTURE_TRIGGER_COMMAND) == 0);
+        }
+        if (i == 160)
+        {
+            // During the post-window
+            SIL_CHECK(EventCapture_Trigger(&s_cap, EVENT_CAPTURE_TRIGGER_BUTTON) == -1);
+        }
+        Push(i, ONE_G_LSB);
+        EventCapture_Service(&s_cap);
+    }
+    SIL_CHECK(s_out.events == 1);
+    SIL_CHECK(s_out.samples == PRE_SAMPLES + POST_SAMPLES);
+    for (uint32_t k = 0; k < s_out.samples; k++)
+    {
+        SIL_CHECK(s_out.times[k] == (121u + k) * 1000u);
+    }
+    SIL_CHECK(s_cap.stats.ignored == 1);
+    SIL_CHECK(s_cap.stats.missed > 0); // two items per service do not keep up with the post-window
+    SIL_CHECK(s_cap.state == EVENT_CAPTURE_ARMED);
+}
+
+static void Test_Detectors(void)
+{
+    Capture_Open(2.0f, 7.0f);
+    for (uint32_t i = 0; i < 200; i++)
+    {
+        // 2.5 g from 100 on; 7.3 g once at 180
+        int16_t z = i < 100 ? ONE_G_LSB : (int16_t)(2.5f * ONE_G_LSB);
+        Push(i, i == 180 ? 30000 : z);
+        EventCapture_Service(&s_cap);
+    }
+    SIL_CHECK(s_cap.stats.events == 2);
+    SIL_CHECK(s_out.events == 2);
+    SIL_CHECK(s_out.event.trigger == EVENT_CAPTURE_TRIGGER_CRASH);
+    SIL_CHECK(s_out.event.time_us == 180000u);
+    SIL_CHECK(s_cap.launched);
+
+    // The launch was the first event, at its fifth sample above 2 g
+    Capture_Open(2.0f, 0.0f);
+    for (uint32_t i = 0; i < 200; i++)
+    {
+        Push(i, i < 100 ? ONE_G_LSB : (int16_t)(2.5f * ONE_G_LSB));
+        EventCapture_Service(&s_cap);
+    }
+    SIL_CHECK(s_cap.stats.events == 1);
+    SIL_CHECK(s_out.event.trigger == EVENT_CAPTURE_TRIGGER_LAUNCH);
+    SIL_CHECK(s_out.event.time_us == 104000u);
+}
+
+static uint8_t s_logData[8192];
+static size_t s_logLen;
+
+typedef struct
+{
+    uint32_t outputs;
+    uint32_t lastTime_us;
+    uint32_t backwards; ///< Outputs stamped before the previous one
+} Replayed_t;
+
+static void Replay_Output(void *ctx, const SimLoop_Output_t *out)
+{
+    Replayed_t *r = ctx;
+    if (r->outputs && out->time_us < r->lastTime_us)
+    {
+        r->backwards++;
+    }
+    r->lastTime_us = out->time_us;
+    r->outputs++;
+}
+
+static int Log_Sink(void *ctx, const uint8_t *data, uint16_t len)
+{
+    (void)ctx;
+    if (s_logLen + len > sizeof(s_logData))
+    {
+        return -1;
+    }
+    memcpy(&s_logData[s_logLen], data, len);
+    s_logLen += len;
+    return 0;
+}
+
+static void Test_LogSink(void)
+{
+    FlightLog_t log;
+    FlightLog_Config_t logCfg = {Log_Sink, NULL, {1000.0f, 1.0e-3f, 2.0e-3f}};
+    s_logLen = 0;
+    SIL_CHECK(FlightLog_Init(&log, &logCfg) == 0);
+
+    EventCapture_Config_t cfg = {
+        .ring = s_ring,
+        .capacity = RING_SAMPLES,
+        .preSamples = PRE_SAMPLES,
+        .postSamples = POST_SAMPLES,
+        .sink = EventCapture_LogSink,
+        .ctx = &log,
+        .samplesPerService = 4,
+    };
+    SIL_CHECK(EventCapture_Init(&s_cap, &cfg) == 0);
+    for (uint32_t i = 0; i < 200; i++)
+    {
+        if (i == 100)
+        {
+            EventCapture_Trigger(&s_cap, EVENT_CAPTURE_TRIGGER_BUTTON);
+        }
+        SensorIMU_Sample_t s = {.time_us = i * 1000u, .temp = (int16_t)i, .gyro = {(int16_t)i, 0, 0}};
+        EventCapture_Push(&s_cap, &s);
+        FlightLog_Loop(&log, i * 1000u);
+        EventCapture_Service(&s_cap);
+    }
+
+    FlightLog_Reader_t reader;
+    FlightLog_Record_t rec;
+    int events = 0;
+    uint32_t captured = 0, loops = 0;
+    SIL_CHECK(FlightLog_ReaderInit(&reader, s_logData, s_logLen) == 0);
+    while (FlightLog_Next(&reader, &rec) == 1)
+    {
+        switch (rec.type)
+        {
+        case FLIGHT_LOG_EVENT:
+            events++;
+            SIL_CHECK(rec.time_us == 100000u);
+            SIL_CHECK(rec.data.event.trigger == EVENT_CAPTURE_TRIGGER_BUTTON);
+            SIL_CHECK(rec.data.event.preSamples == PRE_SAMPLES);
+            break;
+        case FLIGHT_LOG_CAPTURE:
+            // Own timestamps, back in time from the loop records around them
+            SIL_CHECK(rec.time_us == (71u + captured) * 1000u);
+            SIL_CHECK(rec.data.imu.gyro[0] == (int16_t)(71u + captured));
+            captured++;
+            break;
+        case FLIGHT_LOG_LOOP:
+            SIL_CHECK(rec.time_us == loops * 1000u);
+            loops++;
+            break;
+        default:
+            SIL_CHECK(0);
+            break;
+        }
+    }
+    SIL_CHECK(events == 1);
+    SIL_CHECK(captured == PRE_SAMPLES + POST_SAMPLES);
+    SIL_CHECK(loops == 200);
+
+    // Replay: every captured sample is an iteration at its own time
+    static SimLoop_t loop;
+    SimLoop_Config_t loopCfg;
+    SimReplay_Stats_t stats;
+    Replayed_t replayed = {0, 0, 0};
+    SimLoop_DefaultConfig(&loopCfg);
+    SIL_CHECK(FlightLog_ReaderInit(&reader, s_logData, s_logLen) == 0);
+    SimReplay_Configure(&loopCfg, &reader.header);
+    SIL_CHECK(SimLoop_Init(&loop, &loopCfg) == 0);
+    SIL_CHECK(SimReplay_Run(&loop, &reader, Replay_Output, &replayed, &stats) == 0);
+    SIL_CHECK(stats.events == 1);
+    SIL_CHECK(stats.captures == PRE_SAMPLES + POST_SAMPLES);
+    SIL_CHECK(stats.loops == 200);
+    SIL_CHECK(replayed.outputs == stats.loops + stats.captures);
+    SIL_CHECK(replayed.backwards > 0); // capture samples interleave with later loop records
+}
+
+static void Test_LogSinkRefused(void)
+{
+    // Blackbox with no erased sector: its two RAM blocks fill, then it refuses
+    static Blackbox_t bb;
+    const Blackbox_Config_t bbCfg = {16};
+    SilHal_FlashReset();
+    SIL_CHECK(Blackbox_Init(&bb, &bbCfg) == 0);
+
+    FlightLog_t log;
+    FlightLog_Config_t logCfg = {Blackbox_Write, &bb, {1000.0f, 1.0e-3f, 2.0e-3f}};
+    SIL_CHECK(FlightLog_Init(&log, &logCfg) == 0);
+    EventCapture_Config_t cfg = {
+        .ring = s_ring,
+        .capacity = RING_SAMPLES,
+        .preSamples = PRE_SAMPLES,
+        .postSamples = POST_SAMPLES,
+        .sink = EventCapture_LogSink,
+        .ctx = &log,
+        .samplesPerService = 4,
+    };
+    SIL_CHECK(EventCapture_Init(&s_cap, &cfg) == 0);
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        FlightLog_Loop(&log, i * 1000u);
+        Blackbox_Service(&bb, false);
+    }
+    SIL_CHECK(Blackbox_Write(&bb, (const uint8_t *)"x", 1) == -1);
+
+    // The capture completes but waits: nothing counts as flushed
+    EventCapture_Trigger(&s_cap, EVENT_CAPTURE_TRIGGER_BUTTON);
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        SensorIMU_Sample_t s = {.time_us = 1000000u + i * 1000u, .gyro = {(int16_t)i, 0, 0}};
+        EventCapture_Push(&s_cap, &s);
+        SIL_CHECK(EventCapture_Service(&s_cap) == 0);
+    }
+    SIL_CHECK(s_cap.state == EVENT_CAPTURE_FLUSH);
+    SIL_CHECK(!s_cap.eventSent);
+    SIL_CHECK(s_cap.stats.flushed == 0);
+
+    // Erased space: the whole capture goes out after all
+    Blackbox_Service(&bb, true);
+    for (int i = 0; i < 1000 && s_cap.state != EVENT_CAPTURE_ARMED; i++)
+    {
+        EventCapture_Service(&s_cap);
+        Blackbox_Service(&bb, false);
+    }
+    SIL_CHECK(s_cap.state == EVENT_CAPTURE_ARMED);
+    SIL_CHECK(s_cap.stats.flushed == POST_SAMPLES + 1u);
+    Blackbox_Flush(&bb);
+    for (int i = 0; i < 1000 && !Blackbox_Idle(&bb); i++)
+    {
+        Blackbox_Service(&bb, false);
+    }
+
+    static uint8_t stream[8192];
+    Blackbox_Cursor_t cursor = {0};
+    uint16_t len = Blackbox_Read(&bb, &cursor, 0, stream, sizeof(stream));
+    FlightLog_Reader_t reader;
+    FlightLog_Record_t rec;
+    int events = 0;
+    uint32_t captured = 0;
+    SIL_CHECK(FlightLog_ReaderInit(&reader, stream, len) == 0);
+    while (FlightLog_Next(&reader, &rec) == 1)
+    {
+        if (rec.type == FLIGHT_LOG_EVENT)
+        {
+            events++;
+        }
+        else if (rec.type == FLIGHT_LOG_CAPTURE)
+        {
+            SIL_CHECK(rec.data.imu.gyro[0] == (int16_t)captured);
+            captured++;
+        }
+    }
+    SIL_CHECK(events == 1);
+    SIL_CHECK(captured == POST_SAMPLES + 1u);
+}
+
+int main(void)
+{
+    Test_Windows();
+    Test_SlowSink();
+    Test_Detectors();
+    Test_LogSink();
+    Test_LogSinkRefused();
+    return SilTest_Result("test_event_capture");
+}
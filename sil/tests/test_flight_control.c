@@ -0,0 +1,181 @@
+#include "flight_control.h"
+#include "sil_test.h"
+#include <string.h>
+
+#define TEST_LOOP_HZ 1000.0f
+#define TEST_PLANT_GAIN 200.0f // rad/s^2 per unit torque
+
+static void MakeConfig(FlightControl_Config_t *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->loopRate_Hz = TEST_LOOP_HZ;
+    cfg->angleKp[0] = 6.0f;
+    cfg->angleKp[1] = 6.0f;
+    cfg->maxAngle_rad = 0.6f;
+    cfg->dTermCutoff_Hz = 100.0f;
+    cfg->setpointCutoff_Hz = 0.0f;
+    for (int i = 0; i < FLIGHT_AXIS_COUNT; i++)
+    {
+        cfg->maxRate_rads[i] = 10.0f;
+        cfg->rate[i] = (FlightControl_RateGains_t){0.1f, 0.5f, 0.0005f, 0.0f, 0.3f, 1.0f};
+    }
+}
+
+/**
+ * @brief Rigid body with a pure torque-to-acceleration plant, one step per loop
+ */
+static void Plant_Step(FlightControl_State_t *state, const FlightControl_Output_t *out)
+{
+    const float dt = 1.0f / TEST_LOOP_HZ;
+    for (int i = 0; i < FLIGHT_AXIS_COUNT; i++)
+    {
+        state->rate_rads[i] += TEST_PLANT_GAIN * out->torque[i] * dt;
+        if (i < 2)
+        {
+            state->attitude_rad[i] += state->rate_rads[i] * dt;
+        }
+    }
+}
+
+static void Test_Init(void)
+{
+    FlightControl_Config_t cfg;
+    MakeConfig(&cfg);
+    cfg.loopRate_Hz = 0.0f;
+    SIL_CHECK(FlightControl_Init(&cfg) == -1);
+    MakeConfig(&cfg);
+    cfg.rate[FLIGHT_AXIS_YAW].outLimit = 0.0f;
+    SIL_CHECK(FlightControl_Init(&cfg) == -2);
+}
+
+static void Test_Disarmed(void)
+{
+    FlightControl_Config_t cfg;
+    FlightControl_State_t state = {{0.2f, -0.1f}, {1.0f, -2.0f, 0.5f}};
+    FlightControl_Setpoint_t sp = {FLIGHT_MODE_RATE, false, 3.0f, 3.0f, 3.0f, 0.7f};
+    FlightControl_Output_t out;
+
+    MakeConfig(&cfg);
+    SIL_CHECK(FlightControl_Init(&cfg) == 0);
+    FlightControl_Update(&state, &sp, &out);
+    for (int i = 0; i < FLIGHT_AXIS_COUNT; i++)
+    {
+        SIL_CHECK(out.torque[i] == 0.0f);
+    }
+    SIL_CHECK(out.throttle == 0.0f);
+}
+
+static void Test_RateTracking(void)
+{
+    FlightControl_Config_t cfg;
+    FlightControl_State_t state;
+    FlightControl_Setpoint_t sp = {FLIGHT_MODE_RATE, true, 2.0f, -1.0f, 0.5f, 0.4f};
+    FlightControl_Output_t out;
+
+    MakeConfig(&cfg);
+    SIL_CHECK(FlightControl_Init(&cfg) == 0);
+    memset(&state, 0, sizeof(state));
+    for (int n = 0; n < 1000; n++)
+    {
+        FlightControl_Update(&state, &sp, &out);
+        Plant_Step(&state, &out);
+    }
+    SIL_CHECK_NEAR(state.rate_rads[FLIGHT_AXIS_ROLL], 2.0f, 0.02);
+    SIL_CHECK_NEAR(state.rate_rads[FLIGHT_AXIS_PITCH], -1.0f, 0.02);
+    SIL_CHECK_NEAR(state.rate_rads[FLIGHT_AXIS_YAW], 0.5f, 0.02);
+    SIL_CHECK(out.throttle == 0.4f);
+}
+
+static void Test_AngleMode(void)
+{
+    FlightControl_Config_t cfg;
+    FlightControl_State_t state;
+    FlightControl_Setpoint_t sp = {FLIGHT_MODE_ANGLE, true, 0.3f, 1.0f, 0.0f, 0.5f};
+    FlightControl_Output_t out;
+
+    MakeConfig(&cfg);
+    SIL_CHECK(FlightControl_Init(&cfg) == 0);
+    memset(&state, 0, sizeof(state));
+    for (int n = 0; n < 3000; n++)
+    {
+        FlightControl_Update(&state, &sp, &out);
+        Plant_Step(&state, &out);
+    }
+    SIL_CHECK_NEAR(state.attitude_rad[0], 0.3f, 0.01);
+    SIL_CHECK_NEAR(state.attitude_rad[1], cfg.maxAngle_rad, 0.01); // clamped
+}
+
+static void Test_AntiWindup(void)
+{
+    FlightControl_Config_t cfg;
+    FlightControl_State_t state;
+    FlightControl_Setpoint_t sp = {FLIGHT_MODE_RATE, true, 5.0f, 0.0f, 0.0f, 0.5f};
+    FlightControl_Output_t out;
+
+    // Stuck airframe: the output saturates, the integrator must not run away
+    MakeConfig(&cfg);
+    SIL_CHECK(FlightControl_Init(&cfg) == 0);
+    memset(&state, 0, sizeof(state));
+    for (int n = 0; n < 5000; n++)
+    {
+        FlightControl_Update(&state, &sp, &out);
+        SIL_CHECK(out.torque[FLIGHT_AXIS_ROLL] <= cfg.rate[FLIGHT_AXIS_ROLL].outLimit);
+    }
+
+    // The integrator stopped at iLimit; once free, P and D have nothing to add
+    sp.roll = 0.0f;
+    FlightControl_Update(&state, &sp, &out);
+    SIL_CHECK_NEAR(out.torque[FLIGHT_AXIS_ROLL], cfg.rate[FLIGHT_AXIS_ROLL].iLimit, 1e-6);
+    for (int n = 0; n < 1000; n++)
+    {
+        Plant_Step(&state, &out);
+        FlightControl_Update(&state, &sp, &out);
+    }
+    SIL_CHECK_NEAR(state.rate_rads[FLIGHT_AXIS_ROLL], 0.0f, 0.05);
+}
+
+static void Test_FeedForward(void)
+{
+    FlightControl_Config_t cfg;
+    FlightControl_State_t state;
+    FlightControl_Setpoint_t sp = {FLIGHT_MODE_RATE, false, 2.0f, 0.0f, 0.0f, 0.5f};
+    FlightControl_Output_t out;
+
+    // Feed-forward only, 0.05 torque per rad/s of setpoint step
+    MakeConfig(&cfg);
+    for (int i = 0; i < FLIGHT_AXIS_COUNT; i++)
+    {
+        cfg.rate[i] = (FlightControl_RateGains_t){0.0f, 0.0f, 0.0f, 0.00005f, 0.3f, 1.0f};
+    }
+    SIL_CHECK(FlightControl_Init(&cfg) == 0);
+    memset(&state, 0, sizeof(state));
+    FlightControl_Update(&state, &sp, &out);
+
+    // Arming with the sticks deflected does not kick
+    sp.armed = true;
+    FlightControl_Update(&state, &sp, &out);
+    SIL_CHECK(out.torque[FLIGHT_AXIS_ROLL] == 0.0f);
+    sp.roll = 3.0f;
+    FlightControl_Update(&state, &sp, &out);
+    SIL_CHECK_NEAR(out.torque[FLIGHT_AXIS_ROLL], 0.05f, 1e-6);
+
+    // Neither does switching to angle mode, where the rate setpoint comes from the outer loop
+    sp.mode = FLIGHT_MODE_ANGLE;
+    sp.roll = 0.3f;
+    FlightControl_Update(&state, &sp, &out);
+    SIL_CHECK(out.torque[FLIGHT_AXIS_ROLL] == 0.0f);
+    sp.roll = 0.2f;
+    FlightControl_Update(&state, &sp, &out);
+    SIL_CHECK_NEAR(out.torque[FLIGHT_AXIS_ROLL], -6.0f * 0.1f * 0.05f, 1e-6);
+}
+
+int main(void)
+{
+    Test_Init();
+    Test_Disarmed();
+    Test_RateTracking();
+    Test_AngleMode();
+    Test_AntiWindup();
+    Test_FeedForward();
+    return SilTest_Result("flight_control");
+}
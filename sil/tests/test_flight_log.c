@@ -0,0 +1,233 @@
+#include "flight_log.h"
+#include "sil_hal.h"
+#include "sil_test.h"
+#include "sim_flight.h"
+#include "sim_replay.h"
+#include <string.h>
+
+/*
+ * Flight log records round trip through the reader, drops are reported
+ * with GAP records, and a recorded closed-loop flight replays through
+ * SimLoop to the same outputs, bit for bit.
+ */
+
+#define LOG_CAPACITY (256u * 1024u)
+#define FLIGHT_LOOPS 3000u
+
+typedef struct
+{
+    uint8_t data[LOG_CAPACITY];
+    size_t len;
+    size_t capacity; ///< Accept up to here
+} Log_Buffer_t;
+
+static Log_Buffer_t s_buffer;
+static FlightLog_t s_log;
+static SimFlight_t s_sim;
+static SimLoop_t s_loop;
+static SimLoop_Output_t s_recorded[FLIGHT_LOOPS];
+
+static int Log_Sink(void *ctx, const uint8_t *data, uint16_t len)
+{
+    Log_Buffer_t *b = ctx;
+    if (b->len + len > b->capacity)
+    {
+        return -1;
+    }
+    memcpy(&b->data[b->len], data, len);
+    b->len += len;
+    return 0;
+}
+
+static void Log_Open(size_t capacity)
+{
+    s_buffer.len = 0;
+    s_buffer.capacity = capacity;
+    FlightLog_Config_t cfg = {Log_Sink, &s_buffer, {1000.0f, 1.0e-3f, 2.0e-3f}};
+    SIL_CHECK(FlightLog_Init(&s_log, &cfg) == 0);
+}
+
+static void Test_RoundTrip(void)
+{
+    Log_Open(LOG_CAPACITY);
+    SIL_CHECK(s_buffer.len == FLIGHT_LOG_HEADER_SIZE);
+
+    FlightLog_Imu_t imu = {-1234, {32767, -32768, 5}, {-7, 4096, -4096}};
+    FlightLog_Baro_t baro = {-0x123456, -2500};
+    int16_t mag[3] = {100, -200, 300};
+    FlightControl_Setpoint_t sp = {FLIGHT_MODE_ANGLE, true, 0.25f, -0.5f, 1.5f, 0.625f};
+
+    SIL_CHECK(FlightLog_Imu(&s_log, 100, &imu) == 0);
+    SIL_CHECK(FlightLog_Baro(&s_log, 100, &baro) == 0);
+    SIL_CHECK(FlightLog_Mag(&s_log, 1000100, mag) == 0);
+    SIL_CHECK(FlightLog_Setpoint(&s_log, 1000100, &sp) == 0);
+    SIL_CHECK(FlightLog_Setpoint(&s_log, 1000200, &sp) == 0); // unchanged: not written
+    SIL_CHECK(FlightLog_Loop(&s_log, 0xFFFFFFF0u) == 0);
+    SIL_CHECK(FlightLog_Loop(&s_log, 0x10u) == 0); // across the 32-bit wrap
+    SIL_CHECK(s_log.stats.records == 6);
+    SIL_CHECK(s_log.stats.bytes == s_buffer.len);
+
+    // -0.0f is a different payload
+    sp.roll = 0.0f;
+    SIL_CHECK(FlightLog_Setpoint(&s_log, 0x20u, &sp) == 0);
+    sp.roll = -0.0f;
+    SIL_CHECK(FlightLog_Setpoint(&s_log, 0x20u, &sp) == 0);
+    SIL_CHECK(s_log.stats.records == 8);
+
+    FlightLog_Reader_t reader;
+    FlightLog_Record_t rec;
+    SIL_CHECK(FlightLog_ReaderInit(&reader, s_buffer.data, s_buffer.len) == 0);
+    SIL_CHECK(reader.header.loopRate_Hz == 1000.0f);
+    SIL_CHECK(reader.header.accelScale == 2.0e-3f);
+
+    SIL_CHECK(FlightLog_Next(&reader, &rec) == 1);
+    SIL_CHECK(rec.type == FLIGHT_LOG_IMU && rec.time_us == 100);
+    SIL_CHECK(memcmp(&rec.data.imu, &imu, sizeof(imu)) == 0);
+    SIL_CHECK(FlightLog_Next(&reader, &rec) == 1);
+    SIL_CHECK(rec.type == FLIGHT_LOG_BARO && rec.time_us == 100);
+    SIL_CHECK(rec.data.baro.pressure == -0x123456 && rec.data.baro.temp == -2500);
+    SIL_CHECK(FlightLog_Next(&reader, &rec) == 1);
+    SIL_CHECK(rec.type == FLIGHT_LOG_MAG && rec.time_us == 1000100);
+    SIL_CHECK(memcmp(rec.data.mag, mag, sizeof(mag)) == 0);
+    SIL_CHECK(FlightLog_Next(&reader, &rec) == 1);
+    SIL_CHECK(rec.type == FLIGHT_LOG_SETPOINT && rec.data.setpoint.armed);
+    SIL_CHECK(rec.data.setpoint.mode == FLIGHT_MODE_ANGLE && rec.data.setpoint.roll == 0.25f);
+    SIL_CHECK(rec.data.setpoint.pitch == -0.5f && rec.data.setpoint.throttle == 0.625f);
+    SIL_CHECK(FlightLog_Next(&reader, &rec) == 1);
+    SIL_CHECK(rec.type == FLIGHT_LOG_LOOP && rec.time_us == 0xFFFFFFF0u);
+    SIL_CHECK(FlightLog_Next(&reader, &rec) == 1);
+    SIL_CHECK(rec.type == FLIGHT_LOG_LOOP && rec.time_us == 0x10u);
+    SIL_CHECK(FlightLog_Next(&reader, &rec) == 1);
+    SIL_CHECK(FlightLog_Next(&reader, &rec) == 1);
+    SIL_CHECK(rec.type == FLIGHT_LOG_SETPOINT && signbit(rec.data.setpoint.roll));
+    SIL_CHECK(FlightLog_Next(&reader, &rec) == 0);
+
+    // Truncated record, foreign data, other version
+    SIL_CHECK(FlightLog_ReaderInit(&reader, s_buffer.data, FLIGHT_LOG_HEADER_SIZE + 5) == 0);
+    SIL_CHECK(FlightLog_Next(&reader, &rec) == -1);
+    SIL_CHECK(FlightLog_ReaderInit(&reader, s_buffer.data, FLIGHT_LOG_HEADER_SIZE - 1) == -1);
+    s_buffer.data[4] = FLIGHT_LOG_VERSION + 1;
+    SIL_CHECK(FlightLog_ReaderInit(&reader, s_buffer.data, s_buffer.len) == -2);
+    s_buffer.data[0] = 'X';
+    SIL_CHECK(FlightLog_ReaderInit(&reader, s_buffer.data, s_buffer.len) == -1);
+}
+
+static void Test_Drops(void)
+{
+    // Room for the header and one loop mark
+    Log_Open(FLIGHT_LOG_HEADER_SIZE + 2);
+    SIL_CHECK(FlightLog_Loop(&s_log, 10) == 0);
+    SIL_CHECK(FlightLog_Loop(&s_log, 20) != 0);
+    SIL_CHECK(FlightLog_Loop(&s_log, 30) != 0);
+    SIL_CHECK(s_log.stats.dropped == 2);
+
+    // Space again: a GAP with the count comes first
+    s_buffer.capacity = LOG_CAPACITY;
+    SIL_CHECK(FlightLog_Loop(&s_log, 40) == 0);
+
+    FlightLog_Reader_t reader;
+    FlightLog_Record_t rec;
+    SIL_CHECK(FlightLog_ReaderInit(&reader, s_buffer.data, s_buffer.len) == 0);
+    SIL_CHECK(FlightLog_Next(&reader, &rec) == 1 && rec.type == FLIGHT_LOG_LOOP && rec.time_us == 10);
+    SIL_CHECK(FlightLog_Next(&reader, &rec) == 1 && rec.type == FLIGHT_LOG_GAP && rec.data.gap == 2);
+    SIL_CHECK(FlightLog_Next(&reader, &rec) == 1 && rec.type == FLIGHT_LOG_LOOP && rec.time_us == 40);
+    SIL_CHECK(FlightLog_Next(&reader, &rec) == 0);
+}
+
+typedef struct
+{
+    uint32_t loops;
+    uint32_t mismatches;
+} Compare_t;
+
+static void Compare_Output(void *ctx, const SimLoop_Output_t *out)
+{
+    Compare_t *c = ctx;
+    if (c->loops >= FLIGHT_LOOPS || memcmp(out, &s_recorded[c->loops], sizeof(*out)) != 0)
+    {
+        c->mismatches++;
+    }
+    c->loops++;
+}
+
+static void Test_Replay(void)
+{
+    SimFlight_Config_t cfg;
+    SimFlight_DefaultConfig(&cfg);
+    SIL_CHECK(SimFlight_Init(&s_sim, &cfg) == 0);
+
+    s_buffer.len = 0;
+    s_buffer.capacity = LOG_CAPACITY;
+    FlightLog_Config_t logCfg = {Log_Sink, &s_buffer,
+                                 {cfg.loop.control.loopRate_Hz, cfg.loop.gyroScale, cfg.loop.accelScale}};
+    SIL_CHECK(FlightLog_Init(&s_log, &logCfg) == 0);
+    SimFlight_SetLog(&s_sim, &s_log);
+
+    // Take off and bank: altitude hold changes the throttle every loop
+    SimFlight_Command_t cmd;
+    memset(&cmd, 0, sizeof(cmd));
+    cmd.setpoint.mode = FLIGHT_MODE_ANGLE;
+    cmd.setpoint.armed = true;
+    cmd.altitudeHold = true;
+    cmd.altitude_m = 2.0f;
+    for (uint32_t i = 0; i < FLIGHT_LOOPS; i++)
+    {
+        cmd.setpoint.roll = (i >= 2000u) ? 0.2f : 0.0f;
+        SimFlight_Step(&s_sim, &cmd);
+        SimLoop_Output(&s_sim.loop, (uint32_t)SilHal_GetTime_us(), &s_recorded[i]);
+    }
+    SimFlight_SetLog(&s_sim, NULL);
+    SIL_CHECK(s_log.stats.dropped == 0);
+    SIL_CHECK(s_sim.vehicle.state.position_m[2] > 0.5f);
+
+    // IMU samples carry the loop tick that read them
+    FlightLog_Reader_t reader;
+    FlightLog_Record_t rec;
+    SIL_CHECK(FlightLog_ReaderInit(&reader, s_buffer.data, s_buffer.len) == 0);
+    SIL_CHECK(FlightLog_Next(&reader, &rec) == 1);
+    SIL_CHECK(rec.type == FLIGHT_LOG_IMU && rec.time_us == 1000);
+
+    SimLoop_Config_t loopCfg;
+    SimLoop_DefaultConfig(&loopCfg);
+    SIL_CHECK(FlightLog_ReaderInit(&reader, s_buffer.data, s_buffer.len) == 0);
+    SimReplay_Configure(&loopCfg, &reader.header);
+    SIL_CHECK(SimLoop_Init(&s_loop, &loopCfg) == 0);
+
+    Compare_t compare = {0, 0};
+    SimReplay_Stats_t stats;
+    SIL_CHECK(SimReplay_Run(&s_loop, &reader, Compare_Output, &compare, &stats) == 0);
+    SIL_CHECK(stats.loops == FLIGHT_LOOPS);
+    SIL_CHECK(stats.imu == FLIGHT_LOOPS);
+    SIL_CHECK(stats.baro > 200 && stats.baro < 230); // 75 Hz for 3 s
+    SIL_CHECK(stats.dropped == 0);
+    SIL_CHECK(compare.loops == FLIGHT_LOOPS);
+    SIL_CHECK(compare.mismatches == 0);
+
+    // Timing does not change the outputs
+    SIL_CHECK(FlightLog_ReaderInit(&reader, s_buffer.data, s_buffer.len) == 0);
+    SIL_CHECK(SimLoop_Init(&s_loop, &loopCfg) == 0);
+    s_loop.timed = true;
+    compare = (Compare_t){0, 0};
+    SIL_CHECK(SimReplay_Run(&s_loop, &reader, Compare_Output, &compare, NULL) == 0);
+    SIL_CHECK(compare.mismatches == 0);
+    SIL_CHECK(s_loop.timers[SIM_LOOP_STAGE_CONTROL].calls == FLIGHT_LOOPS);
+
+    // Another tuning on the same data shows up
+    SIL_CHECK(FlightLog_ReaderInit(&reader, s_buffer.data, s_buffer.len) == 0);
+    loopCfg.attitudeGain *= 1.01f;
+    SIL_CHECK(SimLoop_Init(&s_loop, &loopCfg) == 0);
+    compare = (Compare_t){0, 0};
+    SIL_CHECK(SimReplay_Run(&s_loop, &reader, Compare_Output, &compare, NULL) == 0);
+    SIL_CHECK(compare.mismatches > FLIGHT_LOOPS / 2);
+
+    // Compact: a few tens of bytes per loop
+    SIL_CHECK(s_buffer.len < FLIGHT_LOOPS * 45u);
+}
+
+int main(void)
+{
+    Test_RoundTrip();
+    Test_Drops();
+    Test_Replay();
+    return SilTest_Result("flight_log");
+}
@@ -0,0 +1,156 @@
+#include "imu_compress.h"
+#include "sil_test.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_SAMPLES 20000
+#define TEST_MAX_BLOCK_SAMPLES 64
+
+static int16_t s_in[TEST_SAMPLES][IMU_COMPRESS_AXES];
+static int16_t s_out[TEST_SAMPLES][IMU_COMPRESS_AXES];
+
+static void MakeSamples(int kind)
+{
+    for (int i = 0; i < TEST_SAMPLES; i++)
+    {
+        for (int a = 0; a < IMU_COMPRESS_AXES; a++)
+        {
+            int32_t v;
+            if (kind == 0)
+            {
+                v = (int32_t)(2000.0 * sin(i * 0.01 + a)) + rand() % 9 - 4; // slow motion plus noise
+            }
+            else
+            {
+                v = (rand() & 0xFFFF) - 32768; // worst case: full-scale noise
+            }
+            s_in[i][a] = (int16_t)v;
+        }
+    }
+}
+
+/**
+ * @brief Encode s_in, decode every block, optionally dropping some
+ * @return Samples decoded into s_out at their indices
+ */
+static int RoundTrip(const ImuCompress_Config_t *cfg, int dropEvery, ImuCompress_Stats_t *stats)
+{
+    ImuCompress_Encoder_t enc;
+    ImuCompress_Decoder_t dec;
+    uint8_t block[IMU_COMPRESS_BLOCK_MAX];
+    int16_t samples[TEST_MAX_BLOCK_SAMPLES][IMU_COMPRESS_AXES];
+    int decoded = 0;
+    int blocks = 0;
+
+    SIL_CHECK(ImuCompress_InitEncoder(&enc, cfg) == 0);
+    ImuCompress_InitDecoder(&dec);
+    memset(s_out, 0, sizeof(s_out));
+
+    for (int i = 0; i <= TEST_SAMPLES; i++)
+    {
+        size_t len = (i < TEST_SAMPLES) ? ImuCompress_Push(&enc, s_in[i], (uint32_t)i * 150u, block)
+                                        : ImuCompress_Flush(&enc, block);
+        if (len == 0)
+        {
+            continue;
+        }
+        SIL_CHECK(len <= IMU_COMPRESS_BLOCK_MAX);
+        if (dropEvery && ++blocks % dropEvery == 0)
+        {
+            continue;
+        }
+
+        uint16_t first;
+        uint32_t time_us;
+        int n = ImuCompress_Decode(&dec, block, len, samples, TEST_MAX_BLOCK_SAMPLES, &first, &time_us);
+        if (n == -2)
+        {
+            continue; // resynchronizing after a drop
+        }
+        SIL_CHECK(n > 0);
+        for (int k = 0; k < n; k++)
+        {
+            // Indices wrap at 16 bits; TEST_SAMPLES stays below that
+            uint16_t index = (uint16_t)(first + k);
+            if (index < TEST_SAMPLES)
+            {
+                memcpy(s_out[index], samples[k], sizeof(samples[k]));
+                decoded++;
+            }
+        }
+        SIL_CHECK(time_us == (uint32_t)first * 150u);
+    }
+    *stats = enc.stats;
+    return decoded;
+}
+
+static void Test_Lossless(uint8_t predictor)
+{
+    ImuCompress_Config_t cfg = {predictor, 500};
+    ImuCompress_Stats_t stats;
+
+    MakeSamples(0);
+    SIL_CHECK(RoundTrip(&cfg, 0, &stats) == TEST_SAMPLES);
+    SIL_CHECK(memcmp(s_in, s_out, sizeof(s_in)) == 0);
+    SIL_CHECK(stats.samples == TEST_SAMPLES);
+    SIL_CHECK(stats.rawBytes > stats.encodedBytes); // smooth data compresses
+
+    MakeSamples(1);
+    SIL_CHECK(RoundTrip(&cfg, 0, &stats) == TEST_SAMPLES);
+    SIL_CHECK(memcmp(s_in, s_out, sizeof(s_in)) == 0);
+}
+
+static void Test_Resync(void)
+{
+    ImuCompress_Config_t cfg = {IMU_COMPRESS_DELTA, 100};
+    ImuCompress_Stats_t stats;
+
+    MakeSamples(0);
+    int decoded = RoundTrip(&cfg, 25, &stats);
+    SIL_CHECK(decoded > TEST_SAMPLES / 2);
+    SIL_CHECK(decoded < TEST_SAMPLES);
+
+    // Whatever was decoded after a drop is exact
+    int wrong = 0;
+    for (int i = 0; i < TEST_SAMPLES; i++)
+    {
+        bool zero = true;
+        for (int a = 0; a < IMU_COMPRESS_AXES; a++)
+        {
+            zero = zero && s_out[i][a] == 0;
+        }
+        if (!zero && memcmp(s_out[i], s_in[i], sizeof(s_in[i])) != 0)
+        {
+            wrong++;
+        }
+    }
+    SIL_CHECK(wrong == 0);
+}
+
+static void Test_Malformed(void)
+{
+    ImuCompress_Decoder_t dec;
+    int16_t samples[TEST_MAX_BLOCK_SAMPLES][IMU_COMPRESS_AXES];
+    uint8_t truncated[4] = {0x80, 3, 0, 0};
+
+    ImuCompress_InitDecoder(&dec);
+    SIL_CHECK(ImuCompress_Decode(&dec, truncated, sizeof(truncated), samples, TEST_MAX_BLOCK_SAMPLES, NULL, NULL) ==
+              -1);
+
+    // Keyframe present, residuals cut off after a continuation byte
+    uint8_t cutResidual[IMU_COMPRESS_HEADER_SIZE + 2 * IMU_COMPRESS_AXES + 1] = {0x80, 2};
+    cutResidual[sizeof(cutResidual) - 1] = 0x80;
+    SIL_CHECK(ImuCompress_Decode(&dec, cutResidual, sizeof(cutResidual), samples, TEST_MAX_BLOCK_SAMPLES, NULL,
+                                 NULL) == -1);
+    SIL_CHECK(!dec.synced);
+}
+
+int main(void)
+{
+    srand(3);
+    Test_Lossless(IMU_COMPRESS_DELTA);
+    Test_Lossless(IMU_COMPRESS_LINEAR);
+    Test_Resync();
+    Test_Malformed();
+    return SilTest_Result("imu_compress");
+}
@@ -0,0 +1,136 @@
+#include "imu_filter_bank.h"
+#include "sil_test.h"
+#include <string.h>
+
+#define TEST_RATE_HZ 1000.0f
+#define TEST_SAMPLES 2000 // the second half is measured, after the filters settle
+
+static FilterBank_t s_bank;
+static float s_data[FILTER_BANK_AXES][TEST_SAMPLES];
+
+static FilterBank_Config_t MakeConfig(uint8_t lpfStages, uint8_t notchCount)
+{
+    FilterBank_Config_t cfg = {TEST_RATE_HZ, lpfStages, 100.0f, 50.0f, notchCount, 3.0f, 80.0f, 400.0f, 20.0f, 0.05f};
+    return cfg;
+}
+
+/**
+ * @brief Filter a unit sine on every axis, one block per call
+ * @return Settled output amplitude on the given axis
+ */
+static float SineGain(float freq_Hz, int axis)
+{
+    float *axes[FILTER_BANK_AXES];
+    for (int i = 0; i < FILTER_BANK_AXES; i++)
+    {
+        for (int t = 0; t < TEST_SAMPLES; t++)
+        {
+            s_data[i][t] = sinf(2.0f * PI * freq_Hz * (float)t / TEST_RATE_HZ);
+        }
+        axes[i] = s_data[i];
+    }
+
+    FilterBank_Process(&s_bank, axes, TEST_SAMPLES);
+
+    float peak = 0.0f;
+    for (int t = TEST_SAMPLES / 2; t < TEST_SAMPLES; t++)
+    {
+        peak = fmaxf(peak, fabsf(s_data[axis][t]));
+    }
+    return peak;
+}
+
+static void Test_LowPass(void)
+{
+    FilterBank_Config_t cfg = MakeConfig(2, 0);
+    SIL_CHECK(FilterBank_Init(&s_bank, &cfg) == 0);
+
+    // Two 2nd order sections: at least 24 dB down one octave above the cutoff
+    SIL_CHECK_NEAR(SineGain(10.0f, VIBRATION_AXIS_GYRO_X), 1.0f, 0.02f);
+    SIL_CHECK(SineGain(2.0f * cfg.gyroLpfCutoff_Hz, VIBRATION_AXIS_GYRO_X) < 0.063f);
+    SIL_CHECK(SineGain(2.0f * cfg.accelLpfCutoff_Hz, VIBRATION_AXIS_ACCEL_Z) < 0.063f);
+
+    SIL_CHECK(s_bank.stats.lastSamples == TEST_SAMPLES);
+    SIL_CHECK(FilterBank_CyclesPerSampleAxis(&s_bank) >= 0.0f);
+}
+
+static void Test_NotchDepth(void)
+{
+    FilterBank_Config_t cfg = MakeConfig(0, 1);
+    SIL_CHECK(FilterBank_Init(&s_bank, &cfg) == 0);
+    FilterBank_SetNotchTarget(&s_bank, 0, 150.0f);
+    FilterBank_Retune(&s_bank);
+    SIL_CHECK(s_bank.notchFreq_Hz[0] == 150.0f); // first placement does not slew
+
+    // At least 40 dB at the centre, an octave away untouched
+    SIL_CHECK(SineGain(150.0f, VIBRATION_AXIS_GYRO_Y) < 0.01f);
+    SIL_CHECK(SineGain(150.0f, VIBRATION_AXIS_ACCEL_X) < 0.01f);
+    SIL_CHECK(SineGain(300.0f, VIBRATION_AXIS_GYRO_Y) > 0.9f);
+}
+
+static void Test_Slew(void)
+{
+    FilterBank_Config_t cfg = MakeConfig(0, 1);
+    SIL_CHECK(FilterBank_Init(&s_bank, &cfg) == 0);
+    FilterBank_SetNotchTarget(&s_bank, 0, 150.0f);
+    FilterBank_Retune(&s_bank);
+
+    // 100 Hz up takes five steps of notchMaxSlew_Hz, then holds
+    FilterBank_SetNotchTarget(&s_bank, 0, 250.0f);
+    for (int i = 1; i <= 5; i++)
+    {
+        uint8_t active = s_bank.active;
+        FilterBank_Retune(&s_bank);
+        SIL_CHECK_NEAR(s_bank.notchFreq_Hz[0], 150.0f + (float)i * cfg.notchMaxSlew_Hz, 1e-3);
+        SIL_CHECK(s_bank.active != active); // new coefficients swapped in
+    }
+    uint8_t active = s_bank.active;
+    FilterBank_Retune(&s_bank);
+    SIL_CHECK(s_bank.notchFreq_Hz[0] == 250.0f);
+    SIL_CHECK(s_bank.active == active);
+
+    // Down, with a last step shorter than the slew limit
+    FilterBank_SetNotchTarget(&s_bank, 0, 215.0f);
+    FilterBank_Retune(&s_bank);
+    SIL_CHECK_NEAR(s_bank.notchFreq_Hz[0], 230.0f, 1e-3);
+    FilterBank_Retune(&s_bank);
+    SIL_CHECK(s_bank.notchFreq_Hz[0] == 215.0f);
+}
+
+static void Test_TrackReorder(void)
+{
+    FilterBank_Config_t cfg = MakeConfig(0, 2);
+    VibrationAnalyzer_Spectrum_t spectrum;
+    SIL_CHECK(FilterBank_Init(&s_bank, &cfg) == 0);
+
+    memset(&spectrum, 0, sizeof(spectrum));
+    spectrum.resolution_Hz = TEST_RATE_HZ / VIBRATION_FFT_SIZE;
+    spectrum.peaks[VIBRATION_AXIS_GYRO_X][0] = (VibrationAnalyzer_Peak_t){120.0f, 1.0f};
+    spectrum.peaks[VIBRATION_AXIS_GYRO_X][1] = (VibrationAnalyzer_Peak_t){200.0f, 0.5f};
+    spectrum.peaks[VIBRATION_AXIS_GYRO_X][2] = (VibrationAnalyzer_Peak_t){60.0f, 2.0f}; // below notchMinFreq_Hz
+    FilterBank_TrackSpectrum(&s_bank, &spectrum);
+    SIL_CHECK(s_bank.notchTarget_Hz[0] == 120.0f);
+    SIL_CHECK(s_bank.notchTarget_Hz[1] == 200.0f);
+
+    // The 200 Hz peak grows past the other and both drift: each stays on its notch
+    spectrum.peaks[VIBRATION_AXIS_GYRO_X][0] = (VibrationAnalyzer_Peak_t){205.0f, 1.0f};
+    spectrum.peaks[VIBRATION_AXIS_GYRO_X][1] = (VibrationAnalyzer_Peak_t){118.0f, 0.5f};
+    FilterBank_TrackSpectrum(&s_bank, &spectrum);
+    SIL_CHECK(s_bank.notchTarget_Hz[0] == 118.0f);
+    SIL_CHECK(s_bank.notchTarget_Hz[1] == 205.0f);
+
+    // One peak gone: its notch holds its target
+    spectrum.peaks[VIBRATION_AXIS_GYRO_X][1] = (VibrationAnalyzer_Peak_t){0.0f, 0.0f};
+    FilterBank_TrackSpectrum(&s_bank, &spectrum);
+    SIL_CHECK(s_bank.notchTarget_Hz[0] == 118.0f);
+    SIL_CHECK(s_bank.notchTarget_Hz[1] == 205.0f);
+}
+
+int main(void)
+{
+    Test_LowPass();
+    Test_NotchDepth();
+    Test_Slew();
+    Test_TrackReorder();
+    return SilTest_Result("imu_filter_bank");
+}
@@ -0,0 +1,147 @@
+#include "imu_temp_comp.h"
+#include "sil_test.h"
+
+#define GYRO_SCALE_RADS (LSM6DSO32_GYRO_SENS_2000DPS_MDPS * 0.001f * 0.0174532925f)
+#define ACCEL_SCALE_MPS2 (LSM6DSO32_ACCEL_SENS_8G_MG * 0.001f * 9.80665f)
+#define ACCEL_1G_LSB 4098
+
+/*
+ * Synthetic sensor on a level bench: gyro z bias and accel z reading both
+ * drift by 2 LSB/degC, zero gyro bias at 25 degC. Temperatures are multiples
+ * of 0.5 degC so every sample is an exact integer.
+ */
+static void Sample(float temp_C, LSM6DSO32_GyroRaw_t *gyro, LSM6DSO32_AccelRaw_t *accel)
+{
+    int16_t drift = (int16_t)(2.0f * (temp_C - 25.0f));
+    *gyro = (LSM6DSO32_GyroRaw_t){0, 0, drift};
+    *accel = (LSM6DSO32_AccelRaw_t){0, 0, (int16_t)(ACCEL_1G_LSB + drift)};
+}
+
+static void MakeConfig(ImuTempComp_Config_t *cfg)
+{
+    cfg->gyroThreshold_rads = 0.1f;
+    cfg->accelThreshold_mps2 = 0.5f;
+    cfg->stationarySamples = 10;
+    cfg->minBinSamples = 50;
+    cfg->maxBinWeight = 1000;
+}
+
+static void Test_Init(void)
+{
+    ImuTempComp_Config_t cfg;
+    ImuTempComp_t comp;
+    MakeConfig(&cfg);
+    SIL_CHECK(ImuTempComp_Init(NULL, &cfg) == -1);
+    SIL_CHECK(ImuTempComp_Init(&comp, NULL) == -1);
+    cfg.minBinSamples = cfg.maxBinWeight + 1;
+    SIL_CHECK(ImuTempComp_Init(&comp, &cfg) == -1);
+    SIL_CHECK_NEAR(ImuTempComp_RawTempToC(0), LSM6DSO32_TEMP_OFFSET_C, 1e-6);
+    SIL_CHECK_NEAR(ImuTempComp_RawTempToC(256), LSM6DSO32_TEMP_OFFSET_C + 1.0f, 1e-6);
+}
+
+static void Test_Slope(void)
+{
+    ImuTempComp_Config_t cfg;
+    ImuTempComp_t comp;
+    LSM6DSO32_GyroRaw_t gyro;
+    LSM6DSO32_AccelRaw_t accel;
+    float g[3];
+    float a[3];
+    MakeConfig(&cfg);
+    SIL_CHECK(ImuTempComp_Init(&comp, &cfg) == 0);
+
+    // Untrained: plain unit conversion
+    Sample(30.0f, &gyro, &accel);
+    ImuTempComp_Convert(&comp, &gyro, &accel, g, a);
+    SIL_CHECK_NEAR(g[2], gyro.z * GYRO_SCALE_RADS, 1e-6);
+    SIL_CHECK_NEAR(a[2], accel.z * ACCEL_SCALE_MPS2, 1e-5);
+
+    // Warm-up from 10 to 38 degC, still on the bench: bins 5..11, centred on 12..36 degC.
+    // The detector needs stationarySamples first; those are not learned.
+    ImuTempComp_SetTemperature(&comp, 10.5f);
+    Sample(10.5f, &gyro, &accel);
+    for (int n = 1; n < cfg.stationarySamples; n++)
+    {
+        SIL_CHECK(!ImuTempComp_Update(&comp, &gyro, &accel));
+    }
+    for (float t = 10.5f; t < 38.0f; t += 1.0f)
+    {
+        ImuTempComp_SetTemperature(&comp, t);
+        Sample(t, &gyro, &accel);
+        for (int n = 0; n < 100; n++)
+        {
+            ImuTempComp_Update(&comp, &gyro, &accel);
+        }
+    }
+    SIL_CHECK(comp.stationary);
+    SIL_CHECK(comp.accelRefBin == 5);
+    for (int i = 5; i <= 11; i++)
+    {
+        SIL_CHECK(comp.bins[i].gyroCount == 400);
+        SIL_CHECK_NEAR(comp.bins[i].gyroBias[2], 2.0f * (4.0f * i - 8.0f - 25.0f) * GYRO_SCALE_RADS, 1e-6);
+    }
+
+    // Between bin centres the linear drift is removed exactly: no rate, accel as at the reference bin
+    for (float t = 12.0f; t <= 36.0f; t += 2.5f)
+    {
+        ImuTempComp_SetTemperature(&comp, t);
+        Sample(t, &gyro, &accel);
+        ImuTempComp_Convert(&comp, &gyro, &accel, g, a);
+        SIL_CHECK_NEAR(g[2], 0.0f, 1e-5);
+        SIL_CHECK_NEAR(a[2], (ACCEL_1G_LSB + 2.0f * (12.0f - 25.0f)) * ACCEL_SCALE_MPS2, 1e-4);
+        SIL_CHECK_NEAR(g[0], 0.0f, 1e-6);
+        SIL_CHECK_NEAR(a[0], 0.0f, 1e-6);
+    }
+
+    // Outside the model the edge bin is held and nothing is learned
+    ImuTempComp_SetTemperature(&comp, 60.0f);
+    SIL_CHECK(comp.tempBin == -1);
+    SIL_CHECK_NEAR(comp.gyroBias[2], 2.0f * (36.0f - 25.0f) * GYRO_SCALE_RADS, 1e-6);
+    Sample(60.0f, &gyro, &accel);
+    gyro.z = 22; // at the held bias, so the still test passes
+    SIL_CHECK(ImuTempComp_Update(&comp, &gyro, &accel));
+    for (int i = 0; i < IMU_TEMP_COMP_BIN_COUNT; i++)
+    {
+        SIL_CHECK(comp.bins[i].gyroCount == ((i >= 5 && i <= 11) ? 400 : 0));
+    }
+}
+
+static void Test_Motion(void)
+{
+    ImuTempComp_Config_t cfg;
+    ImuTempComp_t comp;
+    LSM6DSO32_GyroRaw_t gyro;
+    LSM6DSO32_AccelRaw_t accel;
+    MakeConfig(&cfg);
+    ImuTempComp_Init(&comp, &cfg);
+    ImuTempComp_SetTemperature(&comp, 25.0f);
+
+    // Rotating or accelerating samples reset the detector and are not learned
+    Sample(25.0f, &gyro, &accel);
+    gyro.x = 200;
+    for (int n = 0; n < 100; n++)
+    {
+        SIL_CHECK(!ImuTempComp_Update(&comp, &gyro, &accel));
+    }
+    Sample(25.0f, &gyro, &accel);
+    accel.z = 2 * ACCEL_1G_LSB;
+    SIL_CHECK(!ImuTempComp_Update(&comp, &gyro, &accel));
+    SIL_CHECK(comp.stillCount == 0);
+
+    // Still samples count only after stationarySamples in a row
+    Sample(25.0f, &gyro, &accel);
+    for (int n = 1; n < cfg.stationarySamples; n++)
+    {
+        SIL_CHECK(!ImuTempComp_Update(&comp, &gyro, &accel));
+    }
+    SIL_CHECK(ImuTempComp_Update(&comp, &gyro, &accel));
+    SIL_CHECK(comp.bins[8].gyroCount == 1);
+}
+
+int main(void)
+{
+    Test_Init();
+    Test_Slope();
+    Test_Motion();
+    return SilTest_Result("imu_temp_comp");
+}
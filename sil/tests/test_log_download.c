@@ -0,0 +1,427 @@
+#include "blackbox.h"
+#include "log_download.h"
+#include "sil_hal.h"
+#include "sil_test.h"
+#include <string.h>
+
+/*
+ * Log download: the blackbox reads back as one byte stream at any offset,
+ * and a host client on a simulated link gets the whole log, byte exact,
+ * over a clean link, with data frames lost or corrupted and ACKs lost,
+ * with the board short of transmit room, and resumed halfway. LOG_INFO
+ * reports a new origin once the oldest data is erased, so a host can tell
+ * that its saved offsets no longer apply.
+ */
+
+#define LOG_BYTES 20000u
+#define WINDOW 8u
+#define RETRY_MS 50u
+#define SESSION_MS 500u
+
+static Blackbox_t s_bb;
+static Blackbox_Cursor_t s_cursor;
+static uint8_t s_log[LOG_BYTES]; ///< What was written
+static uint32_t s_logLen;
+
+/*----------------------------------------------------------------------------*/
+/* Log source                                                                 */
+/*----------------------------------------------------------------------------*/
+
+static void Fill_Log(void)
+{
+    SilHal_FlashReset();
+    SIL_CHECK(Blackbox_Init(&s_bb, &(Blackbox_Config_t){16}) == 0);
+
+    // Record lengths that do not line up with blocks or chunks
+    uint32_t seed = 12345u;
+    s_logLen = 0;
+    while (s_logLen < LOG_BYTES)
+    {
+        uint8_t record[61];
+        uint16_t len = (uint16_t)(1u + s_logLen % sizeof(record));
+        if (len > LOG_BYTES - s_logLen)
+        {
+            len = (uint16_t)(LOG_BYTES - s_logLen);
+        }
+        for (uint16_t i = 0; i < len; i++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            record[i] = (uint8_t)(seed >> 16);
+        }
+        while (Blackbox_Write(&s_bb, record, len) != 0)
+        {
+            Blackbox_Service(&s_bb, true);
+        }
+        memcpy(&s_log[s_logLen], record, len);
+        s_logLen += len;
+        Blackbox_Service(&s_bb, true);
+    }
+    Blackbox_Flush(&s_bb);
+    while (!Blackbox_Idle(&s_bb))
+    {
+        Blackbox_Service(&s_bb, true);
+    }
+}
+
+static uint16_t Source_Read(void *ctx, uint32_t offset, uint8_t *out, uint16_t len)
+{
+    return Blackbox_Read(ctx, &s_cursor, offset, out, len);
+}
+
+static uint32_t Source_Size(void *ctx)
+{
+    return Blackbox_Size(ctx);
+}
+
+static uint32_t Source_Origin(void *ctx)
+{
+    Blackbox_Cursor_t oldest;
+    Blackbox_Rewind(ctx, &oldest);
+    return oldest.sequence;
+}
+
+static void Test_BlackboxRead(void)
+{
+    Fill_Log();
+    SIL_CHECK(Blackbox_Size(&s_bb) == LOG_BYTES);
+
+    static uint8_t buf[LOG_BYTES];
+    Blackbox_Cursor_t cursor;
+    Blackbox_Rewind(&s_bb, &cursor);
+
+    // Sequential, in odd pieces
+    uint32_t offset = 0;
+    uint16_t n;
+    while ((n = Blackbox_Read(&s_bb, &cursor, offset, &buf[offset], 77)) > 0)
+    {
+        offset += n;
+    }
+    SIL_CHECK(offset == LOG_BYTES);
+    SIL_CHECK(memcmp(buf, s_log, LOG_BYTES) == 0);
+
+    // Backwards and across blocks
+    const uint32_t offsets[] = {19990, 5000, 511, 0, 12345, 508};
+    for (size_t k = 0; k < sizeof(offsets) / sizeof(offsets[0]); k++)
+    {
+        uint32_t want = LOG_BYTES - offsets[k] < 1000u ? LOG_BYTES - offsets[k] : 1000u;
+        SIL_CHECK(Blackbox_Read(&s_bb, &cursor, offsets[k], buf, 1000) == want);
+        SIL_CHECK(memcmp(buf, &s_log[offsets[k]], want) == 0);
+    }
+    SIL_CHECK(Blackbox_Read(&s_bb, &cursor, LOG_BYTES, buf, 10) == 0);
+}
+
+/*----------------------------------------------------------------------------*/
+/* Simulated link and host                                                    */
+/*----------------------------------------------------------------------------*/
+
+typedef struct
+{
+    // Faults, 0 for none
+    uint32_t dropDataEvery;
+    uint32_t corruptDataEvery;
+    uint32_t dropAckEvery;
+    uint32_t busyEvery;
+
+    uint32_t dataFrames;
+    uint32_t acks;
+    uint32_t sends;
+
+    // Board to host, delivered each millisecond
+    uint8_t wire[64 * TELEMETRY_MAX_ENCODED];
+    size_t wireLen;
+    uint8_t seq;
+
+    // Host
+    bool haveInfo;
+    Telemetry_LogInfo_t info;
+    uint8_t out[LOG_BYTES];
+    uint32_t expected;
+    uint32_t end;
+    uint32_t sinceAck;
+    uint32_t lastData_ms;
+    uint32_t restarts;
+} Link_t;
+
+static Link_t s_link;
+static LogDownload_t s_dl;
+static uint32_t s_now_ms;
+
+static int Link_Send(void *ctx, uint8_t msgId, const void *payload, uint16_t len)
+{
+    (void)ctx;
+    Link_t *link = &s_link;
+    link->sends++;
+    if (link->busyEvery && link->sends % link->busyEvery == 0)
+    {
+        return -1;
+    }
+    if (link->wireLen + TELEMETRY_MAX_ENCODED > sizeof(link->wire))
+    {
+        return -1;
+    }
+
+    uint8_t *frame = &link->wire[link->wireLen];
+    size_t n = Telemetry_EncodeFrame(msgId, link->seq++, payload, len, frame);
+    if (msgId == TELEMETRY_MSG_LOG_DATA)
+    {
+        link->dataFrames++;
+        if (link->dropDataEvery && link->dataFrames % link->dropDataEvery == 0)
+        {
+            return 0; // lost on the wire
+        }
+        if (link->corruptDataEvery && link->dataFrames % link->corruptDataEvery == 0)
+        {
+            frame[n / 2] ^= 0x10;
+        }
+    }
+    link->wireLen += n;
+    return 0;
+}
+
+static void Host_Send(uint8_t msgId, const void *payload, size_t len)
+{
+    uint8_t frame[TELEMETRY_MAX_ENCODED];
+    size_t n = Telemetry_EncodeFrame(msgId, 0, payload, len, frame);
+    LogDownload_Feed(&s_dl, frame, n, s_now_ms);
+}
+
+static void Host_Request(Link_t *link)
+{
+    Telemetry_LogRead_t req = {link->expected, link->end - link->expected};
+    Host_Send(TELEMETRY_MSG_LOG_READ, &req, sizeof(req));
+    link->sinceAck = 0;
+    link->lastData_ms = s_now_ms;
+}
+
+static void Host_Ack(Link_t *link)
+{
+    link->acks++;
+    link->sinceAck = 0;
+    if (link->dropAckEvery && link->acks % link->dropAckEvery == 0)
+    {
+        return;
+    }
+    Telemetry_LogAck_t ack = {link->expected};
+    Host_Send(TELEMETRY_MSG_LOG_ACK, &ack, sizeof(ack));
+}
+
+static void Host_OnFrame(Link_t *link, const uint8_t *raw, int n)
+{
+    if (n < TELEMETRY_RAW_OVERHEAD ||
+        Telemetry_Crc16(0xFFFF, raw, (size_t)n - 2u) != (uint16_t)(raw[n - 2] | (raw[n - 1] << 8)))
+    {
+        return;
+    }
+    const uint8_t *payload = &raw[2];
+    size_t len = (size_t)n - TELEMETRY_RAW_OVERHEAD;
+    if (raw[0] == TELEMETRY_MSG_LOG_INFO && len == sizeof(link->info))
+    {
+        memcpy(&link->info, payload, len);
+        link->haveInfo = true;
+        return;
+    }
+    if (raw[0] != TELEMETRY_MSG_LOG_DATA || len <= 4)
+    {
+        return;
+    }
+
+    uint32_t offset;
+    memcpy(&offset, payload, 4);
+    if (offset != link->expected)
+    {
+        if (offset > link->expected)
+        {
+            link->restarts++;
+            Host_Request(link);
+        }
+        return;
+    }
+    SIL_CHECK(offset + len - 4 <= LOG_BYTES);
+    memcpy(&link->out[offset], &payload[4], len - 4);
+    link->expected += (uint32_t)(len - 4);
+    link->lastData_ms = s_now_ms;
+    if (++link->sinceAck >= WINDOW / 2 || link->expected >= link->end)
+    {
+        Host_Ack(link);
+    }
+}
+
+static void Host_Deliver(Link_t *link)
+{
+    size_t start = 0;
+    for (size_t i = 0; i < link->wireLen; i++)
+    {
+        if (link->wire[i] == 0x00)
+        {
+            uint8_t raw[TELEMETRY_MAX_ENCODED];
+            int n = Telemetry_CobsDecode(&link->wire[start], i - start, raw);
+            if (n > 0)
+            {
+                Host_OnFrame(link, raw, n);
+            }
+            start = i + 1;
+        }
+    }
+    link->wireLen = 0;
+}
+
+static void Server_Open(void)
+{
+    LogDownload_Config_t cfg = {
+        .read = Source_Read,
+        .size = Source_Size,
+        .origin = Source_Origin,
+        .send = Link_Send,
+        .ctx = &s_bb,
+        .window = WINDOW,
+        .chunksPerService = 4,
+        .retryTimeout_ms = RETRY_MS,
+        .sessionTimeout_ms = SESSION_MS,
+    };
+    SIL_CHECK(LogDownload_Init(&s_dl, &cfg) == 0);
+}
+
+/**
+ * @brief Ask the board for LOG_INFO into s_link.info
+ */
+static void Host_Info(void)
+{
+    s_link.haveInfo = false;
+    Host_Send(TELEMETRY_MSG_LOG_INFO, NULL, 0);
+    LogDownload_Service(&s_dl, s_now_ms);
+    Host_Deliver(&s_link);
+    SIL_CHECK(s_link.haveInfo);
+}
+
+/**
+ * @brief Run the host from offset until it has stopAt bytes or gives up
+ * @return Milliseconds taken
+ */
+static uint32_t Download(uint32_t from, uint32_t stopAt)
+{
+    Link_t *link = &s_link;
+    Host_Info();
+    SIL_CHECK(link->info.size == LOG_BYTES);
+    SIL_CHECK(link->info.chunkSize == TELEMETRY_LOG_CHUNK);
+    SIL_CHECK(link->info.window == WINDOW);
+
+    link->expected = from;
+    link->end = link->info.size;
+    Host_Request(link);
+    uint32_t t0 = s_now_ms;
+    while (link->expected < stopAt && s_now_ms - t0 < 20000u)
+    {
+        LogDownload_Service(&s_dl, s_now_ms);
+        Host_Deliver(link);
+        if (s_now_ms - link->lastData_ms >= 4u * RETRY_MS)
+        {
+            link->restarts++;
+            Host_Request(link);
+        }
+        s_now_ms++;
+    }
+    return s_now_ms - t0;
+}
+
+static void Test_Clean(void)
+{
+    memset(&s_link, 0, sizeof(s_link));
+    Server_Open();
+    SIL_CHECK(!LogDownload_Active(&s_dl));
+    Download(0, LOG_BYTES);
+
+    SIL_CHECK(s_link.expected == LOG_BYTES);
+    SIL_CHECK(memcmp(s_link.out, s_log, LOG_BYTES) == 0);
+    SIL_CHECK(!LogDownload_Active(&s_dl)); // the last ACK closed it
+    SIL_CHECK(s_dl.stats.chunks == (LOG_BYTES + TELEMETRY_LOG_CHUNK - 1u) / TELEMETRY_LOG_CHUNK);
+    SIL_CHECK(s_dl.stats.bytes == LOG_BYTES);
+    SIL_CHECK(s_dl.stats.resends == 0);
+    SIL_CHECK(s_dl.stats.badFrames == 0);
+    SIL_CHECK(s_link.restarts == 0);
+}
+
+static void Test_Lossy(void)
+{
+    memset(&s_link, 0, sizeof(s_link));
+    s_link.dropDataEvery = 7;
+    s_link.corruptDataEvery = 11;
+    s_link.dropAckEvery = 5;
+    s_link.busyEvery = 13;
+    Server_Open();
+    Download(0, LOG_BYTES);
+
+    SIL_CHECK(s_link.expected == LOG_BYTES);
+    SIL_CHECK(memcmp(s_link.out, s_log, LOG_BYTES) == 0);
+    SIL_CHECK(s_link.restarts > 0);
+    SIL_CHECK(s_dl.stats.chunks > (LOG_BYTES + TELEMETRY_LOG_CHUNK - 1u) / TELEMETRY_LOG_CHUNK);
+}
+
+static void Test_ResumeAndTimeout(void)
+{
+    memset(&s_link, 0, sizeof(s_link));
+    Server_Open();
+
+    // The host goes away halfway: the board gives up on its own
+    Download(0, LOG_BYTES / 2);
+    uint32_t have = s_link.expected;
+    uint32_t origin = s_link.info.origin;
+    SIL_CHECK(origin == s_bb.sectorSequence[0]);
+    SIL_CHECK(have >= LOG_BYTES / 2 && have < LOG_BYTES);
+    SIL_CHECK(LogDownload_Active(&s_dl));
+    uint32_t chunks = s_dl.stats.chunks;
+    for (uint32_t i = 0; i <= SESSION_MS; i++)
+    {
+        LogDownload_Service(&s_dl, s_now_ms++);
+    }
+    SIL_CHECK(!LogDownload_Active(&s_dl));
+    s_link.wireLen = 0;
+    SIL_CHECK(s_dl.stats.resends > 0); // window resent while nobody listened
+    SIL_CHECK(s_dl.stats.chunks > chunks);
+
+    // Later: the rest, from what was saved, the log still starting where it did
+    Download(have, LOG_BYTES);
+    SIL_CHECK(s_link.info.origin == origin);
+    SIL_CHECK(s_link.expected == LOG_BYTES);
+    SIL_CHECK(memcmp(s_link.out, s_log, LOG_BYTES) == 0);
+    SIL_CHECK(s_dl.stats.requests == 2);
+    SIL_CHECK(!LogDownload_Active(&s_dl));
+
+    // Garbage and frames for someone else on the line
+    uint8_t junk[] = {'p', ':', ' ', '1', '\r', '\n', 0x00};
+    LogDownload_Feed(&s_dl, junk, sizeof(junk), s_now_ms);
+    SIL_CHECK(s_dl.stats.badFrames == 1);
+    Host_Send(TELEMETRY_MSG_BARO, junk, 4);
+    SIL_CHECK(s_dl.stats.badFrames == 1);
+    SIL_CHECK(!LogDownload_Active(&s_dl));
+}
+
+static void Test_OriginMoves(void)
+{
+    memset(&s_link, 0, sizeof(s_link));
+    Server_Open();
+    Host_Info();
+    uint32_t origin = s_link.info.origin;
+
+    // The data the offsets counted from is erased: a resume has to be refused
+    SIL_CHECK(Blackbox_Erase(&s_bb) == 0);
+    uint8_t record[32] = {0};
+    SIL_CHECK(Blackbox_Write(&s_bb, record, sizeof(record)) == 0);
+    Blackbox_Flush(&s_bb);
+    while (!Blackbox_Idle(&s_bb))
+    {
+        Blackbox_Service(&s_bb, false);
+    }
+    Host_Info();
+    SIL_CHECK(s_link.info.size == sizeof(record));
+    SIL_CHECK(s_link.info.origin != origin);
+}
+
+int main(void)
+{
+    Test_BlackboxRead();
+    Test_Clean();
+    Test_Lossy();
+    Test_ResumeAndTimeout();
+    Test_OriginMoves();
+    return SilTest_Result("test_log_download");
+}
@@ -0,0 +1,150 @@
+#include "mag_calibration.h"
+#include "sil_test.h"
+
+#define FIELD_LSB 333.0 // 0.5 gauss earth field at 1.5 mgauss/LSB
+
+// Hard iron in LSB and a symmetric soft-iron distortion
+static const double s_offset[3] = {40.0, -25.0, 60.0};
+static const double s_distortion[3][3] = {
+    {1.10, 0.05, -0.03},
+    {0.05, 0.90, 0.04},
+    {-0.03, 0.04, 1.00},
+};
+
+/*
+ * Point i of n spread evenly over the unit sphere (Fibonacci lattice), through
+ * the distortion and offset, rounded like the sensor output.
+ */
+static void Sample(int i, int n, double u[3], LIS2MDL_Mag_Raw *mag)
+{
+    double z = 1.0 - (2.0 * i + 1.0) / n;
+    double r = sqrt(1.0 - z * z);
+    double phi = 2.39996322972865332 * i; // golden angle
+    u[0] = r * cos(phi);
+    u[1] = r * sin(phi);
+    u[2] = z;
+
+    double raw[3];
+    for (int k = 0; k < 3; k++)
+    {
+        raw[k] = s_offset[k];
+        for (int j = 0; j < 3; j++)
+        {
+            raw[k] += s_distortion[k][j] * u[j] * FIELD_LSB;
+        }
+    }
+    mag->x = (int16_t)lround(raw[0]);
+    mag->y = (int16_t)lround(raw[1]);
+    mag->z = (int16_t)lround(raw[2]);
+}
+
+static void Test_Ellipsoid(void)
+{
+    MagCal_Accumulator_t acc;
+    MagCal_Result_t result;
+    LIS2MDL_Mag_Raw mag;
+    double u[3];
+    const int n = 2000;
+
+    MagCal_Reset(&acc);
+    for (int i = 0; i < n; i++)
+    {
+        Sample(i, n, u, &mag);
+        MagCal_AddSample(&acc, &mag);
+    }
+    SIL_CHECK(MagCal_Fit(&acc, &result) == 0);
+    SIL_CHECK(result.valid);
+    SIL_CHECK(result.samples == (uint32_t)n);
+
+    // Hard iron to well under one LSB despite the rounding
+    for (int k = 0; k < 3; k++)
+    {
+        SIL_CHECK_NEAR(result.offset[k], s_offset[k], 0.2);
+    }
+
+    // Soft iron: the correction undoes the distortion up to the radius scale
+    double scale = result.radius_gauss / FIELD_LSB;
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            double md = 0.0;
+            for (int k = 0; k < 3; k++)
+            {
+                md += result.matrix[i][k] * s_distortion[k][j];
+            }
+            SIL_CHECK_NEAR(md / scale, (i == j) ? 1.0 : 0.0, 2e-3);
+        }
+    }
+    SIL_CHECK_NEAR(result.anisotropy, 1.24, 0.05);
+    SIL_CHECK(result.residualRms < 0.01f);
+
+    // Calibrated samples lie on a sphere, pointing the true way
+    double worstRadius = 0.0;
+    double worstAngle = 0.0;
+    for (int i = 0; i < n; i += 7)
+    {
+        float out[3];
+        Sample(i, n, u, &mag);
+        MagCal_Apply(&result, &mag, out);
+        double norm = sqrt((double)out[0] * out[0] + (double)out[1] * out[1] + (double)out[2] * out[2]);
+        double dot = (out[0] * u[0] + out[1] * u[1] + out[2] * u[2]) / norm;
+        worstRadius = fmax(worstRadius, fabs(norm / result.radius_gauss - 1.0));
+        worstAngle = fmax(worstAngle, acos(fmin(dot, 1.0)));
+    }
+    SIL_CHECK(worstRadius < 3e-3);
+    SIL_CHECK(worstAngle < 3e-3); // rad
+}
+
+static void Test_Degenerate(void)
+{
+    MagCal_Accumulator_t acc;
+    MagCal_Result_t result;
+    LIS2MDL_Mag_Raw mag;
+    double u[3];
+
+    SIL_CHECK(MagCal_Fit(NULL, &result) == -1);
+
+    // Too few samples
+    MagCal_Reset(&acc);
+    for (int i = 0; i < MAG_CAL_MIN_SAMPLES - 1; i++)
+    {
+        Sample(i, MAG_CAL_MIN_SAMPLES, u, &mag);
+        MagCal_AddSample(&acc, &mag);
+    }
+    SIL_CHECK(MagCal_Fit(&acc, &result) == -2);
+    SIL_CHECK(!result.valid);
+
+    // Turned about one axis only: the ellipsoid is not observable
+    MagCal_Reset(&acc);
+    for (int i = 0; i < 500; i++)
+    {
+        double a = 0.0125 * i;
+        mag.x = (int16_t)lround(FIELD_LSB * cos(a));
+        mag.y = (int16_t)lround(FIELD_LSB * sin(a));
+        mag.z = 100;
+        MagCal_AddSample(&acc, &mag);
+    }
+    SIL_CHECK(MagCal_Fit(&acc, &result) < 0);
+    SIL_CHECK(!result.valid);
+}
+
+static void Test_Identity(void)
+{
+    MagCal_Result_t result;
+    LIS2MDL_Mag_Raw mag = {100, -200, 300};
+    float out[3];
+    MagCal_SetIdentity(&result);
+    MagCal_Apply(&result, &mag, out);
+    SIL_CHECK_NEAR(out[0], 0.15f, 1e-6);
+    SIL_CHECK_NEAR(out[1], -0.30f, 1e-6);
+    SIL_CHECK_NEAR(out[2], 0.45f, 1e-6);
+}
+
+int main(void)
+{
+    Test_Ellipsoid();
+    Test_Degenerate();
+    Test_Identity();
+    return SilTest_Result("mag_calibration");
+}
@@ -0,0 +1,120 @@
+#include "mixer.h"
+#include "sil_test.h"
+
+static const float s_rollCoef[MIXER_OUTPUTS] = {
+#define MIXER_ROLL(r, p, y) (r),
+    MIXER_TABLE(MIXER_ROLL)
+#undef MIXER_ROLL
+};
+
+static void Test_Init(void)
+{
+    Mixer_Config_t bad = {false, 1.5f};
+    SIL_CHECK(Mixer_Init(NULL) == -1);
+    SIL_CHECK(Mixer_Init(&bad) == -1);
+}
+
+static void Test_Neutral(void)
+{
+    Mixer_Config_t cfg = {true, 1.0f};
+    const float torque[3] = {0.0f, 0.0f, 0.0f};
+    Mixer_Output_t out;
+
+    SIL_CHECK(Mixer_Init(&cfg) == 0);
+    Mixer_Mix(torque, 0.5f, &out);
+    for (int i = 0; i < MIXER_OUTPUTS; i++)
+    {
+        SIL_CHECK_NEAR(out.output[i], MIXER_IS_MOTOR_FRAME ? 0.5f : 0.0f, 1e-6);
+    }
+    SIL_CHECK(!out.saturated);
+}
+
+#if MIXER_IS_MOTOR_FRAME
+static void Test_Desaturation(void)
+{
+    Mixer_Config_t cfg = {true, 1.0f};
+    const float torque[3] = {2.0f, 0.0f, 0.0f};
+    Mixer_Output_t out;
+
+    SIL_CHECK(Mixer_Init(&cfg) == 0);
+    Mixer_Mix(torque, 0.5f, &out);
+    SIL_CHECK(out.saturated);
+
+    // Full-range spread, roll direction kept
+    float lo = 1.0f;
+    float hi = 0.0f;
+    for (int i = 0; i < MIXER_OUTPUTS; i++)
+    {
+        SIL_CHECK(out.output[i] >= 0.0f && out.output[i] <= 1.0f);
+        lo = (out.output[i] < lo) ? out.output[i] : lo;
+        hi = (out.output[i] > hi) ? out.output[i] : hi;
+        if (s_rollCoef[i] > 0.0f)
+        {
+            SIL_CHECK(out.output[i] > 0.5f);
+        }
+    }
+    SIL_CHECK_NEAR(hi - lo, 1.0f, 1e-5);
+}
+
+static void Test_Airmode(void)
+{
+    Mixer_Config_t cfg = {true, 1.0f};
+    const float torque[3] = {0.2f, 0.0f, 0.0f};
+    Mixer_Output_t air;
+    Mixer_Output_t plain;
+
+    // At zero throttle airmode raises collective to keep the torque
+    SIL_CHECK(Mixer_Init(&cfg) == 0);
+    Mixer_Mix(torque, 0.0f, &air);
+    cfg.airmode = false;
+    SIL_CHECK(Mixer_Init(&cfg) == 0);
+    Mixer_Mix(torque, 0.0f, &plain);
+
+    SIL_CHECK(air.throttle > 0.0f);
+    SIL_CHECK_NEAR(plain.throttle, 0.0f, 1e-6);
+    float airRoll = 0.0f;
+    float plainRoll = 0.0f;
+    for (int i = 0; i < MIXER_OUTPUTS; i++)
+    {
+        airRoll += s_rollCoef[i] * air.output[i];
+        plainRoll += s_rollCoef[i] * plain.output[i];
+    }
+    SIL_CHECK(airRoll > plainRoll);
+
+    // Full throttle is capped in both modes so the top motor keeps headroom
+    Mixer_Mix(torque, 1.0f, &plain);
+    for (int i = 0; i < MIXER_OUTPUTS; i++)
+    {
+        SIL_CHECK(plain.output[i] <= 1.0f);
+    }
+    SIL_CHECK(plain.throttle < 1.0f);
+}
+#else
+static void Test_ServoLimit(void)
+{
+    Mixer_Config_t cfg = {false, 0.3f};
+    const float torque[3] = {1.0f, 0.0f, 0.0f};
+    Mixer_Output_t out;
+
+    SIL_CHECK(Mixer_Init(&cfg) == 0);
+    Mixer_Mix(torque, 0.0f, &out);
+    SIL_CHECK(out.saturated);
+    for (int i = 0; i < MIXER_OUTPUTS; i++)
+    {
+        SIL_CHECK(out.output[i] >= -0.3f && out.output[i] <= 0.3f);
+    }
+}
+#endif
+
+int main(void)
+{
+    Test_Init();
+    Test_Neutral();
+#if MIXER_IS_MOTOR_FRAME
+    Test_Desaturation();
+    Test_Airmode();
+#else
+    Test_ServoLimit();
+#endif
+    return SilTest_Result("mixer");
+}
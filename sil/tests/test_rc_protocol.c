@@ -0,0 +1,156 @@
+#include "rc_protocol.h"
+#include "sil_test.h"
+#include <string.h>
+
+#define RING_SIZE 256
+
+static uint8_t s_ring[RING_SIZE];
+static uint16_t s_write;
+
+static void Ring_Put(const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        s_ring[s_write++ & (RING_SIZE - 1)] = data[i];
+    }
+}
+
+/**
+ * @brief Pack 16 x 11-bit channels LSB first, as SBUS and CRSF carry them
+ */
+static void PackChannels(const uint16_t channel[RC_CHANNELS], uint8_t out[RC_CRSF_RC_PAYLOAD_LEN])
+{
+    memset(out, 0, RC_CRSF_RC_PAYLOAD_LEN);
+    for (int ch = 0; ch < RC_CHANNELS; ch++)
+    {
+        for (int bit = 0; bit < 11; bit++)
+        {
+            if (channel[ch] & (1u << bit))
+            {
+                int pos = ch * 11 + bit;
+                out[pos / 8] |= (uint8_t)(1u << (pos % 8));
+            }
+        }
+    }
+}
+
+static size_t BuildCrsfChannels(const uint16_t channel[RC_CHANNELS], uint8_t *out)
+{
+    out[0] = RC_CRSF_ADDR_FC;
+    out[1] = RC_CRSF_RC_PAYLOAD_LEN + 2;
+    out[2] = RC_CRSF_TYPE_RC_CHANNELS;
+    PackChannels(channel, &out[3]);
+    uint8_t crc = 0;
+    for (int i = 2; i < 3 + RC_CRSF_RC_PAYLOAD_LEN; i++)
+    {
+        crc = RcProtocol_Crc8(crc, out[i]);
+    }
+    out[3 + RC_CRSF_RC_PAYLOAD_LEN] = crc;
+    return 4 + RC_CRSF_RC_PAYLOAD_LEN;
+}
+
+static void Test_Crc8(void)
+{
+    // CRC-8/DVB-S2 check value
+    uint8_t crc = 0;
+    for (const char *p = "123456789"; *p; p++)
+    {
+        crc = RcProtocol_Crc8(crc, (uint8_t)*p);
+    }
+    SIL_CHECK(crc == 0xBC);
+}
+
+static void Test_Sbus(void)
+{
+    RcProtocol_Ring_t ring = {s_ring, RING_SIZE - 1};
+    RcProtocol_Frame_t frame;
+    uint16_t channel[RC_CHANNELS];
+    uint8_t sbus[RC_SBUS_FRAME_LEN];
+    uint16_t read = 0;
+
+    memset(&frame, 0, sizeof(frame));
+    s_write = 0;
+    for (int ch = 0; ch < RC_CHANNELS; ch++)
+    {
+        channel[ch] = (uint16_t)(RC_CHANNEL_MIN + ch * 100);
+    }
+    sbus[0] = RC_SBUS_HEADER;
+    PackChannels(channel, &sbus[1]);
+    sbus[23] = RC_SBUS_FLAG_FAILSAFE;
+    sbus[24] = 0x00;
+
+    // Garbage, then the frame split in two
+    uint8_t junk[3] = {0x55, 0xAA, 0x01};
+    Ring_Put(junk, sizeof(junk));
+    Ring_Put(sbus, 10);
+    SIL_CHECK(RcProtocol_Parse(RC_PROTOCOL_SBUS, &ring, &read, s_write, &frame) == RC_PARSE_NEED_MORE);
+    SIL_CHECK(read == 3);
+    Ring_Put(&sbus[10], RC_SBUS_FRAME_LEN - 10);
+    SIL_CHECK(RcProtocol_Parse(RC_PROTOCOL_SBUS, &ring, &read, s_write, &frame) == RC_PARSE_CHANNELS);
+    SIL_CHECK(read == s_write);
+    SIL_CHECK(memcmp(frame.channel, channel, sizeof(channel)) == 0);
+    SIL_CHECK(frame.failsafe);
+    SIL_CHECK(!frame.frameLost);
+
+    // Bad footer is rejected and skipped
+    sbus[24] = 0x33;
+    Ring_Put(sbus, sizeof(sbus));
+    SIL_CHECK(RcProtocol_Parse(RC_PROTOCOL_SBUS, &ring, &read, s_write, &frame) == RC_PARSE_BAD_FRAME);
+}
+
+static void Test_Crsf(void)
+{
+    RcProtocol_Ring_t ring = {s_ring, RING_SIZE - 1};
+    RcProtocol_Frame_t frame;
+    uint16_t channel[RC_CHANNELS];
+    uint8_t crsf[RC_CRSF_MAX_FRAME_LEN];
+    uint16_t read = 200; // exercise the ring wrap
+    s_write = 200;
+
+    memset(&frame, 0, sizeof(frame));
+    for (int ch = 0; ch < RC_CHANNELS; ch++)
+    {
+        channel[ch] = (uint16_t)(RC_CHANNEL_MAX - ch * 37);
+    }
+    size_t len = BuildCrsfChannels(channel, crsf);
+    Ring_Put(crsf, len);
+    SIL_CHECK(RcProtocol_Parse(RC_PROTOCOL_CRSF, &ring, &read, s_write, &frame) == RC_PARSE_CHANNELS);
+    SIL_CHECK(memcmp(frame.channel, channel, sizeof(channel)) == 0);
+
+    // Corrupted payload fails the CRC
+    crsf[5] ^= 0x01;
+    Ring_Put(crsf, len);
+    SIL_CHECK(RcProtocol_Parse(RC_PROTOCOL_CRSF, &ring, &read, s_write, &frame) == RC_PARSE_BAD_FRAME);
+
+    // Link statistics: LQ 0 is failsafe
+    read = s_write;
+    uint8_t stats[] = {RC_CRSF_ADDR_FC, 12, RC_CRSF_TYPE_LINK_STATS, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    uint8_t crc = 0;
+    for (int i = 2; i < 13; i++)
+    {
+        crc = RcProtocol_Crc8(crc, stats[i]);
+    }
+    stats[13] = crc;
+    Ring_Put(stats, sizeof(stats));
+    SIL_CHECK(RcProtocol_Parse(RC_PROTOCOL_CRSF, &ring, &read, s_write, &frame) == RC_PARSE_OTHER);
+    SIL_CHECK(frame.linkQuality == 0);
+    SIL_CHECK(frame.failsafe);
+}
+
+static void Test_ChannelToUnit(void)
+{
+    SIL_CHECK_NEAR(RcProtocol_ChannelToUnit(RC_CHANNEL_MID), 0.0f, 1e-6);
+    SIL_CHECK_NEAR(RcProtocol_ChannelToUnit(RC_CHANNEL_MAX), 1.0f, 2e-3);
+    SIL_CHECK_NEAR(RcProtocol_ChannelToUnit(RC_CHANNEL_MIN), -1.0f, 2e-3);
+    SIL_CHECK(RcProtocol_ChannelToUnit(2047) == 1.0f);
+    SIL_CHECK(RcProtocol_ChannelToUnit(0) == -1.0f);
+}
+
+int main(void)
+{
+    Test_Crc8();
+    Test_Sbus();
+    Test_Crsf();
+    Test_ChannelToUnit();
+    return SilTest_Result("rc_protocol");
+}
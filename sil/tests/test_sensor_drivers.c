@@ -0,0 +1,132 @@
+#include "lsm6dso32.h"
+#include "lps22hb.h"
+#include "sil_hal.h"
+#include "sil_test.h"
+#include <string.h>
+
+/*
+ * Drivers against a plain register file: bit 7 of the first byte selects a
+ * read, the address auto-increments. Enough to run the drivers' SPI paths
+ * natively; the sensor behaviour itself is not modelled here.
+ */
+
+typedef struct
+{
+    uint8_t reg[128];
+    uint8_t addr;
+    bool read;
+    bool first;
+    uint32_t transactions;
+} RegFile_t;
+
+static void RegFile_Select(void *ctx)
+{
+    RegFile_t *rf = ctx;
+    rf->first = true;
+    rf->transactions++;
+}
+
+static uint8_t RegFile_Transfer(void *ctx, uint8_t tx)
+{
+    RegFile_t *rf = ctx;
+    if (rf->first)
+    {
+        rf->first = false;
+        rf->read = (tx & 0x80) != 0;
+        rf->addr = tx & 0x7F;
+        return 0xFF;
+    }
+    uint8_t rx = rf->reg[rf->addr];
+    if (!rf->read)
+    {
+        rf->reg[rf->addr] = tx;
+    }
+    rf->addr = (rf->addr + 1) & 0x7F;
+    return rx;
+}
+
+static const SilHal_SpiDevice_t s_regFileDevice = {RegFile_Select, RegFile_Transfer, NULL};
+
+static SPI_HandleTypeDef s_spi1 = {1, 0};
+static RegFile_t s_imu;
+static RegFile_t s_baro;
+
+static void Test_Lsm6dso32(void)
+{
+    LSM6DSO32_Handle_t dev;
+    LSM6DSO32_AccelRaw_t accel;
+    LSM6DSO32_GyroRaw_t gyro;
+
+    memset(&dev, 0, sizeof(dev));
+    dev.hspi = &s_spi1;
+    dev.csPort = GPIOA;
+    dev.csPin = GPIO_PIN_4;
+
+    // Wrong part answers
+    SIL_CHECK(LSM6DSO32_Init(&dev) == -3);
+
+    s_imu.reg[LSM6DSO32_REG_WHO_AM_I] = LSM6DSO32_WHO_AM_I_VAL;
+    SIL_CHECK(LSM6DS032_WhoIAm(&dev) == 0);
+    SIL_CHECK(LSM6DSO32_Init(&dev) == 0);
+    SIL_CHECK(s_imu.reg[LSM6DSO32_REG_CTRL1_XL] != 0);
+    SIL_CHECK(s_imu.reg[LSM6DSO32_REG_CTRL2_G] != 0);
+
+    const uint8_t gyroOut[6] = {0x34, 0x12, 0xFF, 0xFF, 0x00, 0x80};
+    const uint8_t accelOut[6] = {0x01, 0x00, 0x00, 0x10, 0xCC, 0xF0};
+    memcpy(&s_imu.reg[LSM6DSO32_REG_OUTX_L_G], gyroOut, sizeof(gyroOut));
+    memcpy(&s_imu.reg[LSM6DSO32_REG_OUTX_L_A], accelOut, sizeof(accelOut));
+
+    SIL_CHECK(LSM6DSO32_ReadGyroRaw(&dev, &gyro) == 0);
+    SIL_CHECK(gyro.x == 0x1234 && gyro.y == -1 && gyro.z == INT16_MIN);
+    SIL_CHECK(LSM6DSO32_ReadAccelRaw(&dev, &accel) == 0);
+    SIL_CHECK(accel.x == 1 && accel.y == 0x1000 && accel.z == (int16_t)0xF0CC);
+}
+
+static void Test_Lps22hb(void)
+{
+    LPS22HB_Handle_t dev;
+    float pressure;
+
+    memset(&dev, 0, sizeof(dev));
+    dev.hspi = &s_spi1;
+    dev.csPort = GPIOB;
+    dev.csPin = GPIO_PIN_0;
+
+    s_baro.reg[LPS22HB_REG_WHO_AM_I] = LPS22HB_WHO_AM_I_VAL;
+    SIL_CHECK(LPS22HB_Init(&dev) == 0);
+    SIL_CHECK(s_baro.reg[LPS22HB_REG_CTRL_1] & 0x02); // BDU
+
+    // 1013.25 hPa * 4096 LSB/hPa
+    uint32_t raw = 4150272u;
+    s_baro.reg[LPS22HB_REG_PRESS_OUT_XL] = (uint8_t)raw;
+    s_baro.reg[LPS22HB_REG_PRESS_OUT_L] = (uint8_t)(raw >> 8);
+    s_baro.reg[LPS22HB_REG_PRESS_OUT_H] = (uint8_t)(raw >> 16);
+    SIL_CHECK(LPS22HB_ReadPressure_hPa(&dev, &pressure) == 0);
+    SIL_CHECK_NEAR(pressure, 1013.25f, 1e-3);
+}
+
+static void Test_ChipSelect(void)
+{
+    // Only the selected device sees the transaction
+    uint32_t imuBefore = s_imu.transactions;
+    uint32_t baroBefore = s_baro.transactions;
+    LSM6DSO32_Handle_t dev = {.hspi = &s_spi1, .csPort = GPIOA, .csPin = GPIO_PIN_4};
+    uint8_t who;
+
+    SIL_CHECK(LSM6DSO32_ReadReg(&dev, LSM6DSO32_REG_WHO_AM_I, &who, 1) == 0);
+    SIL_CHECK(who == LSM6DSO32_WHO_AM_I_VAL);
+    SIL_CHECK(s_imu.transactions == imuBefore + 1);
+    SIL_CHECK(s_baro.transactions == baroBefore);
+}
+
+int main(void)
+{
+    SilHal_Reset();
+    SIL_CHECK(SilHal_SpiAttach(&s_spi1, GPIOA, GPIO_PIN_4, &s_regFileDevice, &s_imu) == 0);
+    SIL_CHECK(SilHal_SpiAttach(&s_spi1, GPIOB, GPIO_PIN_0, &s_regFileDevice, &s_baro) == 0);
+
+    Test_Lsm6dso32();
+    Test_Lps22hb();
+    Test_ChipSelect();
+    return SilTest_Result("sensor_drivers");
+}
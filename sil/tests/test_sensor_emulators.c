@@ -0,0 +1,398 @@
+#include "lis2mdl.h"
+#include "lps22hb.h"
+#include "lsm6dso32.h"
+#include "sil_hal.h"
+#include "sil_sensors.h"
+#include "sil_test.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/*
+ * The unmodified drivers against the register-level emulators on the
+ * board's bus: values, STATUS/BDU/IF_INC behaviour, FIFO watermark and
+ * overrun, and how many SPI transactions each access pattern costs.
+ */
+
+#define GRAVITY 9.80665f
+#define RAD_TO_MDPS (180000.0f / 3.14159265f)
+
+static SPI_HandleTypeDef s_spi2 = {2, 0};
+static SilSensors_t s_rig;
+static uint32_t s_extiCount[16];
+
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+    for (int i = 0; i < 16; i++)
+    {
+        if (GPIO_Pin & (1u << i))
+        {
+            s_extiCount[i]++;
+        }
+    }
+}
+
+// Accel x ramps at 100 m/s^2 per second so consecutive samples differ in the high byte
+static void RampProfile_Sample(void *ctx, uint64_t time_us, SilProfile_Truth_t *truth)
+{
+    (void)ctx;
+    memset(truth, 0, sizeof(*truth));
+    truth->accel_mps2[0] = (float)time_us * 1e-4f;
+    truth->accel_mps2[2] = GRAVITY;
+    truth->pressure_hPa = 1013.25f;
+    truth->temperature_C = 25.0f;
+}
+
+static void Rig_Setup(const SilProfile_t *profile)
+{
+    SilHal_Reset();
+    memset(s_extiCount, 0, sizeof(s_extiCount));
+    SIL_CHECK(SilSensors_Init(&s_rig, profile, &s_spi2) == 0);
+}
+
+static LSM6DSO32_Handle_t Imu_Handle(void)
+{
+    LSM6DSO32_Handle_t dev = {.hspi = &s_spi2, .csPort = SIL_SENSORS_CS_PORT, .csPin = SIL_SENSORS_CS_LSM6DSO32};
+    return dev;
+}
+
+static void Test_Lsm6dso32Outputs(void)
+{
+    SilProfile_Synthetic_t cfg;
+    SilProfile_t profile;
+    SilProfile_SyntheticDefaults(&cfg);
+    cfg.gyro_rads[0] = 0.5f;
+    cfg.gyro_rads[1] = -0.25f;
+    cfg.gyro_rads[2] = 1.0f;
+    SilProfile_InitSynthetic(&profile, &cfg);
+    Rig_Setup(&profile);
+
+    LSM6DSO32_Handle_t dev = Imu_Handle();
+    SIL_CHECK(LSM6DSO32_Init(&dev) == 0);
+    SIL_CHECK(s_rig.imu.reg[LSM6DSO32_REG_CTRL1_XL] == 0x48);
+
+    uint8_t status = 0xFF;
+    SIL_CHECK(LSM6DSO32_ReadReg(&dev, LSM6DSO32_REG_STATUS, &status, 1) == 0);
+    SIL_CHECK(status == 0); // nothing sampled yet
+
+    SilHal_Advance_us(20000);
+    SIL_CHECK(s_rig.imu.accelSamples == 2 && s_rig.imu.gyroSamples == 2); // 104 Hz
+    SIL_CHECK(LSM6DSO32_ReadReg(&dev, LSM6DSO32_REG_STATUS, &status, 1) == 0);
+    SIL_CHECK((status & (LSM6DSO32_STATUS_XLDA | LSM6DSO32_STATUS_GDA)) ==
+              (LSM6DSO32_STATUS_XLDA | LSM6DSO32_STATUS_GDA));
+
+    // Six single-byte transactions per vector against one burst for everything
+    LSM6DSO32_AccelRaw_t accel;
+    LSM6DSO32_GyroRaw_t gyro;
+    int16_t temp;
+    uint32_t before = s_rig.imu.spi.stats.readTransactions;
+    SIL_CHECK(LSM6DSO32_ReadAccelRaw(&dev, &accel) == 0);
+    SIL_CHECK(s_rig.imu.spi.stats.readTransactions - before == 6);
+
+    before = s_rig.imu.spi.stats.readTransactions;
+    SIL_CHECK(LSM6DSO32_ReadAllRaw(&dev, &temp, &gyro, &accel) == 0);
+    SIL_CHECK(s_rig.imu.spi.stats.readTransactions - before == 1);
+
+    SIL_CHECK(accel.x == 0 && accel.y == 0);
+    SIL_CHECK(accel.z == (int16_t)lroundf(1000.0f / LSM6DSO32_ACCEL_SENS_8G_MG));
+    SIL_CHECK(gyro.x == (int16_t)lroundf(0.5f * RAD_TO_MDPS / LSM6DSO32_GYRO_SENS_2000DPS_MDPS));
+    SIL_CHECK(gyro.y == (int16_t)lroundf(-0.25f * RAD_TO_MDPS / LSM6DSO32_GYRO_SENS_2000DPS_MDPS));
+    SIL_CHECK(gyro.z == (int16_t)lroundf(1.0f * RAD_TO_MDPS / LSM6DSO32_GYRO_SENS_2000DPS_MDPS));
+    SIL_CHECK(temp == 0); // 25 degC
+
+    // Reading the high bytes cleared the data-ready flags
+    SIL_CHECK(LSM6DSO32_ReadReg(&dev, LSM6DSO32_REG_STATUS, &status, 1) == 0);
+    SIL_CHECK((status & 0x07) == 0);
+
+    // IF_INC off: a burst keeps reading the same register
+    uint8_t ctrl3 = 0x00;
+    uint8_t who[3] = {0};
+    SIL_CHECK(LSM6DSO32_WriteReg(&dev, LSM6DSO32_REG_CTRL3_C, &ctrl3, 1) == 0);
+    SIL_CHECK(LSM6DSO32_ReadReg(&dev, LSM6DSO32_REG_WHO_AM_I, who, 3) == 0);
+    SIL_CHECK(who[0] == LSM6DSO32_WHO_AM_I_VAL && who[1] == who[0] && who[2] == who[0]);
+}
+
+static void Test_Lsm6dso32Bdu(void)
+{
+    SilProfile_t profile = {RampProfile_Sample, NULL};
+    Rig_Setup(&profile);
+
+    LSM6DSO32_Handle_t dev = Imu_Handle();
+    SIL_CHECK(LSM6DSO32_Init(&dev) == 0);
+
+    // Without BDU a split read mixes two samples
+    uint8_t lo, hi;
+    SilHal_Advance_us(20000);
+    SIL_CHECK(LSM6DSO32_ReadReg(&dev, LSM6DSO32_REG_OUTX_L_A, &lo, 1) == 0);
+    int16_t first = (int16_t)(s_rig.imu.accel.value[1] << 8 | lo);
+    SilHal_Advance_us(30000);
+    SIL_CHECK(LSM6DSO32_ReadReg(&dev, LSM6DSO32_REG_OUTX_H_A, &hi, 1) == 0);
+    SIL_CHECK((int16_t)(hi << 8 | lo) != first);
+
+    // With BDU the high byte still belongs to the sample the low byte came from
+    uint8_t ctrl3 = 0x44; // BDU | IF_INC
+    SIL_CHECK(LSM6DSO32_WriteReg(&dev, LSM6DSO32_REG_CTRL3_C, &ctrl3, 1) == 0);
+    SilHal_Advance_us(10000);
+    SIL_CHECK(LSM6DSO32_ReadReg(&dev, LSM6DSO32_REG_OUTX_L_A, &lo, 1) == 0);
+    first = (int16_t)(s_rig.imu.accel.value[1] << 8 | lo);
+    uint32_t samples = s_rig.imu.accelSamples;
+    SilHal_Advance_us(30000);
+    SIL_CHECK(s_rig.imu.accelSamples > samples);
+    SIL_CHECK(LSM6DSO32_ReadReg(&dev, LSM6DSO32_REG_OUTX_H_A, &hi, 1) == 0);
+    SIL_CHECK((int16_t)(hi << 8 | lo) == first);
+
+    // Once the word is complete the held sample is released
+    LSM6DSO32_AccelRaw_t accel;
+    SIL_CHECK(LSM6DSO32_ReadAccelRaw(&dev, &accel) == 0);
+    SIL_CHECK(accel.x > first);
+}
+
+static void Test_Lsm6dso32Fifo(void)
+{
+    SilProfile_Synthetic_t cfg;
+    SilProfile_t profile;
+    SilProfile_SyntheticDefaults(&cfg);
+    cfg.gyro_rads[2] = 1.0f;
+    SilProfile_InitSynthetic(&profile, &cfg);
+    Rig_Setup(&profile);
+    s_rig.imu.int1Pin = GPIO_PIN_1;
+
+    LSM6DSO32_Handle_t dev = Imu_Handle();
+    SIL_CHECK(LSM6DSO32_Init(&dev) == 0);
+    uint8_t int1 = 0x08; // FIFO_TH
+    SIL_CHECK(LSM6DSO32_WriteReg(&dev, 0x0D, &int1, 1) == 0);
+    SIL_CHECK(LSM6DSO32_FifoConfig(&dev, 0x4, 0x4, 20) == 0); // both batched at 104 Hz
+
+    uint16_t level;
+    uint8_t flags;
+    SilHal_Advance_us(50000);
+    SIL_CHECK(LSM6DSO32_FifoLevel(&dev, &level, &flags) == 0);
+    SIL_CHECK(level == 10 && !(flags & LSM6DSO32_FIFO_STATUS_WTM));
+    SIL_CHECK(s_extiCount[1] == 0);
+
+    SilHal_Advance_us(50000);
+    SIL_CHECK(LSM6DSO32_FifoLevel(&dev, &level, &flags) == 0);
+    SIL_CHECK(level == 20 && (flags & LSM6DSO32_FIFO_STATUS_WTM));
+    SIL_CHECK(s_extiCount[1] == 1);
+
+    // FifoRead costs one transaction per word
+    LSM6DSO32_FifoWord_t words[40];
+    uint32_t before = s_rig.imu.spi.stats.readTransactions;
+    SIL_CHECK(LSM6DSO32_FifoRead(&dev, words, level) == 0);
+    SIL_CHECK(s_rig.imu.spi.stats.readTransactions - before == level);
+
+    int gyroWords = 0, accelWords = 0;
+    for (uint16_t i = 0; i < level; i++)
+    {
+        if (words[i].tag == LSM6DSO32_FIFO_TAG_GYRO)
+        {
+            gyroWords++;
+            SIL_CHECK(words[i].z == (int16_t)lroundf(RAD_TO_MDPS / LSM6DSO32_GYRO_SENS_2000DPS_MDPS));
+        }
+        else if (words[i].tag == LSM6DSO32_FIFO_TAG_ACCEL)
+        {
+            accelWords++;
+            SIL_CHECK(words[i].z == (int16_t)lroundf(1000.0f / LSM6DSO32_ACCEL_SENS_8G_MG));
+        }
+    }
+    SIL_CHECK(gyroWords == 10 && accelWords == 10);
+    SIL_CHECK(LSM6DSO32_FifoLevel(&dev, &level, &flags) == 0);
+    SIL_CHECK(level == 0);
+
+    // The data address wraps from Z_H back to the tag: a single burst drains it
+    SilHal_Advance_us(100000);
+    SIL_CHECK(LSM6DSO32_FifoLevel(&dev, &level, &flags) == 0);
+    SIL_CHECK(level == 20);
+    uint8_t raw[20 * LSM6DSO32_FIFO_WORD_SIZE];
+    before = s_rig.imu.spi.stats.readTransactions;
+    SIL_CHECK(LSM6DSO32_ReadReg(&dev, LSM6DSO32_REG_FIFO_DATA_OUT_TAG, raw, sizeof(raw)) == 0);
+    SIL_CHECK(s_rig.imu.spi.stats.readTransactions - before == 1);
+    for (int i = 0; i < 20; i++)
+    {
+        const uint8_t *w = &raw[i * LSM6DSO32_FIFO_WORD_SIZE];
+        SIL_CHECK((w[0] >> 3) == LSM6DSO32_FIFO_TAG_GYRO || (w[0] >> 3) == LSM6DSO32_FIFO_TAG_ACCEL);
+    }
+    SIL_CHECK(LSM6DSO32_FifoLevel(&dev, &level, &flags) == 0);
+    SIL_CHECK(level == 0);
+
+    // Left alone the FIFO fills, then continuous mode overwrites the oldest words
+    SilHal_Advance_us(5000000);
+    SIL_CHECK(LSM6DSO32_FifoLevel(&dev, &level, &flags) == 0);
+    SIL_CHECK(level == LSM6DSO32_EMU_FIFO_WORDS);
+    SIL_CHECK(flags & LSM6DSO32_FIFO_STATUS_OVR);
+    SIL_CHECK(s_rig.imu.fifoLost > 0);
+}
+
+static void Test_Lis2mdl(void)
+{
+    SilProfile_Synthetic_t cfg;
+    SilProfile_t profile;
+    SilProfile_SyntheticDefaults(&cfg);
+    SilProfile_InitSynthetic(&profile, &cfg);
+    Rig_Setup(&profile);
+
+    LIS2MDL_Handle_t dev = {.hspi = &s_spi2, .csPort = SIL_SENSORS_CS_PORT, .csPin = SIL_SENSORS_CS_LIS2MDL};
+
+    // Out of reset the part answers on SDI only; MISO idles high
+    uint8_t who = 0;
+    SIL_CHECK(LIS2MDL_ReadReg(&dev, LIS2MDL_REG_WHO_AM_I, &who, 1) == 0);
+    SIL_CHECK(who == 0xFF);
+
+    SIL_CHECK(LIS2MDL_Init(&dev) == 0);
+    SIL_CHECK(LIS2MDL_ReadReg(&dev, LIS2MDL_REG_WHO_AM_I, &who, 1) == 0);
+    SIL_CHECK(who == LIS2MDL_WHO_AM_I_VAL);
+
+    LIS2MDL_Mag_Raw mag;
+    SilHal_Advance_us(30000);
+    SIL_CHECK(s_rig.mag.samples == 3); // 100 Hz
+    uint32_t before = s_rig.mag.spi.stats.readTransactions;
+    SIL_CHECK(LIS2MDL_ReadMagneticRaw(&dev, &mag) == 0);
+    SIL_CHECK(s_rig.mag.spi.stats.readTransactions - before == 6);
+    SIL_CHECK(mag.x == (int16_t)lroundf(0.2f * 1000.0f / LIS2MDL_SENS_MGAUSS));
+    SIL_CHECK(mag.y == 0);
+    SIL_CHECK(mag.z == (int16_t)lroundf(0.4f * 1000.0f / LIS2MDL_SENS_MGAUSS));
+
+    // Hard-iron offsets are subtracted from the next samples
+    const LIS2MDL_Mag_Raw offset = {100, -20, 7};
+    LIS2MDL_Mag_Raw corrected;
+    SIL_CHECK(LIS2MDL_SetHardIronOffset(&dev, &offset) == 0);
+    SilHal_Advance_us(10000);
+    SIL_CHECK(LIS2MDL_ReadMagneticRaw(&dev, &corrected) == 0);
+    SIL_CHECK(corrected.x == mag.x - 100 && corrected.y == 20 && corrected.z == mag.z - 7);
+}
+
+static void Test_Lps22hb(void)
+{
+    SilProfile_Synthetic_t cfg;
+    SilProfile_t profile;
+    SilProfile_SyntheticDefaults(&cfg);
+    cfg.climbRate_mps = 10.0f;
+    SilProfile_InitSynthetic(&profile, &cfg);
+    Rig_Setup(&profile);
+
+    LPS22HB_Handle_t dev = {.hspi = &s_spi2, .csPort = SIL_SENSORS_CS_PORT, .csPin = SIL_SENSORS_CS_LPS22HB};
+    dev.config.odr = LPS22HB_CONFIG_ODR_25HZ;
+    dev.config.interupt_mode = LPS22HB_CONFIG_INTERRUPT_MODE_DATA_READY;
+    SIL_CHECK(LPS22HB_Init(&dev) == 0);
+
+    // DRDY on INT_DRDY (PC4) once per sample
+    SilHal_Advance_us(100000);
+    SIL_CHECK(s_rig.baro.samples == 2);
+    SIL_CHECK(s_extiCount[4] == 2);
+
+    uint8_t status;
+    SIL_CHECK(LPS22HB_Status(&dev, &status) == 0);
+    SIL_CHECK((status & 0x03) == 0x03);
+
+    int32_t pressure;
+    int16_t temp;
+    uint32_t before = s_rig.baro.spi.stats.readTransactions;
+    SIL_CHECK(LPS22HB_ReadPT_Burst(&dev, &pressure, &temp) == 0);
+    SIL_CHECK(s_rig.baro.spi.stats.readTransactions - before == 1);
+    SIL_CHECK_NEAR(pressure / 4096.0, SilProfile_IsaPressure(0.8f), 1.0 / 4096.0);
+    SIL_CHECK(temp == 2500);
+    SIL_CHECK(LPS22HB_Status(&dev, &status) == 0);
+    SIL_CHECK((status & 0x03) == 0);
+
+    before = s_rig.baro.spi.stats.readTransactions;
+    SIL_CHECK(LPS22HB_ReadPressure(&dev, &pressure) == 0);
+    SIL_CHECK(s_rig.baro.spi.stats.readTransactions - before == 3);
+
+    // One-shot: a single sample, then powered down again
+    uint8_t ctrl1 = 0x02; // ODR off, BDU
+    uint8_t ctrl2 = 0x19; // IF_ADD_INC | I2C_DIS | ONE_SHOT
+    SIL_CHECK(LPS22HB_WriteReg(&dev, LPS22HB_REG_CTRL_1, &ctrl1, 1) == 0);
+    uint32_t samples = s_rig.baro.samples;
+    SIL_CHECK(LPS22HB_WriteReg(&dev, LPS22HB_REG_CTRL_2, &ctrl2, 1) == 0);
+    SIL_CHECK(LPS22HB_ReadReg(&dev, LPS22HB_REG_CTRL_2, &ctrl2, 1) == 0);
+    SIL_CHECK(ctrl2 == 0x18);
+    SilHal_Advance_us(1000000);
+    SIL_CHECK(s_rig.baro.samples == samples + 1);
+
+    // FIFO mode at 50 Hz with a watermark of 8: fills to 32 and stops
+    uint8_t fifoCtrl = 0x20 | 8;
+    ctrl1 = 0x42;
+    ctrl2 = 0x58; // FIFO_EN | IF_ADD_INC | I2C_DIS
+    SIL_CHECK(LPS22HB_WriteReg(&dev, 0x14, &fifoCtrl, 1) == 0);
+    SIL_CHECK(LPS22HB_WriteReg(&dev, LPS22HB_REG_CTRL_2, &ctrl2, 1) == 0);
+    SIL_CHECK(LPS22HB_WriteReg(&dev, LPS22HB_REG_CTRL_1, &ctrl1, 1) == 0);
+
+    uint8_t fifoStatus;
+    SilHal_Advance_us(200000);
+    SIL_CHECK(LPS22HB_ReadReg(&dev, 0x26, &fifoStatus, 1) == 0);
+    SIL_CHECK(fifoStatus == (0x80 | 10)); // FTH, 10 slots
+
+    SilHal_Advance_us(1000000);
+    SIL_CHECK(LPS22HB_ReadReg(&dev, 0x26, &fifoStatus, 1) == 0);
+    SIL_CHECK((fifoStatus & 0x3F) == LPS22HB_EMU_FIFO_SLOTS);
+    SIL_CHECK(fifoStatus & 0x40);
+
+    // Each burst from PRESS_OUT_XL pops one slot, oldest first: climbing, so falling
+    int32_t previous = INT32_MAX;
+    for (int i = 0; i < LPS22HB_EMU_FIFO_SLOTS; i++)
+    {
+        SIL_CHECK(LPS22HB_ReadPT_Burst(&dev, &pressure, &temp) == 0);
+        SIL_CHECK(pressure < previous);
+        previous = pressure;
+    }
+    SIL_CHECK(LPS22HB_ReadReg(&dev, 0x26, &fifoStatus, 1) == 0);
+    SIL_CHECK(fifoStatus == 0);
+}
+
+static void Test_RecordedProfile(void)
+{
+    const char *path = "test_sensor_emulators.csv";
+    FILE *f = fopen(path, "w");
+    SIL_CHECK(f != NULL);
+    if (!f)
+    {
+        return;
+    }
+    fputs("time_s,ax,ay,az,gx,gy,gz,mx,my,mz,pressure_hPa,temperature_C\n", f);
+    fputs("0.0,0,0,9.80665,0,0,0,0.2,0,0.4,1000.0,20.0\n", f);
+    fputs("1.0,0,0,9.80665,0,0,0.5,0.2,0,0.4,990.0,30.0\n", f);
+    fclose(f);
+
+    SilProfile_Recording_t rec;
+    SilProfile_t profile;
+    SIL_CHECK(SilProfile_LoadCsv(path, &rec) == 0);
+    SIL_CHECK(rec.count == 2);
+    SilProfile_InitRecording(&profile, &rec);
+    Rig_Setup(&profile);
+
+    LPS22HB_Handle_t baro = {.hspi = &s_spi2, .csPort = SIL_SENSORS_CS_PORT, .csPin = SIL_SENSORS_CS_LPS22HB};
+    baro.config.odr = LPS22HB_CONFIG_ODR_25HZ;
+    LSM6DSO32_Handle_t imu = Imu_Handle();
+    SIL_CHECK(LPS22HB_Init(&baro) == 0);
+    SIL_CHECK(LSM6DSO32_Init(&imu) == 0);
+
+    // Last samples before t = 0.5 s: baro at 0.48 s, gyro at 10 ms steps
+    SilHal_Advance_us(500000);
+    float pressure, temp;
+    SIL_CHECK(LPS22HB_ReadPT_Burst_hPa_C(&baro, &pressure, &temp) == 0);
+    SIL_CHECK_NEAR(pressure, 995.2f, 0.01f);
+    SIL_CHECK_NEAR(temp, 24.8f, 0.01f);
+
+    LSM6DSO32_GyroRaw_t gyro;
+    SIL_CHECK(LSM6DSO32_ReadGyroRaw(&imu, &gyro) == 0);
+    SIL_CHECK_NEAR(gyro.z * LSM6DSO32_GYRO_SENS_2000DPS_MDPS / RAD_TO_MDPS, 0.25f, 0.01f);
+
+    // Held after the last record
+    SilHal_Advance_us(2000000);
+    SIL_CHECK(LPS22HB_ReadPT_Burst_hPa_C(&baro, &pressure, &temp) == 0);
+    SIL_CHECK_NEAR(pressure, 990.0f, 0.01f);
+
+    SilProfile_FreeRecording(&rec);
+    remove(path);
+}
+
+int main(void)
+{
+    Test_Lsm6dso32Outputs();
+    Test_Lsm6dso32Bdu();
+    Test_Lsm6dso32Fifo();
+    Test_Lis2mdl();
+    Test_Lps22hb();
+    Test_RecordedProfile();
+    return SilTest_Result("sensor_emulators");
+}
@@ -0,0 +1,103 @@
+#include "telemetry_messages.h"
+#include "sil_test.h"
+#include <stdlib.h>
+#include <string.h>
+
+static void Test_Crc16(void)
+{
+    // CRC-16/CCITT-FALSE check value
+    SIL_CHECK(Telemetry_Crc16(0xFFFF, (const uint8_t *)"123456789", 9) == 0x29B1);
+    SIL_CHECK(Telemetry_Crc16(0xFFFF, NULL, 0) == 0xFFFF);
+}
+
+static void Test_Cobs(void)
+{
+    uint8_t in[300];
+    uint8_t enc[320];
+    uint8_t dec[300];
+
+    // Zero runs, a 254-byte non-zero run and random data
+    for (size_t len = 0; len <= sizeof(in); len += (len < 20) ? 1 : 37)
+    {
+        for (int pattern = 0; pattern < 3; pattern++)
+        {
+            for (size_t i = 0; i < len; i++)
+            {
+                in[i] = (pattern == 0) ? 0x00 : (pattern == 1) ? (uint8_t)(1 + i % 255) : (uint8_t)rand();
+            }
+            size_t n = Telemetry_CobsEncode(in, len, enc);
+            SIL_CHECK(n >= len + 2 && n <= len + len / 254 + 2);
+            SIL_CHECK(enc[n - 1] == 0x00);
+            SIL_CHECK(memchr(enc, 0x00, n - 1) == NULL);
+            SIL_CHECK(Telemetry_CobsDecode(enc, n - 1, dec) == (int)len);
+            SIL_CHECK(memcmp(in, dec, len) == 0);
+        }
+    }
+
+    // A code byte pointing past the end is malformed
+    uint8_t bad[] = {0x05, 0x11, 0x22};
+    SIL_CHECK(Telemetry_CobsDecode(bad, sizeof(bad), dec) == -1);
+}
+
+static void Test_Frame(void)
+{
+    Telemetry_Baro_t baro = {1234, 1013.25f, 21.5f, 12.0f, -0.5f};
+    uint8_t out[TELEMETRY_MAX_ENCODED];
+    uint8_t raw[TELEMETRY_MAX_RAW];
+
+    size_t n = Telemetry_EncodeFrame(TELEMETRY_MSG_BARO, 7, &baro, sizeof(baro), out);
+    SIL_CHECK(n > 0 && n <= TELEMETRY_MAX_ENCODED);
+
+    int len = Telemetry_CobsDecode(out, n - 1, raw);
+    SIL_CHECK(len == (int)(sizeof(baro) + TELEMETRY_RAW_OVERHEAD));
+    SIL_CHECK(raw[0] == TELEMETRY_MSG_BARO);
+    SIL_CHECK(raw[1] == 7);
+    SIL_CHECK(memcmp(&raw[2], &baro, sizeof(baro)) == 0);
+    uint16_t crc = Telemetry_Crc16(0xFFFF, raw, (size_t)len - 2);
+    SIL_CHECK(raw[len - 2] == (crc & 0xFF) && raw[len - 1] == (crc >> 8));
+
+    // Oversize payloads are refused
+    static uint8_t big[TELEMETRY_MAX_PAYLOAD + 1];
+    SIL_CHECK(Telemetry_EncodeFrame(TELEMETRY_MSG_IMU, 0, big, sizeof(big), out) == 0);
+}
+
+static void Test_GeneratedEncoders(void)
+{
+    uint8_t out[TELEMETRY_MAX_ENCODED];
+    uint8_t raw[TELEMETRY_MAX_RAW];
+
+    // Same bytes as the generic encoder
+    Telemetry_Baro_t baro = {1234, 1013.25f, 21.5f, 12.0f, -0.5f};
+    uint8_t ref[TELEMETRY_MAX_ENCODED];
+    size_t n = Telemetry_EncodeBaro(3, &baro, out);
+    SIL_CHECK(n > 0 && n == Telemetry_EncodeFrame(TELEMETRY_MSG_BARO, 3, &baro, sizeof(baro), ref));
+    SIL_CHECK(memcmp(out, ref, n) == 0);
+
+    Telemetry_Schema_t schema = {TELEMETRY_SCHEMA_HASH, TELEMETRY_SCHEMA_MESSAGES, 0};
+    n = Telemetry_EncodeSchema(0, &schema, out);
+    SIL_CHECK(Telemetry_CobsDecode(out, n - 1, raw) == (int)(sizeof(schema) + TELEMETRY_RAW_OVERHEAD));
+    SIL_CHECK(raw[0] == TELEMETRY_MSG_SCHEMA && memcmp(&raw[2], &schema, sizeof(schema)) == 0);
+
+    // Variable message: only the valid part of the last field goes out, and never more than it holds
+    Telemetry_LogData_t data = {.offset = 4096};
+    for (size_t i = 0; i < TELEMETRY_LOG_CHUNK; i++)
+    {
+        data.data[i] = (uint8_t)i;
+    }
+    n = Telemetry_EncodeLogData(1, &data, 10, out);
+    SIL_CHECK(Telemetry_CobsDecode(out, n - 1, raw) == (int)(4 + 10 + TELEMETRY_RAW_OVERHEAD));
+    SIL_CHECK(memcmp(&raw[2], &data, 14) == 0);
+    n = Telemetry_EncodeLogData(1, &data, TELEMETRY_LOG_CHUNK, out);
+    SIL_CHECK(Telemetry_CobsDecode(out, n - 1, raw) == (int)(sizeof(data) + TELEMETRY_RAW_OVERHEAD));
+    SIL_CHECK(Telemetry_EncodeLogData(1, &data, TELEMETRY_LOG_CHUNK + 1, out) == 0);
+}
+
+int main(void)
+{
+    srand(1);
+    Test_Crc16();
+    Test_Cobs();
+    Test_Frame();
+    Test_GeneratedEncoders();
+    return SilTest_Result("telemetry_frame");
+}
@@ -0,0 +1,61 @@
+#include "text_format.h"
+#include "sil_test.h"
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+static void Test_Vector3(void)
+{
+    static const int16_t s_values[] = {0, 1, -1, 9, -10, 4200, -4200, INT16_MAX, INT16_MIN};
+    const int count = sizeof(s_values) / sizeof(s_values[0]);
+    char line[TEXT_FORMAT_LINE_MAX];
+    char reference[TEXT_FORMAT_LINE_MAX];
+
+    for (int i = 0; i < count; i++)
+    {
+        int16_t x = s_values[i];
+        int16_t y = s_values[(i + 3) % count];
+        int16_t z = s_values[(i + 5) % count];
+        size_t len = TextFormat_Vector3(line, sizeof(line), x, y, z);
+        int refLen = snprintf(reference, sizeof(reference), "x: %d, y: %d, z: %d\r\n", x, y, z);
+        SIL_CHECK(len == (size_t)refLen);
+        SIL_CHECK(memcmp(line, reference, len) == 0);
+    }
+}
+
+static void Test_PressureTemp(void)
+{
+    char line[TEXT_FORMAT_LINE_MAX];
+
+    size_t len = TextFormat_PressureTemp(line, sizeof(line), 1013.25f, 21.5f);
+    SIL_CHECK(len == strlen("p: 1013.2500, t: 21.50\r\n"));
+    SIL_CHECK(memcmp(line, "p: 1013.2500, t: 21.50\r\n", len) == 0);
+
+    len = TextFormat_PressureTemp(line, sizeof(line), 987.5f, -0.25f);
+    SIL_CHECK(memcmp(line, "p: 987.5000, t: -0.25\r\n", len) == 0);
+
+    // Same output as the snprintf line it replaced
+    TextFormat_Benchmark_t bench;
+    SIL_CHECK(TextFormat_RunBenchmark(&bench) == 0);
+    SIL_CHECK(bench.identical);
+}
+
+static void Test_Overflow(void)
+{
+    char small[8];
+    TextFormat_t tf;
+
+    TextFormat_Init(&tf, small, sizeof(small));
+    TextFormat_Str(&tf, "p: ");
+    TextFormat_Int(&tf, INT32_MIN);
+    SIL_CHECK(TextFormat_End(&tf) == 0);
+    SIL_CHECK(TextFormat_Vector3(small, sizeof(small), 1, 2, 3) == 0);
+}
+
+int main(void)
+{
+    Test_Vector3();
+    Test_PressureTemp();
+    Test_Overflow();
+    return SilTest_Result("text_format");
+}
@@ -0,0 +1,146 @@
+#include "time_alignment.h"
+#include "sil_test.h"
+
+static void MakeConfig(TimeAlign_Config_t *cfg)
+{
+    cfg->latency_us = 5000;
+    cfg->maxHold_us[TIME_ALIGN_IMU] = 2000;
+    cfg->maxHold_us[TIME_ALIGN_MAG] = 20000;
+    cfg->maxHold_us[TIME_ALIGN_BARO] = 40000;
+}
+
+static void Test_Init(void)
+{
+    TimeAlign_Config_t cfg;
+    TimeAlign_t ta;
+    float out[6];
+    MakeConfig(&cfg);
+    SIL_CHECK(TimeAlign_Init(NULL, &cfg) == -1);
+    SIL_CHECK(TimeAlign_Init(&ta, NULL) == -1);
+    SIL_CHECK(TimeAlign_Init(&ta, &cfg) == 0);
+
+    SIL_CHECK(TimeAlign_SampleSensor(&ta, TIME_ALIGN_IMU, 0, out) == -2);
+    SIL_CHECK(TimeAlign_SampleSensor(&ta, TIME_ALIGN_SENSOR_COUNT, 0, out) == -1);
+    SIL_CHECK(TimeAlign_AlignedTime(&ta, 12000) == 7000);
+    SIL_CHECK(TimeAlign_AlignedTime(&ta, 1000) == UINT32_MAX - 3999); // wraps with the counter
+}
+
+static void Test_Interpolation(void)
+{
+    TimeAlign_Config_t cfg;
+    TimeAlign_t ta;
+    float out[6];
+    MakeConfig(&cfg);
+    TimeAlign_Init(&ta, &cfg);
+
+    // Ramps at 1 kHz, straddling the counter wrap: value = time since t0 in ms
+    const uint32_t t0 = UINT32_MAX - 20000;
+    for (uint32_t n = 0; n < 40; n++)
+    {
+        float gyro[3] = {(float)n, -(float)n, 1.0f};
+        float accel[3] = {0.0f, 0.0f, 2.0f * n};
+        SIL_CHECK(TimeAlign_PushImu(&ta, t0 + 1000 * n, gyro, accel) == 0);
+    }
+
+    // Between samples, on either side of the wrap
+    const uint32_t queries[] = {t0 + 10250, t0 + 20000, t0 + 20700, t0 + 38999};
+    for (size_t q = 0; q < sizeof(queries) / sizeof(queries[0]); q++)
+    {
+        float ms = (uint32_t)(queries[q] - t0) / 1000.0f;
+        SIL_CHECK(TimeAlign_SampleSensor(&ta, TIME_ALIGN_IMU, queries[q], out) == 0);
+        SIL_CHECK_NEAR(out[0], ms, 1e-4);
+        SIL_CHECK_NEAR(out[1], -ms, 1e-4);
+        SIL_CHECK_NEAR(out[2], 1.0f, 1e-6);
+        SIL_CHECK_NEAR(out[5], 2.0f * ms, 2e-4);
+    }
+
+    // Exactly on a sample
+    SIL_CHECK(TimeAlign_SampleSensor(&ta, TIME_ALIGN_IMU, t0 + 15000, out) == 0);
+    SIL_CHECK(out[0] == 15.0f);
+
+    // Out-of-order and duplicate timestamps are refused and change nothing
+    float zero[3] = {0};
+    SIL_CHECK(TimeAlign_PushImu(&ta, t0 + 39000, zero, zero) == -1);
+    SIL_CHECK(TimeAlign_PushImu(&ta, t0 + 30500, zero, zero) == -1);
+    SIL_CHECK(TimeAlign_SampleSensor(&ta, TIME_ALIGN_IMU, t0 + 38999, out) == 0);
+    SIL_CHECK_NEAR(out[0], 38.999f, 1e-4);
+}
+
+static void Test_OutOfWindow(void)
+{
+    TimeAlign_Config_t cfg;
+    TimeAlign_t ta;
+    float out[3];
+    MakeConfig(&cfg);
+    TimeAlign_Init(&ta, &cfg);
+
+    // 100 Hz mag, more samples than the ring keeps
+    for (uint32_t n = 0; n < 2 * TIME_ALIGN_MAG_DEPTH; n++)
+    {
+        float mag[3] = {(float)n, 0.0f, 0.0f};
+        TimeAlign_PushMag(&ta, 10000 * n, mag);
+    }
+    const uint32_t newest = 10000 * (2 * TIME_ALIGN_MAG_DEPTH - 1);
+    const uint32_t oldest = newest - 10000 * (TIME_ALIGN_MAG_DEPTH - 1);
+
+    // Past the newest sample: held up to maxHold_us, then no data
+    SIL_CHECK(TimeAlign_SampleSensor(&ta, TIME_ALIGN_MAG, newest + 5000, out) == 1);
+    SIL_CHECK(out[0] == (float)(2 * TIME_ALIGN_MAG_DEPTH - 1));
+    SIL_CHECK(TimeAlign_SampleSensor(&ta, TIME_ALIGN_MAG, newest + 20000, out) == 1);
+    SIL_CHECK(TimeAlign_SampleSensor(&ta, TIME_ALIGN_MAG, newest + 20001, out) == -3);
+
+    // The oldest kept sample still brackets; anything before it is gone
+    SIL_CHECK(TimeAlign_SampleSensor(&ta, TIME_ALIGN_MAG, oldest, out) == 0);
+    SIL_CHECK(out[0] == (float)TIME_ALIGN_MAG_DEPTH);
+    SIL_CHECK(TimeAlign_SampleSensor(&ta, TIME_ALIGN_MAG, oldest - 1, out) == -4);
+    SIL_CHECK(TimeAlign_SampleSensor(&ta, TIME_ALIGN_MAG, 0, out) == -4);
+}
+
+static void Test_Frame(void)
+{
+    TimeAlign_Config_t cfg;
+    TimeAlign_t ta;
+    TimeAlign_Frame_t frame;
+    MakeConfig(&cfg);
+    TimeAlign_Init(&ta, &cfg);
+
+    // IMU at 1 kHz, mag at 100 Hz, baro at 50 Hz, 100 ms of each
+    for (uint32_t t = 1000; t <= 100000; t += 1000)
+    {
+        float gyro[3] = {t * 1e-3f, 0.0f, 0.0f};
+        float accel[3] = {0.0f, 0.0f, 9.81f};
+        TimeAlign_PushImu(&ta, t, gyro, accel);
+        if (t % 10000 == 0)
+        {
+            float mag[3] = {0.2f, 0.0f, t * 1e-5f};
+            TimeAlign_PushMag(&ta, t, mag);
+        }
+        if (t % 20000 == 0)
+        {
+            TimeAlign_PushBaro(&ta, t, 1000.0f + t * 1e-4f, 20.0f);
+        }
+    }
+
+    uint32_t t = TimeAlign_AlignedTime(&ta, 100000);
+    SIL_CHECK(TimeAlign_Sample(&ta, t, &frame) ==
+              (TIME_ALIGN_VALID_IMU | TIME_ALIGN_VALID_MAG | TIME_ALIGN_VALID_BARO));
+    SIL_CHECK(frame.t_us == 95000);
+    SIL_CHECK_NEAR(frame.gyro[0], 95.0f, 1e-4);
+    SIL_CHECK_NEAR(frame.accel[2], 9.81f, 1e-5);
+    SIL_CHECK_NEAR(frame.mag[2], 0.95f, 1e-5);
+    SIL_CHECK_NEAR(frame.pressure_hPa, 1009.5f, 1e-3);
+    SIL_CHECK_NEAR(frame.baroTemp_C, 20.0f, 1e-5);
+
+    // 3 ms later than the newest IMU sample: IMU drops out, the slower sensors are still held
+    SIL_CHECK(TimeAlign_Sample(&ta, 103000, &frame) == (TIME_ALIGN_VALID_MAG | TIME_ALIGN_VALID_BARO));
+    SIL_CHECK(frame.gyro[0] == 0.0f);
+}
+
+int main(void)
+{
+    Test_Init();
+    Test_Interpolation();
+    Test_OutOfWindow();
+    Test_Frame();
+    return SilTest_Result("time_alignment");
+}
@@ -0,0 +1,137 @@
+"""
+Generate firmware/dsp/fft_tables.c: the CMSIS-DSP FFT tables for the sizes
+enabled in CMakeLists.txt (ARM_TABLE_* definitions).
+
+The vendored CMSIS-DSP tree does not ship arm_common_tables.c, so the few
+tables the firmware needs are generated here with the same definitions:
+
+    twiddleCoef_N[2i], [2i+1]       = cos, sin(2 pi i / N),   i < N
+    twiddleCoef_rfft_N[2i], [2i+1]  = sin, cos(2 pi i / N),   i < N / 2
+    armBitRevIndexTableN            = pairs of elements to swap, in order,
+                                      to undo the output order of the
+                                      complex FFT (element index * 8)
+
+    python3 tools/gen_fft_tables.py > firmware/dsp/fft_tables.c
+"""
+
+import math
+import sys
+
+# Complex FFT length used by arm_rfft_fast_f32 for VIBRATION_FFT_SIZE 256
+CFFT_LEN = 128
+RFFT_LEN = 2 * CFFT_LEN
+
+# ARMBITREVINDEXTABLE_128_TABLE_LENGTH in arm_common_tables.h
+BITREV_TABLE_LENGTH = 208
+
+
+def twiddles(n, count):
+    out = []
+    for i in range(count):
+        out.append(math.cos(i * 2 * math.pi / n))
+        out.append(math.sin(i * 2 * math.pi / n))
+    return out
+
+
+def rfft_twiddles(n):
+    # i * exp(-2 pi i k / n), as in the split step of arm_rfft_fast_f32
+    out = []
+    for i in range(n // 2):
+        out.append(math.sin(i * 2 * math.pi / n))
+        out.append(math.cos(i * 2 * math.pi / n))
+    return out
+
+
+def digit_reverse(value, digits, radix):
+    out = 0
+    for _ in range(digits):
+        out = out * radix + value % radix
+        value //= radix
+    return out
+
+
+def output_order(n):
+    """
+    Index of the frequency bin arm_cfft_f32 leaves at each position before
+    bit reversal, for the radix8by2 lengths (n = 2 * 8^m): one radix-2 stage
+    splitting even and odd bins, then two radix-8 FFTs in digit-reversed order.
+    """
+    half = n // 2
+    digits = round(math.log(half, 8))
+    assert 8 ** digits == half, 'only radix8by2 lengths are supported'
+    return [k // half + 2 * digit_reverse(k % half, digits, 8)
+            for k in range(n)]
+
+
+def bitrev_swaps(n):
+    """Sequential swaps moving the element at k to output_order(n)[k]."""
+    dest = output_order(n)
+    seen = [False] * n
+    swaps = []
+    for start in range(n):
+        if seen[start]:
+            continue
+        cycle = [start]
+        seen[start] = True
+        k = dest[start]
+        while k != start:
+            cycle.append(k)
+            seen[k] = True
+            k = dest[k]
+        # Park the element that belongs at each cycle member in turn
+        for k in cycle[1:]:
+            swaps.append((start, k))
+    return swaps
+
+
+def format_floats(values, per_line=4):
+    lines = []
+    for i in range(0, len(values), per_line):
+        chunk = values[i:i + per_line]
+        lines.append('    ' + ', '.join('%.9ef' % v for v in chunk) + ',')
+    return '\n'.join(lines)
+
+
+def format_u16(values, per_line=8):
+    lines = []
+    for i in range(0, len(values), per_line):
+        chunk = values[i:i + per_line]
+        lines.append('    ' + ', '.join('%d' % v for v in chunk) + ',')
+    return '\n'.join(lines)
+
+
+def main():
+    swaps = bitrev_swaps(CFFT_LEN)
+    entries = [8 * k for pair in swaps for k in pair]
+    assert len(entries) <= BITREV_TABLE_LENGTH
+    # The header fixes the length; the rest are no-op swaps of element 0
+    entries += [0] * (BITREV_TABLE_LENGTH - len(entries))
+
+    out = sys.stdout
+    out.write('''/*
+ * CMSIS-DSP FFT tables for the sizes the firmware uses (see the ARM_TABLE_*
+ * definitions in CMakeLists.txt). Generated by tools/gen_fft_tables.py,
+ * do not edit.
+ */
+#include "arm_math.h"
+#include "arm_common_tables.h"
+
+const float32_t twiddleCoef_%(n)d[%(tw)d] = {
+%(twiddle)s
+};
+
+const float32_t twiddleCoef_rfft_%(r)d[%(rtw)d] = {
+%(rfft)s
+};
+
+const uint16_t armBitRevIndexTable%(n)d[ARMBITREVINDEXTABLE_%(n)d_TABLE_LENGTH] = {
+%(bitrev)s
+};
+''' % dict(n=CFFT_LEN, r=RFFT_LEN, tw=2 * CFFT_LEN, rtw=RFFT_LEN,
+           twiddle=format_floats(twiddles(CFFT_LEN, CFFT_LEN)),
+           rfft=format_floats(rfft_twiddles(RFFT_LEN)),
+           bitrev=format_u16(entries)))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,364 @@
+"""
+Generate the telemetry message code from firmware/comms/telemetry.schema:
+
+    firmware/comms/telemetry_messages.h   message ids, packed structs, frame
+                                          encoders, TELEMETRY_SCHEMA_HASH
+    tools/telemetry/telemetry_schema.c    field descriptors for the host
+                                          decoder (telemetry_schema.h)
+
+The hash is FNV-1a (32 bit) over the canonical form of the schema: one line
+per const, message and field with counts resolved and comments dropped, so
+rewording a comment keeps the hash and any layout change moves it.
+
+    python3 tools/gen_telemetry_schema.py           # rewrite both files
+    python3 tools/gen_telemetry_schema.py --check   # fail if they are stale
+"""
+
+import os
+import re
+import sys
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+SCHEMA = os.path.join(ROOT, 'firmware', 'comms', 'telemetry.schema')
+HEADER = os.path.join(ROOT, 'firmware', 'comms', 'telemetry_messages.h')
+HOST = os.path.join(ROOT, 'tools', 'telemetry', 'telemetry_schema.c')
+FRAME = os.path.join(ROOT, 'firmware', 'comms', 'telemetry_frame.h')
+LINE_MAX = 120
+
+# Schema type: C type, size, TelemetrySchema_Type
+TYPES = {
+    'u8': ('uint8_t', 1, 'TELEMETRY_SCHEMA_U8'),
+    'i8': ('int8_t', 1, 'TELEMETRY_SCHEMA_I8'),
+    'u16': ('uint16_t', 2, 'TELEMETRY_SCHEMA_U16'),
+    'i16': ('int16_t', 2, 'TELEMETRY_SCHEMA_I16'),
+    'u32': ('uint32_t', 4, 'TELEMETRY_SCHEMA_U32'),
+    'i32': ('int32_t', 4, 'TELEMETRY_SCHEMA_I32'),
+    'f32': ('float', 4, 'TELEMETRY_SCHEMA_F32'),
+}
+
+IDENT = r'[A-Za-z_][A-Za-z0-9_]*'
+CONST_RE = re.compile(r'^const\s+(%s)\s+(\d+)$' % IDENT)
+MESSAGE_RE = re.compile(r'^message\s+(%s)\s+(0x[0-9A-Fa-f]+|\d+)(?:\s+(variable|opaque))?$' % IDENT)
+FIELD_RE = re.compile(r'^(\w+)(?:\[(\w+)\])?\s+(%s)$' % IDENT)
+
+
+class SchemaError(Exception):
+    pass
+
+
+def split_comment(line):
+    code, _, doc = line.partition('#')
+    return code.rstrip(), doc.strip()
+
+
+def max_payload():
+    with open(FRAME) as f:
+        m = re.search(r'#define TELEMETRY_MAX_PAYLOAD (\d+)', f.read())
+    return int(m.group(1))
+
+
+def parse(text):
+    consts = []      # (name, value, doc)
+    messages = []    # dict(name, id, kind, doc, fields=[(type, count, countText, name, doc)])
+    values = {}
+    for number, raw in enumerate(text.splitlines(), 1):
+        code, doc = split_comment(raw)
+        if not code.strip():
+            continue
+        where = 'telemetry.schema:%d: ' % number
+        indented = code[0].isspace()
+        code = code.strip()
+
+        if not indented:
+            m = CONST_RE.match(code)
+            if m:
+                values[m.group(1)] = int(m.group(2))
+                consts.append((m.group(1), int(m.group(2)), doc))
+                continue
+            m = MESSAGE_RE.match(code)
+            if not m:
+                raise SchemaError(where + 'expected const or message')
+            msg_id = int(m.group(2), 0)
+            if msg_id > 0xFF or any(x['id'] == msg_id for x in messages):
+                raise SchemaError(where + 'bad or duplicate id 0x%02X' % msg_id)
+            if any(x['name'] == m.group(1) for x in messages):
+                raise SchemaError(where + 'duplicate message ' + m.group(1))
+            messages.append({'name': m.group(1), 'id': msg_id, 'kind': m.group(3) or 'fixed',
+                             'doc': doc, 'fields': []})
+            continue
+
+        if not messages or messages[-1]['kind'] == 'opaque':
+            raise SchemaError(where + 'field outside a message with fields')
+        m = FIELD_RE.match(code)
+        if not m or m.group(1) not in TYPES:
+            raise SchemaError(where + 'expected <type>[count] <name>')
+        count_text = m.group(2)
+        if count_text is None:
+            count = 1
+        elif count_text.isdigit():
+            count = int(count_text)
+        elif count_text in values:
+            count = values[count_text]
+        else:
+            raise SchemaError(where + 'unknown count ' + count_text)
+        fields = messages[-1]['fields']
+        if any(f[3] == m.group(3) for f in fields):
+            raise SchemaError(where + 'duplicate field ' + m.group(3))
+        fields.append((m.group(1), count, count_text, m.group(3), doc))
+
+    for msg in messages:
+        if msg['kind'] != 'opaque' and not msg['fields']:
+            raise SchemaError('message %s has no fields' % msg['name'])
+        if msg['kind'] == 'variable' and msg['fields'][-1][2] is None:
+            raise SchemaError('message %s: the last field of a variable message must be an array' % msg['name'])
+        if payload_size(msg) > max_payload():
+            raise SchemaError('message %s: %d bytes, more than TELEMETRY_MAX_PAYLOAD'
+                              % (msg['name'], payload_size(msg)))
+    return consts, messages
+
+
+def canonical(consts, messages):
+    lines = ['const %s %d' % (name, value) for name, value, _ in consts]
+    for msg in messages:
+        lines.append('message %s 0x%02X %s' % (msg['name'], msg['id'], msg['kind']))
+        for ftype, count, _, name, _ in msg['fields']:
+            lines.append('%s[%d] %s' % (ftype, count, name))
+    return '\n'.join(lines) + '\n'
+
+
+def fnv1a32(data):
+    h = 0x811C9DC5
+    for byte in data:
+        h = ((h ^ byte) * 0x01000193) & 0xFFFFFFFF
+    return h
+
+
+def upper_snake(name):
+    return re.sub(r'(?<=[a-z0-9])(?=[A-Z])', '_', name).upper()
+
+
+def msg_enum(msg):
+    return 'TELEMETRY_MSG_' + upper_snake(msg['name'])
+
+
+def msg_struct(msg):
+    return 'Telemetry_%s_t' % msg['name']
+
+
+def payload_size(msg):
+    return sum(TYPES[t][1] * count for t, count, _, _, _ in msg['fields'])
+
+
+def aligned(lines, indent):
+    """(code, doc) pairs; docs line up one column after the longest code"""
+    width = max(len(code) for code, _ in lines)
+    out = []
+    for code, doc in lines:
+        if doc:
+            out.append('%s%s ///< %s' % (indent, code.ljust(width), doc))
+        else:
+            out.append(indent + code)
+    return out
+
+
+def signature(head, params):
+    """Function head and parameters, wrapped under the open parenthesis past LINE_MAX"""
+    lines = [head + '(']
+    for i, param in enumerate(params):
+        text = param + (')' if i == len(params) - 1 else ', ')
+        if len(lines[-1]) + len(text.rstrip()) > LINE_MAX:
+            lines[-1] = lines[-1].rstrip()
+            lines.append(' ' * (len(head) + 1))
+        lines[-1] += text
+    return lines
+
+
+def gen_header(consts, messages, schema_hash):
+    out = []
+    w = out.append
+    w('#ifndef TELEMETRY_MESSAGES_H')
+    w('#define TELEMETRY_MESSAGES_H')
+    w('')
+    w('#include <stdint.h>')
+    w('#include <stddef.h>')
+    w('#include "telemetry_frame.h"')
+    w('')
+    w('#ifdef __cplusplus')
+    w('extern "C"')
+    w('{')
+    w('#endif')
+    w('')
+    w('/*')
+    w(' * Generated by tools/gen_telemetry_schema.py from telemetry.schema: edit the')
+    w(' * schema and regenerate rather than this file. Payloads are the packed')
+    w(' * little-endian structs below; Telemetry_Encode<Message> frames one with')
+    w(' * the id and size that belong to it.')
+    w(' */')
+    w('#define TELEMETRY_SCHEMA_HASH 0x%08Xu' % schema_hash)
+    w('#define TELEMETRY_SCHEMA_MESSAGES %d' % len(messages))
+    for name, value, doc in consts:
+        w('#define %s %d%s' % (name, value, ' // ' + doc if doc else ''))
+    w('')
+
+    w('    enum Telemetry_MsgId')
+    w('    {')
+    rows = []
+    for msg in messages:
+        if msg['kind'] == 'opaque':
+            doc = msg['doc']
+        else:
+            doc = msg_struct(msg) + (': ' + msg['doc'] if msg['doc'] else '')
+        rows.append(('%s = 0x%02X,' % (msg_enum(msg), msg['id']), doc))
+    out.extend(aligned(rows, ' ' * 8))
+    w('    };')
+
+    for msg in messages:
+        if msg['kind'] == 'opaque':
+            continue
+        w('')
+        w('    typedef struct __attribute__((packed))')
+        w('    {')
+        rows = []
+        for ftype, count, count_text, name, doc in msg['fields']:
+            array = '[%s]' % count_text if count_text else ''
+            rows.append(('%s %s%s;' % (TYPES[ftype][0], name, array), doc))
+        out.extend(aligned(rows, ' ' * 8))
+        w('    } %s;' % msg_struct(msg))
+
+    w('')
+    w('#ifndef __cplusplus')
+    for msg in messages:
+        if msg['kind'] == 'opaque':
+            continue
+        w('    _Static_assert(sizeof(%s) == %d, "%s layout");' % (msg_struct(msg), payload_size(msg), msg['name']))
+    w('#endif')
+
+    for msg in messages:
+        if msg['kind'] == 'opaque':
+            continue
+        struct = msg_struct(msg)
+        w('')
+        w('    /**')
+        if msg['kind'] == 'variable':
+            last = msg['fields'][-1][3]
+            w('     * @brief Frame a %s message with the first %sLen elements of %s' % (msg_enum(msg), last, last))
+            params = ['uint8_t seq', 'const %s *msg' % struct, 'size_t %sLen' % last, 'uint8_t *out']
+        else:
+            params = ['uint8_t seq', 'const %s *msg' % struct, 'uint8_t *out']
+            w('     * @brief Frame a %s message, see Telemetry_EncodeFrame' % msg_enum(msg))
+        w('     */')
+        out.extend(signature('    static inline size_t Telemetry_Encode%s' % msg['name'], params))
+        w('    {')
+        if msg['kind'] == 'variable':
+            w('        size_t len = offsetof(%s, %s) + %sLen * sizeof(msg->%s[0]);' % (struct, last, last, last))
+            w('        return Telemetry_EncodeFrame(%s, seq, msg, len, out);' % msg_enum(msg))
+        else:
+            w('        return Telemetry_EncodeFrame(%s, seq, msg, sizeof(*msg), out);' % msg_enum(msg))
+        w('    }')
+
+    w('')
+    w('#ifdef __cplusplus')
+    w('}')
+    w('#endif')
+    w('')
+    w('#endif // TELEMETRY_MESSAGES_H')
+    return '\n'.join(out) + '\n'
+
+
+def gen_host(messages):
+    out = []
+    w = out.append
+    w('/*')
+    w(' * Generated by tools/gen_telemetry_schema.py from telemetry.schema: edit the')
+    w(' * schema and regenerate rather than this file.')
+    w(' */')
+    w('#include "telemetry_schema.h"')
+    w('')
+    w('/*----------------------------------------------------------------------------*/')
+    w('/* INTERNAL DEFINITIONS                                                       */')
+    w('/*----------------------------------------------------------------------------*/')
+    for msg in messages:
+        if msg['kind'] == 'opaque':
+            continue
+        w('')
+        w('static const TelemetrySchema_Field_t s_%sFields[] = {' % (msg['name'][0].lower() + msg['name'][1:]))
+        for ftype, count, _, name, _ in msg['fields']:
+            w('    {"%s", %s, offsetof(%s, %s), %d},' % (name, TYPES[ftype][2], msg_struct(msg), name, count))
+        w('};')
+    w('')
+    w('static const TelemetrySchema_Message_t s_messages[TELEMETRY_SCHEMA_MESSAGES] = {')
+    for msg in messages:
+        kind = 'TELEMETRY_SCHEMA_' + msg['kind'].upper()
+        if msg['kind'] == 'opaque':
+            w('    {%s, "%s", %s, 0, 0, NULL},' % (msg_enum(msg), msg['name'], kind))
+        else:
+            fields = 's_%sFields' % (msg['name'][0].lower() + msg['name'][1:])
+            w('    {%s, "%s", %s, sizeof(%s), %d, %s},'
+              % (msg_enum(msg), msg['name'], kind, msg_struct(msg), len(msg['fields']), fields))
+    w('};')
+    w('')
+    w('/*----------------------------------------------------------------------------*/')
+    w('/* PUBLIC API IMPLEMENTATION                                                  */')
+    w('/*----------------------------------------------------------------------------*/')
+    w('')
+    w('uint32_t TelemetrySchema_Hash(void)')
+    w('{')
+    w('    return TELEMETRY_SCHEMA_HASH;')
+    w('}')
+    w('')
+    w('size_t TelemetrySchema_Count(void)')
+    w('{')
+    w('    return TELEMETRY_SCHEMA_MESSAGES;')
+    w('}')
+    w('')
+    w('const TelemetrySchema_Message_t *TelemetrySchema_Get(size_t index)')
+    w('{')
+    w('    return index < TELEMETRY_SCHEMA_MESSAGES ? &s_messages[index] : NULL;')
+    w('}')
+    w('')
+    w('const TelemetrySchema_Message_t *TelemetrySchema_Find(uint8_t msgId)')
+    w('{')
+    w('    for (size_t i = 0; i < TELEMETRY_SCHEMA_MESSAGES; i++)')
+    w('    {')
+    w('        if (s_messages[i].id == msgId)')
+    w('        {')
+    w('            return &s_messages[i];')
+    w('        }')
+    w('    }')
+    w('    return NULL;')
+    w('}')
+    return '\n'.join(out) + '\n'
+
+
+def main():
+    check = '--check' in sys.argv[1:]
+    with open(SCHEMA) as f:
+        try:
+            consts, messages = parse(f.read())
+        except SchemaError as e:
+            sys.exit(str(e))
+
+    schema_hash = fnv1a32(canonical(consts, messages).encode())
+    outputs = [(HEADER, gen_header(consts, messages, schema_hash)), (HOST, gen_host(messages))]
+    stale = []
+    for path, text in outputs:
+        try:
+            with open(path) as f:
+                current = f.read()
+        except OSError:
+            current = None
+        if current == text:
+            continue
+        if check:
+            stale.append(os.path.relpath(path, ROOT))
+        else:
+            with open(path, 'w') as f:
+                f.write(text)
+    if stale:
+        sys.exit('out of date with telemetry.schema: %s (run tools/gen_telemetry_schema.py)' % ', '.join(stale))
+    if not check:
+        print('schema hash 0x%08X, %d messages' % (schema_hash, len(messages)))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,309 @@
+/*
+ * stflight_capture: record the firmware telemetry link to a capture file.
+ *
+ *   stflight_capture [-b baud] [-t] [-s seconds] <serial port | -> <out.cap>
+ *   stflight_capture -i <in.cap>
+ *
+ * Every frame that passes the CRC (or every parsed line with -t) is written
+ * to the capture file; decoder statistics are printed once per second.
+ * "-" reads a raw byte dump from stdin. -i prints a summary of a capture.
+ */
+#define _DEFAULT_SOURCE
+#include "telemetry_capture.h"
+#include "telemetry_table.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL DEFINITIONS                                                       */
+/*----------------------------------------------------------------------------*/
+
+#define CAPTURE_READ_SIZE 4096
+
+typedef struct
+{
+    FILE *out;
+    uint32_t hostTime_ms;
+    uint64_t records;
+    uint64_t perMsg[256];
+    bool writeError;
+} Capture_t;
+
+static volatile sig_atomic_t s_stop = 0;
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+static void Capture_OnSignal(int sig)
+{
+    (void)sig;
+    s_stop = 1;
+}
+
+static uint64_t Capture_NowMs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+}
+
+static speed_t Capture_BaudConstant(long baud)
+{
+    switch (baud)
+    {
+    case 115200:
+        return B115200;
+    case 230400:
+        return B230400;
+    case 460800:
+        return B460800;
+    case 921600:
+        return B921600;
+#ifdef B1000000
+    case 1000000:
+        return B1000000;
+    case 1500000:
+        return B1500000;
+    case 2000000:
+        return B2000000;
+#endif
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief Open a serial port raw (8N1, no flow control) at the given baud
+ * @return File descriptor, negative on error
+ */
+static int Capture_OpenSerial(const char *path, long baud)
+{
+    speed_t speed = Capture_BaudConstant(baud);
+    if (speed == 0)
+    {
+        fprintf(stderr, "unsupported baud rate %ld\n", baud);
+        return -1;
+    }
+
+    int fd = open(path, O_RDONLY | O_NOCTTY);
+    if (fd < 0)
+    {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    struct termios tio;
+    if (tcgetattr(fd, &tio) != 0)
+    {
+        fprintf(stderr, "%s: not a serial port\n", path);
+        close(fd);
+        return -1;
+    }
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cflag &= ~(tcflag_t)CRTSCTS;
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 1; // return after 100 ms of silence so statistics keep printing
+    if (tcsetattr(fd, TCSANOW, &tio) != 0)
+    {
+        fprintf(stderr, "%s: cannot configure\n", path);
+        close(fd);
+        return -1;
+    }
+    tcflush(fd, TCIFLUSH);
+    return fd;
+}
+
+static void Capture_OnFrame(void *ctx, const TelemetryStream_Frame_t *frame)
+{
+    Capture_t *cap = ctx;
+    if (TelemetryCapture_WriteRecord(cap->out, cap->hostTime_ms, frame) != 0)
+    {
+        cap->writeError = true;
+        return;
+    }
+    cap->records++;
+    cap->perMsg[frame->msgId]++;
+}
+
+static void Capture_PrintStats(const Capture_t *cap, const TelemetryStream_Stats_t *s, double seconds)
+{
+    fprintf(stderr,
+            "%7.1f s  %10llu B  %8llu frames  lost %llu  crc %llu  cobs %llu  oversize %llu  badline %llu\n", seconds,
+            (unsigned long long)s->bytes, (unsigned long long)cap->records, (unsigned long long)s->lostFrames,
+            (unsigned long long)s->crcErrors, (unsigned long long)s->cobsErrors, (unsigned long long)s->oversize,
+            (unsigned long long)s->badLines);
+}
+
+static int Capture_Summary(const char *path)
+{
+    static const char *const s_names[TELEMETRY_TABLE_COUNT] = {"imu", "baro", "mag", "vector3", "status"};
+
+    TelemetryTable_t *t = TelemetryTable_Create(TELEMETRY_STREAM_BINARY);
+    if (!t)
+    {
+        return 1;
+    }
+    long records = TelemetryTable_LoadCapture(t, path);
+    if (records < 0)
+    {
+        fprintf(stderr, "%s: cannot read capture (%ld)\n", path, records);
+        TelemetryTable_Destroy(t);
+        return 1;
+    }
+
+    printf("%s: %ld records\n", path, records);
+    for (int k = 0; k < TELEMETRY_TABLE_COUNT; k++)
+    {
+        printf("  %-8s %zu rows\n", s_names[k], TelemetryTable_Rows(t, k, NULL));
+    }
+    const TelemetryTable_Stats_t *s = TelemetryTable_GetStats(t);
+    for (size_t i = 0; i < TelemetrySchema_Count(); i++)
+    {
+        const TelemetrySchema_Message_t *msg = TelemetrySchema_Get(i);
+        size_t rows = TelemetryTable_MessageRows(t, msg->id, NULL);
+        if (rows > 0)
+        {
+            printf("  %-8s %zu rows\n", msg->name, rows);
+        }
+    }
+    printf("  imu blocks skipped %llu, bad %llu; unknown frames %llu; bad length %llu\n",
+           (unsigned long long)s->imuSkippedBlocks, (unsigned long long)s->imuBadBlocks,
+           (unsigned long long)s->unknownFrames, (unsigned long long)s->badLength);
+    printf("  schema: firmware 0x%08llX, this build 0x%08X%s\n", (unsigned long long)s->schemaHash,
+           TelemetrySchema_Hash(), s->schemaMismatch ? " (MISMATCH: fields may be misread)" : "");
+    TelemetryTable_Destroy(t);
+    return 0;
+}
+
+static void Capture_Usage(void)
+{
+    fprintf(stderr, "usage: stflight_capture [-b baud] [-t] [-s seconds] <serial port | -> <out.cap>\n"
+                    "       stflight_capture -i <in.cap>\n"
+                    "  -b  baud rate (default 2000000, TELEMETRY_HIGH_RATE; 115200 with it off)\n"
+                    "  -t  text lines instead of binary frames\n"
+                    "  -s  stop after this many seconds (default: Ctrl-C)\n");
+}
+
+/*----------------------------------------------------------------------------*/
+/* ENTRY POINT                                                                */
+/*----------------------------------------------------------------------------*/
+
+int main(int argc, char **argv)
+{
+    long baud = 2000000;
+    uint8_t mode = TELEMETRY_STREAM_BINARY;
+    double duration_s = 0.0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "b:ts:i:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 'b':
+            baud = strtol(optarg, NULL, 10);
+            break;
+        case 't':
+            mode = TELEMETRY_STREAM_TEXT;
+            break;
+        case 's':
+            duration_s = strtod(optarg, NULL);
+            break;
+        case 'i':
+            return Capture_Summary(optarg);
+        default:
+            Capture_Usage();
+            return 2;
+        }
+    }
+    if (argc - optind != 2)
+    {
+        Capture_Usage();
+        return 2;
+    }
+
+    const char *input = argv[optind];
+    int fd = (strcmp(input, "-") == 0) ? STDIN_FILENO : Capture_OpenSerial(input, baud);
+    if (fd < 0)
+    {
+        return 1;
+    }
+
+    static Capture_t cap;
+    cap.out = fopen(argv[optind + 1], "wb");
+    if (!cap.out || TelemetryCapture_WriteHeader(cap.out, (uint32_t)time(NULL)) != 0)
+    {
+        fprintf(stderr, "%s: cannot write\n", argv[optind + 1]);
+        return 1;
+    }
+
+    TelemetryStream_t stream;
+    TelemetryStream_Init(&stream, mode, Capture_OnFrame, &cap);
+
+    signal(SIGINT, Capture_OnSignal);
+    signal(SIGTERM, Capture_OnSignal);
+
+    uint64_t start = Capture_NowMs();
+    uint64_t lastPrint = start;
+    static uint8_t buf[CAPTURE_READ_SIZE];
+    while (!s_stop && !cap.writeError)
+    {
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n < 0 && errno != EINTR)
+        {
+            fprintf(stderr, "read: %s\n", strerror(errno));
+            break;
+        }
+        if (n == 0 && fd == STDIN_FILENO)
+        {
+            break; // end of the dump
+        }
+
+        uint64_t now = Capture_NowMs();
+        cap.hostTime_ms = (uint32_t)(now - start);
+        if (n > 0)
+        {
+            TelemetryStream_Feed(&stream, buf, (size_t)n);
+        }
+
+        if (now - lastPrint >= 1000)
+        {
+            lastPrint = now;
+            Capture_PrintStats(&cap, &stream.stats, (double)(now - start) / 1000.0);
+        }
+        if (duration_s > 0.0 && (double)(now - start) >= duration_s * 1000.0)
+        {
+            break;
+        }
+    }
+
+    Capture_PrintStats(&cap, &stream.stats, (double)(Capture_NowMs() - start) / 1000.0);
+    for (int id = 0; id < 256; id++)
+    {
+        if (cap.perMsg[id])
+        {
+            fprintf(stderr, "  msg 0x%02X: %llu\n", id, (unsigned long long)cap.perMsg[id]);
+        }
+    }
+
+    if (fd != STDIN_FILENO)
+    {
+        close(fd);
+    }
+    if (fclose(cap.out) != 0 || cap.writeError)
+    {
+        fprintf(stderr, "%s: write error\n", argv[optind + 1]);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,469 @@
+/*
+ * stflight_download: pull the flight log off the board (log_download.h).
+ *
+ *   stflight_download [-b baud] [-w window] [-r] <serial port> <out.bin>
+ *
+ * Asks the board for the log size, then reads it from the start (or, with
+ * -r, from the end of an existing out.bin, to finish an interrupted
+ * download) and writes the raw log stream: the flight log sessions one after
+ * the other, ready for the flight log reader. Chunks are acknowledged every
+ * half window; a gap, a bad CRC or 200 ms of silence restarts the read from
+ * the first missing byte. The rate is printed as it goes.
+ *
+ * Offsets count from the oldest data on the board, which moves when the
+ * blackbox erases a sector. The LOG_INFO origin of a download is kept next
+ * to it in out.bin.origin, and -r refuses to append when the board reports
+ * another one: the bytes would not continue the file.
+ */
+#define _DEFAULT_SOURCE
+#include "telemetry_stream.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL DEFINITIONS                                                       */
+/*----------------------------------------------------------------------------*/
+
+#define DOWNLOAD_READ_SIZE 4096
+#define DOWNLOAD_INFO_TRIES 10
+#define DOWNLOAD_INFO_TIMEOUT_MS 500
+#define DOWNLOAD_RETRY_MS 200 // silence before the read is restarted
+#define DOWNLOAD_MAX_RETRIES 25
+#define DOWNLOAD_ORIGIN_SUFFIX ".origin"
+
+typedef struct
+{
+    int fd;
+    FILE *out;
+    uint8_t seq;
+
+    bool haveInfo;
+    Telemetry_LogInfo_t info;
+    uint16_t ackEvery; ///< Chunks between ACKs
+
+    uint32_t expected; ///< Next log byte wanted
+    uint32_t end;
+    uint16_t sinceAck;
+    uint64_t lastData_ms;
+    uint64_t lastRequest_ms;
+    uint64_t duplicates;
+    uint64_t restarts;
+    bool writeError;
+} Download_t;
+
+static volatile sig_atomic_t s_stop = 0;
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+static void Download_OnSignal(int sig)
+{
+    (void)sig;
+    s_stop = 1;
+}
+
+static uint64_t Download_NowMs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+}
+
+static speed_t Download_BaudConstant(long baud)
+{
+    switch (baud)
+    {
+    case 115200:
+        return B115200;
+    case 230400:
+        return B230400;
+    case 460800:
+        return B460800;
+    case 921600:
+        return B921600;
+#ifdef B1000000
+    case 1000000:
+        return B1000000;
+    case 1500000:
+        return B1500000;
+    case 2000000:
+        return B2000000;
+#endif
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief Open a serial port raw (8N1, no flow control) for reading and writing
+ * @return File descriptor, negative on error
+ */
+static int Download_OpenSerial(const char *path, long baud)
+{
+    speed_t speed = Download_BaudConstant(baud);
+    if (speed == 0)
+    {
+        fprintf(stderr, "unsupported baud rate %ld\n", baud);
+        return -1;
+    }
+
+    int fd = open(path, O_RDWR | O_NOCTTY);
+    if (fd < 0)
+    {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    struct termios tio;
+    if (tcgetattr(fd, &tio) != 0)
+    {
+        fprintf(stderr, "%s: not a serial port\n", path);
+        close(fd);
+        return -1;
+    }
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cflag &= ~(tcflag_t)CRTSCTS;
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 1; // reads return after 100 ms of silence: the timeouts need the control back
+    if (tcsetattr(fd, TCSANOW, &tio) != 0)
+    {
+        fprintf(stderr, "%s: cannot configure\n", path);
+        close(fd);
+        return -1;
+    }
+    tcflush(fd, TCIOFLUSH);
+    return fd;
+}
+
+static void Download_Send(Download_t *dl, uint8_t msgId, const void *payload, size_t len)
+{
+    uint8_t frame[TELEMETRY_MAX_ENCODED];
+    size_t n = Telemetry_EncodeFrame(msgId, dl->seq++, payload, len, frame);
+    if (write(dl->fd, frame, n) != (ssize_t)n)
+    {
+        fprintf(stderr, "write: %s\n", strerror(errno));
+    }
+}
+
+static void Download_Request(Download_t *dl, uint64_t now)
+{
+    Telemetry_LogRead_t req = {dl->expected, dl->end - dl->expected};
+    Download_Send(dl, TELEMETRY_MSG_LOG_READ, &req, sizeof(req));
+    dl->sinceAck = 0;
+    dl->lastRequest_ms = now;
+    dl->lastData_ms = now;
+}
+
+static void Download_Ack(Download_t *dl)
+{
+    Telemetry_LogAck_t ack = {dl->expected};
+    Download_Send(dl, TELEMETRY_MSG_LOG_ACK, &ack, sizeof(ack));
+    dl->sinceAck = 0;
+}
+
+static void Download_OnData(Download_t *dl, const uint8_t *payload, size_t len)
+{
+    Telemetry_LogData_t chunk;
+    if (len <= sizeof(chunk.offset) || len > sizeof(chunk))
+    {
+        return;
+    }
+    memcpy(&chunk, payload, len);
+    size_t n = len - sizeof(chunk.offset);
+    uint64_t now = Download_NowMs();
+
+    if (chunk.offset != dl->expected)
+    {
+        if (chunk.offset < dl->expected)
+        {
+            dl->duplicates++; // resent after a restart
+        }
+        else if (now - dl->lastRequest_ms >= DOWNLOAD_RETRY_MS / 2)
+        {
+            // A chunk went missing: go back for it, once per burst
+            dl->restarts++;
+            Download_Request(dl, now);
+        }
+        return;
+    }
+
+    if (fwrite(chunk.data, 1, n, dl->out) != n)
+    {
+        dl->writeError = true;
+        return;
+    }
+    dl->expected += (uint32_t)n;
+    dl->lastData_ms = now;
+    if (++dl->sinceAck >= dl->ackEvery || dl->expected >= dl->end)
+    {
+        Download_Ack(dl);
+    }
+}
+
+static void Download_OnFrame(void *ctx, const TelemetryStream_Frame_t *frame)
+{
+    Download_t *dl = ctx;
+    switch (frame->msgId)
+    {
+    case TELEMETRY_MSG_LOG_INFO:
+        if (frame->len == sizeof(Telemetry_LogInfo_t))
+        {
+            memcpy(&dl->info, frame->payload, sizeof(dl->info));
+            dl->haveInfo = true;
+        }
+        break;
+    case TELEMETRY_MSG_LOG_DATA:
+        if (dl->haveInfo)
+        {
+            Download_OnData(dl, frame->payload, frame->len);
+        }
+        break;
+    default:
+        // Sensor telemetry still in flight when the download started
+        break;
+    }
+}
+
+/**
+ * @brief One read of the link into the decoder; returns after 100 ms of silence
+ * @return 0, or -1 on a read error
+ */
+static int Download_Poll(int fd, TelemetryStream_t *stream)
+{
+    static uint8_t buf[DOWNLOAD_READ_SIZE];
+    ssize_t n = read(fd, buf, sizeof(buf));
+    if (n < 0 && errno != EINTR)
+    {
+        fprintf(stderr, "read: %s\n", strerror(errno));
+        return -1;
+    }
+    if (n > 0)
+    {
+        TelemetryStream_Feed(stream, buf, (size_t)n);
+    }
+    return 0;
+}
+
+static void Download_PrintProgress(const Download_t *dl, uint32_t start, double seconds, long baud)
+{
+    double bytes = (double)(dl->expected - start);
+    double rate = seconds > 0.0 ? bytes / seconds : 0.0;
+    fprintf(stderr, "%7.1f s  %10u / %u B  %8.1f kB/s  (%.0f%% of %ld baud)  restarts %llu  duplicates %llu\n",
+            seconds, dl->expected, dl->end, rate / 1000.0, 100.0 * rate * 10.0 / (double)baud,
+            baud, (unsigned long long)dl->restarts, (unsigned long long)dl->duplicates);
+}
+
+/**
+ * @brief Origin the download into outPath started from, as saved next to it
+ * @return 0, or -1 if there is none
+ */
+static int Download_LoadOrigin(const char *outPath, uint32_t *origin)
+{
+    char path[4096];
+    snprintf(path, sizeof(path), "%s%s", outPath, DOWNLOAD_ORIGIN_SUFFIX);
+    FILE *f = fopen(path, "r");
+    if (!f)
+    {
+        return -1;
+    }
+    unsigned int value;
+    int ret = fscanf(f, "%u", &value) == 1 ? 0 : -1;
+    fclose(f);
+    *origin = value;
+    return ret;
+}
+
+static int Download_SaveOrigin(const char *outPath, uint32_t origin)
+{
+    char path[4096];
+    snprintf(path, sizeof(path), "%s%s", outPath, DOWNLOAD_ORIGIN_SUFFIX);
+    FILE *f = fopen(path, "w");
+    if (!f)
+    {
+        fprintf(stderr, "%s: cannot write\n", path);
+        return -1;
+    }
+    fprintf(f, "%u\n", origin);
+    return fclose(f) == 0 ? 0 : -1;
+}
+
+static void Download_Usage(void)
+{
+    fprintf(stderr, "usage: stflight_download [-b baud] [-w window] [-r] <serial port> <out.bin>\n"
+                    "  -b  baud rate the firmware link runs at (default 2000000, TELEMETRY_HIGH_RATE;\n"
+                    "      115200 with it off)\n"
+                    "  -w  ACK every window / 2 chunks (default: the window the board reports)\n"
+                    "  -r  resume: keep out.bin and read the log from its end, if the board's log\n"
+                    "      still starts where it did (out.bin.origin)\n");
+}
+
+/*----------------------------------------------------------------------------*/
+/* ENTRY POINT                                                                */
+/*----------------------------------------------------------------------------*/
+
+int main(int argc, char **argv)
+{
+    long baud = 2000000;
+    long window = 0;
+    bool resume = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "b:w:rh")) != -1)
+    {
+        switch (opt)
+        {
+        case 'b':
+            baud = strtol(optarg, NULL, 10);
+            break;
+        case 'w':
+            window = strtol(optarg, NULL, 10);
+            break;
+        case 'r':
+            resume = true;
+            break;
+        default:
+            Download_Usage();
+            return 2;
+        }
+    }
+    if (argc - optind != 2)
+    {
+        Download_Usage();
+        return 2;
+    }
+
+    const char *outPath = argv[optind + 1];
+    static Download_t dl;
+    dl.fd = Download_OpenSerial(argv[optind], baud);
+    if (dl.fd < 0)
+    {
+        return 1;
+    }
+    dl.out = fopen(outPath, resume ? "ab" : "wb");
+    if (!dl.out)
+    {
+        fprintf(stderr, "%s: cannot write\n", outPath);
+        return 1;
+    }
+    long have = ftell(dl.out);
+    uint32_t start = have > 0 ? (uint32_t)have : 0u;
+
+    TelemetryStream_t stream;
+    TelemetryStream_Init(&stream, TELEMETRY_STREAM_BINARY, Download_OnFrame, &dl);
+
+    signal(SIGINT, Download_OnSignal);
+    signal(SIGTERM, Download_OnSignal);
+
+    for (int tries = 0; tries < DOWNLOAD_INFO_TRIES && !dl.haveInfo && !s_stop; tries++)
+    {
+        Download_Send(&dl, TELEMETRY_MSG_LOG_INFO, NULL, 0);
+        uint64_t asked = Download_NowMs();
+        while (!dl.haveInfo && !s_stop && Download_NowMs() - asked < DOWNLOAD_INFO_TIMEOUT_MS)
+        {
+            if (Download_Poll(dl.fd, &stream) != 0)
+            {
+                return 1;
+            }
+        }
+    }
+    if (!dl.haveInfo)
+    {
+        fprintf(stderr, "no answer from the board\n");
+        return 1;
+    }
+    uint32_t origin;
+    if (start > 0 && Download_LoadOrigin(outPath, &origin) != 0)
+    {
+        fprintf(stderr, "%s%s: missing, cannot tell where %s starts: download again without -r\n", outPath,
+                DOWNLOAD_ORIGIN_SUFFIX, outPath);
+        return 1;
+    }
+    if (start > 0 && origin != dl.info.origin)
+    {
+        fprintf(stderr, "the board's log starts at sector sequence %u now, %s at %u: its oldest data was erased, "
+                        "download again without -r\n",
+                dl.info.origin, outPath, origin);
+        return 1;
+    }
+    if (start > dl.info.size)
+    {
+        fprintf(stderr, "%s: %u bytes, longer than the %u byte log\n", outPath, start, dl.info.size);
+        return 1;
+    }
+    if (start == 0 && Download_SaveOrigin(outPath, dl.info.origin) != 0)
+    {
+        return 1;
+    }
+    fprintf(stderr, "log %u B, chunk %u B, window %u, origin %u; from %u\n", dl.info.size, dl.info.chunkSize,
+            dl.info.window, dl.info.origin, start);
+
+    long ackWindow = window > 0 ? window : dl.info.window;
+    dl.ackEvery = ackWindow >= 2 ? (uint16_t)(ackWindow / 2) : 1u;
+    dl.expected = start;
+    dl.end = dl.info.size;
+
+    uint64_t begin = Download_NowMs();
+    uint64_t lastPrint = begin;
+    int retries = 0;
+    if (dl.expected < dl.end)
+    {
+        Download_Request(&dl, begin);
+    }
+    while (dl.expected < dl.end && !s_stop && !dl.writeError)
+    {
+        uint32_t before = dl.expected;
+        if (Download_Poll(dl.fd, &stream) != 0)
+        {
+            break;
+        }
+        uint64_t now = Download_NowMs();
+        if (dl.expected != before)
+        {
+            retries = 0;
+        }
+        else if (now - dl.lastData_ms >= DOWNLOAD_RETRY_MS)
+        {
+            if (++retries > DOWNLOAD_MAX_RETRIES)
+            {
+                fprintf(stderr, "board stopped answering\n");
+                break;
+            }
+            dl.restarts++;
+            Download_Request(&dl, now);
+        }
+        if (now - lastPrint >= 1000)
+        {
+            lastPrint = now;
+            Download_PrintProgress(&dl, start, (double)(now - begin) / 1000.0, baud);
+        }
+    }
+
+    Download_PrintProgress(&dl, start, (double)(Download_NowMs() - begin) / 1000.0, baud);
+    fprintf(stderr, "frames %llu, crc errors %llu, cobs errors %llu\n", (unsigned long long)stream.stats.frames,
+            (unsigned long long)stream.stats.crcErrors, (unsigned long long)stream.stats.cobsErrors);
+
+    close(dl.fd);
+    if (fclose(dl.out) != 0 || dl.writeError)
+    {
+        fprintf(stderr, "%s: write error\n", outPath);
+        return 1;
+    }
+    if (dl.expected < dl.end)
+    {
+        fprintf(stderr, "incomplete: run again with -r to continue from %u\n", dl.expected);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,216 @@
+"""
+Live plot of the telemetry link; replaces read_accel.py, read_mag.py and
+read_pressure_temp.py.
+
+    python3 tools/telemetry/stflight_plot.py accel
+    python3 tools/telemetry/stflight_plot.py gyro -c x,z -b 115200
+    python3 tools/telemetry/stflight_plot.py baro -n 2000
+
+Every received sample goes into a preallocated ring buffer; each animation
+frame appends everything that arrived since the previous one in a single
+slice assignment. The window is drawn as a min/max envelope of at most
+--width columns, so spikes stay visible however many samples it holds.
+Needs libstflight_telemetry (see stflight_telemetry.py) and pyserial.
+"""
+
+import argparse
+import os
+import sys
+import time
+
+import numpy as np
+import serial
+from matplotlib import animation
+from matplotlib import pyplot as plt
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import stflight_telemetry as stt  # noqa: E402
+
+
+# Per sensor: table in text and binary mode, how to pull the channels out of
+# a row array, channel names, scale to display units and default y range
+SENSORS = {
+    'accel': dict(text=stt.VECTOR3, binary=stt.IMU,
+                  text_field='v', binary_field='accel',
+                  channels=('x', 'y', 'z'), scale=1 / 4200, ylim=(-2, 2)),
+    'gyro': dict(text=None, binary=stt.IMU,
+                 text_field=None, binary_field='gyro',
+                 channels=('x', 'y', 'z'), scale=1.0, ylim=(-2000, 2000)),
+    'mag': dict(text=stt.VECTOR3, binary=stt.MAG,
+                text_field='v', binary_field='mag',
+                channels=('x', 'y', 'z'), scale=1 / 250, ylim=(-2, 2)),
+    'baro': dict(text=stt.BARO, binary=stt.BARO,
+                 text_field=None, binary_field=None,
+                 channels=('pressure', 'temperature'), scale=1.0,
+                 ylim=((1000, 1100), (17, 40))),
+}
+
+
+class RingBuffer:
+    """Fixed-capacity sample history, oldest samples overwritten first."""
+
+    def __init__(self, capacity, channels):
+        self.data = np.full((capacity, channels), np.nan, dtype=np.float32)
+        self.head = 0     # next row to write
+        self.count = 0    # valid rows
+        self.total = 0    # rows ever written
+
+    def extend(self, block):
+        """Append rows (shape [n, channels]) with at most two slice copies."""
+        capacity = len(self.data)
+        n = len(block)
+        if n == 0:
+            return
+        if n >= capacity:
+            block = block[-capacity:]
+            self.data[:] = block
+            self.head = 0
+        else:
+            first = min(n, capacity - self.head)
+            self.data[self.head:self.head + first] = block[:first]
+            self.data[:n - first] = block[first:]
+            self.head = (self.head + n) % capacity
+        self.total += n
+        self.count = min(self.count + n, capacity)
+
+    def latest(self, n):
+        """Newest n rows, oldest first (a copy only when they wrap)."""
+        n = min(n, self.count)
+        start = self.head - n
+        if start >= 0:
+            return self.data[start:self.head]
+        return np.concatenate((self.data[start:], self.data[:self.head]))
+
+
+def envelope(samples, width):
+    """
+    Decimate [n, channels] to at most 2 * width points per channel: the min
+    and max of each column, so the drawn line covers every sample's value.
+    Returns x positions (sample offsets from the newest) and y values.
+    """
+    n = len(samples)
+    if n <= 2 * width:
+        return np.arange(-n + 1, 1), samples
+    step = n // width
+    used = step * width
+    bins = samples[n - used:].reshape(width, step, -1)
+    y = np.empty((2 * width, samples.shape[1]), dtype=samples.dtype)
+    y[0::2] = bins.min(axis=1)
+    y[1::2] = bins.max(axis=1)
+    x = np.repeat(np.arange(-used + 1, 1, step) + step - 1, 2)
+    return x, y
+
+
+def extract(rows, sensor, binary):
+    """Channel columns of newly decoded rows as float32 [n, channels]."""
+    if len(rows) == 0:
+        return np.empty((0, len(sensor['channels'])), dtype=np.float32)
+    if rows.dtype == stt.DTYPES[stt.BARO]:
+        out = np.column_stack((rows['pressure_hPa'], rows['temperature_C']))
+    else:
+        field = sensor['binary_field'] if binary else sensor['text_field']
+        out = rows[field]
+    return out.astype(np.float32) * np.float32(sensor['scale'])
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    parser.add_argument('sensor', choices=sorted(SENSORS))
+    parser.add_argument('-p', '--port', default='/dev/ttyACM0')
+    parser.add_argument('-b', '--baud', type=int, default=2000000)
+    parser.add_argument('--text', action='store_true',
+                        help='text lines (firmware TELEMETRY_TEXT_OUTPUT 1)')
+    parser.add_argument('-c', '--channels',
+                        help='comma-separated subset, e.g. x,z')
+    parser.add_argument('-n', '--window', type=int, default=5000,
+                        help='samples shown (default 5000)')
+    parser.add_argument('--width', type=int, default=1000,
+                        help='envelope columns drawn (default 1000)')
+    parser.add_argument('--ylim', type=float, nargs=2)
+    parser.add_argument('--interval', type=int, default=30,
+                        help='redraw period in ms (default 30)')
+    args = parser.parse_args()
+
+    sensor = SENSORS[args.sensor]
+    args.binary = not args.text
+    kind = sensor['binary'] if args.binary else sensor['text']
+    if kind is None:
+        parser.error('%s is only sent in binary mode' % args.sensor)
+
+    names = sensor['channels']
+    selected = list(range(len(names)))
+    if args.channels:
+        wanted = args.channels.split(',')
+        unknown = [c for c in wanted if c not in names]
+        if unknown:
+            parser.error('unknown channel %s (have %s)'
+                         % (unknown[0], ','.join(names)))
+        selected = [names.index(c) for c in wanted]
+
+    port = serial.Serial(args.port, args.baud, timeout=0)
+    tables = stt.Telemetry(stt.BINARY if args.binary else stt.TEXT)
+    ring = RingBuffer(args.window, len(names))
+    start = time.monotonic()
+    rate = [0.0, ring.total, start]
+
+    # Pressure and temperature get their own y axis, as in read_pressure_temp
+    fig, ax = plt.subplots()
+    twin = args.sensor == 'baro' and len(selected) == 2
+    axes = [ax, ax.twinx()] if twin else [ax] * len(selected)
+    lines = []
+    for slot, ch in enumerate(selected):
+        line, = axes[slot].plot([], [], lw=1, label=names[ch],
+                                color='C%d' % slot)
+        lines.append(line)
+    if twin:
+        ylims = sensor['ylim']
+    elif args.ylim:
+        ylims = [args.ylim]
+    elif args.sensor == 'baro':
+        ylims = [sensor['ylim'][selected[0]]]
+    else:
+        ylims = [sensor['ylim']]
+    for a, ylim in zip(axes, ylims):
+        a.set_xlim(-args.window + 1, 0)
+        a.set_ylim(*ylim)
+    ax.set_xlabel('samples')
+    fig.legend(loc='upper right')
+    ax.grid()
+    # Inside the axes so blitting redraws it
+    status = ax.text(0.01, 0.98, args.sensor, transform=ax.transAxes,
+                     va='top')
+
+    def update(_frame):
+        waiting = port.in_waiting
+        if waiting:
+            tables.feed(port.read(waiting),
+                        int((time.monotonic() - start) * 1000))
+        ring.extend(extract(tables.rows(kind), sensor, args.binary))
+        # Rows are in the ring now; drop every table so memory stays bounded
+        for k in stt.DTYPES:
+            tables.clear(k)
+
+        x, y = envelope(ring.latest(args.window), args.width)
+        for line, ch in zip(lines, selected):
+            line.set_data(x, y[:, ch])
+
+        now = time.monotonic()
+        if now - rate[2] >= 1.0:
+            rate[0] = (ring.total - rate[1]) / (now - rate[2])
+            rate[1], rate[2] = ring.total, now
+            s = tables.stream_stats
+            status.set_text('%s  %.0f samples/s  lost %d  crc %d  bad lines %d'
+                           % (args.sensor, rate[0], s.lostFrames,
+                              s.crcErrors, s.badLines))
+        return lines + [status]
+
+    # Keep a reference or the animation is garbage collected
+    anim = animation.FuncAnimation(fig, update, interval=args.interval,
+                                   blit=True, cache_frame_data=False)
+    plt.show()
+    del anim
+    port.close()
+
+
+if __name__ == '__main__':
+    main()
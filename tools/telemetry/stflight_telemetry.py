@@ -0,0 +1,269 @@
+"""
+Python binding for the host telemetry decoder (libstflight_telemetry).
+
+Build the library first:
+    cmake -S tools/telemetry -B build/telemetry && cmake --build build/telemetry
+
+    import stflight_telemetry as stt
+
+    tables = stt.Telemetry(stt.BINARY)
+    tables.feed(port.read(port.in_waiting or 1))
+    imu = tables.rows(stt.IMU)      # numpy structured array, no copy
+    accel_x = imu['accel'][:, 0]
+
+    tables = stt.Telemetry.load('flight.cap')
+    info = tables.messages('LogInfo')  # any other message of telemetry.schema
+
+The arrays returned by rows() view memory owned by the library: they are
+only valid until the next feed(), load_capture() or clear(). Copy them
+(np.array(rows)) to keep them longer.
+"""
+
+import ctypes
+import os
+
+import numpy as np
+
+# enum TelemetryStream_Mode
+BINARY = 0
+TEXT = 1
+
+# enum TelemetryTable_Kind
+IMU = 0
+BARO = 1
+MAG = 2
+VECTOR3 = 3
+STATUS = 4
+
+# Table kinds whose rows are a schema message payload as is
+SCHEMA_KINDS = {BARO: 'Baro', MAG: 'Mag', STATUS: 'Status'}
+
+# Row layouts of telemetry_table.h that are not a payload; the others come
+# from the schema descriptors (telemetry_schema.h) when the library loads
+DTYPES = {
+    IMU: np.dtype([('index', '<u4'), ('time_us', '<u4'),
+                   ('accel', '<i2', 3), ('gyro', '<i2', 3)]),
+    VECTOR3: np.dtype([('hostTime_ms', '<u4'), ('v', '<i2', 3)]),
+}
+
+# enum TelemetrySchema_Type, enum TelemetrySchema_Kind
+_SCHEMA_TYPES = ['u1', 'i1', '<u2', '<i2', '<u4', '<i4', '<f4']
+_SCHEMA_OPAQUE = 2
+
+
+class StreamStats(ctypes.Structure):
+    """TelemetryStream_Stats_t"""
+    _fields_ = [(name, ctypes.c_uint64) for name in (
+        'bytes', 'frames', 'crcErrors', 'cobsErrors', 'oversize',
+        'lostFrames', 'badLines')]
+
+
+class TableStats(ctypes.Structure):
+    """TelemetryTable_Stats_t"""
+    _fields_ = [(name, ctypes.c_uint64) for name in (
+        'imuSamples', 'imuSkippedBlocks', 'imuBadBlocks', 'unknownFrames',
+        'badLength', 'schemaHash', 'schemaMismatch')]
+
+
+class SchemaField(ctypes.Structure):
+    """TelemetrySchema_Field_t"""
+    _fields_ = [('name', ctypes.c_char_p), ('type', ctypes.c_uint8),
+                ('offset', ctypes.c_uint16), ('count', ctypes.c_uint16)]
+
+
+class SchemaMessage(ctypes.Structure):
+    """TelemetrySchema_Message_t"""
+    _fields_ = [('id', ctypes.c_uint8), ('name', ctypes.c_char_p),
+                ('kind', ctypes.c_uint8), ('size', ctypes.c_uint16),
+                ('fieldCount', ctypes.c_uint16),
+                ('fields', ctypes.POINTER(SchemaField))]
+
+
+def _message_dtype(msg):
+    names, formats, offsets = [], [], []
+    for i in range(msg.fieldCount):
+        field = msg.fields[i]
+        names.append(field.name.decode())
+        fmt = _SCHEMA_TYPES[field.type]
+        formats.append(fmt if field.count == 1 else (fmt, (field.count,)))
+        offsets.append(field.offset)
+    return np.dtype({'names': names, 'formats': formats, 'offsets': offsets,
+                     'itemsize': msg.size})
+
+
+def _load_library():
+    here = os.path.dirname(os.path.abspath(__file__))
+    candidates = [os.environ.get('STFLIGHT_TELEMETRY_LIB'),
+                  os.path.join(here, '..', '..', 'build', 'telemetry',
+                               'libstflight_telemetry.so'),
+                  os.path.join(here, 'build', 'libstflight_telemetry.so'),
+                  'libstflight_telemetry.so']
+    for path in candidates:
+        if not path:
+            continue
+        try:
+            lib = ctypes.CDLL(path)
+            break
+        except OSError:
+            continue
+    else:
+        raise OSError('libstflight_telemetry.so not found; build tools/telemetry '
+                      'or set STFLIGHT_TELEMETRY_LIB')
+
+    p = ctypes.c_void_p
+    lib.TelemetryTable_Create.argtypes = [ctypes.c_uint8]
+    lib.TelemetryTable_Create.restype = p
+    lib.TelemetryTable_Destroy.argtypes = [p]
+    lib.TelemetryTable_Destroy.restype = None
+    lib.TelemetryTable_Feed.argtypes = [p, p, ctypes.c_size_t, ctypes.c_uint32]
+    lib.TelemetryTable_Feed.restype = None
+    lib.TelemetryTable_LoadCapture.argtypes = [p, ctypes.c_char_p]
+    lib.TelemetryTable_LoadCapture.restype = ctypes.c_long
+    lib.TelemetryTable_Rows.argtypes = [p, ctypes.c_int, ctypes.POINTER(p)]
+    lib.TelemetryTable_Rows.restype = ctypes.c_size_t
+    lib.TelemetryTable_RowSize.argtypes = [ctypes.c_int]
+    lib.TelemetryTable_RowSize.restype = ctypes.c_size_t
+    lib.TelemetryTable_Clear.argtypes = [p, ctypes.c_int]
+    lib.TelemetryTable_Clear.restype = None
+    lib.TelemetryTable_GetStats.argtypes = [p]
+    lib.TelemetryTable_GetStats.restype = ctypes.POINTER(TableStats)
+    lib.TelemetryTable_GetStreamStats.argtypes = [p]
+    lib.TelemetryTable_GetStreamStats.restype = ctypes.POINTER(StreamStats)
+    lib.TelemetryTable_MessageRows.argtypes = [p, ctypes.c_uint8,
+                                               ctypes.POINTER(p)]
+    lib.TelemetryTable_MessageRows.restype = ctypes.c_size_t
+    lib.TelemetryTable_ClearMessage.argtypes = [p, ctypes.c_uint8]
+    lib.TelemetryTable_ClearMessage.restype = None
+    lib.TelemetrySchema_Hash.argtypes = []
+    lib.TelemetrySchema_Hash.restype = ctypes.c_uint32
+    lib.TelemetrySchema_Count.argtypes = []
+    lib.TelemetrySchema_Count.restype = ctypes.c_size_t
+    lib.TelemetrySchema_Get.argtypes = [ctypes.c_size_t]
+    lib.TelemetrySchema_Get.restype = ctypes.POINTER(SchemaMessage)
+
+    for i in range(lib.TelemetrySchema_Count()):
+        msg = lib.TelemetrySchema_Get(i).contents
+        if msg.kind == _SCHEMA_OPAQUE:
+            continue
+        name = msg.name.decode()
+        MESSAGES[name] = (msg.id, _message_dtype(msg))
+        MESSAGES[msg.id] = MESSAGES[name]
+    for kind, name in SCHEMA_KINDS.items():
+        DTYPES[kind] = MESSAGES[name][1]
+
+    # Catch a stale library before numpy misreads its rows
+    for kind, dtype in DTYPES.items():
+        if lib.TelemetryTable_RowSize(kind) != dtype.itemsize:
+            raise OSError('libstflight_telemetry row layout does not match '
+                          'stflight_telemetry.py')
+    return lib
+
+
+_lib = None
+
+# Schema message name or id -> (id, dtype), filled when the library loads
+MESSAGES = {}
+
+
+def _library():
+    global _lib
+    if _lib is None:
+        _lib = _load_library()
+    return _lib
+
+
+class Telemetry:
+    """Decoded telemetry: one growing table per message kind."""
+
+    def __init__(self, mode=BINARY):
+        self._lib = _library()
+        self._handle = self._lib.TelemetryTable_Create(mode)
+        if not self._handle:
+            raise MemoryError('TelemetryTable_Create')
+        self._buf = ctypes.create_string_buffer(0)
+
+    @classmethod
+    def load(cls, path):
+        """Tables filled from a capture file written by stflight_capture."""
+        tables = cls(BINARY)
+        tables.load_capture(path)
+        return tables
+
+    def close(self):
+        if self._handle:
+            self._lib.TelemetryTable_Destroy(self._handle)
+            self._handle = None
+
+    def __del__(self):
+        self.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def feed(self, data, host_time_ms=0):
+        """Decode bytes received from the link."""
+        n = len(data)
+        if n == 0:
+            return
+        # The decoder works in place, so the caller's bytes go through a
+        # reusable scratch buffer
+        if len(self._buf) < n:
+            self._buf = ctypes.create_string_buffer(max(n, 2 * len(self._buf)))
+        ctypes.memmove(self._buf, bytes(data), n)
+        self._lib.TelemetryTable_Feed(self._handle, self._buf, n,
+                                      host_time_ms & 0xFFFFFFFF)
+
+    def load_capture(self, path):
+        """Append every record of a capture file; returns the record count."""
+        records = self._lib.TelemetryTable_LoadCapture(
+            self._handle, os.fsencode(path))
+        if records < 0:
+            raise IOError('%s: cannot read capture (%d)' % (path, records))
+        return records
+
+    def rows(self, kind):
+        """Rows of one kind as a structured array viewing library memory."""
+        data = ctypes.c_void_p()
+        n = self._lib.TelemetryTable_Rows(self._handle, kind,
+                                          ctypes.byref(data))
+        dtype = DTYPES[kind]
+        if n == 0:
+            return np.zeros(0, dtype=dtype)
+        raw = (ctypes.c_uint8 * (n * dtype.itemsize)).from_address(data.value)
+        return np.frombuffer(raw, dtype=dtype)
+
+    def clear(self, kind):
+        """Drop all rows of one kind, e.g. after a plotter consumed them."""
+        self._lib.TelemetryTable_Clear(self._handle, kind)
+
+    def messages(self, message):
+        """Payloads of a schema message without a kind of its own (name or id),
+        with the same lifetime as rows()."""
+        msg_id, dtype = MESSAGES[message]
+        data = ctypes.c_void_p()
+        n = self._lib.TelemetryTable_MessageRows(self._handle, msg_id,
+                                                 ctypes.byref(data))
+        if n == 0:
+            return np.zeros(0, dtype=dtype)
+        raw = (ctypes.c_uint8 * (n * dtype.itemsize)).from_address(data.value)
+        return np.frombuffer(raw, dtype=dtype)
+
+    def clear_messages(self, message):
+        self._lib.TelemetryTable_ClearMessage(self._handle,
+                                              MESSAGES[message][0])
+
+    @property
+    def schema_hash(self):
+        """Hash of the schema this library decodes with."""
+        return self._lib.TelemetrySchema_Hash()
+
+    @property
+    def stats(self):
+        return self._lib.TelemetryTable_GetStats(self._handle).contents
+
+    @property
+    def stream_stats(self):
+        return self._lib.TelemetryTable_GetStreamStats(self._handle).contents
@@ -0,0 +1,84 @@
+#include "telemetry_capture.h"
+#include "telemetry_schema.h"
+#include <stddef.h>
+#include <string.h>
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+int TelemetryCapture_WriteHeader(FILE *f, uint32_t startTime_s)
+{
+    TelemetryCapture_FileHeader_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TELEMETRY_CAPTURE_MAGIC, sizeof(header.magic));
+    header.version = TELEMETRY_CAPTURE_VERSION;
+    header.headerSize = sizeof(header);
+    header.startTime_s = startTime_s;
+    header.schemaHash = TelemetrySchema_Hash();
+    return (fwrite(&header, sizeof(header), 1, f) == 1) ? 0 : -1;
+}
+
+int TelemetryCapture_WriteRecord(FILE *f, uint32_t hostTime_ms, const TelemetryStream_Frame_t *frame)
+{
+    TelemetryCapture_Record_t record = {
+        .hostTime_ms = hostTime_ms,
+        .msgId = frame->msgId,
+        .seq = frame->seq,
+        .len = (uint16_t)frame->len,
+    };
+    if (fwrite(&record, sizeof(record), 1, f) != 1)
+    {
+        return -1;
+    }
+    if (frame->len > 0 && fwrite(frame->payload, frame->len, 1, f) != 1)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+long TelemetryCapture_Read(const char *path, TelemetryStream_Callback_t callback, void *ctx,
+                           uint32_t *hostTime_ms)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f)
+    {
+        return -1;
+    }
+
+    // Fields up to startTime_s are common to every version
+    TelemetryCapture_FileHeader_t header;
+    if (fread(&header, offsetof(TelemetryCapture_FileHeader_t, schemaHash), 1, f) != 1 ||
+        memcmp(header.magic, TELEMETRY_CAPTURE_MAGIC, 8) != 0 || header.version == 0 ||
+        header.version > TELEMETRY_CAPTURE_VERSION || fseek(f, header.headerSize, SEEK_SET) != 0)
+    {
+        fclose(f);
+        return -2;
+    }
+
+    long records = 0;
+    TelemetryCapture_Record_t record;
+    static uint8_t payload[UINT16_MAX];
+    while (fread(&record, sizeof(record), 1, f) == 1)
+    {
+        if (record.len > 0 && fread(payload, record.len, 1, f) != 1)
+        {
+            fclose(f);
+            return -3;
+        }
+        if (hostTime_ms)
+        {
+            *hostTime_ms = record.hostTime_ms;
+        }
+        if (callback)
+        {
+            const TelemetryStream_Frame_t frame = {record.msgId, record.seq, payload, record.len};
+            callback(ctx, &frame);
+        }
+        records++;
+    }
+
+    fclose(f);
+    return records;
+}
@@ -0,0 +1,75 @@
+#ifndef TELEMETRY_CAPTURE_H
+#define TELEMETRY_CAPTURE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "telemetry_stream.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Capture file: every valid frame of a session, in arrival order.
+ *
+ *   file header (16 bytes) | record | record | ...
+ *   record = hostTime_ms (4) | msgId (1) | seq (1) | len (2) | payload (len)
+ *
+ * All fields little-endian. Payloads are stored as received, so IMU blocks
+ * stay compressed; TelemetryTable_LoadCapture expands them. Nothing is
+ * dropped between the decoder and the file.
+ */
+#define TELEMETRY_CAPTURE_MAGIC "STFLCAP" // 8 bytes with the terminator
+#define TELEMETRY_CAPTURE_VERSION 2        // 2: schemaHash; version 1 files still read
+
+    typedef struct __attribute__((packed))
+    {
+        char magic[8];
+        uint16_t version;
+        uint16_t headerSize;  ///< Offset of the first record
+        uint32_t startTime_s; ///< Host wall clock at capture start (Unix time)
+        uint32_t schemaHash;  ///< TelemetrySchema_Hash of the writer, version 2 on
+    } TelemetryCapture_FileHeader_t;
+
+    typedef struct __attribute__((packed))
+    {
+        uint32_t hostTime_ms; ///< Host time since capture start
+        uint8_t msgId;
+        uint8_t seq;
+        uint16_t len;
+    } TelemetryCapture_Record_t;
+
+    /**
+     * @brief Write the file header
+     * @param[in] f           File opened for binary writing
+     * @param[in] startTime_s Unix time of the capture start
+     * @retval  0 on success, negative on error
+     */
+    int TelemetryCapture_WriteHeader(FILE *f, uint32_t startTime_s);
+
+    /**
+     * @brief Append one frame
+     * @param[in] f           Capture file
+     * @param[in] hostTime_ms Host time since capture start
+     * @param[in] frame       Frame from the stream decoder
+     * @retval  0 on success, negative on error
+     */
+    int TelemetryCapture_WriteRecord(FILE *f, uint32_t hostTime_ms, const TelemetryStream_Frame_t *frame);
+
+    /**
+     * @brief Replay a capture file through a frame callback
+     * @param[in]  path        Capture file
+     * @param[in]  callback    Called once per record
+     * @param[in]  ctx         Passed to the callback
+     * @param[out] hostTime_ms Set to the record's host time before each callback (may be NULL)
+     * @return Number of records, -1 cannot open, -2 not a capture file, -3 truncated record
+     */
+    long TelemetryCapture_Read(const char *path, TelemetryStream_Callback_t callback, void *ctx,
+                               uint32_t *hostTime_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TELEMETRY_CAPTURE_H
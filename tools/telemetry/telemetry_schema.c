@@ -0,0 +1,117 @@
+/*
+ * Generated by tools/gen_telemetry_schema.py from telemetry.schema: edit the
+ * schema and regenerate rather than this file.
+ */
+#include "telemetry_schema.h"
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL DEFINITIONS                                                       */
+/*----------------------------------------------------------------------------*/
+
+static const TelemetrySchema_Field_t s_baroFields[] = {
+    {"time_ms", TELEMETRY_SCHEMA_U32, offsetof(Telemetry_Baro_t, time_ms), 1},
+    {"pressure_hPa", TELEMETRY_SCHEMA_F32, offsetof(Telemetry_Baro_t, pressure_hPa), 1},
+    {"temperature_C", TELEMETRY_SCHEMA_F32, offsetof(Telemetry_Baro_t, temperature_C), 1},
+    {"altitude_m", TELEMETRY_SCHEMA_F32, offsetof(Telemetry_Baro_t, altitude_m), 1},
+    {"climbRate_mps", TELEMETRY_SCHEMA_F32, offsetof(Telemetry_Baro_t, climbRate_mps), 1},
+};
+
+static const TelemetrySchema_Field_t s_imuFields[] = {
+    {"time_us", TELEMETRY_SCHEMA_U32, offsetof(Telemetry_Imu_t, time_us), 1},
+    {"accel", TELEMETRY_SCHEMA_I16, offsetof(Telemetry_Imu_t, accel), 3},
+    {"gyro", TELEMETRY_SCHEMA_I16, offsetof(Telemetry_Imu_t, gyro), 3},
+};
+
+static const TelemetrySchema_Field_t s_magFields[] = {
+    {"time_us", TELEMETRY_SCHEMA_U32, offsetof(Telemetry_Mag_t, time_us), 1},
+    {"mag", TELEMETRY_SCHEMA_I16, offsetof(Telemetry_Mag_t, mag), 3},
+};
+
+static const TelemetrySchema_Field_t s_vibrationFields[] = {
+    {"time_ms", TELEMETRY_SCHEMA_U32, offsetof(Telemetry_Vibration_t, time_ms), 1},
+    {"sequence", TELEMETRY_SCHEMA_U32, offsetof(Telemetry_Vibration_t, sequence), 1},
+    {"resolution_Hz", TELEMETRY_SCHEMA_F32, offsetof(Telemetry_Vibration_t, resolution_Hz), 1},
+    {"freq_Hz", TELEMETRY_SCHEMA_F32, offsetof(Telemetry_Vibration_t, freq_Hz), 9},
+    {"amplitude", TELEMETRY_SCHEMA_F32, offsetof(Telemetry_Vibration_t, amplitude), 9},
+};
+
+static const TelemetrySchema_Field_t s_statusFields[] = {
+    {"time_ms", TELEMETRY_SCHEMA_U32, offsetof(Telemetry_Status_t, time_ms), 1},
+    {"framesSent", TELEMETRY_SCHEMA_U32, offsetof(Telemetry_Status_t, framesSent), 1},
+    {"framesDropped", TELEMETRY_SCHEMA_U32, offsetof(Telemetry_Status_t, framesDropped), 1},
+    {"loopMaxCycles", TELEMETRY_SCHEMA_U16, offsetof(Telemetry_Status_t, loopMaxCycles), 1},
+    {"queueHighWater", TELEMETRY_SCHEMA_U8, offsetof(Telemetry_Status_t, queueHighWater), 1},
+    {"reserved", TELEMETRY_SCHEMA_U8, offsetof(Telemetry_Status_t, reserved), 1},
+};
+
+static const TelemetrySchema_Field_t s_schemaFields[] = {
+    {"hash", TELEMETRY_SCHEMA_U32, offsetof(Telemetry_Schema_t, hash), 1},
+    {"messages", TELEMETRY_SCHEMA_U16, offsetof(Telemetry_Schema_t, messages), 1},
+    {"reserved", TELEMETRY_SCHEMA_U16, offsetof(Telemetry_Schema_t, reserved), 1},
+};
+
+static const TelemetrySchema_Field_t s_logInfoFields[] = {
+    {"size", TELEMETRY_SCHEMA_U32, offsetof(Telemetry_LogInfo_t, size), 1},
+    {"chunkSize", TELEMETRY_SCHEMA_U16, offsetof(Telemetry_LogInfo_t, chunkSize), 1},
+    {"window", TELEMETRY_SCHEMA_U16, offsetof(Telemetry_LogInfo_t, window), 1},
+    {"origin", TELEMETRY_SCHEMA_U32, offsetof(Telemetry_LogInfo_t, origin), 1},
+};
+
+static const TelemetrySchema_Field_t s_logReadFields[] = {
+    {"offset", TELEMETRY_SCHEMA_U32, offsetof(Telemetry_LogRead_t, offset), 1},
+    {"length", TELEMETRY_SCHEMA_U32, offsetof(Telemetry_LogRead_t, length), 1},
+};
+
+static const TelemetrySchema_Field_t s_logAckFields[] = {
+    {"offset", TELEMETRY_SCHEMA_U32, offsetof(Telemetry_LogAck_t, offset), 1},
+};
+
+static const TelemetrySchema_Field_t s_logDataFields[] = {
+    {"offset", TELEMETRY_SCHEMA_U32, offsetof(Telemetry_LogData_t, offset), 1},
+    {"data", TELEMETRY_SCHEMA_U8, offsetof(Telemetry_LogData_t, data), 116},
+};
+
+static const TelemetrySchema_Message_t s_messages[TELEMETRY_SCHEMA_MESSAGES] = {
+    {TELEMETRY_MSG_BARO, "Baro", TELEMETRY_SCHEMA_FIXED, sizeof(Telemetry_Baro_t), 5, s_baroFields},
+    {TELEMETRY_MSG_IMU, "Imu", TELEMETRY_SCHEMA_FIXED, sizeof(Telemetry_Imu_t), 3, s_imuFields},
+    {TELEMETRY_MSG_MAG, "Mag", TELEMETRY_SCHEMA_FIXED, sizeof(Telemetry_Mag_t), 2, s_magFields},
+    {TELEMETRY_MSG_IMU_BLOCK, "ImuBlock", TELEMETRY_SCHEMA_OPAQUE, 0, 0, NULL},
+    {TELEMETRY_MSG_VIBRATION, "Vibration", TELEMETRY_SCHEMA_FIXED, sizeof(Telemetry_Vibration_t), 5, s_vibrationFields},
+    {TELEMETRY_MSG_STATUS, "Status", TELEMETRY_SCHEMA_FIXED, sizeof(Telemetry_Status_t), 6, s_statusFields},
+    {TELEMETRY_MSG_SCHEMA, "Schema", TELEMETRY_SCHEMA_FIXED, sizeof(Telemetry_Schema_t), 3, s_schemaFields},
+    {TELEMETRY_MSG_LOG_INFO, "LogInfo", TELEMETRY_SCHEMA_FIXED, sizeof(Telemetry_LogInfo_t), 4, s_logInfoFields},
+    {TELEMETRY_MSG_LOG_READ, "LogRead", TELEMETRY_SCHEMA_FIXED, sizeof(Telemetry_LogRead_t), 2, s_logReadFields},
+    {TELEMETRY_MSG_LOG_ACK, "LogAck", TELEMETRY_SCHEMA_FIXED, sizeof(Telemetry_LogAck_t), 1, s_logAckFields},
+    {TELEMETRY_MSG_LOG_DATA, "LogData", TELEMETRY_SCHEMA_VARIABLE, sizeof(Telemetry_LogData_t), 2, s_logDataFields},
+};
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+uint32_t TelemetrySchema_Hash(void)
+{
+    return TELEMETRY_SCHEMA_HASH;
+}
+
+size_t TelemetrySchema_Count(void)
+{
+    return TELEMETRY_SCHEMA_MESSAGES;
+}
+
+const TelemetrySchema_Message_t *TelemetrySchema_Get(size_t index)
+{
+    return index < TELEMETRY_SCHEMA_MESSAGES ? &s_messages[index] : NULL;
+}
+
+const TelemetrySchema_Message_t *TelemetrySchema_Find(uint8_t msgId)
+{
+    for (size_t i = 0; i < TELEMETRY_SCHEMA_MESSAGES; i++)
+    {
+        if (s_messages[i].id == msgId)
+        {
+            return &s_messages[i];
+        }
+    }
+    return NULL;
+}
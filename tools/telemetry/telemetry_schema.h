@@ -0,0 +1,82 @@
+#ifndef TELEMETRY_SCHEMA_H
+#define TELEMETRY_SCHEMA_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "telemetry_messages.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Field layout of every message in firmware/comms/telemetry.schema, for
+ * decoders that handle messages they have no code for: TelemetryTable keeps
+ * one table per message and stflight_telemetry.py turns the descriptors into
+ * numpy dtypes. The table itself (telemetry_schema.c) is generated with
+ * telemetry_messages.h by tools/gen_telemetry_schema.py, and its offsets are
+ * taken from the firmware structs, so the two cannot disagree.
+ */
+
+    enum TelemetrySchema_Type
+    {
+        TELEMETRY_SCHEMA_U8 = 0,
+        TELEMETRY_SCHEMA_I8,
+        TELEMETRY_SCHEMA_U16,
+        TELEMETRY_SCHEMA_I16,
+        TELEMETRY_SCHEMA_U32,
+        TELEMETRY_SCHEMA_I32,
+        TELEMETRY_SCHEMA_F32,
+    };
+
+    enum TelemetrySchema_Kind
+    {
+        TELEMETRY_SCHEMA_FIXED = 0, ///< Payload is exactly size bytes
+        TELEMETRY_SCHEMA_VARIABLE,  ///< The last field (an array) may be cut short
+        TELEMETRY_SCHEMA_OPAQUE,    ///< Own codec, no fields
+    };
+
+    typedef struct
+    {
+        const char *name;
+        uint8_t type;    ///< enum TelemetrySchema_Type
+        uint16_t offset; ///< In the payload
+        uint16_t count;  ///< Array length, 1 for a scalar
+    } TelemetrySchema_Field_t;
+
+    typedef struct
+    {
+        uint8_t id;       ///< enum Telemetry_MsgId
+        const char *name; ///< As in the schema, e.g. "Baro"
+        uint8_t kind;     ///< enum TelemetrySchema_Kind
+        uint16_t size;    ///< Full payload size (0 for opaque)
+        uint16_t fieldCount;
+        const TelemetrySchema_Field_t *fields;
+    } TelemetrySchema_Message_t;
+
+    /**
+     * @return TELEMETRY_SCHEMA_HASH of the schema this library was built from
+     */
+    uint32_t TelemetrySchema_Hash(void);
+
+    /**
+     * @return Number of messages in the schema
+     */
+    size_t TelemetrySchema_Count(void);
+
+    /**
+     * @return Message by position in the schema, NULL past the end
+     */
+    const TelemetrySchema_Message_t *TelemetrySchema_Get(size_t index);
+
+    /**
+     * @return Message by id, NULL if the schema has none
+     */
+    const TelemetrySchema_Message_t *TelemetrySchema_Find(uint8_t msgId);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TELEMETRY_SCHEMA_H
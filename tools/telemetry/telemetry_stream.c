@@ -0,0 +1,234 @@
+#include "telemetry_stream.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+static void TelemetryStream_Deliver(TelemetryStream_t *ts, uint8_t msgId, uint8_t seq, const uint8_t *payload,
+                                    size_t len)
+{
+    if (ts->haveSeq)
+    {
+        ts->stats.lostFrames += (uint8_t)(seq - ts->lastSeq - 1u);
+    }
+    ts->haveSeq = true;
+    ts->lastSeq = seq;
+    ts->stats.frames++;
+
+    if (ts->callback)
+    {
+        const TelemetryStream_Frame_t frame = {msgId, seq, payload, len};
+        ts->callback(ts->ctx, &frame);
+    }
+}
+
+/**
+ * @brief Decode one delimiter-free COBS block in place and deliver it if the CRC matches
+ */
+static void TelemetryStream_Frame(TelemetryStream_t *ts, uint8_t *buf, size_t len)
+{
+    if (len == 0)
+    {
+        return; // back-to-back delimiters, e.g. after a resync
+    }
+    if (len > TELEMETRY_MAX_ENCODED - 1)
+    {
+        ts->stats.oversize++;
+        return;
+    }
+
+    int raw = Telemetry_CobsDecode(buf, len, buf);
+    if (raw < TELEMETRY_RAW_OVERHEAD)
+    {
+        ts->stats.cobsErrors++;
+        return;
+    }
+
+    size_t body = (size_t)raw - 2;
+    uint16_t crc = (uint16_t)(buf[body] | (buf[body + 1] << 8));
+    if (Telemetry_Crc16(0xFFFF, buf, body) != crc)
+    {
+        ts->stats.crcErrors++;
+        return;
+    }
+
+    TelemetryStream_Deliver(ts, buf[0], buf[1], &buf[2], body - 2);
+}
+
+static bool TelemetryStream_Expect(const char **p, const char *literal)
+{
+    size_t n = strlen(literal);
+    if (strncmp(*p, literal, n) != 0)
+    {
+        return false;
+    }
+    *p += n;
+    return true;
+}
+
+static bool TelemetryStream_Int16(const char **p, int16_t *v)
+{
+    char *end;
+    long x = strtol(*p, &end, 10);
+    if (end == *p || x < INT16_MIN || x > INT16_MAX)
+    {
+        return false;
+    }
+    *p = end;
+    *v = (int16_t)x;
+    return true;
+}
+
+static bool TelemetryStream_Float(const char **p, float *v)
+{
+    char *end;
+    *v = strtof(*p, &end);
+    if (end == *p)
+    {
+        return false;
+    }
+    *p = end;
+    return true;
+}
+
+/**
+ * @brief Parse one text line (NUL-terminated, no line ending)
+ */
+static void TelemetryStream_Line(TelemetryStream_t *ts, const char *line)
+{
+    const char *p = line;
+    uint8_t seq = (uint8_t)(ts->lastSeq + 1u); // text has no sequence numbers
+
+    float pressure;
+    float temperature;
+    if (TelemetryStream_Expect(&p, "p: ") && TelemetryStream_Float(&p, &pressure) &&
+        TelemetryStream_Expect(&p, ", t: ") && TelemetryStream_Float(&p, &temperature) && *p == '\0')
+    {
+        const Telemetry_Baro_t baro = {
+            .time_ms = 0,
+            .pressure_hPa = pressure,
+            .temperature_C = temperature,
+            .altitude_m = NAN,
+            .climbRate_mps = NAN,
+        };
+        TelemetryStream_Deliver(ts, TELEMETRY_MSG_BARO, seq, (const uint8_t *)&baro, sizeof(baro));
+        return;
+    }
+
+    p = line;
+    int16_t v[3];
+    if (TelemetryStream_Expect(&p, "x: ") && TelemetryStream_Int16(&p, &v[0]) && TelemetryStream_Expect(&p, ", y: ") &&
+        TelemetryStream_Int16(&p, &v[1]) && TelemetryStream_Expect(&p, ", z: ") && TelemetryStream_Int16(&p, &v[2]) &&
+        *p == '\0')
+    {
+        TelemetryStream_Deliver(ts, TELEMETRY_HOST_MSG_VECTOR3, seq, (const uint8_t *)v, sizeof(v));
+        return;
+    }
+
+    if (line[0] != '\0')
+    {
+        ts->stats.badLines++;
+    }
+}
+
+static void TelemetryStream_FeedText(TelemetryStream_t *ts, const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        uint8_t c = data[i];
+        if (c == '\n')
+        {
+            if (!ts->skipping)
+            {
+                ts->carry[ts->carryLen] = '\0';
+                TelemetryStream_Line(ts, (const char *)ts->carry);
+            }
+            ts->carryLen = 0;
+            ts->skipping = false;
+        }
+        else if (c == '\r' || ts->skipping)
+        {
+            continue;
+        }
+        else if (ts->carryLen < TELEMETRY_STREAM_LINE_MAX - 1)
+        {
+            ts->carry[ts->carryLen++] = c;
+        }
+        else
+        {
+            ts->stats.badLines++;
+            ts->skipping = true;
+        }
+    }
+}
+
+static void TelemetryStream_FeedBinary(TelemetryStream_t *ts, uint8_t *data, size_t len)
+{
+    size_t start = 0;
+    while (start < len)
+    {
+        uint8_t *delim = memchr(&data[start], 0x00, len - start);
+        size_t end = delim ? (size_t)(delim - data) : len;
+        size_t n = end - start;
+
+        if (ts->skipping)
+        {
+            // Waiting for the delimiter of an oversize frame
+        }
+        else if (ts->carryLen + n > TELEMETRY_MAX_ENCODED - 1)
+        {
+            ts->stats.oversize++;
+            ts->carryLen = 0;
+            ts->skipping = !delim;
+        }
+        else if (ts->carryLen > 0 || !delim)
+        {
+            // Frame continues from or into another chunk: the only copy
+            memcpy(&ts->carry[ts->carryLen], &data[start], n);
+            ts->carryLen += n;
+            if (delim)
+            {
+                TelemetryStream_Frame(ts, ts->carry, ts->carryLen);
+                ts->carryLen = 0;
+            }
+        }
+        else
+        {
+            TelemetryStream_Frame(ts, &data[start], n);
+        }
+
+        if (delim)
+        {
+            ts->skipping = false;
+        }
+        start = end + 1;
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+void TelemetryStream_Init(TelemetryStream_t *ts, uint8_t mode, TelemetryStream_Callback_t callback, void *ctx)
+{
+    memset(ts, 0, sizeof(*ts));
+    ts->mode = mode;
+    ts->callback = callback;
+    ts->ctx = ctx;
+}
+
+void TelemetryStream_Feed(TelemetryStream_t *ts, uint8_t *data, size_t len)
+{
+    ts->stats.bytes += len;
+    if (ts->mode == TELEMETRY_STREAM_TEXT)
+    {
+        TelemetryStream_FeedText(ts, data, len);
+    }
+    else
+    {
+        TelemetryStream_FeedBinary(ts, data, len);
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef TELEMETRY_STREAM_H
+#define TELEMETRY_STREAM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "telemetry_messages.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Host-side incremental decoder for the firmware telemetry link.
+ *
+ * Binary mode: bytes are split on the 0x00 delimiter, COBS-decoded in place
+ * in the caller's buffer and CRC-checked; the callback gets a pointer into
+ * that buffer, so a frame is only copied when it straddles two Feed calls.
+ * A bad frame costs exactly that frame: the next delimiter resynchronizes.
+ *
+ * Text mode: the human-readable lines of text_format.h ("p: ..., t: ..." and
+ * "x: ..., y: ..., z: ...") are turned into TELEMETRY_MSG_BARO and
+ * TELEMETRY_HOST_MSG_VECTOR3 frames, so the same consumers handle both.
+ */
+#define TELEMETRY_HOST_MSG_VECTOR3 0xF0 // host-only: int16 x, y, z from a text line
+#define TELEMETRY_STREAM_LINE_MAX 96
+
+    enum TelemetryStream_Mode
+    {
+        TELEMETRY_STREAM_BINARY = 0,
+        TELEMETRY_STREAM_TEXT,
+    };
+
+    typedef struct
+    {
+        uint8_t msgId;
+        uint8_t seq;            ///< Firmware sequence number (text mode: host counter)
+        const uint8_t *payload; ///< Valid only during the callback
+        size_t len;
+    } TelemetryStream_Frame_t;
+
+    typedef void (*TelemetryStream_Callback_t)(void *ctx, const TelemetryStream_Frame_t *frame);
+
+    typedef struct
+    {
+        uint64_t bytes;      ///< Bytes fed
+        uint64_t frames;     ///< Frames delivered
+        uint64_t crcErrors;  ///< Frames with a bad CRC
+        uint64_t cobsErrors; ///< Malformed COBS or too short to hold a header
+        uint64_t oversize;   ///< Delimiter missing for longer than any valid frame (bytes skipped to the next one)
+        uint64_t lostFrames; ///< Frames missing according to the sequence numbers
+        uint64_t badLines;   ///< Text mode: lines that matched no known format
+    } TelemetryStream_Stats_t;
+
+    typedef struct
+    {
+        uint8_t mode; ///< enum TelemetryStream_Mode
+        TelemetryStream_Callback_t callback;
+        void *ctx;
+
+        uint8_t carry[TELEMETRY_STREAM_LINE_MAX > TELEMETRY_MAX_ENCODED ? TELEMETRY_STREAM_LINE_MAX
+                                                                         : TELEMETRY_MAX_ENCODED];
+        size_t carryLen; ///< Bytes of a frame or line split across Feed calls
+        bool skipping;   ///< Oversize frame or line: drop bytes until the next delimiter
+
+        bool haveSeq;
+        uint8_t lastSeq;
+        TelemetryStream_Stats_t stats;
+    } TelemetryStream_t;
+
+    /**
+     * @brief Reset the decoder
+     * @param[out] ts       Decoder state
+     * @param[in]  mode     enum TelemetryStream_Mode
+     * @param[in]  callback Called once per valid frame
+     * @param[in]  ctx      Passed to the callback
+     */
+    void TelemetryStream_Init(TelemetryStream_t *ts, uint8_t mode, TelemetryStream_Callback_t callback, void *ctx);
+
+    /**
+     * @brief Decode the next chunk of the byte stream
+     * @param[in,out] ts   Decoder state
+     * @param[in,out] data Received bytes; binary frames are decoded in place, so the content is clobbered
+     * @param[in]     len  Number of bytes
+     */
+    void TelemetryStream_Feed(TelemetryStream_t *ts, uint8_t *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TELEMETRY_STREAM_H
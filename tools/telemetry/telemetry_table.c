@@ -0,0 +1,340 @@
+#include "telemetry_table.h"
+#include "telemetry_capture.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL DEFINITIONS                                                       */
+/*----------------------------------------------------------------------------*/
+
+#define TELEMETRY_TABLE_INITIAL_ROWS 1024
+#define TELEMETRY_TABLE_MAX_BLOCK_SAMPLES 64
+
+typedef struct
+{
+    uint8_t *data;
+    size_t rows;
+    size_t capacity;
+} TelemetryTable_Column_t;
+
+struct TelemetryTable
+{
+    TelemetryTable_Column_t column[TELEMETRY_TABLE_COUNT];
+    TelemetryTable_Column_t message[256]; ///< Other schema messages, by id
+    TelemetryStream_t stream;
+    uint32_t hostTime_ms; ///< Time of the frames being fed
+
+    ImuCompress_Decoder_t imuDecoder;
+    bool haveImuBlock;
+    uint16_t lastBlockIndex16; ///< Wire index of the previous block
+    uint32_t lastBlockIndex;   ///< Same, unwrapped
+    uint32_t lastBlockTime_us;
+    float imuPeriod_us;        ///< Sample period measured between blocks (0 until known)
+    uint32_t rawImuCount;      ///< Rows from uncompressed TELEMETRY_MSG_IMU
+
+    TelemetryTable_Stats_t stats;
+};
+
+static const size_t s_rowSize[TELEMETRY_TABLE_COUNT] = {
+    [TELEMETRY_TABLE_IMU] = sizeof(TelemetryTable_ImuRow_t),
+    [TELEMETRY_TABLE_BARO] = sizeof(Telemetry_Baro_t),
+    [TELEMETRY_TABLE_MAG] = sizeof(Telemetry_Mag_t),
+    [TELEMETRY_TABLE_VECTOR3] = sizeof(TelemetryTable_Vector3Row_t),
+    [TELEMETRY_TABLE_STATUS] = sizeof(Telemetry_Status_t),
+};
+
+/*----------------------------------------------------------------------------*/
+/* INTERNAL UTILITY FUNCTIONS                                                 */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @brief Reserve one row at the end of a column, growing it geometrically
+ * @return Row to fill, NULL when out of memory
+ */
+static void *TelemetryTable_AppendRow(TelemetryTable_Column_t *c, size_t rowSize)
+{
+    if (c->rows == c->capacity)
+    {
+        size_t capacity = c->capacity ? 2 * c->capacity : TELEMETRY_TABLE_INITIAL_ROWS;
+        uint8_t *data = realloc(c->data, capacity * rowSize);
+        if (!data)
+        {
+            return NULL;
+        }
+        c->data = data;
+        c->capacity = capacity;
+    }
+    return &c->data[c->rows++ * rowSize];
+}
+
+static void *TelemetryTable_Append(TelemetryTable_t *t, int kind)
+{
+    return TelemetryTable_AppendRow(&t->column[kind], s_rowSize[kind]);
+}
+
+/**
+ * @brief Any schema message without a kind: the payload struct is the row
+ */
+static void TelemetryTable_AddMessage(TelemetryTable_t *t, const TelemetryStream_Frame_t *frame)
+{
+    const TelemetrySchema_Message_t *msg = TelemetrySchema_Find(frame->msgId);
+    if (!msg || msg->kind == TELEMETRY_SCHEMA_OPAQUE)
+    {
+        t->stats.unknownFrames++;
+        return;
+    }
+    size_t minLen = msg->kind == TELEMETRY_SCHEMA_VARIABLE ? msg->fields[msg->fieldCount - 1].offset : msg->size;
+    if (frame->len < minLen || frame->len > msg->size)
+    {
+        t->stats.badLength++;
+        return;
+    }
+    uint8_t *row = TelemetryTable_AppendRow(&t->message[frame->msgId], msg->size);
+    if (row)
+    {
+        memcpy(row, frame->payload, frame->len);
+        memset(&row[frame->len], 0, msg->size - frame->len);
+    }
+}
+
+static void TelemetryTable_CheckSchema(TelemetryTable_t *t, const TelemetryStream_Frame_t *frame)
+{
+    Telemetry_Schema_t schema;
+    if (frame->len != sizeof(schema))
+    {
+        return; // counted by TelemetryTable_AddMessage
+    }
+    memcpy(&schema, frame->payload, sizeof(schema));
+    t->stats.schemaHash = schema.hash;
+    if (schema.hash != TelemetrySchema_Hash())
+    {
+        t->stats.schemaMismatch++;
+    }
+}
+
+static void TelemetryTable_AppendCopy(TelemetryTable_t *t, int kind, const TelemetryStream_Frame_t *frame)
+{
+    if (frame->len != s_rowSize[kind])
+    {
+        t->stats.badLength++;
+        return;
+    }
+    void *row = TelemetryTable_Append(t, kind);
+    if (row)
+    {
+        memcpy(row, frame->payload, frame->len);
+    }
+}
+
+static void TelemetryTable_AddImuBlock(TelemetryTable_t *t, const TelemetryStream_Frame_t *frame)
+{
+    int16_t samples[TELEMETRY_TABLE_MAX_BLOCK_SAMPLES][IMU_COMPRESS_AXES];
+    uint16_t index16;
+    uint32_t time_us;
+    int n = ImuCompress_Decode(&t->imuDecoder, frame->payload, frame->len, samples, TELEMETRY_TABLE_MAX_BLOCK_SAMPLES,
+                               &index16, &time_us);
+    if (n == -2)
+    {
+        t->stats.imuSkippedBlocks++;
+        return;
+    }
+    if (n < 0)
+    {
+        t->stats.imuBadBlocks++;
+        return;
+    }
+
+    // Unwrap the 16-bit wire index; the period comes from consecutive block starts
+    uint32_t index = index16;
+    if (t->haveImuBlock)
+    {
+        index = t->lastBlockIndex + (uint16_t)(index16 - t->lastBlockIndex16);
+        if (index > t->lastBlockIndex)
+        {
+            t->imuPeriod_us = (float)(uint32_t)(time_us - t->lastBlockTime_us) / (float)(index - t->lastBlockIndex);
+        }
+    }
+    t->haveImuBlock = true;
+    t->lastBlockIndex16 = index16;
+    t->lastBlockIndex = index;
+    t->lastBlockTime_us = time_us;
+
+    for (int k = 0; k < n; k++)
+    {
+        TelemetryTable_ImuRow_t *row = TelemetryTable_Append(t, TELEMETRY_TABLE_IMU);
+        if (!row)
+        {
+            return;
+        }
+        row->index = index + (uint32_t)k;
+        row->time_us = time_us + (uint32_t)lrintf((float)k * t->imuPeriod_us);
+        memcpy(row->accel, &samples[k][0], sizeof(row->accel));
+        memcpy(row->gyro, &samples[k][3], sizeof(row->gyro));
+        t->stats.imuSamples++;
+    }
+}
+
+static void TelemetryTable_AddRawImu(TelemetryTable_t *t, const TelemetryStream_Frame_t *frame)
+{
+    Telemetry_Imu_t imu;
+    if (frame->len != sizeof(imu))
+    {
+        t->stats.badLength++;
+        return;
+    }
+    memcpy(&imu, frame->payload, sizeof(imu));
+
+    TelemetryTable_ImuRow_t *row = TelemetryTable_Append(t, TELEMETRY_TABLE_IMU);
+    if (row)
+    {
+        row->index = t->rawImuCount++;
+        row->time_us = imu.time_us;
+        memcpy(row->accel, imu.accel, sizeof(row->accel));
+        memcpy(row->gyro, imu.gyro, sizeof(row->gyro));
+        t->stats.imuSamples++;
+    }
+}
+
+static void TelemetryTable_OnFrame(void *ctx, const TelemetryStream_Frame_t *frame)
+{
+    TelemetryTable_t *t = ctx;
+    TelemetryTable_AddFrame(t, t->hostTime_ms, frame);
+}
+
+/*----------------------------------------------------------------------------*/
+/* PUBLIC API IMPLEMENTATION                                                  */
+/*----------------------------------------------------------------------------*/
+
+TelemetryTable_t *TelemetryTable_Create(uint8_t mode)
+{
+    TelemetryTable_t *t = calloc(1, sizeof(*t));
+    if (!t)
+    {
+        return NULL;
+    }
+    TelemetryStream_Init(&t->stream, mode, TelemetryTable_OnFrame, t);
+    ImuCompress_InitDecoder(&t->imuDecoder);
+    return t;
+}
+
+void TelemetryTable_Destroy(TelemetryTable_t *t)
+{
+    if (!t)
+    {
+        return;
+    }
+    for (int k = 0; k < TELEMETRY_TABLE_COUNT; k++)
+    {
+        free(t->column[k].data);
+    }
+    for (int id = 0; id < 256; id++)
+    {
+        free(t->message[id].data);
+    }
+    free(t);
+}
+
+void TelemetryTable_Feed(TelemetryTable_t *t, uint8_t *data, size_t len, uint32_t hostTime_ms)
+{
+    t->hostTime_ms = hostTime_ms;
+    TelemetryStream_Feed(&t->stream, data, len);
+}
+
+void TelemetryTable_AddFrame(TelemetryTable_t *t, uint32_t hostTime_ms, const TelemetryStream_Frame_t *frame)
+{
+    switch (frame->msgId)
+    {
+    case TELEMETRY_MSG_IMU_BLOCK:
+        TelemetryTable_AddImuBlock(t, frame);
+        break;
+    case TELEMETRY_MSG_IMU:
+        TelemetryTable_AddRawImu(t, frame);
+        break;
+    case TELEMETRY_MSG_BARO:
+        TelemetryTable_AppendCopy(t, TELEMETRY_TABLE_BARO, frame);
+        break;
+    case TELEMETRY_MSG_MAG:
+        TelemetryTable_AppendCopy(t, TELEMETRY_TABLE_MAG, frame);
+        break;
+    case TELEMETRY_MSG_STATUS:
+        TelemetryTable_AppendCopy(t, TELEMETRY_TABLE_STATUS, frame);
+        break;
+    case TELEMETRY_HOST_MSG_VECTOR3:
+    {
+        TelemetryTable_Vector3Row_t *row;
+        if (frame->len != sizeof(row->v))
+        {
+            t->stats.badLength++;
+        }
+        else if ((row = TelemetryTable_Append(t, TELEMETRY_TABLE_VECTOR3)) != NULL)
+        {
+            row->hostTime_ms = hostTime_ms;
+            memcpy(row->v, frame->payload, sizeof(row->v));
+        }
+        break;
+    }
+    case TELEMETRY_MSG_SCHEMA:
+        TelemetryTable_CheckSchema(t, frame);
+        TelemetryTable_AddMessage(t, frame);
+        break;
+    default:
+        TelemetryTable_AddMessage(t, frame);
+        break;
+    }
+}
+
+long TelemetryTable_LoadCapture(TelemetryTable_t *t, const char *path)
+{
+    return TelemetryCapture_Read(path, TelemetryTable_OnFrame, t, &t->hostTime_ms);
+}
+
+size_t TelemetryTable_Rows(const TelemetryTable_t *t, int kind, const void **data)
+{
+    if (kind < 0 || kind >= TELEMETRY_TABLE_COUNT)
+    {
+        return 0;
+    }
+    if (data)
+    {
+        *data = t->column[kind].data;
+    }
+    return t->column[kind].rows;
+}
+
+size_t TelemetryTable_RowSize(int kind)
+{
+    return (kind >= 0 && kind < TELEMETRY_TABLE_COUNT) ? s_rowSize[kind] : 0;
+}
+
+void TelemetryTable_Clear(TelemetryTable_t *t, int kind)
+{
+    if (kind >= 0 && kind < TELEMETRY_TABLE_COUNT)
+    {
+        t->column[kind].rows = 0;
+    }
+}
+
+size_t TelemetryTable_MessageRows(const TelemetryTable_t *t, uint8_t msgId, const void **data)
+{
+    if (data)
+    {
+        *data = t->message[msgId].data;
+    }
+    return t->message[msgId].rows;
+}
+
+void TelemetryTable_ClearMessage(TelemetryTable_t *t, uint8_t msgId)
+{
+    t->message[msgId].rows = 0;
+}
+
+const TelemetryTable_Stats_t *TelemetryTable_GetStats(const TelemetryTable_t *t)
+{
+    return &t->stats;
+}
+
+const TelemetryStream_Stats_t *TelemetryTable_GetStreamStats(const TelemetryTable_t *t)
+{
+    return &t->stream.stats;
+}
@@ -0,0 +1,139 @@
+#ifndef TELEMETRY_TABLE_H
+#define TELEMETRY_TABLE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "telemetry_stream.h"
+#include "telemetry_schema.h"
+#include "imu_compress.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Decoded telemetry as one contiguous array of fixed-size packed rows per
+ * message kind, so Python can view it with numpy.frombuffer and no copy
+ * (see stflight_telemetry.py). Pointers returned by TelemetryTable_Rows stay
+ * valid until the next Feed, AddFrame, LoadCapture or Clear.
+ *
+ * IMU blocks are expanded to one row per sample. Only the first sample of a
+ * block carries a firmware timestamp; the others are spaced by the sample
+ * period measured between blocks.
+ *
+ * Every other message of telemetry.schema lands in a table of its own,
+ * TelemetryTable_MessageRows, with the payload struct as the row: a message
+ * added to the schema is decoded without code here. Variable-length payloads
+ * are padded with zeros to the full struct. SCHEMA messages are also checked
+ * against the schema this library was built from.
+ */
+
+    enum TelemetryTable_Kind
+    {
+        TELEMETRY_TABLE_IMU = 0, ///< TelemetryTable_ImuRow_t
+        TELEMETRY_TABLE_BARO,    ///< Telemetry_Baro_t
+        TELEMETRY_TABLE_MAG,     ///< Telemetry_Mag_t
+        TELEMETRY_TABLE_VECTOR3, ///< TelemetryTable_Vector3Row_t
+        TELEMETRY_TABLE_STATUS,  ///< Telemetry_Status_t
+        TELEMETRY_TABLE_COUNT,
+    };
+
+    typedef struct __attribute__((packed))
+    {
+        uint32_t index;   ///< Sample index, unwrapped (raw TELEMETRY_MSG_IMU rows: arrival count)
+        uint32_t time_us; ///< Firmware time
+        int16_t accel[3];
+        int16_t gyro[3];
+    } TelemetryTable_ImuRow_t;
+
+    typedef struct __attribute__((packed))
+    {
+        uint32_t hostTime_ms; ///< Text lines carry no firmware time
+        int16_t v[3];
+    } TelemetryTable_Vector3Row_t;
+
+    typedef struct
+    {
+        uint64_t imuSamples;       ///< IMU rows added
+        uint64_t imuSkippedBlocks; ///< Compressed blocks dropped while waiting for a keyframe
+        uint64_t imuBadBlocks;     ///< Compressed blocks that failed to decode
+        uint64_t unknownFrames;    ///< Message ids without a table
+        uint64_t badLength;        ///< Payload size does not match the message
+        uint64_t schemaHash;       ///< Hash in the last SCHEMA message (0: none yet)
+        uint64_t schemaMismatch;   ///< SCHEMA messages from another schema than TelemetrySchema_Hash
+    } TelemetryTable_Stats_t;
+
+    typedef struct TelemetryTable TelemetryTable_t;
+
+    /**
+     * @brief Allocate an empty table set with its own stream decoder
+     * @param[in] mode enum TelemetryStream_Mode used by TelemetryTable_Feed
+     * @return Table set, NULL when out of memory
+     */
+    TelemetryTable_t *TelemetryTable_Create(uint8_t mode);
+
+    void TelemetryTable_Destroy(TelemetryTable_t *t);
+
+    /**
+     * @brief Decode received bytes and append the samples
+     * @param[in,out] t           Table set
+     * @param[in,out] data        Bytes from the link (clobbered, see TelemetryStream_Feed)
+     * @param[in]     len         Number of bytes
+     * @param[in]     hostTime_ms Host time, stored with text-mode rows
+     */
+    void TelemetryTable_Feed(TelemetryTable_t *t, uint8_t *data, size_t len, uint32_t hostTime_ms);
+
+    /**
+     * @brief Append one decoded frame
+     */
+    void TelemetryTable_AddFrame(TelemetryTable_t *t, uint32_t hostTime_ms, const TelemetryStream_Frame_t *frame);
+
+    /**
+     * @brief Append every record of a capture file
+     * @return Number of records, negative as TelemetryCapture_Read
+     */
+    long TelemetryTable_LoadCapture(TelemetryTable_t *t, const char *path);
+
+    /**
+     * @brief Contiguous rows of one kind
+     * @param[in]  t    Table set
+     * @param[in]  kind enum TelemetryTable_Kind
+     * @param[out] data First row (may be NULL)
+     * @return Number of rows
+     */
+    size_t TelemetryTable_Rows(const TelemetryTable_t *t, int kind, const void **data);
+
+    /**
+     * @return Row size in bytes of a kind, 0 for an unknown kind
+     */
+    size_t TelemetryTable_RowSize(int kind);
+
+    /**
+     * @brief Drop all rows of one kind (memory is kept for reuse)
+     */
+    void TelemetryTable_Clear(TelemetryTable_t *t, int kind);
+
+    /**
+     * @brief Contiguous payloads of one schema message, TelemetrySchema_Find(msgId)->size bytes each
+     * @param[in]  t     Table set
+     * @param[in]  msgId enum Telemetry_MsgId without a kind of its own
+     * @param[out] data  First row (may be NULL)
+     * @return Number of rows
+     */
+    size_t TelemetryTable_MessageRows(const TelemetryTable_t *t, uint8_t msgId, const void **data);
+
+    /**
+     * @brief Drop all rows of one schema message (memory is kept for reuse)
+     */
+    void TelemetryTable_ClearMessage(TelemetryTable_t *t, uint8_t msgId);
+
+    const TelemetryTable_Stats_t *TelemetryTable_GetStats(const TelemetryTable_t *t);
+
+    const TelemetryStream_Stats_t *TelemetryTable_GetStreamStats(const TelemetryTable_t *t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TELEMETRY_TABLE_H